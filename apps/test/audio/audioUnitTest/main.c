@@ -1163,6 +1163,69 @@ void Testle_audio_EchoCancellerNoiseSuppressor
     LE_ASSERT(status == 0);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the streaming configuration and statistics.
+ *
+ * API tested:
+ * - le_audio_SetStreamingConfig
+ * - le_audio_GetStreamingConfig
+ * - le_audio_GetStreamStats
+ *
+ * Exit if failed
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void Testle_audio_StreamingConfig
+(
+    void
+)
+{
+    uint32_t bufferSize, pipeSize, periodSize, periodsCount;
+    uint32_t underrunCount, overrunCount;
+    uint64_t splicedBytes, copiedBytes;
+    bool useSplice;
+
+    le_audio_GetStreamingConfig(&bufferSize, &pipeSize, &periodSize, &periodsCount, &useSplice);
+    uint32_t defaultBufferSize = bufferSize;
+    uint32_t defaultPipeSize = pipeSize;
+    bool defaultUseSplice = useSplice;
+
+    // Out of range buffer sizes are refused, and leave the configuration unchanged.
+    LE_ASSERT(le_audio_SetStreamingConfig(255, 0, 0, 0, true) == LE_OUT_OF_RANGE);
+    LE_ASSERT(le_audio_SetStreamingConfig(64*1024 + 1, 0, 0, 0, true) == LE_OUT_OF_RANGE);
+    le_audio_GetStreamingConfig(&bufferSize, &pipeSize, &periodSize, &periodsCount, &useSplice);
+    LE_ASSERT(bufferSize == defaultBufferSize);
+
+    LE_ASSERT(le_audio_SetStreamingConfig(2048, 16384, 160, 4, false) == LE_OK);
+    le_audio_GetStreamingConfig(&bufferSize, &pipeSize, &periodSize, &periodsCount, &useSplice);
+    LE_ASSERT(bufferSize == 2048);
+    LE_ASSERT(pipeSize == 16384);
+    LE_ASSERT(periodSize == 160);
+    LE_ASSERT(periodsCount == 4);
+    LE_ASSERT(!useSplice);
+
+    LE_ASSERT(le_audio_SetStreamingConfig(defaultBufferSize, defaultPipeSize, 0, 0,
+                                          defaultUseSplice) == LE_OK);
+
+    // A stream that was never started has no statistics.
+    le_audio_StreamRef_t playbackStreamRef = le_audio_OpenPlayer();
+    LE_ASSERT(playbackStreamRef != NULL);
+
+    LE_ASSERT(le_audio_GetStreamStats(playbackStreamRef, &underrunCount, &overrunCount,
+                                      &splicedBytes, &copiedBytes) == LE_OK);
+    LE_ASSERT(underrunCount == 0);
+    LE_ASSERT(overrunCount == 0);
+    LE_ASSERT(splicedBytes == 0);
+    LE_ASSERT(copiedBytes == 0);
+
+    le_audio_Close(playbackStreamRef);
+
+    // An invalid stream reference is refused.
+    LE_ASSERT(le_audio_GetStreamStats(NULL, &underrunCount, &overrunCount,
+                                      &splicedBytes, &copiedBytes) == LE_FAULT);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * main thread: this thread is used to initialized the le_audio and pa_audio, and to have an event
@@ -1241,6 +1304,9 @@ COMPONENT_INIT
     LE_INFO("======== Test Echo canceller and Noise suppressor ========");
     Testle_audio_EchoCancellerNoiseSuppressor();
 
+    LE_INFO("======== Test streaming configuration and statistics ========");
+    Testle_audio_StreamingConfig();
+
     LE_INFO("======== UnitTest of AUDIO API ends with SUCCESS ========");
     exit(0);
 }
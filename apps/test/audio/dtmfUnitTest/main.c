@@ -0,0 +1,426 @@
+/**
+ * This module implements the unit tests and the benchmark of the DTMF generation and detection.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "le_dtmf_local.h"
+#include <math.h>
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Amplitude of the generated tones, as in le_dtmf.c.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLE_SCALE    (32767)
+#define DTMF_AMPLITUDE  (40)
+#if !defined (PI)
+#define PI 3.14159265358979323846264338327
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of seconds of tone generated by the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCHMARK_SECONDS       20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum sample rate used by the tests.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_SAMPLE_RATE         48000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF digits and their frequencies.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char Digits[] = "123A456B789C*0#D";
+static const uint32_t LowFreqs[] = { 697, 770, 852, 941 };
+static const uint32_t HighFreqs[] = { 1209, 1336, 1477, 1633 };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Samples buffers.
+ */
+//--------------------------------------------------------------------------------------------------
+static int16_t Samples[MAX_SAMPLE_RATE * 2];
+static int16_t RefSamples[MAX_SAMPLE_RATE];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the frequencies of a digit.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetDigitFreqs
+(
+    char      digit,
+    uint32_t* lowFreqPtr,
+    uint32_t* highFreqPtr
+)
+{
+    const char* posPtr = strchr(Digits, digit);
+
+    LE_ASSERT(NULL != posPtr);
+    *lowFreqPtr = LowFreqs[(posPtr - Digits) / 4];
+    *highFreqPtr = HighFreqs[(posPtr - Digits) % 4];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute one tone of the reference waveform, with the phase computed exactly.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t RefTone
+(
+    uint32_t freq,
+    uint32_t sampleRate,
+    uint32_t sampleIndex
+)
+{
+    uint64_t cycles = ((uint64_t)freq * sampleIndex) % sampleRate;
+
+    return (int32_t)(SAMPLE_SCALE * DTMF_AMPLITUDE / 100.0 *
+                     sin(2 * PI * (double)cycles / sampleRate));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate a dual tone with the former implementation, computing sin() for every sample.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LegacyGenerate
+(
+    int16_t*  dataPtr,
+    uint32_t  sampleCount,
+    uint32_t  sampleRate,
+    uint32_t  firstSample,
+    uint32_t  freq1,
+    uint32_t  freq2
+)
+{
+    double   d1 = 1.0f * freq1 / sampleRate;
+    double   d2 = 1.0f * freq2 / sampleRate;
+    uint32_t i;
+
+    for (i = firstSample; i < firstSample + sampleCount; i++)
+    {
+        int16_t s1, s2;
+        int32_t tot;
+
+        s1 = (int16_t)(SAMPLE_SCALE * DTMF_AMPLITUDE / 100.0f * sin(2 * PI * d1 * i));
+        s2 = (int16_t)(SAMPLE_SCALE * DTMF_AMPLITUDE / 100.0f * sin(2 * PI * d2 * i));
+        tot = s1 + s2;
+        *(dataPtr++) = (tot > 32767) ? 32767 : ((tot < -32768) ? -32768 : tot);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare the generated tones with the reference waveform, on a few seconds generated by chunks
+ * of one second as PlayTone() does.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_dtmf_BitAccuracy
+(
+    void
+)
+{
+    static const uint32_t sampleRates[] = { 8000, 16000, 48000 };
+    uint32_t r;
+
+    for (r = 0; r < NUM_ARRAY_MEMBERS(sampleRates); r++)
+    {
+        uint32_t sampleRate = sampleRates[r];
+        uint32_t maxDiff = 0;
+        uint32_t diffCount = 0;
+        uint32_t totalCount = 0;
+        uint32_t d;
+
+        for (d = 0; d <= strlen(Digits); d++)
+        {
+            uint32_t lowFreq = 0;
+            uint32_t highFreq = 0;
+            uint32_t second;
+            uint32_t i;
+
+            if (d < strlen(Digits))
+            {
+                GetDigitFreqs(Digits[d], &lowFreq, &highFreq);
+            }
+            else
+            {
+                // Single tone
+                lowFreq = 1000;
+            }
+
+            for (second = 0; second < 3; second++)
+            {
+                uint32_t firstSample = second * sampleRate;
+
+                le_dtmf_Generate(Samples, sampleRate, sampleRate, firstSample, lowFreq, highFreq);
+
+                for (i = 0; i < sampleRate; i++)
+                {
+                    int32_t ref = RefTone(lowFreq, sampleRate, firstSample + i) +
+                                  RefTone(highFreq, sampleRate, firstSample + i);
+                    uint32_t diff = abs(ref - Samples[i]);
+
+                    if (diff > maxDiff)
+                    {
+                        maxDiff = diff;
+                    }
+                    diffCount += (diff ? 1 : 0);
+                }
+                totalCount += sampleRate;
+            }
+        }
+
+        LE_INFO("%u Hz: %u/%u samples differ from the reference, by %u at most",
+                sampleRate, diffCount, totalCount, maxDiff);
+
+        // Each tone is rounded toward zero, as the reference: interpolation errors can only
+        // move one tone to the next integer.
+        LE_ASSERT(maxDiff <= 2);
+        LE_ASSERT(diffCount < (totalCount / 20));
+    }
+
+    // Silence
+    le_dtmf_Generate(Samples, 1000, 8000, 1234, 0, 0);
+    memset(RefSamples, 0, 1000 * sizeof(int16_t));
+    LE_ASSERT(0 == memcmp(Samples, RefSamples, 1000 * sizeof(int16_t)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a digit and a pause to a buffer, with a given attenuation.
+ *
+ * @return Number of samples appended.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t AppendDigit
+(
+    int16_t*  bufPtr,
+    uint32_t  sampleRate,
+    char      digit,
+    uint32_t  toneMs,
+    uint32_t  pauseMs,
+    int32_t   divider
+)
+{
+    uint32_t toneCount = sampleRate * toneMs / 1000;
+    uint32_t pauseCount = sampleRate * pauseMs / 1000;
+    uint32_t lowFreq;
+    uint32_t highFreq;
+    uint32_t i;
+
+    GetDigitFreqs(digit, &lowFreq, &highFreq);
+    le_dtmf_Generate(bufPtr, toneCount, sampleRate, 0, lowFreq, highFreq);
+    for (i = 0; i < toneCount; i++)
+    {
+        bufPtr[i] /= divider;
+    }
+    memset(bufPtr + toneCount, 0, pauseCount * sizeof(int16_t));
+
+    return toneCount + pauseCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Feed samples to a detector by chunks of a PCM period.
+ *
+ * @return Number of digits detected.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t Detect
+(
+    le_dtmf_Detector_t* detectorPtr,
+    const int16_t*      samplesPtr,
+    uint32_t            sampleCount,
+    uint32_t            stride,
+    char*               digitsPtr,
+    uint32_t            digitsSize
+)
+{
+    uint32_t chunk = 160;
+    uint32_t digitCount = 0;
+    uint32_t i;
+
+    for (i = 0; i < sampleCount; i += chunk)
+    {
+        uint32_t count = ((sampleCount - i) < chunk) ? (sampleCount - i) : chunk;
+
+        digitCount += le_dtmf_Detect(detectorPtr, samplesPtr + i * stride, count, stride,
+                                     digitsPtr + digitCount, digitsSize - digitCount);
+    }
+
+    return digitCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the detection of all the digits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_dtmf_Detect
+(
+    void
+)
+{
+    static const uint32_t sampleRates[] = { 8000, 16000 };
+    le_dtmf_Detector_t detector;
+    char digits[32];
+    uint32_t r;
+    uint32_t i;
+
+    for (r = 0; r < NUM_ARRAY_MEMBERS(sampleRates); r++)
+    {
+        uint32_t sampleRate = sampleRates[r];
+        uint32_t sampleCount = 0;
+        uint32_t digitCount;
+        uint32_t d;
+
+        // All the digits, at the generator level and at -20 dB
+        for (d = 0; d < strlen(Digits); d++)
+        {
+            le_dtmf_InitDetector(&detector, sampleRate);
+            sampleCount = AppendDigit(Samples, sampleRate, Digits[d], 100, 60, 1);
+            sampleCount += AppendDigit(Samples + sampleCount, sampleRate, Digits[d], 100, 60, 10);
+
+            digitCount = Detect(&detector, Samples, sampleCount, 1, digits, sizeof(digits));
+            LE_ASSERT(2 == digitCount);
+            LE_ASSERT(Digits[d] == digits[0]);
+            LE_ASSERT(Digits[d] == digits[1]);
+        }
+
+        // A sequence, with a repeated digit
+        le_dtmf_InitDetector(&detector, sampleRate);
+        sampleCount = 0;
+        for (d = 0; d < strlen("1559#"); d++)
+        {
+            sampleCount += AppendDigit(Samples + sampleCount, sampleRate, "1559#"[d], 80, 80, 2);
+        }
+        digitCount = Detect(&detector, Samples, sampleCount, 1, digits, sizeof(digits));
+        LE_ASSERT(5 == digitCount);
+        LE_ASSERT(0 == memcmp(digits, "1559#", 5));
+
+        // A single tone is not a digit
+        le_dtmf_InitDetector(&detector, sampleRate);
+        le_dtmf_Generate(Samples, sampleRate / 2, sampleRate, 0, 770, 0);
+        LE_ASSERT(0 == Detect(&detector, Samples, sampleRate / 2, 1, digits, sizeof(digits)));
+
+        // Neither are a non-DTMF dual tone, and noise
+        le_dtmf_InitDetector(&detector, sampleRate);
+        le_dtmf_Generate(Samples, sampleRate / 2, sampleRate, 0, 440, 1000);
+        LE_ASSERT(0 == Detect(&detector, Samples, sampleRate / 2, 1, digits, sizeof(digits)));
+
+        le_dtmf_InitDetector(&detector, sampleRate);
+        srand(1);
+        for (i = 0; i < sampleRate / 2; i++)
+        {
+            Samples[i] = (rand() % 20001) - 10000;
+        }
+        LE_ASSERT(0 == Detect(&detector, Samples, sampleRate / 2, 1, digits, sizeof(digits)));
+
+        // Too weak
+        le_dtmf_InitDetector(&detector, sampleRate);
+        sampleCount = AppendDigit(Samples, sampleRate, '5', 100, 60, 200);
+        LE_ASSERT(0 == Detect(&detector, Samples, sampleCount, 1, digits, sizeof(digits)));
+    }
+
+    // Interleaved stereo samples: only the first channel is analyzed
+    le_dtmf_InitDetector(&detector, 8000);
+    uint32_t sampleCount = AppendDigit(RefSamples, 8000, '7', 100, 60, 1);
+    for (i = 0; i < sampleCount; i++)
+    {
+        Samples[2 * i] = RefSamples[i];
+        Samples[2 * i + 1] = (i & 1) ? 16000 : -16000;
+    }
+    LE_ASSERT(1 == Detect(&detector, Samples, sampleCount, 2, digits, sizeof(digits)));
+    LE_ASSERT('7' == digits[0]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetElapsedMs
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return elapsed.sec * 1000.0 + elapsed.usec / 1000.0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare the generation rate of the former sin() implementation and of the table, and measure
+ * the detection rate.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_dtmf_Benchmark
+(
+    void
+)
+{
+    uint32_t sampleRate = 8000;
+    uint32_t sampleCount = BENCHMARK_SECONDS * sampleRate;
+    le_dtmf_Detector_t detector;
+    le_clk_Time_t start;
+    double elapsedMs;
+    char digits[4];
+    uint32_t i;
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCHMARK_SECONDS; i++)
+    {
+        LegacyGenerate(Samples, sampleRate, sampleRate, i * sampleRate, 852, 1477);
+    }
+    elapsedMs = GetElapsedMs(start);
+    LE_INFO("sin() generation: %u samples in %.1f ms (%.0f samples/s)",
+            sampleCount, elapsedMs, sampleCount * 1000.0 / elapsedMs);
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCHMARK_SECONDS; i++)
+    {
+        le_dtmf_Generate(Samples, sampleRate, sampleRate, i * sampleRate, 852, 1477);
+    }
+    elapsedMs = GetElapsedMs(start);
+    LE_INFO("Table generation: %u samples in %.1f ms (%.0f samples/s)",
+            sampleCount, elapsedMs, sampleCount * 1000.0 / elapsedMs);
+
+    le_dtmf_InitDetector(&detector, sampleRate);
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCHMARK_SECONDS; i++)
+    {
+        Detect(&detector, Samples, sampleRate, 1, digits, sizeof(digits));
+    }
+    elapsedMs = GetElapsedMs(start);
+    LE_INFO("Goertzel detection: %u samples in %.1f ms (%.0f samples/s)",
+            sampleCount, elapsedMs, sampleCount * 1000.0 / elapsedMs);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main of the test.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    le_dtmf_Init();
+
+    Test_dtmf_BitAccuracy();
+    Test_dtmf_Detect();
+    Test_dtmf_Benchmark();
+
+    LE_INFO("DTMF tests passed");
+    exit(0);
+}
@@ -0,0 +1,458 @@
+/**
+ * This module implements the loopback benchmark of the media streaming.
+ *
+ * A WAV file is played on a file playback stream and recorded on a file capture stream through
+ * the loopback PCM stand-in, with and without the zero-copy path. The recorded file must be
+ * identical to the played one.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "le_audio_local.h"
+#include "le_media_local.h"
+#include "pa_amr.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Played and recorded files.
+ */
+//--------------------------------------------------------------------------------------------------
+#define PLAY_FILE       "/tmp/mediaLoopbackPlay.wav"
+#define RECORD_FILE     "/tmp/mediaLoopbackRecord.wav"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the WAV header, and of the samples of the played file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define WAV_HEADER_SIZE 44
+#define DATA_SIZE       (8*1024*1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum time to wait for the recording, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_TIMEOUT  60
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Streams and their PCM configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_audio_Stream_t PlayStream;
+static le_audio_Stream_t CaptureStream;
+static le_audio_SamplePcmConfig_t PcmConfig =
+{
+    .sampleRate = 16000,
+    .channelsCount = 1,
+    .bitsPerSample = 16
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Connect the current client thread to the service providing this API (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pm_ConnectService
+(
+    void
+)
+{
+    return;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Acquire a wakeup source (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pm_StayAwake
+(
+    le_pm_WakeupSourceRef_t w
+)
+{
+    return;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release a wakeup source (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+void le_pm_Relax
+(
+    le_pm_WakeupSourceRef_t w
+)
+{
+    return;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a new wakeup source (STUBBED FUNCTION)
+ *
+ * @return Reference to wakeup source
+ */
+//--------------------------------------------------------------------------------------------------
+le_pm_WakeupSourceRef_t le_pm_NewWakeupSource
+(
+    uint32_t    opts,
+    const char *tag
+)
+{
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the priority of a thread.  (STUBBED FUNCTION)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t MyThreadSetPriority
+(
+    le_thread_Ref_t         thread,     ///< [in]
+    le_thread_Priority_t    priority    ///< [in]
+)
+{
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stream object of a stream reference. (STUBBED FUNCTION)
+ *
+ * The streams of this test are their own references.
+ */
+//--------------------------------------------------------------------------------------------------
+le_audio_Stream_t* le_audio_LookupStream
+(
+    le_audio_StreamRef_t streamRef
+)
+{
+    return (le_audio_Stream_t*)streamRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * AMR codec (STUBBED FUNCTIONS)
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_amr_StartDecoder
+(
+    le_audio_Stream_t*               streamPtr,
+    le_audio_MediaThreadContext_t*   mediaCtxPtr
+)
+{
+    return LE_FAULT;
+}
+
+le_result_t pa_amr_DecodeFrames
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr,
+    uint8_t*                       bufferOutPtr,
+    uint32_t*                      readLenPtr
+)
+{
+    return LE_FAULT;
+}
+
+le_result_t pa_amr_StopDecoder
+(
+    le_audio_MediaThreadContext_t*    mediaCtxPtr
+)
+{
+    return LE_FAULT;
+}
+
+le_result_t pa_amr_StartEncoder
+(
+    le_audio_Stream_t*               streamPtr,
+    le_audio_MediaThreadContext_t*   mediaCtxPtr
+)
+{
+    return LE_FAULT;
+}
+
+le_result_t pa_amr_EncodeFrames
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr,
+    uint8_t* inputDataPtr,
+    uint32_t inputDataLen,
+    uint8_t* outputDataPtr,
+    uint32_t* outputDataLen
+)
+{
+    return LE_FAULT;
+}
+
+le_result_t pa_amr_StopEncoder
+(
+    le_audio_MediaThreadContext_t*    mediaCtxPtr
+)
+{
+    return LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the file to play: a WAV header followed by a ramp of samples.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreatePlayFile
+(
+    void
+)
+{
+    uint32_t header[WAV_HEADER_SIZE / sizeof(uint32_t)] =
+    {
+        0x46464952, DATA_SIZE + WAV_HEADER_SIZE - 8, 0x45564157, 0x20746d66, 16,
+        1 | (PcmConfig.channelsCount << 16), PcmConfig.sampleRate,
+        PcmConfig.sampleRate * PcmConfig.channelsCount * PcmConfig.bitsPerSample / 8,
+        (PcmConfig.channelsCount * PcmConfig.bitsPerSample / 8) | (PcmConfig.bitsPerSample << 16),
+        0x61746164, DATA_SIZE
+    };
+    static int16_t samples[4096];
+    uint32_t i;
+    int fd = open(PLAY_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(write(fd, header, sizeof(header)) == sizeof(header));
+
+    for (i = 0; i < DATA_SIZE / sizeof(samples); i++)
+    {
+        uint32_t j;
+
+        for (j = 0; j < NUM_ARRAY_MEMBERS(samples); j++)
+        {
+            samples[j] = (int16_t)(i * NUM_ARRAY_MEMBERS(samples) + j);
+        }
+        LE_ASSERT(write(fd, samples, sizeof(samples)) == sizeof(samples));
+    }
+
+    close(fd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the samples of the recorded file are the played ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckRecordFile
+(
+    void
+)
+{
+    static uint8_t playBuf[65536];
+    static uint8_t recordBuf[65536];
+    uint32_t header[WAV_HEADER_SIZE / sizeof(uint32_t)];
+    int playFd = open(PLAY_FILE, O_RDONLY);
+    int recordFd = open(RECORD_FILE, O_RDONLY);
+    uint32_t i;
+
+    LE_ASSERT((playFd >= 0) && (recordFd >= 0));
+
+    // Sizes of the recorded WAV header
+    LE_ASSERT(read(recordFd, header, sizeof(header)) == sizeof(header));
+    LE_ASSERT(DATA_SIZE + WAV_HEADER_SIZE - 8 == header[1]);
+    LE_ASSERT(DATA_SIZE == header[10]);
+
+    LE_ASSERT(lseek(playFd, WAV_HEADER_SIZE, SEEK_SET) == WAV_HEADER_SIZE);
+    for (i = 0; i < DATA_SIZE / sizeof(playBuf); i++)
+    {
+        LE_ASSERT(read(playFd, playBuf, sizeof(playBuf)) == sizeof(playBuf));
+        LE_ASSERT(read(recordFd, recordBuf, sizeof(recordBuf)) == sizeof(recordBuf));
+        LE_ASSERT(0 == memcmp(playBuf, recordBuf, sizeof(playBuf)));
+    }
+
+    close(playFd);
+    close(recordFd);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a stream object.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitStream
+(
+    le_audio_Stream_t*  streamPtr,
+    le_audio_If_t       audioInterface,
+    int                 fd
+)
+{
+    memset(streamPtr, 0, sizeof(le_audio_Stream_t));
+    streamPtr->audioInterface = audioInterface;
+    streamPtr->isInput = (LE_AUDIO_IF_DSP_FRONTEND_FILE_CAPTURE == audioInterface);
+    streamPtr->fd = fd;
+    streamPtr->encodingFormat = LE_AUDIO_WAVE;
+    streamPtr->samplePcmConfig = PcmConfig;
+    streamPtr->streamRef = (le_audio_StreamRef_t)streamPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the CPU time used by the process, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetCpuMs
+(
+    void
+)
+{
+    struct rusage usage;
+
+    LE_ASSERT(0 == getrusage(RUSAGE_SELF, &usage));
+
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Play the file to the capture stream through the loopback PCM, and measure the throughput.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_media_Loopback
+(
+    const le_media_StreamingConfig_t* configPtr
+)
+{
+    le_audio_SamplePcmConfig_t playConfig;
+    le_audio_SamplePcmConfig_t captureConfig = PcmConfig;
+    le_audio_StreamStats_t playStats;
+    le_audio_StreamStats_t captureStats;
+    le_clk_Time_t start;
+    le_clk_Time_t elapsed;
+    double startCpuMs;
+    double elapsedMs;
+    double cpuMs;
+    struct stat st;
+    int playFd = open(PLAY_FILE, O_RDONLY);
+    int recordFd = open(RECORD_FILE, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    uint32_t waitMs = 0;
+
+    LE_ASSERT((playFd >= 0) && (recordFd >= 0));
+    LE_ASSERT(LE_OK == le_media_SetStreamingConfig(configPtr));
+
+    InitStream(&CaptureStream, LE_AUDIO_IF_DSP_FRONTEND_FILE_CAPTURE, recordFd);
+    InitStream(&PlayStream, LE_AUDIO_IF_DSP_FRONTEND_FILE_PLAY, playFd);
+    PlayStream.playFile = true;
+
+    start = le_clk_GetRelativeTime();
+    startCpuMs = GetCpuMs();
+
+    LE_ASSERT(LE_OK == le_media_Open(&CaptureStream, &captureConfig));
+    LE_ASSERT(LE_OK == le_media_Capture(&CaptureStream, &captureConfig));
+    LE_ASSERT(LE_OK == le_media_Open(&PlayStream, &playConfig));
+    LE_ASSERT(LE_OK == le_media_PlaySamples(&PlayStream, &playConfig));
+
+    // Wait for the whole samples in the recorded file
+    do
+    {
+        usleep(1000);
+        LE_ASSERT(0 == fstat(recordFd, &st));
+    }
+    while ((st.st_size < (DATA_SIZE + WAV_HEADER_SIZE)) && (++waitMs < (RECORD_TIMEOUT * 1000)));
+
+    elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+    elapsedMs = elapsed.sec * 1000.0 + elapsed.usec / 1000.0;
+    cpuMs = GetCpuMs() - startCpuMs;
+
+    LE_ASSERT(LE_OK == le_media_GetStreamStats(&PlayStream, &playStats));
+    LE_ASSERT(LE_OK == le_media_GetStreamStats(&CaptureStream, &captureStats));
+
+    LE_ASSERT(LE_OK == le_media_Stop(&PlayStream));
+    LE_ASSERT(LE_OK == le_media_Stop(&CaptureStream));
+    close(playFd);
+    close(recordFd);
+
+    LE_INFO("bufferSize %u pipeSize %u periodSize %u splice %d: %.1f MB/s, %.1f ms CPU per MB",
+            configPtr->bufferSize, configPtr->pipeSize, configPtr->periodSize,
+            configPtr->useSplice, DATA_SIZE / 1048576.0 / (elapsedMs / 1000.0),
+            cpuMs / (DATA_SIZE / 1048576.0));
+    LE_INFO("  playback: %" PRIu64 " spliced, %" PRIu64 " copied, %u underruns",
+            playStats.splicedBytes, playStats.copiedBytes, playStats.underrunCount);
+    LE_INFO("  capture: %" PRIu64 " spliced, %" PRIu64 " copied, %u overruns",
+            captureStats.splicedBytes, captureStats.copiedBytes, captureStats.overrunCount);
+
+    CheckRecordFile();
+
+    // Every byte is moved once by each media thread
+    LE_ASSERT(DATA_SIZE == playStats.splicedBytes + playStats.copiedBytes);
+    LE_ASSERT(DATA_SIZE == captureStats.splicedBytes + captureStats.copiedBytes);
+    if (!configPtr->useSplice)
+    {
+        LE_ASSERT(0 == playStats.splicedBytes);
+        LE_ASSERT(0 == captureStats.splicedBytes);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the streaming configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_media_StreamingConfig
+(
+    void
+)
+{
+    le_media_StreamingConfig_t defaultConfig;
+    le_media_StreamingConfig_t config;
+
+    le_media_GetStreamingConfig(&defaultConfig);
+    LE_ASSERT(defaultConfig.bufferSize);
+    LE_ASSERT(defaultConfig.useSplice);
+
+    config = defaultConfig;
+    config.bufferSize = 0;
+    LE_ASSERT(LE_OUT_OF_RANGE == le_media_SetStreamingConfig(&config));
+    config.bufferSize = 1024*1024;
+    LE_ASSERT(LE_OUT_OF_RANGE == le_media_SetStreamingConfig(&config));
+
+    config.bufferSize = 4096;
+    config.periodsCount = 4;
+    LE_ASSERT(LE_OK == le_media_SetStreamingConfig(&config));
+    le_media_GetStreamingConfig(&config);
+    LE_ASSERT(4096 == config.bufferSize);
+    LE_ASSERT(4 == config.periodsCount);
+
+    LE_ASSERT(LE_OK == le_media_SetStreamingConfig(&defaultConfig));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main of the test.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    static const le_media_StreamingConfig_t configs[] =
+    {
+        { .bufferSize = 1024,  .pipeSize = 0,      .periodSize = 256,  .useSplice = false },
+        { .bufferSize = 1024,  .pipeSize = 0,      .periodSize = 256,  .useSplice = true },
+        { .bufferSize = 16384, .pipeSize = 262144, .periodSize = 1024, .useSplice = false },
+        { .bufferSize = 16384, .pipeSize = 262144, .periodSize = 1024, .useSplice = true },
+    };
+    uint32_t i;
+
+    le_media_Init();
+
+    Test_media_StreamingConfig();
+
+    CreatePlayFile();
+    for (i = 0; i < NUM_ARRAY_MEMBERS(configs); i++)
+    {
+        Test_media_Loopback(&configs[i]);
+    }
+
+    unlink(PLAY_FILE);
+    unlink(RECORD_FILE);
+
+    LE_INFO("Media loopback tests passed");
+    exit(0);
+}
@@ -0,0 +1,260 @@
+/**
+ * This module implements a loopback PCM platform adaptor for the media streaming benchmark.
+ *
+ * The playback thread pulls the frames period by period, as fast as possible, and pushes them to
+ * the capture stream if one is started.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "le_audio_local.h"
+#include "pa_pcm.h"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default period size in frames.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFAULT_PERIOD_SIZE     256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * PCM handle.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct pcm_Handle
+{
+    le_audio_SamplePcmConfig_t  config;         ///< PCM configuration
+    uint32_t                    periodBytes;    ///< Period size in bytes
+    GetSetFramesFunc_t          framesFunc;     ///< Get/set frames callback
+    ResultFunc_t                resultFunc;     ///< Result callback
+    void*                       contextPtr;     ///< Callbacks context
+    le_thread_Ref_t             threadRef;      ///< Playback thread
+    bool                        inUse;          ///< Handle is allocated
+}
+Pcm_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Playback and capture handles.
+ */
+//--------------------------------------------------------------------------------------------------
+static Pcm_t PlaybackPcm;
+static Pcm_t CapturePcm;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Capture handle receiving the played frames, or NULL.
+ */
+//--------------------------------------------------------------------------------------------------
+static Pcm_t* LoopbackCapturePtr;
+static le_mutex_Ref_t LoopbackMutex;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a handle.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t InitPcm
+(
+    Pcm_t*                      pcmPtr,
+    pcm_Handle_t*               pcmHandlePtr,
+    le_audio_SamplePcmConfig_t* pcmConfig
+)
+{
+    if (pcmPtr->inUse)
+    {
+        LE_ERROR("PCM already in use");
+        return LE_BUSY;
+    }
+
+    memset(pcmPtr, 0, sizeof(Pcm_t));
+    pcmPtr->config = *pcmConfig;
+    pcmPtr->periodBytes = (pcmConfig->periodSize ? pcmConfig->periodSize : DEFAULT_PERIOD_SIZE) *
+                          pcmConfig->channelsCount * pcmConfig->bitsPerSample / 8;
+    pcmPtr->inUse = true;
+
+    if (!LoopbackMutex)
+    {
+        LoopbackMutex = le_mutex_CreateNonRecursive("LoopbackMutex");
+    }
+
+    *pcmHandlePtr = pcmPtr;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Playback thread: pull the frames and push them to the capture.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* PlaybackThread
+(
+    void* contextPtr
+)
+{
+    Pcm_t*      pcmPtr = contextPtr;
+    uint8_t*    bufferPtr = malloc(pcmPtr->periodBytes);
+    le_result_t res;
+    int         oldState;
+
+    LE_ASSERT(bufferPtr);
+
+    while (1)
+    {
+        uint32_t len = pcmPtr->periodBytes;
+
+        res = pcmPtr->framesFunc(bufferPtr, &len, pcmPtr->contextPtr);
+        if (LE_OK != res)
+        {
+            break;
+        }
+
+        // Not cancelable while the mutex is held
+        pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldState);
+        le_mutex_Lock(LoopbackMutex);
+        if (LoopbackCapturePtr && len)
+        {
+            LoopbackCapturePtr->framesFunc(bufferPtr, &len, LoopbackCapturePtr->contextPtr);
+        }
+        le_mutex_Unlock(LoopbackMutex);
+        pthread_setcancelstate(oldState, NULL);
+    }
+
+    free(bufferPtr);
+
+    pcmPtr->resultFunc(res, pcmPtr->contextPtr);
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the recording.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_pcm_Capture
+(
+    pcm_Handle_t pcmHandle
+)
+{
+    le_mutex_Lock(LoopbackMutex);
+    LoopbackCapturePtr = pcmHandle;
+    le_mutex_Unlock(LoopbackMutex);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the playback.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_pcm_Play
+(
+    pcm_Handle_t pcmHandle
+)
+{
+    pcmHandle->threadRef = le_thread_Create("LoopbackPlayback", PlaybackThread, pcmHandle);
+    le_thread_SetJoinable(pcmHandle->threadRef);
+    le_thread_Start(pcmHandle->threadRef);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close sound driver.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_pcm_Close
+(
+    pcm_Handle_t pcmHandle
+)
+{
+    if (pcmHandle->threadRef)
+    {
+        // The playback thread waits for samples: cancel it
+        le_thread_Cancel(pcmHandle->threadRef);
+        le_thread_Join(pcmHandle->threadRef, NULL);
+        pcmHandle->threadRef = NULL;
+    }
+
+    le_mutex_Lock(LoopbackMutex);
+    if (LoopbackCapturePtr == pcmHandle)
+    {
+        LoopbackCapturePtr = NULL;
+    }
+    le_mutex_Unlock(LoopbackMutex);
+
+    pcmHandle->inUse = false;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the period Size in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t pa_pcm_GetPeriodSize
+(
+    pcm_Handle_t pcmHandle
+)
+{
+    return pcmHandle->periodBytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize sound driver for PCM capture.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_pcm_InitCapture
+(
+    pcm_Handle_t *pcmHandlePtr,
+    char* devicePtr,
+    le_audio_SamplePcmConfig_t* pcmConfig
+)
+{
+    return InitPcm(&CapturePcm, pcmHandlePtr, pcmConfig);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize sound driver for PCM playback.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_pcm_InitPlayback
+(
+    pcm_Handle_t *pcmHandlePtr,
+    char* devicePtr,
+    le_audio_SamplePcmConfig_t* pcmConfig
+)
+{
+    return InitPcm(&PlaybackPcm, pcmHandlePtr, pcmConfig);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the frames and result callbacks.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t pa_pcm_SetCallbackHandlers
+(
+    pcm_Handle_t pcmHandle,
+    GetSetFramesFunc_t framesFunc,
+    ResultFunc_t setResultFunc,
+    void* contextPtr
+)
+{
+    pcmHandle->framesFunc = framesFunc;
+    pcmHandle->resultFunc = setResultFunc;
+    pcmHandle->contextPtr = contextPtr;
+
+    return LE_OK;
+}
@@ -18,6 +18,12 @@ le_sem_Ref_t SemExecOne;
 le_sem_Ref_t SemCreateOne;
 le_sem_Ref_t SemCreateTwo;
 
+// The benchmark creates this many instances of the testOne asset, which has 15 fields, so that
+// the asset has about 10000 resources.
+#define BENCHMARK_INSTANCE_COUNT    667
+#define BENCHMARK_FIRST_INSTANCE_ID 100
+#define BENCHMARK_LOOKUP_ROUNDS     100
+
 
 
 void banner(char *testName)
@@ -397,6 +403,98 @@ void RunTest(void)
 }
 
 
+double ElapsedMicroSec(le_clk_Time_t start)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return elapsed.sec * 1000000.0 + elapsed.usec;
+}
+
+
+void RunBenchmark(void)
+{
+    banner("Large asset lookup and TLV benchmark");
+    assetData_AssetDataRef_t testOneAssetRef;
+    assetData_InstanceDataRef_t instRef;
+    le_clk_Time_t start;
+    double microSec;
+    int instanceId;
+    int fieldId;
+    int value;
+    int round;
+    int i;
+
+    LE_TEST(LE_OK == assetData_GetAssetRefById("testOne", 1000, &testOneAssetRef));
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCHMARK_INSTANCE_COUNT; i++)
+    {
+        LE_TEST(LE_OK == assetData_CreateInstanceById("testOne", 1000,
+                                                      BENCHMARK_FIRST_INSTANCE_ID + i, &instRef));
+    }
+    LE_INFO("Created %i instances in %.0f us", BENCHMARK_INSTANCE_COUNT, ElapsedMicroSec(start));
+
+    // Look up every instance, then a field by name and by id.
+    start = le_clk_GetRelativeTime();
+    for (round = 0; round < BENCHMARK_LOOKUP_ROUNDS; round++)
+    {
+        for (i = 0; i < BENCHMARK_INSTANCE_COUNT; i++)
+        {
+            instanceId = BENCHMARK_FIRST_INSTANCE_ID + i;
+
+            LE_ASSERT(LE_OK == assetData_GetInstanceRefById("testOne", 1000, instanceId, &instRef));
+            LE_ASSERT(LE_OK == assetData_GetFieldIdFromName(instRef, "Bathroom/temp", &fieldId));
+            LE_ASSERT(8 == fieldId);
+            LE_ASSERT(LE_OK == assetData_client_GetInt(instRef, fieldId, &value));
+            LE_ASSERT(21 == value);
+        }
+    }
+    microSec = ElapsedMicroSec(start);
+    LE_INFO("%.3f us per instance, field name and field id lookup",
+            microSec / (BENCHMARK_LOOKUP_ROUNDS * BENCHMARK_INSTANCE_COUNT));
+
+    // Unknown ids and names are still reported as such.
+    LE_TEST(LE_NOT_FOUND == assetData_GetInstanceRefById("testOne", 1000,
+                                                         BENCHMARK_FIRST_INSTANCE_ID - 1,
+                                                         &instRef));
+    LE_TEST(LE_OK == assetData_GetInstanceRefById("testOne", 1000,
+                                                  BENCHMARK_FIRST_INSTANCE_ID, &instRef));
+    LE_TEST(LE_NOT_FOUND == assetData_client_GetInt(instRef, 15, &value));
+    LE_TEST(LE_FAULT == assetData_GetFieldIdFromName(instRef, "Attic/temp", &fieldId));
+
+    // The object TLV is larger than any fixed response buffer would reasonably be, and must be
+    // exactly the size computed beforehand.
+    size_t tlvNumBytes;
+    size_t bytesWritten;
+    uint8_t* tlvBufferPtr;
+
+    start = le_clk_GetRelativeTime();
+    LE_TEST(LE_OK == assetData_GetObjectTLVSize(testOneAssetRef, -1, &tlvNumBytes));
+    tlvBufferPtr = malloc(tlvNumBytes);
+    LE_ASSERT(NULL != tlvBufferPtr);
+    LE_TEST(LE_OK == assetData_WriteObjectToTLV(testOneAssetRef, -1,
+                                                tlvBufferPtr, tlvNumBytes, &bytesWritten));
+    LE_INFO("Wrote %zu bytes of object TLV in %.0f us", bytesWritten, ElapsedMicroSec(start));
+    LE_TEST(tlvNumBytes == bytesWritten);
+
+    LE_TEST(LE_OVERFLOW == assetData_WriteObjectToTLV(testOneAssetRef, -1,
+                                                      tlvBufferPtr, tlvNumBytes - 1,
+                                                      &bytesWritten));
+    free(tlvBufferPtr);
+
+    // Deleted instances can no longer be looked up.
+    for (i = 0; i < BENCHMARK_INSTANCE_COUNT; i++)
+    {
+        instanceId = BENCHMARK_FIRST_INSTANCE_ID + i;
+
+        LE_ASSERT(LE_OK == assetData_GetInstanceRefById("testOne", 1000, instanceId, &instRef));
+        assetData_DeleteInstance(instRef);
+        LE_ASSERT(LE_NOT_FOUND == assetData_GetInstanceRefById("testOne", 1000, instanceId,
+                                                               &instRef));
+    }
+}
+
+
 COMPONENT_INIT
 {
     LE_TEST_INIT;
@@ -412,6 +510,7 @@ COMPONENT_INIT
     SemCreateTwo = le_sem_Create("SemCreateTwo", 0);
 
     RunTest();
+    RunBenchmark();
 
     LE_TEST_EXIT;
 }
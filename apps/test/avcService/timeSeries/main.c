@@ -0,0 +1,398 @@
+/**
+ * This module implements the unit tests and the benchmark of the time series encoder.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "timeSeries.h"
+#include "zlib.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of payloads filled by the benchmark, for each data type.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCHMARK_PAYLOAD_COUNT     200
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of an uncompressed payload.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_MAX_NUMBYTES           (64 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of payloads queued by the queue test, more than the queue holds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUEUED_PAYLOAD_COUNT        70
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of payloads the queue holds.
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUEUE_MAX_PAYLOADS          64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data types of the samples.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    SAMPLE_INT,
+    SAMPLE_FLOAT,
+    SAMPLE_BOOL,
+    SAMPLE_STRING
+}
+SampleType_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asset id expected by SendHandler() for the next payload.
+ */
+//--------------------------------------------------------------------------------------------------
+static int ExpectedAssetId;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asset id of the payload SendHandler() fails to send, or -1.
+ */
+//--------------------------------------------------------------------------------------------------
+static int FailedAssetId = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asset id of the payload SendHandler() reports as no longer observed, or -1.
+ */
+//--------------------------------------------------------------------------------------------------
+static int DroppedAssetId = -1;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data of the queued payloads.  Payload n is made of the first n bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t QueuedData[QUEUED_PAYLOAD_COUNT];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Uncompress a payload.
+ *
+ * @return
+ *      Number of bytes of CBOR data.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t Uncompress
+(
+    uint8_t* payloadPtr,
+    size_t payloadNumBytes,
+    uint8_t* cborPtr
+)
+{
+    z_stream zStream;
+
+    memset(&zStream, 0, sizeof(zStream));
+    LE_ASSERT(Z_OK == inflateInit(&zStream));
+
+    zStream.next_in = payloadPtr;
+    zStream.avail_in = payloadNumBytes;
+    zStream.next_out = cborPtr;
+    zStream.avail_out = CBOR_MAX_NUMBYTES;
+
+    LE_ASSERT(Z_STREAM_END == inflate(&zStream, Z_FINISH));
+    LE_ASSERT(0 == zStream.avail_in);
+    inflateEnd(&zStream);
+
+    return zStream.total_out;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the sample number n of a slowly varying signal, sampled every second.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddSample
+(
+    timeSeries_Ref_t ref,
+    SampleType_t type,
+    uint32_t n
+)
+{
+    char string[32];
+    uint64_t utcMilliSec = 1500000000000ULL + (uint64_t)n * 1000;
+
+    switch (type)
+    {
+        case SAMPLE_INT:
+            return timeSeries_AddInt(ref, utcMilliSec, 20 + (n / 7) % 5);
+
+        case SAMPLE_FLOAT:
+            return timeSeries_AddFloat(ref, utcMilliSec, 20.0 + ((n / 3) % 50) * 0.1);
+
+        case SAMPLE_BOOL:
+            return timeSeries_AddBool(ref, utcMilliSec, (n / 10) % 2);
+
+        case SAMPLE_STRING:
+            snprintf(string, sizeof(string), "state %u", (n / 20) % 4);
+            return timeSeries_AddString(ref, utcMilliSec, string);
+    }
+
+    return LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add samples until the time series is full.
+ *
+ * @return
+ *      Number of samples added.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t Fill
+(
+    timeSeries_Ref_t ref,
+    SampleType_t type
+)
+{
+    uint32_t n = 0;
+    le_result_t result;
+
+    do
+    {
+        result = AddSample(ref, type, n++);
+        LE_ASSERT((LE_OK == result) || (LE_NO_MEMORY == result));
+    }
+    while (LE_OK == result);
+
+    LE_ASSERT(n == timeSeries_GetSampleCount(ref));
+
+    return n;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a payload is a whole time series.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckPayload
+(
+    timeSeries_Ref_t ref
+)
+{
+    static uint8_t cbor[CBOR_MAX_NUMBYTES];
+    uint8_t* payloadPtr;
+    size_t payloadNumBytes;
+    size_t cborNumBytes;
+
+    LE_ASSERT(LE_OK == timeSeries_Finish(ref, &payloadPtr, &payloadNumBytes));
+    LE_ASSERT(payloadNumBytes <= TIMESERIES_PAYLOAD_MAX_NUMBYTES);
+
+    cborNumBytes = Uncompress(payloadPtr, payloadNumBytes, cbor);
+
+    // A map of three entries, closed by the break of the sample array.
+    LE_ASSERT(0xA3 == cbor[0]);
+    LE_ASSERT(0xFF == cbor[cborNumBytes - 1]);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test filling, finishing and restarting a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_timeSeries_Fill
+(
+    void
+)
+{
+    timeSeries_Ref_t ref;
+    uint8_t* payloadPtr;
+    size_t payloadNumBytes;
+    uint32_t count;
+
+    LE_ASSERT(LE_OK == timeSeries_Create("/0/1", 1, 1, &ref));
+    LE_ASSERT(0 == timeSeries_GetSampleCount(ref));
+
+    // Once full, a sample is refused and leaves the time series untouched.
+    count = Fill(ref, SAMPLE_STRING);
+    LE_ASSERT(LE_OVERFLOW == AddSample(ref, SAMPLE_STRING, count));
+    LE_ASSERT(count == timeSeries_GetSampleCount(ref));
+    CheckPayload(ref);
+
+    // Nothing can be added once finished, and finishing again gives the same payload.
+    LE_ASSERT(LE_OVERFLOW == AddSample(ref, SAMPLE_INT, 0));
+    LE_ASSERT(LE_OK == timeSeries_Finish(ref, &payloadPtr, &payloadNumBytes));
+
+    LE_ASSERT(LE_OK == timeSeries_Restart(ref));
+    LE_ASSERT(0 == timeSeries_GetSampleCount(ref));
+    LE_ASSERT(LE_OK == AddSample(ref, SAMPLE_INT, 0));
+    CheckPayload(ref);
+
+    timeSeries_Delete(ref);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure, for each data type, how fast samples are added and how many bytes each one takes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_timeSeries_Benchmark
+(
+    void
+)
+{
+    static const char* typeNames[] = { "int", "float", "bool", "string" };
+    static uint8_t cbor[CBOR_MAX_NUMBYTES];
+    SampleType_t type;
+
+    for (type = SAMPLE_INT; type <= SAMPLE_STRING; type++)
+    {
+        timeSeries_Ref_t ref;
+        uint8_t* payloadPtr;
+        size_t payloadNumBytes = 0;
+        size_t cborNumBytes = 0;
+        uint64_t sampleCount = 0;
+        le_clk_Time_t start;
+        le_clk_Time_t elapsed;
+        double seconds;
+        int i;
+
+        LE_ASSERT(LE_OK == timeSeries_Create("/0/1", (SAMPLE_FLOAT == type) ? 10 : 1, 1, &ref));
+
+        start = le_clk_GetRelativeTime();
+        for (i = 0; i < BENCHMARK_PAYLOAD_COUNT; i++)
+        {
+            sampleCount += Fill(ref, type);
+            LE_ASSERT(LE_OK == timeSeries_Finish(ref, &payloadPtr, &payloadNumBytes));
+            LE_ASSERT(LE_OK == timeSeries_Restart(ref));
+        }
+        elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+        seconds = elapsed.sec + elapsed.usec / 1000000.0;
+
+        Fill(ref, type);
+        LE_ASSERT(LE_OK == timeSeries_Finish(ref, &payloadPtr, &payloadNumBytes));
+        cborNumBytes = Uncompress(payloadPtr, payloadNumBytes, cbor);
+
+        LE_INFO("%-6s: %.0f samples/s, %u samples/payload, %.2f bytes/sample (%.2f uncompressed)",
+                typeNames[type],
+                sampleCount / seconds,
+                timeSeries_GetSampleCount(ref),
+                (double)payloadNumBytes / timeSeries_GetSampleCount(ref),
+                (double)cborNumBytes / timeSeries_GetSampleCount(ref));
+
+        timeSeries_Delete(ref);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler of the queued payloads: checks that they come oldest first and whole.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendHandler
+(
+    char* appNamePtr,
+    int assetId,
+    int instanceId,
+    int fieldId,
+    uint8_t* payloadPtr,
+    size_t payloadNumBytes
+)
+{
+    LE_ASSERT(0 == strcmp(appNamePtr, "testApp"));
+    LE_ASSERT(ExpectedAssetId == assetId);
+    LE_ASSERT(assetId + 1 == instanceId);
+    LE_ASSERT(assetId + 2 == fieldId);
+    LE_ASSERT((size_t)assetId == payloadNumBytes);
+    LE_ASSERT(0 == memcmp(payloadPtr, QueuedData, payloadNumBytes));
+
+    if (FailedAssetId == assetId)
+    {
+        return LE_UNAVAILABLE;
+    }
+
+    ExpectedAssetId++;
+
+    return (DroppedAssetId == assetId) ? LE_NOT_FOUND : LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that the queue keeps the most recent payloads, and sends them in order.  A payload that
+ * could not be sent stays queued, with the ones after it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_timeSeries_Queue
+(
+    void
+)
+{
+    int assetId;
+
+    for (assetId = 0; assetId < QUEUED_PAYLOAD_COUNT; assetId++)
+    {
+        QueuedData[assetId] = assetId * 7;
+    }
+
+    for (assetId = 0; assetId < QUEUED_PAYLOAD_COUNT; assetId++)
+    {
+        LE_ASSERT(LE_OK == timeSeries_QueuePayload("testApp",
+                                                   assetId,
+                                                   assetId + 1,
+                                                   assetId + 2,
+                                                   QueuedData,
+                                                   assetId));
+    }
+
+    // The send of payload 20 fails: it is kept, and nothing after it is sent.
+    ExpectedAssetId = QUEUED_PAYLOAD_COUNT - QUEUE_MAX_PAYLOADS;
+    FailedAssetId = 20;
+    DroppedAssetId = 30;
+    timeSeries_SendQueued(SendHandler);
+    LE_ASSERT(20 == ExpectedAssetId);
+
+    timeSeries_SendQueued(SendHandler);
+    LE_ASSERT(20 == ExpectedAssetId);
+
+    // Once sends succeed again, the queue resumes from payload 20.  Payload 30 is dropped, and
+    // the queue moves on.
+    FailedAssetId = -1;
+    timeSeries_SendQueued(SendHandler);
+    LE_ASSERT(QUEUED_PAYLOAD_COUNT == ExpectedAssetId);
+
+    // Nothing left to send.
+    timeSeries_SendQueued(SendHandler);
+    LE_ASSERT(QUEUED_PAYLOAD_COUNT == ExpectedAssetId);
+}
+
+
+COMPONENT_INIT
+{
+    char queueDir[] = "/tmp/timeSeriesTestXXXXXX";
+
+    LE_ASSERT(NULL != mkdtemp(queueDir));
+    timeSeries_Init(queueDir);
+
+    // tests
+    Test_timeSeries_Fill();
+    Test_timeSeries_Queue();
+    Test_timeSeries_Benchmark();
+
+    le_dir_RemoveRecursive(queueDir);
+
+    LE_INFO("Time series tests passed");
+    exit(0);
+}
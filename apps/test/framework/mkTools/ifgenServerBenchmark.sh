@@ -0,0 +1,62 @@
+#!/bin/bash
+#
+# Compare the time a system build spends generating IPC code with ifgen run once per interface
+# and with the ifgen server.  Only the ifgen steps of the build are run, so no compiler is needed.
+#
+# Usage: ifgenServerBenchmark.sh [SDEF_FILE [TARGET]]
+#
+# Defaults to $LEGATO_ROOT/default.sdef and localhost.
+#
+# Copyright (C) Sierra Wireless Inc.
+
+export PATH=$LEGATO_ROOT/bin:$PATH
+
+SDEF=${1:-$LEGATO_ROOT/default.sdef}
+TARGET=${2:-localhost}
+
+WORK_DIR=$(mktemp -d)
+trap "rm -rf $WORK_DIR" EXIT
+
+# Generate the system's interface code in a fresh directory, with IFGEN_SERVER set as given.
+function Generate
+{
+    local name=$1
+    local dir=$WORK_DIR/$name
+
+    if ! mksys $SDEF -t $TARGET -w $dir -o $dir --dont-run-ninja > $WORK_DIR/$name.log 2>&1
+    then
+        cat $WORK_DIR/$name.log
+        echo "FAILED: mksys failed."
+        exit 1
+    fi
+
+    local targets=$(ninja -f $dir/build.ninja -t targets rule GenInterfaceCode)
+    local count=$(echo "$targets" | wc -l)
+
+    local start=$(date +%s%N)
+
+    if ! ninja -f $dir/build.ninja $targets >> $WORK_DIR/$name.log 2>&1
+    then
+        cat $WORK_DIR/$name.log
+        echo "FAILED: ninja failed."
+        exit 1
+    fi
+
+    local end=$(date +%s%N)
+
+    echo "$name: $count files generated in $(( (end - start) / 1000000 )) ms"
+}
+
+IFGEN_SERVER= Generate ifgen
+
+unset IFGEN_SERVER
+Generate ifgenServer
+
+# The generated files must be the same.
+if ! diff -r -x '*.ninja*' -x 'ifgen.sock*' -x 'mktool_*' -x '*.log' \
+          $WORK_DIR/ifgen $WORK_DIR/ifgenServer > $WORK_DIR/diff.log
+then
+    sed -n 1,20p $WORK_DIR/diff.log
+    echo "FAILED: the ifgen server generated different files."
+    exit 1
+fi
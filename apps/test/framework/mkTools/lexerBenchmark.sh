@@ -0,0 +1,62 @@
+#!/bin/bash
+#
+# Measure how fast the mk tools lex and parse definition files: generate an app whose .adef
+# includes a set of large .sinc files (comments, whitespace and file paths), run mkapp on it
+# without running ninja, and report the throughput.
+#
+# Usage: lexerBenchmark.sh [MKAPP [LINE_COUNT]]
+#
+# Defaults to $LEGATO_ROOT/bin/mkapp and 200000 lines.  Run it with the mkapp from two builds to
+# compare them.
+#
+# Copyright (C) Sierra Wireless Inc.
+
+MKAPP=${1:-$LEGATO_ROOT/bin/mkapp}
+LINE_COUNT=${2:-200000}
+INCLUDE_COUNT=10
+
+WORK_DIR=$(mktemp -d)
+trap "rm -rf $WORK_DIR" EXIT
+
+# Generate the .sinc files.
+for ((i = 0; i < INCLUDE_COUNT; i++))
+do
+    awk -v lines=$((LINE_COUNT / INCLUDE_COUNT)) -v inc=$i 'BEGIN {
+        print "requires:\n{\n    file:\n    {"
+        for (n = 0; n < lines; n += 4)
+        {
+            print "        // Line " n " of include " inc ", a C++ style comment."
+            print "        /* A C style comment,"
+            print "           spanning two lines. */"
+            print "        /dev/file" inc "_" n "    /var/run/file" inc "_" n
+        }
+        print "    }\n}"
+    }' > $WORK_DIR/part$i.sinc
+done
+
+{
+    echo "sandboxed: false"
+    for ((i = 0; i < INCLUDE_COUNT; i++))
+    do
+        echo "#include \"part$i.sinc\""
+    done
+} > $WORK_DIR/lexerBenchmark.adef
+
+BYTES=$(cat $WORK_DIR/*.sinc $WORK_DIR/*.adef | wc -c)
+
+START=$(date +%s%N)
+
+if ! (cd $WORK_DIR && $MKAPP lexerBenchmark.adef -t localhost -w $WORK_DIR/build -o $WORK_DIR \
+                             --dont-run-ninja > $WORK_DIR/mkapp.log 2>&1)
+then
+    cat $WORK_DIR/mkapp.log
+    echo "FAILED: mkapp failed."
+    exit 1
+fi
+
+END=$(date +%s%N)
+
+MS=$(( (END - START) / 1000000 ))
+
+echo "Parsed $BYTES bytes in $LINE_COUNT lines in $MS ms" \
+     "($(( BYTES / 1024 * 1000 / (MS > 0 ? MS : 1) )) KiB/s)."
@@ -0,0 +1,28 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Component used to check that a no-op rebuild doesn't recompile anything.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Does nothing.
+ */
+//--------------------------------------------------------------------------------------------------
+void noOpRebuild_Ping
+(
+    void
+)
+{
+}
+
+
+COMPONENT_INIT
+{
+}
@@ -0,0 +1,122 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tests the accounting of the space used by an app with many items in secure storage, and measures
+ * the latency of its writes.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+#define NUM_ITEMS               1000
+#define NUM_REWRITES            1000
+#define ITEM_SIZE               4
+
+static uint8_t bigItem[LE_SECSTORE_MAX_ITEM_SIZE];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes an item, and checks the result.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteItem
+(
+    const char* namePtr,
+    const uint8_t* bufPtr,
+    size_t bufSize,
+    le_result_t expectedResult
+)
+{
+    le_result_t result = le_secStore_Write(namePtr, bufPtr, bufSize);
+    LE_FATAL_IF(result != expectedResult,
+                "Writing %zd bytes to '%s' returned %s instead of %s.",
+                bufSize, namePtr, LE_RESULT_TXT(result), LE_RESULT_TXT(expectedResult));
+}
+
+COMPONENT_INIT
+{
+    LE_INFO("=====================================================================");
+    LE_INFO("==================== SecStoreTest3 BEGIN ============================");
+    LE_INFO("=====================================================================");
+
+    // Get the secure storage limit from the argument list.
+    int limit;
+    le_result_t result = le_arg_GetIntOption(&limit, "l", NULL);
+    LE_FATAL_IF(result != LE_OK,
+                "Could not get storage limit.  %s.", LE_RESULT_TXT(result));
+    LE_FATAL_IF((limit < NUM_ITEMS * ITEM_SIZE) ||
+                (limit - NUM_ITEMS * ITEM_SIZE + 1 > sizeof(bigItem)),
+                "Storage limit %d does not suit %d items.", limit, NUM_ITEMS);
+
+    // Fill the app's area with many small items.
+    char itemName[100];
+    uint32_t i;
+
+    for (i = 0; i < NUM_ITEMS; i++)
+    {
+        snprintf(itemName, sizeof(itemName), "item%u", i);
+        WriteItem(itemName, (uint8_t*)&i, ITEM_SIZE, LE_OK);
+    }
+
+    LE_INFO("Wrote %d items.", NUM_ITEMS);
+
+    // Measure the latency of rewriting the items.
+    le_clk_Time_t start = le_clk_GetRelativeTime();
+
+    for (i = 0; i < NUM_REWRITES; i++)
+    {
+        uint32_t value = i + 1;
+
+        snprintf(itemName, sizeof(itemName), "item%u", i % NUM_ITEMS);
+        WriteItem(itemName, (uint8_t*)&value, ITEM_SIZE, LE_OK);
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    LE_INFO("Average write latency with %d items: %.1f us.",
+            NUM_ITEMS, (elapsed.sec * 1000000.0 + elapsed.usec) / NUM_REWRITES);
+
+    // The items take up all but the remaining space, which a new item can fill but not exceed.
+    size_t remaining = limit - NUM_ITEMS * ITEM_SIZE;
+
+    WriteItem("big", bigItem, remaining + 1, LE_NO_MEMORY);
+    WriteItem("big", bigItem, remaining, LE_OK);
+    WriteItem("one", bigItem, 1, LE_NO_MEMORY);
+
+    // Replacing an item only accounts for the difference in size.
+    WriteItem("big", bigItem, remaining - 1, LE_OK);
+    WriteItem("one", bigItem, 1, LE_OK);
+
+    // Deleting items frees their space.
+    result = le_secStore_Delete("NonExistence");
+    LE_FATAL_IF(result != LE_NOT_FOUND,
+                "Should have failed to delete non-existent item.  %s.", LE_RESULT_TXT(result));
+
+    result = le_secStore_Delete("one");
+    LE_FATAL_IF(result != LE_OK, "Failed to delete item 'one'.  %s.", LE_RESULT_TXT(result));
+
+    result = le_secStore_Delete("item0");
+    LE_FATAL_IF(result != LE_OK, "Failed to delete item 'item0'.  %s.", LE_RESULT_TXT(result));
+
+    WriteItem("big", bigItem, remaining + ITEM_SIZE + 1, LE_NO_MEMORY);
+    WriteItem("big", bigItem, remaining + ITEM_SIZE, LE_OK);
+
+    // clean-up
+    LE_INFO("Clean up...");
+    result = le_secStore_Delete("big");
+    LE_FATAL_IF(result != LE_OK, "Failed to delete item 'big'.  %s.", LE_RESULT_TXT(result));
+
+    for (i = 1; i < NUM_ITEMS; i++)
+    {
+        snprintf(itemName, sizeof(itemName), "item%u", i);
+
+        result = le_secStore_Delete(itemName);
+        LE_FATAL_IF(result != LE_OK,
+                    "Could not delete item '%s'.  %s.", itemName, LE_RESULT_TXT(result));
+    }
+
+    LE_INFO("============ SecStoreTest3 PASSED =============");
+
+    exit(EXIT_SUCCESS);
+}
@@ -40,6 +40,19 @@ le_msg_ServiceRef_t secStoreAdmin_GetServiceRef
     return NULL;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the server service reference
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_ServiceRef_t le_secStore_GetServiceRef
+(
+    void
+)
+{
+    return NULL;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stub the client session reference for the current message for le_secStore
@@ -0,0 +1,188 @@
+/**
+ * Round-trip test of the app hash the update daemon computes to check delta updates.
+ *
+ * Takes the staging area of an app built by mkapp, and checks that delta_ComputeAppMd5() gives the
+ * hash mkapp wrote in the app's info.properties.  Then copies the app and applies an empty delta
+ * to the copy, which must be accepted, and a delta adding a file, which must be rejected, as must
+ * deltas removing or patching files through a symlinked directory.
+ *
+ * Usage: deltaMd5Test STAGING_DIR
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "limit.h"
+#include "delta.h"
+
+
+/// Working directory.
+static char WorkDir[] = "/tmp/deltaMd5TestXXXXXX";
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a shell command, failing the test if it fails.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Run
+(
+    const char* commandPtr
+)
+{
+    int status = system(commandPtr);
+    LE_FATAL_IF(!WIFEXITED(status) || WEXITSTATUS(status) != 0, "'%s' failed.", commandPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the app.md5 property of an app's info.properties.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReadAppMd5
+(
+    const char* dirPath,
+    char md5Str[LIMIT_MD5_STR_BYTES]
+)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/info.properties", dirPath);
+
+    FILE* filePtr = fopen(path, "r");
+    LE_FATAL_IF(filePtr == NULL, "Failed to open '%s' (%m).", path);
+
+    char line[256];
+    bool found = false;
+
+    while (!found && (fgets(line, sizeof(line), filePtr) != NULL))
+    {
+        found = (sscanf(line, "app.md5=%32s", md5Str) == 1);
+    }
+
+    fclose(filePtr);
+
+    LE_FATAL_IF(!found, "No app.md5 in '%s'.", path);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute an app's hash with the shell pipeline app build scripts used before "mk app-md5".
+ */
+//--------------------------------------------------------------------------------------------------
+static void ShellMd5
+(
+    const char* dirPath,
+    char md5Str[LIMIT_MD5_STR_BYTES]
+)
+{
+    char command[PATH_MAX * 2];
+    snprintf(command, sizeof(command),
+             "cd %s && rm -f info.properties && ("
+             " find -P -print0 | LC_ALL=C sort -z &&"
+             " find -P -type f -print0 | LC_ALL=C sort -z | xargs -0 md5sum &&"
+             " find -P -type l -print0 | LC_ALL=C sort -z | xargs -0 -r -n 1 readlink"
+             " ) | md5sum",
+             dirPath);
+
+    FILE* pipePtr = popen(command, "r");
+    LE_ASSERT(pipePtr != NULL);
+    LE_ASSERT(fscanf(pipePtr, "%32s", md5Str) == 1);
+    LE_ASSERT(pclose(pipePtr) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy an app's files into a new unpack directory, and give it an empty delta manifest.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MakeUnpackDir
+(
+    const char* stagingPath,
+    const char* dirPath
+)
+{
+    char command[PATH_MAX * 3];
+    snprintf(command, sizeof(command),
+             "rm -rf %s && cp -a %s %s && mkdir %s/.delta && touch %s/.delta/manifest",
+             dirPath, stagingPath, dirPath, dirPath, dirPath);
+    Run(command);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    const char* stagingPath = le_arg_GetArg(0);
+    LE_FATAL_IF(stagingPath == NULL, "Usage: deltaMd5Test STAGING_DIR");
+
+    LE_ASSERT(mkdtemp(WorkDir) != NULL);
+
+    char expectedMd5[LIMIT_MD5_STR_BYTES];
+    char md5[LIMIT_MD5_STR_BYTES];
+
+    ReadAppMd5(stagingPath, expectedMd5);
+    LE_INFO("mkapp hash of '%s': %s", stagingPath, expectedMd5);
+
+    // The staging area, info.properties included, as installed on the target.
+    LE_TEST(delta_ComputeAppMd5(stagingPath, md5) == LE_OK);
+    LE_TEST(strcmp(md5, expectedMd5) == 0);
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/", stagingPath);
+    LE_TEST(delta_ComputeAppMd5(path, md5) == LE_OK);
+    LE_TEST(strcmp(md5, expectedMd5) == 0);
+
+    // An empty delta leaves the app as it is.
+    char unpackPath[sizeof(WorkDir) + 16];
+    snprintf(unpackPath, sizeof(unpackPath), "%s/unpack", WorkDir);
+    MakeUnpackDir(stagingPath, unpackPath);
+    LE_TEST(delta_Apply(unpackPath, expectedMd5) == LE_OK);
+
+    snprintf(path, sizeof(path), "%s/.delta", unpackPath);
+    LE_TEST(access(path, F_OK) != 0);
+
+    // A delta that adds a file doesn't give the expected app.
+    MakeUnpackDir(stagingPath, unpackPath);
+    snprintf(path, sizeof(path), "echo extra > %s/extra", unpackPath);
+    Run(path);
+    LE_TEST(delta_Apply(unpackPath, expectedMd5) == LE_FORMAT_ERROR);
+
+    // A symlinked directory in the base app doesn't let a delta remove or patch outside the app.
+    MakeUnpackDir(stagingPath, unpackPath);
+    snprintf(path, sizeof(path),
+             "mkdir %s/outside && echo victim > %s/outside/victim && ln -s ../outside %s/link"
+             " && echo 'remove link/victim' > %s/.delta/manifest",
+             WorkDir, WorkDir, unpackPath, unpackPath);
+    Run(path);
+    LE_TEST(delta_Apply(unpackPath, expectedMd5) == LE_FORMAT_ERROR);
+
+    MakeUnpackDir(stagingPath, unpackPath);
+    snprintf(path, sizeof(path),
+             "ln -s ../outside %s/link && echo 'patch link/victim' > %s/.delta/manifest",
+             unpackPath, unpackPath);
+    Run(path);
+    LE_TEST(delta_Apply(unpackPath, expectedMd5) == LE_FORMAT_ERROR);
+
+    snprintf(path, sizeof(path), "grep -qx victim %s/outside/victim", WorkDir);
+    Run(path);
+
+    // Without any regular file besides info.properties, md5sum hashes its empty standard input.
+    char shellMd5[LIMIT_MD5_STR_BYTES];
+    snprintf(path, sizeof(path),
+             "mkdir -p %s/empty/dir && ln -s dir %s/empty/link && cp %s/info.properties %s/empty",
+             WorkDir, WorkDir, stagingPath, WorkDir);
+    Run(path);
+    snprintf(path, sizeof(path), "%s/empty", WorkDir);
+    LE_TEST(delta_ComputeAppMd5(path, md5) == LE_OK);
+    ShellMd5(path, shellMd5);
+    LE_TEST(strcmp(md5, shellMd5) == 0);
+
+    snprintf(path, sizeof(path), "rm -rf %s", WorkDir);
+    Run(path);
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,238 @@
+/**
+ * Throughput benchmark for the update daemon's in-process payload extractor.
+ *
+ * Builds a large synthetic app staging area, packs it the way mkapp does (a bzip2 compressed
+ * tarball), then unpacks it twice:
+ *
+ *  - the old way: copying the payload 1 KB at a time into a pipe to a forked "tar xjop";
+ *  - the new way: reading 64 KB at a time and feeding the extractor and the MD5 hash in one pass.
+ *
+ * Both results are compared, and the throughput of each is reported.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "limit.h"
+#include "untar.h"
+#include "md5.h"
+
+
+/// Number of files in the synthetic app.
+#define FILE_COUNT          200
+
+/// Size of each file in the synthetic app.
+#define FILE_BYTES          (160 * 1024)
+
+/// Working directory.
+static char WorkDir[] = "/tmp/unpackBenchXXXXXX";
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a shell command, failing the test if it fails.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Run
+(
+    const char* commandPtr
+)
+{
+    int status = system(commandPtr);
+    LE_FATAL_IF(!WIFEXITED(status) || WEXITSTATUS(status) != 0, "'%s' failed.", commandPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the staging area and the tarball.  The file contents are half random and half repeated
+ * text, so that they compress about as well as typical binaries.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MakePackage
+(
+    void
+)
+{
+    char path[PATH_MAX];
+    static uint8_t data[FILE_BYTES];
+    int i;
+
+    for (i = 0; i < FILE_COUNT; i++)
+    {
+        snprintf(path, sizeof(path), "%s/staging/%s/file%d", WorkDir, (i % 2) ? "bin" : "lib", i);
+
+        if (i < 2)
+        {
+            char dirPath[PATH_MAX];
+            LE_ASSERT(le_path_GetDir(path, "/", dirPath, sizeof(dirPath)) == LE_OK);
+            LE_ASSERT(le_dir_MakePath(dirPath, 0755) == LE_OK);
+        }
+
+        size_t j;
+        for (j = 0; j < sizeof(data); j++)
+        {
+            data[j] = (j % 1024 < 512) ? (uint8_t)random() : (uint8_t)("legato"[j % 6]);
+        }
+
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        LE_ASSERT(fd >= 0);
+        LE_ASSERT(write(fd, data, sizeof(data)) == sizeof(data));
+        close(fd);
+    }
+
+    char command[PATH_MAX * 2];
+    snprintf(command, sizeof(command),
+             "cd %s/staging && find . -print0 | LC_ALL=C sort -z"
+             " | tar --no-recursion --null -T - -cjf %s/app.tar.bz2",
+             WorkDir, WorkDir);
+    Run(command);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time since a given start time, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+static double ElapsedMs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return elapsed.sec * 1000.0 + elapsed.usec / 1000.0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack by copying the payload through a pipe to tar, 1 KB at a time.
+ *
+ * @return Time taken, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+static double UnpackWithTar
+(
+    const char* dirPath
+)
+{
+    char command[PATH_MAX * 2];
+    snprintf(command, sizeof(command), "mkdir -p %s && tar xjop -C %s", dirPath, dirPath);
+
+    char tarPath[PATH_MAX];
+    snprintf(tarPath, sizeof(tarPath), "%s/app.tar.bz2", WorkDir);
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    int inFd = open(tarPath, O_RDONLY);
+    LE_ASSERT(inFd >= 0);
+
+    FILE* pipePtr = popen(command, "w");
+    LE_ASSERT(pipePtr != NULL);
+
+    char buffer[1024];
+    ssize_t len;
+    while ((len = read(inFd, buffer, sizeof(buffer))) > 0)
+    {
+        LE_ASSERT(write(fileno(pipePtr), buffer, len) == len);
+    }
+
+    close(inFd);
+    LE_ASSERT(pclose(pipePtr) == 0);
+
+    return ElapsedMs(startTime);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack in-process, hashing the payload in the same pass.
+ *
+ * @return Time taken, in ms.
+ */
+//--------------------------------------------------------------------------------------------------
+static double UnpackInProcess
+(
+    const char* dirPath,
+    char md5Str[LIMIT_MD5_STR_BYTES]
+)
+{
+    char tarPath[PATH_MAX];
+    snprintf(tarPath, sizeof(tarPath), "%s/app.tar.bz2", WorkDir);
+
+    LE_ASSERT(le_dir_MakePath(dirPath, 0755) == LE_OK);
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    int inFd = open(tarPath, O_RDONLY);
+    LE_ASSERT(inFd >= 0);
+
+    untar_Ref_t extractor = untar_Create(dirPath);
+    md5_Ctx_t md5Ctx;
+    md5_Init(&md5Ctx);
+
+    static char buffer[64 * 1024];
+    ssize_t len;
+    while ((len = read(inFd, buffer, sizeof(buffer))) > 0)
+    {
+        md5_Update(&md5Ctx, buffer, len);
+        LE_TEST(untar_Write(extractor, buffer, len) == LE_OK);
+    }
+
+    close(inFd);
+
+    LE_TEST(untar_Finish(extractor) == LE_OK);
+    untar_Delete(extractor);
+    md5_Final(&md5Ctx, md5Str);
+
+    return ElapsedMs(startTime);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_ASSERT(mkdtemp(WorkDir) != NULL);
+
+    untar_Init();
+
+    MakePackage();
+
+    char tarPath[PATH_MAX];
+    snprintf(tarPath, sizeof(tarPath), "%s/app.tar.bz2", WorkDir);
+    struct stat st;
+    LE_ASSERT(stat(tarPath, &st) == 0);
+
+    char tarDir[PATH_MAX];
+    char inProcDir[PATH_MAX];
+    snprintf(tarDir, sizeof(tarDir), "%s/tar", WorkDir);
+    snprintf(inProcDir, sizeof(inProcDir), "%s/inProc", WorkDir);
+
+    double tarMs = UnpackWithTar(tarDir);
+
+    char md5Str[LIMIT_MD5_STR_BYTES];
+    double inProcMs = UnpackInProcess(inProcDir, md5Str);
+
+    double mb = (double)FILE_COUNT * FILE_BYTES / (1024 * 1024);
+
+    LE_INFO("Package: %d files, %.1f MB unpacked, %lld bytes compressed.",
+            FILE_COUNT, mb, (long long)st.st_size);
+    LE_INFO("pipe to tar:  %8.1f ms  %6.1f MB/s", tarMs, mb * 1000 / tarMs);
+    LE_INFO("in-process:   %8.1f ms  %6.1f MB/s (MD5 included)", inProcMs, mb * 1000 / inProcMs);
+
+    // Both ways must produce the same tree, and the MD5 must match md5sum's.
+    char command[PATH_MAX * 4];
+    snprintf(command, sizeof(command), "diff -r %s %s", tarDir, inProcDir);
+    LE_TEST(system(command) == 0);
+
+    snprintf(command, sizeof(command), "md5sum %s | grep -q '^%s '", tarPath, md5Str);
+    LE_TEST(system(command) == 0);
+
+    snprintf(command, sizeof(command), "rm -rf %s", WorkDir);
+    Run(command);
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,222 @@
+/**
+ * Test that the update daemon's payload extractor never writes outside the unpack directory.
+ *
+ * Each tarball is built with the system's tar from two source trees, so that an entry of the
+ * first (a symlink) can be followed by an entry of the second going through it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "limit.h"
+#include "untar.h"
+
+
+/// Working directory.
+static char WorkDir[] = "/tmp/untarTestXXXXXX";
+
+/// Directory that must never be written to.
+static char OutsideDir[sizeof(WorkDir) + 16];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a shell command, failing the test if it fails.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Run
+(
+    const char* commandPtr
+)
+{
+    int status = system(commandPtr);
+    LE_FATAL_IF(!WIFEXITED(status) || WEXITSTATUS(status) != 0, "'%s' failed.", commandPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extract a tarball in-process into a new unpack directory.
+ *
+ * @return The result of untar_Write() or untar_Finish(), whichever failed first.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t Extract
+(
+    const char* tarPath,
+    const char* dirPath
+)
+{
+    LE_ASSERT(le_dir_MakePath(dirPath, 0755) == LE_OK);
+
+    int inFd = open(tarPath, O_RDONLY);
+    LE_ASSERT(inFd >= 0);
+
+    untar_Ref_t extractor = untar_Create(dirPath);
+    LE_ASSERT(extractor != NULL);
+
+    static char buffer[64 * 1024];
+    ssize_t len;
+    le_result_t result = LE_OK;
+
+    while ((result == LE_OK) && ((len = read(inFd, buffer, sizeof(buffer))) > 0))
+    {
+        result = untar_Write(extractor, buffer, len);
+    }
+
+    close(inFd);
+
+    if (result == LE_OK)
+    {
+        result = untar_Finish(extractor);
+    }
+
+    untar_Delete(extractor);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build a tarball from a symlink "x" pointing to the outside directory, followed by the entries
+ * of a shell command's tree, then extract it.
+ *
+ * @return The extraction result.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ExtractAfterSymlink
+(
+    const char* namePtr,        ///< Name of the test.
+    const char* makeTreePtr,    ///< Shell command making the second tree in the current directory.
+    const char* entriesPtr      ///< Entries of the second tree to put in the tarball.
+)
+{
+    char command[PATH_MAX * 4];
+
+    snprintf(command, sizeof(command),
+             "cd %s && rm -rf %s && mkdir -p %s/a %s/b %s/out"
+             " && ln -s %s %s/a/x"
+             " && (cd %s/b && %s)"
+             " && tar --no-recursion -cjf %s/%s.tar.bz2 -C %s/%s/a x -C %s/%s/b %s",
+             WorkDir, namePtr, namePtr, namePtr, namePtr,
+             OutsideDir, namePtr,
+             namePtr, makeTreePtr,
+             namePtr, namePtr, WorkDir, namePtr, WorkDir, namePtr, entriesPtr);
+    Run(command);
+
+    char tarPath[PATH_MAX];
+    char dirPath[PATH_MAX];
+    snprintf(tarPath, sizeof(tarPath), "%s/%s/%s.tar.bz2", WorkDir, namePtr, namePtr);
+    snprintf(dirPath, sizeof(dirPath), "%s/%s/out", WorkDir, namePtr);
+
+    le_result_t result = Extract(tarPath, dirPath);
+
+    LE_INFO("%s: %s", namePtr, LE_RESULT_TXT(result));
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the outside directory still only holds its original file, unchanged.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsOutsideUntouched
+(
+    void
+)
+{
+    char command[PATH_MAX * 2];
+
+    snprintf(command, sizeof(command),
+             "test \"$(ls -A %s)\" = passwd && test \"$(cat %s/passwd)\" = original"
+             " && test \"$(stat -c %%a %s)\" = 755",
+             OutsideDir, OutsideDir, OutsideDir);
+
+    return (system(command) == 0);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_INIT;
+
+    LE_ASSERT(mkdtemp(WorkDir) != NULL);
+
+    untar_Init();
+
+    snprintf(OutsideDir, sizeof(OutsideDir), "%s/outside", WorkDir);
+
+    char command[PATH_MAX * 2];
+    snprintf(command, sizeof(command),
+             "mkdir -m 755 %s && echo original > %s/passwd", OutsideDir, OutsideDir);
+    Run(command);
+
+    // A file through the symlink.
+    LE_TEST(ExtractAfterSymlink("file",
+                                "mkdir x && echo evil > x/passwd",
+                                "x/passwd") == LE_FORMAT_ERROR);
+    LE_TEST(IsOutsideUntouched());
+
+    // A new file in a directory created through the symlink.
+    LE_TEST(ExtractAfterSymlink("subdir",
+                                "mkdir -p x/sub && echo evil > x/sub/file",
+                                "x/sub/file") == LE_FORMAT_ERROR);
+    LE_TEST(IsOutsideUntouched());
+
+    // A symlink and a hard link through the symlink.
+    LE_TEST(ExtractAfterSymlink("symlink",
+                                "mkdir x && ln -s /etc x/link",
+                                "x/link") == LE_FORMAT_ERROR);
+    LE_TEST(IsOutsideUntouched());
+
+    LE_TEST(ExtractAfterSymlink("hardlink",
+                                "mkdir x && echo evil > y && ln y x/passwd",
+                                "y x/passwd") == LE_FORMAT_ERROR);
+    LE_TEST(IsOutsideUntouched());
+
+    // A directory over the symlink must not get its permissions applied to the symlink's target.
+    LE_TEST(ExtractAfterSymlink("dir",
+                                "mkdir -m 777 x",
+                                "x") == LE_OK);
+    LE_TEST(IsOutsideUntouched());
+
+    snprintf(command, sizeof(command), "test -d %s/dir/out/x -a ! -L %s/dir/out/x",
+             WorkDir, WorkDir);
+    LE_TEST(system(command) == 0);
+
+    // A regular file over the symlink replaces it.
+    LE_TEST(ExtractAfterSymlink("replace",
+                                "echo new > x",
+                                "x") == LE_OK);
+    LE_TEST(IsOutsideUntouched());
+
+    snprintf(command, sizeof(command), "test \"$(cat %s/replace/out/x)\" = new", WorkDir);
+    LE_TEST(system(command) == 0);
+
+    // Ordinary trees with relative symlinks still extract.
+    snprintf(command, sizeof(command),
+             "mkdir -p %s/app/src/lib %s/app/src/bin && cd %s/app/src"
+             " && echo lib > lib/libfoo.so.1 && ln -s libfoo.so.1 lib/libfoo.so"
+             " && echo exe > bin/foo && ln bin/foo bin/bar"
+             " && find . -print0 | LC_ALL=C sort -z"
+             " | tar --no-recursion --null -T - -cjf %s/app/app.tar.bz2",
+             WorkDir, WorkDir, WorkDir, WorkDir);
+    Run(command);
+
+    char tarPath[PATH_MAX];
+    char dirPath[PATH_MAX];
+    snprintf(tarPath, sizeof(tarPath), "%s/app/app.tar.bz2", WorkDir);
+    snprintf(dirPath, sizeof(dirPath), "%s/app/out", WorkDir);
+    LE_TEST(Extract(tarPath, dirPath) == LE_OK);
+
+    snprintf(command, sizeof(command), "diff -r %s/app/src %s/app/out", WorkDir, WorkDir);
+    LE_TEST(system(command) == 0);
+
+    snprintf(command, sizeof(command), "rm -rf %s", WorkDir);
+    Run(command);
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,151 @@
+/**
+ * IPC throughput benchmark.
+ *
+ * Makes the same number of calls to the IPC test server twice: first one at a time with the
+ * synchronous client functions, then with the asynchronous ones, keeping up to a given number of
+ * requests outstanding on the session.
+ *
+ * Usage: bench [CALL_COUNT [MAX_OUTSTANDING]]
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+/// Default number of calls made in each run.
+#define DEFAULT_CALL_COUNT      10000
+
+/// Default maximum number of asynchronous requests outstanding at once.
+#define DEFAULT_MAX_OUTSTANDING 32
+
+
+static size_t CallCount = DEFAULT_CALL_COUNT;
+static size_t MaxOutstanding = DEFAULT_MAX_OUTSTANDING;
+
+static size_t SentCount = 0;        ///< Number of asynchronous requests sent.
+static size_t DoneCount = 0;        ///< Number of asynchronous requests completed.
+
+static le_clk_Time_t StartTime;     ///< Time at which the current run started.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the throughput of a run that just finished.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Report
+(
+    const char* runNamePtr
+)
+{
+    le_clk_Time_t elapsedTime = le_clk_Sub(le_clk_GetRelativeTime(), StartTime);
+    double seconds = elapsedTime.sec + elapsedTime.usec / 1000000.0;
+
+    LE_INFO("%s: %zu calls in %.3f s (%.0f calls/s)",
+            runNamePtr,
+            CallCount,
+            seconds,
+            (seconds > 0) ? CallCount / seconds : 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make all the calls one after the other, waiting for each response.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunSync
+(
+    void
+)
+{
+    size_t i;
+
+    StartTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < CallCount; i++)
+    {
+        int32_t outValue;
+
+        ipcTest_EchoSimple((int32_t)i, &outValue);
+        LE_FATAL_IF(outValue != (int32_t)i, "Got %" PRId32 " back instead of %zu", outValue, i);
+    }
+
+    Report("Synchronous");
+}
+
+
+static void SendNext(void);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion callback for the asynchronous calls.  Keeps the pipeline full until all calls are
+ * sent, then reports once the last one completes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EchoDone
+(
+    int32_t outValue,
+    void* contextPtr
+)
+{
+    LE_FATAL_IF(outValue != (int32_t)(intptr_t)contextPtr,
+                "Got %" PRId32 " back instead of %" PRId32,
+                outValue,
+                (int32_t)(intptr_t)contextPtr);
+
+    DoneCount++;
+
+    if (SentCount < CallCount)
+    {
+        SendNext();
+    }
+    else if (DoneCount == CallCount)
+    {
+        Report("Pipelined");
+        exit(EXIT_SUCCESS);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the next asynchronous request.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendNext
+(
+    void
+)
+{
+    ipcTest_EchoSimpleAsync((int32_t)SentCount, EchoDone, (void*)(intptr_t)SentCount);
+    SentCount++;
+}
+
+
+COMPONENT_INIT
+{
+    if (le_arg_NumArgs() >= 1)
+    {
+        CallCount = strtoul(le_arg_GetArg(0), NULL, 0);
+    }
+    if (le_arg_NumArgs() >= 2)
+    {
+        MaxOutstanding = strtoul(le_arg_GetArg(1), NULL, 0);
+    }
+    LE_FATAL_IF((CallCount == 0) || (MaxOutstanding == 0),
+                "Usage: bench [CALL_COUNT [MAX_OUTSTANDING]]");
+
+    RunSync();
+
+    // Fill the pipeline.  The completion callbacks keep it full from then on.
+    StartTime = le_clk_GetRelativeTime();
+
+    while ((SentCount < CallCount) && (SentCount < MaxOutstanding))
+    {
+        SendNext();
+    }
+}
@@ -0,0 +1,337 @@
+/**
+ * Multi-threaded server test.
+ *
+ * First makes a slow request in each of several sessions at once, and checks that the server
+ * handled them at the same time.  Then closes a session while a slow request sent in it is being
+ * handled; the server checks that its close handlers wait for the request.  Then makes identical
+ * calls to an idempotent function, and checks that the server merged them, cached the response
+ * for as long as it was asked to, and counted them correctly.  Finally sends a burst of requests,
+ * some slow and some not, in a single session, and checks that they were all handled in order.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+/// Number of sessions making a slow request at the same time.
+#define SESSION_COUNT   4
+
+/// Time the server takes to handle a slow request, in milliseconds.
+#define SLOW_REQUEST_MS 200
+
+/// Number of requests sent in a single session to check ordering.
+#define ORDER_COUNT     100
+
+
+/// Number of sessions making the same idempotent call at the same time.
+#define MERGED_COUNT    3
+
+
+static le_sem_Ref_t DoneSem;            ///< Posted by each session thread when done.
+
+static size_t NextResponse = 0;         ///< Index of the next response expected in order.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a session of its own and makes a slow request in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* SessionThreadMain
+(
+    void* contextPtr
+)
+{
+    int32_t outValue;
+
+    ipcTest_ConnectService();
+
+    ipcTest_EchoSimple(-SLOW_REQUEST_MS, &outValue);
+    LE_FATAL_IF(outValue != -SLOW_REQUEST_MS, "Got %" PRId32 " back", outValue);
+
+    ipcTest_DisconnectService();
+
+    le_sem_Post(DoneSem);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes a slow request in several sessions at once.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestSessionsInParallel
+(
+    void
+)
+{
+    int i;
+
+    DoneSem = le_sem_Create("SessionsDone", 0);
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < SESSION_COUNT; i++)
+    {
+        le_thread_Start(le_thread_Create("Session", SessionThreadMain, NULL));
+    }
+
+    for (i = 0; i < SESSION_COUNT; i++)
+    {
+        le_sem_Wait(DoneSem);
+    }
+
+    le_clk_Time_t elapsedTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    long elapsedMs = elapsedTime.sec * 1000 + elapsedTime.usec / 1000;
+
+    LE_INFO("%d slow requests in separate sessions took %ld ms", SESSION_COUNT, elapsedMs);
+
+    LE_FATAL_IF(elapsedMs >= SESSION_COUNT * SLOW_REQUEST_MS,
+                "Requests of different sessions weren't handled at the same time.");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion callback for the request of a session closed before its response.  Never called.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EchoIgnored
+(
+    int32_t outValue,
+    void* contextPtr
+)
+{
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a session of its own, and closes it while the server is handling a slow request in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CloseThreadMain
+(
+    void* contextPtr
+)
+{
+    ipcTest_ConnectService();
+
+    ipcTest_EchoSimpleAsync(-SLOW_REQUEST_MS, EchoIgnored, NULL);
+
+    usleep(SLOW_REQUEST_MS * 1000 / 4);
+
+    ipcTest_DisconnectService();
+
+    le_sem_Post(DoneSem);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes a session in the middle of a request.  The server dies if the session's close handlers
+ * are called before the request is done, so check that it still answers afterwards.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestCloseDuringRequest
+(
+    void
+)
+{
+    int32_t outValue;
+
+    le_thread_Start(le_thread_Create("Close", CloseThreadMain, NULL));
+    le_sem_Wait(DoneSem);
+
+    usleep(SLOW_REQUEST_MS * 1000 * 2);
+
+    ipcTest_EchoSimple(1, &outValue);
+    LE_FATAL_IF(outValue != 1, "Got %" PRId32 " back", outValue);
+
+    LE_INFO("Session closed during a request was cleaned up after it");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Opens a session of its own and makes a slow idempotent call in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* IdempotentThreadMain
+(
+    void* contextPtr
+)
+{
+    int32_t outValue;
+
+    ipcTest_ConnectService();
+
+    ipcTest_EchoIdempotent(-SLOW_REQUEST_MS, &outValue);
+    LE_FATAL_IF(outValue != -SLOW_REQUEST_MS, "Got %" PRId32 " back", outValue);
+
+    ipcTest_DisconnectService();
+
+    le_sem_Post(DoneSem);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the number of calls the server handled, and its request coalescing statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckIdempotentStats
+(
+    uint32_t handledCount,
+    uint64_t callCount,
+    uint64_t mergedCount,
+    uint64_t cacheHitCount
+)
+{
+    uint32_t serverHandledCount;
+    uint64_t serverCallCount, serverMergedCount, serverCacheHitCount;
+
+    ipcTest_GetIdempotentStats(&serverHandledCount,
+                               &serverCallCount,
+                               &serverMergedCount,
+                               &serverCacheHitCount);
+
+    LE_INFO("Idempotent calls: %" PRIu32 " handled, %" PRIu64 " made, %" PRIu64 " merged, "
+            "%" PRIu64 " cache hits", serverHandledCount, serverCallCount, serverMergedCount,
+            serverCacheHitCount);
+
+    LE_FATAL_IF(serverHandledCount != handledCount,
+                "%" PRIu32 " calls handled, expected %" PRIu32, serverHandledCount, handledCount);
+    LE_FATAL_IF(serverCallCount != callCount,
+                "%" PRIu64 " calls counted, expected %" PRIu64, serverCallCount, callCount);
+    LE_FATAL_IF(serverMergedCount != mergedCount,
+                "%" PRIu64 " calls merged, expected %" PRIu64, serverMergedCount, mergedCount);
+    LE_FATAL_IF(serverCacheHitCount != cacheHitCount,
+                "%" PRIu64 " cache hits, expected %" PRIu64, serverCacheHitCount, cacheHitCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes identical calls to an idempotent function in several sessions at once, which the server
+ * must handle once, then checks that a cached response is used until it expires.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestIdempotentCalls
+(
+    void
+)
+{
+    int32_t outValue;
+    int i;
+
+    CheckIdempotentStats(0, 0, 0, 0);
+
+    // Identical calls made while the first one is being handled get its response.
+    for (i = 0; i < MERGED_COUNT; i++)
+    {
+        le_thread_Start(le_thread_Create("Idempotent", IdempotentThreadMain, NULL));
+    }
+
+    for (i = 0; i < MERGED_COUNT; i++)
+    {
+        le_sem_Wait(DoneSem);
+    }
+
+    CheckIdempotentStats(1, MERGED_COUNT, MERGED_COUNT - 1, 0);
+
+    // Responses aren't cached by default: the same call is handled again.
+    ipcTest_EchoIdempotent(2, &outValue);
+    LE_FATAL_IF(outValue != 2, "Got %" PRId32 " back", outValue);
+    ipcTest_EchoIdempotent(2, &outValue);
+    LE_FATAL_IF(outValue != 2, "Got %" PRId32 " back", outValue);
+
+    CheckIdempotentStats(3, MERGED_COUNT + 2, MERGED_COUNT - 1, 0);
+
+    // A cached response is sent until it expires.
+    ipcTest_SetIdempotentCacheTime(SLOW_REQUEST_MS);
+
+    ipcTest_EchoIdempotent(3, &outValue);
+    LE_FATAL_IF(outValue != 3, "Got %" PRId32 " back", outValue);
+    ipcTest_EchoIdempotent(3, &outValue);
+    LE_FATAL_IF(outValue != 3, "Got %" PRId32 " back", outValue);
+
+    CheckIdempotentStats(4, MERGED_COUNT + 4, MERGED_COUNT - 1, 1);
+
+    usleep(SLOW_REQUEST_MS * 1000 * 2);
+
+    ipcTest_EchoIdempotent(3, &outValue);
+    LE_FATAL_IF(outValue != 3, "Got %" PRId32 " back", outValue);
+
+    CheckIdempotentStats(5, MERGED_COUNT + 5, MERGED_COUNT - 1, 1);
+
+    ipcTest_SetIdempotentCacheTime(0);
+
+    LE_INFO("Identical idempotent calls were merged, and cached responses expired");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion callback for the requests sent by TestOrderInSession().
+ */
+//--------------------------------------------------------------------------------------------------
+static void EchoDone
+(
+    int32_t outValue,
+    void* contextPtr
+)
+{
+    size_t index = (size_t)(intptr_t)contextPtr;
+
+    LE_FATAL_IF(index != NextResponse,
+                "Got response to request %zu when expecting %zu.", index, NextResponse);
+
+    NextResponse++;
+
+    if (NextResponse == ORDER_COUNT)
+    {
+        LE_INFO("%d requests in one session were handled in order", ORDER_COUNT);
+        exit(EXIT_SUCCESS);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a burst of requests in a single session.  Every other one is slow, so any of them handled
+ * out of order would very likely respond out of order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestOrderInSession
+(
+    void
+)
+{
+    size_t i;
+
+    for (i = 0; i < ORDER_COUNT; i++)
+    {
+        ipcTest_EchoSimpleAsync((i % 2) ? -1 : (int32_t)i, EchoDone, (void*)(intptr_t)i);
+    }
+}
+
+
+COMPONENT_INIT
+{
+    TestSessionsInParallel();
+
+    TestCloseDuringRequest();
+
+    TestIdempotentCalls();
+
+    TestOrderInSession();
+}
@@ -9,12 +9,92 @@
 
 #include <string.h>
 
+/// Maximum number of sessions with a slow request being handled at the same time.
+#define MAX_BUSY_SESSIONS   16
+
+/// Sessions with a slow request being handled.  Protected by BusyMutex.
+static le_msg_SessionRef_t BusySessions[MAX_BUSY_SESSIONS];
+
+static le_mutex_Ref_t BusyMutex;
+
+/// Number of times ipcTest_EchoIdempotent() was called.  Accessed atomically.
+static uint32_t IdempotentHandledCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replace a session by another in the list of sessions with a slow request being handled.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReplaceBusySession
+(
+    le_msg_SessionRef_t oldSessionRef,
+    le_msg_SessionRef_t newSessionRef
+)
+{
+    int i;
+
+    le_mutex_Lock(BusyMutex);
+
+    for (i = 0; i < MAX_BUSY_SESSIONS; i++)
+    {
+        if (BusySessions[i] == oldSessionRef)
+        {
+            BusySessions[i] = newSessionRef;
+            break;
+        }
+    }
+
+    le_mutex_Unlock(BusyMutex);
+
+    LE_FATAL_IF(i == MAX_BUSY_SESSIONS, "Too many slow requests at once.");
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a session isn't closed under a request still being handled, which would let close
+ * handlers free per-client data that the request is using.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckClosedSession
+(
+    le_msg_SessionRef_t sessionRef,
+    void* contextPtr
+)
+{
+    int i;
+
+    le_mutex_Lock(BusyMutex);
+
+    for (i = 0; i < MAX_BUSY_SESSIONS; i++)
+    {
+        LE_FATAL_IF(BusySessions[i] == sessionRef,
+                    "Session %p closed while a request was being handled.", sessionRef);
+    }
+
+    le_mutex_Unlock(BusyMutex);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Echo a value.  Negative values make the server take -InValue milliseconds to respond, to
+ * simulate a request that blocks.
+ */
+//--------------------------------------------------------------------------------------------------
 void ipcTest_EchoSimple
 (
     int32_t InValue,
     int32_t *OutValuePtr
 )
 {
+    if (InValue < 0)
+    {
+        le_msg_SessionRef_t sessionRef = ipcTest_GetClientSessionRef();
+
+        ReplaceBusySession(NULL, sessionRef);
+        usleep(-InValue * 1000);
+        ReplaceBusySession(sessionRef, NULL);
+    }
+
     if (OutValuePtr)
     {
         *OutValuePtr = InValue;
@@ -95,6 +175,69 @@ void ipcTest_EchoString
     }
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Echo a value, and count the calls.  Negative values make the server take -InValue milliseconds
+ * to respond, so that identical calls get merged.
+ */
+//--------------------------------------------------------------------------------------------------
+void ipcTest_EchoIdempotent
+(
+    int32_t InValue,
+    int32_t *OutValuePtr
+)
+{
+    __atomic_add_fetch(&IdempotentHandledCount, 1, __ATOMIC_RELAXED);
+
+    if (InValue < 0)
+    {
+        usleep(-InValue * 1000);
+    }
+
+    if (OutValuePtr)
+    {
+        *OutValuePtr = InValue;
+    }
+}
+
+void ipcTest_SetIdempotentCacheTime
+(
+    uint32_t CacheTime
+)
+{
+    ipcTest_SetResponseCacheTime(CacheTime);
+}
+
+void ipcTest_GetIdempotentStats
+(
+    uint32_t *HandledCountPtr,
+    uint64_t *CallCountPtr,
+    uint64_t *MergedCountPtr,
+    uint64_t *CacheHitCountPtr
+)
+{
+    uint64_t callCount, mergedCount, cacheHitCount;
+
+    ipcTest_GetCoalescingStats(&callCount, &mergedCount, &cacheHitCount);
+
+    if (HandledCountPtr)
+    {
+        *HandledCountPtr = __atomic_load_n(&IdempotentHandledCount, __ATOMIC_RELAXED);
+    }
+    if (CallCountPtr)
+    {
+        *CallCountPtr = callCount;
+    }
+    if (MergedCountPtr)
+    {
+        *MergedCountPtr = mergedCount;
+    }
+    if (CacheHitCountPtr)
+    {
+        *CacheHitCountPtr = cacheHitCount;
+    }
+}
+
 #if 0
 // Not currently supported on Java.
 void ipcTest_EchoArray
@@ -130,4 +273,7 @@ void ipcTest_ExitServer
 
 COMPONENT_INIT
 {
+    BusyMutex = le_mutex_CreateNonRecursive("BusySessions");
+
+    le_msg_AddServiceCloseHandler(ipcTest_GetServiceRef(), CheckClosedSession, NULL);
 }
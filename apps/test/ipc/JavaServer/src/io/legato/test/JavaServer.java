@@ -104,6 +104,59 @@ public class JavaServer implements ipcTest, Component
         }
     }
 
+    // Java servers don't merge identical calls: every call to EchoIdempotent is handled.
+    private BigInteger idempotentHandledCount = BigInteger.ZERO;
+
+    @Override
+    public void EchoIdempotent
+    (
+        BigInteger InValue,
+        Ref<BigInteger> OutValue
+    )
+    {
+        idempotentHandledCount = idempotentHandledCount.add(BigInteger.ONE);
+
+        if (OutValue != null)
+        {
+            OutValue.setValue(InValue);
+        }
+    }
+
+    @Override
+    public void SetIdempotentCacheTime
+    (
+        BigInteger CacheTime
+    )
+    {
+    }
+
+    @Override
+    public void GetIdempotentStats
+    (
+        Ref<BigInteger> HandledCount,
+        Ref<BigInteger> CallCount,
+        Ref<BigInteger> MergedCount,
+        Ref<BigInteger> CacheHitCount
+    )
+    {
+        if (HandledCount != null)
+        {
+            HandledCount.setValue(idempotentHandledCount);
+        }
+        if (CallCount != null)
+        {
+            CallCount.setValue(idempotentHandledCount);
+        }
+        if (MergedCount != null)
+        {
+            MergedCount.setValue(BigInteger.ZERO);
+        }
+        if (CacheHitCount != null)
+        {
+            CacheHitCount.setValue(BigInteger.ZERO);
+        }
+    }
+
     @Override
     public void ExitServer()
     {
@@ -0,0 +1,289 @@
+/**
+ * This module implements the unit tests for the GNSS broadcast ring.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "le_gnssBroadcast.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of samples written by the writer in the concurrent test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CONCURRENT_SAMPLE_COUNT     200000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of readers in the concurrent test.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CONCURRENT_READER_COUNT     3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring under test, and its read-only file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnssBroadcast_Ring_t* RingPtr;
+static int RingFd;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Semaphore posted by the readers of the concurrent test, once attached and once done.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sem_Ref_t ReaderSem;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a sample whose fields are all derived from a number, so that a reader can check that it
+ * is neither torn nor out of order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteNumberedSample
+(
+    int32_t number
+)
+{
+    le_gnssBroadcast_Sample_t sample;
+
+    memset(&sample, 0, sizeof(sample));
+    sample.latitude = number;
+    sample.longitude = -number;
+    sample.epochTime = (uint64_t)number * 1000;
+
+    le_gnssBroadcast_WriteSample(RingPtr, &sample);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test attaching to shared memory that is not a ring.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_gnssBroadcast_AttachBadFd
+(
+    void
+)
+{
+    le_gnssBroadcast_Reader_t reader;
+    int fd = open("/dev/null", O_RDONLY);
+
+    LE_ASSERT(-1 != fd);
+    LE_ASSERT(LE_FORMAT_ERROR == le_gnssBroadcast_Attach(fd, &reader));
+    close(fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that long NMEA strings are split over several records, and that waiting on an empty ring
+ * times out.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_gnssBroadcast_Nmea
+(
+    void
+)
+{
+    le_gnssBroadcast_Reader_t reader;
+    const le_gnssBroadcast_Record_t* recordPtr;
+    char nmea[LE_GNSSBROADCAST_NMEA_MAX_BYTES * 2 + 100 + 1];
+    char readNmea[sizeof(nmea)];
+    size_t readSize = 0;
+    size_t i;
+
+    for (i = 0; i < sizeof(nmea) - 1; i++)
+    {
+        nmea[i] = 'A' + (i % 26);
+    }
+    nmea[i] = '\0';
+
+    LE_ASSERT(LE_OK == le_gnssBroadcast_Attach(RingFd, &reader));
+    LE_ASSERT(LE_WOULD_BLOCK == le_gnssBroadcast_Peek(&reader, &recordPtr));
+    LE_ASSERT(LE_TIMEOUT == le_gnssBroadcast_Wait(&reader, 10));
+
+    le_gnssBroadcast_WriteNmea(RingPtr, nmea);
+    le_gnssBroadcast_WriteNmea(RingPtr, "");
+
+    LE_ASSERT(LE_OK == le_gnssBroadcast_Wait(&reader, 0));
+
+    for (i = 0; i < 3; i++)
+    {
+        LE_ASSERT(LE_OK == le_gnssBroadcast_Peek(&reader, &recordPtr));
+        LE_ASSERT(LE_GNSSBROADCAST_NMEA == recordPtr->type);
+        LE_ASSERT(recordPtr->size == ((i < 2) ? LE_GNSSBROADCAST_NMEA_MAX_BYTES : 100));
+        memcpy(readNmea + readSize, recordPtr->data.nmea, recordPtr->size);
+        readSize += recordPtr->size;
+        LE_ASSERT(LE_OK == le_gnssBroadcast_Next(&reader));
+    }
+
+    LE_ASSERT(LE_WOULD_BLOCK == le_gnssBroadcast_Peek(&reader, &recordPtr));
+    LE_ASSERT(readSize == strlen(nmea));
+    LE_ASSERT(0 == memcmp(nmea, readNmea, readSize));
+    LE_ASSERT(0 == reader.overrunCount);
+
+    le_gnssBroadcast_Detach(&reader);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that a reader falling behind is told how many records it lost, then reads the remaining
+ * ones in order.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_gnssBroadcast_Overrun
+(
+    void
+)
+{
+    le_gnssBroadcast_Reader_t reader;
+    const le_gnssBroadcast_Record_t* recordPtr;
+    int32_t number;
+
+    LE_ASSERT(LE_OK == le_gnssBroadcast_Attach(RingFd, &reader));
+
+    for (number = 0; number < 3 * LE_GNSSBROADCAST_RECORD_COUNT; number++)
+    {
+        WriteNumberedSample(number);
+    }
+
+    // The oldest record left is about to be overwritten by the next write, so it is skipped too.
+    LE_ASSERT(LE_OVERFLOW == le_gnssBroadcast_Peek(&reader, &recordPtr));
+    LE_ASSERT((2 * LE_GNSSBROADCAST_RECORD_COUNT + 1) == reader.overrunCount);
+
+    for (number = 2 * LE_GNSSBROADCAST_RECORD_COUNT + 1;
+         number < 3 * LE_GNSSBROADCAST_RECORD_COUNT;
+         number++)
+    {
+        LE_ASSERT(LE_OK == le_gnssBroadcast_Peek(&reader, &recordPtr));
+        LE_ASSERT(LE_GNSSBROADCAST_SAMPLE == recordPtr->type);
+        LE_ASSERT(number == recordPtr->data.sample.latitude);
+        LE_ASSERT(LE_OK == le_gnssBroadcast_Next(&reader));
+    }
+
+    LE_ASSERT(LE_WOULD_BLOCK == le_gnssBroadcast_Peek(&reader, &recordPtr));
+
+    // A record overwritten while in use is reported when released.
+    WriteNumberedSample(number++);
+    LE_ASSERT(LE_OK == le_gnssBroadcast_Peek(&reader, &recordPtr));
+    while (number <= 4 * LE_GNSSBROADCAST_RECORD_COUNT)
+    {
+        WriteNumberedSample(number++);
+    }
+    LE_ASSERT(LE_OVERFLOW == le_gnssBroadcast_Next(&reader));
+
+    le_gnssBroadcast_Detach(&reader);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reader of the concurrent test.  Checks that the samples it reads are whole and in order, and
+ * that together with the ones it lost they account for all the samples written.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ReaderThread
+(
+    void* contextPtr
+)
+{
+    le_gnssBroadcast_Reader_t reader;
+    const le_gnssBroadcast_Record_t* recordPtr;
+    int32_t lastNumber = -1;
+    uint32_t readCount = 0;
+
+    LE_ASSERT(LE_OK == le_gnssBroadcast_Attach(RingFd, &reader));
+    le_sem_Post(ReaderSem);
+
+    while (lastNumber < CONCURRENT_SAMPLE_COUNT - 1)
+    {
+        le_result_t result = le_gnssBroadcast_Peek(&reader, &recordPtr);
+
+        if (LE_WOULD_BLOCK == result)
+        {
+            LE_ASSERT(LE_OK == le_gnssBroadcast_Wait(&reader, 10000));
+        }
+        else if (LE_OK == result)
+        {
+            le_gnssBroadcast_Sample_t sample = recordPtr->data.sample;
+
+            if (LE_OK == le_gnssBroadcast_Next(&reader))
+            {
+                LE_ASSERT(sample.latitude > lastNumber);
+                LE_ASSERT(sample.longitude == -sample.latitude);
+                LE_ASSERT(sample.epochTime == (uint64_t)sample.latitude * 1000);
+                lastNumber = sample.latitude;
+                readCount++;
+            }
+        }
+    }
+
+    LE_INFO("Reader read %u samples and lost %u", readCount, reader.overrunCount);
+    LE_ASSERT(CONCURRENT_SAMPLE_COUNT == readCount + reader.overrunCount);
+
+    le_gnssBroadcast_Detach(&reader);
+    le_sem_Post(ReaderSem);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test several readers reading while the writer writes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_gnssBroadcast_Concurrent
+(
+    void
+)
+{
+    int32_t number;
+    int i;
+
+    ReaderSem = le_sem_Create("ReaderSem", 0);
+
+    for (i = 0; i < CONCURRENT_READER_COUNT; i++)
+    {
+        le_thread_Start(le_thread_Create("Reader", ReaderThread, NULL));
+    }
+    for (i = 0; i < CONCURRENT_READER_COUNT; i++)
+    {
+        le_sem_Wait(ReaderSem);
+    }
+
+    for (number = 0; number < CONCURRENT_SAMPLE_COUNT; number++)
+    {
+        WriteNumberedSample(number);
+    }
+
+    for (i = 0; i < CONCURRENT_READER_COUNT; i++)
+    {
+        le_sem_Wait(ReaderSem);
+    }
+
+    le_sem_Delete(ReaderSem);
+}
+
+
+COMPONENT_INIT
+{
+    RingPtr = le_gnssBroadcast_Create(&RingFd);
+    LE_ASSERT(NULL != RingPtr);
+
+    // tests
+    Test_le_gnssBroadcast_AttachBadFd();
+    Test_le_gnssBroadcast_Nmea();
+    Test_le_gnssBroadcast_Overrun();
+    Test_le_gnssBroadcast_Concurrent();
+
+    LE_INFO("GNSS broadcast unit tests passed");
+    exit(0);
+}
@@ -12,6 +12,10 @@
 #include "le_print.h"
 
 static le_gnss_PositionHandlerRef_t PositionHandlerRef = NULL;
+static le_gnss_SampleDataHandlerRef_t SampleDataHandlerRef = NULL;
+
+// Number of position samples whose data was reported to the sample data handler
+static int SampleDataCount = 0;
 
 //Wait up to 60 seconds for a 3D fix
 #define WAIT_MAX_FOR_3DFIX  60
@@ -329,6 +333,29 @@ static void PositionHandlerFunction
         LE_INFO("Altitude unknown [%d,%d]", altitude, vAccuracy);
     }
 
+    // Get all the sample's data at once, and check it against the data retrieved above
+    {
+        le_gnss_FixState_t bulkState;
+        le_gnss_SampleFieldBitMask_t validFields;
+        int32_t bulkLatitude, bulkLongitude, bulkAltitude;
+        uint16_t bulkYear, bulkHours;
+
+        LE_ASSERT_OK(le_gnss_GetSampleData(positionSampleRef, &bulkState, &validFields,
+                                           &bulkLatitude, &bulkLongitude, NULL,
+                                           &bulkAltitude, NULL, NULL,
+                                           NULL, NULL, NULL, NULL, NULL, NULL,
+                                           &bulkYear, NULL, NULL, &bulkHours, NULL, NULL, NULL,
+                                           NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                                           NULL, NULL, NULL));
+        LE_ASSERT(bulkState == state);
+        LE_ASSERT(bulkLatitude == latitude);
+        LE_ASSERT(bulkLongitude == longitude);
+        LE_ASSERT(bulkAltitude == altitude);
+        LE_ASSERT(bulkYear == year);
+        LE_ASSERT(bulkHours == hours);
+        LE_INFO("Sample data valid fields 0x%X", (unsigned int)validFields);
+    }
+
     // Get altitude in meters, between WGS-84 earth ellipsoid
     // and mean sea level [resolution 1e-3]
     result = le_gnss_GetAltitudeOnWgs84(positionSampleRef, &altitudeOnWgs84);
@@ -483,6 +510,64 @@ static void PositionHandlerFunction
     le_gnss_ReleaseSampleRef(positionSampleRef);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler function for position sample data notifications.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void SampleDataHandlerFunction
+(
+    le_gnss_FixState_t state,
+    le_gnss_SampleFieldBitMask_t validFields,
+    int32_t latitude,
+    int32_t longitude,
+    int32_t hAccuracy,
+    int32_t altitude,
+    int32_t vAccuracy,
+    int32_t altitudeOnWgs84,
+    uint32_t hSpeed,
+    uint32_t hSpeedAccuracy,
+    int32_t vSpeed,
+    int32_t vSpeedAccuracy,
+    uint32_t direction,
+    uint32_t directionAccuracy,
+    uint16_t year,
+    uint16_t month,
+    uint16_t day,
+    uint16_t hours,
+    uint16_t minutes,
+    uint16_t seconds,
+    uint16_t milliseconds,
+    uint64_t epochTime,
+    uint32_t timeAccuracy,
+    uint8_t leapSeconds,
+    uint16_t hdop,
+    uint16_t vdop,
+    uint16_t pdop,
+    int32_t magneticDeviation,
+    uint8_t satsInViewCount,
+    uint8_t satsTrackingCount,
+    uint8_t satsUsedCount,
+    void* contextPtr
+)
+{
+    SampleDataCount++;
+
+    if (validFields & LE_GNSS_SAMPLE_LATITUDE)
+    {
+        LE_ASSERT(INT32_MAX != latitude);
+    }
+    else
+    {
+        LE_ASSERT(INT32_MAX == latitude);
+    }
+
+    LE_INFO("Sample data #%d: state %d, valid fields 0x%X, lat.%d, long.%d, sats used %d",
+            SampleDataCount, state, (unsigned int)validFields, latitude, longitude,
+            satsUsedCount);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Test: Add Position Handler
@@ -500,6 +585,8 @@ static void* PositionThread
     LE_INFO("======== Position Handler thread  ========");
     PositionHandlerRef = le_gnss_AddPositionHandler(PositionHandlerFunction, NULL);
     LE_ASSERT((PositionHandlerRef != NULL));
+    SampleDataHandlerRef = le_gnss_AddSampleDataHandler(SampleDataHandlerFunction, NULL);
+    LE_ASSERT((SampleDataHandlerRef != NULL));
 
     le_event_RunLoop();
     return NULL;
@@ -573,6 +660,8 @@ static void TestLeGnssPositionHandler
     }
 
     le_gnss_RemovePositionHandler(PositionHandlerRef);
+    le_gnss_RemoveSampleDataHandler(SampleDataHandlerRef);
+    LE_ASSERT(SampleDataCount > 0);
 
     LE_INFO("Wait 5 seconds");
     sleep(5);
@@ -863,6 +952,7 @@ static void TestLeGnssTtffMeasurement
     LoopToGet3Dfix(&ttff);
 
     le_gnss_RemovePositionHandler(PositionHandlerRef);
+    le_gnss_RemoveSampleDataHandler(SampleDataHandlerRef);
     LE_INFO("Wait 5 seconds");
     sleep(5);
 
@@ -536,6 +536,183 @@ static void Test_le_pos_GetFixState
     LE_ASSERT((state == LE_POS_STATE_FIX_ESTIMATED) && (result == LE_OK));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of movement handlers registered by the movement handlers benchmark
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define MOVEMENT_HANDLER_COUNT  1000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of times the position trace is replayed by the movement handlers benchmark
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+#define MOVEMENT_TRACE_LAPS     50
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position trace, taken from the fixes recorded in posDaemonTest/gnss_nmea.txt
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static const struct
+{
+    int32_t latitude;       ///< Latitude in degrees [resolution 1e-6].
+    int32_t longitude;      ///< Longitude in degrees [resolution 1e-6].
+    int32_t altitude;       ///< Altitude in meters [resolution 1e-3].
+}
+PositionTrace[] =
+{
+    { 48849717, 2281533, -4872 },
+    { 48849833, 2281633, -3472 },
+    { 48849917, 2281767, -2272 },
+    { 48850017, 2281867, -1672 },
+    { 48850117, 2281983, -1472 },
+    { 48850217, 2282100, -1472 },
+    { 48850317, 2282217, -1472 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Horizontal and vertical magnitudes in meters given to the benchmark's movement handlers
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint32_t Magnitudes[][2] =
+{
+    { 0, 0 }, { 10, 0 }, { 20, 0 }, { 50, 0 }, { 0, 2 }, { 0, 5 }, { 30, 3 }, { 100, 100 },
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of notifications received by each benchmark's movement handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t MovementCount[MOVEMENT_HANDLER_COUNT];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Movement handler of the benchmark
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void MovementHandler
+(
+    le_pos_SampleRef_t positionSampleRef,
+    void* contextPtr
+)
+{
+    MovementCount[(size_t)contextPtr]++;
+
+    le_pos_sample_Release(positionSampleRef);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Movement handlers benchmark
+ *
+ * Replay a recorded position trace with MOVEMENT_HANDLER_COUNT movement handlers registered, and
+ * verify that handlers with the same magnitudes are notified alike.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_le_pos_MovementHandlers
+(
+    void
+)
+{
+    le_pos_MovementHandlerRef_t handlerRefs[MOVEMENT_HANDLER_COUNT];
+    size_t magnitudeCount = NUM_ARRAY_MEMBERS(Magnitudes);
+    size_t traceLength = NUM_ARRAY_MEMBERS(PositionTrace);
+    gnssSimuLocation_t gnssLocation;
+    gnssSimuAltitude_t gnssAltitude;
+    gnssSimuPositionState_t gnssPositionState;
+    uint32_t fixCount = 0;
+    int var = 0;
+    size_t i, lap;
+
+    le_gnssSimu_SetSampleRef((le_gnss_SampleRef_t) &var);
+    gnssPositionState.state = LE_GNSS_STATE_FIX_3D;
+    gnssPositionState.result = LE_OK;
+    le_gnssSimu_SetPositionState(gnssPositionState);
+
+    for (i = 0; i < MOVEMENT_HANDLER_COUNT; i++)
+    {
+        handlerRefs[i] = le_pos_AddMovementHandler(Magnitudes[i % magnitudeCount][0],
+                                                   Magnitudes[i % magnitudeCount][1],
+                                                   MovementHandler,
+                                                   (void*)i);
+        LE_ASSERT(handlerRefs[i] != NULL);
+    }
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    // Go back and forth along the trace.
+    for (lap = 0; lap < MOVEMENT_TRACE_LAPS; lap++)
+    {
+        for (i = 0; i < traceLength; i++)
+        {
+            size_t point = (lap % 2) ? (traceLength - 1 - i) : i;
+
+            gnssLocation.latitude = PositionTrace[point].latitude;
+            gnssLocation.longitude = PositionTrace[point].longitude;
+            gnssLocation.accuracy = 500;
+            gnssLocation.result = LE_OK;
+            le_gnssSimu_SetLocation(gnssLocation);
+
+            gnssAltitude.altitude = PositionTrace[point].altitude;
+            gnssAltitude.accuracy = 10;
+            gnssAltitude.result = LE_OK;
+            le_gnssSimu_SetAltitude(gnssAltitude);
+
+            le_gnssSimu_ReportPosition();
+            fixCount++;
+        }
+    }
+
+    le_clk_Time_t elapsedTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    double usec = elapsedTime.sec * 1000000.0 + elapsedTime.usec;
+
+    LE_INFO("%d movement handlers: %" PRIu32 " fixes in %.0f us (%.1f us per fix)",
+            MOVEMENT_HANDLER_COUNT, fixCount, usec, usec / fixCount);
+
+    for (i = 0; i < MOVEMENT_HANDLER_COUNT; i++)
+    {
+        // Every handler is notified of the first fix, and those without magnitudes of all of them.
+        LE_ASSERT(MovementCount[i] >= 1);
+        LE_ASSERT(MovementCount[i] <= fixCount);
+        if ((0 == Magnitudes[i % magnitudeCount][0]) && (0 == Magnitudes[i % magnitudeCount][1]))
+        {
+            LE_ASSERT(MovementCount[i] == fixCount);
+        }
+
+        // Handlers with the same magnitudes are notified alike.
+        if (i >= magnitudeCount)
+        {
+            LE_ASSERT(MovementCount[i] == MovementCount[i - magnitudeCount]);
+        }
+    }
+
+    for (i = 0; i < magnitudeCount; i++)
+    {
+        LE_INFO("Magnitudes %" PRIu32 "m/%" PRIu32 "m: %" PRIu32 " notifications",
+                Magnitudes[i][0], Magnitudes[i][1], MovementCount[i]);
+    }
+
+    for (i = 0; i < MOVEMENT_HANDLER_COUNT; i++)
+    {
+        le_pos_RemoveMovementHandler(handlerRefs[i]);
+    }
+
+    // No handler is notified anymore.
+    le_gnssSimu_ReportPosition();
+    LE_ASSERT(MovementCount[0] == fixCount);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * main of the test
@@ -559,6 +736,7 @@ COMPONENT_INIT
     Test_le_pos_GetDate();
     Test_le_pos_GetTime();
     Test_le_pos_GetFixState();
+    Test_le_pos_MovementHandlers();
 
     exit(0);
 }
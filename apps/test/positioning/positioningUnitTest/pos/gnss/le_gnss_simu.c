@@ -84,6 +84,14 @@ static gnssSimuPositionState_t GnssSimuPositionSate;
 //--------------------------------------------------------------------------------------------------
 static le_gnss_SampleRef_t Sample;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position handler registered by the positioning service
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnss_PositionHandler_t PositionHandler;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * le_gnssSimu_SetLocation: update simulated location data
@@ -210,6 +218,23 @@ void le_gnssSimu_SetPositionState
     GnssSimuPositionSate = state;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * le_gnssSimu_ReportPosition: report the simulated sample to the position handler
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gnssSimu_ReportPosition
+(
+    void
+)
+{
+    if (PositionHandler.handlerFuncPtr)
+    {
+        PositionHandler.handlerFuncPtr(Sample, PositionHandler.handlerContextPtr);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to initialize the GNSS
@@ -242,7 +267,10 @@ le_gnss_PositionHandlerRef_t le_gnss_AddPositionHandler
     void*                        contextPtr           ///< [IN] The context pointer
 )
 {
-    return NULL;
+    PositionHandler.handlerFuncPtr = handlerPtr;
+    PositionHandler.handlerContextPtr = contextPtr;
+
+    return (le_gnss_PositionHandlerRef_t)&PositionHandler;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -257,6 +285,8 @@ void le_gnss_RemovePositionHandler
     le_gnss_PositionHandlerRef_t    handlerRef ///< [IN] The handler reference.
 )
 {
+    PositionHandler.handlerFuncPtr = NULL;
+    PositionHandler.handlerContextPtr = NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -944,6 +974,137 @@ le_gnss_SampleRef_t le_gnss_GetLastSampleRef
     return Sample;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get all the position sample's data at once.
+ *
+ * @return
+ *  - LE_FAULT         Function failed to find the positionSample.
+ *  - LE_OK            Function succeeded.
+ *
+ * @note Only the simulated data is flagged as valid. All the output parameters can be set to
+ *       NULL if not needed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetSampleData
+(
+    le_gnss_SampleRef_t positionSampleRef,              ///< [IN] Position sample's reference.
+    le_gnss_FixState_t* statePtr,                       ///< [OUT]
+    le_gnss_SampleFieldBitMask_t* validFieldsPtr,       ///< [OUT]
+    int32_t* latitudePtr,                               ///< [OUT]
+    int32_t* longitudePtr,                              ///< [OUT]
+    int32_t* hAccuracyPtr,                              ///< [OUT]
+    int32_t* altitudePtr,                               ///< [OUT]
+    int32_t* vAccuracyPtr,                              ///< [OUT]
+    int32_t* altitudeOnWgs84Ptr,                        ///< [OUT]
+    uint32_t* hSpeedPtr,                                ///< [OUT]
+    uint32_t* hSpeedAccuracyPtr,                        ///< [OUT]
+    int32_t* vSpeedPtr,                                 ///< [OUT]
+    int32_t* vSpeedAccuracyPtr,                         ///< [OUT]
+    uint32_t* directionPtr,                             ///< [OUT]
+    uint32_t* directionAccuracyPtr,                     ///< [OUT]
+    uint16_t* yearPtr,                                  ///< [OUT]
+    uint16_t* monthPtr,                                 ///< [OUT]
+    uint16_t* dayPtr,                                   ///< [OUT]
+    uint16_t* hoursPtr,                                 ///< [OUT]
+    uint16_t* minutesPtr,                               ///< [OUT]
+    uint16_t* secondsPtr,                               ///< [OUT]
+    uint16_t* millisecondsPtr,                          ///< [OUT]
+    uint64_t* epochTimePtr,                             ///< [OUT]
+    uint32_t* timeAccuracyPtr,                          ///< [OUT]
+    uint8_t* leapSecondsPtr,                            ///< [OUT]
+    uint16_t* hdopPtr,                                  ///< [OUT]
+    uint16_t* vdopPtr,                                  ///< [OUT]
+    uint16_t* pdopPtr,                                  ///< [OUT]
+    int32_t* magneticDeviationPtr,                      ///< [OUT]
+    uint8_t* satsInViewCountPtr,                        ///< [OUT]
+    uint8_t* satsTrackingCountPtr,                      ///< [OUT]
+    uint8_t* satsUsedCountPtr                           ///< [OUT]
+)
+{
+    le_gnss_SampleFieldBitMask_t validFields = 0;
+
+    if (LE_OK != GnssSimuPositionSate.result)
+    {
+        return LE_FAULT;
+    }
+
+#define SIMU_FIELD(name, value, valid, bit)     \
+    if (name##Ptr)                              \
+    {                                           \
+        *name##Ptr = (value);                   \
+    }                                           \
+    if (valid)                                  \
+    {                                           \
+        validFields |= (bit);                   \
+    }
+
+    SIMU_FIELD(latitude, GnssLocation.latitude,
+               (LE_FAULT != GnssLocation.result) && (INT32_MAX != GnssLocation.latitude),
+               LE_GNSS_SAMPLE_LATITUDE);
+    SIMU_FIELD(longitude, GnssLocation.longitude,
+               (LE_FAULT != GnssLocation.result) && (INT32_MAX != GnssLocation.longitude),
+               LE_GNSS_SAMPLE_LONGITUDE);
+    SIMU_FIELD(hAccuracy, GnssLocation.accuracy,
+               (LE_FAULT != GnssLocation.result) && (INT32_MAX != GnssLocation.accuracy),
+               LE_GNSS_SAMPLE_H_ACCURACY);
+    SIMU_FIELD(altitude, GnssAltitude.altitude,
+               (LE_FAULT != GnssAltitude.result) && (INT32_MAX != GnssAltitude.altitude),
+               LE_GNSS_SAMPLE_ALTITUDE);
+    SIMU_FIELD(vAccuracy, GnssAltitude.accuracy,
+               (LE_FAULT != GnssAltitude.result) && (INT32_MAX != GnssAltitude.accuracy),
+               LE_GNSS_SAMPLE_V_ACCURACY);
+    SIMU_FIELD(altitudeOnWgs84, INT32_MAX, false, 0);
+    SIMU_FIELD(hSpeed, GnssHSpeed.speed,
+               (LE_FAULT != GnssHSpeed.result) && (UINT32_MAX != GnssHSpeed.speed),
+               LE_GNSS_SAMPLE_H_SPEED);
+    SIMU_FIELD(hSpeedAccuracy, GnssHSpeed.accuracy,
+               (LE_FAULT != GnssHSpeed.result) && (UINT32_MAX != GnssHSpeed.accuracy),
+               LE_GNSS_SAMPLE_H_SPEED_ACCURACY);
+    SIMU_FIELD(vSpeed, GnssVSpeed.speed,
+               (LE_FAULT != GnssVSpeed.result) && (INT32_MAX != GnssVSpeed.speed),
+               LE_GNSS_SAMPLE_V_SPEED);
+    SIMU_FIELD(vSpeedAccuracy, GnssVSpeed.accuracy,
+               (LE_FAULT != GnssVSpeed.result) && (INT32_MAX != GnssVSpeed.accuracy),
+               LE_GNSS_SAMPLE_V_SPEED_ACCURACY);
+    SIMU_FIELD(direction, GnssDirection.direction,
+               (LE_FAULT != GnssDirection.result) && (UINT32_MAX != GnssDirection.direction),
+               LE_GNSS_SAMPLE_DIRECTION);
+    SIMU_FIELD(directionAccuracy, GnssDirection.accuracy,
+               (LE_FAULT != GnssDirection.result) && (UINT32_MAX != GnssDirection.accuracy),
+               LE_GNSS_SAMPLE_DIRECTION_ACCURACY);
+    SIMU_FIELD(year, GnssDate.year, LE_OK == GnssDate.result, LE_GNSS_SAMPLE_DATE);
+    SIMU_FIELD(month, GnssDate.month, LE_OK == GnssDate.result, LE_GNSS_SAMPLE_DATE);
+    SIMU_FIELD(day, GnssDate.day, LE_OK == GnssDate.result, LE_GNSS_SAMPLE_DATE);
+    SIMU_FIELD(hours, GnssTime.hrs, LE_OK == GnssTime.result, LE_GNSS_SAMPLE_TIME);
+    SIMU_FIELD(minutes, GnssTime.min, LE_OK == GnssTime.result, LE_GNSS_SAMPLE_TIME);
+    SIMU_FIELD(seconds, GnssTime.sec, LE_OK == GnssTime.result, LE_GNSS_SAMPLE_TIME);
+    SIMU_FIELD(milliseconds, GnssTime.msec, LE_OK == GnssTime.result, LE_GNSS_SAMPLE_TIME);
+    SIMU_FIELD(epochTime, 0, false, 0);
+    SIMU_FIELD(timeAccuracy, UINT16_MAX, false, 0);
+    SIMU_FIELD(leapSeconds, UINT8_MAX, false, 0);
+    SIMU_FIELD(hdop, UINT16_MAX, false, 0);
+    SIMU_FIELD(vdop, UINT16_MAX, false, 0);
+    SIMU_FIELD(pdop, UINT16_MAX, false, 0);
+    SIMU_FIELD(magneticDeviation, INT32_MAX, false, 0);
+    SIMU_FIELD(satsInViewCount, UINT8_MAX, false, 0);
+    SIMU_FIELD(satsTrackingCount, UINT8_MAX, false, 0);
+    SIMU_FIELD(satsUsedCount, UINT8_MAX, false, 0);
+
+#undef SIMU_FIELD
+
+    if (statePtr)
+    {
+        *statePtr = GnssSimuPositionSate.state;
+    }
+    if (validFieldsPtr)
+    {
+        *validFieldsPtr = validFields;
+    }
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to release the position sample.
@@ -134,6 +134,7 @@ void le_gnssSimu_SetVSpeed(gnssSimuVSpeed_t gnssVSpeed);
 void le_gnssSimu_SetTime(gnssSimuTime_t gnssTime);
 void le_gnssSimu_SetSampleRef(le_gnss_SampleRef_t sample);
 void le_gnssSimu_SetPositionState(gnssSimuPositionState_t state);
+void le_gnssSimu_ReportPosition(void);
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -558,6 +559,42 @@ le_result_t le_gnss_GetMagneticDeviation
         ///< [OUT] MagneticDeviation in degrees [resolution 1e-1].
 );
 
+le_result_t le_gnss_GetSampleData
+(
+    le_gnss_SampleRef_t positionSampleRef,              ///< [IN] Position sample's reference.
+    le_gnss_FixState_t* statePtr,                       ///< [OUT]
+    le_gnss_SampleFieldBitMask_t* validFieldsPtr,       ///< [OUT]
+    int32_t* latitudePtr,                               ///< [OUT]
+    int32_t* longitudePtr,                              ///< [OUT]
+    int32_t* hAccuracyPtr,                              ///< [OUT]
+    int32_t* altitudePtr,                               ///< [OUT]
+    int32_t* vAccuracyPtr,                              ///< [OUT]
+    int32_t* altitudeOnWgs84Ptr,                        ///< [OUT]
+    uint32_t* hSpeedPtr,                                ///< [OUT]
+    uint32_t* hSpeedAccuracyPtr,                        ///< [OUT]
+    int32_t* vSpeedPtr,                                 ///< [OUT]
+    int32_t* vSpeedAccuracyPtr,                         ///< [OUT]
+    uint32_t* directionPtr,                             ///< [OUT]
+    uint32_t* directionAccuracyPtr,                     ///< [OUT]
+    uint16_t* yearPtr,                                  ///< [OUT]
+    uint16_t* monthPtr,                                 ///< [OUT]
+    uint16_t* dayPtr,                                   ///< [OUT]
+    uint16_t* hoursPtr,                                 ///< [OUT]
+    uint16_t* minutesPtr,                               ///< [OUT]
+    uint16_t* secondsPtr,                               ///< [OUT]
+    uint16_t* millisecondsPtr,                          ///< [OUT]
+    uint64_t* epochTimePtr,                             ///< [OUT]
+    uint32_t* timeAccuracyPtr,                          ///< [OUT]
+    uint8_t* leapSecondsPtr,                            ///< [OUT]
+    uint16_t* hdopPtr,                                  ///< [OUT]
+    uint16_t* vdopPtr,                                  ///< [OUT]
+    uint16_t* pdopPtr,                                  ///< [OUT]
+    int32_t* magneticDeviationPtr,                      ///< [OUT]
+    uint8_t* satsInViewCountPtr,                        ///< [OUT]
+    uint8_t* satsTrackingCountPtr,                      ///< [OUT]
+    uint8_t* satsUsedCountPtr                           ///< [OUT]
+);
+
 le_gnss_SampleRef_t le_gnss_GetLastSampleRef
 (
     void
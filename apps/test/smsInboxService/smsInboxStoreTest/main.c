@@ -0,0 +1,513 @@
+/**
+ * This module implements the unit tests and the benchmark of the smsInbox message store.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "smsInboxStore.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of messages stored by the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCHMARK_MSG_COUNT         10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the messages stored by the benchmark, about the size of a text SMS.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCHMARK_MSG_BYTES         200
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of messages stored by the functional tests.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TEST_MSG_COUNT              20
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mailbox names.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* MboxNames[] = { "le_smsInbox1", "le_smsInbox2", "le_smsInbox3" };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory of the store.
+ */
+//--------------------------------------------------------------------------------------------------
+static char StoreDir[] = "/tmp/smsInboxStoreTestXXXXXX";
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the data of a message from its number.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t MakeData
+(
+    uint32_t number,
+    uint8_t* dataPtr
+)
+{
+    size_t dataSize = 1 + number % 100;
+    size_t i;
+
+    for (i = 0; i < dataSize; i++)
+    {
+        dataPtr[i] = number + i;
+    }
+
+    return dataSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the data of a message.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckData
+(
+    uint32_t msgId,
+    uint32_t number
+)
+{
+    uint8_t expected[SMSINBOXSTORE_MAX_DATA_BYTES];
+    uint8_t data[SMSINBOXSTORE_MAX_DATA_BYTES];
+    size_t expectedSize = MakeData(number, expected);
+    size_t dataSize = sizeof(data);
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Read(msgId, data, &dataSize));
+    LE_ASSERT(expectedSize == dataSize);
+    LE_ASSERT(0 == memcmp(expected, data, dataSize));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of a store file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetStorePath
+(
+    const char* fileNamePtr,
+    char* pathPtr,
+    size_t pathSize
+)
+{
+    LE_ASSERT(snprintf(pathPtr, pathSize, "%s/%s", StoreDir, fileNamePtr) < (int)pathSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the size of a store file.
+ */
+//--------------------------------------------------------------------------------------------------
+static off_t GetStoreFileSize
+(
+    const char* fileNamePtr
+)
+{
+    char path[PATH_MAX];
+    struct stat st;
+
+    GetStorePath(fileNamePtr, path, sizeof(path));
+    LE_ASSERT(0 == stat(path, &st));
+
+    return st.st_size;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reopen the store, from its index or by replaying the whole log.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Reopen
+(
+    bool removeIndex
+)
+{
+    char path[PATH_MAX];
+
+    SmsInboxStore_Close();
+
+    if (removeIndex)
+    {
+        GetStorePath("index", path, sizeof(path));
+        LE_ASSERT(0 == unlink(path));
+    }
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Init(StoreDir, MboxNames, NUM_ARRAY_MEMBERS(MboxNames)));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the messages stored by Test_smsInboxStore_Messages().
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckMessages
+(
+    uint32_t firstMsgId
+)
+{
+    uint32_t msgId;
+    uint32_t i;
+
+    // Mailbox 0 holds the even messages but the first, read in mailbox 0.
+    LE_ASSERT(TEST_MSG_COUNT / 2 - 1 == SmsInboxStore_GetCount(0));
+    msgId = 0;
+    for (i = 2; i < TEST_MSG_COUNT; i += 2)
+    {
+        msgId = SmsInboxStore_GetNext(0, msgId);
+        LE_ASSERT(firstMsgId + i == msgId);
+        LE_ASSERT(!SmsInboxStore_IsUnread(msgId, 0));
+        CheckData(msgId, i);
+    }
+    LE_ASSERT(0 == SmsInboxStore_GetNext(0, msgId));
+
+    // Mailbox 1 holds all the messages but the first, unread in mailbox 1.
+    LE_ASSERT(TEST_MSG_COUNT - 1 == SmsInboxStore_GetCount(1));
+    msgId = 0;
+    for (i = 1; i < TEST_MSG_COUNT; i++)
+    {
+        msgId = SmsInboxStore_GetNext(1, msgId);
+        LE_ASSERT(firstMsgId + i == msgId);
+        LE_ASSERT(SmsInboxStore_IsUnread(msgId, 1));
+    }
+    LE_ASSERT(0 == SmsInboxStore_GetNext(1, msgId));
+
+    // The first message is deleted, and mailbox 2 is empty.
+    LE_ASSERT(!SmsInboxStore_IsInMbox(firstMsgId, 0));
+    LE_ASSERT(!SmsInboxStore_IsInMbox(firstMsgId, 1));
+    LE_ASSERT(0 == SmsInboxStore_GetCount(2));
+    LE_ASSERT(0 == SmsInboxStore_GetNext(2, 0));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test adding, reading, marking and removing messages, and reopening the store.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_smsInboxStore_Messages
+(
+    void
+)
+{
+    uint8_t data[SMSINBOXSTORE_MAX_DATA_BYTES + 1];
+    size_t dataSize;
+    uint32_t firstMsgId = 0;
+    uint32_t msgId;
+    uint32_t i;
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Clear());
+
+    for (i = 0; i < TEST_MSG_COUNT; i++)
+    {
+        dataSize = MakeData(i, data);
+        LE_ASSERT(LE_OK == SmsInboxStore_Add(data, dataSize, (i % 2) ? 0x2 : 0x3, &msgId));
+        LE_ASSERT(msgId == SmsInboxStore_GetLastId());
+
+        if (0 == i)
+        {
+            firstMsgId = msgId;
+        }
+
+        LE_ASSERT(firstMsgId + i == msgId);
+        LE_ASSERT(SmsInboxStore_IsUnread(msgId, 1));
+        LE_ASSERT(SmsInboxStore_IsUnread(msgId, 0) == !(i % 2));
+    }
+
+    // Invalid messages.
+    LE_ASSERT(LE_BAD_PARAMETER == SmsInboxStore_Add(data, sizeof(data), 0x1, &msgId));
+    LE_ASSERT(LE_BAD_PARAMETER == SmsInboxStore_Add(data, 1, 0, &msgId));
+    LE_ASSERT(LE_BAD_PARAMETER == SmsInboxStore_Import(firstMsgId, data, 1, 0x1, 0x1));
+
+    dataSize = 0;
+    LE_ASSERT(LE_OVERFLOW == SmsInboxStore_Read(firstMsgId + 1, data, &dataSize));
+    dataSize = sizeof(data);
+    LE_ASSERT(LE_NOT_FOUND == SmsInboxStore_Read(firstMsgId + TEST_MSG_COUNT, data, &dataSize));
+
+    // Mark the even messages read in mailbox 0, then remove the first one from both mailboxes.
+    for (i = 0; i < TEST_MSG_COUNT; i += 2)
+    {
+        LE_ASSERT(LE_OK == SmsInboxStore_SetUnread(firstMsgId + i, 0, false));
+    }
+    LE_ASSERT(LE_NOT_FOUND == SmsInboxStore_SetUnread(firstMsgId + 1, 0, false));
+    LE_ASSERT(LE_NOT_FOUND == SmsInboxStore_Remove(firstMsgId + 1, 2));
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Remove(firstMsgId, 0));
+    CheckData(firstMsgId, 0);
+    LE_ASSERT(LE_OK == SmsInboxStore_Remove(firstMsgId, 1));
+    dataSize = sizeof(data);
+    LE_ASSERT(LE_NOT_FOUND == SmsInboxStore_Read(firstMsgId, data, &dataSize));
+    LE_ASSERT(LE_NOT_FOUND == SmsInboxStore_Remove(firstMsgId, 1));
+
+    CheckMessages(firstMsgId);
+
+    // The state is the same after reopening from the index, and from the log alone.
+    Reopen(false);
+    CheckMessages(firstMsgId);
+    Reopen(true);
+    CheckMessages(firstMsgId);
+    LE_ASSERT(firstMsgId + TEST_MSG_COUNT - 1 == SmsInboxStore_GetLastId());
+
+    // Identifiers are not reused, even when the last messages are deleted.
+    for (i = 1; i < TEST_MSG_COUNT; i++)
+    {
+        SmsInboxStore_Remove(firstMsgId + i, 0);
+        LE_ASSERT(LE_OK == SmsInboxStore_Remove(firstMsgId + i, 1));
+    }
+    LE_ASSERT(LE_OK == SmsInboxStore_Clear());
+    Reopen(true);
+    LE_ASSERT(LE_OK == SmsInboxStore_Add(data, 1, 0x1, &msgId));
+    LE_ASSERT(firstMsgId + TEST_MSG_COUNT == msgId);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that a partial record at the end of the log is dropped at start-up, and that a corrupted
+ * record in the middle of the log does not drop the records after it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_smsInboxStore_CrashRecovery
+(
+    void
+)
+{
+    uint8_t data[SMSINBOXSTORE_MAX_DATA_BYTES];
+    char path[PATH_MAX];
+    uint32_t msgId;
+    uint32_t lastMsgId;
+    size_t dataSize;
+    int i;
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Clear());
+
+    for (i = 0; i < 3; i++)
+    {
+        dataSize = MakeData(i + 50, data);
+        LE_ASSERT(LE_OK == SmsInboxStore_Add(data, dataSize, 0x1, &msgId));
+    }
+    lastMsgId = msgId;
+    LE_ASSERT(LE_OK == SmsInboxStore_SetUnread(lastMsgId - 1, 0, false));
+
+    // Simulate a crash while appending a message: the index is not saved, and the record is cut.
+    off_t logSize = GetStoreFileSize("log");
+    LE_ASSERT(LE_OK == SmsInboxStore_Add(data, dataSize, 0x1, &msgId));
+    GetStorePath("log", path, sizeof(path));
+    LE_ASSERT(0 == truncate(path, logSize + 10));
+
+    GetStorePath("index", path, sizeof(path));
+    unlink(path);
+    SmsInboxStore_Close();
+    unlink(path);
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Init(StoreDir, MboxNames, NUM_ARRAY_MEMBERS(MboxNames)));
+    LE_ASSERT(logSize == GetStoreFileSize("log"));
+    LE_ASSERT(3 == SmsInboxStore_GetCount(0));
+    LE_ASSERT(lastMsgId == SmsInboxStore_GetLastId());
+    LE_ASSERT(!SmsInboxStore_IsUnread(lastMsgId - 1, 0));
+    CheckData(lastMsgId, 52);
+
+    // A corrupted record is dropped too.
+    LE_ASSERT(LE_OK == SmsInboxStore_Add(data, dataSize, 0x1, &msgId));
+    LE_ASSERT(lastMsgId + 1 == msgId);
+    SmsInboxStore_Close();
+    GetStorePath("index", path, sizeof(path));
+    unlink(path);
+
+    GetStorePath("log", path, sizeof(path));
+    int fd = open(path, O_WRONLY);
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(1 == pwrite(fd, "x", 1, logSize + 30));
+    close(fd);
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Init(StoreDir, MboxNames, NUM_ARRAY_MEMBERS(MboxNames)));
+    LE_ASSERT(logSize == GetStoreFileSize("log"));
+    LE_ASSERT(3 == SmsInboxStore_GetCount(0));
+
+    // A corrupted record in the middle of the log is skipped, and the next records are kept.
+    for (i = 0; i < 3; i++)
+    {
+        dataSize = MakeData(i + 60, data);
+        LE_ASSERT(LE_OK == SmsInboxStore_Add(data, dataSize, 0x2, &msgId));
+    }
+    SmsInboxStore_Close();
+    GetStorePath("index", path, sizeof(path));
+    unlink(path);
+
+    off_t fullLogSize = GetStoreFileSize("log");
+    GetStorePath("log", path, sizeof(path));
+    fd = open(path, O_WRONLY);
+    LE_ASSERT(fd >= 0);
+    LE_ASSERT(1 == pwrite(fd, "x", 1, logSize + 30));
+    close(fd);
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Init(StoreDir, MboxNames, NUM_ARRAY_MEMBERS(MboxNames)));
+    LE_ASSERT(fullLogSize == GetStoreFileSize("log"));
+    LE_ASSERT(3 == SmsInboxStore_GetCount(0));
+    LE_ASSERT(2 == SmsInboxStore_GetCount(1));
+    LE_ASSERT(msgId - 1 == SmsInboxStore_GetNext(1, 0));
+    CheckData(msgId - 1, 61);
+    CheckData(msgId, 62);
+    LE_ASSERT(msgId == SmsInboxStore_GetLastId());
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that the messages follow their mailboxes when the mailboxes change.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_smsInboxStore_MboxChange
+(
+    void
+)
+{
+    const char* newMboxNames[] = { "le_smsInbox3", "le_smsInbox1" };
+    uint8_t data[1] = { 0 };
+    uint32_t msgId1;
+    uint32_t msgId2;
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Clear());
+    LE_ASSERT(LE_OK == SmsInboxStore_Add(data, sizeof(data), 0x1, &msgId1));
+    LE_ASSERT(LE_OK == SmsInboxStore_Add(data, sizeof(data), 0x6, &msgId2));
+    LE_ASSERT(LE_OK == SmsInboxStore_SetUnread(msgId2, 2, false));
+    SmsInboxStore_Close();
+
+    LE_ASSERT(LE_OK == SmsInboxStore_Init(StoreDir, newMboxNames, NUM_ARRAY_MEMBERS(newMboxNames)));
+    LE_ASSERT(SmsInboxStore_IsInMbox(msgId1, 1));
+    LE_ASSERT(SmsInboxStore_IsUnread(msgId1, 1));
+    LE_ASSERT(SmsInboxStore_IsInMbox(msgId2, 0));
+    LE_ASSERT(!SmsInboxStore_IsUnread(msgId2, 0));
+    LE_ASSERT(!SmsInboxStore_IsInMbox(msgId2, 1));
+    LE_ASSERT(1 == SmsInboxStore_GetCount(0));
+    LE_ASSERT(1 == SmsInboxStore_GetCount(1));
+
+    Reopen(false);
+    LE_ASSERT(SmsInboxStore_IsInMbox(msgId1, 0));
+    LE_ASSERT(!SmsInboxStore_IsInMbox(msgId2, 0));
+    LE_ASSERT(SmsInboxStore_IsInMbox(msgId2, 2));
+    LE_ASSERT(!SmsInboxStore_IsUnread(msgId2, 2));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetElapsedMs
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return elapsed.sec * 1000.0 + elapsed.usec / 1000.0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Benchmark a store of BENCHMARK_MSG_COUNT messages, kept in every mailbox like the smsInbox
+ * does, and check that the log is compacted once they are deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_smsInboxStore_Benchmark
+(
+    void
+)
+{
+    uint8_t data[BENCHMARK_MSG_BYTES];
+    uint32_t firstMsgId = 0;
+    uint32_t msgId;
+    le_clk_Time_t start;
+    uint32_t i;
+
+    memset(data, 'a', sizeof(data));
+    LE_ASSERT(LE_OK == SmsInboxStore_Clear());
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCHMARK_MSG_COUNT; i++)
+    {
+        LE_ASSERT(LE_OK == SmsInboxStore_Add(data, sizeof(data), 0x7, &msgId));
+        if (0 == i)
+        {
+            firstMsgId = msgId;
+        }
+    }
+    LE_INFO("Add %u messages: %.1f ms", BENCHMARK_MSG_COUNT, GetElapsedMs(start));
+    LE_INFO("Log: %u bytes, index: %u bytes",
+            (uint32_t)GetStoreFileSize("log"), (uint32_t)GetStoreFileSize("index"));
+
+    start = le_clk_GetRelativeTime();
+    Reopen(false);
+    LE_INFO("Open from the index: %.1f ms", GetElapsedMs(start));
+    LE_ASSERT(BENCHMARK_MSG_COUNT == SmsInboxStore_GetCount(2));
+
+    start = le_clk_GetRelativeTime();
+    Reopen(true);
+    LE_INFO("Open from the log only: %.1f ms", GetElapsedMs(start));
+    LE_ASSERT(BENCHMARK_MSG_COUNT == SmsInboxStore_GetCount(2));
+
+    // List and read a mailbox, as a client does.
+    start = le_clk_GetRelativeTime();
+    msgId = 0;
+    for (i = 0; i < BENCHMARK_MSG_COUNT; i++)
+    {
+        uint8_t readData[SMSINBOXSTORE_MAX_DATA_BYTES];
+        size_t readSize = sizeof(readData);
+
+        msgId = SmsInboxStore_GetNext(0, msgId);
+        LE_ASSERT(firstMsgId + i == msgId);
+        LE_ASSERT(SmsInboxStore_IsInMbox(msgId, 0));
+        LE_ASSERT(LE_OK == SmsInboxStore_Read(msgId, readData, &readSize));
+        LE_ASSERT(LE_OK == SmsInboxStore_SetUnread(msgId, 0, false));
+    }
+    LE_ASSERT(0 == SmsInboxStore_GetNext(0, msgId));
+    LE_INFO("List, read and mark %u messages: %.1f ms", BENCHMARK_MSG_COUNT, GetElapsedMs(start));
+
+    // Delete the oldest messages of all mailboxes, as when the mailboxes are full.
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCHMARK_MSG_COUNT; i++)
+    {
+        uint8_t mbox;
+
+        for (mbox = 0; mbox < NUM_ARRAY_MEMBERS(MboxNames); mbox++)
+        {
+            msgId = SmsInboxStore_GetNext(mbox, 0);
+            LE_ASSERT(firstMsgId + i == msgId);
+            LE_ASSERT(LE_OK == SmsInboxStore_Remove(msgId, mbox));
+        }
+    }
+    LE_INFO("Delete %u messages: %.1f ms", BENCHMARK_MSG_COUNT, GetElapsedMs(start));
+
+    LE_ASSERT(0 == SmsInboxStore_GetCount(0));
+    LE_ASSERT(GetStoreFileSize("log") < BENCHMARK_MSG_BYTES * BENCHMARK_MSG_COUNT / 10);
+
+    Reopen(true);
+    LE_ASSERT(0 == SmsInboxStore_GetNext(1, 0));
+    LE_ASSERT(firstMsgId + BENCHMARK_MSG_COUNT - 1 == SmsInboxStore_GetLastId());
+}
+
+
+COMPONENT_INIT
+{
+    LE_ASSERT(NULL != mkdtemp(StoreDir));
+    LE_ASSERT(LE_OK == SmsInboxStore_Init(StoreDir, MboxNames, NUM_ARRAY_MEMBERS(MboxNames)));
+
+    // tests
+    Test_smsInboxStore_Messages();
+    Test_smsInboxStore_CrashRecovery();
+    Test_smsInboxStore_MboxChange();
+    Test_smsInboxStore_Benchmark();
+
+    SmsInboxStore_Close();
+    le_dir_RemoveRecursive(StoreDir);
+
+    LE_INFO("SMS inbox store tests passed");
+    exit(0);
+}
@@ -0,0 +1,379 @@
+/**
+ * This module implements the unit tests and the benchmark of the sysfs GPIO utilities, run
+ * against a fake sysfs GPIO directory.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "gpioSysfs.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fake sysfs GPIO directory. gpioSysfsUtils.c is built with SYSFS_GPIO_PATH set to it.
+ */
+//--------------------------------------------------------------------------------------------------
+#define FAKE_SYSFS_PATH             SYSFS_GPIO_PATH
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of toggles done by the benchmark.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BENCHMARK_TOGGLE_COUNT      10000
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * GPIO objects of the fake pins 1 to 4.
+ */
+//--------------------------------------------------------------------------------------------------
+static struct gpioSysfs_Gpio Pins[] =
+{
+    {1,"gpio1",false,NULL,-1,NULL,NULL,NULL,-1,false},
+    {2,"gpio2",false,NULL,-1,NULL,NULL,NULL,-1,false},
+    {3,"gpio3",false,NULL,-1,NULL,NULL,NULL,-1,false},
+    {4,"gpio4",false,NULL,-1,NULL,NULL,NULL,-1,false},
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * References to the GPIO objects, indexed by bit position in the masks.
+ */
+//--------------------------------------------------------------------------------------------------
+static gpioSysfs_GpioRef_t PinRefs[] = { &Pins[0], &Pins[1], &Pins[2], &Pins[3] };
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fake session of the pins.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_SessionRef_t FakeSessionRef = (le_msg_SessionRef_t)0x1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a file of the fake sysfs.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteFakeFile
+(
+    const char* gpioName,
+    const char* attrName,
+    const char* content
+)
+{
+    char path[128];
+    FILE* fp;
+
+    snprintf(path, sizeof(path), "%s/%s/%s", FAKE_SYSFS_PATH, gpioName, attrName);
+    fp = fopen(path, "w");
+    LE_ASSERT(NULL != fp);
+    LE_ASSERT(strlen(content) == fwrite(content, 1, strlen(content), fp));
+    LE_ASSERT(0 == fclose(fp));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the first character of a file of the fake sysfs.
+ */
+//--------------------------------------------------------------------------------------------------
+static char ReadFakeFile
+(
+    const char* gpioName,
+    const char* attrName
+)
+{
+    char path[128];
+    FILE* fp;
+    int c;
+
+    snprintf(path, sizeof(path), "%s/%s/%s", FAKE_SYSFS_PATH, gpioName, attrName);
+    fp = fopen(path, "r");
+    LE_ASSERT(NULL != fp);
+    c = fgetc(fp);
+    fclose(fp);
+    LE_ASSERT(EOF != c);
+
+    return (char)c;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the fake sysfs, with pins 1 to 4 exported as inputs.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CreateFakeSysfs
+(
+    void
+)
+{
+    char path[128];
+    size_t i;
+
+    le_dir_RemoveRecursive(FAKE_SYSFS_PATH);
+
+    snprintf(path, sizeof(path), "%s/gpiochip1", FAKE_SYSFS_PATH);
+    LE_ASSERT(LE_OK == le_dir_MakePath(path, S_IRWXU));
+    WriteFakeFile("gpiochip1", "mask", "0x000000000000000f\n");
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Pins); i++)
+    {
+        snprintf(path, sizeof(path), "%s/%s", FAKE_SYSFS_PATH, Pins[i].gpioName);
+        LE_ASSERT(LE_OK == le_dir_MakePath(path, S_IRWXU));
+        WriteFakeFile(Pins[i].gpioName, "value", "0\n");
+        WriteFakeFile(Pins[i].gpioName, "direction", "in\n");
+        WriteFakeFile(Pins[i].gpioName, "edge", "none\n");
+        WriteFakeFile(Pins[i].gpioName, "active_low", "0\n");
+        WriteFakeFile(Pins[i].gpioName, "pull", "down\n");
+
+        Pins[i].inUse = true;
+        Pins[i].currentSession = FakeSessionRef;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test the pins advertised by the GPIO controller.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_gpioSysfs_IsPinAvailable
+(
+    void
+)
+{
+    LE_ASSERT(gpioSysfs_IsPinAvailable(1));
+    LE_ASSERT(gpioSysfs_IsPinAvailable(4));
+    LE_ASSERT(!gpioSysfs_IsPinAvailable(5));
+    LE_ASSERT(!gpioSysfs_IsPinAvailable(0));
+    LE_ASSERT(!gpioSysfs_IsPinAvailable(65));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test driving an output: the direction is written once, then only the value file is written.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_gpioSysfs_Output
+(
+    void
+)
+{
+    gpioSysfs_GpioRef_t gpioRef = &Pins[0];
+
+    LE_ASSERT(gpioSysfs_IsInput(gpioRef));
+
+    LE_ASSERT(LE_OK == gpioSysfs_Activate(gpioRef));
+    LE_ASSERT('o' == ReadFakeFile("gpio1", "direction"));
+    LE_ASSERT('1' == ReadFakeFile("gpio1", "value"));
+    LE_ASSERT(gpioRef->isOutput);
+    LE_ASSERT(gpioRef->valueFd >= 0);
+
+    // Mark the direction file so that rewriting it would be detected
+    WriteFakeFile("gpio1", "direction", "x\n");
+    LE_ASSERT(LE_OK == gpioSysfs_Deactivate(gpioRef));
+    LE_ASSERT('0' == ReadFakeFile("gpio1", "value"));
+    LE_ASSERT('x' == ReadFakeFile("gpio1", "direction"));
+    LE_ASSERT(gpioSysfs_IsOutput(gpioRef));
+    LE_ASSERT(!gpioSysfs_IsActive(gpioRef));
+
+    LE_ASSERT(LE_OK == gpioSysfs_SetPushPullOutput(gpioRef, SYSFS_ACTIVE_TYPE_LOW, true));
+    LE_ASSERT('o' == ReadFakeFile("gpio1", "direction"));
+    LE_ASSERT('1' == ReadFakeFile("gpio1", "active_low"));
+    LE_ASSERT('1' == ReadFakeFile("gpio1", "value"));
+    LE_ASSERT(gpioSysfs_IsActive(gpioRef));
+    LE_ASSERT(SYSFS_ACTIVE_TYPE_LOW == gpioSysfs_GetPolarity(gpioRef));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test reading an input through the value file kept open.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_gpioSysfs_Input
+(
+    void
+)
+{
+    gpioSysfs_GpioRef_t gpioRef = &Pins[1];
+
+    LE_ASSERT(LE_OK == gpioSysfs_SetInput(gpioRef, SYSFS_ACTIVE_TYPE_HIGH));
+    LE_ASSERT('i' == ReadFakeFile("gpio2", "direction"));
+    LE_ASSERT(!gpioRef->isOutput);
+    LE_ASSERT(gpioSysfs_IsInput(gpioRef));
+
+    LE_ASSERT(SYSFS_VALUE_LOW == gpioSysfs_ReadValue(gpioRef));
+    LE_ASSERT(gpioRef->valueFd >= 0);
+
+    // The new value is read through the same file descriptor
+    int fd = gpioRef->valueFd;
+    WriteFakeFile("gpio2", "value", "1\n");
+    LE_ASSERT(SYSFS_VALUE_HIGH == gpioSysfs_ReadValue(gpioRef));
+    WriteFakeFile("gpio2", "value", "0\n");
+    LE_ASSERT(SYSFS_VALUE_LOW == gpioSysfs_ReadValue(gpioRef));
+    LE_ASSERT(fd == gpioRef->valueFd);
+
+    // Switching an output back to input must write the direction again
+    LE_ASSERT(LE_OK == gpioSysfs_Activate(gpioRef));
+    LE_ASSERT(gpioRef->isOutput);
+    LE_ASSERT(LE_OK == gpioSysfs_SetInput(gpioRef, SYSFS_ACTIVE_TYPE_HIGH));
+    LE_ASSERT('i' == ReadFakeFile("gpio2", "direction"));
+    LE_ASSERT(gpioSysfs_IsInput(gpioRef));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test reading and writing several pins in one call.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_gpioSysfs_Batch
+(
+    void
+)
+{
+    uint64_t valueMask = 0;
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Pins); i++)
+    {
+        LE_ASSERT(LE_OK == gpioSysfs_SetPushPullOutput(&Pins[i], SYSFS_ACTIVE_TYPE_HIGH, false));
+    }
+
+    // Pin 3 (bit 2) is left untouched
+    WriteFakeFile("gpio3", "value", "1\n");
+    LE_ASSERT(LE_OK == gpioSysfs_WriteValues(PinRefs, NUM_ARRAY_MEMBERS(PinRefs), 0xB, 0xA));
+    LE_ASSERT('0' == ReadFakeFile("gpio1", "value"));
+    LE_ASSERT('1' == ReadFakeFile("gpio2", "value"));
+    LE_ASSERT('1' == ReadFakeFile("gpio3", "value"));
+    LE_ASSERT('1' == ReadFakeFile("gpio4", "value"));
+
+    LE_ASSERT(LE_OK == gpioSysfs_ReadValues(PinRefs, NUM_ARRAY_MEMBERS(PinRefs), 0xF, &valueMask));
+    LE_ASSERT(0xE == valueMask);
+    LE_ASSERT(LE_OK == gpioSysfs_ReadValues(PinRefs, NUM_ARRAY_MEMBERS(PinRefs), 0x9, &valueMask));
+    LE_ASSERT(0x8 == valueMask);
+
+    LE_ASSERT(LE_OK == gpioSysfs_WriteValues(PinRefs, NUM_ARRAY_MEMBERS(PinRefs), 0xF, 0x0));
+    LE_ASSERT(LE_OK == gpioSysfs_ReadValues(PinRefs, NUM_ARRAY_MEMBERS(PinRefs), 0xF, &valueMask));
+    LE_ASSERT(0x0 == valueMask);
+
+    // Pins out of the table are rejected
+    LE_ASSERT(LE_BAD_PARAMETER ==
+              gpioSysfs_WriteValues(PinRefs, NUM_ARRAY_MEMBERS(PinRefs), 0x10, 0x10));
+    LE_ASSERT(LE_BAD_PARAMETER ==
+              gpioSysfs_ReadValues(PinRefs, NUM_ARRAY_MEMBERS(PinRefs), 0x11, &valueMask));
+    LE_ASSERT(LE_OK == gpioSysfs_WriteValues(PinRefs, NUM_ARRAY_MEMBERS(PinRefs), 0x0, 0x0));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Test that the value file and the known direction are released with the session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_gpioSysfs_SessionClose
+(
+    void
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(Pins); i++)
+    {
+        gpioSysfs_SessionCloseHandlerFunc(FakeSessionRef, &Pins[i]);
+        LE_ASSERT(!Pins[i].inUse);
+        LE_ASSERT(-1 == Pins[i].valueFd);
+        LE_ASSERT(!Pins[i].isOutput);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a start time, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetElapsedMs
+(
+    le_clk_Time_t start
+)
+{
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), start);
+
+    return elapsed.sec * 1000.0 + elapsed.usec / 1000.0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare the toggle rate of an output when the value file is opened for each write, as it used
+ * to be, and when it is kept open.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Test_gpioSysfs_Benchmark
+(
+    void
+)
+{
+    gpioSysfs_GpioRef_t gpioRef = &Pins[0];
+    char path[128];
+    le_clk_Time_t start;
+    double elapsedMs;
+    uint32_t i;
+
+    snprintf(path, sizeof(path), "%s/%s/%s", FAKE_SYSFS_PATH, gpioRef->gpioName, "value");
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCHMARK_TOGGLE_COUNT; i++)
+    {
+        FILE* fp = fopen(path, "w");
+        LE_ASSERT(NULL != fp);
+        fprintf(fp, "%d", (int)(i & 1));
+        fclose(fp);
+    }
+    elapsedMs = GetElapsedMs(start);
+    LE_INFO("%u toggles opening the value file: %.1f ms (%.0f toggles/s)",
+            BENCHMARK_TOGGLE_COUNT, elapsedMs, BENCHMARK_TOGGLE_COUNT * 1000.0 / elapsedMs);
+
+    LE_ASSERT(LE_OK == gpioSysfs_SetPushPullOutput(gpioRef, SYSFS_ACTIVE_TYPE_HIGH, false));
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCHMARK_TOGGLE_COUNT; i++)
+    {
+        LE_ASSERT(LE_OK == ((i & 1) ? gpioSysfs_Activate(gpioRef) :
+                                      gpioSysfs_Deactivate(gpioRef)));
+    }
+    elapsedMs = GetElapsedMs(start);
+    LE_INFO("%u toggles with the value file kept open: %.1f ms (%.0f toggles/s)",
+            BENCHMARK_TOGGLE_COUNT, elapsedMs, BENCHMARK_TOGGLE_COUNT * 1000.0 / elapsedMs);
+
+    start = le_clk_GetRelativeTime();
+    for (i = 0; i < BENCHMARK_TOGGLE_COUNT; i++)
+    {
+        LE_ASSERT(LE_OK == gpioSysfs_WriteValues(PinRefs, NUM_ARRAY_MEMBERS(PinRefs),
+                                                 0xF, (i & 1) ? 0xF : 0x0));
+    }
+    elapsedMs = GetElapsedMs(start);
+    LE_INFO("%u toggles of %u pins in one call: %.1f ms",
+            BENCHMARK_TOGGLE_COUNT, (uint32_t)NUM_ARRAY_MEMBERS(PinRefs), elapsedMs);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main of the test.
+ */
+//--------------------------------------------------------------------------------------------------
+COMPONENT_INIT
+{
+    CreateFakeSysfs();
+
+    Test_gpioSysfs_IsPinAvailable();
+    Test_gpioSysfs_Output();
+    Test_gpioSysfs_Input();
+    Test_gpioSysfs_Batch();
+    Test_gpioSysfs_Benchmark();
+    Test_gpioSysfs_SessionClose();
+
+    le_dir_RemoveRecursive(FAKE_SYSFS_PATH);
+
+    LE_INFO("sysfs GPIO tests passed");
+    exit(0);
+}
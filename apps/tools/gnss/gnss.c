@@ -11,6 +11,7 @@
 
 #include "legato.h"
 #include "interfaces.h"
+#include "le_gnssBroadcast.h"
 
 //-------------------------------------------------------------------------------------------------
 /**
@@ -98,7 +99,8 @@ void PrintGnssHelp
          "\t\t\tgnss set acqRate <acqRate in milliseconds>\n"
          "\t\t\tgnss set nmeaSentences <nmeaMask>\n"
          "\t\t\tgnss set minElevation <minElevation in degrees>\n"
-         "\t\t\tgnss watch [WatchPeriod in seconds]\n\n"
+         "\t\t\tgnss watch [WatchPeriod in seconds]\n"
+         "\t\t\tgnss nmea [WatchPeriod in seconds]\n\n"
          "\t\tDESCRIPTION:\n"
          "\t\t\tgnss help\n"
          "\t\t\t\t- Print this help message and exit\n\n"
@@ -194,6 +196,11 @@ void PrintGnssHelp
          "\t\t\t\t- Used to monitor all gnss information(position, speed, satellites used etc).\n"
          "\t\t\t\t  Here, WatchPeriod is optional. Default time(600s) will be used if not\n"
          "\t\t\t\t  specified\n\n"
+         "\t\t\tgnss nmea [WatchPeriod in seconds]\n"
+         "\t\t\t\t- Used to print the NMEA flow, read from the GNSS broadcast ring shared by\n"
+         "\t\t\t\t  all its readers. NMEA sentences lost by falling behind are reported.\n"
+         "\t\t\t\t  Here, WatchPeriod is optional. Default time(600s) will be used if not\n"
+         "\t\t\t\t  specified\n\n"
          "\tPlease note, some commands require gnss device to be in specific state\n"
          "\t(and platform reboot) to produce valid result. Please look :\n"
          "\thttp://legato.io/legato-docs/latest/howToGNSS.html,\n"
@@ -2112,6 +2119,98 @@ static int WatchGnssInfo
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function to print the NMEA flow read from the GNSS broadcast ring.
+ *
+ * @return
+ *     - EXIT_SUCCESS on success.
+ *     - EXIT_FAILURE on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static int WatchNmea
+(
+    uint32_t watchPeriod          ///< [IN] Watch period in seconds.
+)
+{
+    le_gnssBroadcast_Reader_t reader;
+    int fd;
+    le_result_t result = le_gnss_GetBroadcastFd(&fd);
+
+    if (LE_OK != result)
+    {
+        printf("Failed to get the GNSS broadcast ring! %s\n", LE_RESULT_TXT(result));
+        return EXIT_FAILURE;
+    }
+
+    result = le_gnssBroadcast_Attach(fd, &reader);
+    close(fd);
+    if (LE_OK != result)
+    {
+        printf("Failed to map the GNSS broadcast ring! %s\n", LE_RESULT_TXT(result));
+        return EXIT_FAILURE;
+    }
+
+    printf("Watch NMEA flow for %ds\n", watchPeriod);
+
+    le_clk_Time_t period = { watchPeriod, 0 };
+    le_clk_Time_t endTime = le_clk_Add(le_clk_GetRelativeTime(), period);
+
+    for (;;)
+    {
+        const le_gnssBroadcast_Record_t* recordPtr;
+        uint32_t lostCount = reader.overrunCount;
+        char nmea[LE_GNSSBROADCAST_NMEA_MAX_BYTES];
+        size_t size;
+
+        result = le_gnssBroadcast_Peek(&reader, &recordPtr);
+
+        if (LE_WOULD_BLOCK == result)
+        {
+            le_clk_Time_t remaining = le_clk_Sub(endTime, le_clk_GetRelativeTime());
+
+            if (remaining.sec < 0)
+            {
+                break;
+            }
+            le_gnssBroadcast_Wait(&reader, remaining.sec * 1000 + remaining.usec / 1000);
+            continue;
+        }
+
+        if (LE_OK == result)
+        {
+            if (LE_GNSSBROADCAST_NMEA != recordPtr->type)
+            {
+                le_gnssBroadcast_Next(&reader);
+                continue;
+            }
+
+            // Copy the sentence out before checking that it wasn't overwritten meanwhile.
+            size = recordPtr->size;
+            if (size > sizeof(nmea))
+            {
+                size = sizeof(nmea);
+            }
+            memcpy(nmea, recordPtr->data.nmea, size);
+
+            if (LE_OK == le_gnssBroadcast_Next(&reader))
+            {
+                fwrite(nmea, 1, size, stdout);
+                continue;
+            }
+        }
+
+        fflush(stdout);
+        fprintf(stderr, "%u NMEA records lost\n", reader.overrunCount - lostCount);
+    }
+
+    fflush(stdout);
+    le_gnssBroadcast_Detach(&reader);
+
+    return EXIT_SUCCESS;
+}
+
+
 //-------------------------------------------------------------------------------------------------
 /**
  * This function prints the GNSS device status.
@@ -2433,6 +2532,25 @@ COMPONENT_INIT
         strcpy(ParamsName, commandPtr);
         exit(WatchGnssInfo(watchPeriod));
     }
+    else if (strcmp(commandPtr, "nmea") == 0)
+    {
+        const char* watchPeriodPtr = le_arg_GetArg(1);
+        uint32_t watchPeriod = DEFAULT_WATCH_PERIOD;
+        //Check whether any watch period value is specified.
+        if (NULL != watchPeriodPtr)
+        {
+            char *endPtr;
+            errno = 0;
+            watchPeriod = strtoul(watchPeriodPtr, &endPtr, 10);
+
+            if (endPtr[0] != '\0' || errno != 0)
+            {
+                fprintf(stderr, "Bad watch period value: %s\n", watchPeriodPtr);
+                exit(EXIT_FAILURE);
+            }
+        }
+        exit(WatchNmea(watchPeriod));
+    }
     else
     {
         printf("Invalid command for GNSS service\n");
@@ -21,17 +21,11 @@
 #include "limit.h"
 #include "assetData.h"
 #include "le_print.h"
+#include "timeSeries.h"
 
 // For htonl
 #include <arpa/inet.h>
 
-#ifdef LEGATO_FEATURE_TIMESERIES
-
-#include "tinycbor/cbor.h"
-#include "zlib.h"
-
-#endif
-
 //--------------------------------------------------------------------------------------------------
 // Macros
 //--------------------------------------------------------------------------------------------------
@@ -60,30 +54,29 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Maximum number of bytes for CBOR encoded time series data
+ * Expected number of asset instances, for sizing the InstanceMap
  */
 //--------------------------------------------------------------------------------------------------
-#define MAX_CBOR_BUFFER_NUMBYTES 1024
+#define INSTANCE_MAP_CAPACITY 1024
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Checks the return value from the tinyCBOR encoder and returns from function if an error is found.
+ * The fields of an instance are indexed by id in a table if the largest field id is less than
+ * FIELD_TABLE_DENSITY times the number of fields, plus FIELD_TABLE_MIN_SIZE.  Instances with
+ * sparser ids are searched through their field list.
  */
 //--------------------------------------------------------------------------------------------------
-#ifdef LEGATO_FEATURE_TIMESERIES
+#define FIELD_TABLE_DENSITY  4
+#define FIELD_TABLE_MIN_SIZE 16
 
-#define \
-    RETURN_IF_CBOR_ERROR( err ) \
-    ({ \
-        if (err != CborNoError) \
-        { \
-            LE_ERROR("CBOR encoding error %s", cbor_error_string(err)); \
-            return LE_FAULT; \
-        } \
-    })
 
-#endif
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory of the time series payloads pushed while the AirVantage session is not available
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIME_SERIES_QUEUE_DIR "/data/avc/timeSeries"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -149,48 +142,20 @@ typedef struct le_avdata_AssetInstance
     AssetData_t* assetDataPtr;   ///< Back reference to asset data containing this instance
     le_dls_List_t fieldList;     ///< List of fields for this instance
     le_dls_Link_t link;          ///< For adding to the asset instance list
+    struct FieldData** fieldTablePtr;   ///< Fields indexed by field id, or NULL if ids too sparse
+    int fieldTableSize;                 ///< Number of entries in fieldTablePtr
+    struct FieldData** fieldsByNamePtr; ///< Fields sorted by name
+    int numFields;                      ///< Number of fields in fieldList
 }
 InstanceData_t;
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Data contained in time series
- */
-//--------------------------------------------------------------------------------------------------
-typedef struct
-{
-    uint8_t* bufferPtr;             ///< Buffer for accumulating history data.
-    size_t bufferSize;              ///< Buffer size of history data.
-
-#ifdef LEGATO_FEATURE_TIMESERIES
-    double timeStampFactor;         ///< Factor of time stamp.
-    uint64_t prevTimeStamp;         ///< Time stamp of last data capture, used for delta encoding.
-
-    double factor;                  ///< Factor of data.
-    union
-    {
-        int prevIntValue;           ///< Value of of last data capture - used for delta encoding.
-        double prevFloatValue;      ///< Value of last data capture - used for delta encoding.
-    };
-
-    uint32_t numElements;           ///< Number of elements in cbor encoded stream.
-
-    CborEncoder streamRef;          ///< CBOR encoded stream reference.
-    CborEncoder mapRef;             ///< CBOR encoded map reference.
-    CborEncoder sampleRef;          ///< CBOR encoded sample data reference.
-#endif
-}
-TimeSeriesData_t;
-
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Data contained in a single field of an asset instance
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct FieldData
 {
     int fieldId;
     char name[100];
@@ -208,7 +173,7 @@ typedef struct
         char* strValuePtr;
     };
 
-    TimeSeriesData_t* timeSeriesPtr;
+    timeSeries_Ref_t timeSeriesRef;
 
     le_dls_Link_t link;          ///< For adding to the field list
 }
@@ -325,26 +290,19 @@ static le_hashmap_Ref_t AssetMapByName = NULL;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Used to delay reporting REG_UPDATE, so that we don't generate too much message traffic.
- */
-//--------------------------------------------------------------------------------------------------
-static le_timer_Ref_t RegUpdateTimerRef;
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- * Time series data memory pool.  Initialized in assetData_Init().
+ * Maps (AssetData block, instanceId) to an instance.  The keys are the instances themselves.
+ * Initialized in assetData_Init().
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t TimeSeriesDataPoolRef = NULL;
+static le_hashmap_Ref_t InstanceMap = NULL;
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * CBOR buffer memory pool.  Initialized in assetData_Init().
+ * Used to delay reporting REG_UPDATE, so that we don't generate too much message traffic.
  */
 //--------------------------------------------------------------------------------------------------
-static le_mem_PoolRef_t CborBufferPoolRef = NULL;
+static le_timer_Ref_t RegUpdateTimerRef;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -560,7 +518,7 @@ static void InitDefaultFieldData
     fieldDataPtr->isObserve = false;
     fieldDataPtr->readCallBackOpRef = NULL;
 
-    fieldDataPtr->timeSeriesPtr = NULL;
+    fieldDataPtr->timeSeriesRef = NULL;
 
     switch ( fieldDataPtr->type )
     {
@@ -1105,6 +1063,154 @@ static le_result_t CreateAssetDataFromModelByName
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Hash an InstanceMap key, i.e. an instance of which only the asset and the instance id are used.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t HashInstanceKey
+(
+    const void* keyPtr
+)
+{
+    const InstanceData_t* instancePtr = keyPtr;
+
+    return ((size_t)instancePtr->assetDataPtr >> 4) * 31 + (size_t)instancePtr->instanceId;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare two InstanceMap keys.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool EqualsInstanceKey
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+{
+    const InstanceData_t* firstPtr = firstKeyPtr;
+    const InstanceData_t* secondPtr = secondKeyPtr;
+
+    return ( (firstPtr->assetDataPtr == secondPtr->assetDataPtr) &&
+             (firstPtr->instanceId == secondPtr->instanceId) );
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compare the names of two fields, for sorting and searching fieldsByNamePtr.
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareFieldNames
+(
+    const void* firstPtr,
+    const void* secondPtr
+)
+{
+    const FieldData_t* firstFieldPtr = *(FieldData_t* const*)firstPtr;
+    const FieldData_t* secondFieldPtr = *(FieldData_t* const*)secondPtr;
+
+    return strcmp(firstFieldPtr->name, secondFieldPtr->name);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the indexes of the fields of an instance, once its field list is complete.
+ */
+//--------------------------------------------------------------------------------------------------
+static void IndexFields
+(
+    InstanceData_t* instanceDataPtr
+)
+{
+    FieldData_t* fieldDataPtr;
+    le_dls_Link_t* linkPtr;
+    int maxFieldId = -1;
+    int i = 0;
+
+    instanceDataPtr->numFields = le_dls_NumLinks(&instanceDataPtr->fieldList);
+    instanceDataPtr->fieldTablePtr = NULL;
+    instanceDataPtr->fieldTableSize = 0;
+    instanceDataPtr->fieldsByNamePtr = NULL;
+
+    if ( instanceDataPtr->numFields == 0 )
+    {
+        return;
+    }
+
+    // The tables have as many entries as there are fields in the model, so they are allocated
+    // from the heap rather than from a pool.
+    instanceDataPtr->fieldsByNamePtr = calloc(instanceDataPtr->numFields, sizeof(FieldData_t*));
+    LE_ASSERT(instanceDataPtr->fieldsByNamePtr != NULL);
+
+    linkPtr = le_dls_Peek(&instanceDataPtr->fieldList);
+    while ( linkPtr != NULL )
+    {
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        instanceDataPtr->fieldsByNamePtr[i++] = fieldDataPtr;
+        if ( fieldDataPtr->fieldId > maxFieldId )
+        {
+            maxFieldId = fieldDataPtr->fieldId;
+        }
+
+        linkPtr = le_dls_PeekNext(&instanceDataPtr->fieldList, linkPtr);
+    }
+
+    qsort(instanceDataPtr->fieldsByNamePtr,
+          instanceDataPtr->numFields,
+          sizeof(FieldData_t*),
+          CompareFieldNames);
+
+    if ( maxFieldId < (FIELD_TABLE_DENSITY * instanceDataPtr->numFields + FIELD_TABLE_MIN_SIZE) )
+    {
+        instanceDataPtr->fieldTableSize = maxFieldId + 1;
+        instanceDataPtr->fieldTablePtr = calloc(instanceDataPtr->fieldTableSize,
+                                                sizeof(FieldData_t*));
+        LE_ASSERT(instanceDataPtr->fieldTablePtr != NULL);
+
+        for (i = 0; i < instanceDataPtr->numFields; i++)
+        {
+            fieldDataPtr = instanceDataPtr->fieldsByNamePtr[i];
+
+            if ( fieldDataPtr->fieldId >= 0 )
+            {
+                instanceDataPtr->fieldTablePtr[fieldDataPtr->fieldId] = fieldDataPtr;
+            }
+        }
+    }
+    else
+    {
+        LE_DEBUG("Field ids of %s/%i too sparse to be indexed",
+                 instanceDataPtr->assetDataPtr->appName,
+                 instanceDataPtr->assetDataPtr->assetId);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the indexes of the fields of an instance.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReleaseFieldIndex
+(
+    InstanceData_t* instanceDataPtr
+)
+{
+    free(instanceDataPtr->fieldTablePtr);
+    free(instanceDataPtr->fieldsByNamePtr);
+
+    instanceDataPtr->fieldTablePtr = NULL;
+    instanceDataPtr->fieldTableSize = 0;
+    instanceDataPtr->fieldsByNamePtr = NULL;
+    instanceDataPtr->numFields = 0;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Get the specified instance from the given asset data block
@@ -1121,28 +1227,21 @@ static le_result_t GetInstanceFromAssetData
     InstanceData_t** instanceDataPtrPtr   ///< [OUT]
 )
 {
+    InstanceData_t key;
     InstanceData_t* assetInstancePtr;
-    le_dls_Link_t* linkPtr;
 
-    // Get the start of the instance list
-    linkPtr = le_dls_Peek(&assetDataPtr->instanceList);
+    // Only the fields used by HashInstanceKey() and EqualsInstanceKey() need to be set.
+    key.assetDataPtr = assetDataPtr;
+    key.instanceId = instanceId;
 
-    // Loop through the asset instances
-    while ( linkPtr != NULL )
+    assetInstancePtr = le_hashmap_Get(InstanceMap, &key);
+    if ( assetInstancePtr == NULL )
     {
-        assetInstancePtr = CONTAINER_OF(linkPtr, InstanceData_t, link);
-        //LE_PRINT_VALUE("%i", assetInstancePtr->instanceId);
-
-        if ( assetInstancePtr->instanceId == instanceId )
-        {
-            *instanceDataPtrPtr = assetInstancePtr;
-            return LE_OK;
-        }
-
-        linkPtr = le_dls_PeekNext(&assetDataPtr->instanceList, linkPtr);
+        return LE_NOT_FOUND;
     }
 
-    return LE_NOT_FOUND;
+    *instanceDataPtrPtr = assetInstancePtr;
+    return LE_OK;
 }
 
 
@@ -1165,6 +1264,19 @@ static le_result_t GetFieldFromInstance
     FieldData_t* fieldDataPtr;
     le_dls_Link_t* fieldLinkPtr;
 
+    // Use the field table, if the instance has one.
+    if ( instanceDataPtr->fieldTablePtr != NULL )
+    {
+        if ( (fieldId < 0) || (fieldId >= instanceDataPtr->fieldTableSize) ||
+             (instanceDataPtr->fieldTablePtr[fieldId] == NULL) )
+        {
+            return LE_NOT_FOUND;
+        }
+
+        *fieldDataPtrPtr = instanceDataPtr->fieldTablePtr[fieldId];
+        return LE_OK;
+    }
+
     // Get the start of the field list
     fieldLinkPtr = le_dls_Peek(&instanceDataPtr->fieldList);
 
@@ -1309,11 +1421,7 @@ static le_result_t StartTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint8_t* timeSeriesBufferPtr;
     char headerId[64];
-    CborError err;
-    CborEncoder headerArray;
-    CborEncoder factorArray;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -1323,7 +1431,7 @@ static le_result_t StartTimeSeries
     }
 
     // Is time series enabled on this field.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         LE_ERROR("Time series already enabled on this field.");
         return LE_BUSY;
@@ -1335,80 +1443,7 @@ static le_result_t StartTimeSeries
                  instanceRef->instanceId,
                  fieldId);
 
-    fieldDataPtr->timeSeriesPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
-
-    memset(fieldDataPtr->timeSeriesPtr, 0, sizeof(TimeSeriesData_t));
-
-    timeSeriesBufferPtr = le_mem_ForceAlloc(CborBufferPoolRef);
-    fieldDataPtr->timeSeriesPtr->bufferPtr = timeSeriesBufferPtr;
-
-    fieldDataPtr->timeSeriesPtr->bufferSize = MAX_CBOR_BUFFER_NUMBYTES;
-
-    // Initialize CBOR stream.
-    cbor_encoder_init(&fieldDataPtr->timeSeriesPtr->streamRef,
-                      timeSeriesBufferPtr,
-                      MAX_CBOR_BUFFER_NUMBYTES,
-                      0);
-
-    err = cbor_encoder_create_map(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                  &fieldDataPtr->timeSeriesPtr->mapRef,
-                                  NUM_TIME_SERIES_MAPS);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Create a map and add the header in to the map.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "h");
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Create an array for the header.
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &headerArray,
-                                    1);
-    RETURN_IF_CBOR_ERROR(err);
-
-    err = cbor_encode_text_string(&headerArray, headerId, strlen(headerId));
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Close the heade map i.e done with entering in to header array.
-    // e.g. "h" : [/1000/0]  --> map for header.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &headerArray);
-
-    // Create a map for factor.
-    // e.g. "f" : [1]  --> map for factor.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "f");
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Create an array of factors (time stamp factor, data factor)
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &factorArray,
-                                    2);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Add factor for time stamp.
-    err = cbor_encode_double(&factorArray, timeStampFactor);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Add factor for sample.
-    err = cbor_encode_double(&factorArray, factor);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Close the map i.e done with entering in to factor array.
-    cbor_encoder_close_container(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                 &factorArray);
-
-    // Create an array for samples. The sample array will have time stamp and data pair.
-    err = cbor_encode_text_stringz(&fieldDataPtr->timeSeriesPtr->mapRef, "s");
-    RETURN_IF_CBOR_ERROR(err);
-
-    err = cbor_encoder_create_array(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                    &fieldDataPtr->timeSeriesPtr->sampleRef,
-                                    CborIndefiniteLength);
-    RETURN_IF_CBOR_ERROR(err);
-
-    fieldDataPtr->timeSeriesPtr->factor = factor;
-    fieldDataPtr->timeSeriesPtr->timeStampFactor = timeStampFactor;
-
-    return result;
+    return timeSeries_Create(headerId, factor, timeStampFactor, &fieldDataPtr->timeSeriesRef);
 
 #else
     LE_ERROR("Time series not supported.");
@@ -1444,16 +1479,15 @@ static le_result_t StopTimeSeries
         return result;
     }
 
-    if (fieldDataPtr->timeSeriesPtr == NULL)
+    if (fieldDataPtr->timeSeriesRef == NULL)
     {
         LE_ERROR("Time series not enabled on this field.");
         return LE_CLOSED;
     }
 
-    le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-    le_mem_Release(fieldDataPtr->timeSeriesPtr);
+    timeSeries_Delete(fieldDataPtr->timeSeriesRef);
 
-    fieldDataPtr->timeSeriesPtr = NULL;
+    fieldDataPtr->timeSeriesRef = NULL;
 
     return LE_OK;
 
@@ -1464,9 +1498,95 @@ static le_result_t StopTimeSeries
 }
 
 
+#ifdef LEGATO_FEATURE_TIMESERIES
 //--------------------------------------------------------------------------------------------------
 /**
- * Compress the accumulated CBOR encoded time series data and send it to server.
+ * Send compressed time series data to the server, as a notification of the observed field, using
+ * the token of the field's current observe request.
+ *
+ * @return:
+ *      - LE_OK if the notification was handed to the PA
+ *      - LE_UNAVAILABLE if the session is not available
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t NotifyTimeSeries
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance of the field.
+    FieldData_t* fieldDataPtr,                  ///< [IN] Observed field.
+    uint8_t* payloadPtr,                        ///< [IN] Compressed payload.
+    size_t payloadNumBytes                      ///< [IN] Payload size in bytes.
+)
+{
+    pa_avc_LWM2MOperationDataRef_t opRef;
+
+    if (CurrentAvSessionStatus != ASSET_DATA_SESSION_AVAILABLE)
+    {
+        return LE_UNAVAILABLE;
+    }
+
+    opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
+                                instanceRef->assetDataPtr->assetId,
+                                -1,
+                                -1,
+                                PA_AVC_OPTYPE_NOTIFY,
+                                SIERRA_CBOR_ENCODING,
+                                fieldDataPtr->token,
+                                fieldDataPtr->tokenLength);
+    if (opRef == NULL)
+    {
+        LE_ERROR("Unable to create the notify operation.");
+        return LE_FAULT;
+    }
+
+    pa_avc_NotifyChange(opRef, payloadPtr, payloadNumBytes);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send time series data queued while the session was not available.  Called by
+ * timeSeries_SendQueued() for each queued payload.
+ *
+ * @return:
+ *      - LE_OK if the notification was handed to the PA
+ *      - LE_NOT_FOUND if the field is gone or no longer observed
+ *      - LE_UNAVAILABLE if the session is not available
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendQueuedTimeSeries
+(
+    char* appNamePtr,               ///< [IN] App name of the asset.
+    int assetId,                    ///< [IN] Asset id.
+    int instanceId,                 ///< [IN] Instance id.
+    int fieldId,                    ///< [IN] Field id.
+    uint8_t* payloadPtr,            ///< [IN] Compressed payload.
+    size_t payloadNumBytes          ///< [IN] Payload size in bytes.
+)
+{
+    assetData_InstanceDataRef_t instanceRef;
+    FieldData_t* fieldDataPtr;
+
+    if ( (GetInstance(appNamePtr, assetId, instanceId, &instanceRef) != LE_OK) ||
+         (GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr) != LE_OK) ||
+         !fieldDataPtr->isObserve )
+    {
+        return LE_NOT_FOUND;
+    }
+
+    return NotifyTimeSeries(instanceRef, fieldDataPtr, payloadPtr, payloadNumBytes);
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the compressed time series data to server.  If it can't be sent now, for instance because
+ * the AirVantage session is not available, the data is queued in flash and sent as soon as the
+ * session is available.
  *
  * @return:
  *      - LE_OK on success
@@ -1488,15 +1608,8 @@ static le_result_t PushTimeSeries
 
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    uint32_t cborStreamSize;
-    unsigned char compressedBuf[MAX_CBOR_BUFFER_NUMBYTES];
-    unsigned long int compressBufLength;
-    z_stream defstream;
-    pa_avc_LWM2MOperationDataRef_t opRef;
-    CborError err;
-
-    double dataFactor;
-    double timeStampFactor;
+    uint8_t* payloadPtr;
+    size_t payloadNumBytes;
 
     result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
     if ( result != LE_OK )
@@ -1504,7 +1617,7 @@ static le_result_t PushTimeSeries
         return result;
     }
 
-    if (fieldDataPtr->timeSeriesPtr == NULL)
+    if (fieldDataPtr->timeSeriesRef == NULL)
     {
         // Time series not enabled on this field.
         LE_ERROR("Time series not enabled on this field.");
@@ -1518,70 +1631,41 @@ static le_result_t PushTimeSeries
         return LE_UNAVAILABLE;
     }
 
-    // Remember the factors used.
-    dataFactor = fieldDataPtr->timeSeriesPtr->factor;
-    timeStampFactor = fieldDataPtr->timeSeriesPtr->timeStampFactor;
-
-    // Close the map i.e done with entering in to sample array.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                               &fieldDataPtr->timeSeriesPtr->sampleRef);
-
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Close the stream.
-    err = cbor_encoder_close_container_checked(&fieldDataPtr->timeSeriesPtr->streamRef,
-                                               &fieldDataPtr->timeSeriesPtr->mapRef);
-    RETURN_IF_CBOR_ERROR(err);
-
-    // Dump CBOR encoded data.
-    cborStreamSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->mapRef,
-                                                  fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-    //LE_DEBUG("cborStreamSize = %d", cborStreamSize);
-    //LE_DUMP(fieldDataPtr->timeSeriesPtr->bufferPtr, cborStreamSize);
-
-    // Compress the cbor encoded data
-    // ToDo: In place compression
-    defstream.zalloc = Z_NULL;
-    defstream.zfree = Z_NULL;
-    defstream.opaque = Z_NULL;
-
-    defstream.avail_in = cborStreamSize;
-    defstream.next_in = (Bytef *)fieldDataPtr->timeSeriesPtr->bufferPtr;
-    defstream.avail_out = (uInt)sizeof(compressedBuf);
-    defstream.next_out = (Bytef *)compressedBuf;
-
-    deflateInit(&defstream, Z_BEST_COMPRESSION);
-    deflate(&defstream, Z_FINISH);
-    deflateEnd(&defstream);
-
-    compressBufLength = defstream.total_out;
+    // The samples have been delta encoded, CBOR encoded and compressed as they were added, so
+    // closing the stream is all that is left to do.
+    result = timeSeries_Finish(fieldDataPtr->timeSeriesRef, &payloadPtr, &payloadNumBytes);
+    if (result != LE_OK)
+    {
+        return result;
+    }
 
-    //LE_DEBUG("Compressed size is: %lu\n", compressBufLength);
-    //LE_DUMP(compressedBuf, compressBufLength);
+    LE_DEBUG("%u samples compressed to %zd bytes.",
+             timeSeries_GetSampleCount(fieldDataPtr->timeSeriesRef),
+             payloadNumBytes);
 
-    // Send the delta encoded + CBOR encoded + Zipped data to the server.
-    opRef = pa_avc_CreateOpData(instanceRef->assetDataPtr->appName,
-                                instanceRef->assetDataPtr->assetId,
-                                -1,
-                                -1,
-                                PA_AVC_OPTYPE_NOTIFY,
-                                SIERRA_CBOR_ENCODING,
-                                fieldDataPtr->token,
-                                fieldDataPtr->tokenLength);
-
-    pa_avc_NotifyChange(opRef, compressedBuf, compressBufLength);
+    if (NotifyTimeSeries(instanceRef, fieldDataPtr, payloadPtr, payloadNumBytes) != LE_OK)
+    {
+        LE_DEBUG("Unable to send now; queuing time series data.");
 
-    // Stop time series.
-    result = StopTimeSeries(instanceRef, fieldId);
+        result = timeSeries_QueuePayload(instanceRef->assetDataPtr->appName,
+                                         instanceRef->assetDataPtr->assetId,
+                                         instanceRef->instanceId,
+                                         fieldId,
+                                         payloadPtr,
+                                         payloadNumBytes);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
 
-    // Restart time series if asked.
-    if (result == LE_OK && isRestartTimeSeries)
+    // Restart time series if asked, with the same header and factors.
+    if (isRestartTimeSeries)
     {
-        result = StartTimeSeries(instanceRef, fieldId, dataFactor, timeStampFactor);
+        return timeSeries_Restart(fieldDataPtr->timeSeriesRef);
     }
 
-    return result;
+    return StopTimeSeries(instanceRef, fieldId);
 
 #else
     LE_ERROR("Time series not supported.");
@@ -1619,7 +1703,7 @@ le_result_t GetTimeSeriesStatus
         return result;
     }
 
-    if (fieldDataPtr->timeSeriesPtr == NULL)
+    if (fieldDataPtr->timeSeriesRef == NULL)
     {
         // Time series not enabled on this field.
         LE_DEBUG("Time series not enabled on this field.");
@@ -1630,7 +1714,7 @@ le_result_t GetTimeSeriesStatus
     else
     {
         *isTimeSeriesPtr = true;
-        *numDataPointsPtr = fieldDataPtr->timeSeriesPtr->numElements;
+        *numDataPointsPtr = timeSeries_GetSampleCount(fieldDataPtr->timeSeriesRef);
     }
 
     return LE_OK;
@@ -1644,7 +1728,7 @@ le_result_t GetTimeSeriesStatus
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the sampled data in to the CBOR sample array.
+ * Add the sampled data in to the time series.
  *
  * @return:
  *      - LE_OK on success
@@ -1662,133 +1746,45 @@ static le_result_t TimeSeriesAddEntry
 
 #ifdef LEGATO_FEATURE_TIMESERIES
 
-    CborError err;
-    uint64_t timeStamp;
-    int intDelta;
-    double floatDelta;
-    size_t currentSize;
-    struct timeval tv;
-
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
-
-
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
-    {
-        LE_WARN("Time series buffer overflow on field %d.", fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
-
-        return LE_OVERFLOW;
-    }
-
-    // Get current system time if utc milli seconds is not provided.
-    // The time stamp is expected in UTC milli seconds by the server.
-    if (utcMilliSec == 0)
-    {
-        gettimeofday(&tv, NULL);
-        utcMilliSec = (uint64_t)(tv.tv_sec) * 1000 + (uint64_t)(tv.tv_usec) / 1000;
-    }
-
-    // For the first entry write the absolute value, for all other entries calculate delta.
-    if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-    {
-        timeStamp = utcMilliSec * fieldDataPtr->timeSeriesPtr->timeStampFactor;
-    }
-    else
-    {
-        timeStamp = (utcMilliSec - fieldDataPtr->timeSeriesPtr->prevTimeStamp) *
-                    fieldDataPtr->timeSeriesPtr->timeStampFactor;
-    }
-
-    // Add time stamp to sample array.
-    err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, timeStamp);
-    RETURN_IF_CBOR_ERROR(err);
-
-    fieldDataPtr->timeSeriesPtr->prevTimeStamp = utcMilliSec;
-
-    // Add the data to sample array.
-    switch ( fieldDataPtr->type )
-    {
-        case DATA_TYPE_INT:
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-            {
-                intDelta = fieldDataPtr->intValue * fieldDataPtr->timeSeriesPtr->factor;
-            }
-            else
-            {
-                intDelta = (fieldDataPtr->intValue - fieldDataPtr->timeSeriesPtr->prevIntValue) *
-                            fieldDataPtr->timeSeriesPtr->factor;
-            }
-
-            //LE_DEBUG("intDelta = %d", intDelta);
-
-            err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, intDelta);
-
-            fieldDataPtr->timeSeriesPtr->prevIntValue = fieldDataPtr->intValue;
-            break;
-
-        case DATA_TYPE_BOOL:
-            err = cbor_encode_boolean(&fieldDataPtr->timeSeriesPtr->sampleRef, fieldDataPtr->boolValue);
-            break;
-
-        case DATA_TYPE_STRING:
-            err = cbor_encode_text_string(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                          fieldDataPtr->strValuePtr,
-                                          strlen(fieldDataPtr->strValuePtr));
-            break;
-
-        case DATA_TYPE_FLOAT:
-            // ToDO: float doesn't benefit from use of factor - investigate.
-            if (fieldDataPtr->timeSeriesPtr->numElements == 0)
-            {
-                floatDelta = fieldDataPtr->floatValue * fieldDataPtr->timeSeriesPtr->factor;
-            }
-            else
-            {
-                floatDelta = (fieldDataPtr->floatValue - fieldDataPtr->timeSeriesPtr->prevFloatValue);
-                floatDelta = floatDelta * fieldDataPtr->timeSeriesPtr->factor;
-            }
-
-            if ((uint64_t)fieldDataPtr->timeSeriesPtr->factor == 1)
-            {
-                err = cbor_encode_double(&fieldDataPtr->timeSeriesPtr->sampleRef, floatDelta);
-            }
-            else
-            {
-                LE_DEBUG("Float data encoded as integer.");
-                err = cbor_encode_int(&fieldDataPtr->timeSeriesPtr->sampleRef, (int64_t)floatDelta);
-            }
+    le_result_t result = LE_FAULT;
 
-            fieldDataPtr->timeSeriesPtr->prevFloatValue = fieldDataPtr->floatValue;
+    switch ( fieldDataPtr->type )
+    {
+        case DATA_TYPE_INT:
+            result = timeSeries_AddInt(fieldDataPtr->timeSeriesRef,
+                                       utcMilliSec,
+                                       fieldDataPtr->intValue);
             break;
 
-        case DATA_TYPE_NONE:
-            LE_ERROR("Failed to add an entry in CBOR stream.");
+        case DATA_TYPE_BOOL:
+            result = timeSeries_AddBool(fieldDataPtr->timeSeriesRef,
+                                        utcMilliSec,
+                                        fieldDataPtr->boolValue);
             break;
-    }
 
-    RETURN_IF_CBOR_ERROR(err);
-
-    fieldDataPtr->timeSeriesPtr->numElements++;
+        case DATA_TYPE_STRING:
+            result = timeSeries_AddString(fieldDataPtr->timeSeriesRef,
+                                          utcMilliSec,
+                                          fieldDataPtr->strValuePtr);
+            break;
 
+        case DATA_TYPE_FLOAT:
+            result = timeSeries_AddFloat(fieldDataPtr->timeSeriesRef,
+                                         utcMilliSec,
+                                         fieldDataPtr->floatValue);
+            break;
 
-    // Reserve CBOR_RESERVED_BYTES bytes for closing the container.
-    // The stream has to be flushed it starts getting in to the reserved area.
-    currentSize = cbor_encoder_get_buffer_size(&fieldDataPtr->timeSeriesPtr->sampleRef,
-                                               fieldDataPtr->timeSeriesPtr->bufferPtr);
+        case DATA_TYPE_NONE:
+            LE_ERROR("Failed to add an entry in time series.");
+            break;
+    }
 
-    if (currentSize > (fieldDataPtr->timeSeriesPtr->bufferSize - CBOR_RESERVED_BYTES))
+    if ((result == LE_OVERFLOW) || (result == LE_NO_MEMORY))
     {
-        LE_WARN("Time series buffer full; flush and restart time series on field %d.",
-                 fieldDataPtr->fieldId);
-        LE_DEBUG("currentSize = %zd.", currentSize);
-
-        return LE_NO_MEMORY;
+        LE_WARN("Time series buffer full on field %d.", fieldDataPtr->fieldId);
     }
 
-    return LE_OK;
+    return result;
 
 #else
     LE_ERROR("Time series not supported.");
@@ -2198,7 +2194,7 @@ static le_result_t SetInt
 
     // If time series is enabled add the data to time series history and get out. If time series is
     // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
     }
@@ -2312,7 +2308,7 @@ static le_result_t SetFloat
 
     // If time series is enabled add the data to time series history and get out. If time series is
     // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
     }
@@ -2467,7 +2463,7 @@ static le_result_t SetBool
 
     // If time series is enabled add the data to time series history and get out. If time series is
     // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
     }
@@ -2625,7 +2621,7 @@ static le_result_t SetString
 
     // If time series is enabled add the data to time series history and get out. If time series is
     // not enabled send the observe notification right away.
-    if (fieldDataPtr->timeSeriesPtr != NULL)
+    if (fieldDataPtr->timeSeriesRef != NULL)
     {
         return TimeSeriesAddEntry(fieldDataPtr, utcMilliSec);
     }
@@ -2871,6 +2867,14 @@ void assetData_SessionStatus
     {
         le_timer_Restart(RegUpdateTimerRef);
     }
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+    // Send the time series data pushed while the session was not available.
+    if (CurrentAvSessionStatus == ASSET_DATA_SESSION_AVAILABLE)
+    {
+        timeSeries_SendQueued(SendQueuedTimeSeries);
+    }
+#endif
 }
 
 
@@ -3063,6 +3067,9 @@ le_result_t assetData_CreateInstanceById
     // Add back reference from instance data to the asset containing the instance
     assetInstPtr->assetDataPtr = assetDataPtr;
 
+    // Index the fields, and the instance itself.
+    IndexFields(assetInstPtr);
+    le_hashmap_Put(InstanceMap, assetInstPtr, assetInstPtr);
 
     le_dls_Queue(&assetDataPtr->instanceList, &assetInstPtr->link);
 
@@ -3167,6 +3174,10 @@ void assetData_DeleteInstance
     FieldData_t* fieldDataPtr;
     le_dls_Link_t* linkPtr;
 
+    // Remove the instance and field indexes first, as the fields are going away.
+    le_hashmap_Remove(InstanceMap, instanceRef);
+    ReleaseFieldIndex(instanceRef);
+
     // Pop the first field from field list
     linkPtr = le_dls_Pop(&instanceRef->fieldList);
 
@@ -3188,11 +3199,12 @@ void assetData_DeleteInstance
         }
 
         // Release Time Series resources.
-        if (fieldDataPtr->timeSeriesPtr != NULL)
+        if (fieldDataPtr->timeSeriesRef != NULL)
         {
             LE_DEBUG("Releasing time series resources of %s", fieldDataPtr->name);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr->bufferPtr);
-            le_mem_Release(fieldDataPtr->timeSeriesPtr);
+#ifdef LEGATO_FEATURE_TIMESERIES
+            timeSeries_Delete(fieldDataPtr->timeSeriesRef);
+#endif
         }
 
         // Release the field.
@@ -3550,43 +3562,34 @@ le_result_t assetData_GetFieldIdFromName
     int* fieldIdPtr                             ///< [OUT] The field id
 )
 {
-    /*
-     * NOTE:
-     *   The main use for this function is to get the fieldId that is then passed to the various
-     *   assetData_client_Get* functions.  This is not particularly efficient as it requires
-     *   iterating twice through the field list.  One alternative would be to add a new set of
-     *   assetData_client_Get* functions that take a field name instead of field id.
-     *
-     *   For now, assume that the performance is good enough, but if it becomes an issue then
-     *   this second set of functions may need to be added.  Of course, there might also be some
-     *   other alternative solution that has not yet been considered.
-     */
-
-    FieldData_t* fieldDataPtr;
-    le_dls_Link_t* fieldLinkPtr;
+    FieldData_t key;
+    FieldData_t* keyPtr = &key;
+    FieldData_t** fieldDataPtrPtr;
 
-    // Get the start of the field list
-    fieldLinkPtr = le_dls_Peek(&instanceRef->fieldList);
-
-    //LE_PRINT_VALUE("%s", instanceRef->assetDataPtr->appName);
-    //LE_PRINT_VALUE("%s", instanceRef->assetDataPtr->assetName);
-
-    // Loop through the fields
-    while ( fieldLinkPtr != NULL )
+    // The main use for this function is to get the fieldId that is then passed to the various
+    // assetData_client_Get* functions, so the fields are searched by name in a sorted table.
+    if ( le_utf8_Copy(key.name, fieldNamePtr, sizeof(key.name), NULL) != LE_OK )
     {
-        fieldDataPtr = CONTAINER_OF(fieldLinkPtr, FieldData_t, link);
-        //LE_PRINT_VALUE("%s", fieldDataPtr->name);
+        return LE_FAULT;
+    }
 
-        if ( strcmp(fieldDataPtr->name, fieldNamePtr) == 0 )
-        {
-            *fieldIdPtr = fieldDataPtr->fieldId;
-            return LE_OK;
-        }
+    if ( instanceRef->numFields == 0 )
+    {
+        return LE_FAULT;
+    }
 
-        fieldLinkPtr = le_dls_PeekNext(&instanceRef->fieldList, fieldLinkPtr);
+    fieldDataPtrPtr = bsearch(&keyPtr,
+                              instanceRef->fieldsByNamePtr,
+                              instanceRef->numFields,
+                              sizeof(FieldData_t*),
+                              CompareFieldNames);
+    if ( fieldDataPtrPtr == NULL )
+    {
+        return LE_FAULT;
     }
 
-    return LE_FAULT;
+    *fieldIdPtr = (*fieldDataPtrPtr)->fieldId;
+    return LE_OK;
 }
 
 
@@ -4528,9 +4531,10 @@ le_result_t assetData_Init
     ActionHandlerDataPoolRef = le_mem_CreatePool("Action handler data pool",
                                                  sizeof(ActionHandlerData_t));
 
-    // Memory pool for time series data.
-    TimeSeriesDataPoolRef = le_mem_CreatePool("TimeSeries data pool", sizeof(TimeSeriesData_t));
-    CborBufferPoolRef = le_mem_CreatePool("CBOR buffer pool", MAX_CBOR_BUFFER_NUMBYTES);
+#ifdef LEGATO_FEATURE_TIMESERIES
+    // Time series, and the payloads left queued by a previous run.
+    timeSeries_Init(TIME_SERIES_QUEUE_DIR);
+#endif
 
     StringValuePoolRef = le_mem_CreatePool("String value pool", STRING_VALUE_NUMBYTES);
     AddressStringPoolRef = le_mem_CreatePool("Address pool", 100);
@@ -4544,6 +4548,12 @@ le_result_t assetData_Init
                                        le_hashmap_HashString,
                                        le_hashmap_EqualsString);
 
+    // Create InstanceMap that maps (AssetData block, instanceId) to an instance.
+    InstanceMap = le_hashmap_Create("Instance Map",
+                                    INSTANCE_MAP_CAPACITY,
+                                    HashInstanceKey,
+                                    EqualsInstanceKey);
+
 
     // Use a timer to delay reporting instance creation events to the modem for 15 seconds after
     // the last creation event. This allows us to aggregate multiple registration updates together.
@@ -4748,7 +4758,101 @@ static le_result_t WriteTLVHeader
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write a LWM2M Resource TLV to the given buffer.
+ * Get the size of a LWM2M TLV header, which is one byte for the type, plus the id, plus the length
+ * field if the value is too long for its length to be encoded in the type byte.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetTLVHeaderNumBytes
+(
+    int id,                             ///< [IN] Object instance or resource id
+    size_t valueNumBytes                ///< [IN] # bytes for TLV value
+)
+{
+    size_t numBytes = ( id > 255 ) ? 3 : 2;
+
+    if ( valueNumBytes >= 8 )
+        numBytes++;
+    if ( valueNumBytes >= (1<<8) )
+        numBytes++;
+    if ( valueNumBytes >= (1<<16) )
+        numBytes++;
+
+    return numBytes;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes of the TLV value of a field.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if the field has no data
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetFieldValueNumBytes
+(
+    FieldData_t* fieldDataPtr,          ///< [IN] The field
+    size_t* valueNumBytesPtr            ///< [OUT] # bytes for TLV value
+)
+{
+    switch ( fieldDataPtr->type )
+    {
+        case DATA_TYPE_INT:
+            *valueNumBytesPtr = 4;
+            return LE_OK;
+
+        case DATA_TYPE_BOOL:
+            *valueNumBytesPtr = 1;
+            return LE_OK;
+
+        case DATA_TYPE_STRING:
+            *valueNumBytesPtr = strlen(fieldDataPtr->strValuePtr);
+            return LE_OK;
+
+        case DATA_TYPE_FLOAT:
+            *valueNumBytesPtr = 8;
+            return LE_OK;
+
+        case DATA_TYPE_NONE:
+            break;
+    }
+
+    LE_ERROR("No data to read");
+    return LE_FAULT;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes of the LWM2M Resource TLV of a field.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT if the field has no data
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetFieldTLVNumBytes
+(
+    FieldData_t* fieldDataPtr,          ///< [IN] The field
+    size_t* numBytesPtr                 ///< [OUT] # bytes for the TLV
+)
+{
+    size_t valueNumBytes;
+
+    if ( GetFieldValueNumBytes(fieldDataPtr, &valueNumBytes) != LE_OK )
+    {
+        return LE_FAULT;
+    }
+
+    *numBytesPtr = GetTLVHeaderNumBytes(fieldDataPtr->fieldId, valueNumBytes) + valueNumBytes;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a LWM2M Resource TLV to the given buffer.  The TLV is written in place, without staging.
  *
  * @return:
  *      - LE_OK on success
@@ -4765,103 +4869,106 @@ static le_result_t WriteFieldTLV
     size_t* numBytesWrittenPtr              ///< [OUT] # bytes written to buffer.
 )
 {
-    le_result_t result = LE_OK;
-    size_t numBytesWritten = 0;
-    int strLength;
+    size_t valueNumBytes;
+    size_t numBytesWritten;
+
+    *numBytesWrittenPtr = 0;
+
+    if ( GetFieldValueNumBytes(fieldDataPtr, &valueNumBytes) != LE_OK )
+    {
+        return LE_FAULT;
+    }
 
-    // Provide enough space for max field size, which is 256 bytes for a string, plus max header
-    // size, which is 6 bytes.  Thus will ensure overflow doesn't happen when putting data in
-    // tmpBuffer.  Overflow will be checked when trying to copy to the output buffer in bufPtr.
-    uint8_t tmpBuffer[256+6];
-    uint8_t* tmpBufferPtr = tmpBuffer;
+    // Check that the whole TLV fits before writing anything.
+    if ( (GetTLVHeaderNumBytes(fieldDataPtr->fieldId, valueNumBytes) + valueNumBytes)
+         > bufNumBytes )
+    {
+        LE_WARN("Overflow: oiid=%i, rid=%i", instRef->instanceId, fieldDataPtr->fieldId);
+        return LE_OVERFLOW;
+    }
+
+    if ( WriteTLVHeader(TLV_TYPE_RESOURCE,
+                        fieldDataPtr->fieldId,
+                        valueNumBytes,
+                        bufPtr,
+                        bufNumBytes,
+                        &numBytesWritten) != LE_OK )
+    {
+        return LE_FAULT;
+    }
+    bufPtr += numBytesWritten;
 
     switch ( fieldDataPtr->type )
     {
         case DATA_TYPE_INT:
-            WriteTLVHeader(TLV_TYPE_RESOURCE,
-                           fieldDataPtr->fieldId,
-                           4,
-                           tmpBufferPtr,
-                           sizeof(tmpBuffer),
-                           &numBytesWritten);
-            tmpBufferPtr += numBytesWritten;
-            WriteUint(tmpBufferPtr, fieldDataPtr->intValue, 4);
-
-            numBytesWritten += 4;
+            WriteUint(bufPtr, fieldDataPtr->intValue, 4);
             break;
 
         case DATA_TYPE_BOOL:
-            WriteTLVHeader(TLV_TYPE_RESOURCE,
-                           fieldDataPtr->fieldId,
-                           1,
-                           tmpBufferPtr,
-                           sizeof(tmpBuffer),
-                           &numBytesWritten);
-            tmpBufferPtr += numBytesWritten;
-            WriteUint(tmpBufferPtr, fieldDataPtr->boolValue, 1);
-
-            numBytesWritten += 1;
+            WriteUint(bufPtr, fieldDataPtr->boolValue, 1);
             break;
 
         case DATA_TYPE_STRING:
-            strLength = strlen(fieldDataPtr->strValuePtr);
-
-            WriteTLVHeader(TLV_TYPE_RESOURCE,
-                           fieldDataPtr->fieldId,
-                           strLength,
-                           tmpBufferPtr,
-                           sizeof(tmpBuffer),
-                           &numBytesWritten);
-
-            tmpBufferPtr += numBytesWritten;
-
-            result = le_utf8_Copy((char*)tmpBufferPtr,
-                                  fieldDataPtr->strValuePtr,
-                                  sizeof(tmpBuffer)-numBytesWritten,
-                                  NULL);
-
-            // Assumes no overflow; that will be checked below
-            numBytesWritten += strLength;
+            // The TLV value is not NUL-terminated.
+            memcpy(bufPtr, fieldDataPtr->strValuePtr, valueNumBytes);
             break;
 
         case DATA_TYPE_FLOAT:
-            WriteTLVHeader(TLV_TYPE_RESOURCE,
-                           fieldDataPtr->fieldId,
-                           8,
-                           tmpBufferPtr,
-                           sizeof(tmpBuffer),
-                           &numBytesWritten);
-            tmpBufferPtr += numBytesWritten;
-
-            WriteDouble(tmpBufferPtr, fieldDataPtr->floatValue);
-
-            numBytesWritten += 8;
+            WriteDouble(bufPtr, fieldDataPtr->floatValue);
             break;
 
         case DATA_TYPE_NONE:
-            LE_ERROR("No data to read");
-            result = LE_FAULT;
-            *numBytesWrittenPtr = 0;
             break;
     }
 
-    // Successfully got the data, so copy to output buffer, if there is room.
-    if ( result == LE_OK )
+    *numBytesWrittenPtr = numBytesWritten + valueNumBytes;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes of the list of readable LWM2M Resource TLVs of an instance, as written
+ * by assetData_WriteFieldListToTLV().
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_GetFieldListTLVSize
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    size_t* numBytesPtr                         ///< [OUT] # bytes of the TLV list
+)
+{
+    le_dls_Link_t* linkPtr;
+    FieldData_t* fieldDataPtr;
+    size_t fieldNumBytes;
+    size_t numBytes = 0;
+
+    linkPtr = le_dls_Peek(&instanceRef->fieldList);
+
+    while ( linkPtr != NULL )
     {
-        if ( numBytesWritten <= bufNumBytes )
-        {
-            memcpy(bufPtr, tmpBuffer, numBytesWritten);
-            *numBytesWrittenPtr = numBytesWritten;
-        }
-        else
+        fieldDataPtr = CONTAINER_OF(linkPtr, FieldData_t, link);
+
+        // Same selection as assetData_WriteFieldListToTLV().
+        if ( fieldDataPtr->access & ACCESS_WRITE )
         {
-            LE_WARN("Overflow: oiid=%i, rid=%i", instRef->instanceId, fieldDataPtr->fieldId);
-            *numBytesWrittenPtr = 0;
-            result = LE_OVERFLOW;
+            if ( GetFieldTLVNumBytes(fieldDataPtr, &fieldNumBytes) != LE_OK )
+            {
+                return LE_FAULT;
+            }
+
+            numBytes += fieldNumBytes;
         }
+
+        linkPtr = le_dls_PeekNext(&instanceRef->fieldList, linkPtr);
     }
 
-    return result;
+    *numBytesPtr = numBytes;
+    return LE_OK;
 }
 
 
@@ -4928,7 +5035,44 @@ le_result_t assetData_WriteFieldListToTLV
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write a LWM2M Object Instance TLV to the given buffer.
+ * Get the number of bytes of the value of a LWM2M Object Instance TLV, i.e. of the Resource TLVs
+ * it contains.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the field does not exist
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetInstanceValueNumBytes
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    int fieldId,                                ///< [IN] Field to write, or -1 for all fields
+    FieldData_t** fieldDataPtrPtr,              ///< [OUT] The field, if fieldId is not -1
+    size_t* valueNumBytesPtr                    ///< [OUT] # bytes of the TLV value
+)
+{
+    le_result_t result;
+
+    // Either all the allowable TLVs, or just the one specified.
+    if ( fieldId == -1 )
+    {
+        *fieldDataPtrPtr = NULL;
+        return assetData_GetFieldListTLVSize(instanceRef, valueNumBytesPtr);
+    }
+
+    result = GetFieldFromInstance(instanceRef, fieldId, fieldDataPtrPtr);
+    if ( result != LE_OK )
+        return result;
+
+    return GetFieldTLVNumBytes(*fieldDataPtrPtr, valueNumBytesPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a LWM2M Object Instance TLV to the given buffer.  The size of the Resource TLVs is
+ * computed first, so that the instance header and then the Resource TLVs are written in place.
  *
  * @return:
  *      - LE_OK on success
@@ -4947,64 +5091,101 @@ static le_result_t WriteInstanceToTLV
 {
     le_result_t result;
     FieldData_t* fieldDataPtr;
-    size_t totalNumBytesWritten;
+    size_t valueNumBytes;
+    size_t headerNumBytes;
     size_t numBytesWritten;
-    uint8_t tmpBuffer[256-6];  // leave enough space for maximum header size of 6 bytes
 
-    // Need to write the field TLVs first, to know how many bytes will be in the instance TLV.
-    // Either read all the allowable TLVs, or just the one specified.
-    if ( fieldId == -1 )
+    *numBytesWrittenPtr = 0;
+
+    result = GetInstanceValueNumBytes(instanceRef, fieldId, &fieldDataPtr, &valueNumBytes);
+    if ( result != LE_OK )
+        return result;
+
+    // Ensure that the header and all the TLV data will fit.
+    headerNumBytes = GetTLVHeaderNumBytes(instanceRef->instanceId, valueNumBytes);
+    if ( headerNumBytes + valueNumBytes > bufNumBytes )
+    {
+        LE_WARN("Overflow: oiid=%i, rid=%i", instanceRef->instanceId, fieldId);
+        return LE_OVERFLOW;
+    }
+
+    result = WriteTLVHeader(TLV_TYPE_OBJ_INST,
+                            instanceRef->instanceId,
+                            valueNumBytes,
+                            bufPtr,
+                            bufNumBytes,
+                            &headerNumBytes);
+    if ( result != LE_OK )
+        return result;
+
+    bufPtr += headerNumBytes;
+    bufNumBytes -= headerNumBytes;
+
+    if ( fieldDataPtr == NULL )
     {
-        // Read all fields that are allowed and write to the TLV.
         result = assetData_WriteFieldListToTLV(instanceRef,
-                                               tmpBuffer,
-                                               sizeof(tmpBuffer),
-                                               &totalNumBytesWritten);
-        if ( result != LE_OK )
-        {
-            return result;
-        }
+                                               bufPtr,
+                                               bufNumBytes,
+                                               &numBytesWritten);
     }
     else
     {
-        result = GetFieldFromInstance(instanceRef, fieldId, &fieldDataPtr);
-        if ( result != LE_OK )
-            return result;
-
-        WriteFieldTLV(instanceRef,
-                      fieldDataPtr,
-                      tmpBuffer,
-                      sizeof(tmpBuffer),
-                      &totalNumBytesWritten);
+        result = WriteFieldTLV(instanceRef,
+                               fieldDataPtr,
+                               bufPtr,
+                               bufNumBytes,
+                               &numBytesWritten);
     }
+    if ( result != LE_OK )
+        return result;
 
-    // If there is room in the output buffer, write the instance TLV to it.  Ensure that all the
-    // TLV data will fit, plus 6 bytes for header.
-    if ( totalNumBytesWritten + 6 <= bufNumBytes )
-    {
-        WriteTLVHeader(TLV_TYPE_OBJ_INST,
-                       instanceRef->instanceId,
-                       totalNumBytesWritten,
-                       bufPtr,
-                       bufNumBytes,
-                       &numBytesWritten);
+    *numBytesWrittenPtr = headerNumBytes + numBytesWritten;
+    return LE_OK;
+}
 
-        bufPtr += numBytesWritten;
-        bufNumBytes -= numBytesWritten;
 
-        memcpy(bufPtr, tmpBuffer, totalNumBytesWritten);
-        *numBytesWrittenPtr = numBytesWritten+totalNumBytesWritten;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes of the TLV with all instances of the LWM2M Object, as written by
+ * assetData_WriteObjectToTLV().
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the field does not exist
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_GetObjectTLVSize
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    int fieldId,                                ///< [IN] Field to write, or -1 for all fields
+    size_t* numBytesPtr                         ///< [OUT] # bytes of the TLV
+)
+{
+    le_result_t result;
+    le_dls_Link_t* linkPtr;
+    InstanceData_t* instancePtr;
+    FieldData_t* fieldDataPtr;
+    size_t valueNumBytes;
+    size_t numBytes = 0;
 
-        result = LE_OK;
-    }
-    else
+    linkPtr = le_dls_Peek(&assetRef->instanceList);
+
+    while ( linkPtr != NULL )
     {
-        LE_WARN("Overflow: oiid=%i, rid=%i", instanceRef->instanceId, fieldId);
-        *numBytesWrittenPtr = 0;
-        result = LE_OVERFLOW;
+        instancePtr = CONTAINER_OF(linkPtr, InstanceData_t, link);
+
+        result = GetInstanceValueNumBytes(instancePtr, fieldId, &fieldDataPtr, &valueNumBytes);
+        if ( result != LE_OK )
+            return result;
+
+        numBytes += GetTLVHeaderNumBytes(instancePtr->instanceId, valueNumBytes) + valueNumBytes;
+
+        linkPtr = le_dls_PeekNext(&assetRef->instanceList, linkPtr);
     }
 
-    return result;
+    *numBytesPtr = numBytes;
+    return LE_OK;
 }
 
 
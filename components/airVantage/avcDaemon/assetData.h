@@ -37,23 +37,6 @@
 #define ASSET_DATA_LEGATO_OBJ_NAME "legato"
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- *  Number of maps (called objects in JSON) in the CBOR encoded data (header, factor & sample).
- */
-//--------------------------------------------------------------------------------------------------
-#define NUM_TIME_SERIES_MAPS 3
-
-
-//--------------------------------------------------------------------------------------------------
-/**
- *  Number of bytes reserved in the CBOR stream. After all the samples are added to CBOR stream few
- *  more bytes are needed to close the sample array and the stream.
- */
-//--------------------------------------------------------------------------------------------------
-#define CBOR_RESERVED_BYTES 32
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Actions that can happen on field or asset
@@ -896,6 +879,23 @@ LE_SHARED le_result_t assetData_Init
 //--------------------------------------------------------------------------------------------------
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes of the list of readable LWM2M Resource TLVs of an instance, as written
+ * by assetData_WriteFieldListToTLV().
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_GetFieldListTLVSize
+(
+    assetData_InstanceDataRef_t instanceRef,    ///< [IN] Asset instance to use
+    size_t* numBytesPtr                         ///< [OUT] # bytes of the TLV list
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write a list of readable LWM2M Resource TLVs to the given buffer.
@@ -915,6 +915,25 @@ le_result_t assetData_WriteFieldListToTLV
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes of the TLV with all instances of the LWM2M Object, as written by
+ * assetData_WriteObjectToTLV().
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_NOT_FOUND if the field does not exist
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t assetData_GetObjectTLVSize
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    int fieldId,                                ///< [IN] Field to write, or -1 for all fields
+    size_t* numBytesPtr                         ///< [OUT] # bytes of the TLV
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write TLV with all instances of the LWM2M Object to the given buffer.
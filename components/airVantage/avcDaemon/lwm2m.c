@@ -59,10 +59,36 @@
  *
  * The buffer size required to store object 9 for 64 APPS is 64*320 bytes = ~20K
  * Though we need only ~20K bytes, we have allocated 32K bytes for margin of safety.
+ *
+ * TLV responses larger than this, e.g. for objects with many instances, are written to
+ * LargeResponsePtr instead.
  */
 //--------------------------------------------------------------------------------------------------
 static uint8_t ValueData[32*1024];
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of a TLV response.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RESPONSE_NUMBYTES (1024*1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffer for the TLV responses that do not fit in ValueData, and its size.  It is grown to the
+ * exact size of the TLV as needed, and kept for the subsequent block reads and the next responses.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* LargeResponsePtr = NULL;
+static size_t LargeResponseNumBytes = 0;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The asset data that will be sent to the Airvantage server; either ValueData or LargeResponsePtr.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t* ResponsePtr = ValueData;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Size of the asset data that will be sent to the Airvantage server.
@@ -97,6 +123,119 @@ static assetData_AssetDataRef_t CurrentReadAssetRef;
 // Local functions
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set ResponsePtr to a buffer of at least the given size.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the response is too large
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SetResponseBuffer
+(
+    size_t numBytes     ///< [IN] Size of the response
+)
+{
+    uint8_t* bufPtr;
+
+    if ( numBytes <= sizeof(ValueData) )
+    {
+        ResponsePtr = ValueData;
+        return LE_OK;
+    }
+
+    if ( numBytes > MAX_RESPONSE_NUMBYTES )
+    {
+        LE_ERROR("Response of %zu bytes is too large", numBytes);
+        return LE_OVERFLOW;
+    }
+
+    if ( numBytes > LargeResponseNumBytes )
+    {
+        // The size depends on the asset data model, so it is allocated from the heap rather than
+        // from a pool.
+        bufPtr = realloc(LargeResponsePtr, numBytes);
+        if ( bufPtr == NULL )
+        {
+            LE_ERROR("Cannot allocate %zu bytes for the response", numBytes);
+            return LE_OVERFLOW;
+        }
+
+        LargeResponsePtr = bufPtr;
+        LargeResponseNumBytes = numBytes;
+    }
+
+    ResponsePtr = LargeResponsePtr;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the TLV with all instances of an object to the response buffer.
+ *
+ * @return:
+ *      - See assetData_WriteObjectToTLV()
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteObjectResponse
+(
+    assetData_AssetDataRef_t assetRef,          ///< [IN] Asset to use
+    int resourceId                              ///< [IN] Field to write, or -1 for all fields
+)
+{
+    le_result_t result;
+    size_t numBytes;
+
+    result = assetData_GetObjectTLVSize(assetRef, resourceId, &numBytes);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    result = SetResponseBuffer(numBytes);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    return assetData_WriteObjectToTLV(assetRef, resourceId, ResponsePtr, numBytes, &BytesWritten);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the list of readable resource TLVs of an instance to the response buffer.
+ *
+ * @return:
+ *      - See assetData_WriteFieldListToTLV()
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteFieldListResponse
+(
+    assetData_InstanceDataRef_t instRef         ///< [IN] Asset instance to use
+)
+{
+    le_result_t result;
+    size_t numBytes;
+
+    result = assetData_GetFieldListTLVSize(instRef, &numBytes);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    result = SetResponseBuffer(numBytes);
+    if ( result != LE_OK )
+    {
+        return result;
+    }
+
+    return assetData_WriteFieldListToTLV(instRef, ResponsePtr, numBytes, &BytesWritten);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Handler function for receiving Operation indication
@@ -187,11 +326,7 @@ static void OperationHandler
         {
             CurrentReadResId = resourceId;
             CurrentReadAssetRef = assetRef;
-            result = assetData_WriteObjectToTLV(assetRef,
-                                                resourceId,
-                                                ValueData,
-                                                sizeof(ValueData),
-                                                &BytesWritten);
+            result = WriteObjectResponse(assetRef, resourceId);
         }
         else
         {
@@ -221,7 +356,7 @@ static void OperationHandler
         else
         {
             // Send the valid response
-            pa_avc_OperationReportSuccess(opRef, ValueData, BytesWritten);
+            pa_avc_OperationReportSuccess(opRef, ResponsePtr, BytesWritten);
         }
 
         // TODO: Refactor so I don't need a return here.
@@ -270,11 +405,7 @@ static void OperationHandler
                 // At COAP level observe cancel is a read request from the server with observe
                 // option flag set to false. So the reponse for cancel should include TLV for
                 // entire object.
-                result = assetData_WriteObjectToTLV(assetRef,
-                                    resourceId,
-                                    ValueData,
-                                    sizeof(ValueData),
-                                    &BytesWritten);
+                result = WriteObjectResponse(assetRef, resourceId);
 
                 if ( result == LE_NOT_FOUND )
                     opErr = PA_AVC_OPERR_OBJ_UNSUPPORTED;
@@ -291,7 +422,7 @@ static void OperationHandler
                 LE_INFO("Observe cancelled successfully.");
 
                 // Send the valid response
-                pa_avc_OperationReportSuccess(opRef, ValueData, BytesWritten);
+                pa_avc_OperationReportSuccess(opRef, ResponsePtr, BytesWritten);
             }
             return;
         }
@@ -336,11 +467,7 @@ static void OperationHandler
         }
         else
         {
-            result = assetData_WriteObjectToTLV(assetRef,
-                                                resourceId,
-                                                ValueData,
-                                                sizeof(ValueData),
-                                                &BytesWritten);
+            result = WriteObjectResponse(assetRef, resourceId);
 
             if ( result == LE_NOT_FOUND )
                 opErr = PA_AVC_OPERR_OBJ_UNSUPPORTED;
@@ -357,7 +484,7 @@ static void OperationHandler
             LE_INFO("Observe set successfully.");
 
             // Send the valid response
-            pa_avc_OperationReportSuccess(opRef, ValueData, BytesWritten);
+            pa_avc_OperationReportSuccess(opRef, ResponsePtr, BytesWritten);
         }
 
         return;
@@ -396,10 +523,7 @@ static void OperationHandler
 
                 if ( resourceId == -1 )
                 {
-                    result = assetData_WriteFieldListToTLV(instRef,
-                                                           ValueData,
-                                                           sizeof(ValueData),
-                                                           &BytesWritten);
+                    result = WriteFieldListResponse(instRef);
                 }
                 else
                 {
@@ -417,6 +541,7 @@ static void OperationHandler
                         return;
                     }
 
+                    ResponsePtr = ValueData;
                     BytesWritten = strlen((char*)ValueData);
                 }
             }
@@ -450,7 +575,7 @@ static void OperationHandler
             }
 
             // Send the valid response
-            pa_avc_OperationReportSuccess(opRef, ValueData, BytesWritten);
+            pa_avc_OperationReportSuccess(opRef, ResponsePtr, BytesWritten);
             break;
 
 
@@ -0,0 +1,1046 @@
+/**
+ * @file timeSeries.c
+ *
+ * Implementation of the timeSeries sub-component.
+ *
+ * The CBOR encoded time series is a map of three entries: the header "h" (resource path), the
+ * factors "f" (time stamp factor, data factor) and the samples "s", an indefinite length array of
+ * time stamp and value pairs.  The header and each sample are encoded in a small scratch buffer
+ * and fed to a deflate stream straight away, so only the compressed data is kept.
+ *
+ * The payload must never exceed its buffer, but deflate keeps some of its input until it decides
+ * to output a block.  So everything fed since the last flush is assumed to still be pending, and
+ * a sample is only accepted if the worst-case compressed size of the pending data, this sample and
+ * the end of the stream fits in what is left of the buffer.  When it doesn't, the pending data is
+ * flushed first, which costs a few bytes but leaves the whole remaining space usable.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#include "legato.h"
+#include "timeSeries.h"
+
+#ifdef LEGATO_FEATURE_TIMESERIES
+
+#include "tinycbor/cbor.h"
+#include "zlib.h"
+
+//--------------------------------------------------------------------------------------------------
+// Definitions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of maps (called objects in JSON) in the CBOR encoded data (header, factor & sample).
+ */
+//--------------------------------------------------------------------------------------------------
+#define NUM_MAPS 3
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a CBOR encoded header.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HEADER_MAX_NUMBYTES 128
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a CBOR encoded sample: a time stamp and a string of up to 255 bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLE_MAX_NUMBYTES 288
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * CBOR "break" byte, closing the indefinite length sample array.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CBOR_BREAK_BYTE 0xFF
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compression level and parameters.  A 4 KB window is as large as the uncompressed data of a
+ * payload usually gets, and keeps the memory of each stream at about 30 KB.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFLATE_LEVEL       Z_BEST_COMPRESSION
+#define DEFLATE_WINDOW_BITS 12
+#define DEFLATE_MEM_LEVEL   5
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of payloads queued in flash.  The oldest is dropped when the queue is full.
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUEUE_MAX_PAYLOADS 64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of the magic field of a queued payload file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUEUE_MAGIC 0x54534552
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of the path of a queued payload file.
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUEUE_PATH_MAX_NUMBYTES 256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of the queue directory path, leaving room for a file name.
+ */
+//--------------------------------------------------------------------------------------------------
+#define QUEUE_DIR_MAX_NUMBYTES (QUEUE_PATH_MAX_NUMBYTES - 16)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the return value from the tinyCBOR encoder and returns from function if an error is found.
+ */
+//--------------------------------------------------------------------------------------------------
+#define \
+    RETURN_IF_CBOR_ERROR( err ) \
+    ({ \
+        if (err != CborNoError) \
+        { \
+            LE_ERROR("CBOR encoding error %s", cbor_error_string(err)); \
+            return LE_FAULT; \
+        } \
+    })
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time series data
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct timeSeries_Data
+{
+    uint8_t header[HEADER_MAX_NUMBYTES];    ///< CBOR encoded header, kept for restarts.
+    size_t headerNumBytes;          ///< Header size in bytes.
+
+    uint8_t* bufferPtr;             ///< Buffer for the compressed data.
+    z_stream zStream;               ///< Deflate stream writing to the buffer.
+    size_t pendingNumBytes;         ///< Bytes fed to the stream since the last flush.
+    bool isFinished;                ///< Has the stream been closed?
+
+    double timeStampFactor;         ///< Factor of time stamp.
+    uint64_t prevTimeStamp;         ///< Time stamp of last data capture, used for delta encoding.
+
+    double factor;                  ///< Factor of data.
+    union
+    {
+        int prevIntValue;           ///< Value of of last data capture - used for delta encoding.
+        double prevFloatValue;      ///< Value of last data capture - used for delta encoding.
+    };
+
+    uint32_t numElements;           ///< Number of samples in the stream.
+}
+TimeSeriesData_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header of a payload file queued in flash, followed by the payload.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                                     ///< QUEUE_MAGIC
+    int32_t assetId;                                    ///< Asset id.
+    int32_t instanceId;                                 ///< Instance id.
+    int32_t fieldId;                                    ///< Field id.
+    uint32_t payloadNumBytes;                           ///< Payload size in bytes.
+    char appName[TIMESERIES_APP_NAME_MAX_NUMBYTES];     ///< App name of the asset.
+}
+QueuedPayloadHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+// Local Data
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Time series data memory pool.  Initialized in timeSeries_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t TimeSeriesDataPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compressed payload buffer memory pool.  Initialized in timeSeries_Init().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t PayloadBufferPoolRef = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory of the payloads queued in flash, one file per payload named after its sequence
+ * number.
+ */
+//--------------------------------------------------------------------------------------------------
+static char QueueDir[QUEUE_DIR_MAX_NUMBYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sequence numbers of the oldest queued payload and of the next one to queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t QueueFirstSeq = 0;
+static uint32_t QueueNextSeq = 0;
+
+
+//--------------------------------------------------------------------------------------------------
+// Local functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Is there enough space left in the buffer to compress the given number of bytes on top of the
+ * pending ones, and close the stream?
+ */
+//--------------------------------------------------------------------------------------------------
+static bool Fits
+(
+    TimeSeriesData_t* tsPtr,
+    size_t numBytes
+)
+{
+    // The deflate bound includes the zlib header and trailer, which is more than closing the
+    // stream takes.
+    return (deflateBound(&tsPtr->zStream, tsPtr->pendingNumBytes + numBytes + 1) <=
+            tsPtr->zStream.avail_out);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Output all the data pending in the deflate stream.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Flush
+(
+    TimeSeriesData_t* tsPtr
+)
+{
+    if (tsPtr->pendingNumBytes > 0)
+    {
+        tsPtr->zStream.next_in = NULL;
+        tsPtr->zStream.avail_in = 0;
+        deflate(&tsPtr->zStream, Z_SYNC_FLUSH);
+        tsPtr->pendingNumBytes = 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress CBOR encoded data.  The caller must have checked that it fits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void Compress
+(
+    TimeSeriesData_t* tsPtr,
+    uint8_t* dataPtr,
+    size_t numBytes
+)
+{
+    tsPtr->zStream.next_in = dataPtr;
+    tsPtr->zStream.avail_in = numBytes;
+    deflate(&tsPtr->zStream, Z_NO_FLUSH);
+    tsPtr->pendingNumBytes += numBytes;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new stream in the buffer with the header.  The deflate stream must have been
+ * initialized or reset.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartStream
+(
+    TimeSeriesData_t* tsPtr
+)
+{
+    tsPtr->zStream.next_out = tsPtr->bufferPtr;
+    tsPtr->zStream.avail_out = TIMESERIES_PAYLOAD_MAX_NUMBYTES;
+    tsPtr->pendingNumBytes = 0;
+    tsPtr->isFinished = false;
+    tsPtr->prevTimeStamp = 0;
+    tsPtr->numElements = 0;
+
+    Compress(tsPtr, tsPtr->header, tsPtr->headerNumBytes);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a CBOR encoded sample with its time stamp, delta encoded except for the first sample.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ *      - LE_OVERFLOW if the time series has been closed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartSample
+(
+    TimeSeriesData_t* tsPtr,
+    uint64_t* utcMilliSecPtr,       ///< [IN/OUT] Time stamp, 0 for now.
+    CborEncoder* encoderPtr,        ///< [OUT] Encoder to add the value with.
+    uint8_t* bufferPtr              ///< [IN] Scratch buffer of SAMPLE_MAX_NUMBYTES.
+)
+{
+    uint64_t timeStamp;
+    struct timeval tv;
+    CborError err;
+
+    if (tsPtr->isFinished)
+    {
+        LE_WARN("Time series already closed.");
+        return LE_OVERFLOW;
+    }
+
+    // Get current system time if utc milli seconds is not provided.
+    // The time stamp is expected in UTC milli seconds by the server.
+    if (*utcMilliSecPtr == 0)
+    {
+        gettimeofday(&tv, NULL);
+        *utcMilliSecPtr = (uint64_t)(tv.tv_sec) * 1000 + (uint64_t)(tv.tv_usec) / 1000;
+    }
+
+    // For the first entry write the absolute value, for all other entries calculate delta.
+    if (tsPtr->numElements == 0)
+    {
+        timeStamp = *utcMilliSecPtr * tsPtr->timeStampFactor;
+    }
+    else
+    {
+        timeStamp = (*utcMilliSecPtr - tsPtr->prevTimeStamp) * tsPtr->timeStampFactor;
+    }
+
+    cbor_encoder_init(encoderPtr, bufferPtr, SAMPLE_MAX_NUMBYTES, 0);
+
+    err = cbor_encode_int(encoderPtr, timeStamp);
+    RETURN_IF_CBOR_ERROR(err);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compress a CBOR encoded sample, if it fits.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_OVERFLOW if the sample was not added as the time series is full.
+ *      - LE_NO_MEMORY if the sample was added but there is no space for next one.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddSample
+(
+    TimeSeriesData_t* tsPtr,
+    uint64_t utcMilliSec,
+    CborEncoder* encoderPtr,
+    uint8_t* bufferPtr
+)
+{
+    size_t numBytes = cbor_encoder_get_buffer_size(encoderPtr, bufferPtr);
+
+    if (!Fits(tsPtr, numBytes))
+    {
+        Flush(tsPtr);
+
+        if (!Fits(tsPtr, numBytes))
+        {
+            LE_WARN("Time series buffer overflow.");
+            return LE_OVERFLOW;
+        }
+    }
+
+    Compress(tsPtr, bufferPtr, numBytes);
+
+    tsPtr->prevTimeStamp = utcMilliSec;
+    tsPtr->numElements++;
+
+    // Make sure that the next sample, assumed to be of the same size, will fit.
+    if (!Fits(tsPtr, numBytes))
+    {
+        Flush(tsPtr);
+
+        if (!Fits(tsPtr, numBytes))
+        {
+            LE_WARN("Time series buffer full; flush and restart time series.");
+            return LE_NO_MEMORY;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the path of a queued payload file.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetQueuedPayloadPath
+(
+    uint32_t seq,
+    char* pathPtr
+)
+{
+    snprintf(pathPtr, QUEUE_PATH_MAX_NUMBYTES, "%s/%08x", QueueDir, seq);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the oldest queued payload.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RemoveOldestQueuedPayload
+(
+    void
+)
+{
+    char path[QUEUE_PATH_MAX_NUMBYTES];
+
+    GetQueuedPayloadPath(QueueFirstSeq, path);
+    unlink(path);
+    QueueFirstSeq++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the payloads left queued in flash, e.g. by a previous run.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LoadQueue
+(
+    void
+)
+{
+    DIR* dirPtr = opendir(QueueDir);
+    struct dirent* entryPtr;
+    bool isEmpty = true;
+
+    QueueFirstSeq = 0;
+    QueueNextSeq = 0;
+
+    if (NULL == dirPtr)
+    {
+        return;
+    }
+
+    while (NULL != (entryPtr = readdir(dirPtr)))
+    {
+        char* endPtr;
+        uint32_t seq = strtoul(entryPtr->d_name, &endPtr, 16);
+
+        // Skip ".", ".." and any file left half-written.
+        if ((8 != strlen(entryPtr->d_name)) || ('\0' != *endPtr))
+        {
+            continue;
+        }
+
+        if (isEmpty || (seq < QueueFirstSeq))
+        {
+            QueueFirstSeq = seq;
+        }
+        if (isEmpty || (seq >= QueueNextSeq))
+        {
+            QueueNextSeq = seq + 1;
+        }
+        isEmpty = false;
+    }
+
+    closedir(dirPtr);
+
+    if (!isEmpty)
+    {
+        LE_INFO("%u time series payloads queued.", QueueNextSeq - QueueFirstSeq);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+// Interface functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a time series and write its header.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_Create
+(
+    const char* resourcePathPtr,    ///< [IN] Path of the resource, e.g. "/0/1".
+    double factor,                  ///< [IN] Multiplication factor used for delta encoding
+    double timeStampFactor,         ///< [IN] Multiplication factor used for delta encoding of
+                                    ///<      time stamp
+    timeSeries_Ref_t* refPtr        ///< [OUT] Time series.
+)
+{
+    uint8_t header[HEADER_MAX_NUMBYTES];
+    CborError err;
+    CborEncoder streamRef;
+    CborEncoder mapRef;
+    CborEncoder headerArray;
+    CborEncoder factorArray;
+    CborEncoder sampleRef;
+    TimeSeriesData_t* tsPtr;
+
+    // Create a map and add the header in to the map.
+    // e.g. "h" : [/1000/0]  --> map for header.
+    cbor_encoder_init(&streamRef, header, sizeof(header), 0);
+
+    err = cbor_encoder_create_map(&streamRef, &mapRef, NUM_MAPS);
+    RETURN_IF_CBOR_ERROR(err);
+
+    err = cbor_encode_text_stringz(&mapRef, "h");
+    RETURN_IF_CBOR_ERROR(err);
+
+    err = cbor_encoder_create_array(&mapRef, &headerArray, 1);
+    RETURN_IF_CBOR_ERROR(err);
+
+    err = cbor_encode_text_stringz(&headerArray, resourcePathPtr);
+    RETURN_IF_CBOR_ERROR(err);
+
+    err = cbor_encoder_close_container(&mapRef, &headerArray);
+    RETURN_IF_CBOR_ERROR(err);
+
+    // Create an array of factors (time stamp factor, data factor)
+    // e.g. "f" : [1, 1]  --> map for factor.
+    err = cbor_encode_text_stringz(&mapRef, "f");
+    RETURN_IF_CBOR_ERROR(err);
+
+    err = cbor_encoder_create_array(&mapRef, &factorArray, 2);
+    RETURN_IF_CBOR_ERROR(err);
+
+    err = cbor_encode_double(&factorArray, timeStampFactor);
+    RETURN_IF_CBOR_ERROR(err);
+
+    err = cbor_encode_double(&factorArray, factor);
+    RETURN_IF_CBOR_ERROR(err);
+
+    err = cbor_encoder_close_container(&mapRef, &factorArray);
+    RETURN_IF_CBOR_ERROR(err);
+
+    // Open the array for samples. The sample array will have time stamp and data pair.  It is
+    // closed by timeSeries_Finish() with a break byte.
+    err = cbor_encode_text_stringz(&mapRef, "s");
+    RETURN_IF_CBOR_ERROR(err);
+
+    err = cbor_encoder_create_array(&mapRef, &sampleRef, CborIndefiniteLength);
+    RETURN_IF_CBOR_ERROR(err);
+
+    tsPtr = le_mem_ForceAlloc(TimeSeriesDataPoolRef);
+    memset(tsPtr, 0, sizeof(TimeSeriesData_t));
+
+    memcpy(tsPtr->header, header, sizeof(header));
+    tsPtr->headerNumBytes = cbor_encoder_get_buffer_size(&sampleRef, header);
+    tsPtr->bufferPtr = le_mem_ForceAlloc(PayloadBufferPoolRef);
+    tsPtr->factor = factor;
+    tsPtr->timeStampFactor = timeStampFactor;
+
+    tsPtr->zStream.zalloc = Z_NULL;
+    tsPtr->zStream.zfree = Z_NULL;
+    tsPtr->zStream.opaque = Z_NULL;
+
+    if (Z_OK != deflateInit2(&tsPtr->zStream,
+                             DEFLATE_LEVEL,
+                             Z_DEFLATED,
+                             DEFLATE_WINDOW_BITS,
+                             DEFLATE_MEM_LEVEL,
+                             Z_DEFAULT_STRATEGY))
+    {
+        LE_ERROR("Failed to initialize compression.");
+        le_mem_Release(tsPtr->bufferPtr);
+        le_mem_Release(tsPtr);
+        return LE_FAULT;
+    }
+
+    StartStream(tsPtr);
+
+    *refPtr = tsPtr;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restart a time series with the same header and factors, dropping its samples.  This reuses the
+ * buffer and the compression state of the time series.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_Restart
+(
+    timeSeries_Ref_t ref            ///< [IN] Time series.
+)
+{
+    if (Z_OK != deflateReset(&ref->zStream))
+    {
+        LE_ERROR("Failed to reset compression.");
+        return LE_FAULT;
+    }
+
+    StartStream(ref);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_Delete
+(
+    timeSeries_Ref_t ref            ///< [IN] Time series.
+)
+{
+    deflateEnd(&ref->zStream);
+    le_mem_Release(ref->bufferPtr);
+    le_mem_Release(ref);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an integer sample.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ *      - LE_OVERFLOW if the sample was not added as the time series is full.
+ *      - LE_NO_MEMORY if the sample was added but there is no space for next one.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddInt
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint64_t utcMilliSec,           ///< [IN] Time stamp in UTC milliseconds, or 0 for now.
+    int value                       ///< [IN] Value.
+)
+{
+    uint8_t buffer[SAMPLE_MAX_NUMBYTES];
+    CborEncoder encoder;
+    CborError err;
+    int intDelta;
+    le_result_t result;
+
+    result = StartSample(ref, &utcMilliSec, &encoder, buffer);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if (ref->numElements == 0)
+    {
+        intDelta = value * ref->factor;
+    }
+    else
+    {
+        intDelta = (value - ref->prevIntValue) * ref->factor;
+    }
+
+    err = cbor_encode_int(&encoder, intDelta);
+    RETURN_IF_CBOR_ERROR(err);
+
+    result = AddSample(ref, utcMilliSec, &encoder, buffer);
+    if (result != LE_OVERFLOW)
+    {
+        ref->prevIntValue = value;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a boolean sample.
+ *
+ * @return:
+ *      - See timeSeries_AddInt()
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddBool
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint64_t utcMilliSec,           ///< [IN] Time stamp in UTC milliseconds, or 0 for now.
+    bool value                      ///< [IN] Value.
+)
+{
+    uint8_t buffer[SAMPLE_MAX_NUMBYTES];
+    CborEncoder encoder;
+    CborError err;
+    le_result_t result;
+
+    result = StartSample(ref, &utcMilliSec, &encoder, buffer);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    err = cbor_encode_boolean(&encoder, value);
+    RETURN_IF_CBOR_ERROR(err);
+
+    return AddSample(ref, utcMilliSec, &encoder, buffer);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a string sample.
+ *
+ * @return:
+ *      - See timeSeries_AddInt()
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddString
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint64_t utcMilliSec,           ///< [IN] Time stamp in UTC milliseconds, or 0 for now.
+    const char* valuePtr            ///< [IN] Value.
+)
+{
+    uint8_t buffer[SAMPLE_MAX_NUMBYTES];
+    CborEncoder encoder;
+    CborError err;
+    le_result_t result;
+
+    result = StartSample(ref, &utcMilliSec, &encoder, buffer);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    err = cbor_encode_text_stringz(&encoder, valuePtr);
+    RETURN_IF_CBOR_ERROR(err);
+
+    return AddSample(ref, utcMilliSec, &encoder, buffer);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a floating point sample.
+ *
+ * @return:
+ *      - See timeSeries_AddInt()
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_AddFloat
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint64_t utcMilliSec,           ///< [IN] Time stamp in UTC milliseconds, or 0 for now.
+    double value                    ///< [IN] Value.
+)
+{
+    uint8_t buffer[SAMPLE_MAX_NUMBYTES];
+    CborEncoder encoder;
+    CborError err;
+    double floatDelta;
+    le_result_t result;
+
+    result = StartSample(ref, &utcMilliSec, &encoder, buffer);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    // ToDO: float doesn't benefit from use of factor - investigate.
+    if (ref->numElements == 0)
+    {
+        floatDelta = value * ref->factor;
+    }
+    else
+    {
+        floatDelta = (value - ref->prevFloatValue) * ref->factor;
+    }
+
+    if ((uint64_t)ref->factor == 1)
+    {
+        err = cbor_encode_double(&encoder, floatDelta);
+    }
+    else
+    {
+        err = cbor_encode_int(&encoder, (int64_t)floatDelta);
+    }
+    RETURN_IF_CBOR_ERROR(err);
+
+    result = AddSample(ref, utcMilliSec, &encoder, buffer);
+    if (result != LE_OVERFLOW)
+    {
+        ref->prevFloatValue = value;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of samples added to a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t timeSeries_GetSampleCount
+(
+    timeSeries_Ref_t ref            ///< [IN] Time series.
+)
+{
+    return ref->numElements;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the time series and get its compressed payload.  No sample can be added afterwards.  The
+ * payload remains valid until the time series is deleted.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_Finish
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint8_t** payloadPtrPtr,        ///< [OUT] Compressed payload.
+    size_t* payloadNumBytesPtr      ///< [OUT] Payload size in bytes.
+)
+{
+    uint8_t breakByte = CBOR_BREAK_BYTE;
+
+    if (!ref->isFinished)
+    {
+        // Close the sample array; the map and the stream have definite lengths.
+        ref->zStream.next_in = &breakByte;
+        ref->zStream.avail_in = 1;
+
+        if (Z_STREAM_END != deflate(&ref->zStream, Z_FINISH))
+        {
+            LE_ERROR("Failed to compress time series.");
+            return LE_FAULT;
+        }
+
+        ref->isFinished = true;
+    }
+
+    *payloadPtrPtr = ref->bufferPtr;
+    *payloadNumBytesPtr = ref->zStream.total_out;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a payload in flash, to be sent by timeSeries_SendQueued().  When the queue is full, the
+ * oldest payload is dropped.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t timeSeries_QueuePayload
+(
+    const char* appNamePtr,         ///< [IN] App name of the asset.
+    int assetId,                    ///< [IN] Asset id.
+    int instanceId,                 ///< [IN] Instance id.
+    int fieldId,                    ///< [IN] Field id.
+    const uint8_t* payloadPtr,      ///< [IN] Compressed payload.
+    size_t payloadNumBytes          ///< [IN] Payload size in bytes.
+)
+{
+    QueuedPayloadHeader_t header;
+    char tmpPath[QUEUE_PATH_MAX_NUMBYTES];
+    char path[QUEUE_PATH_MAX_NUMBYTES];
+    int fd;
+    bool isWritten;
+
+    if (payloadNumBytes > TIMESERIES_PAYLOAD_MAX_NUMBYTES)
+    {
+        LE_ERROR("Payload too large to be queued.");
+        return LE_FAULT;
+    }
+
+    if (LE_OK != le_dir_MakePath(QueueDir, S_IRWXU))
+    {
+        LE_ERROR("Unable to create directory %s", QueueDir);
+        return LE_FAULT;
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.magic = QUEUE_MAGIC;
+    header.assetId = assetId;
+    header.instanceId = instanceId;
+    header.fieldId = fieldId;
+    header.payloadNumBytes = payloadNumBytes;
+    le_utf8_Copy(header.appName, appNamePtr, sizeof(header.appName), NULL);
+
+    // Write to a temporary file and rename it, so that a payload is either whole or absent.
+    snprintf(tmpPath, sizeof(tmpPath), "%s/tmp", QueueDir);
+
+    fd = open(tmpPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (-1 == fd)
+    {
+        LE_ERROR("Unable to open %s: %m", tmpPath);
+        return LE_FAULT;
+    }
+
+    isWritten = ((sizeof(header) == write(fd, &header, sizeof(header))) &&
+                 (payloadNumBytes == write(fd, payloadPtr, payloadNumBytes)) &&
+                 (0 == fsync(fd)));
+    close(fd);
+
+    if (!isWritten)
+    {
+        LE_ERROR("Unable to write %s", tmpPath);
+        unlink(tmpPath);
+        return LE_FAULT;
+    }
+
+    if ((QueueNextSeq - QueueFirstSeq) >= QUEUE_MAX_PAYLOADS)
+    {
+        LE_WARN("Time series queue full; dropping the oldest payload.");
+        RemoveOldestQueuedPayload();
+    }
+
+    GetQueuedPayloadPath(QueueNextSeq, path);
+    if (-1 == rename(tmpPath, path))
+    {
+        LE_ERROR("Unable to rename %s: %m", tmpPath);
+        unlink(tmpPath);
+        return LE_FAULT;
+    }
+
+    QueueNextSeq++;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the queued payloads, oldest first, removing each one only once it has been sent.  Stops at
+ * the first payload that could not be sent, which is kept with the ones after it.
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_SendQueued
+(
+    timeSeries_SendFunc_t sendFunc  ///< [IN] Function sending a payload.
+)
+{
+    while (QueueFirstSeq != QueueNextSeq)
+    {
+        QueuedPayloadHeader_t header;
+        uint8_t payload[TIMESERIES_PAYLOAD_MAX_NUMBYTES];
+        char path[QUEUE_PATH_MAX_NUMBYTES];
+        int fd;
+        bool isRead;
+
+        GetQueuedPayloadPath(QueueFirstSeq, path);
+
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (-1 == fd)
+        {
+            LE_WARN("Unable to open %s: %m", path);
+            RemoveOldestQueuedPayload();
+            continue;
+        }
+
+        isRead = ((sizeof(header) == read(fd, &header, sizeof(header))) &&
+                  (QUEUE_MAGIC == header.magic) &&
+                  (header.payloadNumBytes <= sizeof(payload)) &&
+                  (header.payloadNumBytes == read(fd, payload, header.payloadNumBytes)));
+        close(fd);
+
+        if (isRead)
+        {
+            le_result_t result;
+
+            header.appName[sizeof(header.appName) - 1] = '\0';
+
+            result = sendFunc(header.appName,
+                              header.assetId,
+                              header.instanceId,
+                              header.fieldId,
+                              payload,
+                              header.payloadNumBytes);
+            if (LE_NOT_FOUND == result)
+            {
+                LE_WARN("Dropping time series payload %s: field no longer observed", path);
+            }
+            else if (LE_OK != result)
+            {
+                // Keep this payload, and the ones after it, for the next time.
+                LE_WARN("Unable to send time series payload %s (%s)", path, LE_RESULT_TXT(result));
+                return;
+            }
+        }
+        else
+        {
+            LE_WARN("Dropping corrupted time series payload %s", path);
+        }
+
+        RemoveOldestQueuedPayload();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+void timeSeries_Init
+(
+    const char* queueDirPtr         ///< [IN] Directory of the payloads queued in flash.
+)
+{
+    TimeSeriesDataPoolRef = le_mem_CreatePool("TimeSeries data pool", sizeof(TimeSeriesData_t));
+    PayloadBufferPoolRef = le_mem_CreatePool("TimeSeries payload pool",
+                                             TIMESERIES_PAYLOAD_MAX_NUMBYTES);
+
+    LE_FATAL_IF(LE_OK != le_utf8_Copy(QueueDir, queueDirPtr, sizeof(QueueDir), NULL),
+                "Time series queue path too long: %s", queueDirPtr);
+
+    LoadQueue();
+}
+
+#endif
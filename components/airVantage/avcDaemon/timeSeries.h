@@ -0,0 +1,262 @@
+/**
+ * @file timeSeries.h
+ *
+ * Interface for the timeSeries sub-component.
+ *
+ * A time series delta-encodes the samples recorded on a field as CBOR and compresses them as they
+ * are recorded, so the payload sent on push is built up sample by sample and its size limit
+ * applies to the compressed data.  Payloads pushed while the AirVantage session is not available
+ * are queued in flash and sent when it comes back.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ *
+ */
+
+#ifndef LEGATO_TIMESERIES_INCLUDE_GUARD
+#define LEGATO_TIMESERIES_INCLUDE_GUARD
+
+#include "legato.h"
+
+//--------------------------------------------------------------------------------------------------
+// Definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of a compressed time series payload.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_PAYLOAD_MAX_NUMBYTES 1024
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of bytes of an app name, including the terminating NUL.
+ */
+//--------------------------------------------------------------------------------------------------
+#define TIMESERIES_APP_NAME_MAX_NUMBYTES 100
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct timeSeries_Data* timeSeries_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function called to send each payload queued while the session was not available.  The observe
+ * token is looked up when sending, since the server may have observed the field again since the
+ * payload was queued.
+ *
+ * @return:
+ *      - LE_OK if the payload was sent; it is removed from the queue
+ *      - LE_NOT_FOUND if the field is gone or no longer observed; the payload is dropped
+ *      - Any other value if the payload could not be sent now; it is kept for the next time
+ */
+//--------------------------------------------------------------------------------------------------
+typedef le_result_t (*timeSeries_SendFunc_t)
+(
+    char* appNamePtr,               ///< [IN] App name of the asset.
+    int assetId,                    ///< [IN] Asset id.
+    int instanceId,                 ///< [IN] Instance id.
+    int fieldId,                    ///< [IN] Field id.
+    uint8_t* payloadPtr,            ///< [IN] Compressed payload.
+    size_t payloadNumBytes          ///< [IN] Payload size in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+// Interface functions
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Init this sub-component
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void timeSeries_Init
+(
+    const char* queueDirPtr         ///< [IN] Directory of the payloads queued in flash.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a time series and write its header.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_Create
+(
+    const char* resourcePathPtr,    ///< [IN] Path of the resource, e.g. "/0/1".
+    double factor,                  ///< [IN] Multiplication factor used for delta encoding
+    double timeStampFactor,         ///< [IN] Multiplication factor used for delta encoding of
+                                    ///<      time stamp
+    timeSeries_Ref_t* refPtr        ///< [OUT] Time series.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Restart a time series with the same header and factors, dropping its samples.  This reuses the
+ * buffer and the compression state of the time series.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_Restart
+(
+    timeSeries_Ref_t ref            ///< [IN] Time series.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void timeSeries_Delete
+(
+    timeSeries_Ref_t ref            ///< [IN] Time series.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an integer sample.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ *      - LE_OVERFLOW if the sample was not added as the time series is full.
+ *      - LE_NO_MEMORY if the sample was added but there is no space for next one.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_AddInt
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint64_t utcMilliSec,           ///< [IN] Time stamp in UTC milliseconds, or 0 for now.
+    int value                       ///< [IN] Value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a boolean sample.
+ *
+ * @return:
+ *      - See timeSeries_AddInt()
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_AddBool
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint64_t utcMilliSec,           ///< [IN] Time stamp in UTC milliseconds, or 0 for now.
+    bool value                      ///< [IN] Value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a string sample.
+ *
+ * @return:
+ *      - See timeSeries_AddInt()
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_AddString
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint64_t utcMilliSec,           ///< [IN] Time stamp in UTC milliseconds, or 0 for now.
+    const char* valuePtr            ///< [IN] Value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a floating point sample.
+ *
+ * @return:
+ *      - See timeSeries_AddInt()
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_AddFloat
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint64_t utcMilliSec,           ///< [IN] Time stamp in UTC milliseconds, or 0 for now.
+    double value                    ///< [IN] Value.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of samples added to a time series.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED uint32_t timeSeries_GetSampleCount
+(
+    timeSeries_Ref_t ref            ///< [IN] Time series.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the time series and get its compressed payload.  No sample can be added afterwards.  The
+ * payload remains valid until the time series is deleted.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_Finish
+(
+    timeSeries_Ref_t ref,           ///< [IN] Time series.
+    uint8_t** payloadPtrPtr,        ///< [OUT] Compressed payload.
+    size_t* payloadNumBytesPtr      ///< [OUT] Payload size in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a payload in flash, to be sent by timeSeries_SendQueued().  When the queue is full, the
+ * oldest payload is dropped.
+ *
+ * @return:
+ *      - LE_OK on success
+ *      - LE_FAULT on any other error
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t timeSeries_QueuePayload
+(
+    const char* appNamePtr,         ///< [IN] App name of the asset.
+    int assetId,                    ///< [IN] Asset id.
+    int instanceId,                 ///< [IN] Instance id.
+    int fieldId,                    ///< [IN] Field id.
+    const uint8_t* payloadPtr,      ///< [IN] Compressed payload.
+    size_t payloadNumBytes          ///< [IN] Payload size in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the queued payloads, oldest first, removing each one only once it has been sent.  Stops at
+ * the first payload that could not be sent, which is kept with the ones after it.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void timeSeries_SendQueued
+(
+    timeSeries_SendFunc_t sendFunc  ///< [IN] Function sending a payload.
+);
+
+#endif // LEGATO_TIMESERIES_INCLUDE_GUARD
@@ -895,7 +895,13 @@ static void RemoveStreamEventHandler
         }
 
         LE_DEBUG("dtmfDetectionHandlerCount %d", dtmfDetectionHandlerCount);
-        if (dtmfDetectionHandlerCount == 1)
+        if ((dtmfDetectionHandlerCount == 1) &&
+            (LE_AUDIO_IF_DSP_FRONTEND_FILE_CAPTURE == streamPtr->audioInterface))
+        {
+            // DTMF are detected on the captured samples by le_media, in the PCM capture thread
+            __atomic_store_n(&streamPtr->dtmfDetection, false, __ATOMIC_RELAXED);
+        }
+        else if (dtmfDetectionHandlerCount == 1)
         {
             pa_audio_StopDtmfDecoder(streamPtr);
 
@@ -1256,6 +1262,22 @@ static void CloseSessionEventHandler
 //                                       Public declarations
 //--------------------------------------------------------------------------------------------------
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stream object of a stream reference. Must be called from the main thread, which is the
+ * one that closes the streams.
+ *
+ * @return The stream object, or NULL if the stream has been closed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_audio_Stream_t* le_audio_LookupStream
+(
+    le_audio_StreamRef_t streamRef  ///< [IN] The audio stream reference.
+)
+{
+    return le_ref_Lookup(AudioStreamRefMap, streamRef);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the audio component.
@@ -1999,8 +2021,14 @@ le_audio_DtmfDetectorHandlerRef_t le_audio_AddDtmfDetectorHandler
         return NULL;
     }
 
+    // DTMF of a capture stream are detected on the captured samples, and reported by le_media
+    // through the stream event.
+    if (LE_AUDIO_IF_DSP_FRONTEND_FILE_CAPTURE == streamPtr->audioInterface)
+    {
+        __atomic_store_n(&streamPtr->dtmfDetection, true, __ATOMIC_RELAXED);
+    }
     // Register a handler function for Dtmf streams events
-    if (streamPtr->dtmfEventHandler == NULL)
+    else if (streamPtr->dtmfEventHandler == NULL)
     {
         streamPtr->dtmfEventHandler = pa_audio_AddDtmfStreamEventHandler(DtmfStreamEventHandler,
                                                                      streamPtr);
@@ -3548,3 +3576,139 @@ le_result_t le_audio_UnmuteCallWaitingTone
     return pa_audio_MuteCallWaitingTone(false);
 }
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the streaming configuration, applied to the playback and capture streams started afterwards.
+ *
+ * @return LE_OUT_OF_RANGE  The buffer size is out of range.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_SetStreamingConfig
+(
+    uint32_t bufferSize,
+        ///< [IN]
+        ///< Bytes moved by the media thread at once, 256 to 65536.
+
+    uint32_t pipeSize,
+        ///< [IN]
+        ///< Capacity of the media pipes in bytes, 0 for the system default.
+
+    uint32_t periodSize,
+        ///< [IN]
+        ///< PCM period size in frames, 0 for the platform default.
+
+    uint32_t periodsCount,
+        ///< [IN]
+        ///< Number of PCM periods, 0 for the platform default.
+
+    bool useSplice
+        ///< [IN]
+        ///< Move WAV data with splice() when the files allow it.
+)
+{
+    le_media_StreamingConfig_t config =
+    {
+        .bufferSize = bufferSize,
+        .pipeSize = pipeSize,
+        .periodSize = periodSize,
+        .periodsCount = periodsCount,
+        .useSplice = useSplice
+    };
+
+    return le_media_SetStreamingConfig(&config);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the streaming configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_audio_GetStreamingConfig
+(
+    uint32_t* bufferSizePtr,
+        ///< [OUT]
+        ///< Bytes moved by the media thread in one transfer.
+
+    uint32_t* pipeSizePtr,
+        ///< [OUT]
+        ///< Capacity of the media pipes in bytes, 0 for the system default.
+
+    uint32_t* periodSizePtr,
+        ///< [OUT]
+        ///< PCM period size in frames, 0 for the platform default.
+
+    uint32_t* periodsCountPtr,
+        ///< [OUT]
+        ///< Number of PCM periods, 0 for the platform default.
+
+    bool* useSplicePtr
+        ///< [OUT]
+        ///< Move WAV data with splice() when the files allow it.
+)
+{
+    le_media_StreamingConfig_t config;
+
+    le_media_GetStreamingConfig(&config);
+
+    *bufferSizePtr = config.bufferSize;
+    *pipeSizePtr = config.pipeSize;
+    *periodSizePtr = config.periodSize;
+    *periodsCountPtr = config.periodsCount;
+    *useSplicePtr = config.useSplice;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the streaming statistics of a playback or capture stream. The statistics are reset when the
+ * playback or the capture starts.
+ *
+ * @return LE_FAULT         Function failed.
+ * @return LE_OK            Function succeeded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_audio_GetStreamStats
+(
+    le_audio_StreamRef_t streamRef,
+        ///< [IN]
+        ///< Audio stream reference.
+
+    uint32_t* underrunCountPtr,
+        ///< [OUT]
+        ///< Playback periods that could not be filled in time.
+
+    uint32_t* overrunCountPtr,
+        ///< [OUT]
+        ///< Capture periods written while the pipe was full.
+
+    uint64_t* splicedBytesPtr,
+        ///< [OUT]
+        ///< Bytes moved by the media thread without copy.
+
+    uint64_t* copiedBytesPtr
+        ///< [OUT]
+        ///< Bytes copied by the media thread through a buffer.
+)
+{
+    le_audio_Stream_t* streamPtr = le_ref_Lookup(AudioStreamRefMap, streamRef);
+    le_audio_StreamStats_t stats;
+
+    if (streamPtr == NULL)
+    {
+        LE_KILL_CLIENT("Invalid stream reference (%p) provided!", streamRef);
+        return LE_FAULT;
+    }
+
+    if (le_media_GetStreamStats(streamPtr, &stats) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    *underrunCountPtr = stats.underrunCount;
+    *overrunCountPtr = stats.overrunCount;
+    *splicedBytesPtr = stats.splicedBytes;
+    *copiedBytesPtr = stats.copiedBytes;
+
+    return LE_OK;
+}
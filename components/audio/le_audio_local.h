@@ -18,6 +18,9 @@ typedef struct
     uint16_t channelsCount;         ///< Number of channels
     uint16_t bitsPerSample;         ///< Sampling resolution
     uint32_t byteRate;              ///< byterate of the played/recorded file
+    uint32_t periodSize;            ///< Period size in frames, 0 for the platform default
+    uint32_t periodsCount;          ///< Number of periods of the PCM buffer, 0 for the platform
+                                    ///  default
 }
 le_audio_SamplePcmConfig_t;
 
@@ -73,6 +76,21 @@ typedef enum
 le_audio_If_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Streaming statistics of a playback/capture stream. The fields are updated by the media and PCM
+ * threads, and must be accessed atomically.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t underrunCount;         ///< Playback periods that could not be filled in time
+    uint32_t overrunCount;          ///< Capture periods written while the pipe was full
+    uint64_t splicedBytes;          ///< Bytes moved by the media thread without copy
+    uint64_t copiedBytes;           ///< Bytes copied by the media thread through a buffer
+}
+le_audio_StreamStats_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The data parameters structure associated to the playback/capture thread.
@@ -88,6 +106,9 @@ typedef struct {
     bool                        pause;              ///< pause in capture
     le_audio_MediaEvent_t       mediaEvent;         ///< media event to be sent
     int                         framesFuncTimeout;  ///< Timeout for getFramesFunc callback
+    struct le_dtmf_Detector*    dtmfDetectorPtr;    ///< DTMF detector on captured samples
+    int                         pipeSize;           ///< Capacity of the capture pipe, 0 if fd
+                                                    ///  is not a pipe
 }
 le_audio_PcmContext_t;
 
@@ -139,6 +160,12 @@ typedef le_result_t (*CloseMediaFunc_t)
     le_audio_MediaThreadContextPtr_t
 );
 
+typedef le_result_t (*SpliceMediaFunc_t)
+(
+    le_audio_MediaThreadContextPtr_t mediaCtxPtr,    ///< [IN] Media thread context
+    uint32_t*                        lenPtr          ///< [OUT] Length of the moved data
+);
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -162,6 +189,8 @@ typedef struct le_audio_MediaThreadContext
     uint32_t                         fd_in;              ///< file descriptor to read
     uint32_t                         fd_out;             ///< file descriptor to write
     uint32_t                         bufferSize;         ///< Size of the required buffer
+    uint8_t*                         bufferPtr;          ///< Buffer to copy the data through,
+                                                         ///< allocated when first needed
     le_sem_Ref_t                     threadSemaphore;    ///< semaphore to wait starting
     InitMediaFunc_t                  initFunc;           ///< Init function for play/capture
                                                          ///< in WAV/AMR format
@@ -171,7 +200,10 @@ typedef struct le_audio_MediaThreadContext
                                                          ///< in WAV/AMR format
     CloseMediaFunc_t                 closeFunc;          ///< Close function for play/capture
                                                          ///< in WAV/AMR format
+    SpliceMediaFunc_t                spliceFunc;         ///< Zero-copy function for play/capture,
+                                                         ///< used instead of readFunc/writeFunc
     le_audio_Codec_t                 codecParams;        ///< Codec parameters
+    le_audio_StreamPtr_t             streamPtr;          ///< Stream object
 }
 le_audio_MediaThreadContext_t;
 
@@ -208,6 +240,10 @@ typedef struct le_audio_Stream {
     pa_audio_Params_t   PaParams;                      ///< PA Parameters
     bool echoCancellerEnabled;                         ///< Store the status of echo canceller
     bool noiseSuppressorEnabled;                       ///< Store the status of noise suppressor
+    bool dtmfDetection;                                ///< DTMF are detected on the captured
+                                                       ///  samples (read by the capture thread,
+                                                       ///  must be accessed atomically)
+    le_audio_StreamStats_t stats;                      ///< Streaming statistics
 }
 le_audio_Stream_t;
 
@@ -252,5 +288,18 @@ typedef void (*le_audio_DtmfStreamEventHandlerFunc_t)
     void*                           contextPtr        ///< handler's context
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the stream object of a stream reference. Must be called from the main thread, which is the
+ * one that closes the streams.
+ *
+ * @return The stream object, or NULL if the stream has been closed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_audio_Stream_t* le_audio_LookupStream
+(
+    le_audio_StreamRef_t streamRef  ///< [IN] The audio stream reference.
+);
+
 
 #endif // LEGATO_LEAUDIOLOCAL_INCLUDE_GUARD
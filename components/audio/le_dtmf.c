@@ -0,0 +1,441 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file le_dtmf.c
+ *
+ * This file contains the source code of the DTMF generation and detection on PCM samples.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "le_dtmf_local.h"
+#include <math.h>
+
+//--------------------------------------------------------------------------------------------------
+// Symbol and Enum definitions.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Values used for DTMF sampling.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SAMPLE_SCALE    (32767)
+#define DTMF_AMPLITUDE  (40)
+#if !defined (PI)
+#define PI 3.14159265358979323846264338327
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the sine table. The fractional part of the phase is used to interpolate between two
+ * entries of the table.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SINE_TABLE_BITS     10
+#define SINE_TABLE_SIZE     (1 << SINE_TABLE_BITS)
+#define PHASE_FRAC_BITS     (32 - SINE_TABLE_BITS)
+#define PHASE_FRAC_MASK     ((1U << PHASE_FRAC_BITS) - 1)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of samples generated from an exact phase. The phase of the next sample is then
+ * computed again from the sample index, so that rounding errors do not accumulate.
+ */
+//--------------------------------------------------------------------------------------------------
+#define GENERATE_BLOCK_SIZE 256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Duration of a detection block, in samples at 8 kHz. 205 samples give a good separation of the
+ * DTMF frequencies at 8 kHz; the block is scaled for other sample rates.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DETECT_BLOCK_SIZE_8KHZ  205
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Detection thresholds:
+ * - minimum mean square value of a block, i.e. a signal of about -50 dBFS.
+ * - minimum part of the energy of a block carried by the two tones.
+ * - maximum power ratio between the two tones (twist), about 8 dB.
+ * - maximum power ratio between another frequency of a group and the tone of this group.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DETECT_MIN_MEAN_SQUARE      10000.0f
+#define DETECT_MIN_TONE_RATIO       0.7f
+#define DETECT_MAX_TWIST            6.3f
+#define DETECT_MAX_OTHER_RATIO      0.1f
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sine table, scaled to the DTMF amplitude. The extra entry is a copy of the first one, so that
+ * the last entry can be interpolated without wrapping.
+ */
+//--------------------------------------------------------------------------------------------------
+static float SineTable[SINE_TABLE_SIZE + 1];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF frequencies: rows (low frequencies), then columns (high frequencies).
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint32_t DtmfFreqs[LE_DTMF_FREQ_COUNT] =
+{
+    697, 770, 852, 941, 1209, 1336, 1477, 1633
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF keypad, indexed by row and column.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char DtmfKeypad[4][4] =
+{
+    { '1', '2', '3', 'A' },
+    { '4', '5', '6', 'B' },
+    { '7', '8', '9', 'C' },
+    { '*', '0', '#', 'D' }
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add two 16-bit values.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static inline int16_t SaturateAdd16
+(
+    int32_t a,
+    int32_t b
+)
+{
+    int32_t tot=a+b;
+
+    if (tot > 32767)
+    {
+        return 32767;
+    }
+    else if (tot < -32768)
+    {
+        return -32768;
+    }
+    else
+    {
+        return (tot & 0xFFFF);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the phase of a tone at a given sample, as a fraction of a period on 32 bits.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t GetPhase
+(
+    uint32_t freq,
+    uint32_t sampleRate,
+    uint32_t sampleIndex
+)
+{
+    // Number of periods elapsed, modulo 1, in units of 1/sampleRate period: exact
+    uint64_t cycles = ((uint64_t)freq * sampleIndex) % sampleRate;
+
+    return (uint32_t)((cycles << 32) / sampleRate);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the sine table value of a phase.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline float GetSine
+(
+    uint32_t phase
+)
+{
+    uint32_t index = phase >> PHASE_FRAC_BITS;
+    float    frac = (float)(phase & PHASE_FRAC_MASK) * (1.0f / (PHASE_FRAC_MASK + 1.0f));
+
+    return SineTable[index] + frac * (SineTable[index + 1] - SineTable[index]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate a block of samples of a dual tone. The samples are independent from each other so
+ * that the loop can be vectorized.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GenerateBlock
+(
+    int16_t* restrict bufPtr,
+    uint32_t          sampleCount,
+    uint32_t          phase1,
+    uint32_t          step1,
+    uint32_t          phase2,
+    uint32_t          step2
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < sampleCount; i++)
+    {
+        int32_t s1 = (int32_t)GetSine(phase1 + i * step1);
+        int32_t s2 = (int32_t)GetSine(phase2 + i * step2);
+
+        bufPtr[i] = SaturateAdd16(s1, s2);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the digit of a complete detection block.
+ *
+ * @return The digit, or '\0' if there is no valid digit in the block.
+ */
+//--------------------------------------------------------------------------------------------------
+static char AnalyzeBlock
+(
+    const le_dtmf_Detector_t* detectorPtr
+)
+{
+    float    power[LE_DTMF_FREQ_COUNT];
+    uint32_t row = 0;
+    uint32_t col = 4;
+    uint32_t i;
+
+    for (i = 0; i < LE_DTMF_FREQ_COUNT; i++)
+    {
+        power[i] = detectorPtr->s1[i] * detectorPtr->s1[i] +
+                   detectorPtr->s2[i] * detectorPtr->s2[i] -
+                   detectorPtr->coef[i] * detectorPtr->s1[i] * detectorPtr->s2[i];
+    }
+
+    for (i = 1; i < 4; i++)
+    {
+        if (power[i] > power[row])
+        {
+            row = i;
+        }
+        if (power[i + 4] > power[col])
+        {
+            col = i + 4;
+        }
+    }
+
+    if (detectorPtr->energy < (DETECT_MIN_MEAN_SQUARE * detectorPtr->blockSize))
+    {
+        return '\0';
+    }
+
+    // The power of a pure tone over a block is energy * blockSize / 2
+    if ((power[row] + power[col]) <
+        (DETECT_MIN_TONE_RATIO * detectorPtr->energy * detectorPtr->blockSize / 2))
+    {
+        return '\0';
+    }
+
+    if ((power[row] > (power[col] * DETECT_MAX_TWIST)) ||
+        (power[col] > (power[row] * DETECT_MAX_TWIST)))
+    {
+        return '\0';
+    }
+
+    for (i = 0; i < LE_DTMF_FREQ_COUNT; i++)
+    {
+        if ((i != row) && (i != col) &&
+            (power[i] > (power[(i < 4) ? row : col] * DETECT_MAX_OTHER_RATIO)))
+        {
+            return '\0';
+        }
+    }
+
+    return DtmfKeypad[row][col - 4];
+}
+
+//--------------------------------------------------------------------------------------------------
+//                                       Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the DTMF module. Must be called once before generating tones.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_dtmf_Init
+(
+    void
+)
+{
+    uint32_t i;
+
+    for (i = 0; i < SINE_TABLE_SIZE; i++)
+    {
+        SineTable[i] = SAMPLE_SCALE * DTMF_AMPLITUDE / 100.0 * sin(2 * PI * i / SINE_TABLE_SIZE);
+    }
+    SineTable[SINE_TABLE_SIZE] = SineTable[0];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate 16-bit samples of a dual tone. A frequency of 0 generates silence for that tone.
+ *
+ * Samples are numbered from the start of the tone, so a long tone can be generated by
+ * successive calls with increasing firstSample.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_dtmf_Generate
+(
+    int16_t*  bufPtr,       ///< [OUT] Samples buffer
+    uint32_t  sampleCount,  ///< [IN] Number of samples to generate
+    uint32_t  sampleRate,   ///< [IN] Sample frequency in Hertz
+    uint32_t  firstSample,  ///< [IN] Index of the first sample since the start of the tone
+    uint32_t  lowFreq,      ///< [IN] Frequency of the first tone in Hertz
+    uint32_t  highFreq      ///< [IN] Frequency of the second tone in Hertz
+)
+{
+    uint32_t step1;
+    uint32_t step2;
+    uint32_t i;
+
+    if (0 == sampleRate)
+    {
+        memset(bufPtr, 0, sampleCount * sizeof(int16_t));
+        return;
+    }
+
+    lowFreq %= sampleRate;
+    highFreq %= sampleRate;
+    step1 = (uint32_t)((((uint64_t)lowFreq << 32) + sampleRate / 2) / sampleRate);
+    step2 = (uint32_t)((((uint64_t)highFreq << 32) + sampleRate / 2) / sampleRate);
+
+    for (i = 0; i < sampleCount; i += GENERATE_BLOCK_SIZE)
+    {
+        uint32_t count = sampleCount - i;
+
+        if (count > GENERATE_BLOCK_SIZE)
+        {
+            count = GENERATE_BLOCK_SIZE;
+        }
+
+        GenerateBlock(bufPtr + i,
+                      count,
+                      GetPhase(lowFreq, sampleRate, firstSample + i),
+                      step1,
+                      GetPhase(highFreq, sampleRate, firstSample + i),
+                      step2);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a DTMF detector.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_dtmf_InitDetector
+(
+    le_dtmf_Detector_t* detectorPtr,    ///< [IN] DTMF detector
+    uint32_t            sampleRate      ///< [IN] Sample frequency in Hertz
+)
+{
+    uint32_t i;
+
+    memset(detectorPtr, 0, sizeof(le_dtmf_Detector_t));
+
+    detectorPtr->sampleRate = sampleRate;
+    detectorPtr->blockSize = (uint64_t)sampleRate * DETECT_BLOCK_SIZE_8KHZ / 8000;
+    if (0 == detectorPtr->blockSize)
+    {
+        detectorPtr->blockSize = DETECT_BLOCK_SIZE_8KHZ;
+    }
+
+    for (i = 0; i < LE_DTMF_FREQ_COUNT; i++)
+    {
+        detectorPtr->coef[i] = (sampleRate ? 2 * cos(2 * PI * DtmfFreqs[i] / sampleRate) : 0);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Feed 16-bit samples to a DTMF detector.
+ *
+ * A digit is returned once, when it has been present in two consecutive blocks. The same digit
+ * is returned again only after a block without any digit.
+ *
+ * @return Number of digits detected in these samples.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_dtmf_Detect
+(
+    le_dtmf_Detector_t* detectorPtr,    ///< [IN] DTMF detector
+    const int16_t*      samplesPtr,     ///< [IN] Samples
+    uint32_t            sampleCount,    ///< [IN] Number of samples
+    uint32_t            stride,         ///< [IN] Distance between two samples, e.g. the number
+                                        ///<      of channels for interleaved samples
+    char*               digitsPtr,      ///< [OUT] Digits detected
+    uint32_t            digitsSize      ///< [IN] Size of the digits buffer
+)
+{
+    uint32_t digitCount = 0;
+    uint32_t i;
+    uint32_t k;
+
+    if (0 == stride)
+    {
+        stride = 1;
+    }
+
+    for (i = 0; i < sampleCount; i++)
+    {
+        float x = samplesPtr[i * stride];
+
+        detectorPtr->energy += x * x;
+
+        // Independent filters: this loop can be vectorized
+        for (k = 0; k < LE_DTMF_FREQ_COUNT; k++)
+        {
+            float s0 = x + detectorPtr->coef[k] * detectorPtr->s1[k] - detectorPtr->s2[k];
+
+            detectorPtr->s2[k] = detectorPtr->s1[k];
+            detectorPtr->s1[k] = s0;
+        }
+
+        if (++detectorPtr->sampleCount < detectorPtr->blockSize)
+        {
+            continue;
+        }
+
+        char digit = AnalyzeBlock(detectorPtr);
+
+        if ('\0' == digit)
+        {
+            detectorPtr->digit = '\0';
+        }
+        else if ((digit == detectorPtr->candidate) && (digit != detectorPtr->digit))
+        {
+            detectorPtr->digit = digit;
+
+            if (digitCount < digitsSize)
+            {
+                digitsPtr[digitCount++] = digit;
+            }
+            else
+            {
+                LE_WARN("Digit '%c' dropped", digit);
+            }
+        }
+        detectorPtr->candidate = digit;
+
+        detectorPtr->sampleCount = 0;
+        detectorPtr->energy = 0;
+        memset(detectorPtr->s1, 0, sizeof(detectorPtr->s1));
+        memset(detectorPtr->s2, 0, sizeof(detectorPtr->s2));
+    }
+
+    return digitCount;
+}
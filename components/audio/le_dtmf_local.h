@@ -0,0 +1,101 @@
+/** @file le_dtmf_local.h
+ *
+ * DTMF generation and detection on PCM samples.
+ *
+ * Tones are synthesized from a sine table with linear interpolation, and the phase of each tone
+ * is recomputed exactly every few hundred samples so that long tones do not drift.  Digits are
+ * detected with the Goertzel algorithm, evaluated on blocks of about 25 ms.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_LEDTMFLOCAL_INCLUDE_GUARD
+#define LEGATO_LEDTMFLOCAL_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of DTMF frequencies: 4 row (low) frequencies and 4 column (high) frequencies.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_DTMF_FREQ_COUNT  8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * DTMF detector state.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct le_dtmf_Detector
+{
+    uint32_t sampleRate;                    ///< Sample frequency in Hertz
+    uint32_t blockSize;                     ///< Number of samples of a Goertzel block
+    uint32_t sampleCount;                   ///< Number of samples in the current block
+    float    coef[LE_DTMF_FREQ_COUNT];      ///< Goertzel coefficients, 2*cos(2*PI*freq/rate)
+    float    s1[LE_DTMF_FREQ_COUNT];        ///< Goertzel state, previous output
+    float    s2[LE_DTMF_FREQ_COUNT];        ///< Goertzel state, output before the previous one
+    float    energy;                        ///< Energy of the current block
+    char     candidate;                     ///< Digit found in the previous block, or '\0'
+    char     digit;                         ///< Digit currently detected, or '\0'
+}
+le_dtmf_Detector_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the DTMF module. Must be called once before generating tones.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_dtmf_Init
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate 16-bit samples of a dual tone. A frequency of 0 generates silence for that tone.
+ *
+ * Samples are numbered from the start of the tone, so a long tone can be generated by
+ * successive calls with increasing firstSample.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_dtmf_Generate
+(
+    int16_t*  bufPtr,       ///< [OUT] Samples buffer
+    uint32_t  sampleCount,  ///< [IN] Number of samples to generate
+    uint32_t  sampleRate,   ///< [IN] Sample frequency in Hertz
+    uint32_t  firstSample,  ///< [IN] Index of the first sample since the start of the tone
+    uint32_t  lowFreq,      ///< [IN] Frequency of the first tone in Hertz
+    uint32_t  highFreq      ///< [IN] Frequency of the second tone in Hertz
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize a DTMF detector.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_dtmf_InitDetector
+(
+    le_dtmf_Detector_t* detectorPtr,    ///< [IN] DTMF detector
+    uint32_t            sampleRate      ///< [IN] Sample frequency in Hertz
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Feed 16-bit samples to a DTMF detector.
+ *
+ * A digit is returned once, when it has been present in two consecutive blocks. The same digit
+ * is returned again only after a block without any digit.
+ *
+ * @return Number of digits detected in these samples.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t le_dtmf_Detect
+(
+    le_dtmf_Detector_t* detectorPtr,    ///< [IN] DTMF detector
+    const int16_t*      samplesPtr,     ///< [IN] Samples
+    uint32_t            sampleCount,    ///< [IN] Number of samples
+    uint32_t            stride,         ///< [IN] Distance between two samples, e.g. the number
+                                        ///<      of channels for interleaved samples
+    char*               digitsPtr,      ///< [OUT] Digits detected
+    uint32_t            digitsSize      ///< [IN] Size of the digits buffer
+);
+
+#endif // LEGATO_LEDTMFLOCAL_INCLUDE_GUARD
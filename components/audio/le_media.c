@@ -15,7 +15,8 @@
 #include "pa_audio.h"
 #include "pa_amr.h"
 #include "pa_pcm.h"
-#include <math.h>
+#include "le_dtmf_local.h"
+#include <sys/ioctl.h>
 
 //--------------------------------------------------------------------------------------------------
 // Symbol and Enum definitions.
@@ -28,17 +29,6 @@
 //--------------------------------------------------------------------------------------------------
 #define STRING_LEN    30
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Values used for DTMF sampling.
- */
-//--------------------------------------------------------------------------------------------------
-#define SAMPLE_SCALE    (32767)
-#define DTMF_AMPLITUDE  (40)
-#if !defined (PI)
-#define PI 3.14159265358979323846264338327
-#endif
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Symbols used to populate wave header file.
@@ -57,6 +47,32 @@
 //--------------------------------------------------------------------------------------------------
 #define NO_MORE_SAMPLES_INFINITE_TIMEOUT -1
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default number of bytes moved by the media thread in one transfer.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef MEDIA_DEFAULT_BUFFER_SIZE
+#define MEDIA_DEFAULT_BUFFER_SIZE   (PIPE_BUF/4)
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Default capacity of the media pipes in bytes, 0 for the system default.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef MEDIA_DEFAULT_PIPE_SIZE
+#define MEDIA_DEFAULT_PIPE_SIZE     0
+#endif
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Bounds of the media thread transfer size. The transfer buffer comes from MediaBufferPool.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MEDIA_MIN_BUFFER_SIZE       256
+#define MEDIA_MAX_BUFFER_SIZE       (64*1024)
+
 //--------------------------------------------------------------------------------------------------
 // Data structures.
 //--------------------------------------------------------------------------------------------------
@@ -160,6 +176,20 @@ static le_mem_PoolRef_t MediaThreadContextPool;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t PcmThreadContextPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the DTMF detectors of the capture streams
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DtmfDetectorPool;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The memory pool for the buffers the media threads copy the data through
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t MediaBufferPool;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Wake Lock for audio streams
@@ -168,6 +198,20 @@ static le_mem_PoolRef_t PcmThreadContextPool;
 //--------------------------------------------------------------------------------------------------
 static le_pm_WakeupSourceRef_t MediaWakeLock;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Streaming configuration of the next started streams
+ */
+//--------------------------------------------------------------------------------------------------
+static le_media_StreamingConfig_t StreamingConfig =
+{
+    .bufferSize = MEDIA_DEFAULT_BUFFER_SIZE,
+    .pipeSize = MEDIA_DEFAULT_PIPE_SIZE,
+    .periodSize = 0,
+    .periodsCount = 0,
+    .useSplice = true
+};
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Reads a specified number of bytes from the provided file descriptor into the provided buffer.
@@ -287,6 +331,91 @@ static ssize_t WriteFd
     return tempBufSize;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves up to a specified number of bytes from a file descriptor to another one without copying
+ * them to user space. One of the file descriptors must be a pipe. This function blocks until some
+ * bytes are moved or an EOF is reached.
+ *
+ * @return
+ *      Number of bytes moved, 0 at EOF.
+ *      -1 if there is an error, errno is set to EINVAL if these file descriptors cannot be spliced.
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t SpliceFd
+(
+    int fdIn,                             ///<[IN] File to read.
+    int fdOut,                            ///<[IN] File to write.
+    size_t size                           ///<[IN] Maximum number of bytes to move.
+)
+{
+    ssize_t len;
+
+    do
+    {
+        len = splice(fdIn, NULL, fdOut, NULL, size, SPLICE_F_MOVE | SPLICE_F_MORE);
+
+        if ((len < 0) && (errno == EAGAIN))
+        {
+            // Non-blocking file descriptors: wait until both ends are ready. Both are polled at
+            // once, and an end that is ready is left out of the next poll (negative fds are
+            // ignored) so that waiting on the other one does not spin.
+            struct pollfd pfd[2] = { { .fd = fdIn, .events = POLLIN },
+                                     { .fd = fdOut, .events = POLLOUT } };
+
+            while (((pfd[0].fd >= 0) || (pfd[1].fd >= 0)) && (poll(pfd, 2, -1) > 0))
+            {
+                if (pfd[0].revents)
+                {
+                    pfd[0].fd = -1;
+                }
+                if (pfd[1].revents)
+                {
+                    pfd[1].fd = -1;
+                }
+            }
+        }
+    }
+    while ((len < 0) && ((errno == EINTR) || (errno == EAGAIN)));
+
+    return len;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the capacity of a pipe according to the streaming configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetPipeSize
+(
+    int fd                                ///<[IN] Pipe.
+)
+{
+    if (StreamingConfig.pipeSize &&
+        (fcntl(fd, F_SETPIPE_SZ, StreamingConfig.pipeSize) == -1))
+    {
+        LE_WARN("Cannot set pipe size to %u, errno %d (%m)", StreamingConfig.pipeSize, errno);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the streaming statistics of a stream.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetStreamStats
+(
+    le_audio_Stream_t* streamPtr          ///<[IN] Stream object.
+)
+{
+    // The counters are updated by the media and PCM threads: use atomic accesses so that a 64-bit
+    // counter is never torn on 32-bit targets.
+    __atomic_store_n(&streamPtr->stats.underrunCount, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&streamPtr->stats.overrunCount, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&streamPtr->stats.splicedBytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&streamPtr->stats.copiedBytes, 0, __ATOMIC_RELAXED);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Return the low frequency component of a DTMF character.
@@ -381,34 +510,6 @@ static inline uint32_t Digit2HighFreq
     }
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- *  Add two 16-bit values.
- *
- */
-//--------------------------------------------------------------------------------------------------
-static inline int16_t SaturateAdd16
-(
-    int32_t a,
-    int32_t b
-)
-{
-    int32_t tot=a+b;
-
-    if (tot > 32767)
-    {
-        return 32767;
-    }
-    else if (tot < -32768)
-    {
-        return -32768;
-    }
-    else
-    {
-        return (tot & 0xFFFF);
-    }
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  *  Play Tone function. This function split into samples of 1s. To play a DTMF or a PAUSE for a
@@ -423,9 +524,6 @@ static le_result_t PlayTone
     uint32_t*                      bufferLenPtr  ///< [OUT] Length of the buffer
 )
 {
-    double   d1, d2;
-    uint32_t i;
-
     DtmfParams_t*  dtmfParamsPtr = (DtmfParams_t*) mediaCtxPtr->codecParams;
     // Max samples on the whole duration
     uint32_t samplesCount;
@@ -433,8 +531,6 @@ static le_result_t PlayTone
     uint32_t sampleOneSecond = dtmfParamsPtr->sampleRate + dtmfParamsPtr->currentSampleCount;
     uint32_t freq1;
     uint32_t freq2;
-    int32_t  amp1;
-    int32_t  amp2;
     int16_t* dataPtr = (int16_t*) bufferOutPtr;
     // Length of the current sample: max 1 second, i.e, sampleRate
     uint32_t sampleLength;
@@ -490,26 +586,16 @@ static le_result_t PlayTone
 
         freq1 = Digit2LowFreq(dtmfParamsPtr->dtmf[dtmfParamsPtr->currentDtmf]);
         freq2 = Digit2HighFreq(dtmfParamsPtr->dtmf[dtmfParamsPtr->currentDtmf]);
-        amp1 = DTMF_AMPLITUDE;
-        amp2 = DTMF_AMPLITUDE;
 
-        d1 = 1.0f * freq1 / dtmfParamsPtr->sampleRate;
-        d2 = 1.0f * freq2 / dtmfParamsPtr->sampleRate;
+        le_dtmf_Generate(dataPtr, sampleLength, dtmfParamsPtr->sampleRate,
+                         dtmfParamsPtr->currentSampleCount, freq1, freq2);
 
-        for (i = dtmfParamsPtr->currentSampleCount;
-             // Play max sampleRate (1s) of DTMF and continue at next call
-             (i < sampleOneSecond) && (i < samplesCount);
-             i++)
+        // Save the current sample count. If the whole DTMF is played, reset to 0
+        dtmfParamsPtr->currentSampleCount += sampleLength;
+        if (dtmfParamsPtr->currentSampleCount >= samplesCount)
         {
-            int16_t s1, s2;
-
-            s1 = (int16_t)(SAMPLE_SCALE * amp1 / 100.0f * sin(2 * PI * d1 * i));
-            s2 = (int16_t)(SAMPLE_SCALE * amp2 / 100.0f * sin(2 * PI * d2 * i));
-            *(dataPtr++) = SaturateAdd16(s1, s2);
+            dtmfParamsPtr->currentSampleCount = 0;
         }
-
-        // Save the current sample count. If the whole DTMF is played, reset to 0
-        dtmfParamsPtr->currentSampleCount = (i == samplesCount ? 0 : i);
         if (0 == dtmfParamsPtr->currentSampleCount)
         {
             // Update the index of DTMF if the current sample count is reset to 0
@@ -620,6 +706,40 @@ static le_result_t MediaWriteFd
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move data from a file descriptor to another one without copy.
+ *
+ * @return LE_OK            Data moved, or EOF reached
+ * @return LE_UNSUPPORTED   The file descriptors cannot be spliced
+ * @return LE_FAULT         The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MediaSpliceFd
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr,     ///< [IN] Media thread context
+    uint32_t*                      lenPtr           ///< [OUT] Length of the moved data
+)
+{
+    ssize_t size = SpliceFd(mediaCtxPtr->fd_in, mediaCtxPtr->fd_out, mediaCtxPtr->bufferSize);
+
+    if (size < 0)
+    {
+        if (errno == EINVAL)
+        {
+            return LE_UNSUPPORTED;
+        }
+
+        LE_ERROR("Splice error fd_in=%d fd_out=%d, errno %d (%m)",
+                 mediaCtxPtr->fd_in, mediaCtxPtr->fd_out, errno);
+        return LE_FAULT;
+    }
+
+    *lenPtr = size;
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Write on a file descriptor with AMR encoding.
@@ -661,33 +781,19 @@ static le_result_t AmrWriteFd
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write on a file descriptor a WAV audio file.
+ * Update the sizes of the WAV header after new samples have been written to the file.
  *
+ * The write position of the file is restored at the end of the samples.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t WavWriteFd
+static le_result_t UpdateWavHeader
 (
     le_audio_MediaThreadContext_t* mediaCtxPtr,  ///< [IN] Media thread context
-    uint8_t*                       bufferInPtr,  ///< [IN] Decoding samples buffer input
-    uint32_t                       bufferLen     ///< [IN] Buffer length
+    uint32_t                       len           ///< [IN] Length of the new samples
 )
 {
     WavHeader_t hdr;
     WavParams_t* wavParamPtr =  (WavParams_t*) mediaCtxPtr->codecParams;
-    int oldstate = PTHREAD_CANCEL_ENABLE, dummy = PTHREAD_CANCEL_ENABLE;
-
-    // This function is set to no cancelable to avoid desynchronisation between the data and the
-    // header
-    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate);
-
-    int32_t len = WriteFd(mediaCtxPtr->fd_out, bufferInPtr, bufferLen);
-
-    if (len != bufferLen)
-    {
-        LE_ERROR("write error: %d written, expected %d, errno %d", len, bufferLen, errno);
-        pthread_setcancelstate(oldstate, &dummy);
-        return LE_FAULT;
-    }
 
     wavParamPtr->recordingSize += len;
 
@@ -700,7 +806,6 @@ static le_result_t WavWriteFd
     if (len != sizeof(wavParamPtr->recordingSize))
     {
         LE_ERROR("read error: %d written, errno %d", len, errno);
-        pthread_setcancelstate(oldstate, &dummy);
         return LE_FAULT;
     }
 
@@ -713,15 +818,85 @@ static le_result_t WavWriteFd
     if (len != sizeof(riffSize))
     {
         LE_ERROR("read error: %d written, errno %d", len, errno);
-        pthread_setcancelstate(oldstate, &dummy);
         return LE_FAULT;
     }
 
     lseek(mediaCtxPtr->fd_out, sizeof(WavHeader_t)+wavParamPtr->recordingSize, SEEK_SET);
 
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write on a file descriptor a WAV audio file.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WavWriteFd
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr,  ///< [IN] Media thread context
+    uint8_t*                       bufferInPtr,  ///< [IN] Decoding samples buffer input
+    uint32_t                       bufferLen     ///< [IN] Buffer length
+)
+{
+    le_result_t res;
+    int oldstate = PTHREAD_CANCEL_ENABLE, dummy = PTHREAD_CANCEL_ENABLE;
+
+    // This function is set to no cancelable to avoid desynchronisation between the data and the
+    // header
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate);
+
+    int32_t len = WriteFd(mediaCtxPtr->fd_out, bufferInPtr, bufferLen);
+
+    if (len != bufferLen)
+    {
+        LE_ERROR("write error: %d written, expected %d, errno %d", len, bufferLen, errno);
+        pthread_setcancelstate(oldstate, &dummy);
+        return LE_FAULT;
+    }
+
+    res = UpdateWavHeader(mediaCtxPtr, len);
+
     pthread_setcancelstate(oldstate, &dummy);
 
-    return LE_OK;
+    return res;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the captured samples to a WAV audio file without copy.
+ *
+ * @return LE_OK            Data moved, or EOF reached
+ * @return LE_UNSUPPORTED   The file descriptors cannot be spliced
+ * @return LE_FAULT         The function failed
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WavSpliceFd
+(
+    le_audio_MediaThreadContext_t* mediaCtxPtr,  ///< [IN] Media thread context
+    uint32_t*                      lenPtr        ///< [OUT] Length of the moved data
+)
+{
+    le_result_t res;
+    int oldstate = PTHREAD_CANCEL_ENABLE, dummy = PTHREAD_CANCEL_ENABLE;
+    struct pollfd pfd = { .fd = mediaCtxPtr->fd_in, .events = POLLIN };
+
+    // Wait for samples while the thread can be cancelled, then move them and update the header
+    // atomically
+    while ((poll(&pfd, 1, -1) < 0) && (errno == EINTR));
+
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate);
+
+    res = MediaSpliceFd(mediaCtxPtr, lenPtr);
+
+    if ((LE_OK == res) && *lenPtr)
+    {
+        res = UpdateWavHeader(mediaCtxPtr, *lenPtr);
+    }
+
+    pthread_setcancelstate(oldstate, &dummy);
+
+    return res;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -760,7 +935,7 @@ static le_result_t InitPlayWavFile
         return LE_FAULT;
     }
 
-    mediaCtxPtr->bufferSize = PIPE_BUF/4;
+    mediaCtxPtr->bufferSize = StreamingConfig.bufferSize;
 
     return LE_OK;
 }
@@ -780,7 +955,7 @@ static le_result_t InitRecWavFile
     SetWavHeader(mediaCtxPtr->fd_out, &(streamPtr->samplePcmConfig));
 
     mediaCtxPtr->format = LE_AUDIO_FILE_WAVE;
-    mediaCtxPtr->bufferSize = 1024;
+    mediaCtxPtr->bufferSize = StreamingConfig.bufferSize;
 
     return LE_OK;
 }
@@ -840,6 +1015,11 @@ static void DestroyMediaThread
             le_sem_Delete(mediaCtxPtr->threadSemaphore);
         }
 
+        if (mediaCtxPtr->bufferPtr)
+        {
+            le_mem_Release(mediaCtxPtr->bufferPtr);
+        }
+
         le_mem_Release(mediaCtxPtr);
         streamPtr->mediaThreadContextPtr = NULL;
     }
@@ -858,9 +1038,10 @@ static void* MediaThread
 )
 {
     le_audio_MediaThreadContext_t * mediaCtxPtr = (le_audio_MediaThreadContext_t *) contextPtr;
-    uint8_t outBuffer[mediaCtxPtr->bufferSize];
+    le_audio_StreamStats_t* statsPtr = &mediaCtxPtr->streamPtr->stats;
     uint32_t readLen = 0;
     bool semPost = false;
+    le_result_t res;
 
     LE_DEBUG("MediaThread");
 
@@ -870,33 +1051,66 @@ static void* MediaThread
         return NULL;
     }
 
+    if (mediaCtxPtr->bufferSize > MEDIA_MAX_BUFFER_SIZE)
+    {
+        LE_ERROR("Buffer size %u too large", mediaCtxPtr->bufferSize);
+        return NULL;
+    }
+
     while (1)
     {
-        memset(outBuffer,0,mediaCtxPtr->bufferSize);
+        if (mediaCtxPtr->spliceFunc)
+        {
+            /* move the packet without copy */
+            res = mediaCtxPtr->spliceFunc(mediaCtxPtr, &readLen);
+
+            if (LE_UNSUPPORTED == res)
+            {
+                LE_INFO("Cannot splice fd_in %d to fd_out %d, copy the data",
+                        mediaCtxPtr->fd_in, mediaCtxPtr->fd_out);
+                mediaCtxPtr->spliceFunc = NULL;
+                continue;
+            }
+            else if ((LE_OK != res) || !readLen)
+            {
+                break;
+            }
 
-        /* read/decode the packet */
-        if ( ( mediaCtxPtr->readFunc( mediaCtxPtr,
-                                      outBuffer,
-                                      &readLen ) == LE_OK ) && readLen )
+            __atomic_fetch_add(&statsPtr->splicedBytes, readLen, __ATOMIC_RELAXED);
+        }
+        else
         {
-            if ( mediaCtxPtr->writeFunc( mediaCtxPtr,
-                                         outBuffer,
-                                         readLen ) != LE_OK )
+            // The buffer is only needed when the data is copied. It is released when the thread
+            // is destroyed, as the thread can be cancelled at any point.
+            if (!mediaCtxPtr->bufferPtr)
+            {
+                mediaCtxPtr->bufferPtr = le_mem_ForceAlloc(MediaBufferPool);
+            }
+
+            memset(mediaCtxPtr->bufferPtr,0,mediaCtxPtr->bufferSize);
+
+            /* read/decode the packet */
+            if ( ( mediaCtxPtr->readFunc( mediaCtxPtr,
+                                          mediaCtxPtr->bufferPtr,
+                                          &readLen ) != LE_OK ) || !readLen )
             {
                 break;
             }
-            else
+
+            if ( mediaCtxPtr->writeFunc( mediaCtxPtr,
+                                         mediaCtxPtr->bufferPtr,
+                                         readLen ) != LE_OK )
             {
-                if (mediaCtxPtr->threadSemaphore && !semPost)
-                {
-                    le_sem_Post(mediaCtxPtr->threadSemaphore);
-                    semPost = true;
-                }
+                break;
             }
+
+            __atomic_fetch_add(&statsPtr->copiedBytes, readLen, __ATOMIC_RELAXED);
         }
-        else
+
+        if (mediaCtxPtr->threadSemaphore && !semPost)
         {
-            break;
+            le_sem_Post(mediaCtxPtr->threadSemaphore);
+            semPost = true;
         }
     }
 
@@ -937,6 +1151,12 @@ static le_result_t InitMediaThread
     mediaCtxPtr->fd_in = fd_in;
     mediaCtxPtr->fd_out = fd_out;
     mediaCtxPtr->format = format;
+    mediaCtxPtr->streamPtr = streamPtr;
+
+    if (!StreamingConfig.useSplice)
+    {
+        mediaCtxPtr->spliceFunc = NULL;
+    }
 
     if ( mediaCtxPtr->initFunc &&
         (mediaCtxPtr->initFunc ( streamPtr,
@@ -1030,6 +1250,7 @@ static le_result_t PlayWavFile
     mediaContextPtr->readFunc = MediaReadFd;
     mediaContextPtr->writeFunc = MediaWriteFd;
     mediaContextPtr->closeFunc = ReleaseCodecParams;
+    mediaContextPtr->spliceFunc = MediaSpliceFd;
 
     *formatPtr = LE_AUDIO_FILE_WAVE;
 
@@ -1234,6 +1455,7 @@ static le_result_t RecordWavFile
     mediaCtxPtr->readFunc = MediaReadFd;
     mediaCtxPtr->writeFunc = WavWriteFd;
     mediaCtxPtr->closeFunc = ReleaseCodecParams;
+    mediaCtxPtr->spliceFunc = WavSpliceFd;
     *formatPtr = LE_AUDIO_FILE_WAVE;
 
     return LE_OK;
@@ -1454,6 +1676,7 @@ static le_result_t GetPlaybackFrames
             case 0:
                 // timeout: no data read
                 LE_DEBUG("No data read");
+                __atomic_fetch_add(&streamPtr->stats.underrunCount, 1, __ATOMIC_RELAXED);
                 if (!amount)
                 {
                     // no more samples available at this point:
@@ -1514,6 +1737,94 @@ static le_result_t GetPlaybackFrames
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a DTMF detected on a capture stream. This function is queued to the main thread with the
+ * stream reference, as the stream may have been closed since the DTMF was detected.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportDtmf
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    le_audio_Stream_t*     streamPtr = le_audio_LookupStream(param1Ptr);
+    le_audio_StreamEvent_t streamEvent;
+
+    // The stream may have been closed, or the detection disabled, since the DTMF was detected
+    if ((NULL == streamPtr) || !__atomic_load_n(&streamPtr->dtmfDetection, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    streamEvent.streamPtr = streamPtr;
+    streamEvent.streamEvent = LE_AUDIO_BITMASK_DTMF_DETECTION;
+    streamEvent.event.dtmf = (char)(intptr_t)param2Ptr;
+
+    LE_DEBUG("DTMF '%c' detected", streamEvent.event.dtmf);
+
+    le_event_Report(streamPtr->streamEventId,
+                    &streamEvent,
+                    sizeof(le_audio_StreamEvent_t));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Detect DTMF on captured frames. The detector is created when the detection is enabled on the
+ * stream, and released when it is disabled.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void DetectDtmf
+(
+    le_audio_Stream_t* streamPtr,
+    uint8_t*           bufferPtr,
+    uint32_t           bufsize
+)
+{
+    le_audio_PcmContext_t* pcmContextPtr = streamPtr->pcmContextPtr;
+    uint32_t channelsCount = pcmContextPtr->pcmConfig.channelsCount;
+    char     digits[8];
+    uint32_t digitCount;
+    uint32_t i;
+
+    if (!__atomic_load_n(&streamPtr->dtmfDetection, __ATOMIC_RELAXED) ||
+        (16 != pcmContextPtr->pcmConfig.bitsPerSample) ||
+        (0 == channelsCount))
+    {
+        if (pcmContextPtr->dtmfDetectorPtr)
+        {
+            le_mem_Release(pcmContextPtr->dtmfDetectorPtr);
+            pcmContextPtr->dtmfDetectorPtr = NULL;
+        }
+        return;
+    }
+
+    if (!pcmContextPtr->dtmfDetectorPtr)
+    {
+        pcmContextPtr->dtmfDetectorPtr = le_mem_ForceAlloc(DtmfDetectorPool);
+        le_dtmf_InitDetector(pcmContextPtr->dtmfDetectorPtr, pcmContextPtr->pcmConfig.sampleRate);
+    }
+
+    // Only the first channel is analyzed
+    digitCount = le_dtmf_Detect(pcmContextPtr->dtmfDetectorPtr,
+                                (const int16_t*) bufferPtr,
+                                bufsize / (sizeof(int16_t) * channelsCount),
+                                channelsCount,
+                                digits,
+                                sizeof(digits));
+
+    for (i = 0; i < digitCount; i++)
+    {
+        le_event_QueueFunctionToThread(pcmContextPtr->mainThreadRef,
+                                       ReportDtmf,
+                                       streamPtr->streamRef,
+                                       (void*)(intptr_t)digits[i]);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set capture frames
@@ -1530,8 +1841,21 @@ static le_result_t SetCaptureFrames
     le_audio_Stream_t*     streamPtr = contextPtr;
     le_audio_PcmContext_t* pcmContextPtr = streamPtr->pcmContextPtr;
 
+    DetectDtmf(streamPtr, bufferPtr, *bufsizePtr);
+
     if ( !pcmContextPtr->pause )
     {
+        int queued = 0;
+
+        // The reader is late if these frames do not fit in the pipe: the capture is blocked until
+        // it catches up
+        if (pcmContextPtr->pipeSize &&
+            (ioctl(pcmContextPtr->fd, FIONREAD, &queued) == 0) &&
+            ((queued + *bufsizePtr) > pcmContextPtr->pipeSize))
+        {
+            __atomic_fetch_add(&streamPtr->stats.overrunCount, 1, __ATOMIC_RELAXED);
+        }
+
         if (WriteFd(pcmContextPtr->fd, bufferPtr, *bufsizePtr) < 0)
         {
             LE_ERROR("Cannot write on pipe");
@@ -1679,6 +2003,9 @@ le_result_t le_media_PlayDtmf
         return LE_FAULT;
     }
 
+    SetPipeSize(pipefd[1]);
+    ResetStreamStats(streamPtr);
+
     mediaCtxPtr->fd_arg = streamPtr->fd;
     mediaCtxPtr->fd_pipe_input = pipefd[1];
     mediaCtxPtr->fd_pipe_output = pipefd[0];
@@ -1754,6 +2081,9 @@ le_result_t le_media_Open
                     return LE_FAULT;
                 }
 
+                SetPipeSize(pipefd[1]);
+                ResetStreamStats(streamPtr);
+
                 mediaCtxPtr->fd_arg = streamPtr->fd;
                 mediaCtxPtr->fd_pipe_input = pipefd[1];
                 mediaCtxPtr->fd_pipe_output = pipefd[0];
@@ -1814,6 +2144,9 @@ le_result_t le_media_Open
                     return LE_FAULT;
                 }
 
+                SetPipeSize(pipefd[1]);
+                ResetStreamStats(streamPtr);
+
                 mediaCtxPtr->fd_arg = streamPtr->fd;
                 mediaCtxPtr->fd_pipe_input = pipefd[1];
                 mediaCtxPtr->fd_pipe_output = pipefd[0];
@@ -1888,6 +2221,15 @@ le_result_t le_media_PlaySamples
                                       samplePcmConfigPtr->bitsPerSample  ) / 8;
 
     memcpy(&(pcmContextPtr->pcmConfig), samplePcmConfigPtr, sizeof(le_audio_SamplePcmConfig_t));
+    pcmContextPtr->pcmConfig.periodSize = StreamingConfig.periodSize;
+    pcmContextPtr->pcmConfig.periodsCount = StreamingConfig.periodsCount;
+
+    // Samples played or captured without media thread: the statistics were not reset by
+    // le_media_Open()
+    if (!streamPtr->mediaThreadContextPtr)
+    {
+        ResetStreamStats(streamPtr);
+    }
 
     pcmContextPtr->mainThreadRef = le_thread_GetCurrent();
     pcmContextPtr->interface = streamPtr->audioInterface;
@@ -2111,8 +2453,14 @@ le_result_t le_media_Stop
         {
             if (streamPtr->pcmContextPtr)
             {
-                LE_DEBUG("Close pa_pcm");
+                LE_DEBUG("Close pa_pcm: %u underruns, %u overruns",
+                         __atomic_load_n(&streamPtr->stats.underrunCount, __ATOMIC_RELAXED),
+                         __atomic_load_n(&streamPtr->stats.overrunCount, __ATOMIC_RELAXED));
                 pa_pcm_Close(streamPtr->pcmContextPtr->pcmHandle);
+                if (streamPtr->pcmContextPtr->dtmfDetectorPtr)
+                {
+                    le_mem_Release(streamPtr->pcmContextPtr->dtmfDetectorPtr);
+                }
                 le_mem_Release(streamPtr->pcmContextPtr);
                 streamPtr->pcmContextPtr = NULL;
             }
@@ -2182,12 +2530,28 @@ le_result_t le_media_Capture
                                     samplePcmConfigPtr->bitsPerSample) / 8;
 
     memcpy(&(pcmContextPtr->pcmConfig), samplePcmConfigPtr, sizeof(le_audio_SamplePcmConfig_t));
+    pcmContextPtr->pcmConfig.periodSize = StreamingConfig.periodSize;
+    pcmContextPtr->pcmConfig.periodsCount = StreamingConfig.periodsCount;
+
+    // Samples played or captured without media thread: the statistics were not reset by
+    // le_media_Open()
+    if (!streamPtr->mediaThreadContextPtr)
+    {
+        ResetStreamStats(streamPtr);
+    }
 
     pcmContextPtr->mainThreadRef = le_thread_GetCurrent();
     pcmContextPtr->interface = streamPtr->audioInterface;
     pcmContextPtr->pause = false;
     streamPtr->pcmContextPtr = pcmContextPtr;
 
+    // Capacity of the capture pipe, to count the overruns
+    pcmContextPtr->pipeSize = fcntl(pcmContextPtr->fd, F_GETPIPE_SZ);
+    if (pcmContextPtr->pipeSize < 0)
+    {
+        pcmContextPtr->pipeSize = 0;
+    }
+
     char deviceString[STRING_LEN];
     snprintf(deviceString,sizeof(deviceString),"hw:0,%d", streamPtr->hwDeviceId);
     LE_DEBUG("Hardware interface: %s", deviceString);
@@ -2275,6 +2639,88 @@ void le_media_Init
     PcmThreadContextPool = le_mem_CreatePool("PcmThreadContextPool",
                                                                sizeof(le_audio_PcmContext_t));
 
+    // Allocate the DTMF detectors pool.
+    DtmfDetectorPool = le_mem_CreatePool("DtmfDetectorPool", sizeof(le_dtmf_Detector_t));
+
+    // Allocate the media buffers pool.
+    MediaBufferPool = le_mem_CreatePool("MediaBufferPool", MEDIA_MAX_BUFFER_SIZE);
+
+    // Build the tables used to generate the DTMF.
+    le_dtmf_Init();
+
     // Create a Wakeup source for Media
     MediaWakeLock = le_pm_NewWakeupSource( LE_PM_REF_COUNT, "MediaStream" );
 }
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the streaming configuration.
+ *
+ * @return LE_OK            The configuration is set
+ * @return LE_OUT_OF_RANGE  The buffer size is out of range
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_media_SetStreamingConfig
+(
+    const le_media_StreamingConfig_t* configPtr     ///< [IN] Streaming configuration
+)
+{
+    if ((configPtr->bufferSize < MEDIA_MIN_BUFFER_SIZE) ||
+        (configPtr->bufferSize > MEDIA_MAX_BUFFER_SIZE))
+    {
+        LE_ERROR("Buffer size %u out of range [%u, %u]", configPtr->bufferSize,
+                 MEDIA_MIN_BUFFER_SIZE, MEDIA_MAX_BUFFER_SIZE);
+        return LE_OUT_OF_RANGE;
+    }
+
+    StreamingConfig = *configPtr;
+
+    LE_DEBUG("bufferSize %u pipeSize %u periodSize %u periodsCount %u useSplice %d",
+             StreamingConfig.bufferSize, StreamingConfig.pipeSize, StreamingConfig.periodSize,
+             StreamingConfig.periodsCount, StreamingConfig.useSplice);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the streaming configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_media_GetStreamingConfig
+(
+    le_media_StreamingConfig_t* configPtr           ///< [OUT] Streaming configuration
+)
+{
+    *configPtr = StreamingConfig;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the streaming statistics of a stream. The statistics are reset when the playback or the
+ * capture starts.
+ *
+ * @return LE_OK            The function is succeeded
+ * @return LE_BAD_PARAMETER The stream object is NULL
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_media_GetStreamStats
+(
+    le_audio_Stream_t*          streamPtr,          ///< [IN] Stream object
+    le_audio_StreamStats_t*     statsPtr            ///< [OUT] Streaming statistics
+)
+{
+    if (streamPtr == NULL)
+    {
+        LE_ERROR("Bad stream object");
+        return LE_BAD_PARAMETER;
+    }
+
+    // The counters are updated by the media and PCM threads
+    statsPtr->underrunCount = __atomic_load_n(&streamPtr->stats.underrunCount, __ATOMIC_RELAXED);
+    statsPtr->overrunCount = __atomic_load_n(&streamPtr->stats.overrunCount, __ATOMIC_RELAXED);
+    statsPtr->splicedBytes = __atomic_load_n(&streamPtr->stats.splicedBytes, __ATOMIC_RELAXED);
+    statsPtr->copiedBytes = __atomic_load_n(&streamPtr->stats.copiedBytes, __ATOMIC_RELAXED);
+
+    return LE_OK;
+}
@@ -6,6 +6,23 @@
 #ifndef LEGATO_LEMEDIALOCAL_INCLUDE_GUARD
 #define LEGATO_LEMEDIALOCAL_INCLUDE_GUARD
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Streaming configuration, applied to the streams started afterwards.
+ *
+ * A larger buffer or pipe lowers the CPU load and the risk of underrun, at the cost of latency.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t bufferSize;    ///< Bytes moved by the media thread in one transfer
+    uint32_t pipeSize;      ///< Capacity of the media pipes in bytes, 0 for the system default
+    uint32_t periodSize;    ///< PCM period size in frames, 0 for the platform default
+    uint32_t periodsCount;  ///< Number of PCM periods, 0 for the platform default
+    bool     useSplice;     ///< Move WAV data with splice() when the file descriptors allow it
+}
+le_media_StreamingConfig_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function must be called to play a DTMF on a specific audio stream.
@@ -149,5 +166,42 @@ bool le_media_IsStreamBusy
     le_audio_Stream_t*          streamPtr         ///< [IN] Stream object
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the streaming configuration.
+ *
+ * @return LE_OK            The configuration is set
+ * @return LE_OUT_OF_RANGE  The buffer size is out of range
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_media_SetStreamingConfig
+(
+    const le_media_StreamingConfig_t* configPtr     ///< [IN] Streaming configuration
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the streaming configuration.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_media_GetStreamingConfig
+(
+    le_media_StreamingConfig_t* configPtr           ///< [OUT] Streaming configuration
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the streaming statistics of a stream. The statistics are reset when the playback or the
+ * capture starts.
+ *
+ * @return LE_OK            The function is succeeded
+ * @return LE_BAD_PARAMETER The stream object is NULL
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_media_GetStreamStats
+(
+    le_audio_Stream_t*          streamPtr,          ///< [IN] Stream object
+    le_audio_StreamStats_t*     statsPtr            ///< [OUT] Streaming statistics
+);
 
 #endif // LEGATO_LEMEDIALOCAL_INCLUDE_GUARD
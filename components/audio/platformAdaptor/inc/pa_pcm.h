@@ -111,6 +111,8 @@ LE_SHARED uint32_t pa_pcm_GetPeriodSize
 /**
  * Initialize sound driver for PCM capture.
  *
+ * The periodSize and periodsCount fields of the configuration are hints: 0 selects the driver
+ * default.
  */
 //--------------------------------------------------------------------------------------------------
 LE_SHARED le_result_t pa_pcm_InitCapture
@@ -125,6 +127,8 @@ LE_SHARED le_result_t pa_pcm_InitCapture
 /**
  * Initialize sound driver for PCM playback.
  *
+ * The periodSize and periodsCount fields of the configuration are hints: 0 selects the driver
+ * default.
  */
 //--------------------------------------------------------------------------------------------------
 LE_SHARED le_result_t pa_pcm_InitPlayback
@@ -0,0 +1,404 @@
+/**
+ * @file le_gnssBroadcast.c
+ *
+ * Implementation of the GNSS broadcast ring.
+ *
+ * The ring has a single writer, which never waits for the readers.  A record is written as
+ * follows:
+ *  1. claimSeq is set to the sequence number of the record, telling the readers that the slot is
+ *     about to be overwritten;
+ *  2. the data and then the sequence number of the record are written;
+ *  3. writeSeq is increased, publishing the record, and the readers waiting on it are woken up.
+ *
+ * A reader checks that a record is published and still has the expected sequence number before
+ * using it, then checks claimSeq once done with it to know whether the writer started overwriting
+ * it in the meantime.
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "le_gnssBroadcast.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Format of the name of the shared memory object, unlinked as soon as it is created.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SHM_NAME_FORMAT     "/le_gnssBroadcast.%d"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mask giving the index of the record of a sequence number.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_INDEX_MASK   (LE_GNSSBROADCAST_RECORD_COUNT - 1)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Claim the next record of the ring for writing.
+ *
+ * @return
+ *      Pointer to the record.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnssBroadcast_Record_t* ClaimRecord
+(
+    le_gnssBroadcast_Ring_t* ringPtr    ///< [in] Ring.
+)
+{
+    // Only the writer changes writeSeq.
+    uint32_t seq = ringPtr->writeSeq;
+
+    __atomic_store_n(&ringPtr->claimSeq, seq, __ATOMIC_RELAXED);
+
+    // The claim must be visible before any byte of the record changes.
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return &ringPtr->records[seq & RECORD_INDEX_MASK];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Publish the record claimed by ClaimRecord() and wake up the readers waiting for it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PublishRecord
+(
+    le_gnssBroadcast_Ring_t* ringPtr,       ///< [in] Ring.
+    le_gnssBroadcast_Record_t* recordPtr    ///< [in] Record claimed.
+)
+{
+    uint32_t seq = ringPtr->writeSeq;
+
+    recordPtr->reserved = 0;
+    __atomic_store_n(&recordPtr->seq, seq, __ATOMIC_RELEASE);
+    __atomic_store_n(&ringPtr->writeSeq, seq + 1, __ATOMIC_RELEASE);
+
+    syscall(SYS_futex, &ringPtr->writeSeq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a broadcast ring in shared memory.  The shared memory has no name: it can only be
+ * reached through the returned read-only file descriptor, which the writer hands out to readers.
+ *
+ * @return
+ *      - Pointer to the ring, for the writer.
+ *      - NULL on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_gnssBroadcast_Ring_t* le_gnssBroadcast_Create
+(
+    int* readOnlyFdPtr      ///< [out] Read-only file descriptor of the ring.
+)
+{
+    char name[32];
+    le_gnssBroadcast_Ring_t* ringPtr;
+    int fd;
+
+    snprintf(name, sizeof(name), SHM_NAME_FORMAT, getpid());
+
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (-1 == fd)
+    {
+        LE_ERROR("Cannot create shared memory '%s': %m", name);
+        return NULL;
+    }
+
+    *readOnlyFdPtr = shm_open(name, O_RDONLY, 0);
+    shm_unlink(name);
+
+    if (-1 == *readOnlyFdPtr)
+    {
+        LE_ERROR("Cannot open shared memory '%s': %m", name);
+        close(fd);
+        return NULL;
+    }
+
+    if (-1 == ftruncate(fd, sizeof(le_gnssBroadcast_Ring_t)))
+    {
+        LE_ERROR("Cannot size shared memory '%s': %m", name);
+        close(fd);
+        close(*readOnlyFdPtr);
+        return NULL;
+    }
+
+    ringPtr = mmap(NULL, sizeof(le_gnssBroadcast_Ring_t), PROT_READ | PROT_WRITE, MAP_SHARED,
+                   fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == ringPtr)
+    {
+        LE_ERROR("Cannot map shared memory '%s': %m", name);
+        close(*readOnlyFdPtr);
+        return NULL;
+    }
+
+    // The memory is zeroed by ftruncate(): only the identification remains to be filled in.
+    ringPtr->recordCount = LE_GNSSBROADCAST_RECORD_COUNT;
+    ringPtr->recordSize = sizeof(le_gnssBroadcast_Record_t);
+    ringPtr->version = LE_GNSSBROADCAST_VERSION;
+    __atomic_store_n(&ringPtr->magic, LE_GNSSBROADCAST_MAGIC, __ATOMIC_RELEASE);
+
+    return ringPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write NMEA sentences to the ring, splitting them over several records if they don't fit in one.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gnssBroadcast_WriteNmea
+(
+    le_gnssBroadcast_Ring_t* ringPtr,   ///< [in] Ring.
+    const char* nmeaPtr                 ///< [in] NMEA sentences, NUL-terminated.
+)
+{
+    size_t remaining = strlen(nmeaPtr);
+
+    while (remaining > 0)
+    {
+        size_t size = (remaining < LE_GNSSBROADCAST_NMEA_MAX_BYTES) ?
+                      remaining : LE_GNSSBROADCAST_NMEA_MAX_BYTES;
+        le_gnssBroadcast_Record_t* recordPtr = ClaimRecord(ringPtr);
+
+        recordPtr->type = LE_GNSSBROADCAST_NMEA;
+        recordPtr->size = size;
+        memcpy(recordPtr->data.nmea, nmeaPtr, size);
+
+        PublishRecord(ringPtr, recordPtr);
+
+        nmeaPtr += size;
+        remaining -= size;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a decoded position sample to the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gnssBroadcast_WriteSample
+(
+    le_gnssBroadcast_Ring_t* ringPtr,           ///< [in] Ring.
+    const le_gnssBroadcast_Sample_t* samplePtr  ///< [in] Sample.
+)
+{
+    le_gnssBroadcast_Record_t* recordPtr = ClaimRecord(ringPtr);
+
+    recordPtr->type = LE_GNSSBROADCAST_SAMPLE;
+    recordPtr->size = sizeof(*samplePtr);
+    recordPtr->data.sample = *samplePtr;
+
+    PublishRecord(ringPtr, recordPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map a ring read-only and start reading it from the next record written.  The file descriptor
+ * can be closed afterwards.
+ *
+ * @return
+ *      - LE_OK on success.
+ *      - LE_FORMAT_ERROR if the shared memory isn't a ring of this version.
+ *      - LE_FAULT on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnssBroadcast_Attach
+(
+    int fd,                                 ///< [in] File descriptor of the ring.
+    le_gnssBroadcast_Reader_t* readerPtr    ///< [out] Reader.
+)
+{
+    struct stat fileStat;
+    const le_gnssBroadcast_Ring_t* ringPtr;
+
+    if ((-1 == fstat(fd, &fileStat)) || (fileStat.st_size < (off_t)sizeof(*ringPtr)))
+    {
+        LE_ERROR("Shared memory is missing or too small");
+        return LE_FORMAT_ERROR;
+    }
+
+    ringPtr = mmap(NULL, sizeof(*ringPtr), PROT_READ, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == ringPtr)
+    {
+        LE_ERROR("Cannot map shared memory: %m");
+        return LE_FAULT;
+    }
+
+    if ((LE_GNSSBROADCAST_MAGIC != __atomic_load_n(&ringPtr->magic, __ATOMIC_ACQUIRE)) ||
+        (LE_GNSSBROADCAST_VERSION != ringPtr->version) ||
+        (LE_GNSSBROADCAST_RECORD_COUNT != ringPtr->recordCount) ||
+        (sizeof(le_gnssBroadcast_Record_t) != ringPtr->recordSize))
+    {
+        LE_ERROR("Shared memory is not a version %d broadcast ring", LE_GNSSBROADCAST_VERSION);
+        munmap((void*)ringPtr, sizeof(*ringPtr));
+        return LE_FORMAT_ERROR;
+    }
+
+    readerPtr->ringPtr = ringPtr;
+    readerPtr->nextSeq = __atomic_load_n(&ringPtr->writeSeq, __ATOMIC_ACQUIRE);
+    readerPtr->overrunCount = 0;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap a ring.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gnssBroadcast_Detach
+(
+    le_gnssBroadcast_Reader_t* readerPtr    ///< [in] Reader.
+)
+{
+    munmap((void*)readerPtr->ringPtr, sizeof(*readerPtr->ringPtr));
+    readerPtr->ringPtr = NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next record to read, in place.  The record must be released with
+ * le_gnssBroadcast_Next() before peeking at the following one.
+ *
+ * @return
+ *      - LE_OK if there is a record to read.
+ *      - LE_WOULD_BLOCK if all the records written have been read.
+ *      - LE_OVERFLOW if records were lost.  The reader has skipped to the oldest record still in
+ *        the ring and overrunCount has been updated: peek again.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnssBroadcast_Peek
+(
+    le_gnssBroadcast_Reader_t* readerPtr,           ///< [in] Reader.
+    const le_gnssBroadcast_Record_t** recordPtrPtr  ///< [out] Record to read.
+)
+{
+    const le_gnssBroadcast_Ring_t* ringPtr = readerPtr->ringPtr;
+    uint32_t writeSeq = __atomic_load_n(&ringPtr->writeSeq, __ATOMIC_ACQUIRE);
+    const le_gnssBroadcast_Record_t* recordPtr;
+
+    if (writeSeq == readerPtr->nextSeq)
+    {
+        return LE_WOULD_BLOCK;
+    }
+
+    recordPtr = &ringPtr->records[readerPtr->nextSeq & RECORD_INDEX_MASK];
+
+    // Sequence numbers wrap around, so only their differences are meaningful.
+    if (((uint32_t)(writeSeq - readerPtr->nextSeq) > LE_GNSSBROADCAST_RECORD_COUNT) ||
+        (__atomic_load_n(&recordPtr->seq, __ATOMIC_ACQUIRE) != readerPtr->nextSeq))
+    {
+        // Skip to the oldest record that isn't about to be overwritten by the next write.  The
+        // record may have been overwritten after writeSeq was read, so read it again.
+        uint32_t oldestSeq = __atomic_load_n(&ringPtr->writeSeq, __ATOMIC_ACQUIRE) -
+                             LE_GNSSBROADCAST_RECORD_COUNT + 1;
+
+        readerPtr->overrunCount += oldestSeq - readerPtr->nextSeq;
+        readerPtr->nextSeq = oldestSeq;
+
+        return LE_OVERFLOW;
+    }
+
+    *recordPtrPtr = recordPtr;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the record got from le_gnssBroadcast_Peek() and move on to the next one.
+ *
+ * @return
+ *      - LE_OK if the record was left untouched while it was being read.
+ *      - LE_OVERFLOW if the writer may have overwritten it: whatever was read from it must be
+ *        discarded.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnssBroadcast_Next
+(
+    le_gnssBroadcast_Reader_t* readerPtr    ///< [in] Reader.
+)
+{
+    uint32_t claimSeq;
+    uint32_t seq = readerPtr->nextSeq++;
+
+    // The record must be read before the claim is checked.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    claimSeq = __atomic_load_n(&readerPtr->ringPtr->claimSeq, __ATOMIC_RELAXED);
+
+    if ((uint32_t)(claimSeq - seq) >= LE_GNSSBROADCAST_RECORD_COUNT)
+    {
+        readerPtr->overrunCount++;
+        return LE_OVERFLOW;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for a record to be written after the ones already read.
+ *
+ * @return
+ *      - LE_OK if there is a record to read.
+ *      - LE_TIMEOUT if none was written in time.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnssBroadcast_Wait
+(
+    le_gnssBroadcast_Reader_t* readerPtr,   ///< [in] Reader.
+    int32_t timeoutMs                       ///< [in] Timeout in milliseconds, -1 to wait forever.
+)
+{
+    const uint32_t* writeSeqPtr = &readerPtr->ringPtr->writeSeq;
+    le_clk_Time_t deadline = { 0, 0 };
+
+    if (timeoutMs >= 0)
+    {
+        le_clk_Time_t timeout = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+        deadline = le_clk_Add(le_clk_GetRelativeTime(), timeout);
+    }
+
+    while (__atomic_load_n(writeSeqPtr, __ATOMIC_ACQUIRE) == readerPtr->nextSeq)
+    {
+        struct timespec timeout;
+        struct timespec* timeoutPtr = NULL;
+
+        if (timeoutMs >= 0)
+        {
+            le_clk_Time_t remaining = le_clk_Sub(deadline, le_clk_GetRelativeTime());
+
+            if ((remaining.sec < 0) || ((0 == remaining.sec) && (remaining.usec <= 0)))
+            {
+                return LE_TIMEOUT;
+            }
+            timeout.tv_sec = remaining.sec;
+            timeout.tv_nsec = remaining.usec * 1000;
+            timeoutPtr = &timeout;
+        }
+
+        // Returns as soon as writeSeq no longer holds the value read, or when woken up.
+        syscall(SYS_futex, writeSeqPtr, FUTEX_WAIT, readerPtr->nextSeq, timeoutPtr, NULL, 0);
+    }
+
+    return LE_OK;
+}
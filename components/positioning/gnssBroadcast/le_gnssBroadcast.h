@@ -0,0 +1,303 @@
+/**
+ * @file le_gnssBroadcast.h
+ *
+ * GNSS broadcast ring.
+ *
+ * The positioning service writes every NMEA sentence and every decoded position sample it gets
+ * from the GNSS device into a ring of fixed-size records in shared memory.  Any number of readers
+ * map that memory read-only (the file descriptor is obtained with le_gnss_GetBroadcastFd()) and
+ * read the records in place, without any copy or IPC message per record.  When /dev/nmea is a
+ * character device fed by the firmware, only the NMEA sentences reported by the platform adaptor
+ * reach the ring.
+ *
+ * Each record carries a sequence number.  The writer never waits for the readers: a reader that
+ * falls more than @ref LE_GNSSBROADCAST_RECORD_COUNT records behind loses the oldest ones, and is
+ * told so by le_gnssBroadcast_Peek() or le_gnssBroadcast_Next() returning LE_OVERFLOW.
+ *
+ * A reader typically does:
+ * @code
+ * le_gnssBroadcast_Reader_t reader;
+ * const le_gnssBroadcast_Record_t* recordPtr;
+ *
+ * le_gnss_GetBroadcastFd(&fd);
+ * le_gnssBroadcast_Attach(fd, &reader);
+ * close(fd);
+ *
+ * for (;;)
+ * {
+ *     le_result_t result = le_gnssBroadcast_Peek(&reader, &recordPtr);
+ *
+ *     if (LE_WOULD_BLOCK == result)
+ *     {
+ *         le_gnssBroadcast_Wait(&reader, -1);
+ *         continue;
+ *     }
+ *     if (LE_OK == result)
+ *     {
+ *         // Use *recordPtr here.
+ *
+ *         if (LE_OK != le_gnssBroadcast_Next(&reader))
+ *         {
+ *             // The record was overwritten while it was being used: discard what was read.
+ *         }
+ *     }
+ * }
+ * @endcode
+ *
+ * <hr>
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LE_GNSS_BROADCAST_H
+#define LE_GNSS_BROADCAST_H
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of the magic field of a broadcast ring ("GNSB").
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_GNSSBROADCAST_MAGIC          0x424E5347
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Version of the ring layout.  Increased whenever the layout of the header or of the records
+ * changes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_GNSSBROADCAST_VERSION        1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of records in the ring.  Must be a power of two.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_GNSSBROADCAST_RECORD_COUNT   256
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of NMEA bytes in one record.  Longer NMEA strings are split over several
+ * consecutive records.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_GNSSBROADCAST_NMEA_MAX_BYTES 240
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Type of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LE_GNSSBROADCAST_NMEA   = 1,    ///< NMEA sentences, in data.nmea.
+    LE_GNSSBROADCAST_SAMPLE = 2     ///< Decoded position sample, in data.sample.
+}
+le_gnssBroadcast_RecordType_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decoded position sample.  The fields are the ones returned by le_gnss_GetSampleData(), with the
+ * same units and the same values for the fields that are not valid.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t state;              ///< Position fix state (le_gnss_FixState_t).
+    uint32_t validFields;        ///< Fields that are valid (le_gnss_SampleFieldBitMask_t).
+    uint64_t epochTime;          ///< Epoch time in milliseconds.
+    int32_t  latitude;           ///< Latitude.
+    int32_t  longitude;          ///< Longitude.
+    int32_t  hAccuracy;          ///< Horizontal position's accuracy.
+    int32_t  altitude;           ///< Altitude.
+    int32_t  vAccuracy;          ///< Vertical position's accuracy.
+    int32_t  altitudeOnWgs84;    ///< Altitude with respect to the WGS-84.
+    uint32_t hSpeed;             ///< Horizontal speed.
+    uint32_t hSpeedAccuracy;     ///< Horizontal speed's accuracy.
+    int32_t  vSpeed;             ///< Vertical speed.
+    int32_t  vSpeedAccuracy;     ///< Vertical speed's accuracy.
+    uint32_t direction;          ///< Direction.
+    uint32_t directionAccuracy;  ///< Direction's accuracy.
+    uint32_t timeAccuracy;       ///< Time accuracy.
+    int32_t  magneticDeviation;  ///< Magnetic deviation.
+    uint16_t year;               ///< UTC Year.
+    uint16_t month;              ///< UTC Month.
+    uint16_t day;                ///< UTC Day.
+    uint16_t hours;              ///< UTC Hours.
+    uint16_t minutes;            ///< UTC Minutes.
+    uint16_t seconds;            ///< UTC Seconds.
+    uint16_t milliseconds;       ///< UTC Milliseconds.
+    uint16_t hdop;               ///< Horizontal dilution of precision.
+    uint16_t vdop;               ///< Vertical dilution of precision.
+    uint16_t pdop;               ///< Position dilution of precision.
+    uint8_t  leapSeconds;        ///< UTC leap seconds.
+    uint8_t  satsInViewCount;    ///< Satellites in View count.
+    uint8_t  satsTrackingCount;  ///< Tracking satellites in View count.
+    uint8_t  satsUsedCount;      ///< Satellites in View used for Navigation.
+}
+le_gnssBroadcast_Sample_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record of the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t seq;       ///< Sequence number of the record.
+    uint32_t type;      ///< Type of the record (le_gnssBroadcast_RecordType_t).
+    uint32_t size;      ///< Number of bytes used in the data.
+    uint32_t reserved;  ///< Reserved, set to 0.
+    union
+    {
+        char                      nmea[LE_GNSSBROADCAST_NMEA_MAX_BYTES]; ///< Not NUL-terminated.
+        le_gnssBroadcast_Sample_t sample;                                 ///< Decoded sample.
+    }
+    data;               ///< Data of the record, according to its type.
+}
+le_gnssBroadcast_Record_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Layout of the shared memory: a header followed by the records.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;         ///< LE_GNSSBROADCAST_MAGIC.
+    uint32_t version;       ///< LE_GNSSBROADCAST_VERSION.
+    uint32_t recordCount;   ///< LE_GNSSBROADCAST_RECORD_COUNT.
+    uint32_t recordSize;    ///< sizeof(le_gnssBroadcast_Record_t).
+    uint32_t writeSeq;      ///< Sequence number of the next record to be written.
+    uint32_t claimSeq;      ///< Sequence number of the record being, or last, written.
+    uint32_t reserved[10];  ///< Reserved, set to 0.
+    le_gnssBroadcast_Record_t records[LE_GNSSBROADCAST_RECORD_COUNT];
+}
+le_gnssBroadcast_Ring_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of a reader.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const le_gnssBroadcast_Ring_t* ringPtr; ///< Mapped ring.
+    uint32_t nextSeq;                       ///< Sequence number of the next record to read.
+    uint32_t overrunCount;                  ///< Number of records lost so far.
+}
+le_gnssBroadcast_Reader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a broadcast ring in shared memory.  The shared memory has no name: it can only be
+ * reached through the returned read-only file descriptor, which the writer hands out to readers.
+ *
+ * @return
+ *      - Pointer to the ring, for the writer.
+ *      - NULL on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_gnssBroadcast_Ring_t* le_gnssBroadcast_Create
+(
+    int* readOnlyFdPtr      ///< [out] Read-only file descriptor of the ring.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write NMEA sentences to the ring, splitting them over several records if they don't fit in one.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void le_gnssBroadcast_WriteNmea
+(
+    le_gnssBroadcast_Ring_t* ringPtr,   ///< [in] Ring.
+    const char* nmeaPtr                 ///< [in] NMEA sentences, NUL-terminated.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a decoded position sample to the ring.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void le_gnssBroadcast_WriteSample
+(
+    le_gnssBroadcast_Ring_t* ringPtr,           ///< [in] Ring.
+    const le_gnssBroadcast_Sample_t* samplePtr  ///< [in] Sample.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map a ring read-only and start reading it from the next record written.  The file descriptor
+ * can be closed afterwards.
+ *
+ * @return
+ *      - LE_OK on success.
+ *      - LE_FORMAT_ERROR if the shared memory isn't a ring of this version.
+ *      - LE_FAULT on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t le_gnssBroadcast_Attach
+(
+    int fd,                                 ///< [in] File descriptor of the ring.
+    le_gnssBroadcast_Reader_t* readerPtr    ///< [out] Reader.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap a ring.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED void le_gnssBroadcast_Detach
+(
+    le_gnssBroadcast_Reader_t* readerPtr    ///< [in] Reader.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the next record to read, in place.  The record must be released with
+ * le_gnssBroadcast_Next() before peeking at the following one.
+ *
+ * @return
+ *      - LE_OK if there is a record to read.
+ *      - LE_WOULD_BLOCK if all the records written have been read.
+ *      - LE_OVERFLOW if records were lost.  The reader has skipped to the oldest record still in
+ *        the ring and overrunCount has been updated: peek again.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t le_gnssBroadcast_Peek
+(
+    le_gnssBroadcast_Reader_t* readerPtr,           ///< [in] Reader.
+    const le_gnssBroadcast_Record_t** recordPtrPtr  ///< [out] Record to read.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Release the record got from le_gnssBroadcast_Peek() and move on to the next one.
+ *
+ * @return
+ *      - LE_OK if the record was left untouched while it was being read.
+ *      - LE_OVERFLOW if the writer may have overwritten it: whatever was read from it must be
+ *        discarded.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t le_gnssBroadcast_Next
+(
+    le_gnssBroadcast_Reader_t* readerPtr    ///< [in] Reader.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for a record to be written after the ones already read.
+ *
+ * @return
+ *      - LE_OK if there is a record to read.
+ *      - LE_TIMEOUT if none was written in time.
+ */
+//--------------------------------------------------------------------------------------------------
+LE_SHARED le_result_t le_gnssBroadcast_Wait
+(
+    le_gnssBroadcast_Reader_t* readerPtr,   ///< [in] Reader.
+    int32_t timeoutMs                       ///< [in] Timeout in milliseconds, -1 to wait forever.
+);
+
+#endif // LE_GNSS_BROADCAST_H
@@ -12,6 +12,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "pa_gnss.h"
+#include "le_gnssBroadcast.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -188,6 +189,29 @@ typedef struct le_gnss_PositionHandler
 }
 le_gnss_PositionHandler_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sample data Handler structure.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_gnss_SampleDataHandlerFunc_t handlerFuncPtr;    ///< The handler function address.
+    void*                           handlerContextPtr; ///< The handler function context.
+    le_dls_Link_t                   link;              ///< Object node link
+}
+le_gnss_SampleDataHandler_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Data of a position sample, as returned by le_gnss_GetSampleData(), reported to the sample data
+ * handlers and written to the broadcast ring.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef le_gnssBroadcast_Sample_t le_gnss_SampleData_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Position sample request objet structure.
@@ -255,6 +279,22 @@ static int32_t NumOfPositionHandlers = 0;
 //--------------------------------------------------------------------------------------------------
 static le_dls_List_t PositionHandlerList = LE_DLS_LIST_INIT;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for sample data handlers.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   SampleDataHandlerPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create and initialize the sample data handlers list.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t SampleDataHandlerList = LE_DLS_LIST_INIT;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory Pool for position samples.
@@ -302,6 +342,29 @@ static le_ref_MapRef_t PositionSampleMap;
 //--------------------------------------------------------------------------------------------------
 static int NmeaPipeFd = -1;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * True when the NMEA node is a FIFO managed by Legato, false when it is a character device fed by
+ * the firmware, in which case the NMEA sentences reported by the PA only go to the broadcast ring.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsNmeaPipeManaged = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Broadcast ring carrying the NMEA flow and the position samples to readers in other processes,
+ * NULL if it could not be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_gnssBroadcast_Ring_t* BroadcastRingPtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read-only file descriptor of the broadcast ring, duplicated for each reader.
+ */
+//--------------------------------------------------------------------------------------------------
+static int BroadcastFd = -1;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Position Handler destructor.
@@ -533,8 +596,17 @@ static void PaNmeaHandler
 {
     LE_DEBUG("Handler Function called with PA NMEA %p", nmeaPtr);
 
-    // Write the NMEA sentence to the /dev/nmea device folder
-    WriteNmeaPipe(nmeaPtr);
+    // Broadcast the NMEA sentence first: writing to the pipe may fail or wait for a reader.
+    if (NULL != BroadcastRingPtr)
+    {
+        le_gnssBroadcast_WriteNmea(BroadcastRingPtr, nmeaPtr);
+    }
+
+    // Write the NMEA sentence to the /dev/nmea device folder, unless the firmware feeds it
+    if (IsNmeaPipeManaged)
+    {
+        WriteNmeaPipe(nmeaPtr);
+    }
 
     le_mem_Release(nmeaPtr);
 }
@@ -656,6 +728,154 @@ static void GetPosSampleData
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fills in the data of a position sample, setting the fields that are not valid to the values
+ * the le_gnss_Get... functions return for them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetSampleData
+(
+    const le_gnss_PositionSample_t* posSampleDataPtr,  // [IN] The position sample.
+    le_gnss_SampleData_t* sampleDataPtr                // [OUT] The position sample's data.
+)
+{
+    le_gnss_SampleFieldBitMask_t validFields = 0;
+
+    sampleDataPtr->state = posSampleDataPtr->fixState;
+
+#define SAMPLE_FIELD(field, valid, bit, invalidValue)                                   \
+    if (valid)                                                                          \
+    {                                                                                   \
+        sampleDataPtr->field = posSampleDataPtr->field;                                 \
+        validFields |= (bit);                                                           \
+    }                                                                                   \
+    else                                                                                \
+    {                                                                                   \
+        sampleDataPtr->field = (invalidValue);                                          \
+    }
+
+    // Position information
+    SAMPLE_FIELD(latitude, posSampleDataPtr->latitudeValid, LE_GNSS_SAMPLE_LATITUDE, INT32_MAX);
+    SAMPLE_FIELD(longitude, posSampleDataPtr->longitudeValid, LE_GNSS_SAMPLE_LONGITUDE, INT32_MAX);
+    SAMPLE_FIELD(hAccuracy, posSampleDataPtr->hAccuracyValid, LE_GNSS_SAMPLE_H_ACCURACY,
+                 INT32_MAX);
+    SAMPLE_FIELD(altitude, posSampleDataPtr->altitudeValid, LE_GNSS_SAMPLE_ALTITUDE, INT32_MAX);
+    SAMPLE_FIELD(vAccuracy, posSampleDataPtr->vAccuracyValid, LE_GNSS_SAMPLE_V_ACCURACY,
+                 INT32_MAX);
+    SAMPLE_FIELD(altitudeOnWgs84, posSampleDataPtr->altitudeOnWgs84Valid,
+                 LE_GNSS_SAMPLE_ALTITUDE_ON_WGS84, INT32_MAX);
+
+    // Speed and direction
+    SAMPLE_FIELD(hSpeed, posSampleDataPtr->hSpeedValid, LE_GNSS_SAMPLE_H_SPEED, UINT32_MAX);
+    SAMPLE_FIELD(hSpeedAccuracy, posSampleDataPtr->hSpeedAccuracyValid,
+                 LE_GNSS_SAMPLE_H_SPEED_ACCURACY, UINT32_MAX);
+    SAMPLE_FIELD(vSpeed, posSampleDataPtr->vSpeedValid, LE_GNSS_SAMPLE_V_SPEED, INT32_MAX);
+    SAMPLE_FIELD(vSpeedAccuracy, posSampleDataPtr->vSpeedAccuracyValid,
+                 LE_GNSS_SAMPLE_V_SPEED_ACCURACY, INT32_MAX);
+    SAMPLE_FIELD(direction, posSampleDataPtr->directionValid, LE_GNSS_SAMPLE_DIRECTION,
+                 UINT32_MAX);
+    SAMPLE_FIELD(directionAccuracy, posSampleDataPtr->directionAccuracyValid,
+                 LE_GNSS_SAMPLE_DIRECTION_ACCURACY, UINT32_MAX);
+
+    // Date and time
+    SAMPLE_FIELD(year, posSampleDataPtr->dateValid, LE_GNSS_SAMPLE_DATE, 0);
+    SAMPLE_FIELD(month, posSampleDataPtr->dateValid, LE_GNSS_SAMPLE_DATE, 0);
+    SAMPLE_FIELD(day, posSampleDataPtr->dateValid, LE_GNSS_SAMPLE_DATE, 0);
+    SAMPLE_FIELD(hours, posSampleDataPtr->timeValid, LE_GNSS_SAMPLE_TIME, 0);
+    SAMPLE_FIELD(minutes, posSampleDataPtr->timeValid, LE_GNSS_SAMPLE_TIME, 0);
+    SAMPLE_FIELD(seconds, posSampleDataPtr->timeValid, LE_GNSS_SAMPLE_TIME, 0);
+    SAMPLE_FIELD(milliseconds, posSampleDataPtr->timeValid, LE_GNSS_SAMPLE_TIME, 0);
+    SAMPLE_FIELD(epochTime, posSampleDataPtr->timeValid, LE_GNSS_SAMPLE_TIME, 0);
+    SAMPLE_FIELD(timeAccuracy, posSampleDataPtr->timeAccuracyValid, LE_GNSS_SAMPLE_TIME_ACCURACY,
+                 UINT16_MAX);
+    SAMPLE_FIELD(leapSeconds, posSampleDataPtr->leapSecondsValid, LE_GNSS_SAMPLE_LEAP_SECONDS,
+                 UINT8_MAX);
+
+    // DOP parameters
+    SAMPLE_FIELD(hdop, posSampleDataPtr->hdopValid, LE_GNSS_SAMPLE_HDOP, UINT16_MAX);
+    SAMPLE_FIELD(vdop, posSampleDataPtr->vdopValid, LE_GNSS_SAMPLE_VDOP, UINT16_MAX);
+    SAMPLE_FIELD(pdop, posSampleDataPtr->pdopValid, LE_GNSS_SAMPLE_PDOP, UINT16_MAX);
+
+    SAMPLE_FIELD(magneticDeviation, posSampleDataPtr->magneticDeviationValid,
+                 LE_GNSS_SAMPLE_MAGNETIC_DEVIATION, INT32_MAX);
+
+    // Satellites status
+    SAMPLE_FIELD(satsInViewCount, posSampleDataPtr->satsInViewCountValid,
+                 LE_GNSS_SAMPLE_SATS_IN_VIEW_COUNT, UINT8_MAX);
+    SAMPLE_FIELD(satsTrackingCount, posSampleDataPtr->satsTrackingCountValid,
+                 LE_GNSS_SAMPLE_SATS_TRACKING_COUNT, UINT8_MAX);
+    SAMPLE_FIELD(satsUsedCount, posSampleDataPtr->satsUsedCountValid,
+                 LE_GNSS_SAMPLE_SATS_USED_COUNT, UINT8_MAX);
+
+#undef SAMPLE_FIELD
+
+    sampleDataPtr->validFields = validFields;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the data of a position sample to the sample data handlers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportSampleData
+(
+    const le_gnss_SampleData_t* sampleDataPtr  // [IN] The position sample's data.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&SampleDataHandlerList);
+
+    if (NULL == linkPtr)
+    {
+        return;
+    }
+
+    do
+    {
+        le_gnss_SampleDataHandler_t* handlerNodePtr =
+                        CONTAINER_OF(linkPtr, le_gnss_SampleDataHandler_t, link);
+
+        // Move to the next node first, as the handler may remove itself.
+        linkPtr = le_dls_PeekNext(&SampleDataHandlerList, linkPtr);
+
+        handlerNodePtr->handlerFuncPtr(sampleDataPtr->state,
+                                       sampleDataPtr->validFields,
+                                       sampleDataPtr->latitude,
+                                       sampleDataPtr->longitude,
+                                       sampleDataPtr->hAccuracy,
+                                       sampleDataPtr->altitude,
+                                       sampleDataPtr->vAccuracy,
+                                       sampleDataPtr->altitudeOnWgs84,
+                                       sampleDataPtr->hSpeed,
+                                       sampleDataPtr->hSpeedAccuracy,
+                                       sampleDataPtr->vSpeed,
+                                       sampleDataPtr->vSpeedAccuracy,
+                                       sampleDataPtr->direction,
+                                       sampleDataPtr->directionAccuracy,
+                                       sampleDataPtr->year,
+                                       sampleDataPtr->month,
+                                       sampleDataPtr->day,
+                                       sampleDataPtr->hours,
+                                       sampleDataPtr->minutes,
+                                       sampleDataPtr->seconds,
+                                       sampleDataPtr->milliseconds,
+                                       sampleDataPtr->epochTime,
+                                       sampleDataPtr->timeAccuracy,
+                                       sampleDataPtr->leapSeconds,
+                                       sampleDataPtr->hdop,
+                                       sampleDataPtr->vdop,
+                                       sampleDataPtr->pdop,
+                                       sampleDataPtr->magneticDeviation,
+                                       sampleDataPtr->satsInViewCount,
+                                       sampleDataPtr->satsTrackingCount,
+                                       sampleDataPtr->satsUsedCount,
+                                       handlerNodePtr->handlerContextPtr);
+    }
+    while (NULL != linkPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The signal event handler function for SIGPIPE called from the Legato event loop.
@@ -708,6 +928,21 @@ static void PaPositionHandler
     // Get the position sample data from the PA position data report
     GetPosSampleData(&LastPositionSample, positionPtr);
 
+    if ((NULL != BroadcastRingPtr) || (NULL != le_dls_Peek(&SampleDataHandlerList)))
+    {
+        le_gnss_SampleData_t sampleData;
+
+        GetSampleData(&LastPositionSample, &sampleData);
+
+        if (NULL != BroadcastRingPtr)
+        {
+            le_gnssBroadcast_WriteSample(BroadcastRingPtr, &sampleData);
+        }
+
+        // Report the position sample data to the sample data handlers
+        ReportSampleData(&sampleData);
+    }
+
     if(!NumOfPositionHandlers)
     {
         LE_DEBUG("No positioning handlers, exit Handler Function");
@@ -909,6 +1144,10 @@ le_result_t gnss_Init
                                                sizeof(le_gnss_PositionHandler_t));
     le_mem_SetDestructor(PositionHandlerPoolRef, PositionHandlerDestructor);
 
+    // Create a pool for sample data Handler objects
+    SampleDataHandlerPoolRef = le_mem_CreatePool("SampleDataHandlerPoolRef",
+                                                 sizeof(le_gnss_SampleDataHandler_t));
+
     // Create a pool for Position Sample objects
     PositionSamplePoolRef = le_mem_CreatePool("PositionSamplePoolRef",
                                               sizeof(le_gnss_PositionSample_t));
@@ -935,6 +1174,11 @@ le_result_t gnss_Init
     memset(&LastPositionSample, 0, sizeof(LastPositionSample));
     LastPositionSample.fixState = LE_GNSS_STATE_FIX_NO_POS;
 
+    // Create the broadcast ring.  The positioning service works without it, only the readers of
+    // le_gnss_GetBroadcastFd() are affected.
+    BroadcastRingPtr = le_gnssBroadcast_Create(&BroadcastFd);
+    LE_WARN_IF(NULL == BroadcastRingPtr, "GNSS broadcast ring is not available");
+
     // Subscribe to PA position Data handler
     if ((PaHandlerRef=pa_gnss_AddPositionDataHandler(PaPositionHandler)) == NULL)
     {
@@ -949,10 +1193,7 @@ le_result_t gnss_Init
     // That node is a FIFO (named pipe): it will be managed from Legato (User space).
     if ((resultStat == 0) && (S_ISFIFO(nmeaFileStat.st_mode))) // FIFO (named pipe)
     {
-         if ((PaNmeaHandlerRef=pa_gnss_AddNmeaHandler(PaNmeaHandler)) == NULL)
-         {
-             LE_ERROR("Failed to add PA NMEA handler!");
-         }
+        IsNmeaPipeManaged = true;
     }
     else if ((resultStat == 0) && (S_ISCHR(nmeaFileStat.st_mode))) // Character device file
     {
@@ -960,15 +1201,9 @@ le_result_t gnss_Init
     }
     else if((resultStat == -1)&&(errno == ENOENT)) // No such file or directory
     {
-        if ((PaNmeaHandlerRef=pa_gnss_AddNmeaHandler(PaNmeaHandler)) != NULL)
-        {
-            // Create NMEA device folder
-            CreateNmeaPipe();
-        }
-        else
-        {
-            LE_ERROR("Failed to add PA NMEA handler!");
-        }
+        // Create NMEA device folder
+        CreateNmeaPipe();
+        IsNmeaPipeManaged = true;
     }
     else
     {
@@ -976,6 +1211,16 @@ le_result_t gnss_Init
                LE_GNSS_NMEA_NODE_PATH, errno, strerror(errno));
     }
 
+    // The PA NMEA flow feeds the NMEA pipe when Legato manages it, and the broadcast ring in any
+    // case: with a character device, the ring only gets the sentences the PA reports.
+    if ((IsNmeaPipeManaged) || (NULL != BroadcastRingPtr))
+    {
+        if ((PaNmeaHandlerRef=pa_gnss_AddNmeaHandler(PaNmeaHandler)) == NULL)
+        {
+            LE_ERROR("Failed to add PA NMEA handler!");
+        }
+    }
+
     return result;
 }
 
@@ -1069,7 +1314,88 @@ void le_gnss_RemovePositionHandler
         } while (linkPtr != NULL);
     }
 
-    if(NumOfPositionHandlers == 0)
+    if ((NumOfPositionHandlers == 0) && (le_dls_IsEmpty(&SampleDataHandlerList)))
+    {
+        pa_gnss_RemovePositionDataHandler(PaHandlerRef);
+        PaHandlerRef = NULL;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to register an handler for the data of each position sample.
+ *
+ *  - A handler reference, which is only needed for later removal of the handler.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_gnss_SampleDataHandlerRef_t le_gnss_AddSampleDataHandler
+(
+    le_gnss_SampleDataHandlerFunc_t handlerPtr,         ///< [IN] The handler function.
+    void*                           contextPtr          ///< [IN] The context pointer
+)
+{
+    le_gnss_SampleDataHandler_t* sampleDataHandlerPtr;
+
+    LE_FATAL_IF((NULL == handlerPtr), "handlerPtr pointer is NULL !");
+
+    // Create the sample data handler node.
+    sampleDataHandlerPtr = le_mem_ForceAlloc(SampleDataHandlerPoolRef);
+    sampleDataHandlerPtr->handlerFuncPtr = handlerPtr;
+    sampleDataHandlerPtr->handlerContextPtr = contextPtr;
+    sampleDataHandlerPtr->link = LE_DLS_LINK_INIT;
+
+    // Subscribe to PA position Data handler
+    if (NULL == PaHandlerRef)
+    {
+        if ((PaHandlerRef=pa_gnss_AddPositionDataHandler(PaPositionHandler)) == NULL)
+        {
+            LE_ERROR("Failed to add PA position Data handler!");
+        }
+        else
+        {
+            LE_DEBUG("PaHandlerRef %p subscribed", PaHandlerRef);
+        }
+    }
+
+    le_dls_Queue(&SampleDataHandlerList, &(sampleDataHandlerPtr->link));
+
+    LE_DEBUG("Sample data handler %p added", handlerPtr);
+
+    return (le_gnss_SampleDataHandlerRef_t)sampleDataHandlerPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function must be called to remove a handler for the data of each position sample.
+ *
+ * @note Doesn't return on failure, so there's no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_gnss_RemoveSampleDataHandler
+(
+    le_gnss_SampleDataHandlerRef_t handlerRef   ///< [IN] The handler reference.
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&SampleDataHandlerList);
+
+    while (NULL != linkPtr)
+    {
+        le_gnss_SampleDataHandler_t* sampleDataHandlerPtr =
+                        CONTAINER_OF(linkPtr, le_gnss_SampleDataHandler_t, link);
+
+        if ((le_gnss_SampleDataHandlerRef_t)sampleDataHandlerPtr == handlerRef)
+        {
+            le_dls_Remove(&SampleDataHandlerList, linkPtr);
+            le_mem_Release(sampleDataHandlerPtr);
+            break;
+        }
+
+        linkPtr = le_dls_PeekNext(&SampleDataHandlerList, linkPtr);
+    }
+
+    if ((NumOfPositionHandlers == 0) && (le_dls_IsEmpty(&SampleDataHandlerList)))
     {
         pa_gnss_RemovePositionDataHandler(PaHandlerRef);
         PaHandlerRef = NULL;
@@ -2603,6 +2929,269 @@ le_result_t le_gnss_GetMagneticDeviation
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get all the position sample's data at once.
+ *
+ * @return
+ *  - LE_FAULT         Function failed to find the positionSample.
+ *  - LE_OK            Function succeeded.
+ *
+ * @note The fields have the same units as with the corresponding le_gnss_Get... functions.
+ *       Fields that are not flagged as valid in validFields are set to the values these functions
+ *       return for invalid parameters.
+ *
+ * @note The satellites information is not included, use le_gnss_GetSatellitesInfo() to get it.
+ *
+ * @note All the output parameters can be set to NULL if not needed.
+ *
+ * @note If the caller is passing an invalid Position sample reference into this function,
+ *       it is a fatal error, the function will not return.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetSampleData
+(
+    le_gnss_SampleRef_t positionSampleRef,
+        ///< [IN] Position sample's reference.
+
+    le_gnss_FixState_t* statePtr,
+        ///< [OUT] Position fix state.
+
+    le_gnss_SampleFieldBitMask_t* validFieldsPtr,
+        ///< [OUT] Fields that are valid.
+
+    int32_t* latitudePtr,
+        ///< [OUT] WGS84 Latitude in degrees [resolution 1e-6].
+
+    int32_t* longitudePtr,
+        ///< [OUT] WGS84 Longitude in degrees [resolution 1e-6].
+
+    int32_t* hAccuracyPtr,
+        ///< [OUT] Horizontal position's accuracy in meters [resolution 1e-2].
+
+    int32_t* altitudePtr,
+        ///< [OUT] Altitude in meters, above Mean Sea Level [resolution 1e-3].
+
+    int32_t* vAccuracyPtr,
+        ///< [OUT] Vertical position's accuracy in meters [resolution 1e-1].
+
+    int32_t* altitudeOnWgs84Ptr,
+        ///< [OUT] Altitude in meters, between WGS-84 earth ellipsoid and mean sea
+        ///<       level [resolution 1e-3].
+
+    uint32_t* hSpeedPtr,
+        ///< [OUT] Horizontal speed in meters/second [resolution 1e-2].
+
+    uint32_t* hSpeedAccuracyPtr,
+        ///< [OUT] Horizontal speed's accuracy estimate in meters/second
+        ///<       [resolution 1e-1].
+
+    int32_t* vSpeedPtr,
+        ///< [OUT] Vertical speed in meters/second [resolution 1e-2].
+
+    int32_t* vSpeedAccuracyPtr,
+        ///< [OUT] Vertical speed's accuracy estimate in meters/second
+        ///<       [resolution 1e-1].
+
+    uint32_t* directionPtr,
+        ///< [OUT] Direction in degrees [resolution 1e-1].
+
+    uint32_t* directionAccuracyPtr,
+        ///< [OUT] Direction's accuracy estimate in degrees [resolution 1e-1].
+
+    uint16_t* yearPtr,
+        ///< [OUT] UTC Year A.D. [e.g. 2014].
+
+    uint16_t* monthPtr,
+        ///< [OUT] UTC Month into the year [range 1...12].
+
+    uint16_t* dayPtr,
+        ///< [OUT] UTC Days into the month [range 1...31].
+
+    uint16_t* hoursPtr,
+        ///< [OUT] UTC Hours into the day [range 0..23].
+
+    uint16_t* minutesPtr,
+        ///< [OUT] UTC Minutes into the hour [range 0..59].
+
+    uint16_t* secondsPtr,
+        ///< [OUT] UTC Seconds into the minute [range 0..59].
+
+    uint16_t* millisecondsPtr,
+        ///< [OUT] UTC Milliseconds into the second [range 0..999].
+
+    uint64_t* epochTimePtr,
+        ///< [OUT] Milliseconds since Jan. 1, 1970.
+
+    uint32_t* timeAccuracyPtr,
+        ///< [OUT] Estimated time accuracy in milliseconds.
+
+    uint8_t* leapSecondsPtr,
+        ///< [OUT] UTC leap seconds in advance in seconds.
+
+    uint16_t* hdopPtr,
+        ///< [OUT] Horizontal Dilution of Precision [resolution 1e-3].
+
+    uint16_t* vdopPtr,
+        ///< [OUT] Vertical Dilution of Precision [resolution 1e-3].
+
+    uint16_t* pdopPtr,
+        ///< [OUT] Position Dilution of Precision [resolution 1e-3].
+
+    int32_t* magneticDeviationPtr,
+        ///< [OUT] Magnetic deviation in degrees [resolution 1e-1].
+
+    uint8_t* satsInViewCountPtr,
+        ///< [OUT] Number of satellites expected to be in view.
+
+    uint8_t* satsTrackingCountPtr,
+        ///< [OUT] Number of satellites in view, when tracking.
+
+    uint8_t* satsUsedCountPtr
+        ///< [OUT] Number of satellites in view used for Navigation.
+)
+{
+    le_gnss_SampleData_t sampleData;
+    le_gnss_PositionSampleRequest_t* positionSampleRequestNodePtr =
+                                                le_ref_Lookup(PositionSampleMap,positionSampleRef);
+
+    // Check position sample's reference
+    le_result_t result = ValidatePositionSamplePtr(positionSampleRequestNodePtr);
+    if (LE_OK != result)
+    {
+        return result;
+    }
+
+    GetSampleData(positionSampleRequestNodePtr->positionSampleNodePtr, &sampleData);
+
+    if (statePtr)
+    {
+        *statePtr = sampleData.state;
+    }
+    if (validFieldsPtr)
+    {
+        *validFieldsPtr = sampleData.validFields;
+    }
+    if (latitudePtr)
+    {
+        *latitudePtr = sampleData.latitude;
+    }
+    if (longitudePtr)
+    {
+        *longitudePtr = sampleData.longitude;
+    }
+    if (hAccuracyPtr)
+    {
+        *hAccuracyPtr = sampleData.hAccuracy;
+    }
+    if (altitudePtr)
+    {
+        *altitudePtr = sampleData.altitude;
+    }
+    if (vAccuracyPtr)
+    {
+        *vAccuracyPtr = sampleData.vAccuracy;
+    }
+    if (altitudeOnWgs84Ptr)
+    {
+        *altitudeOnWgs84Ptr = sampleData.altitudeOnWgs84;
+    }
+    if (hSpeedPtr)
+    {
+        *hSpeedPtr = sampleData.hSpeed;
+    }
+    if (hSpeedAccuracyPtr)
+    {
+        *hSpeedAccuracyPtr = sampleData.hSpeedAccuracy;
+    }
+    if (vSpeedPtr)
+    {
+        *vSpeedPtr = sampleData.vSpeed;
+    }
+    if (vSpeedAccuracyPtr)
+    {
+        *vSpeedAccuracyPtr = sampleData.vSpeedAccuracy;
+    }
+    if (directionPtr)
+    {
+        *directionPtr = sampleData.direction;
+    }
+    if (directionAccuracyPtr)
+    {
+        *directionAccuracyPtr = sampleData.directionAccuracy;
+    }
+    if (yearPtr)
+    {
+        *yearPtr = sampleData.year;
+    }
+    if (monthPtr)
+    {
+        *monthPtr = sampleData.month;
+    }
+    if (dayPtr)
+    {
+        *dayPtr = sampleData.day;
+    }
+    if (hoursPtr)
+    {
+        *hoursPtr = sampleData.hours;
+    }
+    if (minutesPtr)
+    {
+        *minutesPtr = sampleData.minutes;
+    }
+    if (secondsPtr)
+    {
+        *secondsPtr = sampleData.seconds;
+    }
+    if (millisecondsPtr)
+    {
+        *millisecondsPtr = sampleData.milliseconds;
+    }
+    if (epochTimePtr)
+    {
+        *epochTimePtr = sampleData.epochTime;
+    }
+    if (timeAccuracyPtr)
+    {
+        *timeAccuracyPtr = sampleData.timeAccuracy;
+    }
+    if (leapSecondsPtr)
+    {
+        *leapSecondsPtr = sampleData.leapSeconds;
+    }
+    if (hdopPtr)
+    {
+        *hdopPtr = sampleData.hdop;
+    }
+    if (vdopPtr)
+    {
+        *vdopPtr = sampleData.vdop;
+    }
+    if (pdopPtr)
+    {
+        *pdopPtr = sampleData.pdop;
+    }
+    if (magneticDeviationPtr)
+    {
+        *magneticDeviationPtr = sampleData.magneticDeviation;
+    }
+    if (satsInViewCountPtr)
+    {
+        *satsInViewCountPtr = sampleData.satsInViewCount;
+    }
+    if (satsTrackingCountPtr)
+    {
+        *satsTrackingCountPtr = sampleData.satsTrackingCount;
+    }
+    if (satsUsedCountPtr)
+    {
+        *satsUsedCountPtr = sampleData.satsUsedCount;
+    }
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function gets the last updated position sample object reference.
@@ -3854,6 +4443,45 @@ le_result_t le_gnss_GetNmeaSentences
     return result;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * This function gets a read-only file descriptor of the broadcast ring, through which the NMEA
+ * flow and the position samples are shared with any number of readers.
+ *
+ * @return
+ *  - LE_OK             Success
+ *  - LE_UNAVAILABLE    The broadcast ring could not be created
+ *  - LE_FAULT          Failure
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gnss_GetBroadcastFd
+(
+    int* fdPtr      ///< [OUT] Read-only file descriptor of the broadcast ring.
+)
+{
+    if (NULL == fdPtr)
+    {
+        LE_KILL_CLIENT("Invalid pointer provided!");
+        return LE_FAULT;
+    }
+
+    if (NULL == BroadcastRingPtr)
+    {
+        *fdPtr = -1;
+        return LE_UNAVAILABLE;
+    }
+
+    // The IPC closes the file descriptor once sent: hand out a duplicate.
+    *fdPtr = dup(BroadcastFd);
+    if (-1 == *fdPtr)
+    {
+        LE_ERROR("Cannot duplicate broadcast file descriptor: %m");
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * This function returns the state of the GNSS device.
@@ -33,12 +33,17 @@
 
 #define POSITIONING_SAMPLE_MAX          1
 
+// Distances are computed with a flat earth approximation, in fixed point, when both the latitude
+// and longitude differences are below this value in degrees (resolution 1e-6).  The error is then
+// well below the GNSS accuracy; larger moves use the Haversine formula.
+#define FAST_DISTANCE_MAX_DELTA         1000000
 
-/// Typically, we don't expect more than this number of concurrent activation requests.
-#define POSITIONING_ACTIVATION_MAX      13      // Ideally should be a prime number.
+// Length of a degree of latitude (resolution 1e-6) in meters, in Q16 fixed point.
+#define METERS_PER_MICRODEGREE_Q16      7287    // 6371km * PI / 180 / 1e6 * 65536
 
 
-#define CHECK_VALIDITY(_par_,_max_) ((_par_) == (_max_))? false : true
+/// Typically, we don't expect more than this number of concurrent activation requests.
+#define POSITIONING_ACTIVATION_MAX      13      // Ideally should be a prime number.
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -105,6 +110,36 @@ typedef struct le_pos_Sample
 }
 le_pos_Sample_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Group of movement handlers.
+ *
+ * Whether a movement handler must be notified of a fix only depends on its magnitudes and on the
+ * position last reported to it.  Handlers with the same magnitudes that were last notified of the
+ * same fix are therefore kept together and evaluated once per fix, whatever their number.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t                     horizontalMagnitude; ///< The horizontal magnitude in meters.
+    uint32_t                     verticalMagnitude;   ///< The vertical magnitude in meters.
+    uint32_t                     acquisitionRate;     ///< The acquisition rate for these
+                                                      ///  magnitudes.
+    bool                         lastPositionValid;   ///< False until a first fix is reported to
+                                                      ///  the group.
+    uint32_t                     lastFixCount;        ///< Fix count of the last notification.
+    int32_t                      lastLat;             ///< The latitude associated with the last
+                                                      ///  notification.
+    int32_t                      lastLong;            ///< The longitude associated with the last
+                                                      ///  notification.
+    int32_t                      lastAlt;             ///< The altitude associated with the last
+                                                      ///  notification.
+    le_dls_List_t                handlerList;         ///< Handlers of the group.
+    le_dls_Link_t                link;                ///< Object node link
+}
+MovementGroup_t;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Position Sample's Handler structure.
@@ -115,19 +150,10 @@ typedef struct le_pos_SampleHandler
 {
     le_pos_MovementHandlerFunc_t handlerFuncPtr;      ///< The handler function address.
     void*                        handlerContextPtr;   ///< The handler function context.
-    uint32_t                     acquisitionRate;     ///< The acquisition rate for this handler.
-    uint32_t                     horizontalMagnitude; ///< The horizontal magnitude in meters for
-                                                      ///  this handler.
-    uint32_t                     verticalMagnitude;   ///< The vertical magnitude in meters for this
-                                                      ///  handler.
-    int32_t                      lastLat;             ///< The altitude associated with the last
-                                                      ///  handler's notification.
-    int32_t                      lastLong;            ///< The longitude associated with the last
-                                                      ///  handler's notification.
-    int32_t                      lastAlt;             ///< The altitude associated with the last
-                                                      ///  handler's notification.
+    MovementGroup_t*             groupPtr;            ///< The group the handler belongs to.
     le_msg_SessionRef_t          sessionRef;          ///< Store message session reference.
     le_dls_Link_t                link;                ///< Object node link
+    le_dls_Link_t                groupLink;           ///< Link in the group's handler list
 }
 le_pos_SampleHandler_t;
 
@@ -248,6 +274,58 @@ static le_ref_MapRef_t PosSampleMap;
 static le_mem_PoolRef_t PosCtrlHandlerPoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Movement handler groups list.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t MovementGroupList = LE_DLS_LIST_INIT;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory Pool for movement handler groups.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t   MovementGroupPoolRef;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of fixes processed, used to tell the groups notified of the current fix.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FixCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Smallest acquisition rate of the movement handler groups, UINT32_MAX if there is none.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t SmallestHandlerRate = UINT32_MAX;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Cosine of the latitude for each degree from 0 to 90, in Q15 fixed point.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint16_t CosineTable[] =
+{
+    32768, 32763, 32748, 32723, 32688, 32643, 32588, 32524, 32449, 32365,
+    32270, 32166, 32052, 31928, 31795, 31651, 31499, 31336, 31164, 30983,
+    30792, 30592, 30382, 30163, 29935, 29698, 29452, 29197, 28932, 28660,
+    28378, 28088, 27789, 27482, 27166, 26842, 26510, 26170, 25822, 25466,
+    25102, 24730, 24351, 23965, 23571, 23170, 22763, 22348, 21926, 21498,
+    21063, 20622, 20174, 19720, 19261, 18795, 18324, 17847, 17364, 16877,
+    16384, 15886, 15384, 14876, 14365, 13848, 13328, 12803, 12275, 11743,
+    11207, 10668, 10126,  9580,  9032,  8481,  7927,  7371,  6813,  6252,
+     5690,  5126,  4560,  3993,  3425,  2856,  2286,  1715,  1144,   572,
+        0,
+};
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Number of Handler functions that own position samples.
@@ -296,31 +374,38 @@ static void PosSampleDestructor
     void* obj
 )
 {
-    le_pos_Sample_t *posSampleNodePtr;
-    le_dls_Link_t   *linkPtr;
+    le_pos_Sample_t *posSampleNodePtr = (le_pos_Sample_t*)obj;
 
     LE_FATAL_IF((obj == NULL), "Position Sample Object does not exist!");
 
-    linkPtr = le_dls_Peek(&PosSampleList);
-    if (linkPtr != NULL)
+    // Every sample is queued in the list when created.
+    le_dls_Remove(&PosSampleList, &(posSampleNodePtr->link));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute again the smallest acquisition rate of the movement handler groups.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateSmallestRate
+(
+    void
+)
+{
+    le_dls_Link_t *linkPtr = le_dls_Peek(&MovementGroupList);
+
+    SmallestHandlerRate = UINT32_MAX;
+
+    while (linkPtr != NULL)
     {
-        do
+        MovementGroup_t *groupPtr = CONTAINER_OF(linkPtr, MovementGroup_t, link);
+
+        if (groupPtr->acquisitionRate < SmallestHandlerRate)
         {
-            // Get the node from the list
-            posSampleNodePtr = (le_pos_Sample_t*)CONTAINER_OF(linkPtr, le_pos_Sample_t, link);
-            // Check the node.
-            if (posSampleNodePtr == (le_pos_Sample_t*)obj)
-            {
-                // Remove the node.
-                le_dls_Remove(&PosSampleList, linkPtr);
-                linkPtr=NULL;
-            }
-            else
-            {
-                // Move to the next node.
-                linkPtr = le_dls_PeekNext(&PosSampleList, linkPtr);
-            }
-        } while (linkPtr != NULL);
+            SmallestHandlerRate = groupPtr->acquisitionRate;
+        }
+        linkPtr = le_dls_PeekNext(&MovementGroupList, linkPtr);
     }
 }
 
@@ -335,31 +420,21 @@ static void PosSampleHandlerDestructor
     void* obj
 )
 {
-    le_pos_SampleHandler_t *posSampleHandlerNodePtr;
-    le_dls_Link_t          *linkPtr;
+    le_pos_SampleHandler_t *posSampleHandlerNodePtr = (le_pos_SampleHandler_t*)obj;
+    MovementGroup_t        *groupPtr = posSampleHandlerNodePtr->groupPtr;
 
-    linkPtr = le_dls_Peek(&PosSampleHandlerList);
-    if (linkPtr != NULL)
+    le_dls_Remove(&PosSampleHandlerList, &(posSampleHandlerNodePtr->link));
+    le_dls_Remove(&(groupPtr->handlerList), &(posSampleHandlerNodePtr->groupLink));
+
+    if (le_dls_IsEmpty(&(groupPtr->handlerList)))
     {
-        do
+        le_dls_Remove(&MovementGroupList, &(groupPtr->link));
+
+        if (groupPtr->acquisitionRate == SmallestHandlerRate)
         {
-            // Get the node from the list
-            posSampleHandlerNodePtr = (le_pos_SampleHandler_t*)CONTAINER_OF(linkPtr,
-                                                                            le_pos_SampleHandler_t,
-                                                                            link);
-            // Check the node.
-            if (posSampleHandlerNodePtr == (le_pos_SampleHandler_t*)obj)
-            {
-                // Remove the node.
-                le_dls_Remove(&PosSampleHandlerList, linkPtr);
-                linkPtr=NULL;
-            }
-            else
-            {
-                // Move to the next node.
-                linkPtr = le_dls_PeekNext(&PosSampleHandlerList, linkPtr);
-            }
-        } while (linkPtr != NULL);
+            UpdateSmallestRate();
+        }
+        le_mem_Release(groupPtr);
     }
 }
 
@@ -404,10 +479,10 @@ static uint32_t CalculateAcquisitionRate
 //--------------------------------------------------------------------------------------------------
 static uint32_t ComputeDistance
 (
-    uint32_t latitude1,
-    uint32_t longitude1,
-    uint32_t latitude2,
-    uint32_t longitude2
+    int32_t latitude1,
+    int32_t longitude1,
+    int32_t latitude2,
+    int32_t longitude2
 )
 {
     // Haversine formula:
@@ -431,6 +506,98 @@ static uint32_t ComputeDistance
     return (uint32_t)(R * c * 1000);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Integer square root.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t SquareRoot
+(
+    uint64_t value
+)
+{
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)root;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calculate the distance in meters between two fix points.
+ *
+ * Over short distances the earth is taken as flat around the mean latitude, which only needs
+ * integer arithmetic and an interpolated cosine table.  Longer distances use the Haversine
+ * formula.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ComputeFastDistance
+(
+    int32_t latitude1,
+    int32_t longitude1,
+    int32_t latitude2,
+    int32_t longitude2
+)
+{
+    int64_t dLat = (int64_t)latitude2 - latitude1;
+    int64_t dLon = (int64_t)longitude2 - longitude1;
+
+    // Take the shortest way around the antimeridian.
+    if (dLon > 180000000)
+    {
+        dLon -= 360000000;
+    }
+    else if (dLon < -180000000)
+    {
+        dLon += 360000000;
+    }
+
+    if ((llabs(dLat) >= FAST_DISTANCE_MAX_DELTA) || (llabs(dLon) >= FAST_DISTANCE_MAX_DELTA))
+    {
+        return ComputeDistance(latitude1, longitude1, latitude2, longitude2);
+    }
+
+    // Cosine of the mean latitude, interpolated between whole degrees.
+    uint32_t meanLat = (uint32_t)llabs(((int64_t)latitude1 + latitude2) / 2);
+    if (meanLat >= 90000000)
+    {
+        meanLat = 89999999;
+    }
+    uint32_t degree = meanLat / 1000000;
+    uint32_t fraction = meanLat % 1000000;
+    int64_t cosine = CosineTable[degree]
+                     - ((int64_t)(CosineTable[degree] - CosineTable[degree + 1]) * fraction)
+                       / 1000000;
+
+    // Longitude difference brought back to the latitude scale.
+    dLon = (dLon * cosine) >> 15;
+
+    uint64_t distance = SquareRoot((uint64_t)(dLat * dLat + dLon * dLon));
+
+    return (uint32_t)((distance * METERS_PER_MICRODEGREE_Q16) >> 16);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Verify if the covered distance is beyond the magnitude.
@@ -464,47 +631,6 @@ static bool IsBeyondMagnitude
     }
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Calculate the smallest acquisition rate to use for all the registered handlers.
- *
- */
-//--------------------------------------------------------------------------------------------------
-static uint32_t ComputeCommonSmallestRate
-(
-    uint32_t rate
-)
-{
-    le_pos_SampleHandler_t *posSampleHandlerNodePtr;
-    le_dls_Link_t          *linkPtr;
-
-    linkPtr = le_dls_Peek(&PosSampleHandlerList);
-    if (linkPtr != NULL)
-    {
-        do
-        {
-            // Get the node from the list
-            posSampleHandlerNodePtr = (le_pos_SampleHandler_t*)CONTAINER_OF(linkPtr,
-                                                                            le_pos_SampleHandler_t,
-                                                                            link);
-            // Check the node.
-            if (posSampleHandlerNodePtr->acquisitionRate < rate)
-            {
-                // Remove the node.
-                rate = posSampleHandlerNodePtr->acquisitionRate;
-                linkPtr=NULL;
-            }
-            else
-            {
-                // Move to the next node.
-                linkPtr = le_dls_PeekNext(&PosSampleHandlerList, linkPtr);
-            }
-        } while (linkPtr != NULL);
-    }
-
-    return rate;
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Compute horizontal and vertical move
@@ -515,7 +641,7 @@ static uint32_t ComputeCommonSmallestRate
 //--------------------------------------------------------------------------------------------------
 static le_result_t ComputeMove
 (
-  le_pos_SampleHandler_t *posSampleHandlerNodePtr,  ///< [IN]  The handler reference.
+  MovementGroup_t        *groupPtr,                 ///< [IN]  The handler group.
   const PositionParam_t  *posParamPtr,              ///< [IN]  The position structure for the move
                                                     ///        calculation.
   bool                   *hflagPtr,                 ///< [OUT] True if the horizontal distance is
@@ -523,34 +649,37 @@ static le_result_t ComputeMove
   bool                   *vflagPtr                  ///< [OUT] True if the vertical distance is
 )                                                   ///        beyond the magnitude.
 {
-    if (NULL == posSampleHandlerNodePtr)
+    if (NULL == groupPtr)
     {
-        LE_ERROR("posSampleHandlerNodePtr is Null");
+        LE_ERROR("groupPtr is Null");
         return LE_FAULT;
     }
 
-    if ((posSampleHandlerNodePtr->horizontalMagnitude != 0) && !(posParamPtr->locationValid))
+    if ((groupPtr->horizontalMagnitude != 0) && !(posParamPtr->locationValid))
     {
         LE_ERROR("Longitude or Latitude are not relevant");
         return LE_FAULT;
     }
 
-    if (((posSampleHandlerNodePtr->verticalMagnitude != 0) && (!posParamPtr->altitudeValid)))
+    if (((groupPtr->verticalMagnitude != 0) && (!posParamPtr->altitudeValid)))
     {
         LE_ERROR("Altitude is not relevant");
         return LE_FAULT;
     }
 
     // Compute horizontal and vertical move
-    LE_DEBUG("Last Position lat.%d, long.%d",
-                 posSampleHandlerNodePtr->lastLat, posSampleHandlerNodePtr->lastLong);
+    LE_DEBUG("Last Position lat.%d, long.%d", groupPtr->lastLat, groupPtr->lastLong);
 
-    uint32_t horizontalMove = ComputeDistance(posSampleHandlerNodePtr->lastLat,
-                                              posSampleHandlerNodePtr->lastLong,
-                                              posParamPtr->latitude,
-                                              posParamPtr->longitude);
+    uint32_t horizontalMove = 0;
+    if (groupPtr->horizontalMagnitude != 0)
+    {
+        horizontalMove = ComputeFastDistance(groupPtr->lastLat,
+                                             groupPtr->lastLong,
+                                             posParamPtr->latitude,
+                                             posParamPtr->longitude);
+    }
 
-    uint32_t verticalMove = abs(posParamPtr->altitude - posSampleHandlerNodePtr->lastAlt);
+    uint32_t verticalMove = abs(posParamPtr->altitude - groupPtr->lastAlt);
 
     LE_DEBUG("horizontalMove.%d, verticalMove.%d", horizontalMove, verticalMove);
 
@@ -561,9 +690,9 @@ static le_result_t ComputeMove
     else
     {
         // Vertical accuracy is in meters with 1 decimal place
-        *vflagPtr = IsBeyondMagnitude(posSampleHandlerNodePtr->verticalMagnitude,
-                                   verticalMove,
-                                   posParamPtr->vAccuracy/10);
+        *vflagPtr = IsBeyondMagnitude(groupPtr->verticalMagnitude,
+                                      verticalMove,
+                                      posParamPtr->vAccuracy/10);
     }
 
     if (INT32_MAX == posParamPtr->hAccuracy)
@@ -573,15 +702,101 @@ static le_result_t ComputeMove
     else
     {
         // Accuracy is in meters with 2 decimal places
-        *hflagPtr = IsBeyondMagnitude(posSampleHandlerNodePtr->horizontalMagnitude,
-                                   horizontalMove,
-                                   posParamPtr->hAccuracy/100);
+        *hflagPtr = IsBeyondMagnitude(groupPtr->horizontalMagnitude,
+                                      horizontalMove,
+                                      posParamPtr->hAccuracy/100);
     }
     LE_DEBUG("Vertical IsBeyondMagnitude.%d", *vflagPtr);
     LE_DEBUG("Horizontal IsBeyondMagnitude.%d", *hflagPtr);
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report a position sample to a movement handler.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportSample
+(
+    le_pos_SampleHandler_t *posSampleHandlerNodePtr,  ///< [IN] The handler to notify.
+    const le_pos_Sample_t  *samplePtr                 ///< [IN] The sample to report.
+)
+{
+    // Create the position sample node.
+    PosSampleRequest_t* posSampleRequestPtr = le_mem_ForceAlloc(PosSampleRequestPoolRef);
+    posSampleRequestPtr->posSampleNodePtr = (le_pos_Sample_t*)le_mem_ForceAlloc(PosSamplePoolRef);
+    *posSampleRequestPtr->posSampleNodePtr = *samplePtr;
+    posSampleRequestPtr->posSampleNodePtr->link = LE_DLS_LINK_INIT;
+
+    // Add the node to the queue of the list by passing in the node's link.
+    le_dls_Queue(&PosSampleList, &(posSampleRequestPtr->posSampleNodePtr->link));
+
+    LE_DEBUG("Report sample %p to the corresponding handler (handler %p)",
+             posSampleRequestPtr->posSampleNodePtr,
+             posSampleHandlerNodePtr->handlerFuncPtr);
+
+    le_pos_SampleRef_t reqRef = le_ref_CreateRef(PosSampleMap, posSampleRequestPtr);
+
+    // Get the message session reference from handler function
+    posSampleRequestPtr->sessionRef = posSampleHandlerNodePtr->sessionRef;
+
+    // Store posSample reference which will be used in close session handler
+    posSampleRequestPtr->positionSampleRef = reqRef;
+
+    // Call the client's handler
+    posSampleHandlerNodePtr->handlerFuncPtr(reqRef, posSampleHandlerNodePtr->handlerContextPtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move the handlers of a group that was just notified into another group with the same
+ * magnitudes notified of the same fix, if there is one, as they will behave the same from now on.
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void MergeGroup
+(
+    MovementGroup_t *groupPtr   ///< [IN] The group just notified.
+)
+{
+    le_dls_Link_t   *linkPtr = le_dls_Peek(&MovementGroupList);
+    MovementGroup_t *otherPtr = NULL;
+
+    while (linkPtr != NULL)
+    {
+        MovementGroup_t *nodePtr = CONTAINER_OF(linkPtr, MovementGroup_t, link);
+
+        if ((nodePtr != groupPtr) &&
+            (nodePtr->lastPositionValid) &&
+            (nodePtr->lastFixCount == groupPtr->lastFixCount) &&
+            (nodePtr->horizontalMagnitude == groupPtr->horizontalMagnitude) &&
+            (nodePtr->verticalMagnitude == groupPtr->verticalMagnitude))
+        {
+            otherPtr = nodePtr;
+            break;
+        }
+        linkPtr = le_dls_PeekNext(&MovementGroupList, linkPtr);
+    }
+
+    if (NULL == otherPtr)
+    {
+        return;
+    }
+
+    while (NULL != (linkPtr = le_dls_Pop(&(groupPtr->handlerList))))
+    {
+        le_pos_SampleHandler_t *handlerPtr = CONTAINER_OF(linkPtr,
+                                                          le_pos_SampleHandler_t,
+                                                          groupLink);
+        handlerPtr->groupPtr = otherPtr;
+        le_dls_Queue(&(otherPtr->handlerList), linkPtr);
+    }
+
+    le_dls_Remove(&MovementGroupList, &(groupPtr->link));
+    le_mem_Release(groupPtr);
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The main position Sample Handler.
@@ -594,43 +809,15 @@ static void PosSampleHandlerfunc
     void* contextPtr
 )
 {
-    le_result_t result;
-    // Location parameters
-    bool        locationValid = false;
-    int32_t     latitude;
-    int32_t     longitude;
-    int32_t     hAccuracy;
-    bool        altitudeValid = false;
-    int32_t     altitude;
-    int32_t     vAccuracy;
-    // Horizontal speed
-    uint32_t hSpeed;
-    uint32_t hSpeedAccuracy;
-    // Vertical speed
-    int32_t vSpeed;
-    int32_t vSpeedAccuracy;
-    // Direction
-    uint32_t direction;
-    uint32_t directionAccuracy;
-    // Date parameters
-    uint16_t year;
-    uint16_t month;
-    uint16_t day;
-    // Time parameters
-    uint16_t hours;
-    uint16_t minutes;
-    uint16_t seconds;
-    uint16_t milliseconds;
-    // Leap seconds in advance
-    uint8_t leapSeconds;
-    PositionParam_t posParam;
-    // the position fix state
+    // Position sample data
     le_gnss_FixState_t gnssState;
+    le_gnss_SampleFieldBitMask_t validFields;
+    // Sample reported to the handlers, filled once for all of them.
+    le_pos_Sample_t sample;
+    PositionParam_t posParam;
 
     // Positioning sample parameters
-    le_pos_SampleHandler_t* posSampleHandlerNodePtr;
     le_dls_Link_t*          linkPtr;
-    PosSampleRequest_t*     posSampleRequestPtr=NULL;
 
     if (NULL == positionSampleRef)
     {
@@ -648,218 +835,129 @@ static void PosSampleHandlerfunc
 
     LE_DEBUG("Handler Function called with sample %p", positionSampleRef);
 
-    // Get Location
-    result = le_gnss_GetLocation(positionSampleRef, &latitude, &longitude, &hAccuracy);
-    if ((LE_OK == result) ||
-        ((LE_OUT_OF_RANGE == result) && (INT32_MAX != latitude) && (INT32_MAX != longitude)))
-    {
-        locationValid = true;
-        LE_DEBUG("Position lat.%d, long.%d, hAccuracy.%d", latitude, longitude, hAccuracy/100);
+    // Get all the sample's data at once
+    if (LE_OK != le_gnss_GetSampleData(positionSampleRef, &gnssState, &validFields,
+                                       &sample.latitude, &sample.longitude, &sample.hAccuracy,
+                                       &sample.altitude, &sample.vAccuracy, NULL,
+                                       &sample.hSpeed, &sample.hSpeedAccuracy,
+                                       &sample.vSpeed, &sample.vSpeedAccuracy,
+                                       &sample.direction, &sample.directionAccuracy,
+                                       &sample.year, &sample.month, &sample.day,
+                                       &sample.hours, &sample.minutes, &sample.seconds,
+                                       &sample.milliseconds,
+                                       NULL, NULL, &sample.leapSeconds,
+                                       NULL, NULL, NULL, NULL, NULL, NULL, NULL))
+    {
+        LE_ERROR("Failed to get the position sample's data");
+        le_gnss_ReleaseSampleRef(positionSampleRef);
+        return;
+    }
+
+    // Release provided Position sample reference
+    le_gnss_ReleaseSampleRef(positionSampleRef);
+
+    sample.fixState = (le_pos_FixState_t)gnssState;
+    sample.latitudeValid = ((validFields & LE_GNSS_SAMPLE_LATITUDE) != 0);
+    sample.longitudeValid = ((validFields & LE_GNSS_SAMPLE_LONGITUDE) != 0);
+    sample.hAccuracyValid = ((validFields & LE_GNSS_SAMPLE_H_ACCURACY) != 0);
+    sample.altitudeValid = ((validFields & LE_GNSS_SAMPLE_ALTITUDE) != 0);
+    sample.vAccuracyValid = ((validFields & LE_GNSS_SAMPLE_V_ACCURACY) != 0);
+    sample.hSpeedValid = ((validFields & LE_GNSS_SAMPLE_H_SPEED) != 0);
+    sample.hSpeedAccuracyValid = ((validFields & LE_GNSS_SAMPLE_H_SPEED_ACCURACY) != 0);
+    sample.vSpeedValid = ((validFields & LE_GNSS_SAMPLE_V_SPEED) != 0);
+    sample.vSpeedAccuracyValid = ((validFields & LE_GNSS_SAMPLE_V_SPEED_ACCURACY) != 0);
+    // Heading not supported by GNSS engine
+    sample.headingValid = false;
+    sample.heading = UINT32_MAX;
+    sample.headingAccuracyValid = false;
+    sample.headingAccuracy = UINT32_MAX;
+    sample.directionValid = ((validFields & LE_GNSS_SAMPLE_DIRECTION) != 0);
+    sample.directionAccuracyValid = ((validFields & LE_GNSS_SAMPLE_DIRECTION_ACCURACY) != 0);
+    sample.dateValid = ((validFields & LE_GNSS_SAMPLE_DATE) != 0);
+    sample.timeValid = ((validFields & LE_GNSS_SAMPLE_TIME) != 0);
+    sample.leapSecondsValid = ((validFields & LE_GNSS_SAMPLE_LEAP_SECONDS) != 0);
+    sample.link = LE_DLS_LINK_INIT;
+
+    if (sample.latitudeValid && sample.longitudeValid)
+    {
+        LE_DEBUG("Position lat.%d, long.%d, hAccuracy.%d",
+                 sample.latitude, sample.longitude, sample.hAccuracy/100);
     }
     else
     {
-        locationValid = false;
-        LE_DEBUG("Position unknown [%d,%d,%d]", latitude, longitude, hAccuracy);
+        LE_DEBUG("Position unknown [%d,%d,%d]",
+                 sample.latitude, sample.longitude, sample.hAccuracy);
     }
 
-    // Get altitude
-    result = le_gnss_GetAltitude(positionSampleRef, &altitude, &vAccuracy);
-
-    if ((LE_OK == result) ||
-        ((LE_OUT_OF_RANGE != result) && (INT32_MAX != altitude)))
+    if (sample.altitudeValid)
     {
-        altitudeValid = true;
-        LE_DEBUG("Altitude.%d, vAccuracy.%d", altitude/1000, vAccuracy/10);
+        LE_DEBUG("Altitude.%d, vAccuracy.%d", sample.altitude/1000, sample.vAccuracy/10);
     }
     else
     {
-        altitudeValid = false;
-        LE_DEBUG("Altitude unknown [%d,%d]", altitude, vAccuracy);
+        LE_DEBUG("Altitude unknown [%d,%d]", sample.altitude, sample.vAccuracy);
     }
 
-    // Positioning sample
-    linkPtr = le_dls_Peek(&PosSampleHandlerList);
+    posParam.latitude = sample.latitude;
+    posParam.longitude = sample.longitude;
+    posParam.altitude = sample.altitude;
+    posParam.vAccuracy = sample.vAccuracy;
+    posParam.hAccuracy = sample.hAccuracy;
+    posParam.locationValid = (sample.latitudeValid && sample.longitudeValid);
+    posParam.altitudeValid = sample.altitudeValid;
 
-    if (NULL == linkPtr)
-    {
-        // Release provided Position sample reference
-        le_gnss_ReleaseSampleRef(positionSampleRef);
-        return;
-    }
+    FixCount++;
 
-    posParam.latitude = latitude;
-    posParam.longitude = longitude;
-    posParam.altitude = altitude;
-    posParam.vAccuracy = vAccuracy;
-    posParam.hAccuracy = hAccuracy;
-    posParam.locationValid = locationValid;
-    posParam.altitudeValid = altitudeValid;
+    // Evaluate the move once per group of handlers.
+    linkPtr = le_dls_Peek(&MovementGroupList);
 
-    do
+    while (NULL != linkPtr)
     {
         bool hflag, vflag;
-        // Get the node from the list
-        posSampleHandlerNodePtr = (le_pos_SampleHandler_t*)CONTAINER_OF(linkPtr,
-                                                                        le_pos_SampleHandler_t,
-                                                                        link);
+        MovementGroup_t* groupPtr = CONTAINER_OF(linkPtr, MovementGroup_t, link);
+
+        // Move to the next node now, as the group may be merged into another one.
+        linkPtr = le_dls_PeekNext(&MovementGroupList, linkPtr);
 
-        if (LE_FAULT == ComputeMove(posSampleHandlerNodePtr, &posParam, &hflag, &vflag))
+        if (LE_FAULT == ComputeMove(groupPtr, &posParam, &hflag, &vflag))
         {
-            // Release provided Position sample reference
-            le_gnss_ReleaseSampleRef(positionSampleRef);
-            return;
+            continue;
         }
 
         // Movement is detected in the following cases:
+        // - No fix has been reported to the handlers yet
         // - Vertical distance is beyond the magnitude
         // - Horizontal distance is beyond the magnitude
         // - We don't care about vertical & horizontal distance (magnitudes equal to 0)
         //   therefore that movement handler is called each positioning acquisition rate
-        if (((0 != posSampleHandlerNodePtr->verticalMagnitude) && (vflag)) ||
-             ((0 != posSampleHandlerNodePtr->horizontalMagnitude) && (hflag)) ||
-             ((0 == posSampleHandlerNodePtr->verticalMagnitude)
-             && (0 == posSampleHandlerNodePtr->horizontalMagnitude)))
-        {
-            // Create the position sample node.
-            posSampleRequestPtr = le_mem_ForceAlloc(PosSampleRequestPoolRef);
-            posSampleRequestPtr->posSampleNodePtr
-                                = (le_pos_Sample_t*)le_mem_ForceAlloc(PosSamplePoolRef);
-            posSampleRequestPtr->posSampleNodePtr->latitudeValid
-                                = CHECK_VALIDITY(latitude,INT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->latitude = latitude;
-
-            posSampleRequestPtr->posSampleNodePtr->longitudeValid
-                                = CHECK_VALIDITY(longitude,INT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->longitude = longitude;
-
-            posSampleRequestPtr->posSampleNodePtr->hAccuracyValid
-                                = CHECK_VALIDITY(hAccuracy,INT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->hAccuracy = hAccuracy;
-
-            posSampleRequestPtr->posSampleNodePtr->altitudeValid
-                                = CHECK_VALIDITY(altitude,INT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->altitude = altitude;
-
-            posSampleRequestPtr->posSampleNodePtr->vAccuracyValid
-                                = CHECK_VALIDITY(vAccuracy,INT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->vAccuracy = vAccuracy;
-
-            // Get horizontal speed
-            le_gnss_GetHorizontalSpeed(positionSampleRef, &hSpeed, &hSpeedAccuracy);
-            posSampleRequestPtr->posSampleNodePtr->hSpeedValid
-                                    = CHECK_VALIDITY(hSpeed,UINT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->hSpeed = hSpeed;
-            posSampleRequestPtr->posSampleNodePtr->hSpeedAccuracyValid =
-                                                CHECK_VALIDITY(hSpeedAccuracy,UINT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->hSpeedAccuracy = hSpeedAccuracy;
-
-            // Get vertical speed
-            le_gnss_GetVerticalSpeed(positionSampleRef, &vSpeed, &vSpeedAccuracy);
-            posSampleRequestPtr->posSampleNodePtr->vSpeedValid
-                                = CHECK_VALIDITY(vSpeed,INT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->vSpeed = vSpeed;
-            posSampleRequestPtr->posSampleNodePtr->vSpeedAccuracyValid =
-                                                CHECK_VALIDITY(vSpeedAccuracy,INT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->vSpeedAccuracy = vSpeedAccuracy;
-
-            // Heading not supported by GNSS engine
-            posSampleRequestPtr->posSampleNodePtr->headingValid = false;
-            posSampleRequestPtr->posSampleNodePtr->heading = UINT32_MAX;
-            posSampleRequestPtr->posSampleNodePtr->headingAccuracyValid = false;
-            posSampleRequestPtr->posSampleNodePtr->headingAccuracy = UINT32_MAX;
-
-            // Get direction
-            le_gnss_GetDirection(positionSampleRef, &direction, &directionAccuracy);
-
-            posSampleRequestPtr->posSampleNodePtr->directionValid
-                                = CHECK_VALIDITY(direction,UINT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->direction = direction;
-            posSampleRequestPtr->posSampleNodePtr->directionAccuracyValid =
-                                            CHECK_VALIDITY(directionAccuracy,UINT32_MAX);
-            posSampleRequestPtr->posSampleNodePtr->directionAccuracy = directionAccuracy;
-
-            // Get UTC time
-            if (LE_OK == le_gnss_GetDate(positionSampleRef, &year, &month, &day))
-            {
-                posSampleRequestPtr->posSampleNodePtr->dateValid = true;
-            }
-            else
+        if ((!groupPtr->lastPositionValid) ||
+            ((0 != groupPtr->verticalMagnitude) && (vflag)) ||
+            ((0 != groupPtr->horizontalMagnitude) && (hflag)) ||
+            ((0 == groupPtr->verticalMagnitude) && (0 == groupPtr->horizontalMagnitude)))
+        {
+            le_dls_Link_t* handlerLinkPtr;
+
+            // Save the information reported to the handler functions
+            groupPtr->lastPositionValid = true;
+            groupPtr->lastFixCount = FixCount;
+            groupPtr->lastLat = sample.latitude;
+            groupPtr->lastLong = sample.longitude;
+            groupPtr->lastAlt = sample.altitude;
+
+            handlerLinkPtr = le_dls_Peek(&(groupPtr->handlerList));
+            while (NULL != handlerLinkPtr)
             {
-                posSampleRequestPtr->posSampleNodePtr->dateValid = false;
-            }
-            posSampleRequestPtr->posSampleNodePtr->year = year;
-            posSampleRequestPtr->posSampleNodePtr->month = month;
-            posSampleRequestPtr->posSampleNodePtr->day = day;
+                le_pos_SampleHandler_t* posSampleHandlerNodePtr =
+                    CONTAINER_OF(handlerLinkPtr, le_pos_SampleHandler_t, groupLink);
 
-            if (LE_OK == le_gnss_GetTime(positionSampleRef, &hours, &minutes, &seconds,
-                                         &milliseconds))
-            {
-                posSampleRequestPtr->posSampleNodePtr->timeValid = true;
-            }
-            else
-            {
-                posSampleRequestPtr->posSampleNodePtr->timeValid = false;
-            }
-            posSampleRequestPtr->posSampleNodePtr->hours = hours;
-            posSampleRequestPtr->posSampleNodePtr->minutes = minutes;
-            posSampleRequestPtr->posSampleNodePtr->seconds = seconds;
-            posSampleRequestPtr->posSampleNodePtr->milliseconds = milliseconds;
+                handlerLinkPtr = le_dls_PeekNext(&(groupPtr->handlerList), handlerLinkPtr);
 
-            // Get UTC leap seconds in advance
-            if (LE_OK == le_gnss_GetGpsLeapSeconds(positionSampleRef, &leapSeconds))
-            {
-               posSampleRequestPtr->posSampleNodePtr->leapSecondsValid = true;
-            }
-            else
-            {
-                posSampleRequestPtr->posSampleNodePtr->leapSecondsValid = false;
+                ReportSample(posSampleHandlerNodePtr, &sample);
             }
-            posSampleRequestPtr->posSampleNodePtr->leapSeconds = leapSeconds;
 
-            // Get position fix state
-            if (LE_OK != le_gnss_GetPositionState(positionSampleRef, &gnssState))
-            {
-                posSampleRequestPtr->posSampleNodePtr->fixState = LE_POS_STATE_UNKNOWN;
-                LE_ERROR("Failed to get a position fix");
-            }
-            else
-            {
-                posSampleRequestPtr->posSampleNodePtr->fixState = (le_pos_FixState_t)gnssState;
-            }
-
-            posSampleRequestPtr->posSampleNodePtr->link = LE_DLS_LINK_INIT;
-
-            // Add the node to the queue of the list by passing in the node's link.
-            le_dls_Queue(&PosSampleList, &(posSampleRequestPtr->posSampleNodePtr->link));
-
-            // Save the information reported to the handler function
-            posSampleHandlerNodePtr->lastLat = latitude;
-            posSampleHandlerNodePtr->lastLong = longitude;
-            posSampleHandlerNodePtr->lastAlt = altitude;
-
-            LE_DEBUG("Report sample %p to the corresponding handler (handler %p)",
-                     posSampleRequestPtr->posSampleNodePtr,
-                     posSampleHandlerNodePtr->handlerFuncPtr);
-
-            le_pos_SampleRef_t reqRef = le_ref_CreateRef(PosSampleMap, posSampleRequestPtr);
-
-            // Get the message session reference from handler function
-            posSampleRequestPtr->sessionRef = posSampleHandlerNodePtr->sessionRef;
-
-            // Store posSample reference which will be used in close session handler
-            posSampleRequestPtr->positionSampleRef = reqRef;
-
-            // Call the client's handler
-            posSampleHandlerNodePtr->handlerFuncPtr(reqRef,
-                                            posSampleHandlerNodePtr->handlerContextPtr);
+            MergeGroup(groupPtr);
         }
-
-        // Move to the next node.
-        linkPtr = le_dls_PeekNext(&PosSampleHandlerList, linkPtr);
-    } while (NULL != linkPtr);
-
-    // Release provided Position sample reference
-    le_gnss_ReleaseSampleRef(positionSampleRef);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1032,6 +1130,9 @@ COMPONENT_INIT
                                                 sizeof(le_pos_SampleHandler_t));
     le_mem_SetDestructor(PosSampleHandlerPoolRef, PosSampleHandlerDestructor);
 
+    // Create a pool for the movement handler groups
+    MovementGroupPoolRef = le_mem_CreatePool("MovementGroupPoolRef", sizeof(MovementGroup_t));
+
     // Create the reference HashMap for positioning sample
     PosSampleMap = le_ref_CreateMap("PosSampleMap", POSITIONING_SAMPLE_MAX);
 
@@ -1172,19 +1273,75 @@ le_pos_MovementHandlerRef_t le_pos_AddMovementHandler
 {
     uint32_t                 rate = 0;
     le_pos_SampleHandler_t*  posSampleHandlerNodePtr=NULL;
+    MovementGroup_t*         groupPtr=NULL;
+    le_dls_Link_t*           linkPtr;
 
     LE_FATAL_IF((handlerPtr == NULL), "handlerPtr pointer is NULL !");
 
+    // Start acquisition
+    if (NumOfHandlers == 0)
+    {
+        if ((GnssHandlerRef=le_gnss_AddPositionHandler(PosSampleHandlerfunc, NULL)) == NULL)
+        {
+            LE_ERROR("Failed to add PA GNSS's handler!");
+            return NULL;
+        }
+    }
+
+    // Join the group of the handlers with the same magnitudes that are still waiting for their
+    // first notification, or create it.
+    linkPtr = le_dls_Peek(&MovementGroupList);
+    while (linkPtr != NULL)
+    {
+        MovementGroup_t* nodePtr = CONTAINER_OF(linkPtr, MovementGroup_t, link);
+
+        if ((!nodePtr->lastPositionValid) &&
+            (nodePtr->horizontalMagnitude == horizontalMagnitude) &&
+            (nodePtr->verticalMagnitude == verticalMagnitude))
+        {
+            groupPtr = nodePtr;
+            break;
+        }
+        linkPtr = le_dls_PeekNext(&MovementGroupList, linkPtr);
+    }
+
+    if (NULL == groupPtr)
+    {
+        groupPtr = (MovementGroup_t*)le_mem_ForceAlloc(MovementGroupPoolRef);
+        groupPtr->horizontalMagnitude = horizontalMagnitude;
+        groupPtr->verticalMagnitude = verticalMagnitude;
+        groupPtr->acquisitionRate = CalculateAcquisitionRate(SUPPOSED_AVERAGE_SPEED,
+                                                             horizontalMagnitude,
+                                                             verticalMagnitude);
+        groupPtr->lastPositionValid = false;
+        groupPtr->lastFixCount = 0;
+        groupPtr->lastLat = 0;
+        groupPtr->lastLong = 0;
+        groupPtr->lastAlt = 0;
+        groupPtr->handlerList = LE_DLS_LIST_INIT;
+        groupPtr->link = LE_DLS_LINK_INIT;
+        le_dls_Queue(&MovementGroupList, &(groupPtr->link));
+
+        if (groupPtr->acquisitionRate < SmallestHandlerRate)
+        {
+            SmallestHandlerRate = groupPtr->acquisitionRate;
+        }
+    }
+
     // Create the position sample handler node.
     posSampleHandlerNodePtr = (le_pos_SampleHandler_t*)le_mem_ForceAlloc(PosSampleHandlerPoolRef);
     posSampleHandlerNodePtr->handlerFuncPtr = handlerPtr;
     posSampleHandlerNodePtr->handlerContextPtr = contextPtr;
-    posSampleHandlerNodePtr->acquisitionRate = CalculateAcquisitionRate(SUPPOSED_AVERAGE_SPEED,
-                                                                        horizontalMagnitude,
-                                                                        verticalMagnitude);
-
+    posSampleHandlerNodePtr->groupPtr = groupPtr;
     posSampleHandlerNodePtr->sessionRef = le_pos_GetClientSessionRef();
-    AcqRate = ComputeCommonSmallestRate(posSampleHandlerNodePtr->acquisitionRate);
+    posSampleHandlerNodePtr->link = LE_DLS_LINK_INIT;
+    posSampleHandlerNodePtr->groupLink = LE_DLS_LINK_INIT;
+
+    le_dls_Queue(&PosSampleHandlerList, &(posSampleHandlerNodePtr->link));
+    le_dls_Queue(&(groupPtr->handlerList), &(posSampleHandlerNodePtr->groupLink));
+    NumOfHandlers++;
+
+    AcqRate = SmallestHandlerRate;
 
     LE_DEBUG("Computed Acquisistion rate is %d sec for an average speed of %d km/h",
              rate,
@@ -1199,23 +1356,6 @@ le_pos_MovementHandlerRef_t le_pos_AddMovementHandler
         le_cfg_CommitTxn(posCfg);
     }
 
-    posSampleHandlerNodePtr->horizontalMagnitude = horizontalMagnitude;
-    posSampleHandlerNodePtr->verticalMagnitude = verticalMagnitude;
-
-    // Start acquisition
-    if (NumOfHandlers == 0)
-    {
-        if ((GnssHandlerRef=le_gnss_AddPositionHandler(PosSampleHandlerfunc, NULL)) == NULL)
-        {
-            LE_ERROR("Failed to add PA GNSS's handler!");
-            le_mem_Release(posSampleHandlerNodePtr);
-            return NULL;
-        }
-    }
-
-    le_dls_Queue(&PosSampleHandlerList, &(posSampleHandlerNodePtr->link));
-    NumOfHandlers++;
-
     return (le_pos_MovementHandlerRef_t)posSampleHandlerNodePtr;
 }
 
@@ -13,6 +13,13 @@
  * writes item "bar" the item will be stored as "/app/foo/bar".  Also, if a non-app user "foo"
  * writes item "bar" the item will be stored as "/foo/bar".
  *
+ * The space used by each client is kept in a usage ledger, so that checking the limit on a write
+ * does not require scanning the client's whole area.  The ledger of a client is persisted in a
+ * record under "/usage", followed by the path of the client's area.  The record is deleted before
+ * the client's area is modified, and written again some time after the last modification, so a
+ * record that exists is always up to date.  A client with no record, e.g. after a crash, has its
+ * area scanned once.
+ *
  * <hr>
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -57,6 +64,46 @@
 #define GLOBAL_PATH         "/global"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Path in secure storage to store the usage ledger records of the clients.
+ */
+//--------------------------------------------------------------------------------------------------
+#define USAGE_PATH          "/usage"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Name of a usage ledger record, under USAGE_PATH followed by the path of the client's area.
+ */
+//--------------------------------------------------------------------------------------------------
+#define USAGE_RECORD_NAME   "usedBytes"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number of a usage ledger record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define USAGE_RECORD_MAGIC  0x55535331
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delay, in milliseconds, after the last modification before the usage ledger records are written.
+ */
+//--------------------------------------------------------------------------------------------------
+#define USAGE_FLUSH_DELAY_MS    5000
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expected number of clients, for sizing the client and usage maps.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CLIENT_MAP_SIZE     31
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Current system path.
@@ -163,6 +210,399 @@ Entry_t;
 static le_mem_PoolRef_t EntryPool = NULL;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Client of the le_secStore service, cached for the lifetime of its session.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_msg_SessionRef_t sessionRef;         ///< Session of the client.
+    char name[LIMIT_MAX_USER_NAME_BYTES];   ///< App name, or user name if not an app.
+    bool isApp;                             ///< true if the client is an app.
+    bool isLimitValid;                      ///< true once limit has been read.
+    size_t limit;                           ///< Secure storage limit of the client, in bytes.
+}
+Client_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of clients.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ClientPool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of clients, keyed by session reference.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ClientMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Usage ledger entry of a client's area.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char path[SECSTOREADMIN_MAX_PATH_BYTES]; ///< Path to the client's area.
+    size_t usedBytes;                        ///< Space used by the client's area, if isKnown.
+    bool isKnown;                            ///< true if usedBytes is up to date.
+    bool isRecordCurrent;                    ///< true if the record matches usedBytes.
+    bool mayHaveRecord;                      ///< false if the record is known not to exist.
+}
+Usage_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Usage ledger record, as stored in secure storage.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                         ///< USAGE_RECORD_MAGIC.
+    uint32_t reserved;                      ///< Zero.
+    uint64_t usedBytes;                     ///< Space used by the client's area.
+    uint64_t check;                         ///< Bitwise complement of usedBytes.
+}
+UsageRecord_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of usage ledger entries.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t UsagePool = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map of usage ledger entries, keyed by path to the client's area.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t UsageMap = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer used to write the usage ledger records some time after the last modification.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_timer_Ref_t UsageFlushTimer = NULL;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the path of the usage ledger record of a client's area.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_OVERFLOW if the path does not fit in the buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetUsageRecordPath
+(
+    const char* clientPathPtr,              ///< [IN] Path to the client's area.
+    char* bufPtr,                           ///< [OUT] Buffer to contain the path.
+    size_t bufSize                          ///< [IN] Size of the buffer.
+)
+{
+    bufPtr[0] = '\0';
+
+    return le_path_Concat("/", bufPtr, bufSize, USAGE_PATH, clientPathPtr, USAGE_RECORD_NAME, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the usage ledger entry of a client's area, creating it from its record if there is one.
+ *
+ * @return
+ *      The usage ledger entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static Usage_t* GetUsage
+(
+    const char* clientPathPtr               ///< [IN] Path to the client's area.
+)
+{
+    Usage_t* usagePtr = le_hashmap_Get(UsageMap, clientPathPtr);
+
+    if (usagePtr != NULL)
+    {
+        return usagePtr;
+    }
+
+    usagePtr = le_mem_ForceAlloc(UsagePool);
+
+    LE_ASSERT(le_utf8_Copy(usagePtr->path, clientPathPtr, sizeof(usagePtr->path), NULL) == LE_OK);
+    usagePtr->usedBytes = 0;
+    usagePtr->isKnown = false;
+    usagePtr->isRecordCurrent = false;
+    usagePtr->mayHaveRecord = true;
+
+    // Load the record, if it exists and is valid.
+    char recordPath[SECSTOREADMIN_MAX_PATH_BYTES];
+    UsageRecord_t record;
+    size_t recordSize = sizeof(record);
+
+    if (GetUsageRecordPath(clientPathPtr, recordPath, sizeof(recordPath)) == LE_OK)
+    {
+        le_result_t result = pa_secStore_Read(recordPath, (uint8_t*)&record, &recordSize);
+
+        if (result == LE_NOT_FOUND)
+        {
+            usagePtr->mayHaveRecord = false;
+        }
+        else if ( (result == LE_OK) &&
+                  (recordSize == sizeof(record)) &&
+                  (record.magic == USAGE_RECORD_MAGIC) &&
+                  (record.check == ~record.usedBytes) )
+        {
+            usagePtr->usedBytes = record.usedBytes;
+            usagePtr->isKnown = true;
+            usagePtr->isRecordCurrent = true;
+        }
+    }
+
+    le_hashmap_Put(UsageMap, usagePtr->path, usagePtr);
+
+    return usagePtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes sure that the space used by a client's area is known, scanning the area if needed.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadUsage
+(
+    Usage_t* usagePtr                       ///< [IN] Usage ledger entry.
+)
+{
+    if (usagePtr->isKnown)
+    {
+        return LE_OK;
+    }
+
+    size_t usedBytes = 0;
+    le_result_t result = pa_secStore_GetSize(usagePtr->path, &usedBytes);
+
+    if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+    {
+        return result;
+    }
+
+    LE_DEBUG("Scanned %s: %zu bytes used.", usagePtr->path, usedBytes);
+
+    usagePtr->usedBytes = usedBytes;
+    usagePtr->isKnown = true;
+    usagePtr->isRecordCurrent = false;
+
+    // Write the record later, so that the next scan can be avoided.
+    le_timer_Restart(UsageFlushTimer);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Prepares for the modification of a client's area by deleting its usage ledger record, so that
+ * the record cannot be out of date if the modification is interrupted.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_UNAVAILABLE if the secure storage is currently unavailable.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t BeginUsageUpdate
+(
+    Usage_t* usagePtr                       ///< [IN] Usage ledger entry.
+)
+{
+    if (usagePtr->mayHaveRecord)
+    {
+        char recordPath[SECSTOREADMIN_MAX_PATH_BYTES];
+
+        if (GetUsageRecordPath(usagePtr->path, recordPath, sizeof(recordPath)) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        le_result_t result = pa_secStore_Delete(recordPath);
+
+        if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+        {
+            return result;
+        }
+
+        usagePtr->mayHaveRecord = false;
+    }
+
+    usagePtr->isRecordCurrent = false;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Accounts for the modification of a client's area.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndUsageUpdate
+(
+    Usage_t* usagePtr,                      ///< [IN] Usage ledger entry.
+    le_result_t result,                     ///< [IN] Result of the modification.
+    size_t oldItemSize,                     ///< [IN] Size of the item before the modification.
+    size_t newItemSize                      ///< [IN] Size of the item after the modification.
+)
+{
+    if ( (result == LE_OK) && usagePtr->isKnown && (usagePtr->usedBytes >= oldItemSize) )
+    {
+        usagePtr->usedBytes = usagePtr->usedBytes - oldItemSize + newItemSize;
+    }
+    else
+    {
+        // The area may have been partially modified, so scan it next time.
+        usagePtr->isKnown = false;
+    }
+
+    le_timer_Restart(UsageFlushTimer);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Invalidates the usage ledger entries and records of the clients whose area contains, or is
+ * contained in, the specified path.  This must be called before the path is modified other than
+ * through the le_secStore API.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InvalidateUsage
+(
+    const char* pathPtr                     ///< [IN] Path about to be modified.
+)
+{
+    char recordPath[SECSTOREADMIN_MAX_PATH_BYTES] = "";
+    le_result_t result;
+
+    // Delete the records of the areas under the path, or of the area at the path.
+    if (le_path_Concat("/", recordPath, sizeof(recordPath), USAGE_PATH, pathPtr, NULL) == LE_OK)
+    {
+        result = pa_secStore_Delete(recordPath);
+
+        if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+        {
+            LE_ERROR("Could not delete usage records under '%s'.  %s.",
+                     recordPath, LE_RESULT_TXT(result));
+        }
+
+        // Delete the record of the area containing the path, which is one of its ancestors.
+        char* sepPtr;
+
+        while ( ((sepPtr = strrchr(recordPath, '/')) != NULL) &&
+                (sepPtr - recordPath > (ssize_t)strlen(USAGE_PATH)) )
+        {
+            *sepPtr = '\0';
+
+            char ancestorRecordPath[SECSTOREADMIN_MAX_PATH_BYTES] = "";
+
+            if (le_path_Concat("/", ancestorRecordPath, sizeof(ancestorRecordPath),
+                               recordPath, USAGE_RECORD_NAME, NULL) == LE_OK)
+            {
+                result = pa_secStore_Delete(ancestorRecordPath);
+
+                if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+                {
+                    LE_ERROR("Could not delete usage record '%s'.  %s.",
+                             ancestorRecordPath, LE_RESULT_TXT(result));
+                }
+            }
+        }
+    }
+
+    // Invalidate the entries in memory.
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(UsageMap);
+
+    while (le_hashmap_NextNode(iter) == LE_OK)
+    {
+        Usage_t* usagePtr = le_hashmap_GetValue(iter);
+
+        if ( le_path_IsEquivalent(usagePtr->path, pathPtr, "/") ||
+             le_path_IsSubpath(usagePtr->path, pathPtr, "/") ||
+             le_path_IsSubpath(pathPtr, usagePtr->path, "/") )
+        {
+            usagePtr->isKnown = false;
+            usagePtr->isRecordCurrent = false;
+            usagePtr->mayHaveRecord = true;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Timer handler that writes the usage ledger records that are out of date.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushUsage
+(
+    le_timer_Ref_t timerRef                 ///< [IN] Timer.
+)
+{
+    le_hashmap_It_Ref_t iter = le_hashmap_GetIterator(UsageMap);
+
+    while (le_hashmap_NextNode(iter) == LE_OK)
+    {
+        Usage_t* usagePtr = le_hashmap_GetValue(iter);
+        char recordPath[SECSTOREADMIN_MAX_PATH_BYTES];
+
+        if ( (!usagePtr->isKnown) || usagePtr->isRecordCurrent ||
+             (GetUsageRecordPath(usagePtr->path, recordPath, sizeof(recordPath)) != LE_OK) )
+        {
+            continue;
+        }
+
+        UsageRecord_t record =
+        {
+            .magic = USAGE_RECORD_MAGIC,
+            .reserved = 0,
+            .usedBytes = usagePtr->usedBytes,
+            .check = ~(uint64_t)usagePtr->usedBytes
+        };
+
+        // Even a failed write may have left a partial record.
+        usagePtr->mayHaveRecord = true;
+
+        le_result_t result = pa_secStore_Write(recordPath, (uint8_t*)&record, sizeof(record));
+
+        if (result == LE_OK)
+        {
+            usagePtr->isRecordCurrent = true;
+        }
+        else
+        {
+            LE_WARN("Could not write usage record '%s'.  %s.", recordPath, LE_RESULT_TXT(result));
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if the specified system index is in the list.
@@ -376,6 +816,7 @@ static le_result_t SetCurrSystem
         }
 
         // This system is invalid and needs to be deleted.
+        InvalidateUsage(CurrSysPath);
         result = pa_secStore_Delete(CurrSysPath);
         if ((!isReadOnly) && (LE_NOT_FOUND == result))
         {
@@ -401,6 +842,9 @@ static le_result_t SetCurrSystem
                     "Secure storage path '%s...' is too long.",
                     ancestorPath);
 
+        InvalidateUsage(CurrSysPath);
+        InvalidateUsage(ancestorPath);
+
         if (IsEmpty(&FrameworkSystems))
         {
             // If there is only one system then we can just do a move instead of a copy.
@@ -464,6 +908,7 @@ static void RemoveOldSystems
                         SYS_PATH, secIndexPtr->index) >= sizeof(path),
                         "Secure storage path '%s...' is too long.", path);
 
+            InvalidateUsage(path);
             le_result_t result = pa_secStore_Delete(path);
 
             if (result != LE_OK)
@@ -629,6 +1074,69 @@ static le_result_t GetClientName
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the currently connected client of the le_secStore service.  The client's name is looked up
+ * on its first request, and cached until its session is closed.
+ *
+ * This function must be called within an IPC message handler from the client.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t GetClient
+(
+    Client_t** clientPtrPtr                 ///< [OUT] Client.
+)
+{
+    le_msg_SessionRef_t sessionRef = le_secStore_GetClientSessionRef();
+    Client_t* clientPtr = le_hashmap_Get(ClientMap, sessionRef);
+
+    if (clientPtr == NULL)
+    {
+        clientPtr = le_mem_ForceAlloc(ClientPool);
+
+        if (GetClientName(clientPtr->name, sizeof(clientPtr->name), &clientPtr->isApp) != LE_OK)
+        {
+            le_mem_Release(clientPtr);
+            return LE_FAULT;
+        }
+
+        clientPtr->sessionRef = sessionRef;
+        clientPtr->isLimitValid = false;
+        clientPtr->limit = 0;
+
+        le_hashmap_Put(ClientMap, sessionRef, clientPtr);
+    }
+
+    *clientPtrPtr = clientPtr;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Removes a client from the cache when its session is closed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CleanupClient
+(
+    le_msg_SessionRef_t sessionRef,
+    void*               contextPtr
+)
+{
+    Client_t* clientPtr = le_hashmap_Remove(ClientMap, sessionRef);
+
+    if (clientPtr != NULL)
+    {
+        le_mem_Release(clientPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the path to the client's area in secure storage.  If the client is an application the path
@@ -664,7 +1172,8 @@ static void GetClientPath
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks if there is enough space in the client's area of secure storage for the client to write
- * the item.
+ * the item.  The space used by the client is taken from its usage ledger entry, so only the
+ * existing item, if any, is looked up.
  *
  * @return
  *      LE_OK if the item would fit in the client's area of secure storage.
@@ -675,39 +1184,38 @@ static void GetClientPath
 //--------------------------------------------------------------------------------------------------
 static le_result_t CheckClientLimit
 (
-    const char* clientNamePtr,              ///< [IN] Name of the client.
-    const char* clientPathPtr,              ///< [IN] Path to the client's area in secure storage.
-    const char* itemNamePtr,                ///< [IN] Name of the item.
-    size_t itemSize                         ///< [IN] Size, in bytes, of the item.
+    Client_t* clientPtr,                    ///< [IN] Client.
+    Usage_t* usagePtr,                      ///< [IN] Usage ledger entry of the client's area.
+    const char* itemPathPtr,                ///< [IN] Path of the item.
+    size_t itemSize,                        ///< [IN] Size, in bytes, of the item.
+    size_t* origItemSizePtr                 ///< [OUT] Size, in bytes, of the existing item.
 )
 {
     // Get the secure storage limit for the client.
-    appCfg_Iter_t iter = appCfg_FindApp(clientNamePtr);
-    if (!iter)
+    if (!clientPtr->isLimitValid)
     {
-       LE_ERROR("iter is NULL");
-       return LE_FAULT;
+        appCfg_Iter_t iter = appCfg_FindApp(clientPtr->name);
+        if (!iter)
+        {
+           LE_ERROR("iter is NULL");
+           return LE_FAULT;
+        }
+        clientPtr->limit = appCfg_GetSecStoreLimit(iter);
+        clientPtr->isLimitValid = true;
+        appCfg_DeleteIter(iter);
     }
-    size_t secStoreLimit = appCfg_GetSecStoreLimit(iter);
-    appCfg_DeleteIter(iter);
 
     // Get the current amount of space used by the client.
-    size_t usedSpace = 0;
-    le_result_t result = pa_secStore_GetSize(clientPathPtr, &usedSpace);
+    le_result_t result = LoadUsage(usagePtr);
 
-    if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
+    if (result != LE_OK)
     {
         return result;
     }
 
     // Get the size of the item in the secure storage if it already exists.
-    char itemPath[SECSTOREADMIN_MAX_PATH_BYTES] = "";
-
-    LE_FATAL_IF(le_path_Concat("/", itemPath, sizeof(itemPath), clientPathPtr, itemNamePtr, NULL) != LE_OK,
-                "Client %s's path for item %s is too long.", clientNamePtr, itemNamePtr);
-
-    size_t origItemSize = 0;
-    result = pa_secStore_GetSize(itemPath, &origItemSize);
+    *origItemSizePtr = 0;
+    result = pa_secStore_GetSize(itemPathPtr, origItemSizePtr);
 
     if ( (result != LE_OK) && (result != LE_NOT_FOUND) )
     {
@@ -715,7 +1223,7 @@ static le_result_t CheckClientLimit
     }
 
     // Calculate if replacing the item would fit within the limit.
-    if (((ssize_t)(secStoreLimit - usedSpace + origItemSize - itemSize)) >= 0)
+    if (((ssize_t)(clientPtr->limit - usagePtr->usedBytes + *origItemSizePtr - itemSize)) >= 0)
     {
         return LE_OK;
     }
@@ -814,6 +1322,8 @@ static le_result_t Write
 
     char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
     le_result_t result;
+    Usage_t* usagePtr = NULL;
+    size_t origItemSize = 0;
 
     if(isGlobal)
     {
@@ -824,34 +1334,46 @@ static le_result_t Write
     else
     {
         // Get the client's name and see if it is an app.
-        bool isApp;
-        char clientName[LIMIT_MAX_USER_NAME_BYTES];
+        Client_t* clientPtr;
 
-        if (GetClientName(clientName, sizeof(clientName), &isApp) != LE_OK)
+        if (GetClient(&clientPtr) != LE_OK)
         {
             LE_KILL_CLIENT("Could not get the client's name.");
             return LE_FAULT;
         }
 
-        // Get the path to the client's secure storage area.
-        GetClientPath(clientName, isApp, path, sizeof(path));
+        // Get the path to the client's secure storage area, and its usage.
+        GetClientPath(clientPtr->name, clientPtr->isApp, path, sizeof(path));
+        usagePtr = GetUsage(path);
+
+        // Append item name to client path.
+        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
+                    "Client %s's path for item %s is too long.", clientPtr->name, name);
 
         // Check the available limit for the client.
-        result = CheckClientLimit(clientName, path, name, bufNumElements);
+        result = CheckClientLimit(clientPtr, usagePtr, path, bufNumElements, &origItemSize);
 
         if (result != LE_OK)
         {
             return result;
         }
 
-        // Append item name to client path.
-        LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
-                    "Client %s's path for item %s is too long.", clientName, name);
+        result = BeginUsageUpdate(usagePtr);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
     }
 
     // Write the item to the secure storage.
     result = pa_secStore_Write(path, bufPtr, bufNumElements);
 
+    if (usagePtr != NULL)
+    {
+        EndUsageUpdate(usagePtr, result, origItemSize, bufNumElements);
+    }
+
     if (result == LE_BAD_PARAMETER)
     {
         return LE_FAULT;
@@ -963,21 +1485,20 @@ static le_result_t Read
     else
     {
         // Get the client's name and see if it is an app.
-        bool isApp;
-        char clientName[LIMIT_MAX_USER_NAME_BYTES];
+        Client_t* clientPtr;
 
-        if (GetClientName(clientName, sizeof(clientName), &isApp) != LE_OK)
+        if (GetClient(&clientPtr) != LE_OK)
         {
             LE_KILL_CLIENT("Could not get the client's name.");
             return LE_FAULT;
         }
 
         // Get the path to the client's secure storage area.
-        GetClientPath(clientName, isApp, path, sizeof(path));
+        GetClientPath(clientPtr->name, clientPtr->isApp, path, sizeof(path));
 
         // Append item name to client path.
         LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
-                    "Client %s's path for item %s is too long.", clientName, name);
+                    "Client %s's path for item %s is too long.", clientPtr->name, name);
     }
 
     // Read the item from the secure storage.
@@ -1075,6 +1596,9 @@ le_result_t Delete
     }
 
     char path[SECSTOREADMIN_MAX_PATH_BYTES] = {0};
+    le_result_t result;
+    Usage_t* usagePtr = NULL;
+    size_t itemSize = 0;
 
     if(isGlobal)
     {
@@ -1085,25 +1609,47 @@ le_result_t Delete
     else
     {
         // Get the client's name and see if it is an app.
-        bool isApp;
-        char clientName[LIMIT_MAX_USER_NAME_BYTES];
+        Client_t* clientPtr;
 
-        if (GetClientName(clientName, sizeof(clientName), &isApp) != LE_OK)
+        if (GetClient(&clientPtr) != LE_OK)
         {
             LE_KILL_CLIENT("Could not get the client's name.");
             return LE_FAULT;
         }
 
-        // Get the path to the client's secure storage area.
-        GetClientPath(clientName, isApp, path, sizeof(path));
+        // Get the path to the client's secure storage area, and its usage.
+        GetClientPath(clientPtr->name, clientPtr->isApp, path, sizeof(path));
+        usagePtr = GetUsage(path);
 
         // Append item name to client path.
         LE_FATAL_IF(le_path_Concat("/", path, sizeof(path), name, NULL) != LE_OK,
-                    "Client %s's path for item %s is too long.", clientName, name);
+                    "Client %s's path for item %s is too long.", clientPtr->name, name);
+
+        // Get the size of the item, which may also be a directory of items.
+        result = pa_secStore_GetSize(path, &itemSize);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        result = BeginUsageUpdate(usagePtr);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
     }
 
     // Delete the item from the secure storage.
-    return pa_secStore_Delete(path);
+    result = pa_secStore_Delete(path);
+
+    if (usagePtr != NULL)
+    {
+        EndUsageUpdate(usagePtr, result, itemSize, 0);
+    }
+
+    return result;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1543,6 +2089,7 @@ le_result_t secStoreAdmin_Write
     }
 
     // Write the item to the secure storage.
+    InvalidateUsage(path);
     return pa_secStore_Write(path, bufPtr, bufNumElements);
 }
 
@@ -1647,6 +2194,7 @@ le_result_t secStoreAdmin_Delete
     }
 
     // Delete the item from the secure storage.
+    InvalidateUsage(path);
     return pa_secStore_Delete(path);
 }
 
@@ -1738,8 +2286,27 @@ COMPONENT_INIT
 
     SystemIndexPool = le_mem_CreatePool("SystemIndexPool", sizeof(SystemsIndex_t));
 
+    ClientPool = le_mem_CreatePool("ClientPool", sizeof(Client_t));
+    ClientMap = le_hashmap_Create("ClientMap",
+                                  CLIENT_MAP_SIZE,
+                                  le_hashmap_HashVoidPointer,
+                                  le_hashmap_EqualsVoidPointer);
+
+    UsagePool = le_mem_CreatePool("UsagePool", sizeof(Usage_t));
+    UsageMap = le_hashmap_Create("UsageMap",
+                                 CLIENT_MAP_SIZE,
+                                 le_hashmap_HashString,
+                                 le_hashmap_EqualsString);
+
+    UsageFlushTimer = le_timer_Create("UsageFlushTimer");
+    LE_ASSERT(le_timer_SetMsInterval(UsageFlushTimer, USAGE_FLUSH_DELAY_MS) == LE_OK);
+    LE_ASSERT(le_timer_SetHandler(UsageFlushTimer, FlushUsage) == LE_OK);
+
     // Register a handler that will clean up client specific data when clients disconnect.
     le_msg_AddServiceCloseHandler(secStoreAdmin_GetServiceRef(),
                                   CleanupClientIterators,
                                   NULL);
+    le_msg_AddServiceCloseHandler(le_secStore_GetServiceRef(),
+                                  CleanupClient,
+                                  NULL);
 }
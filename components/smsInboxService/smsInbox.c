@@ -2,18 +2,20 @@
 /**
  *  SMS Inbox Server
  *
- * When the service is activated, or when a SMS is received, the SMS is copied from the SIM to a
- * specific folder (SMSINBOX_PATH/MSG_PATH).
+ * When the service is activated, or when a SMS is received, the SMS is moved from the SIM to the
+ * message store in SMSINBOX_PATH/STORE_PATH (see smsInboxStore.h).
  *
- * Each SMS is copied into a dedicated file (named with a unique message identifier). The data
- * are stored using the Jannsson representation: Each data (imsi, SMS format, message length,
- * text/pdu, sender telephone number, timestamp, read/unread) are recorded with a key to retrieve
- * each value.
+ * Each SMS is stored as one record of the store, identified by a unique message identifier. The
+ * record holds a MsgHeader_t (SMS format, message length, size of each field) followed by the
+ * imsi, the sender telephone number, the timestamp and the text/binary/pdu payload.
  *
- * Each application using the SMS Inbox Server possesses a configuration file in
- * SMSINBOX_PATH/CONF_PATH directory (also encoding using Jansson format): this file is used to
- * store the message identifier contained in the application mailbox. It is updated each time is new
- * SMS is received.
+ * The store keeps, for each message, the mailboxes of the applications using the SMS Inbox Server
+ * and whether the message is unread in each of them. The message is deleted once it has been
+ * deleted from all the mailboxes.
+ *
+ * Previous versions stored each SMS in a Jansson file of SMSINBOX_PATH/MSG_PATH, and the content
+ * of each mailbox in a Jansson file of SMSINBOX_PATH/CONF_PATH. These files are imported in the
+ * store at start-up, then removed.
  *
  *  Copyright (C) Sierra Wireless Inc.
  */
@@ -23,6 +25,7 @@
 #include "interfaces.h"
 #include "mdmCfgEntries.h"
 #include "le_smsInbox.h"
+#include "smsInboxStore.h"
 
 #include "le_print.h"
 #include "le_hex.h"
@@ -40,14 +43,15 @@
  */
 //--------------------------------------------------------------------------------------------------
 #define SMSINBOX_PATH "/data/smsInbox/"
-#define MSG_PATH "msg/"
-#define CONF_PATH "cfg/"
+#define STORE_PATH "store"
 
 //--------------------------------------------------------------------------------------------------
 /**
- * File extension definition.
+ * Directories and file extension of the Jansson files of previous versions.
  */
 //--------------------------------------------------------------------------------------------------
+#define MSG_PATH "msg/"
+#define CONF_PATH "cfg/"
 #define FILE_EXTENSION ".json"
 
 //--------------------------------------------------------------------------------------------------
@@ -64,7 +68,6 @@
 #define JSON_MSGLEN "msgLen"
 #define JSON_TIMESTAMP "timestamp"
 #define JSON_ISUNREAD "isUnread"
-#define JSON_ISDELETED "isDeleted"
 #define JSON_MSGINBOX "msgInBox"
 
 //--------------------------------------------------------------------------------------------------
@@ -88,6 +91,15 @@
 //--------------------------------------------------------------------------------------------------
 #define MAX_NUM_OF_LIST    MAX_APPS
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Message header flags.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSG_HAS_TEL         0x01
+#define MSG_HAS_TIMESTAMP   0x02
+#define MSG_HAS_PAYLOAD     0x04
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The config tree path and node definitions.
@@ -117,44 +129,53 @@ typedef uint32_t MessageId_t;
 /**
  * Browsing structure.
  *
+ * Messages received after the GetFirst call are not listed.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    json_t* jsonObjPtr;
-    json_t* jsonArrayPtr;
-    uint32_t currentMessageIndex;
-    uint32_t maxIndex;
+    MessageId_t lastMessageId;      ///< Last message returned
+    MessageId_t maxMessageId;       ///< Last message received when the browsing started
 }
 BrowseCtx_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Entry description structure.
+ * Header of a message in the store.
  *
+ * The header is followed by the imsi, the sender telephone number, the timestamp and the
+ * payload, without terminating null characters.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    enum
-    {
-        DESC_INT,
-        DESC_STRING,
-        DESC_BOOL
-    }                               type;       ///< Union type (string or integer
-    union
-    {
-        struct
-        {
-            char*   strPtr;                     ///< String
-            size_t  lenStr;                     ///< Length of the string
-        }                  str;                 ///< Value for string
-        uint32_t           val;                 ///< Value for integer
-        bool               boolVal;             ///< Boolean value
-    }                               uVal;       ///< Union type
+    int32_t  format;                ///< SMS format
+    uint32_t msgLen;                ///< Message length
+    uint16_t payloadSize;           ///< Payload size, in bytes
+    uint8_t  imsiSize;              ///< Imsi size, in bytes
+    uint8_t  telSize;               ///< Sender telephone number size, in bytes
+    uint8_t  timeStampSize;         ///< Timestamp size, in bytes
+    uint8_t  flags;                 ///< MSG_HAS_xxx flags
+    uint8_t  reserved[2];           ///< Reserved, set to 0
 }
-EntryDesc_t;
+MsgHeader_t;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decoded message.
+ *
+ * The fields point into the buffer the message is read in.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MsgHeader_t    header;          ///< Message header
+    const char*    imsiPtr;         ///< Imsi
+    const char*    telPtr;          ///< Sender telephone number
+    const char*    timeStampPtr;    ///< Timestamp
+    const uint8_t* payloadPtr;      ///< Text, binary or pdu payload
+}
+Msg_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -293,14 +314,6 @@ static uint32_t MaxInboxSize;
 //--------------------------------------------------------------------------------------------------
 static char SimImsi[LE_SIM_IMSI_BYTES];
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Next message Identifier
- *
- */
-//--------------------------------------------------------------------------------------------------
-static MessageId_t NextMessageId = 1;
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Memory Pool for SmsInbox Client Handler.
@@ -318,1126 +331,730 @@ static le_ref_MapRef_t ActivationRequestRefMap;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a boolean value of a key in a Jason object
+ * Get the store mailbox of a message box.
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddBooleanKeyInJsonObject
+static uint8_t GetMboxIndex
 (
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    bool value          ///<[IN] Value to be added
+    MboxCtx_t* mboxCtxPtr   ///<[IN] message box
 )
 {
-    json_t *jsonBoolPtr;
-    int ret = -1;
-
-    if ( value == true )
-    {
-        jsonBoolPtr = json_true();
-    }
-    else
-    {
-        jsonBoolPtr = json_false();
-    }
-
-    if (jsonBoolPtr)
-    {
-        ret = json_object_set_new(jsonObjPtr, key, jsonBoolPtr);
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
+    return (uint8_t)(mboxCtxPtr - Apps);
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Add an integer value of a key in a Jason object
+ * Check if a message belongs to a message box
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddIntegerKeyInJsonObject
+static le_result_t CheckMessageIdInMbox
 (
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    int  value          ///<[IN] Value to be added
+    MboxCtx_t* mboxCtxPtr,  ///<[IN] message box
+    MessageId_t messageId   ///<[IN] Message identifier
 )
 {
-    json_t *jsonIntPtr = json_integer(value);
-    int ret = -1;
-
-    if (jsonIntPtr)
-    {
-        if (json_is_array(jsonObjPtr))
-        {
-            ret = json_array_append_new(jsonObjPtr, jsonIntPtr);
-        }
-        else
-        {
-            ret = json_object_set_new(jsonObjPtr, key, jsonIntPtr);
-        }
-    }
-    else
-    {
-        LE_ERROR("Error during set of the key %s", key);
-    }
-
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
+    if (!SmsInboxStore_IsInMbox(messageId, GetMboxIndex(mboxCtxPtr)))
     {
+        LE_ERROR("Bad msg id or mbox name");
         return LE_FAULT;
     }
+
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a string value of a key in a Jason object
+ * Append a string field to a message being encoded
  *
+ * @return Size of the field, in bytes
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddStringKeyInJsonObject
+static uint8_t AppendMsgField
 (
-    json_t *jsonObjPtr, ///<[IN] json object
-    const char* key,    ///<[IN] Key to be added
-    char* string        ///<[IN] String to be added
+    uint8_t* bufPtr,        ///<[IN] Message buffer
+    size_t* offsetPtr,      ///<[INOUT] Offset of the field in the buffer
+    const char* strPtr      ///<[IN] Field value
 )
 {
-    json_t * jsonStrPtr = json_string(string);
-    int ret = -1;
+    size_t len = strnlen(strPtr, UINT8_MAX);
 
-    if (jsonStrPtr)
-    {
-        ret = json_object_set_new(jsonObjPtr, key, jsonStrPtr);
-    }
-    else
+    if (len > SMSINBOXSTORE_MAX_DATA_BYTES - *offsetPtr)
     {
-        LE_ERROR("Error during set of the key %s", key);
+        len = SMSINBOXSTORE_MAX_DATA_BYTES - *offsetPtr;
     }
 
-    if (ret == 0)
-    {
-        return LE_OK;
-    }
-    else
-    {
-        return LE_FAULT;
-    }
-}
+    memcpy(bufPtr + *offsetPtr, strPtr, len);
+    *offsetPtr += len;
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Get the SMSInbox directory path length
- *
- */
-//--------------------------------------------------------------------------------------------------
-static uint32_t GetSMSInboxMessagePathLen
-(
-    void
-)
-{
-    return 2*sizeof(MessageId_t)+strlen(SMSINBOX_PATH)+strlen(MSG_PATH)+strlen(FILE_EXTENSION)+1;
+    return (uint8_t)len;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Get the SMSInbox file path
+ * Encode a SMS as a message of the store
  *
+ * @return Size of the message, in bytes
  */
 //--------------------------------------------------------------------------------------------------
-static void GetSMSInboxMessagePath
+static size_t EncodeMsgEntry
 (
-    MessageId_t messageId,  ///[IN] message identifier
-    char* pathPtr,          ///<[OUT] path of the messageId file
-    uint32_t pathLen        ///<[IN] Length of pathPtr
+    le_sms_MsgRef_t msgRef, ///<[IN] SMS to be encoded
+    uint8_t* bufPtr         ///<[OUT] Message buffer, of SMSINBOXSTORE_MAX_DATA_BYTES bytes
 )
 {
-    snprintf(pathPtr, pathLen, "%s%s%08x%s", SMSINBOX_PATH, MSG_PATH,
-                                            (int) messageId,
-                                            FILE_EXTENSION);
-}
+    MsgHeader_t header;
+    size_t offset = sizeof(MsgHeader_t);
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Get the SMSInbox configuration path length
- *
- */
-//--------------------------------------------------------------------------------------------------
-static uint32_t GetSMSInboxConfigPathLen
-(
-    char* appNamePtr    ///<[IN] Application name
-)
-{
-    return strlen(appNamePtr)+strlen(SMSINBOX_PATH)+strlen(CONF_PATH)+strlen(FILE_EXTENSION)+1;
-}
+    memset(&header, 0, sizeof(header));
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Get the application's box file descriptor path
- *
- */
-//--------------------------------------------------------------------------------------------------
-static void GetSMSInboxConfigPath
-(
-    char* appNamePtr,   ///<[IN] Application name
-    char* pathPtr,      ///<[OUT] configuration file path
-    uint32_t pathLen    ///<[IN] path length
-)
-{
-    snprintf(pathPtr, pathLen, "%s%s%s%s", SMSINBOX_PATH, CONF_PATH, appNamePtr, FILE_EXTENSION);
-}
+    // Add imsi
+    header.imsiSize = AppendMsgField(bufPtr, &offset, SimImsi);
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Modify Json object
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t ModifyJsonObj
-(
-    json_t* jsonObjPtr,         ///<[IN] Json object (root object)
-    json_t* jsonValPtr,         ///<[IN] Json value to be modified
-    char*   key,                ///<[IN] Key to modify
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
-)
-{
-    int res = 0;
+    // Add sms format
+    le_sms_Format_t format = le_sms_GetFormat(msgRef);
+    header.format = (int32_t) format;
 
-    if (jsonValPtr == NULL)
+    switch ( format )
     {
-        return LE_FAULT;
-    }
+        case LE_SMS_FORMAT_TEXT:
+        case LE_SMS_FORMAT_BINARY:
+        {
+            char tel[LE_MDMDEFS_PHONE_NUM_MAX_BYTES];
+            memset(tel,0,LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
 
-    switch (modifPtr->type)
-    {
-        case DESC_STRING:
-            // check the type
-            if (json_is_string(jsonValPtr) == false)
+            // Add phone number
+            le_result_t result = le_sms_GetSenderTel(msgRef, tel, LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
+
+            if (result != LE_OK)
             {
-                LE_ERROR("Bad key format");
-                res = -1;
+                LE_ERROR("Unable to get the tel number %d", result);
+            }
+            else
+            {
+                LE_DEBUG("tel num: %s", tel);
+                header.telSize = AppendMsgField(bufPtr, &offset, tel);
+                header.flags |= MSG_HAS_TEL;
             }
 
-            if ( res == 0 )
+            // Add timestamp
+            char timeStamp[LE_SMS_TIMESTAMP_MAX_BYTES];
+            memset(timeStamp,0,LE_SMS_TIMESTAMP_MAX_BYTES);
+            result = le_sms_GetTimeStamp (msgRef, timeStamp, LE_SMS_TIMESTAMP_MAX_BYTES);
+
+            if (result != LE_OK)
             {
-                res = json_string_set(jsonValPtr, modifPtr->uVal.str.strPtr);
+                LE_ERROR("Unable to get the timestamp %d", result);
             }
-        break;
-        case DESC_INT:
-            // check the type
-            if (json_is_integer(jsonValPtr) == false )
+            else
             {
-                LE_ERROR("Bad key format");
-                res = -1;
+                LE_DEBUG("timestamp: %s", timeStamp);
+                header.timeStampSize = AppendMsgField(bufPtr, &offset, timeStamp);
+                header.flags |= MSG_HAS_TIMESTAMP;
             }
 
-            if ( res == 0 )
+            size_t len = le_sms_GetUserdataLen(msgRef);
+            header.msgLen = len;
+
+            // Add a character for last '\0'
+            len++;
+
+            if (len > SMSINBOXSTORE_MAX_DATA_BYTES - offset)
+            {
+                LE_ERROR("Payload too long %zu", len);
+                result = LE_OVERFLOW;
+            }
+            else if (format == LE_SMS_FORMAT_TEXT)
+            {
+                // Get text
+                result = le_sms_GetText(msgRef, (char*) bufPtr + offset, len);
+            }
+            else
+            {
+                // Get binary
+                result = le_sms_GetBinary(msgRef, bufPtr + offset, &len);
+            }
+
+            if (result != LE_OK)
+            {
+                LE_ERROR("Unable to get payload %d", result);
+                header.msgLen = 0;
+            }
+            else
             {
-                res = json_integer_set(jsonValPtr, modifPtr->uVal.val);
+                header.payloadSize = len;
+                header.flags |= MSG_HAS_PAYLOAD;
+                offset += len;
             }
+        }
         break;
-        case DESC_BOOL:
-            // check the type
-            if ( (json_is_true(jsonValPtr) != true) && (json_is_false(jsonValPtr) != true) )
+
+        case LE_SMS_FORMAT_PDU:
+        {
+            size_t len = le_sms_GetPDULen(msgRef);
+            header.msgLen = len;
+            // Add a character for last '\0'
+            len++;
+            le_result_t result;
+
+            // Add pdu
+            if (len > SMSINBOXSTORE_MAX_DATA_BYTES - offset)
             {
-                LE_ERROR("Bad key format");
-                res = -1;
+                LE_ERROR("PDU too long %zu", len);
+                result = LE_OVERFLOW;
+            }
+            else
+            {
+                result = le_sms_GetPDU(msgRef, bufPtr + offset, &len);
             }
 
-            if (( res == 0 ) &&
-                (AddBooleanKeyInJsonObject(jsonObjPtr, key, modifPtr->uVal.boolVal) != LE_OK))
+            if (result != LE_OK)
             {
-                res = -1;
+                LE_ERROR("Unable to get pdu %d", result);
+                header.msgLen = 0;
             }
+            else
+            {
+                header.payloadSize = len;
+                header.flags |= MSG_HAS_PAYLOAD;
+                offset += len;
+            }
+        }
         break;
+        case LE_SMS_FORMAT_UNKNOWN:
         default:
-            res = -1;
-        break;
+            LE_ERROR("Bad format %d", format);
     }
 
-    if (res < 0)
-    {
-        LE_ERROR(("Update error %d"), modifPtr->type);
-        return LE_FAULT;
-    }
-    else
-    {
-        return LE_OK;
-    }
+    memcpy(bufPtr, &header, sizeof(header));
 
+    return offset;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Modify message file
+ * Decode a message of the store
  *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT if the message is corrupted
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ModifyMsgEntry
+static le_result_t DecodeMsgEntry
 (
-    MessageId_t messageId,      ///<[IN] Message identifier to be modified
-    char* keyPtr[],              ///<[IN] Key to modify
-    uint8_t nbKey,              ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * modifPtr      ///<[IN] Requested modification
+    const uint8_t* bufPtr,  ///<[IN] Message buffer
+    size_t bufSize,         ///<[IN] Message size
+    Msg_t* msgPtr           ///<[OUT] Decoded message
 )
 {
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    json_error_t error;
-    le_result_t res;
-    int indexKey = -1;
-
-    GetSMSInboxMessagePath(messageId, path, pathLen);
-
-    json_t* jsonRootPtr = json_load_file(path, 0, &error);
-
-    if (NULL == jsonRootPtr)
+    if (bufSize < sizeof(MsgHeader_t))
     {
-        LE_ERROR("json decoder error %s", error.text);
+        LE_ERROR("Message too short %zu", bufSize);
         return LE_FAULT;
     }
 
-    json_t* jsonValPtr = jsonRootPtr;
-    json_t* jsonSubObjPtr = jsonRootPtr;
-
-    while ((true == json_is_object(jsonValPtr)) && (nbKey > indexKey))
-    {
-        indexKey++;
-        jsonSubObjPtr = jsonValPtr;
-        jsonValPtr = json_object_get(jsonSubObjPtr, keyPtr[indexKey]);
-    }
-
-    if (!jsonValPtr)
-    {
-        if ((indexKey > -1) && (indexKey < nbKey))
-        {
-            LE_ERROR("Unable to get the object %s", keyPtr[indexKey]);
-        }
-        else
-        {
-            LE_ERROR("indexKey: %d is out of range", indexKey);
-        }
-
-        res = LE_FAULT;
-    }
-    else
-    {
-        res = ModifyJsonObj(jsonSubObjPtr, jsonValPtr, keyPtr[indexKey], modifPtr);
-    }
+    memcpy(&msgPtr->header, bufPtr, sizeof(MsgHeader_t));
 
-    if (LE_OK == res)
-    {
-        if (json_dump_file(jsonRootPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0)
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
-    }
-    else
+    if (bufSize != sizeof(MsgHeader_t) + msgPtr->header.imsiSize + msgPtr->header.telSize
+                   + msgPtr->header.timeStampSize + msgPtr->header.payloadSize)
     {
-        LE_ERROR("Something was wrong in ModifyJsonObj");
+        LE_ERROR("Bad message size %zu", bufSize);
+        return LE_FAULT;
     }
 
-    json_decref(jsonRootPtr);
+    msgPtr->imsiPtr = (const char*) bufPtr + sizeof(MsgHeader_t);
+    msgPtr->telPtr = msgPtr->imsiPtr + msgPtr->header.imsiSize;
+    msgPtr->timeStampPtr = msgPtr->telPtr + msgPtr->header.telSize;
+    msgPtr->payloadPtr = (const uint8_t*) msgPtr->timeStampPtr + msgPtr->header.timeStampSize;
 
-    return res;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read Json object
+ * Read and decode a message of a message box
  *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT if the message can't be read
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t ReadJsonObj
+static le_result_t ReadMsgEntry
 (
-    json_t* jsonValPtr,         ///<[IN] Json value to be read
-    char* keyPtr[],             ///<[IN] Key to read
-    uint8_t nbKey,              ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * decodePtr     ///<[OUT] Decoding result
+    MessageId_t messageId,  ///<[IN] Message identifier
+    uint8_t* bufPtr,        ///<[OUT] Message buffer, of SMSINBOXSTORE_MAX_DATA_BYTES bytes
+    Msg_t* msgPtr           ///<[OUT] Decoded message
 )
 {
-    le_result_t res = LE_OK;
+    size_t bufSize = SMSINBOXSTORE_MAX_DATA_BYTES;
 
-    if ( jsonValPtr == NULL )
+    if (SmsInboxStore_Read(messageId, bufPtr, &bufSize) != LE_OK)
     {
-        LE_ERROR("No information");
+        LE_ERROR("Unable to read message %08x", (int) messageId);
         return LE_FAULT;
     }
 
-    switch json_typeof(jsonValPtr)
-    {
-        case JSON_STRING:
-        {
-            if ( decodePtr->type != DESC_STRING )
-            {
-                res = LE_FAULT;
-                LE_ERROR("Bad format");
-            }
-
-            if (res == LE_OK)
-            {
-                const char* strPtr = json_string_value((const json_t *)jsonValPtr);
-
-                if ( strlen(strPtr) >= decodePtr->uVal.str.lenStr )
-                {
-                    LE_ERROR("String too long");
-                    res = LE_OVERFLOW;
-                }
-                else
-                {
-                    strcpy(decodePtr->uVal.str.strPtr, strPtr);
-                    decodePtr->uVal.str.lenStr = strlen(strPtr);
-                }
-            }
-        }
-        break;
-        case JSON_INTEGER:
-        {
-            if ( decodePtr->type != DESC_INT )
-            {
-                LE_ERROR("Bad format");
-                res = LE_FAULT;
-            }
-            else
-            {
-                decodePtr->uVal.val = json_integer_value((const json_t *)jsonValPtr);
-            }
-        }
-        break;
-        case JSON_TRUE:
-        case JSON_FALSE:
-        {
-            if ( decodePtr->type != DESC_BOOL )
-            {
-                LE_ERROR("Bad format");
-                res = LE_FAULT;
-            }
-            else
-            {
-                decodePtr->uVal.boolVal = json_is_true((const json_t *)jsonValPtr);
-            }
-        }
-        break;
-        case JSON_OBJECT:
-        {
-            // if key-value is an object, read the next key
-            if (nbKey >= 1)
-            {
-                json_t* jsonSubValPtr = json_object_get(jsonValPtr, keyPtr[0]);
-
-                if ( jsonSubValPtr )
-                {
-                    res = ReadJsonObj(jsonSubValPtr, &keyPtr[1], nbKey-1,  decodePtr );
-                }
-                else
-                {
-                    res = LE_FAULT;
-                }
-            }
-            else
-            {
-                res = LE_FAULT;
-            }
-        }
-        break;
-        case JSON_ARRAY:
-        case JSON_REAL:
-        case JSON_NULL:
-        default:
-            res = LE_FAULT;
-        break;
-    }
-
-    return res;
+    return DecodeMsgEntry(bufPtr, bufSize, msgPtr);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read Application's config file
+ * Copy a string field of a message
  *
+ * @return
+ *  - LE_OK on success
+ *  - LE_OVERFLOW if the string buffer is too small
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t GetMsgListFromMbox
+static le_result_t CopyMsgField
 (
-    char* pathPtr,              ///<[IN] Application's config file path
-    json_t **jsonRootObjPtr,    ///<[OUT] json root object
-    json_t **jsonArrayPtr       ///<[OUT] messages in box list
+    const char* fieldPtr,   ///<[IN] Field value
+    size_t fieldSize,       ///<[IN] Field size
+    char* strPtr,           ///<[OUT] String buffer
+    size_t strNumElements   ///<[IN] String buffer size
 )
 {
-    json_error_t error;
-    *jsonRootObjPtr = json_load_file(pathPtr, 0, &error);
-
-    if ( !(*jsonRootObjPtr) )
+    if (fieldSize >= strNumElements)
     {
-        // File doesn't exist, create objects
-        *jsonRootObjPtr = json_object();
-
-        if ( !(*jsonRootObjPtr) )
-        {
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
+        LE_ERROR("String too long");
+        return LE_OVERFLOW;
     }
 
-    *jsonArrayPtr = json_object_get(*jsonRootObjPtr, JSON_MSGINBOX);
-
-    if ( !(*jsonArrayPtr) )
-    {
-        // Array doesn't exist, create it
-        *jsonArrayPtr = json_array();
-
-        if (!(*jsonArrayPtr))
-        {
-            json_decref(*jsonRootObjPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
-
-        if ( json_object_set(*jsonRootObjPtr, JSON_MSGINBOX, *jsonArrayPtr) < 0 )
-        {
-            json_decref(*jsonRootObjPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
-    }
+    memcpy(strPtr, fieldPtr, fieldSize);
+    strPtr[fieldSize] = '\0';
 
     return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove a message from the application's cfg file
+ * Copy the payload of a message
  *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT if the message has no payload of this format
+ *  - LE_OVERFLOW if the buffer is too small
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t DeleteMsgInAppCfg
+static le_result_t CopyMsgPayload
 (
-    char *appNamePtr,               ///<[IN] application name
-    MessageId_t deleteMessageId     ///<[IN] message to delete
+    const Msg_t* msgPtr,        ///<[IN] Decoded message
+    le_sms_Format_t format,     ///<[IN] Expected format
+    uint8_t* bufPtr,            ///<[OUT] Payload buffer
+    size_t* bufNumElementsPtr   ///<[INOUT] Payload buffer size, then payload size
 )
 {
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appNamePtr);
-    char path[pathLen];
-    memset(path,0,pathLen);
-    GetSMSInboxConfigPath(appNamePtr, path, pathLen);
-    json_t *jsonObjPtr;
-    json_t *jsonArrayPtr;
-
-    if (GetMsgListFromMbox(path, &jsonObjPtr, &jsonArrayPtr) != LE_OK)
+    if ((msgPtr->header.format != (int32_t) format) || !(msgPtr->header.flags & MSG_HAS_PAYLOAD))
     {
+        LE_ERROR("No information");
         return LE_FAULT;
     }
 
-    int i;
-    MessageId_t messageId;
-
-    for (i=0; i < json_array_size(jsonArrayPtr); i++)
+    if (msgPtr->header.payloadSize > *bufNumElementsPtr)
     {
-        json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
-
-        if (jsonIntegerPtr)
-        {
-            messageId = json_integer_value(jsonIntegerPtr);
-
-            if (messageId == deleteMessageId)
-            {
-                LE_DEBUG("Remove %d", (int) messageId);
-                json_array_remove(jsonArrayPtr, i);
-            }
-        }
-        else
-        {
-            LE_ERROR("Json error");
-        }
-    }
-
-    le_result_t res = LE_OK;
-    if ( json_dump_file(jsonObjPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
-    {
-        res = LE_FAULT;
+        LE_ERROR("Payload too long");
+        return LE_OVERFLOW;
     }
 
-    json_decref(jsonObjPtr);
+    memcpy(bufPtr, msgPtr->payloadPtr, msgPtr->header.payloadSize);
+    *bufNumElementsPtr = msgPtr->header.payloadSize;
 
-    return res;
+    return LE_OK;
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Check if a message belongs to a message box
+ * Create a new message entry, in the message boxes of all the applications. The oldest messages
+ * of the full message boxes are deleted.
  *
  */
 //--------------------------------------------------------------------------------------------------
-
-le_result_t CheckMessageIdInMbox
+static le_result_t CreateMsgEntry
 (
-    char* mboxName,
-    MessageId_t messageId
+    const uint8_t* dataPtr, ///<[IN] Encoded message
+    size_t dataSize,        ///<[IN] Encoded message size
+    MessageId_t *msgPtr     ///<[OUT] created messageId
 )
 {
-    json_t *jsonRootObjPtr;
-    json_t *jsonArrayPtr;
-    uint32_t pathLen = GetSMSInboxConfigPathLen(mboxName);
-    char path[pathLen];
-    GetSMSInboxConfigPath(mboxName, path, pathLen);
-
-    if ( GetMsgListFromMbox(path, &jsonRootObjPtr, &jsonArrayPtr) != LE_OK )
-    {
-        LE_ERROR("Error in GetMsgListFromMbox");
-        return LE_FAULT;
-    }
-
-    int i = 0;
+    uint32_t mboxMask = 0;
+    int i;
 
-    while (i < json_array_size(jsonArrayPtr))
+    // For all the applications
+    for (i = 0; i < le_smsInbox_NbMbx; i++)
     {
-        json_t * jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
-        MessageId_t msgId = 0;
-
-        if (jsonIntegerPtr)
+        if ( (NULL == Apps[i].namePtr) || (0 == Apps[i].inboxSize) )
         {
-            msgId = json_integer_value(jsonIntegerPtr);
-        }
-        else
-        {
-            LE_ERROR("json error");
-            json_decref(jsonRootObjPtr);
-            return LE_FAULT;
+            continue;
         }
 
-        if (msgId == messageId)
+        // delete older entries
+        while (SmsInboxStore_GetCount(i) >= Apps[i].inboxSize)
         {
-            json_decref(jsonRootObjPtr);
-            return LE_OK;
-        }
-
-        i++;
-    }
+            MessageId_t messageId = SmsInboxStore_GetNext(i, 0);
 
-    LE_ERROR("Bad msg id or mbox name");
-    json_decref(jsonRootObjPtr);
-    return LE_FAULT;
-}
+            LE_DEBUG("Remove %08x from %s", (int) messageId, Apps[i].namePtr);
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Decode message file
- *
- */
-//--------------------------------------------------------------------------------------------------
-static le_result_t DecodeMsgEntry
-(
-    char* mboxName,                      ///<[IN] mbox name
-    MessageId_t messageId,               ///<[IN] Message identifier to decode
-    char* keyPtr[],                      ///<[IN] Key to retrieve
-    uint8_t nbKey,                       ///<[IN] Number of elements in keyPtr
-    EntryDesc_t * decodePtr              ///<[IN/OUT] Decoding result
-)
-{
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
-    json_error_t error;
-    le_result_t res = LE_OK;
+            if (SmsInboxStore_Remove(messageId, i) != LE_OK)
+            {
+                LE_ERROR("Can't remove entry %08x", (int) messageId);
+                break;
+            }
+        }
 
-    GetSMSInboxMessagePath(messageId, path, pathLen);
+        mboxMask |= 1U << i;
+    }
 
-    json_t* jsonRootPtr = json_load_file(path, JSON_REJECT_DUPLICATES, &error);
+    le_result_t res = SmsInboxStore_Add(dataPtr, dataSize, mboxMask, msgPtr);
 
-    if ( jsonRootPtr == NULL )
+    if (res != LE_OK)
     {
-        LE_ERROR("json decoder error %s", error.text);
-        DeleteMsgInAppCfg(mboxName, messageId);
+        LE_ERROR("Unable to store the message: %s", LE_RESULT_TXT(res));
         return LE_FAULT;
     }
 
-    res = ReadJsonObj(jsonRootPtr, keyPtr, nbKey, decodePtr);
-
-    json_decref(jsonRootPtr);
+    LE_DEBUG("New entry: %08x", (int) *msgPtr);
 
-    return res;
+    return LE_OK;
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Check if an application requested the deletion of a message
+ * Convert the file name string in hexa
  *
  */
 //--------------------------------------------------------------------------------------------------
-static bool IsDeleted
+static MessageId_t GetMessageId
 (
-    MessageId_t messageId,  ///<[IN] Message identifier
-    char* appNamePtr        ///<[IN] Application name
+    char* fileName  ///<[IN] file name to be converted
 )
 {
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[2] = {JSON_ISDELETED, appNamePtr};
-
-    if (DecodeMsgEntry(appNamePtr, messageId, key, 2, &decode) == LE_OK)
-    {
-        return decode.uVal.boolVal;
-    }
-    else
-    {
-        // if error, delete the message
-        return true;
-    }
+    char *savePtr;
+    char *str = strtok_r(fileName,".", &savePtr);
+    return le_hex_HexaToInteger(str);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Perform the deleteion
+ * Compare two message identifiers, for qsort and bsearch
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void PerformDeletion
+static int CompareMessageId
 (
-    MessageId_t messageId   ///<[IN] Message identifier
+    const void* aPtr,   ///<[IN] First message identifier
+    const void* bPtr    ///<[IN] Second message identifier
 )
 {
-    int i;
-    bool deleted = true;
-
-    for (i=0; i < MAX_APPS; i++)
-    {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            deleted &= IsDeleted(messageId, Apps[i].namePtr);
-        }
-    }
-
-    // All applications mark this message to be delteted => erase physically the message
-    if (deleted)
-    {
-        uint16_t pathLen = GetSMSInboxMessagePathLen();
-        char path[pathLen];
-        memset(path,0,pathLen);
+    MessageId_t a = *(const MessageId_t*) aPtr;
+    MessageId_t b = *(const MessageId_t*) bPtr;
 
-        GetSMSInboxMessagePath(messageId, path, pathLen);
-
-        unlink(path);
-    }
+    return (a > b) - (a < b);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Add a message in the application's cfg file
+ * Select the Jansson message files of a directory
  *
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t AddMsgInAppCfg
+static int IsJsonFile
 (
-    MboxCtx_t* appsPtr,         ///<[IN] application config
-    MessageId_t messageId     ///<[IN] message to add
+    const struct dirent* entryPtr   ///<[IN] Directory entry
 )
 {
-    uint32_t pathLen = GetSMSInboxConfigPathLen(appsPtr->namePtr);
-    char path[pathLen];
-    GetSMSInboxConfigPath(appsPtr->namePtr, path, pathLen);
-    json_t* jsonMsgIdPtr = NULL;
-    json_t* jsonPtr;
-    json_t* jsonArrayPtr;
-
-    if ( GetMsgListFromMbox (path, &jsonPtr, &jsonArrayPtr) != LE_OK )
-    {
-        return LE_FAULT;
-    }
-
-    if ( json_array_size(jsonArrayPtr) == appsPtr->inboxSize )
-    {
-        // delete older entry
-        jsonMsgIdPtr = json_array_get(jsonArrayPtr, 0);
-        MessageId_t messageId = 0;
-
-        if (jsonMsgIdPtr)
-        {
-            messageId = json_integer_value(jsonMsgIdPtr);
-        }
-
-        if (messageId != 0)
-        {
-            json_array_remove(jsonArrayPtr, 0);
-
-            EntryDesc_t modif;
-            modif.type = DESC_BOOL;
-            modif.uVal.boolVal = true;
-            char* key[2]={JSON_ISDELETED, appsPtr->namePtr};
+    size_t len = strlen(entryPtr->d_name);
+    size_t extLen = strlen(FILE_EXTENSION);
 
-            if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-            {
-                LE_ERROR("Can't modify entry %08x", (int) messageId);
-            }
-
-            PerformDeletion(messageId);
-        }
-        else
-        {
-            json_decref(jsonPtr);
-            LE_ERROR("json error");
-            return LE_FAULT;
-        }
-    }
-
-    if (AddIntegerKeyInJsonObject(jsonArrayPtr, NULL, messageId) != LE_OK)
-    {
-        json_decref(jsonPtr);
-        LE_ERROR("json error");
-        return LE_FAULT;
-    }
-
-    if ( json_dump_file(jsonPtr, path, JSON_INDENT(1) | JSON_PRESERVE_ORDER) < 0 )
-    {
-        json_decref(jsonPtr);
-        LE_ERROR("json error");
-        return LE_FAULT;
-    }
-
-    json_decref(jsonPtr);
-
-    // Use for the first initialization
-    if (jsonArrayPtr->refcount > 0)
-    {
-        json_decref(jsonArrayPtr);
-    }
-
-    return LE_OK;
+    return (len > extLen) && (0 == strcmp(entryPtr->d_name + len - extLen, FILE_EXTENSION));
 }
 
-
-
 //--------------------------------------------------------------------------------------------------
 /**
- * Encode Json file
+ * Load the sorted list of the messages of an application's Jansson cfg file
  *
+ * @return Number of messages in the list
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t EncodeMsgEntry
+static size_t LoadJsonMbox
 (
-    uint32_t fd,            ///<[IN] file descriptor
-    le_sms_MsgRef_t msgRef  ///<[IN] SMS to be encoding
+    const char* appNamePtr,     ///<[IN] Application name
+    MessageId_t** msgListPtr    ///<[OUT] Sorted messages, to be freed
 )
 {
-    json_t *jsonRootPtr = json_object();
+    char path[PATH_MAX];
+    json_error_t error;
+    size_t count = 0;
+    size_t i;
 
-    if (!jsonRootPtr)
-    {
-        LE_ERROR("Json error");
-        return LE_FAULT;
-    }
+    *msgListPtr = NULL;
 
-    // Add imsi in json file
-    AddStringKeyInJsonObject(jsonRootPtr, JSON_IMSI, SimImsi);
+    snprintf(path, sizeof(path), "%s%s%s%s", SMSINBOX_PATH, CONF_PATH, appNamePtr, FILE_EXTENSION);
 
-    // Add sms format in json file
-    le_sms_Format_t format = le_sms_GetFormat(msgRef);
-    AddIntegerKeyInJsonObject(jsonRootPtr, JSON_FORMAT, (int) format);
+    json_t* jsonRootPtr = json_load_file(path, 0, &error);
 
-    // Unread by default for all applications
-    json_t *jsonUnreadPtr = json_object();
-    int i;
-    for (i=0; i < MAX_APPS; i++)
+    if (NULL == jsonRootPtr)
     {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
-        {
-            AddBooleanKeyInJsonObject(jsonUnreadPtr, Apps[i].namePtr, true);
-        }
+        LE_DEBUG("No mbox file for %s", appNamePtr);
+        return 0;
     }
 
-    json_object_set_new(jsonRootPtr, JSON_ISUNREAD, jsonUnreadPtr);
+    json_t* jsonArrayPtr = json_object_get(jsonRootPtr, JSON_MSGINBOX);
 
-    // Undeleted by default for all applications
-    json_t *jsonDeletePtr = json_object();
-    for (i=0; i < MAX_APPS; i++)
+    if ( json_is_array(jsonArrayPtr) && (json_array_size(jsonArrayPtr) > 0) )
     {
-        if ( Apps[i].namePtr && (strlen(Apps[i].namePtr) != 0) )
+        *msgListPtr = malloc(json_array_size(jsonArrayPtr) * sizeof(MessageId_t));
+
+        if (NULL == *msgListPtr)
         {
-            AddBooleanKeyInJsonObject(jsonDeletePtr, Apps[i].namePtr, false);
+            LE_ERROR("Unable to allocate the list of %s", appNamePtr);
         }
-    }
-
-    json_object_set_new(jsonRootPtr, JSON_ISDELETED, jsonDeletePtr);
-
-    switch ( format )
-    {
-        case LE_SMS_FORMAT_TEXT:
-        case LE_SMS_FORMAT_BINARY:
+        else
         {
-            char tel[LE_MDMDEFS_PHONE_NUM_MAX_BYTES];
-            memset(tel,0,LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
-
-            // Add phone number
-            le_result_t result = le_sms_GetSenderTel(msgRef, tel, LE_MDMDEFS_PHONE_NUM_MAX_BYTES);
-
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get the tel number %d", result);
-            }
-            else
-            {
-                LE_DEBUG("tel num: %s", tel);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_SENDERTEL, tel);
-            }
-
-            // Add timestamp
-            char timeStamp[LE_SMS_TIMESTAMP_MAX_BYTES];
-            result = le_sms_GetTimeStamp (msgRef, timeStamp, LE_SMS_TIMESTAMP_MAX_BYTES);
-
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get the timestamp %d", result);
-            }
-            else
+            for (i = 0; i < json_array_size(jsonArrayPtr); i++)
             {
-                LE_DEBUG("timestamp: %s", timeStamp);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_TIMESTAMP, timeStamp);
+                json_t* jsonIntegerPtr = json_array_get(jsonArrayPtr, i);
+
+                if (json_is_integer(jsonIntegerPtr))
+                {
+                    (*msgListPtr)[count++] = json_integer_value(jsonIntegerPtr);
+                }
             }
 
-            size_t len = le_sms_GetUserdataLen(msgRef);
-            AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, len);
+            qsort(*msgListPtr, count, sizeof(MessageId_t), CompareMessageId);
+        }
+    }
 
-            // Add a character for last '\0'
-            len++;
+    json_decref(jsonRootPtr);
 
-            uint8_t bin[len];
-            memset(bin,0,len);
-            int32_t strLen = 2*len + 1;
-            char string[strLen];
-            memset(string,0,strLen);
-            const char* jsonKey;
+    return count;
+}
 
-            if (format == LE_SMS_FORMAT_TEXT)
-            {
-                // Get text
-                result = le_sms_GetText(msgRef, (char*) bin, len);
-                jsonKey = JSON_TEXT;
-            }
-            else
-            {
-                // Get binary
-                result = le_sms_GetBinary(msgRef, bin, &len);
-                jsonKey = JSON_BIN;
-            }
+//--------------------------------------------------------------------------------------------------
+/**
+ * Import a Jansson message file in the store
+ *
+ */
+//--------------------------------------------------------------------------------------------------
+static void ImportJsonMsg
+(
+    const char* pathPtr,                ///<[IN] Message file path
+    MessageId_t messageId,              ///<[IN] Message identifier
+    uint32_t mboxMask                   ///<[IN] Message boxes of the message
+)
+{
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
+    MsgHeader_t header;
+    size_t offset = sizeof(MsgHeader_t);
+    uint32_t unreadMask = 0;
+    json_error_t error;
+    const char* strPtr;
+    int i;
 
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get payload %d", result);
-                AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, 0);
-            }
-            else
-            {
-                // Convert payload in string: json supports only utf-8 characters.
-                // Some extended-ASCII characters can be sent by SMS (such as character with accent)
-                // and can't be convert directly in utf-8. A convertion in string solves this issue.
-                strLen = le_hex_BinaryToString(bin, len, string, strLen);
-                AddStringKeyInJsonObject(jsonRootPtr, jsonKey, string);
+    json_t* jsonRootPtr = json_load_file(pathPtr, JSON_REJECT_DUPLICATES, &error);
 
-            }
-        }
-        break;
+    if (NULL == jsonRootPtr)
+    {
+        LE_WARN("json decoder error %s, %s not imported", error.text, pathPtr);
+        return;
+    }
 
-        case LE_SMS_FORMAT_PDU:
-        {
-            size_t len = le_sms_GetPDULen(msgRef);
-            AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, len);
-            // Add a character for last '\0'
-            len++;
-            uint8_t pdu[len];
-            memset(pdu,0,len);
-            int32_t strLen = 2*len + 1;
-            char string[strLen];
-            memset(string,0,strLen);
+    memset(&header, 0, sizeof(header));
 
-            // Add pdu
-            le_result_t result = le_sms_GetPDU(msgRef, pdu, &len);
+    strPtr = json_string_value(json_object_get(jsonRootPtr, JSON_IMSI));
+    header.imsiSize = AppendMsgField(buf, &offset, strPtr ? strPtr : "");
 
-            if (result != LE_OK)
-            {
-                LE_ERROR("Unable to get pdu %d", result);
-                AddIntegerKeyInJsonObject(jsonRootPtr, JSON_MSGLEN, 0);
-            }
-            else
-            {
-                // Convert pdu in string
-                strLen = le_hex_BinaryToString(pdu, len, string, strLen);
-                AddStringKeyInJsonObject(jsonRootPtr, JSON_PDU, string);
-            }
-        }
-        break;
-        case LE_SMS_FORMAT_UNKNOWN:
+    strPtr = json_string_value(json_object_get(jsonRootPtr, JSON_SENDERTEL));
+    if (strPtr)
+    {
+        header.telSize = AppendMsgField(buf, &offset, strPtr);
+        header.flags |= MSG_HAS_TEL;
+    }
+
+    strPtr = json_string_value(json_object_get(jsonRootPtr, JSON_TIMESTAMP));
+    if (strPtr)
+    {
+        header.timeStampSize = AppendMsgField(buf, &offset, strPtr);
+        header.flags |= MSG_HAS_TIMESTAMP;
+    }
+
+    json_t* jsonFormatPtr = json_object_get(jsonRootPtr, JSON_FORMAT);
+    header.format = json_is_integer(jsonFormatPtr) ? json_integer_value(jsonFormatPtr)
+                                                   : LE_SMS_FORMAT_UNKNOWN;
+    header.msgLen = json_integer_value(json_object_get(jsonRootPtr, JSON_MSGLEN));
+
+    switch (header.format)
+    {
+        case LE_SMS_FORMAT_TEXT:
+            strPtr = json_string_value(json_object_get(jsonRootPtr, JSON_TEXT));
+            break;
+        case LE_SMS_FORMAT_BINARY:
+            strPtr = json_string_value(json_object_get(jsonRootPtr, JSON_BIN));
+            break;
+        case LE_SMS_FORMAT_PDU:
+            strPtr = json_string_value(json_object_get(jsonRootPtr, JSON_PDU));
+            break;
         default:
-            LE_ERROR("Bad format %d", format);
+            strPtr = NULL;
+            break;
     }
 
-    // Write json file in the file system
-    char* jsondumpStr = json_dumps( (const json_t *) jsonRootPtr,
-                                    JSON_INDENT(1) | JSON_PRESERVE_ORDER);
-    if (!jsondumpStr)
+    if (strPtr)
     {
-        LE_ERROR("jsondumpStr is NULL");
-        return LE_FAULT;
+        int32_t len = le_hex_StringToBinary(strPtr, strlen(strPtr), buf + offset,
+                                            SMSINBOXSTORE_MAX_DATA_BYTES - offset);
+
+        if (len < 0)
+        {
+            LE_WARN("Bad payload in %s", pathPtr);
+        }
+        else
+        {
+            header.payloadSize = len;
+            header.flags |= MSG_HAS_PAYLOAD;
+            offset += len;
+        }
     }
 
-    char* restJsondumpStr = jsondumpStr;
-    ssize_t writeSize = strlen(jsondumpStr);
-    ssize_t writtenSize;
+    memcpy(buf, &header, sizeof(header));
 
-    do
+    // Unread by default
+    json_t* jsonUnreadPtr = json_object_get(jsonRootPtr, JSON_ISUNREAD);
+    for (i = 0; i < le_smsInbox_NbMbx; i++)
     {
-        writtenSize = write( fd, restJsondumpStr, writeSize );
-        if (writtenSize > 0)
+        if ( !json_is_false(json_object_get(jsonUnreadPtr, Apps[i].namePtr)) )
         {
-            writeSize -= writtenSize;
-            restJsondumpStr += writtenSize;
+            unreadMask |= 1U << i;
         }
     }
-    while ((writeSize > 0) && ((writtenSize >= 0) || (EINTR == errno)));
 
-    free(jsondumpStr);
     json_decref(jsonRootPtr);
 
-    return LE_OK;
+    if (SmsInboxStore_Import(messageId, buf, offset, mboxMask, unreadMask) != LE_OK)
+    {
+        LE_ERROR("Unable to import %s", pathPtr);
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a new message entry
+ * Import the Jansson files of previous versions in the store, then remove them.
  *
+ * The messages are imported with their identifiers, in increasing order: messages already in the
+ * store, imported before a reset, are skipped.
  */
 //--------------------------------------------------------------------------------------------------
-static le_result_t CreateMsgEntry
+static void ImportJsonFiles
 (
-    MessageId_t *msgPtr,    ///<[OUT] create messageId
-    int32_t *fdPtr         ///<[OUT] Created file descriptor
+    void
 )
 {
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path, 0, pathLen);
+    MessageId_t* mboxMsgList[MAX_APPS] = { NULL };
+    size_t mboxMsgCount[MAX_APPS] = { 0 };
+    char path[PATH_MAX];
+    struct dirent **namelist;
+    int nbSmsEntries;
+    int entry;
+    int i;
 
-    GetSMSInboxMessagePath(NextMessageId, path, pathLen);
+    snprintf(path, sizeof(path), "%s%s", SMSINBOX_PATH, MSG_PATH);
 
-    *fdPtr = open( path, O_CREAT | O_RDWR | O_SYNC, S_IRUSR | S_IWUSR );
+    nbSmsEntries = scandir(path, &namelist, IsJsonFile, alphasort);
 
-    if (*fdPtr < 0)
+    if (nbSmsEntries < 0)
     {
-        LE_ERROR("No such file: %s", path);
-        return LE_FAULT;
+        LE_ERROR("Unable to scan %s: %m", path);
+        return;
     }
 
-    LE_DEBUG("New entry: %s", path);
+    LE_INFO("Importing %d messages", nbSmsEntries);
 
-    int i;
+    for (i = 0; i < le_smsInbox_NbMbx; i++)
+    {
+        mboxMsgCount[i] = LoadJsonMbox(Apps[i].namePtr, &mboxMsgList[i]);
+    }
 
-    // For all the applications
-    for (i = 0; i < MAX_APPS; i++)
+    for (entry = 0; entry < nbSmsEntries; entry++)
     {
-        if ( Apps[i].namePtr && strlen(Apps[i].namePtr) )
+        char msgPath[PATH_MAX];
+        uint32_t mboxMask = 0;
+
+        snprintf(msgPath, sizeof(msgPath), "%s%s", path, namelist[entry]->d_name);
+
+        MessageId_t messageId = GetMessageId(namelist[entry]->d_name);
+
+        if ( ((MessageId_t) -1 != messageId) && (messageId > SmsInboxStore_GetLastId()) )
         {
-            AddMsgInAppCfg(&Apps[i], NextMessageId);
+            for (i = 0; i < le_smsInbox_NbMbx; i++)
+            {
+                if ( (mboxMsgCount[i] > 0) &&
+                     bsearch(&messageId, mboxMsgList[i], mboxMsgCount[i], sizeof(MessageId_t),
+                             CompareMessageId) )
+                {
+                    mboxMask |= 1U << i;
+                }
+            }
+
+            // Messages deleted from all the mailboxes are dropped
+            if (mboxMask)
+            {
+                ImportJsonMsg(msgPath, messageId, mboxMask);
+            }
         }
-    }
 
-    *msgPtr = NextMessageId;
+        free(namelist[entry]);
+    }
 
-    NextMessageId++;
+    free(namelist);
 
-    return LE_OK;
-}
+    for (i = 0; i < le_smsInbox_NbMbx; i++)
+    {
+        free(mboxMsgList[i]);
+    }
 
+    if (SmsInboxStore_Sync() != LE_OK)
+    {
+        LE_ERROR("Unable to sync the store, files kept");
+        return;
+    }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Convert the file name string in hexa
- *
- */
-//--------------------------------------------------------------------------------------------------
-static MessageId_t GetMessageId
-(
-    char* fileName  ///<[IN] file name to be converted
-)
-{
-    char *savePtr;
-    char *str = strtok_r(fileName,".", &savePtr);
-    return le_hex_HexaToInteger(str);
+    // The message files are removed first, so that the import is not run again
+    le_dir_RemoveRecursive(path);
 }
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Init the SMSInBox directory
+ * Init the SMSInBox store
  *
  */
 //--------------------------------------------------------------------------------------------------
-static void InitSmsInBoxDirectory
+static void InitSmsInboxStore
 (
     void
 )
 {
-    struct dirent **namelist;
-    uint32_t nbSmsEntries;
+    char path[PATH_MAX];
 
-    LE_DEBUG("InitSmsInBoxDirectory");
+    LE_DEBUG("InitSmsInboxStore");
 
-    // create directories
-    if (0 > mkdir( SMSINBOX_PATH, S_IREAD|S_IWRITE ))
-    {
-        LE_ERROR("Unable to create directory %s: %m", SMSINBOX_PATH);
-        return;
-    }
-    uint16_t pathLen = GetSMSInboxMessagePathLen();
-    char path[pathLen];
-    memset(path,0,pathLen);
-    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, CONF_PATH);
-    if (0 > mkdir( path, S_IREAD|S_IWRITE ))
+    if (SmsInboxStore_Init(SMSINBOX_PATH STORE_PATH, le_smsInbox_mboxName,
+                           le_smsInbox_NbMbx) != LE_OK)
     {
-        LE_ERROR("Unable to create directory %s: %m", path );
+        LE_ERROR("Unable to open the store %s", SMSINBOX_PATH STORE_PATH);
         return;
     }
-    memset(path,0,pathLen);
-    snprintf(path, pathLen, "%s%s", SMSINBOX_PATH, MSG_PATH);
-    if (0 > mkdir( path, S_IREAD|S_IWRITE ))
-    {
-        LE_ERROR("Unable to create directory %s: %m", path );
-        return;
-    }
-
 
-    nbSmsEntries = scandir(path, &namelist, NULL, alphasort);
-
-    if ( nbSmsEntries > 2 )
+    snprintf(path, sizeof(path), "%s%s", SMSINBOX_PATH, MSG_PATH);
+    if (le_dir_IsDir(path))
     {
-        uint8_t len = strlen(namelist[nbSmsEntries-1]->d_name);
-        char name[len+1];
-        memset(name, 0, len+1);
-        strncpy(name, namelist[nbSmsEntries-1]->d_name, len);
-        NextMessageId = GetMessageId(name);
-        NextMessageId++;
-
-        LE_DEBUG("NextMessageId %d", (int) NextMessageId);
+        ImportJsonFiles();
     }
 
-    while (nbSmsEntries--)
+    if (!le_dir_IsDir(path))
     {
-        free(namelist[nbSmsEntries]);
+        snprintf(path, sizeof(path), "%s%s", SMSINBOX_PATH, CONF_PATH);
+        le_dir_RemoveRecursive(path);
     }
-
-    free(namelist);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -1451,9 +1068,6 @@ static void MoveSmsFromSimToFolder
     void
 )
 {
-    int32_t fd;
-    le_result_t result = LE_OK;
-
     le_sms_MsgListRef_t msgListRef = le_sms_CreateRxMsgList();
 
     if (!msgListRef)
@@ -1466,20 +1080,10 @@ static void MoveSmsFromSimToFolder
 
     while(smsRef)
     {
+        uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
         MessageId_t msgId;
 
-        result = CreateMsgEntry(&msgId, &fd);
-
-        if (result == LE_OK)
-        {
-            if ( EncodeMsgEntry(fd, smsRef) != LE_OK )
-            {
-                LE_ERROR("Encoding issue");
-            }
-
-            close(fd);
-        }
-        else
+        if (CreateMsgEntry(buf, EncodeMsgEntry(smsRef, buf), &msgId) != LE_OK)
         {
             LE_ERROR("Error during new entry creation");
         }
@@ -1507,18 +1111,10 @@ static void NewSmsMsgHandler
     void*           contextPtr
 )
 {
-    int32_t fd;
-    le_result_t result;
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
     MessageId_t msgId;
 
-    result = CreateMsgEntry(&msgId, &fd);
-
-    if (result == LE_OK)
-    {
-        result = EncodeMsgEntry(fd, msgRef);
-        close(fd);
-
-    }
+    le_result_t result = CreateMsgEntry(buf, EncodeMsgEntry(msgRef, buf), &msgId);
 
     if (result == LE_OK)
     {
@@ -1714,8 +1310,8 @@ COMPONENT_INIT
     // Retrieve the smsInbox settings from the configuration tree
     LoadInboxSettings();
 
-    // Initialization of the smsInbox directory
-    InitSmsInBoxDirectory();
+    // Initialization of the smsInbox store
+    InitSmsInboxStore();
 
     // Create an event Id for new messages
     RxMsgEventId = le_event_CreateId("RxMsgEventId", sizeof(MessageId_t));
@@ -1901,7 +1497,6 @@ void SmsInbox_RemoveRxMessageHandler
     le_mem_Release(rxMsgReportPtr);
 }
 
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Delete a Message.
@@ -1933,30 +1528,17 @@ void SmsInbox_DeleteMsg
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISDELETED, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
-    {
-        LE_ERROR("ModifyMsgEntry error");
-    }
-
-    if (DeleteMsgInAppCfg(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId)
-                          != LE_OK)
+    if (SmsInboxStore_Remove(msgId, GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr))
+        != LE_OK)
     {
-        LE_ERROR("DeleteMsgInAppCfg error");
+        LE_ERROR("SmsInboxStore_Remove error");
     }
-
-    PerformDeletion(messageId);
 }
 
 
@@ -2004,13 +1586,14 @@ le_result_t SmsInbox_GetImsi
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
+    Msg_t msg;
     le_result_t res;
 
     memset(imsiPtr,0,imsiNumElements);
@@ -2020,14 +1603,12 @@ le_result_t SmsInbox_GetImsi
         return LE_OVERFLOW;
     }
 
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = imsiPtr;
-    decode.uVal.str.lenStr = imsiNumElements;
-    char* key[1] = {JSON_IMSI};
+    if ((res = ReadMsgEntry(msgId, buf, &msg)) == LE_OK)
+    {
+        res = CopyMsgField(msg.imsiPtr, msg.header.imsiSize, imsiPtr, imsiNumElements);
+    }
 
-    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr,
-                              messageId, key, 1, &decode)) == LE_OK)
+    if (res == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
     }
@@ -2071,22 +1652,19 @@ le_sms_Format_t SmsInbox_GetFormat
         return 0;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return 0;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_INT;
-    char* key[1] = {JSON_FORMAT};
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
+    Msg_t msg;
 
-    if (DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
-                      &decode) == LE_OK)
+    if (ReadMsgEntry(msgId, buf, &msg) == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
-        return decode.uVal.val;
+        return msg.header.format;
     }
     else
     {
@@ -2136,23 +1714,31 @@ le_result_t SmsInbox_GetSenderTel
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
+    Msg_t msg;
     le_result_t res;
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = telPtr;
-    decode.uVal.str.lenStr = telNumElements;
     memset(telPtr,0,telNumElements);
-    char* key[1] = {JSON_SENDERTEL};
 
-    if ((res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key,
-                              1, &decode)) == LE_OK)
+    if ((res = ReadMsgEntry(msgId, buf, &msg)) == LE_OK)
+    {
+        if (msg.header.flags & MSG_HAS_TEL)
+        {
+            res = CopyMsgField(msg.telPtr, msg.header.telSize, telPtr, telNumElements);
+        }
+        else
+        {
+            LE_ERROR("No information");
+            res = LE_FAULT;
+        }
+    }
+
+    if (res == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
     }
@@ -2206,23 +1792,32 @@ le_result_t SmsInbox_GetTimeStamp
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = timestampPtr;
-    decode.uVal.str.lenStr = timestampNumElements;
-    memset(timestampPtr,0,timestampNumElements);
-    char* key[1] = {JSON_TIMESTAMP};
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
+    Msg_t msg;
     le_result_t res;
+    memset(timestampPtr,0,timestampNumElements);
+
+    if ((res = ReadMsgEntry(msgId, buf, &msg)) == LE_OK)
+    {
+        if (msg.header.flags & MSG_HAS_TIMESTAMP)
+        {
+            res = CopyMsgField(msg.timeStampPtr, msg.header.timeStampSize,
+                               timestampPtr, timestampNumElements);
+        }
+        else
+        {
+            LE_ERROR("No information");
+            res = LE_FAULT;
+        }
+    }
 
-    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId,
-                               key, 1, &decode)) == LE_OK )
+    if (res == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
     }
@@ -2263,28 +1858,20 @@ size_t SmsInbox_GetMsgLen
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-
-    EntryDesc_t decode;
-    decode.type = DESC_INT;
-    char* key[1] = {JSON_MSGLEN};
-    le_result_t res;
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
+    Msg_t msg;
 
-    if ( (res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr,
-                                messageId,
-                                key,
-                                1,
-                                &decode)) == LE_OK )
+    if (ReadMsgEntry(msgId, buf, &msg) == LE_OK)
     {
         SmsInbox_MarkRead(sessionRef, msgId);
 
-        return decode.uVal.val;
+        return msg.header.msgLen;
     }
     else
     {
@@ -2335,38 +1922,24 @@ le_result_t SmsInbox_GetText
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
+    Msg_t msg;
     le_result_t res;
-    size_t len = 2*textNumElements+1;
-    char tmpTextPtr[len];
-    memset(tmpTextPtr,0,len);
     memset(textPtr,0,textNumElements);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpTextPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_TEXT};
-
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
-                         &decode);
+    if ((res = ReadMsgEntry(msgId, buf, &msg)) == LE_OK)
+    {
+        res = CopyMsgPayload(&msg, LE_SMS_FORMAT_TEXT, (uint8_t*) textPtr, &textNumElements);
+    }
 
     if ( res == LE_OK )
     {
-        if ( le_hex_StringToBinary(tmpTextPtr,
-                                   decode.uVal.str.lenStr,
-                                   (uint8_t*) textPtr,
-                                   textNumElements ) < 0 )
-        {
-            return LE_FAULT;
-        }
-
         SmsInbox_MarkRead(sessionRef, msgId);
     }
 
@@ -2416,42 +1989,24 @@ le_result_t SmsInbox_GetBinary
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
+    Msg_t msg;
     le_result_t res;
-    EntryDesc_t decode;
-    size_t len = 2*(*binNumElementsPtr)+1;
-    char tmpBinPtr[len];
-    memset(tmpBinPtr,0,len);
     memset(binPtr,0,*binNumElementsPtr);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpBinPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_BIN};
-
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId,
-                         key, 1, &decode);
+    if ((res = ReadMsgEntry(msgId, buf, &msg)) == LE_OK)
+    {
+        res = CopyMsgPayload(&msg, LE_SMS_FORMAT_BINARY, binPtr, binNumElementsPtr);
+    }
 
     if ( res == LE_OK )
     {
-        int32_t binNumElements = le_hex_StringToBinary(tmpBinPtr,
-                                                    decode.uVal.str.lenStr,
-                                                    binPtr,
-                                                    *binNumElementsPtr);
-
-        if ( binNumElements < 0 )
-        {
-            return LE_FAULT;
-        }
-
-        *binNumElementsPtr = binNumElements;
-
         SmsInbox_MarkRead(sessionRef, msgId);
     }
 
@@ -2505,42 +2060,24 @@ le_result_t SmsInbox_GetPdu
         return 0;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return 0;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
+    uint8_t buf[SMSINBOXSTORE_MAX_DATA_BYTES];
+    Msg_t msg;
     le_result_t res;
-    EntryDesc_t decode;
-    size_t len = 2*(*pduNumElementsPtr)+1;
-    char tmpPduPtr[len];
-    memset(tmpPduPtr,0,len);
     memset(pduPtr,0,*pduNumElementsPtr);
 
-    decode.type = DESC_STRING;
-    decode.uVal.str.strPtr = tmpPduPtr;
-    decode.uVal.str.lenStr = len;
-    char* key[1] = {JSON_PDU};
-
-    res = DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 1,
-                         &decode);
+    if ((res = ReadMsgEntry(msgId, buf, &msg)) == LE_OK)
+    {
+        res = CopyMsgPayload(&msg, LE_SMS_FORMAT_PDU, pduPtr, pduNumElementsPtr);
+    }
 
     if ( res == LE_OK )
     {
-        int32_t pduNumElements = le_hex_StringToBinary(tmpPduPtr,
-                                                    decode.uVal.str.lenStr,
-                                                    pduPtr,
-                                                    *pduNumElementsPtr);
-
-        if ( pduNumElements < 0 )
-        {
-            return LE_FAULT;
-        }
-
-        *pduNumElementsPtr = pduNumElements;
-
         SmsInbox_MarkRead(sessionRef, msgId);
     }
 
@@ -2579,75 +2116,21 @@ uint32_t SmsInbox_GetFirst
         return 0;
     }
 
-    uint32_t pathLen = GetSMSInboxConfigPathLen(clientRequestPtr->
-                                                mboxSessionPtr->mboxCtxPtr->namePtr);
-    char path[pathLen];
-    memset(path,0,pathLen);
-    GetSMSInboxConfigPath(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, path, pathLen);
-    le_result_t res = LE_OK;
-    MessageId_t messageId=0;
-
-    if ( GetMsgListFromMbox(path,
-                        &clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr,
-                        &clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr) != LE_OK )
-    {
-        LE_ERROR("error in GetMsgListFromMbox");
-        return 0;
-    }
-
-    clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex =
-                      json_array_size(clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr);
+    BrowseCtx_t* browseCtxPtr = &clientRequestPtr->mboxSessionPtr->browseCtx;
+    uint8_t mbox = GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr);
 
-    LE_DEBUG("maxIndex %d", clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex);
-
-    if ( clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex > 0 )
-    {
-        json_t * jsonIntegerPtr =
-                 json_array_get(clientRequestPtr->mboxSessionPtr->browseCtx.jsonArrayPtr, 0);
+    browseCtxPtr->maxMessageId = SmsInboxStore_GetLastId();
+    browseCtxPtr->lastMessageId = SmsInboxStore_GetNext(mbox, 0);
 
-        if (jsonIntegerPtr)
-        {
-            messageId = json_integer_value(jsonIntegerPtr);
-        }
-        else
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
+    LE_DEBUG("maxMessageId %08x", (int) browseCtxPtr->maxMessageId);
 
-        if (messageId)
-        {
-            clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex = 1;
-        }
-        else
-        {
-            LE_ERROR("json error");
-            res = LE_FAULT;
-        }
-    }
-    else
+    if (0 == browseCtxPtr->lastMessageId)
     {
-        res = LE_FAULT;
         LE_DEBUG("Empty mbox");
+        memset(browseCtxPtr, 0, sizeof(BrowseCtx_t));
     }
 
-    if (res == LE_FAULT)
-    {
-        if (clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr)
-        {
-            json_decref(clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr);
-        }
-
-        memset(&clientRequestPtr->mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
-
-        return 0;
-    }
-    else
-    {
-        return messageId;
-    }
-
-    return 0;
+    return browseCtxPtr->lastMessageId;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2675,57 +2158,28 @@ uint32_t SmsInbox_GetNext
         return LE_BAD_PARAMETER;
     }
 
-    while(clientRequestPtr->mboxSessionPtr->browseCtx.maxIndex !=
-          clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex)
-    {
-        LE_DEBUG("currentIndex %d, maxIndex %d", clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.currentMessageIndex,
-                                                 clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.maxIndex);
-
-        json_t * jsonIntegerPtr = json_array_get(clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.jsonArrayPtr,
-                                                 clientRequestPtr->
-                                                 mboxSessionPtr->browseCtx.currentMessageIndex);
+    BrowseCtx_t* browseCtxPtr = &clientRequestPtr->mboxSessionPtr->browseCtx;
 
-        if (jsonIntegerPtr)
-        {
-            MessageId_t messageId = json_integer_value(jsonIntegerPtr);
-
-            if (messageId > 0)
-            {
-                clientRequestPtr->mboxSessionPtr->browseCtx.currentMessageIndex++;
+    if (browseCtxPtr->lastMessageId != 0)
+    {
+        LE_DEBUG("lastMessageId %08x, maxMessageId %08x", (int) browseCtxPtr->lastMessageId,
+                                                          (int) browseCtxPtr->maxMessageId);
 
-                // Check if the message exist (it may be deleted since the GetFirst call)
-                uint16_t pathLen = GetSMSInboxMessagePathLen();
-                char path[pathLen];
-                memset(path, 0, pathLen);
-                GetSMSInboxMessagePath(messageId, path, pathLen);
-                int32_t fd = open(path, O_RDWR);
+        // Messages deleted since the GetFirst call are skipped by the store
+        MessageId_t messageId =
+            SmsInboxStore_GetNext(GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr),
+                                  browseCtxPtr->lastMessageId);
 
-                if (fd > 0)
-                {
-                    // message is still existing
-                    close(fd);
-                    return messageId;
-                }
-                // else continue the parsing
-            }
-            else
-            {
-                LE_ERROR("json error");
-            }
-        }
-        else
+        if ((messageId != 0) && (messageId <= browseCtxPtr->maxMessageId))
         {
-            LE_ERROR("json error");
+            browseCtxPtr->lastMessageId = messageId;
+            return messageId;
         }
     }
 
-    // Parsing end => free the memory
+    // Parsing end
     LE_DEBUG("No more messages");
-    json_decref(clientRequestPtr->mboxSessionPtr->browseCtx.jsonObjPtr);
-    memset(&clientRequestPtr->mboxSessionPtr->browseCtx, 0, sizeof(BrowseCtx_t));
+    memset(browseCtxPtr, 0, sizeof(BrowseCtx_t));
 
     return 0;
 }
@@ -2766,27 +2220,14 @@ bool SmsInbox_IsUnread
         return LE_BAD_PARAMETER;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return LE_BAD_PARAMETER;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t decode;
-    decode.type = DESC_BOOL;
-    char* key[] = {JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (DecodeMsgEntry(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, messageId, key, 2,
-                       &decode) == LE_OK)
-    {
-        return decode.uVal.boolVal;
-    }
-    else
-    {
-        LE_ERROR("Error in DecodeMsgEntry");
-        return false;
-    }
+    return SmsInboxStore_IsUnread(msgId,
+                                  GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -2821,21 +2262,17 @@ void SmsInbox_MarkRead
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = false;
-    char* key[2]={JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    if (SmsInboxStore_SetUnread(msgId,
+                                GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr),
+                                false) != LE_OK)
     {
-        LE_ERROR("Error in ModifyMsgEntry");
+        LE_ERROR("Error in SmsInboxStore_SetUnread");
     }
 }
 
@@ -2871,20 +2308,16 @@ void SmsInbox_MarkUnread
         return;
     }
 
-    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr, msgId) != LE_OK)
+    if (CheckMessageIdInMbox(clientRequestPtr->mboxSessionPtr->mboxCtxPtr, msgId) != LE_OK)
     {
         LE_ERROR("message not included into the mbox");
         return;
     }
 
-    MessageId_t messageId = (MessageId_t) msgId;
-    EntryDesc_t modif;
-    modif.type = DESC_BOOL;
-    modif.uVal.boolVal = true;
-    char* key[2]={JSON_ISUNREAD, clientRequestPtr->mboxSessionPtr->mboxCtxPtr->namePtr};
-
-    if (ModifyMsgEntry(messageId, key, 2, &modif) != LE_OK)
+    if (SmsInboxStore_SetUnread(msgId,
+                                GetMboxIndex(clientRequestPtr->mboxSessionPtr->mboxCtxPtr),
+                                true) != LE_OK)
     {
-        LE_ERROR("Error in ModifyMsgEntry");
+        LE_ERROR("Error in SmsInboxStore_SetUnread");
     }
 }
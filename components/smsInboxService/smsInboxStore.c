@@ -0,0 +1,2152 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  SMS Inbox Store
+ *
+ * The store is made of two files in its directory:
+ *
+ *  - LOG_FILE starts with a header giving the names of the mailboxes, followed by records.  A
+ *    MESSAGE record holds a new message with its mailboxes and unread flags, and a FLAGS record
+ *    holds new mailboxes and unread flags for a message.  A message in no mailbox is deleted.
+ *    Records are only ever appended, so a crash can only leave a partial record at the end of the
+ *    log, which is detected by its CRC and truncated at the next start.  A corrupted record in the
+ *    middle of the log is skipped up to the next valid record, and dropped at the next compaction.
+ *
+ *  - INDEX_FILE is a snapshot of the index: the messages in the log, with their current
+ *    mailboxes and unread flags, and the size of the log it covers.  It is written through a
+ *    temporary file and a rename, once enough records have been appended since the last one.  The
+ *    directory is synced after each rename, so that the new file is the one found after a crash.
+ *
+ * When the deleted messages and the FLAGS records make up most of the log, the live messages are
+ * copied to a new log, which replaces the old one through a rename.  The log header holds a
+ * generation number, incremented on each compaction, so that an index of another log is ignored
+ * and the whole log is replayed instead.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "smsInboxStore.h"
+
+
+//--------------------------------------------------------------------------------------------------
+// Symbols and enums.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store file names.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_FILE "log"
+#define INDEX_FILE "index"
+#define TMP_EXTENSION ".tmp"
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic numbers and version of the store files.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LOG_MAGIC 0x4C534D53        // "SMSL"
+#define INDEX_MAGIC 0x49534D53      // "SMSI"
+#define RECORD_MAGIC 0x52534D53     // "SMSR"
+#define STORE_VERSION 1
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a mailbox name in the log header.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MBOX_NAME_BYTES 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Minimum number of bytes appended to the log before the index is saved again.  The index is not
+ * saved before as many bytes as its own size have been appended either, so that saving it does
+ * not write more than the log itself.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INDEX_SAVE_MIN_BYTES (16 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Minimum number of bytes of deleted messages and FLAGS records before the log is compacted.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_MIN_BYTES (64 * 1024)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Minimum number of deleted entries before they are removed from the index.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SQUEEZE_MIN_ENTRIES 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initial number of entries of the index.
+ */
+//--------------------------------------------------------------------------------------------------
+#define INITIAL_ENTRY_CAPACITY 64
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of bytes of the log read at once when looking for the next valid record.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RESYNC_CHUNK_BYTES 1024
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record types.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_MESSAGE 1
+#define RECORD_FLAGS 2
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a record, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RECORD_SIZE(dataSize) ((uint32_t)(sizeof(RecordHeader_t) + (dataSize)))
+
+//--------------------------------------------------------------------------------------------------
+// Data structures.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log header.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;                                         ///< LOG_MAGIC
+    uint32_t version;                                       ///< STORE_VERSION
+    uint32_t generation;                                    ///< Compaction count
+    uint32_t nextMsgId;                                     ///< Lowest identifier of new messages
+    uint32_t mboxCount;                                     ///< Number of mailboxes
+    char     mboxName[SMSINBOXSTORE_MAX_MBOX][MBOX_NAME_BYTES]; ///< Mailbox names
+    uint32_t crc;                                           ///< CRC of the header
+}
+LogHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record header, followed by dataSize bytes of data.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;         ///< RECORD_MAGIC
+    uint16_t type;          ///< RECORD_MESSAGE or RECORD_FLAGS
+    uint16_t dataSize;      ///< Size of the data, in bytes
+    uint32_t msgId;         ///< Message identifier
+    uint16_t mboxMask;      ///< Mailboxes of the message
+    uint16_t unreadMask;    ///< Mailboxes in which the message is unread
+    uint32_t crc;           ///< CRC of the header and the data
+}
+RecordHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index file header, followed by count entries.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;         ///< INDEX_MAGIC
+    uint32_t version;       ///< STORE_VERSION
+    uint32_t generation;    ///< Generation of the log
+    uint32_t logSize;       ///< Size of the log covered by the index, in bytes
+    uint32_t nextMsgId;     ///< Lowest identifier of new messages
+    uint32_t count;         ///< Number of entries
+    uint32_t crc;           ///< CRC of the header and the entries
+}
+IndexHeader_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index entry of a message.  A message in no mailbox is deleted; its entry is kept until the
+ * index is squeezed, so that the entries remain sorted by identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t msgId;         ///< Message identifier
+    uint32_t offset;        ///< Offset of the MESSAGE record in the log
+    uint16_t dataSize;      ///< Size of the message data, in bytes
+    uint16_t mboxMask;      ///< Mailboxes of the message
+    uint16_t unreadMask;    ///< Mailboxes in which the message is unread
+    uint16_t reserved;      ///< Zero
+}
+Entry_t;
+
+//--------------------------------------------------------------------------------------------------
+//                                       Static declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Paths of the store files.
+ */
+//--------------------------------------------------------------------------------------------------
+static char DirPath[PATH_MAX];
+static char LogPath[PATH_MAX];
+static char LogTmpPath[PATH_MAX];
+static char IndexPath[PATH_MAX];
+static char IndexTmpPath[PATH_MAX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mailbox names, and number of mailboxes.
+ */
+//--------------------------------------------------------------------------------------------------
+static char MboxNames[SMSINBOXSTORE_MAX_MBOX][MBOX_NAME_BYTES];
+static uint8_t MboxCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of messages in each mailbox.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t MboxMsgCount[SMSINBOXSTORE_MAX_MBOX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Position in the index of the oldest message of each mailbox, or of an older entry.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t MboxFirstPos[SMSINBOXSTORE_MAX_MBOX];
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Index entries, sorted by message identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* EntryPtr;
+static uint32_t EntryCount;
+static uint32_t EntryCapacity;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of entries of deleted messages in the index.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t DeadCount;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log file descriptor, generation and size.
+ */
+//--------------------------------------------------------------------------------------------------
+static int LogFd = -1;
+static uint32_t LogGeneration;
+static uint32_t LogSize;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Whether records have been appended to the log since it was last synchronized.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsLogSyncNeeded;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the log covered by the saved index.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t IndexedLogSize;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the MESSAGE records of the messages not deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t LiveBytes;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Next message Identifier
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t NextMsgId = 1;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the mask of all the mailboxes.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t GetAllMboxMask
+(
+    void
+)
+{
+    return (1U << MboxCount) - 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a whole buffer at an offset in a file.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteAt
+(
+    int fd,                 ///<[IN] File descriptor
+    const void* bufPtr,     ///<[IN] Buffer to write
+    size_t size,            ///<[IN] Number of bytes to write
+    off_t offset            ///<[IN] Offset in the file
+)
+{
+    const uint8_t* dataPtr = bufPtr;
+
+    while (size > 0)
+    {
+        ssize_t writtenSize = pwrite(fd, dataPtr, size, offset);
+
+        if (writtenSize < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            LE_ERROR("Write error: %m");
+            return LE_FAULT;
+        }
+
+        dataPtr += writtenSize;
+        offset += writtenSize;
+        size -= writtenSize;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read a whole buffer at an offset in a file.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error, or if the file is too short
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadAt
+(
+    int fd,                 ///<[IN] File descriptor
+    void* bufPtr,           ///<[OUT] Buffer to read into
+    size_t size,            ///<[IN] Number of bytes to read
+    off_t offset            ///<[IN] Offset in the file
+)
+{
+    uint8_t* dataPtr = bufPtr;
+
+    while (size > 0)
+    {
+        ssize_t readSize = pread(fd, dataPtr, size, offset);
+
+        if (readSize < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            LE_ERROR("Read error: %m");
+            return LE_FAULT;
+        }
+
+        if (readSize == 0)
+        {
+            return LE_FAULT;
+        }
+
+        dataPtr += readSize;
+        offset += readSize;
+        size -= readSize;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the CRC of a record.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t ComputeRecordCrc
+(
+    const RecordHeader_t* headerPtr,    ///<[IN] Record header
+    const uint8_t* dataPtr              ///<[IN] Record data
+)
+{
+    RecordHeader_t header = *headerPtr;
+    header.crc = 0;
+
+    uint32_t crc = le_crc_Crc32((uint8_t*)&header, sizeof(header), LE_CRC_START_CRC32);
+
+    return le_crc_Crc32((uint8_t*)dataPtr, headerPtr->dataSize, crc);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read and check a record of the log.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FORMAT_ERROR if there is no valid record at this offset
+ *  - LE_FAULT on read error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadRecord
+(
+    int fd,                         ///<[IN] Log file descriptor
+    uint32_t offset,                ///<[IN] Offset of the record
+    uint32_t fileSize,              ///<[IN] Size of the log
+    RecordHeader_t* headerPtr,      ///<[OUT] Record header
+    uint8_t* dataPtr                ///<[OUT] Record data, SMSINBOXSTORE_MAX_DATA_BYTES long
+)
+{
+    if ((fileSize < offset) || (fileSize - offset < sizeof(RecordHeader_t)))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    if (ReadAt(fd, headerPtr, sizeof(RecordHeader_t), offset) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    if ((headerPtr->magic != RECORD_MAGIC) ||
+        ((headerPtr->type != RECORD_MESSAGE) && (headerPtr->type != RECORD_FLAGS)) ||
+        (headerPtr->dataSize > SMSINBOXSTORE_MAX_DATA_BYTES) ||
+        (fileSize - offset < RECORD_SIZE(headerPtr->dataSize)))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    if (ReadAt(fd, dataPtr, headerPtr->dataSize, offset + sizeof(RecordHeader_t)) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    if (ComputeRecordCrc(headerPtr, dataPtr) != headerPtr->crc)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look for the first valid record of the log after an offset.  Records are not aligned, so every
+ * occurrence of RECORD_MAGIC is tried, and only a record whose CRC matches is accepted.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_NOT_FOUND if there is no valid record after the offset
+ *  - LE_FAULT on read error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t FindNextRecord
+(
+    int fd,                         ///<[IN] Log file descriptor
+    uint32_t* offsetPtr,            ///<[IN/OUT] Offset to search after, offset of the record
+    uint32_t fileSize,              ///<[IN] Size of the log
+    RecordHeader_t* headerPtr,      ///<[OUT] Record header
+    uint8_t* dataPtr                ///<[OUT] Record data, SMSINBOXSTORE_MAX_DATA_BYTES long
+)
+{
+    uint8_t buffer[RESYNC_CHUNK_BYTES];
+    const uint32_t magic = RECORD_MAGIC;
+    uint32_t offset = *offsetPtr + 1;
+
+    while ((offset < fileSize) && (fileSize - offset >= sizeof(RecordHeader_t)))
+    {
+        uint32_t size = fileSize - offset;
+        uint32_t i;
+
+        if (size > sizeof(buffer))
+        {
+            size = sizeof(buffer);
+        }
+
+        if (ReadAt(fd, buffer, size, offset) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        for (i = 0; i + sizeof(magic) <= size; i++)
+        {
+            if (memcmp(buffer + i, &magic, sizeof(magic)) != 0)
+            {
+                continue;
+            }
+
+            le_result_t result = ReadRecord(fd, offset + i, fileSize, headerPtr, dataPtr);
+
+            if (LE_OK == result)
+            {
+                *offsetPtr = offset + i;
+                return LE_OK;
+            }
+
+            if (result != LE_FORMAT_ERROR)
+            {
+                return result;
+            }
+        }
+
+        // The magic number may straddle two chunks.
+        offset += size - (sizeof(magic) - 1);
+    }
+
+    return LE_NOT_FOUND;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a record in a log file.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t WriteRecord
+(
+    int fd,                 ///<[IN] Log file descriptor
+    uint32_t offset,        ///<[IN] Offset of the record
+    uint16_t type,          ///<[IN] Record type
+    uint32_t msgId,         ///<[IN] Message identifier
+    uint32_t mboxMask,      ///<[IN] Mailboxes of the message
+    uint32_t unreadMask,    ///<[IN] Mailboxes in which the message is unread
+    const uint8_t* dataPtr, ///<[IN] Record data
+    size_t dataSize         ///<[IN] Size of the record data
+)
+{
+    uint8_t record[RECORD_SIZE(SMSINBOXSTORE_MAX_DATA_BYTES)];
+    RecordHeader_t header =
+    {
+        .magic = RECORD_MAGIC,
+        .type = type,
+        .dataSize = dataSize,
+        .msgId = msgId,
+        .mboxMask = mboxMask,
+        .unreadMask = unreadMask,
+        .crc = 0
+    };
+
+    header.crc = ComputeRecordCrc(&header, dataPtr);
+
+    memcpy(record, &header, sizeof(header));
+    if (dataSize > 0)
+    {
+        memcpy(record + sizeof(header), dataPtr, dataSize);
+    }
+
+    return WriteAt(fd, record, RECORD_SIZE(dataSize), offset);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Append a record to the log.  The log is truncated back if the record cannot be fully written.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AppendRecord
+(
+    uint16_t type,          ///<[IN] Record type
+    uint32_t msgId,         ///<[IN] Message identifier
+    uint32_t mboxMask,      ///<[IN] Mailboxes of the message
+    uint32_t unreadMask,    ///<[IN] Mailboxes in which the message is unread
+    const uint8_t* dataPtr, ///<[IN] Record data
+    size_t dataSize         ///<[IN] Size of the record data
+)
+{
+    if (LogFd < 0)
+    {
+        LE_ERROR("Store is not open");
+        return LE_FAULT;
+    }
+
+    if (WriteRecord(LogFd, LogSize, type, msgId, mboxMask, unreadMask, dataPtr, dataSize) != LE_OK)
+    {
+        if (ftruncate(LogFd, LogSize) < 0)
+        {
+            LE_ERROR("Unable to truncate %s: %m", LogPath);
+        }
+
+        return LE_FAULT;
+    }
+
+    LogSize += RECORD_SIZE(dataSize);
+    IsLogSyncNeeded = true;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the appended records to flash.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SyncLog
+(
+    void
+)
+{
+    if (IsLogSyncNeeded)
+    {
+        if (fdatasync(LogFd) < 0)
+        {
+            LE_ERROR("Unable to sync %s: %m", LogPath);
+            return LE_FAULT;
+        }
+
+        IsLogSyncNeeded = false;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the directory of the store to flash, so that a renamed file survives a crash.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SyncDir
+(
+    void
+)
+{
+    int fd = open(DirPath, O_RDONLY | O_DIRECTORY);
+
+    if (fd < 0)
+    {
+        LE_ERROR("Unable to open %s: %m", DirPath);
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+
+    if (fsync(fd) < 0)
+    {
+        LE_ERROR("Unable to sync %s: %m", DirPath);
+        result = LE_FAULT;
+    }
+
+    close(fd);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the position of the first entry whose identifier is greater than or equal to msgId.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FindPos
+(
+    uint32_t msgId          ///<[IN] Message identifier
+)
+{
+    uint32_t low = 0;
+    uint32_t high = EntryCount;
+
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+
+        if (EntryPtr[mid].msgId < msgId)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the entry of a message that is not deleted.
+ *
+ * @return The entry, or NULL if not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* FindEntry
+(
+    uint32_t msgId          ///<[IN] Message identifier
+)
+{
+    uint32_t pos = FindPos(msgId);
+
+    if ((pos < EntryCount) && (EntryPtr[pos].msgId == msgId) && (EntryPtr[pos].mboxMask != 0))
+    {
+        return &EntryPtr[pos];
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make room for a number of entries in the index.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_NO_MEMORY if the index cannot grow
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReserveEntries
+(
+    uint32_t count          ///<[IN] Number of entries
+)
+{
+    if (count <= EntryCapacity)
+    {
+        return LE_OK;
+    }
+
+    uint32_t capacity = (EntryCapacity != 0) ? EntryCapacity : INITIAL_ENTRY_CAPACITY;
+
+    while (capacity < count)
+    {
+        capacity *= 2;
+    }
+
+    Entry_t* newEntryPtr = realloc(EntryPtr, capacity * sizeof(Entry_t));
+
+    if (NULL == newEntryPtr)
+    {
+        LE_ERROR("Unable to grow the index to %u entries", capacity);
+        return LE_NO_MEMORY;
+    }
+
+    EntryPtr = newEntryPtr;
+    EntryCapacity = capacity;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove the entries of the deleted messages from the index.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SqueezeEntries
+(
+    void
+)
+{
+    uint32_t i;
+    uint32_t count = 0;
+
+    if (DeadCount == 0)
+    {
+        return;
+    }
+
+    for (i = 0; i < EntryCount; i++)
+    {
+        if (EntryPtr[i].mboxMask != 0)
+        {
+            EntryPtr[count++] = EntryPtr[i];
+        }
+    }
+
+    EntryCount = count;
+    DeadCount = 0;
+    memset(MboxFirstPos, 0, sizeof(MboxFirstPos));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the mailboxes and unread flags of an entry, and update the counters.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetEntryMasks
+(
+    Entry_t* entryPtr,      ///<[IN] Entry of a message not deleted
+    uint32_t mboxMask,      ///<[IN] New mailboxes
+    uint32_t unreadMask     ///<[IN] New unread flags
+)
+{
+    uint32_t changedMask = entryPtr->mboxMask ^ mboxMask;
+    uint8_t mbox;
+
+    for (mbox = 0; mbox < MboxCount; mbox++)
+    {
+        if (changedMask & (1U << mbox))
+        {
+            if (mboxMask & (1U << mbox))
+            {
+                MboxMsgCount[mbox]++;
+            }
+            else
+            {
+                MboxMsgCount[mbox]--;
+            }
+        }
+    }
+
+    entryPtr->mboxMask = mboxMask;
+    entryPtr->unreadMask = unreadMask & mboxMask;
+
+    if (mboxMask == 0)
+    {
+        LiveBytes -= RECORD_SIZE(entryPtr->dataSize);
+        DeadCount++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add an entry to the index, after the existing ones.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushEntry
+(
+    uint32_t msgId,         ///<[IN] Message identifier
+    uint32_t offset,        ///<[IN] Offset of the MESSAGE record
+    size_t dataSize,        ///<[IN] Size of the message data
+    uint32_t mboxMask,      ///<[IN] Mailboxes of the message
+    uint32_t unreadMask     ///<[IN] Mailboxes in which the message is unread
+)
+{
+    Entry_t* entryPtr = &EntryPtr[EntryCount++];
+
+    memset(entryPtr, 0, sizeof(Entry_t));
+    entryPtr->msgId = msgId;
+    entryPtr->offset = offset;
+    entryPtr->dataSize = dataSize;
+
+    LiveBytes += RECORD_SIZE(dataSize);
+    SetEntryMasks(entryPtr, mboxMask, unreadMask);
+
+    if (msgId >= NextMsgId)
+    {
+        NextMsgId = msgId + 1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reset the index.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetEntries
+(
+    void
+)
+{
+    EntryCount = 0;
+    DeadCount = 0;
+    LiveBytes = 0;
+    memset(MboxMsgCount, 0, sizeof(MboxMsgCount));
+    memset(MboxFirstPos, 0, sizeof(MboxFirstPos));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the index in the index file.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SaveIndex
+(
+    void
+)
+{
+    // The index must not cover records that could still be lost.
+    if (SyncLog() != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    SqueezeEntries();
+
+    IndexHeader_t header =
+    {
+        .magic = INDEX_MAGIC,
+        .version = STORE_VERSION,
+        .generation = LogGeneration,
+        .logSize = LogSize,
+        .nextMsgId = NextMsgId,
+        .count = EntryCount,
+        .crc = 0
+    };
+
+    uint32_t crc = le_crc_Crc32((uint8_t*)&header, sizeof(header), LE_CRC_START_CRC32);
+    header.crc = le_crc_Crc32((uint8_t*)EntryPtr, EntryCount * sizeof(Entry_t), crc);
+
+    int fd = open(IndexTmpPath, O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR);
+
+    if (fd < 0)
+    {
+        LE_ERROR("Unable to create %s: %m", IndexTmpPath);
+        return LE_FAULT;
+    }
+
+    le_result_t result = WriteAt(fd, &header, sizeof(header), 0);
+
+    if (LE_OK == result)
+    {
+        result = WriteAt(fd, EntryPtr, EntryCount * sizeof(Entry_t), sizeof(header));
+    }
+
+    if ((LE_OK == result) && (fsync(fd) < 0))
+    {
+        LE_ERROR("Unable to sync %s: %m", IndexTmpPath);
+        result = LE_FAULT;
+    }
+
+    close(fd);
+
+    if ((LE_OK == result) && (rename(IndexTmpPath, IndexPath) < 0))
+    {
+        LE_ERROR("Unable to rename %s: %m", IndexTmpPath);
+        result = LE_FAULT;
+    }
+
+    if (result != LE_OK)
+    {
+        unlink(IndexTmpPath);
+        return result;
+    }
+
+    if (SyncDir() != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    IndexedLogSize = LogSize;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Count the messages of each mailbox, and the size of their records.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecountEntries
+(
+    void
+)
+{
+    uint32_t i;
+    uint8_t mbox;
+
+    DeadCount = 0;
+    LiveBytes = 0;
+    memset(MboxMsgCount, 0, sizeof(MboxMsgCount));
+    memset(MboxFirstPos, 0, sizeof(MboxFirstPos));
+
+    for (i = 0; i < EntryCount; i++)
+    {
+        if (EntryPtr[i].mboxMask == 0)
+        {
+            DeadCount++;
+            continue;
+        }
+
+        LiveBytes += RECORD_SIZE(EntryPtr[i].dataSize);
+
+        for (mbox = 0; mbox < MboxCount; mbox++)
+        {
+            if (EntryPtr[i].mboxMask & (1U << mbox))
+            {
+                MboxMsgCount[mbox]++;
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the index from the index file.
+ *
+ * @return
+ *  - LE_OK on success, with the size of the log covered by the index.
+ *  - LE_NOT_FOUND if there is no index file.
+ *  - LE_FORMAT_ERROR if the index file is invalid, or is not the index of this log.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadIndex
+(
+    uint32_t fileSize,      ///<[IN] Size of the log
+    uint32_t* logSizePtr    ///<[OUT] Size of the log covered by the index
+)
+{
+    IndexHeader_t header;
+    struct stat st;
+
+    int fd = open(IndexPath, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if ((fstat(fd, &st) < 0) ||
+        (ReadAt(fd, &header, sizeof(header), 0) != LE_OK) ||
+        (header.magic != INDEX_MAGIC) ||
+        (header.version != STORE_VERSION) ||
+        (header.generation != LogGeneration) ||
+        (header.logSize < sizeof(LogHeader_t)) ||
+        (header.logSize > fileSize) ||
+        (st.st_size != (off_t)(sizeof(header) + (uint64_t)header.count * sizeof(Entry_t))) ||
+        (ReserveEntries(header.count) != LE_OK) ||
+        (ReadAt(fd, EntryPtr, header.count * sizeof(Entry_t), sizeof(header)) != LE_OK))
+    {
+        close(fd);
+        return LE_FORMAT_ERROR;
+    }
+
+    close(fd);
+
+    uint32_t storedCrc = header.crc;
+    header.crc = 0;
+
+    uint32_t crc = le_crc_Crc32((uint8_t*)&header, sizeof(header), LE_CRC_START_CRC32);
+    crc = le_crc_Crc32((uint8_t*)EntryPtr, header.count * sizeof(Entry_t), crc);
+
+    if (crc != storedCrc)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    uint32_t i;
+    const Entry_t* entryPtr = EntryPtr;
+
+    for (i = 0; i < header.count; i++, entryPtr++)
+    {
+        if ((entryPtr->msgId == 0) ||
+            (entryPtr->msgId >= header.nextMsgId) ||
+            ((i > 0) && (entryPtr->msgId <= entryPtr[-1].msgId)) ||
+            (entryPtr->mboxMask == 0) ||
+            (entryPtr->mboxMask & ~GetAllMboxMask()) ||
+            (entryPtr->dataSize > SMSINBOXSTORE_MAX_DATA_BYTES) ||
+            (entryPtr->offset < sizeof(LogHeader_t)) ||
+            (entryPtr->offset > header.logSize - RECORD_SIZE(entryPtr->dataSize)))
+        {
+            return LE_FORMAT_ERROR;
+        }
+    }
+
+    EntryCount = header.count;
+    RecountEntries();
+
+    if (header.nextMsgId > NextMsgId)
+    {
+        NextMsgId = header.nextMsgId;
+    }
+
+    *logSizePtr = header.logSize;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Apply a record of the log to the index.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FORMAT_ERROR if the record is inconsistent with the index
+ *  - LE_NO_MEMORY if the index cannot grow
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyRecord
+(
+    const RecordHeader_t* headerPtr,    ///<[IN] Record header
+    uint32_t offset                     ///<[IN] Offset of the record
+)
+{
+    if ((headerPtr->mboxMask & ~GetAllMboxMask()) ||
+        (headerPtr->unreadMask & ~headerPtr->mboxMask))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    if (RECORD_MESSAGE == headerPtr->type)
+    {
+        if ((headerPtr->msgId == 0) ||
+            (headerPtr->mboxMask == 0) ||
+            ((EntryCount > 0) && (headerPtr->msgId <= EntryPtr[EntryCount - 1].msgId)))
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        if (ReserveEntries(EntryCount + 1) != LE_OK)
+        {
+            return LE_NO_MEMORY;
+        }
+
+        PushEntry(headerPtr->msgId, offset, headerPtr->dataSize, headerPtr->mboxMask,
+                  headerPtr->unreadMask);
+    }
+    else
+    {
+        // The message may have been deleted by an earlier record.
+        Entry_t* entryPtr = FindEntry(headerPtr->msgId);
+
+        if (entryPtr)
+        {
+            SetEntryMasks(entryPtr, headerPtr->mboxMask, headerPtr->unreadMask);
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Replay the records of the log from an offset.  A corrupted record is skipped up to the next
+ * valid record, and the log is truncated after the last valid record.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReplayLog
+(
+    uint32_t offset,        ///<[IN] Offset of the first record to replay
+    uint32_t fileSize       ///<[IN] Size of the log
+)
+{
+    RecordHeader_t header;
+    uint8_t data[SMSINBOXSTORE_MAX_DATA_BYTES];
+    le_result_t result = LE_OK;
+    uint32_t count = 0;
+
+    while (offset < fileSize)
+    {
+        result = ReadRecord(LogFd, offset, fileSize, &header, data);
+
+        if (LE_FORMAT_ERROR == result)
+        {
+            uint32_t badOffset = offset;
+
+            result = FindNextRecord(LogFd, &offset, fileSize, &header, data);
+
+            if (LE_NOT_FOUND == result)
+            {
+                // Interrupted append, or corrupted end of the log.
+                result = LE_OK;
+                break;
+            }
+
+            LE_WARN_IF(LE_OK == result, "Skipped %u corrupted bytes at offset %u of %s",
+                       offset - badOffset, badOffset, LogPath);
+        }
+
+        if (LE_OK == result)
+        {
+            result = ApplyRecord(&header, offset);
+
+            if (LE_FORMAT_ERROR == result)
+            {
+                LE_WARN("Skipped inconsistent record at offset %u of %s", offset, LogPath);
+                result = LE_OK;
+            }
+        }
+
+        if (result != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        offset += RECORD_SIZE(header.dataSize);
+        count++;
+    }
+
+    LE_DEBUG("Replayed %u records", count);
+
+    if (offset < fileSize)
+    {
+        // Drop the end of the log, which holds no valid record.
+        LE_WARN("Truncating %s from %u to %u bytes", LogPath, fileSize, offset);
+
+        if (ftruncate(LogFd, offset) < 0)
+        {
+            LE_ERROR("Unable to truncate %s: %m", LogPath);
+            return LE_FAULT;
+        }
+    }
+
+    LogSize = offset;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write a new log with the messages of the index, and replace the log with it.  This is used to
+ * compact the log, and to create it.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RewriteLog
+(
+    void
+)
+{
+    LogHeader_t header;
+    RecordHeader_t recordHeader;
+    uint8_t data[SMSINBOXSTORE_MAX_DATA_BYTES];
+    uint32_t* offsetPtr = NULL;
+    uint32_t i;
+    le_result_t result = LE_OK;
+
+    SqueezeEntries();
+
+    memset(&header, 0, sizeof(header));
+    header.magic = LOG_MAGIC;
+    header.version = STORE_VERSION;
+    header.generation = LogGeneration + 1;
+    header.nextMsgId = NextMsgId;
+    header.mboxCount = MboxCount;
+    memcpy(header.mboxName, MboxNames, sizeof(header.mboxName));
+    header.crc = le_crc_Crc32((uint8_t*)&header, sizeof(header), LE_CRC_START_CRC32);
+
+    if (EntryCount > 0)
+    {
+        offsetPtr = malloc(EntryCount * sizeof(uint32_t));
+
+        if (NULL == offsetPtr)
+        {
+            LE_ERROR("Unable to allocate %u offsets", EntryCount);
+            return LE_FAULT;
+        }
+    }
+
+    int fd = open(LogTmpPath, O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR);
+
+    if (fd < 0)
+    {
+        LE_ERROR("Unable to create %s: %m", LogTmpPath);
+        free(offsetPtr);
+        return LE_FAULT;
+    }
+
+    uint32_t offset = sizeof(header);
+
+    result = WriteAt(fd, &header, sizeof(header), 0);
+
+    // Copy the messages, with their current mailboxes and unread flags.
+    for (i = 0; (i < EntryCount) && (LE_OK == result); i++)
+    {
+        Entry_t* entryPtr = &EntryPtr[i];
+
+        result = ReadRecord(LogFd, entryPtr->offset, LogSize, &recordHeader, data);
+
+        if ((LE_OK == result) &&
+            ((recordHeader.type != RECORD_MESSAGE) || (recordHeader.msgId != entryPtr->msgId)))
+        {
+            result = LE_FORMAT_ERROR;
+        }
+
+        if (LE_OK == result)
+        {
+            result = WriteRecord(fd, offset, RECORD_MESSAGE, entryPtr->msgId,
+                                 entryPtr->mboxMask, entryPtr->unreadMask,
+                                 data, entryPtr->dataSize);
+        }
+        else
+        {
+            LE_ERROR("Unable to read message %u", entryPtr->msgId);
+        }
+
+        offsetPtr[i] = offset;
+        offset += RECORD_SIZE(entryPtr->dataSize);
+    }
+
+    if ((LE_OK == result) && (fsync(fd) < 0))
+    {
+        LE_ERROR("Unable to sync %s: %m", LogTmpPath);
+        result = LE_FAULT;
+    }
+
+    if ((LE_OK == result) && (rename(LogTmpPath, LogPath) < 0))
+    {
+        LE_ERROR("Unable to rename %s: %m", LogTmpPath);
+        result = LE_FAULT;
+    }
+
+    if (result != LE_OK)
+    {
+        close(fd);
+        unlink(LogTmpPath);
+        free(offsetPtr);
+        return LE_FAULT;
+    }
+
+    // The new log is in place: a crash before the directory is synced only brings back the old
+    // log, with its own index.  SaveIndex() below syncs the directory again.
+    LE_ERROR_IF(SyncDir() != LE_OK, "Unable to sync the new log");
+
+    if (LogFd >= 0)
+    {
+        close(LogFd);
+    }
+
+    LogFd = fd;
+    LogGeneration = header.generation;
+    LogSize = offset;
+    IsLogSyncNeeded = false;
+
+    for (i = 0; i < EntryCount; i++)
+    {
+        EntryPtr[i].offset = offsetPtr[i];
+    }
+
+    free(offsetPtr);
+
+    LE_DEBUG("Log rewritten: %u messages, %u bytes", EntryCount, LogSize);
+
+    return SaveIndex();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compact the log if it is mostly made of deleted messages and FLAGS records, or save the index
+ * if enough records have been appended since it was last saved.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompactOrSaveIndex
+(
+    void
+)
+{
+    uint32_t garbageBytes = LogSize - sizeof(LogHeader_t) - LiveBytes;
+    uint32_t indexSize = sizeof(IndexHeader_t) + (EntryCount - DeadCount) * sizeof(Entry_t);
+    uint32_t unindexedBytes = LogSize - IndexedLogSize;
+
+    if ((garbageBytes >= COMPACT_MIN_BYTES) && (garbageBytes > LiveBytes))
+    {
+        if (RewriteLog() != LE_OK)
+        {
+            LE_ERROR("Unable to compact the log");
+        }
+    }
+    else if ((unindexedBytes >= INDEX_SAVE_MIN_BYTES) && (unindexedBytes >= indexSize))
+    {
+        if (SaveIndex() != LE_OK)
+        {
+            LE_ERROR("Unable to save the index");
+        }
+    }
+    else if ((DeadCount >= SQUEEZE_MIN_ENTRIES) && (DeadCount > EntryCount / 2))
+    {
+        SqueezeEntries();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read and check the log header.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FORMAT_ERROR if the header is invalid
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadLogHeader
+(
+    LogHeader_t* headerPtr      ///<[OUT] Log header
+)
+{
+    if (ReadAt(LogFd, headerPtr, sizeof(LogHeader_t), 0) != LE_OK)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    uint32_t storedCrc = headerPtr->crc;
+    headerPtr->crc = 0;
+
+    if ((headerPtr->magic != LOG_MAGIC) ||
+        (headerPtr->version != STORE_VERSION) ||
+        (headerPtr->mboxCount > SMSINBOXSTORE_MAX_MBOX) ||
+        (le_crc_Crc32((uint8_t*)headerPtr, sizeof(LogHeader_t), LE_CRC_START_CRC32) != storedCrc))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Match the mailboxes of the log with new mailbox names, and change the masks of the messages
+ * accordingly.
+ *
+ * @return
+ *  - true if the mailboxes have changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool RemapMboxes
+(
+    char mboxNames[SMSINBOXSTORE_MAX_MBOX][MBOX_NAME_BYTES],  ///<[IN] New mailbox names
+    uint8_t mboxCount                                           ///<[IN] New number of mailboxes
+)
+{
+    uint8_t newMbox[SMSINBOXSTORE_MAX_MBOX];
+    bool isChanged = (mboxCount != MboxCount);
+    uint8_t mbox;
+    uint8_t i;
+    uint32_t j;
+
+    for (mbox = 0; mbox < MboxCount; mbox++)
+    {
+        newMbox[mbox] = SMSINBOXSTORE_MAX_MBOX;
+
+        for (i = 0; i < mboxCount; i++)
+        {
+            if (strncmp(MboxNames[mbox], mboxNames[i], MBOX_NAME_BYTES) == 0)
+            {
+                newMbox[mbox] = i;
+                break;
+            }
+        }
+
+        if (newMbox[mbox] != mbox)
+        {
+            isChanged = true;
+        }
+    }
+
+    if (!isChanged)
+    {
+        return false;
+    }
+
+    LE_INFO("Mailboxes have changed");
+
+    for (j = 0; j < EntryCount; j++)
+    {
+        uint32_t mboxMask = 0;
+        uint32_t unreadMask = 0;
+
+        for (mbox = 0; mbox < MboxCount; mbox++)
+        {
+            if (newMbox[mbox] < SMSINBOXSTORE_MAX_MBOX)
+            {
+                if (EntryPtr[j].mboxMask & (1U << mbox))
+                {
+                    mboxMask |= 1U << newMbox[mbox];
+                }
+
+                if (EntryPtr[j].unreadMask & (1U << mbox))
+                {
+                    unreadMask |= 1U << newMbox[mbox];
+                }
+            }
+        }
+
+        EntryPtr[j].mboxMask = mboxMask;
+        EntryPtr[j].unreadMask = unreadMask;
+    }
+
+    memcpy(MboxNames, mboxNames, sizeof(MboxNames));
+    MboxCount = mboxCount;
+    RecountEntries();
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message to the log and to the index.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_BAD_PARAMETER if the message is too long or is not in any mailbox
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t AddMessage
+(
+    uint32_t msgId,         ///<[IN] Message identifier
+    const uint8_t* dataPtr, ///<[IN] Message data
+    size_t dataSize,        ///<[IN] Size of the message data
+    uint32_t mboxMask,      ///<[IN] Mailboxes of the message
+    uint32_t unreadMask     ///<[IN] Mailboxes in which the message is unread
+)
+{
+    mboxMask &= GetAllMboxMask();
+    unreadMask &= mboxMask;
+
+    if ((dataSize > SMSINBOXSTORE_MAX_DATA_BYTES) || (mboxMask == 0) || (msgId == 0))
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    if (ReserveEntries(EntryCount + 1) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    uint32_t offset = LogSize;
+
+    if (AppendRecord(RECORD_MESSAGE, msgId, mboxMask, unreadMask, dataPtr, dataSize) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    PushEntry(msgId, offset, dataSize, mboxMask, unreadMask);
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the mailboxes and the unread flags of a message.
+ *
+ * @return
+ *  - LE_OK on success
+ *  - LE_FAULT on error
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t UpdateMessage
+(
+    Entry_t* entryPtr,      ///<[IN] Entry of the message
+    uint32_t mboxMask,      ///<[IN] New mailboxes
+    uint32_t unreadMask     ///<[IN] New unread flags
+)
+{
+    unreadMask &= mboxMask;
+
+    if ((mboxMask == entryPtr->mboxMask) && (unreadMask == entryPtr->unreadMask))
+    {
+        return LE_OK;
+    }
+
+    if (AppendRecord(RECORD_FLAGS, entryPtr->msgId, mboxMask, unreadMask, NULL, 0) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    SetEntryMasks(entryPtr, mboxMask, unreadMask);
+    CompactOrSaveIndex();
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+//                                       Public declarations
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the store in a directory, creating it if needed.  The messages are loaded from the index
+ * and the end of the log.
+ *
+ * The mailboxes are identified by their position in the list of names.  If the list differs from
+ * the one the store was written with, the mailboxes are matched by name and the messages of the
+ * mailboxes no longer listed are deleted.
+ *
+ * @return
+ *  - LE_OK            The store is open.
+ *  - LE_BAD_PARAMETER Too many mailboxes.
+ *  - LE_FAULT         The store could not be opened.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Init
+(
+    const char* dirPtr,
+        ///< [IN]
+        ///< Directory of the store.
+
+    const char* const* mboxNamePtr,
+        ///< [IN]
+        ///< Names of the mailboxes.
+
+    uint8_t mboxCount
+        ///< [IN]
+        ///< Number of mailboxes.
+)
+{
+    char mboxNames[SMSINBOXSTORE_MAX_MBOX][MBOX_NAME_BYTES];
+    uint8_t mbox;
+
+    if (mboxCount > SMSINBOXSTORE_MAX_MBOX)
+    {
+        LE_ERROR("Too many mailboxes: %u", mboxCount);
+        return LE_BAD_PARAMETER;
+    }
+
+    memset(mboxNames, 0, sizeof(mboxNames));
+
+    for (mbox = 0; mbox < mboxCount; mbox++)
+    {
+        if (le_utf8_Copy(mboxNames[mbox], mboxNamePtr[mbox], MBOX_NAME_BYTES, NULL) != LE_OK)
+        {
+            LE_WARN("Mailbox name %s truncated", mboxNamePtr[mbox]);
+        }
+    }
+
+    if ((le_utf8_Copy(DirPath, dirPtr, sizeof(DirPath), NULL) != LE_OK) ||
+        (snprintf(LogPath, sizeof(LogPath), "%s/%s", dirPtr, LOG_FILE) >= (int)sizeof(LogPath)) ||
+        (snprintf(LogTmpPath, sizeof(LogTmpPath), "%s%s", LogPath, TMP_EXTENSION)
+                                                                    >= (int)sizeof(LogTmpPath)) ||
+        (snprintf(IndexPath, sizeof(IndexPath), "%s/%s", dirPtr, INDEX_FILE)
+                                                                    >= (int)sizeof(IndexPath)) ||
+        (snprintf(IndexTmpPath, sizeof(IndexTmpPath), "%s%s", IndexPath, TMP_EXTENSION)
+                                                                    >= (int)sizeof(IndexTmpPath)))
+    {
+        LE_ERROR("Store path too long: %s", dirPtr);
+        return LE_FAULT;
+    }
+
+    if (le_dir_MakePath(dirPtr, S_IRWXU) != LE_OK)
+    {
+        LE_ERROR("Unable to create directory %s", dirPtr);
+        return LE_FAULT;
+    }
+
+    SmsInboxStore_Close();
+
+    LogFd = open(LogPath, O_RDWR);
+
+    if (LogFd < 0)
+    {
+        if (errno != ENOENT)
+        {
+            LE_ERROR("Unable to open %s: %m", LogPath);
+            return LE_FAULT;
+        }
+
+        LE_INFO("Creating store in %s", dirPtr);
+        memcpy(MboxNames, mboxNames, sizeof(MboxNames));
+        MboxCount = mboxCount;
+
+        return RewriteLog();
+    }
+
+    LogHeader_t header;
+    struct stat st;
+
+    if ((ReadLogHeader(&header) != LE_OK) ||
+        (fstat(LogFd, &st) < 0) ||
+        ((uint64_t)st.st_size > UINT32_MAX))
+    {
+        LE_ERROR("Invalid log %s, starting an empty store", LogPath);
+        unlink(IndexPath);
+        memcpy(MboxNames, mboxNames, sizeof(MboxNames));
+        MboxCount = mboxCount;
+
+        return RewriteLog();
+    }
+
+    // Load the messages with the mailboxes of the log.
+    memcpy(MboxNames, header.mboxName, sizeof(MboxNames));
+    MboxCount = header.mboxCount;
+    LogGeneration = header.generation;
+    NextMsgId = (header.nextMsgId > 0) ? header.nextMsgId : 1;
+
+    uint32_t offset = sizeof(LogHeader_t);
+    le_result_t result = LoadIndex(st.st_size, &offset);
+
+    if (result != LE_OK)
+    {
+        LE_INFO("No valid index (%s), replaying the whole log", LE_RESULT_TXT(result));
+        ResetEntries();
+        offset = sizeof(LogHeader_t);
+    }
+
+    IndexedLogSize = offset;
+
+    if (ReplayLog(offset, st.st_size) != LE_OK)
+    {
+        SmsInboxStore_Close();
+        return LE_FAULT;
+    }
+
+    LE_INFO("Loaded %u messages from %s", EntryCount - DeadCount, dirPtr);
+
+    if (RemapMboxes(mboxNames, mboxCount))
+    {
+        return RewriteLog();
+    }
+
+    CompactOrSaveIndex();
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the store, after saving its index.
+ */
+//--------------------------------------------------------------------------------------------------
+void SmsInboxStore_Close
+(
+    void
+)
+{
+    if (LogFd >= 0)
+    {
+        if ((LogSize != IndexedLogSize) && (SaveIndex() != LE_OK))
+        {
+            LE_ERROR("Unable to save the index");
+        }
+
+        close(LogFd);
+        LogFd = -1;
+    }
+
+    free(EntryPtr);
+    EntryPtr = NULL;
+    EntryCapacity = 0;
+    ResetEntries();
+
+    LogGeneration = 0;
+    LogSize = 0;
+    IndexedLogSize = 0;
+    IsLogSyncNeeded = false;
+    NextMsgId = 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete all the messages of the store.
+ *
+ * @return
+ *  - LE_OK            The store is empty.
+ *  - LE_FAULT         The store could not be emptied.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Clear
+(
+    void
+)
+{
+    ResetEntries();
+
+    return RewriteLog();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a new message, unread in all its mailboxes.  The message is on flash when the function
+ * returns.
+ *
+ * @return
+ *  - LE_OK            The message is added.
+ *  - LE_BAD_PARAMETER The message is too long or is not in any mailbox.
+ *  - LE_FAULT         The message could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Add
+(
+    const uint8_t* dataPtr,
+        ///< [IN]
+        ///< Message data.
+
+    size_t dataSize,
+        ///< [IN]
+        ///< Size of the message data, in bytes.
+
+    uint32_t mboxMask,
+        ///< [IN]
+        ///< Mailboxes of the message, one bit per mailbox.
+
+    uint32_t* msgIdPtr
+        ///< [OUT]
+        ///< Identifier given to the message.
+)
+{
+    uint32_t msgId = NextMsgId;
+    le_result_t result = AddMessage(msgId, dataPtr, dataSize, mboxMask, mboxMask);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    *msgIdPtr = msgId;
+
+    if (SyncLog() != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    CompactOrSaveIndex();
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message with a given identifier, e.g. when importing messages from another store.  The
+ * identifier must be greater than those of the messages in the store.  The message is only sure
+ * to be on flash after SmsInboxStore_Sync().
+ *
+ * @return
+ *  - LE_OK            The message is added.
+ *  - LE_BAD_PARAMETER The message is too long, is not in any mailbox, or its identifier is
+ *                     not greater than those in the store.
+ *  - LE_FAULT         The message could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Import
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    const uint8_t* dataPtr,
+        ///< [IN]
+        ///< Message data.
+
+    size_t dataSize,
+        ///< [IN]
+        ///< Size of the message data, in bytes.
+
+    uint32_t mboxMask,
+        ///< [IN]
+        ///< Mailboxes of the message, one bit per mailbox.
+
+    uint32_t unreadMask
+        ///< [IN]
+        ///< Mailboxes in which the message is unread, one bit per mailbox.
+)
+{
+    if (msgId < NextMsgId)
+    {
+        return LE_BAD_PARAMETER;
+    }
+
+    le_result_t result = AddMessage(msgId, dataPtr, dataSize, mboxMask, unreadMask);
+
+    if (LE_OK == result)
+    {
+        CompactOrSaveIndex();
+    }
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the changes to flash, and save the index.
+ *
+ * @return
+ *  - LE_OK            The changes are on flash.
+ *  - LE_FAULT         The changes could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Sync
+(
+    void
+)
+{
+    if (LogFd < 0)
+    {
+        return LE_FAULT;
+    }
+
+    if (LogSize == IndexedLogSize)
+    {
+        return LE_OK;
+    }
+
+    return SaveIndex();
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the data of a message.
+ *
+ * @return
+ *  - LE_OK            The data is read.
+ *  - LE_NOT_FOUND     There is no such message.
+ *  - LE_OVERFLOW      The buffer is too small.
+ *  - LE_FAULT         The message could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Read
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t* bufPtr,
+        ///< [OUT]
+        ///< Buffer for the message data.
+
+    size_t* bufSizePtr
+        ///< [INOUT]
+        ///< Size of the buffer, then size of the message data, in bytes.
+)
+{
+    Entry_t* entryPtr = FindEntry(msgId);
+
+    if (NULL == entryPtr)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if (entryPtr->dataSize > *bufSizePtr)
+    {
+        return LE_OVERFLOW;
+    }
+
+    RecordHeader_t header;
+    uint8_t data[SMSINBOXSTORE_MAX_DATA_BYTES];
+
+    if ((ReadRecord(LogFd, entryPtr->offset, LogSize, &header, data) != LE_OK) ||
+        (header.type != RECORD_MESSAGE) ||
+        (header.msgId != msgId))
+    {
+        LE_ERROR("Unable to read message %u", msgId);
+        return LE_FAULT;
+    }
+
+    memcpy(bufPtr, data, header.dataSize);
+    *bufSizePtr = header.dataSize;
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message is in a mailbox.
+ *
+ * @return True if the message is in the mailbox, false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+bool SmsInboxStore_IsInMbox
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t mbox
+        ///< [IN]
+        ///< Mailbox.
+)
+{
+    Entry_t* entryPtr = FindEntry(msgId);
+
+    return (entryPtr != NULL) && (mbox < MboxCount) && (entryPtr->mboxMask & (1U << mbox));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message is unread in a mailbox.
+ *
+ * @return True if the message is in the mailbox and unread, false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+bool SmsInboxStore_IsUnread
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t mbox
+        ///< [IN]
+        ///< Mailbox.
+)
+{
+    Entry_t* entryPtr = FindEntry(msgId);
+
+    return (entryPtr != NULL) && (mbox < MboxCount) && (entryPtr->unreadMask & (1U << mbox));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mark a message as read or unread in a mailbox.
+ *
+ * @return
+ *  - LE_OK            The message is marked.
+ *  - LE_NOT_FOUND     The message is not in the mailbox.
+ *  - LE_FAULT         The change could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_SetUnread
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t mbox,
+        ///< [IN]
+        ///< Mailbox.
+
+    bool isUnread
+        ///< [IN]
+        ///< True to mark the message as unread, false to mark it as read.
+)
+{
+    if (!SmsInboxStore_IsInMbox(msgId, mbox))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    Entry_t* entryPtr = FindEntry(msgId);
+    uint32_t unreadMask = entryPtr->unreadMask;
+
+    if (isUnread)
+    {
+        unreadMask |= 1U << mbox;
+    }
+    else
+    {
+        unreadMask &= ~(1U << mbox);
+    }
+
+    return UpdateMessage(entryPtr, entryPtr->mboxMask, unreadMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a message from a mailbox.  The message is deleted once it is in no mailbox.
+ *
+ * @return
+ *  - LE_OK            The message is removed.
+ *  - LE_NOT_FOUND     The message is not in the mailbox.
+ *  - LE_FAULT         The change could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Remove
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t mbox
+        ///< [IN]
+        ///< Mailbox.
+)
+{
+    if (!SmsInboxStore_IsInMbox(msgId, mbox))
+    {
+        return LE_NOT_FOUND;
+    }
+
+    Entry_t* entryPtr = FindEntry(msgId);
+
+    return UpdateMessage(entryPtr, entryPtr->mboxMask & ~(1U << mbox), entryPtr->unreadMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of messages in a mailbox.
+ *
+ * @return Number of messages.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t SmsInboxStore_GetCount
+(
+    uint8_t mbox
+        ///< [IN]
+        ///< Mailbox.
+)
+{
+    if (mbox >= MboxCount)
+    {
+        return 0;
+    }
+
+    return MboxMsgCount[mbox];
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the oldest message of a mailbox received after a given message.  Messages are ordered by
+ * identifier.
+ *
+ * @return
+ *  - 0 No more messages.
+ *  - Message identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t SmsInboxStore_GetNext
+(
+    uint8_t mbox,
+        ///< [IN]
+        ///< Mailbox.
+
+    uint32_t msgId
+        ///< [IN]
+        ///< Message identifier, or 0 to get the oldest message of the mailbox.
+)
+{
+    if ((mbox >= MboxCount) || (MboxMsgCount[mbox] == 0) || (msgId == UINT32_MAX))
+    {
+        return 0;
+    }
+
+    // The entries before MboxFirstPos are not in the mailbox: messages are only ever added to a
+    // mailbox with a new entry at the end of the index.
+    uint32_t pos = FindPos(msgId + 1);
+
+    if (pos < MboxFirstPos[mbox])
+    {
+        pos = MboxFirstPos[mbox];
+    }
+
+    while ((pos < EntryCount) && !(EntryPtr[pos].mboxMask & (1U << mbox)))
+    {
+        pos++;
+    }
+
+    if (msgId == 0)
+    {
+        MboxFirstPos[mbox] = pos;
+    }
+
+    return (pos < EntryCount) ? EntryPtr[pos].msgId : 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the identifier of the last message added.
+ *
+ * @return
+ *  - 0 No message has been added.
+ *  - Message identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t SmsInboxStore_GetLastId
+(
+    void
+)
+{
+    return NextMsgId - 1;
+}
@@ -0,0 +1,330 @@
+// -------------------------------------------------------------------------------------------------
+/**
+ *  SMS Inbox Store
+ *
+ * Declaration of the message store of the smsInbox.
+ *
+ * The messages are appended to a log file, along with the changes of their mailboxes and read
+ * flags.  An index of the messages (identifier, mailboxes, unread flags and offset in the log) is
+ * kept in memory, and saved from time to time in a binary index file so that only the end of the
+ * log has to be replayed at start-up.  Records are checked with a CRC, and a log ending with a
+ * partially written record is truncated.  The log is compacted when most of it is made of deleted
+ * messages and obsolete flag changes.
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+// -------------------------------------------------------------------------------------------------
+
+#ifndef SMSINBOXSTORE_H_INCLUDE_GUARD
+#define SMSINBOXSTORE_H_INCLUDE_GUARD
+
+#include "legato.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of mailboxes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMSINBOXSTORE_MAX_MBOX 16
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of the data of a message, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SMSINBOXSTORE_MAX_DATA_BYTES 512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open the store in a directory, creating it if needed.  The messages are loaded from the index
+ * and the end of the log.
+ *
+ * The mailboxes are identified by their position in the list of names.  If the list differs from
+ * the one the store was written with, the mailboxes are matched by name and the messages of the
+ * mailboxes no longer listed are deleted.
+ *
+ * @return
+ *  - LE_OK            The store is open.
+ *  - LE_BAD_PARAMETER Too many mailboxes.
+ *  - LE_FAULT         The store could not be opened.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Init
+(
+    const char* dirPtr,
+        ///< [IN]
+        ///< Directory of the store.
+
+    const char* const* mboxNamePtr,
+        ///< [IN]
+        ///< Names of the mailboxes.
+
+    uint8_t mboxCount
+        ///< [IN]
+        ///< Number of mailboxes.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the store, after saving its index.
+ */
+//--------------------------------------------------------------------------------------------------
+void SmsInboxStore_Close
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete all the messages of the store.
+ *
+ * @return
+ *  - LE_OK            The store is empty.
+ *  - LE_FAULT         The store could not be emptied.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Clear
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a new message, unread in all its mailboxes.  The message is on flash when the function
+ * returns.
+ *
+ * @return
+ *  - LE_OK            The message is added.
+ *  - LE_BAD_PARAMETER The message is too long or is not in any mailbox.
+ *  - LE_FAULT         The message could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Add
+(
+    const uint8_t* dataPtr,
+        ///< [IN]
+        ///< Message data.
+
+    size_t dataSize,
+        ///< [IN]
+        ///< Size of the message data, in bytes.
+
+    uint32_t mboxMask,
+        ///< [IN]
+        ///< Mailboxes of the message, one bit per mailbox.
+
+    uint32_t* msgIdPtr
+        ///< [OUT]
+        ///< Identifier given to the message.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a message with a given identifier, e.g. when importing messages from another store.  The
+ * identifier must be greater than those of the messages in the store.  The message is only sure
+ * to be on flash after SmsInboxStore_Sync().
+ *
+ * @return
+ *  - LE_OK            The message is added.
+ *  - LE_BAD_PARAMETER The message is too long, is not in any mailbox, or its identifier is
+ *                     not greater than those in the store.
+ *  - LE_FAULT         The message could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Import
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    const uint8_t* dataPtr,
+        ///< [IN]
+        ///< Message data.
+
+    size_t dataSize,
+        ///< [IN]
+        ///< Size of the message data, in bytes.
+
+    uint32_t mboxMask,
+        ///< [IN]
+        ///< Mailboxes of the message, one bit per mailbox.
+
+    uint32_t unreadMask
+        ///< [IN]
+        ///< Mailboxes in which the message is unread, one bit per mailbox.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write the changes to flash, and save the index.
+ *
+ * @return
+ *  - LE_OK            The changes are on flash.
+ *  - LE_FAULT         The changes could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Sync
+(
+    void
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read the data of a message.
+ *
+ * @return
+ *  - LE_OK            The data is read.
+ *  - LE_NOT_FOUND     There is no such message.
+ *  - LE_OVERFLOW      The buffer is too small.
+ *  - LE_FAULT         The message could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Read
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t* bufPtr,
+        ///< [OUT]
+        ///< Buffer for the message data.
+
+    size_t* bufSizePtr
+        ///< [INOUT]
+        ///< Size of the buffer, then size of the message data, in bytes.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message is in a mailbox.
+ *
+ * @return True if the message is in the mailbox, false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+bool SmsInboxStore_IsInMbox
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t mbox
+        ///< [IN]
+        ///< Mailbox.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a message is unread in a mailbox.
+ *
+ * @return True if the message is in the mailbox and unread, false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+bool SmsInboxStore_IsUnread
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t mbox
+        ///< [IN]
+        ///< Mailbox.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mark a message as read or unread in a mailbox.
+ *
+ * @return
+ *  - LE_OK            The message is marked.
+ *  - LE_NOT_FOUND     The message is not in the mailbox.
+ *  - LE_FAULT         The change could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_SetUnread
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t mbox,
+        ///< [IN]
+        ///< Mailbox.
+
+    bool isUnread
+        ///< [IN]
+        ///< True to mark the message as unread, false to mark it as read.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a message from a mailbox.  The message is deleted once it is in no mailbox.
+ *
+ * @return
+ *  - LE_OK            The message is removed.
+ *  - LE_NOT_FOUND     The message is not in the mailbox.
+ *  - LE_FAULT         The change could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t SmsInboxStore_Remove
+(
+    uint32_t msgId,
+        ///< [IN]
+        ///< Message identifier.
+
+    uint8_t mbox
+        ///< [IN]
+        ///< Mailbox.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of messages in a mailbox.
+ *
+ * @return Number of messages.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t SmsInboxStore_GetCount
+(
+    uint8_t mbox
+        ///< [IN]
+        ///< Mailbox.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the oldest message of a mailbox received after a given message.  Messages are ordered by
+ * identifier.
+ *
+ * @return
+ *  - 0 No more messages.
+ *  - Message identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t SmsInboxStore_GetNext
+(
+    uint8_t mbox,
+        ///< [IN]
+        ///< Mailbox.
+
+    uint32_t msgId
+        ///< [IN]
+        ///< Message identifier, or 0 to get the oldest message of the mailbox.
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the identifier of the last message added.
+ *
+ * @return
+ *  - 0 No message has been added.
+ *  - Message identifier.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t SmsInboxStore_GetLastId
+(
+    void
+);
+
+#endif // SMSINBOXSTORE_H_INCLUDE_GUARD
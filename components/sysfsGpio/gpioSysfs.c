@@ -21,7 +21,7 @@
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin1 = {1,"gpio1",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin1 = {1,"gpio1",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin1 = &SysfsGpioPin1;
 
 void gpioPin1_InputMonitorHandlerFunc (int fd, short events)
@@ -155,7 +155,7 @@ le_result_t le_gpioPin1_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin2 = {2,"gpio2",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin2 = {2,"gpio2",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin2 = &SysfsGpioPin2;
 
 void gpioPin2_InputMonitorHandlerFunc (int fd, short events)
@@ -289,7 +289,7 @@ le_result_t le_gpioPin2_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin3 = {3,"gpio3",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin3 = {3,"gpio3",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin3 = &SysfsGpioPin3;
 
 void gpioPin3_InputMonitorHandlerFunc (int fd, short events)
@@ -423,7 +423,7 @@ le_result_t le_gpioPin3_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin4 = {4,"gpio4",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin4 = {4,"gpio4",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin4 = &SysfsGpioPin4;
 
 void gpioPin4_InputMonitorHandlerFunc (int fd, short events)
@@ -557,7 +557,7 @@ le_result_t le_gpioPin4_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin5 = {5,"gpio5",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin5 = {5,"gpio5",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin5 = &SysfsGpioPin5;
 
 void gpioPin5_InputMonitorHandlerFunc (int fd, short events)
@@ -691,7 +691,7 @@ le_result_t le_gpioPin5_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin6 = {6,"gpio6",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin6 = {6,"gpio6",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin6 = &SysfsGpioPin6;
 
 void gpioPin6_InputMonitorHandlerFunc (int fd, short events)
@@ -825,7 +825,7 @@ le_result_t le_gpioPin6_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin7 = {7,"gpio7",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin7 = {7,"gpio7",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin7 = &SysfsGpioPin7;
 
 void gpioPin7_InputMonitorHandlerFunc (int fd, short events)
@@ -959,7 +959,7 @@ le_result_t le_gpioPin7_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin8 = {8,"gpio8",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin8 = {8,"gpio8",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin8 = &SysfsGpioPin8;
 
 void gpioPin8_InputMonitorHandlerFunc (int fd, short events)
@@ -1093,7 +1093,7 @@ le_result_t le_gpioPin8_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin9 = {9,"gpio9",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin9 = {9,"gpio9",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin9 = &SysfsGpioPin9;
 
 void gpioPin9_InputMonitorHandlerFunc (int fd, short events)
@@ -1227,7 +1227,7 @@ le_result_t le_gpioPin9_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin10 = {10,"gpio10",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin10 = {10,"gpio10",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin10 = &SysfsGpioPin10;
 
 void gpioPin10_InputMonitorHandlerFunc (int fd, short events)
@@ -1361,7 +1361,7 @@ le_result_t le_gpioPin10_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin11 = {11,"gpio11",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin11 = {11,"gpio11",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin11 = &SysfsGpioPin11;
 
 void gpioPin11_InputMonitorHandlerFunc (int fd, short events)
@@ -1495,7 +1495,7 @@ le_result_t le_gpioPin11_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin12 = {12,"gpio12",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin12 = {12,"gpio12",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin12 = &SysfsGpioPin12;
 
 void gpioPin12_InputMonitorHandlerFunc (int fd, short events)
@@ -1629,7 +1629,7 @@ le_result_t le_gpioPin12_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin13 = {13,"gpio13",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin13 = {13,"gpio13",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin13 = &SysfsGpioPin13;
 
 void gpioPin13_InputMonitorHandlerFunc (int fd, short events)
@@ -1763,7 +1763,7 @@ le_result_t le_gpioPin13_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin14 = {14,"gpio14",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin14 = {14,"gpio14",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin14 = &SysfsGpioPin14;
 
 void gpioPin14_InputMonitorHandlerFunc (int fd, short events)
@@ -1897,7 +1897,7 @@ le_result_t le_gpioPin14_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin15 = {15,"gpio15",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin15 = {15,"gpio15",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin15 = &SysfsGpioPin15;
 
 void gpioPin15_InputMonitorHandlerFunc (int fd, short events)
@@ -2031,7 +2031,7 @@ le_result_t le_gpioPin15_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin16 = {16,"gpio16",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin16 = {16,"gpio16",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin16 = &SysfsGpioPin16;
 
 void gpioPin16_InputMonitorHandlerFunc (int fd, short events)
@@ -2165,7 +2165,7 @@ le_result_t le_gpioPin16_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin17 = {17,"gpio17",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin17 = {17,"gpio17",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin17 = &SysfsGpioPin17;
 
 void gpioPin17_InputMonitorHandlerFunc (int fd, short events)
@@ -2299,7 +2299,7 @@ le_result_t le_gpioPin17_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin18 = {18,"gpio18",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin18 = {18,"gpio18",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin18 = &SysfsGpioPin18;
 
 void gpioPin18_InputMonitorHandlerFunc (int fd, short events)
@@ -2433,7 +2433,7 @@ le_result_t le_gpioPin18_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin19 = {19,"gpio19",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin19 = {19,"gpio19",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin19 = &SysfsGpioPin19;
 
 void gpioPin19_InputMonitorHandlerFunc (int fd, short events)
@@ -2567,7 +2567,7 @@ le_result_t le_gpioPin19_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin20 = {20,"gpio20",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin20 = {20,"gpio20",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin20 = &SysfsGpioPin20;
 
 void gpioPin20_InputMonitorHandlerFunc (int fd, short events)
@@ -2701,7 +2701,7 @@ le_result_t le_gpioPin20_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin21 = {21,"gpio21",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin21 = {21,"gpio21",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin21 = &SysfsGpioPin21;
 
 void gpioPin21_InputMonitorHandlerFunc (int fd, short events)
@@ -2835,7 +2835,7 @@ le_result_t le_gpioPin21_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin22 = {22,"gpio22",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin22 = {22,"gpio22",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin22 = &SysfsGpioPin22;
 
 void gpioPin22_InputMonitorHandlerFunc (int fd, short events)
@@ -2969,7 +2969,7 @@ le_result_t le_gpioPin22_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin23 = {23,"gpio23",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin23 = {23,"gpio23",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin23 = &SysfsGpioPin23;
 
 void gpioPin23_InputMonitorHandlerFunc (int fd, short events)
@@ -3103,7 +3103,7 @@ le_result_t le_gpioPin23_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin24 = {24,"gpio24",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin24 = {24,"gpio24",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin24 = &SysfsGpioPin24;
 
 void gpioPin24_InputMonitorHandlerFunc (int fd, short events)
@@ -3237,7 +3237,7 @@ le_result_t le_gpioPin24_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin25 = {25,"gpio25",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin25 = {25,"gpio25",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin25 = &SysfsGpioPin25;
 
 void gpioPin25_InputMonitorHandlerFunc (int fd, short events)
@@ -3371,7 +3371,7 @@ le_result_t le_gpioPin25_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin26 = {26,"gpio26",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin26 = {26,"gpio26",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin26 = &SysfsGpioPin26;
 
 void gpioPin26_InputMonitorHandlerFunc (int fd, short events)
@@ -3505,7 +3505,7 @@ le_result_t le_gpioPin26_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin27 = {27,"gpio27",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin27 = {27,"gpio27",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin27 = &SysfsGpioPin27;
 
 void gpioPin27_InputMonitorHandlerFunc (int fd, short events)
@@ -3639,7 +3639,7 @@ le_result_t le_gpioPin27_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin28 = {28,"gpio28",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin28 = {28,"gpio28",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin28 = &SysfsGpioPin28;
 
 void gpioPin28_InputMonitorHandlerFunc (int fd, short events)
@@ -3773,7 +3773,7 @@ le_result_t le_gpioPin28_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin29 = {29,"gpio29",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin29 = {29,"gpio29",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin29 = &SysfsGpioPin29;
 
 void gpioPin29_InputMonitorHandlerFunc (int fd, short events)
@@ -3907,7 +3907,7 @@ le_result_t le_gpioPin29_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin30 = {30,"gpio30",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin30 = {30,"gpio30",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin30 = &SysfsGpioPin30;
 
 void gpioPin30_InputMonitorHandlerFunc (int fd, short events)
@@ -4041,7 +4041,7 @@ le_result_t le_gpioPin30_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin31 = {31,"gpio31",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin31 = {31,"gpio31",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin31 = &SysfsGpioPin31;
 
 void gpioPin31_InputMonitorHandlerFunc (int fd, short events)
@@ -4175,7 +4175,7 @@ le_result_t le_gpioPin31_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin32 = {32,"gpio32",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin32 = {32,"gpio32",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin32 = &SysfsGpioPin32;
 
 void gpioPin32_InputMonitorHandlerFunc (int fd, short events)
@@ -4309,7 +4309,7 @@ le_result_t le_gpioPin32_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin33 = {33,"gpio33",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin33 = {33,"gpio33",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin33 = &SysfsGpioPin33;
 
 void gpioPin33_InputMonitorHandlerFunc (int fd, short events)
@@ -4443,7 +4443,7 @@ le_result_t le_gpioPin33_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin34 = {34,"gpio34",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin34 = {34,"gpio34",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin34 = &SysfsGpioPin34;
 
 void gpioPin34_InputMonitorHandlerFunc (int fd, short events)
@@ -4577,7 +4577,7 @@ le_result_t le_gpioPin34_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin35 = {35,"gpio35",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin35 = {35,"gpio35",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin35 = &SysfsGpioPin35;
 
 void gpioPin35_InputMonitorHandlerFunc (int fd, short events)
@@ -4711,7 +4711,7 @@ le_result_t le_gpioPin35_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin36 = {36,"gpio36",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin36 = {36,"gpio36",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin36 = &SysfsGpioPin36;
 
 void gpioPin36_InputMonitorHandlerFunc (int fd, short events)
@@ -4845,7 +4845,7 @@ le_result_t le_gpioPin36_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin37 = {37,"gpio37",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin37 = {37,"gpio37",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin37 = &SysfsGpioPin37;
 
 void gpioPin37_InputMonitorHandlerFunc (int fd, short events)
@@ -4979,7 +4979,7 @@ le_result_t le_gpioPin37_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin38 = {38,"gpio38",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin38 = {38,"gpio38",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin38 = &SysfsGpioPin38;
 
 void gpioPin38_InputMonitorHandlerFunc (int fd, short events)
@@ -5113,7 +5113,7 @@ le_result_t le_gpioPin38_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin39 = {39,"gpio39",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin39 = {39,"gpio39",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin39 = &SysfsGpioPin39;
 
 void gpioPin39_InputMonitorHandlerFunc (int fd, short events)
@@ -5247,7 +5247,7 @@ le_result_t le_gpioPin39_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin40 = {40,"gpio40",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin40 = {40,"gpio40",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin40 = &SysfsGpioPin40;
 
 void gpioPin40_InputMonitorHandlerFunc (int fd, short events)
@@ -5381,7 +5381,7 @@ le_result_t le_gpioPin40_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin41 = {41,"gpio41",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin41 = {41,"gpio41",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin41 = &SysfsGpioPin41;
 
 void gpioPin41_InputMonitorHandlerFunc (int fd, short events)
@@ -5515,7 +5515,7 @@ le_result_t le_gpioPin41_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin42 = {42,"gpio42",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin42 = {42,"gpio42",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin42 = &SysfsGpioPin42;
 
 void gpioPin42_InputMonitorHandlerFunc (int fd, short events)
@@ -5649,7 +5649,7 @@ le_result_t le_gpioPin42_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin43 = {43,"gpio43",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin43 = {43,"gpio43",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin43 = &SysfsGpioPin43;
 
 void gpioPin43_InputMonitorHandlerFunc (int fd, short events)
@@ -5783,7 +5783,7 @@ le_result_t le_gpioPin43_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin44 = {44,"gpio44",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin44 = {44,"gpio44",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin44 = &SysfsGpioPin44;
 
 void gpioPin44_InputMonitorHandlerFunc (int fd, short events)
@@ -5917,7 +5917,7 @@ le_result_t le_gpioPin44_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin45 = {45,"gpio45",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin45 = {45,"gpio45",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin45 = &SysfsGpioPin45;
 
 void gpioPin45_InputMonitorHandlerFunc (int fd, short events)
@@ -6051,7 +6051,7 @@ le_result_t le_gpioPin45_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin46 = {46,"gpio46",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin46 = {46,"gpio46",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin46 = &SysfsGpioPin46;
 
 void gpioPin46_InputMonitorHandlerFunc (int fd, short events)
@@ -6185,7 +6185,7 @@ le_result_t le_gpioPin46_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin47 = {47,"gpio47",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin47 = {47,"gpio47",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin47 = &SysfsGpioPin47;
 
 void gpioPin47_InputMonitorHandlerFunc (int fd, short events)
@@ -6319,7 +6319,7 @@ le_result_t le_gpioPin47_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin48 = {48,"gpio48",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin48 = {48,"gpio48",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin48 = &SysfsGpioPin48;
 
 void gpioPin48_InputMonitorHandlerFunc (int fd, short events)
@@ -6453,7 +6453,7 @@ le_result_t le_gpioPin48_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin49 = {49,"gpio49",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin49 = {49,"gpio49",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin49 = &SysfsGpioPin49;
 
 void gpioPin49_InputMonitorHandlerFunc (int fd, short events)
@@ -6587,7 +6587,7 @@ le_result_t le_gpioPin49_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin50 = {50,"gpio50",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin50 = {50,"gpio50",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin50 = &SysfsGpioPin50;
 
 void gpioPin50_InputMonitorHandlerFunc (int fd, short events)
@@ -6721,7 +6721,7 @@ le_result_t le_gpioPin50_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin51 = {51,"gpio51",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin51 = {51,"gpio51",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin51 = &SysfsGpioPin51;
 
 void gpioPin51_InputMonitorHandlerFunc (int fd, short events)
@@ -6855,7 +6855,7 @@ le_result_t le_gpioPin51_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin52 = {52,"gpio52",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin52 = {52,"gpio52",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin52 = &SysfsGpioPin52;
 
 void gpioPin52_InputMonitorHandlerFunc (int fd, short events)
@@ -6989,7 +6989,7 @@ le_result_t le_gpioPin52_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin53 = {53,"gpio53",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin53 = {53,"gpio53",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin53 = &SysfsGpioPin53;
 
 void gpioPin53_InputMonitorHandlerFunc (int fd, short events)
@@ -7123,7 +7123,7 @@ le_result_t le_gpioPin53_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin54 = {54,"gpio54",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin54 = {54,"gpio54",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin54 = &SysfsGpioPin54;
 
 void gpioPin54_InputMonitorHandlerFunc (int fd, short events)
@@ -7257,7 +7257,7 @@ le_result_t le_gpioPin54_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin55 = {55,"gpio55",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin55 = {55,"gpio55",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin55 = &SysfsGpioPin55;
 
 void gpioPin55_InputMonitorHandlerFunc (int fd, short events)
@@ -7391,7 +7391,7 @@ le_result_t le_gpioPin55_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin56 = {56,"gpio56",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin56 = {56,"gpio56",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin56 = &SysfsGpioPin56;
 
 void gpioPin56_InputMonitorHandlerFunc (int fd, short events)
@@ -7525,7 +7525,7 @@ le_result_t le_gpioPin56_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin57 = {57,"gpio57",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin57 = {57,"gpio57",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin57 = &SysfsGpioPin57;
 
 void gpioPin57_InputMonitorHandlerFunc (int fd, short events)
@@ -7659,7 +7659,7 @@ le_result_t le_gpioPin57_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin58 = {58,"gpio58",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin58 = {58,"gpio58",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin58 = &SysfsGpioPin58;
 
 void gpioPin58_InputMonitorHandlerFunc (int fd, short events)
@@ -7793,7 +7793,7 @@ le_result_t le_gpioPin58_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin59 = {59,"gpio59",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin59 = {59,"gpio59",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin59 = &SysfsGpioPin59;
 
 void gpioPin59_InputMonitorHandlerFunc (int fd, short events)
@@ -7927,7 +7927,7 @@ le_result_t le_gpioPin59_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin60 = {60,"gpio60",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin60 = {60,"gpio60",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin60 = &SysfsGpioPin60;
 
 void gpioPin60_InputMonitorHandlerFunc (int fd, short events)
@@ -8061,7 +8061,7 @@ le_result_t le_gpioPin60_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin61 = {61,"gpio61",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin61 = {61,"gpio61",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin61 = &SysfsGpioPin61;
 
 void gpioPin61_InputMonitorHandlerFunc (int fd, short events)
@@ -8195,7 +8195,7 @@ le_result_t le_gpioPin61_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin62 = {62,"gpio62",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin62 = {62,"gpio62",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin62 = &SysfsGpioPin62;
 
 void gpioPin62_InputMonitorHandlerFunc (int fd, short events)
@@ -8329,7 +8329,7 @@ le_result_t le_gpioPin62_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin63 = {63,"gpio63",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin63 = {63,"gpio63",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin63 = &SysfsGpioPin63;
 
 void gpioPin63_InputMonitorHandlerFunc (int fd, short events)
@@ -8463,7 +8463,7 @@ le_result_t le_gpioPin63_DisableEdgeSense (void)
  */
 //--------------------------------------------------------------------------------------------------
 
-static struct gpioSysfs_Gpio SysfsGpioPin64 = {64,"gpio64",false,NULL,-1,NULL,NULL,NULL};
+static struct gpioSysfs_Gpio SysfsGpioPin64 = {64,"gpio64",false,NULL,-1,NULL,NULL,NULL,-1,false};
 static gpioSysfs_GpioRef_t gpioRefPin64 = &SysfsGpioPin64;
 
 void gpioPin64_InputMonitorHandlerFunc (int fd, short events)
@@ -8591,6 +8591,176 @@ le_result_t le_gpioPin64_DisableEdgeSense (void)
 //--------------------------------------------------------------------------------------------------
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * GPIO objects of all the pins, indexed by bit position in the le_gpioBatch masks.
+ */
+//--------------------------------------------------------------------------------------------------
+static const gpioSysfs_GpioRef_t GpioRefTable[] =
+{
+    &SysfsGpioPin1,
+    &SysfsGpioPin2,
+    &SysfsGpioPin3,
+    &SysfsGpioPin4,
+    &SysfsGpioPin5,
+    &SysfsGpioPin6,
+    &SysfsGpioPin7,
+    &SysfsGpioPin8,
+    &SysfsGpioPin9,
+    &SysfsGpioPin10,
+    &SysfsGpioPin11,
+    &SysfsGpioPin12,
+    &SysfsGpioPin13,
+    &SysfsGpioPin14,
+    &SysfsGpioPin15,
+    &SysfsGpioPin16,
+    &SysfsGpioPin17,
+    &SysfsGpioPin18,
+    &SysfsGpioPin19,
+    &SysfsGpioPin20,
+    &SysfsGpioPin21,
+    &SysfsGpioPin22,
+    &SysfsGpioPin23,
+    &SysfsGpioPin24,
+    &SysfsGpioPin25,
+    &SysfsGpioPin26,
+    &SysfsGpioPin27,
+    &SysfsGpioPin28,
+    &SysfsGpioPin29,
+    &SysfsGpioPin30,
+    &SysfsGpioPin31,
+    &SysfsGpioPin32,
+    &SysfsGpioPin33,
+    &SysfsGpioPin34,
+    &SysfsGpioPin35,
+    &SysfsGpioPin36,
+    &SysfsGpioPin37,
+    &SysfsGpioPin38,
+    &SysfsGpioPin39,
+    &SysfsGpioPin40,
+    &SysfsGpioPin41,
+    &SysfsGpioPin42,
+    &SysfsGpioPin43,
+    &SysfsGpioPin44,
+    &SysfsGpioPin45,
+    &SysfsGpioPin46,
+    &SysfsGpioPin47,
+    &SysfsGpioPin48,
+    &SysfsGpioPin49,
+    &SysfsGpioPin50,
+    &SysfsGpioPin51,
+    &SysfsGpioPin52,
+    &SysfsGpioPin53,
+    &SysfsGpioPin54,
+    &SysfsGpioPin55,
+    &SysfsGpioPin56,
+    &SysfsGpioPin57,
+    &SysfsGpioPin58,
+    &SysfsGpioPin59,
+    &SysfsGpioPin60,
+    &SysfsGpioPin61,
+    &SysfsGpioPin62,
+    &SysfsGpioPin63,
+    &SysfsGpioPin64
+};
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that all the pins of a mask are held by the process calling the le_gpioBatch service.
+ *
+ * @return true if the pins can be used by the caller, false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsHeldByClient
+(
+    uint64_t pinMask        ///< [IN] Pins to check
+)
+{
+    uid_t uid;
+    pid_t clientPid;
+    size_t i;
+
+    if (LE_OK != le_msg_GetClientUserCreds(le_gpioBatch_GetClientSessionRef(), &uid, &clientPid))
+    {
+        LE_ERROR("Unable to get the credentials of the client");
+        return false;
+    }
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(GpioRefTable); i++)
+    {
+        if (0 == (pinMask & ((uint64_t)1 << i)))
+        {
+            continue;
+        }
+
+        gpioSysfs_GpioRef_t gpioRef = GpioRefTable[i];
+        pid_t pinPid = 0;
+
+        if ((!gpioRef->inUse) ||
+            (LE_OK != le_msg_GetClientUserCreds(gpioRef->currentSession, &uid, &pinPid)) ||
+            (pinPid != clientPid))
+        {
+            LE_WARN("GPIO %s is not held by client pid %d", gpioRef->gpioName, clientPid);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drive several output pins.
+ *
+ * @return
+ *  - LE_OK            All the selected pins were written.
+ *  - LE_NOT_PERMITTED A selected pin is not held by the caller.
+ *  - LE_IO_ERROR      A pin could not be written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gpioBatch_Write
+(
+    uint64_t pinMask,       ///< [IN] Pins to write (bit n = GPIO pin n + 1).
+    uint64_t valueMask      ///< [IN] States to drive (1 = active, 0 = inactive).
+)
+{
+    if (!IsHeldByClient(pinMask))
+    {
+        return LE_NOT_PERMITTED;
+    }
+
+    return gpioSysfs_WriteValues(GpioRefTable, NUM_ARRAY_MEMBERS(GpioRefTable),
+                                 pinMask, valueMask);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read several pins.
+ *
+ * @return
+ *  - LE_OK            All the selected pins were read.
+ *  - LE_NOT_PERMITTED A selected pin is not held by the caller.
+ *  - LE_IO_ERROR      A pin could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_gpioBatch_Read
+(
+    uint64_t pinMask,       ///< [IN] Pins to read (bit n = GPIO pin n + 1).
+    uint64_t* valueMaskPtr  ///< [OUT] States of the pins (1 = active, 0 = inactive).
+)
+{
+    if (!IsHeldByClient(pinMask))
+    {
+        return LE_NOT_PERMITTED;
+    }
+
+    le_result_t res = gpioSysfs_ReadValues(GpioRefTable, NUM_ARRAY_MEMBERS(GpioRefTable),
+                                           pinMask, valueMaskPtr);
+
+    return (LE_OK == res) ? LE_OK : LE_IO_ERROR;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The place where the component starts up.  All initialization happens here.
@@ -435,6 +435,45 @@ bool gpioSysfs_IsPinAvailable
     int pinNum         ///< [IN] GPIO pin number (starting at 1)
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drive several output pins in one call. Pin gpioRefs[n] is selected by bit n of pinMask, and
+ * its new state is bit n of valueMask (1 = active, 0 = inactive). Pins that are not yet outputs
+ * are configured as outputs first.
+ *
+ * @return
+ * - LE_OK if all the selected pins were written
+ * - LE_BAD_PARAMETER if a selected pin has no GPIO object
+ * - LE_IO_ERROR if a pin could not be written. The pins before it have been written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioSysfs_WriteValues
+(
+    const gpioSysfs_GpioRef_t* gpioRefs, ///< [IN] GPIO object references, one per mask bit
+    size_t count,                        ///< [IN] Number of references (64 at most)
+    uint64_t pinMask,                    ///< [IN] Pins to write
+    uint64_t valueMask                   ///< [IN] States to drive
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read several pins in one call. Pin gpioRefs[n] is selected by bit n of pinMask, and its state
+ * is returned in bit n of the value mask (1 = active, 0 = inactive).
+ *
+ * @return
+ * - LE_OK if all the selected pins were read
+ * - LE_BAD_PARAMETER if a selected pin has no GPIO object
+ * - LE_IO_ERROR if a pin could not be read
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioSysfs_ReadValues
+(
+    const gpioSysfs_GpioRef_t* gpioRefs, ///< [IN] GPIO object references, one per mask bit
+    size_t count,                        ///< [IN] Number of references (64 at most)
+    uint64_t pinMask,                    ///< [IN] Pins to read
+    uint64_t* valueMaskPtr               ///< [OUT] States of the pins read
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The struct of Sysfs object
@@ -449,6 +488,9 @@ struct gpioSysfs_Gpio {
     void *callbackContextPtr;                     ///< Client context to be passed back
     le_fdMonitor_Ref_t fdMonitor;                 ///< fdMonitor Object associated to this GPIO
     le_msg_SessionRef_t currentSession;           ///< Current valid IPC session for this pin
+    int valueFd;                                  ///< The FD of the value file, kept open while
+                                                  ///< the pin is in use (-1 if not open)
+    bool isOutput;                                ///< Is the pin known to be set as an output?
 };
 
 
@@ -16,9 +16,13 @@
 //--------------------------------------------------------------------------------------------------
 /**
  * GPIO signals have paths like /sys/class/gpio/gpio42/ (for GPIO #42)
+ *
+ * Can be overridden at build time, e.g. to run against a fake sysfs directory in unit tests.
  */
 //--------------------------------------------------------------------------------------------------
+#ifndef SYSFS_GPIO_PATH
 #define SYSFS_GPIO_PATH    "/sys/class/gpio"
+#endif
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -249,6 +253,75 @@ static le_result_t ReadSysGpioSignalAttr
     return LE_OK;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the FD of the "value" file of a GPIO, opening it on first use.
+ *
+ * The file stays open until the session using the pin closes, so that reading or writing the
+ * value costs a single pread() or pwrite() instead of an open/write/close sequence.
+ *
+ * @return
+ * - The FD of the value file
+ * - -1 if the file could not be opened
+ */
+//--------------------------------------------------------------------------------------------------
+static int GetValueFd
+(
+    gpioSysfs_GpioRef_t gpioRef               ///< [IN] GPIO object reference
+)
+{
+    char path[64];
+    int fd;
+
+    if (gpioRef->valueFd >= 0)
+    {
+        return gpioRef->valueFd;
+    }
+
+    snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "value");
+
+    do
+    {
+        fd = open(path, O_RDWR | O_CLOEXEC);
+    }
+    while ((fd < 0) && (errno == EINTR));
+
+    if (fd < 0)
+    {
+        LE_ERROR("Error opening file %s. %m", path);
+        return -1;
+    }
+
+    LE_DEBUG("Opened %s as fd %d", path, fd);
+    gpioRef->valueFd = fd;
+
+    return fd;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the "value" file of a GPIO, if it is open.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseValueFd
+(
+    gpioSysfs_GpioRef_t gpioRef               ///< [IN] GPIO object reference
+)
+{
+    if (gpioRef->valueFd < 0)
+    {
+        return;
+    }
+
+    int ret = 0;
+    do
+    {
+        ret = close(gpioRef->valueFd);
+    }
+    while ((ret != 0) && (errno == EINTR));
+    gpioRef->valueFd = -1;
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * write value to GPIO output, low or high
@@ -260,8 +333,9 @@ static le_result_t WriteOutputValue
     gpioSysfs_Value_t level                   ///< [IN] High or low
 )
 {
-    char path[64];
-    char attr[16];
+    const char attr = (level == SYSFS_VALUE_HIGH) ? '1' : '0';
+    ssize_t written;
+    int fd;
 
     if ((!gpioRef) || (gpioRef->pinNum == 0))
     {
@@ -269,11 +343,74 @@ static le_result_t WriteOutputValue
         return LE_BAD_PARAMETER;
     }
 
-    snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "value");
-    snprintf(attr, sizeof(attr), "%d", level);
-    LE_DEBUG("path:%s, attr:%s", path, attr);
+    fd = GetValueFd(gpioRef);
+    if (fd < 0)
+    {
+        return LE_IO_ERROR;
+    }
 
-    return WriteSysGpioSignalAttr(path, attr);
+    do
+    {
+        written = pwrite(fd, &attr, 1, 0);
+    }
+    while ((written < 0) && (errno == EINTR));
+
+    if (written != 1)
+    {
+        LE_ERROR("Failed to write %c to GPIO %s value. %m", attr, gpioRef->gpioName);
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * read value of a GPIO, low or high
+ *
+ * @return
+ * - LE_OK on success
+ * - LE_BAD_PARAMETER if the object is not initialized
+ * - LE_IO_ERROR if the value could not be read
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReadInputValue
+(
+    gpioSysfs_GpioRef_t gpioRef,              ///< [IN] GPIO object reference
+    gpioSysfs_Value_t* levelPtr               ///< [OUT] High or low
+)
+{
+    char buf[1];
+    ssize_t bytesRead;
+    int fd;
+
+    if ((!gpioRef) || (gpioRef->pinNum == 0))
+    {
+        LE_ERROR("gpioRef is NULL or gpio not initialized");
+        return LE_BAD_PARAMETER;
+    }
+
+    fd = GetValueFd(gpioRef);
+    if (fd < 0)
+    {
+        return LE_IO_ERROR;
+    }
+
+    do
+    {
+        bytesRead = pread(fd, buf, sizeof(buf), 0);
+    }
+    while ((bytesRead < 0) && (errno == EINTR));
+
+    if (bytesRead != sizeof(buf))
+    {
+        LE_ERROR("Unable to read value for GPIO %s. %m", gpioRef->gpioName);
+        return LE_IO_ERROR;
+    }
+
+    *levelPtr = (buf[0] == '0') ? SYSFS_VALUE_LOW : SYSFS_VALUE_HIGH;
+
+    return LE_OK;
 }
 
 
@@ -358,7 +495,12 @@ static le_result_t SetDirection
     attr = (mode == SYSFS_PIN_MODE_OUTPUT) ? "out": "in";
     LE_DEBUG("path:%s, attribute:%s", path, attr);
 
-    return WriteSysGpioSignalAttr(path, attr);
+    le_result_t res = WriteSysGpioSignalAttr(path, attr);
+
+    // Remember outputs, so that driving them does not need to set the direction again
+    gpioRef->isOutput = ((LE_OK == res) && (mode == SYSFS_PIN_MODE_OUTPUT));
+
+    return res;
 }
 
 
@@ -674,9 +816,6 @@ gpioSysfs_Value_t gpioSysfs_ReadValue
     gpioSysfs_GpioRef_t gpioRef            ///< [IN] GPIO object reference
 )
 {
-    char path[64];
-    char result[17];
-    le_result_t leResult;
     gpioSysfs_Value_t type;
 
     if ((!gpioRef) || (gpioRef->pinNum == 0))
@@ -685,15 +824,12 @@ gpioSysfs_Value_t gpioSysfs_ReadValue
         return -1;
     }
 
-    snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "value");
-    leResult = ReadSysGpioSignalAttr(path, sizeof(result), result);
-    if (leResult != LE_OK)
+    if (ReadInputValue(gpioRef, &type) != LE_OK)
     {
         return -1;
     }
 
-    type = atoi(result);
-    LE_DEBUG("result:%s Value:%s", result, (type==1) ? "high": "low");
+    LE_DEBUG("Value:%s", (type == SYSFS_VALUE_HIGH) ? "high": "low");
 
     return type;
 }
@@ -711,7 +847,9 @@ le_result_t gpioSysfs_Activate
     gpioSysfs_GpioRef_t gpioRef
 )
 {
-    if (LE_OK != SetDirection(gpioRef, SYSFS_PIN_MODE_OUTPUT))
+    // The direction is only written if the pin is not already known to be an output, so that
+    // toggling an output only costs a write to its value file.
+    if ((!gpioRef->isOutput) && (LE_OK != SetDirection(gpioRef, SYSFS_PIN_MODE_OUTPUT)))
     {
         LE_ERROR("Failed to set Direction on GPIO %s", gpioRef->gpioName);
         return LE_IO_ERROR;
@@ -737,7 +875,9 @@ le_result_t gpioSysfs_Deactivate
     gpioSysfs_GpioRef_t gpioRef
 )
 {
-    if (LE_OK != SetDirection(gpioRef, SYSFS_PIN_MODE_OUTPUT))
+    // The direction is only written if the pin is not already known to be an output, so that
+    // toggling an output only costs a write to its value file.
+    if ((!gpioRef->isOutput) && (LE_OK != SetDirection(gpioRef, SYSFS_PIN_MODE_OUTPUT)))
     {
         LE_ERROR("Failed to set Direction on GPIO %s", gpioRef->gpioName);
         return LE_IO_ERROR;
@@ -796,6 +936,11 @@ bool gpioSysfs_IsInput
         return false;
     }
 
+    if (gpioRef->isOutput)
+    {
+        return false;
+    }
+
     snprintf(path, sizeof(path), "%s/%s/%s", SYSFS_GPIO_PATH, gpioRef->gpioName, "direction");
     leResult = ReadSysGpioSignalAttr(path, sizeof(result), result);
     if (leResult != LE_OK)
@@ -1107,6 +1252,9 @@ void gpioSysfs_SessionOpenHandlerFunc
     // Store the current, valid session ref
     gpioRef->currentSession = sessionRef;
 
+    // The direction may have been changed since the pin was last used
+    gpioRef->isOutput = false;
+
     LE_DEBUG("gpio pin:%d, GPIO Name:%s", gpioRef->pinNum, gpioRef->gpioName);
     return;
 
@@ -1158,6 +1306,9 @@ void gpioSysfs_SessionCloseHandlerFunc
         gpioRef->monitorFd = -1;
     }
 
+    CloseValueFd(gpioRef);
+    gpioRef->isOutput = false;
+
     LE_DEBUG("Removing callback references");
     // If there is a callback registered then forget it
     gpioRef->callbackContextPtr = NULL;
@@ -1234,3 +1385,106 @@ bool gpioSysfs_IsPinAvailable
     return (check & (1 << (bitInMask -1)));
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Drive several output pins in one call. Pin gpioRefs[n] is selected by bit n of pinMask, and
+ * its new state is bit n of valueMask (1 = active, 0 = inactive).
+ *
+ * @return
+ * - LE_OK if all the selected pins were written
+ * - LE_BAD_PARAMETER if a selected pin has no GPIO object
+ * - LE_IO_ERROR if a pin could not be written. The pins before it have been written.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioSysfs_WriteValues
+(
+    const gpioSysfs_GpioRef_t* gpioRefs, ///< [IN] GPIO object references, one per mask bit
+    size_t count,                        ///< [IN] Number of references (64 at most)
+    uint64_t pinMask,                    ///< [IN] Pins to write
+    uint64_t valueMask                   ///< [IN] States to drive
+)
+{
+    size_t i;
+
+    if ((count > 64) || ((count < 64) && ((pinMask >> count) != 0)))
+    {
+        LE_ERROR("Pin mask 0x%" PRIx64 " is out of range", pinMask);
+        return LE_BAD_PARAMETER;
+    }
+
+    for (i = 0; (i < count) && (pinMask != 0); i++, pinMask >>= 1, valueMask >>= 1)
+    {
+        if (0 == (pinMask & 1))
+        {
+            continue;
+        }
+
+        if (NULL == gpioRefs[i])
+        {
+            LE_ERROR("No GPIO object for pin index %zu", i);
+            return LE_BAD_PARAMETER;
+        }
+
+        le_result_t res = (valueMask & 1) ? gpioSysfs_Activate(gpioRefs[i]) :
+                                            gpioSysfs_Deactivate(gpioRefs[i]);
+        if (LE_OK != res)
+        {
+            return LE_IO_ERROR;
+        }
+    }
+
+    return LE_OK;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read several pins in one call. Pin gpioRefs[n] is selected by bit n of pinMask, and its state
+ * is returned in bit n of the value mask (1 = active, 0 = inactive).
+ *
+ * @return
+ * - LE_OK if all the selected pins were read
+ * - LE_BAD_PARAMETER if a selected pin has no GPIO object
+ * - LE_IO_ERROR if a pin could not be read
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t gpioSysfs_ReadValues
+(
+    const gpioSysfs_GpioRef_t* gpioRefs, ///< [IN] GPIO object references, one per mask bit
+    size_t count,                        ///< [IN] Number of references (64 at most)
+    uint64_t pinMask,                    ///< [IN] Pins to read
+    uint64_t* valueMaskPtr               ///< [OUT] States of the pins read
+)
+{
+    uint64_t valueMask = 0;
+    size_t i;
+
+    if ((count > 64) || ((count < 64) && ((pinMask >> count) != 0)))
+    {
+        LE_ERROR("Pin mask 0x%" PRIx64 " is out of range", pinMask);
+        return LE_BAD_PARAMETER;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (0 == (pinMask & ((uint64_t)1 << i)))
+        {
+            continue;
+        }
+
+        gpioSysfs_Value_t level;
+        le_result_t res = ReadInputValue(gpioRefs[i], &level);
+        if (LE_OK != res)
+        {
+            return res;
+        }
+
+        if (SYSFS_VALUE_HIGH == level)
+        {
+            valueMask |= ((uint64_t)1 << i);
+        }
+    }
+
+    *valueMaskPtr = valueMask;
+
+    return LE_OK;
+}
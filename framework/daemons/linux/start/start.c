@@ -77,6 +77,11 @@ static const char AppsUnpackDir[] = "/legato/apps/unpack";
 static const char OldFwDir[] = "/mnt/flash/opt/legato";
 
 static const char LdconfigNotDoneMarkerFile[] = "/legato/systems/needs_ldconfig";
+static const char LdSoConfFile[] = "/etc/ld.so.conf";
+static const char LdSoCacheFile[] = "/etc/ld.so.cache";
+static const char CurrentSystemLibDir[] = "/legato/systems/current/lib";
+static const char SystemLdSoCacheFile[] = "/legato/systems/current/ld.so.cache";
+static const char SystemLdSoCacheStampFile[] = "/legato/systems/current/ld.so.cache.stamp";
 static const char GoldenVersionFile[] = "/mnt/legato/system/version";
 static const char CurrentVersionFile[] = "/legato/systems/current/version";
 static const char BootCountFile[] = "/legato/bootCount";
@@ -664,6 +669,272 @@ static void Rename
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute an FNV-1a hash of a block of data, continuing from a previous hash.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t HashData
+(
+    uint64_t hash,          ///< Previous hash (or FNV offset basis to start a new one).
+    const void* dataPtr,
+    size_t dataSize
+)
+{
+    const uint8_t* bytePtr = dataPtr;
+
+    while (dataSize-- > 0)
+    {
+        hash ^= *bytePtr++;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the stamp identifying everything the dynamic linker's cache is built from: the
+ * root file system's library directories and the current system's libraries.
+ *
+ * The current system's library directory itself is new for each system, so its entries are
+ * identified instead.  As unchanged files of a new system are hard links to the previous system's,
+ * a system update that doesn't change any library ends up with the same stamp as the previous
+ * system, and can reuse its cache.
+ *
+ * @return LE_OK, or LE_FAULT if the stamp could not be computed.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ComputeLdSoCacheStamp
+(
+    char* buffer,       ///< [OUT] Stamp.
+    size_t size         ///< Size of the buffer in bytes.
+)
+{
+    static const char* const rootFsLibDirs[] = { "/lib", "/usr/lib" };
+    size_t len = 0;
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(rootFsLibDirs); i++)
+    {
+        struct stat st;
+
+        if (stat(rootFsLibDirs[i], &st) != 0)
+        {
+            // A missing directory is part of the configuration too.
+            memset(&st, 0, sizeof(st));
+        }
+
+        len += snprintf(buffer + len, size - len, "%s %llx %llx %lld.%09ld\n",
+                        rootFsLibDirs[i],
+                        (unsigned long long)st.st_dev,
+                        (unsigned long long)st.st_ino,
+                        (long long)st.st_mtim.tv_sec,
+                        st.st_mtim.tv_nsec);
+        if (len >= size)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    DIR* dirPtr = opendir(CurrentSystemLibDir);
+    if (dirPtr == NULL)
+    {
+        LE_ERROR("Failed (%m) to open '%s'.", CurrentSystemLibDir);
+        return LE_FAULT;
+    }
+
+    // Entries are combined with a sum, so the order they are read in doesn't matter.
+    uint64_t libHash = 0;
+    size_t libCount = 0;
+    struct dirent* entryPtr;
+
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        struct stat st;
+        char target[PATH_MAX];
+
+        if ((strcmp(entryPtr->d_name, ".") == 0) || (strcmp(entryPtr->d_name, "..") == 0))
+        {
+            continue;
+        }
+
+        if (fstatat(dirfd(dirPtr), entryPtr->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            LE_ERROR("Failed (%m) to stat '%s/%s'.", CurrentSystemLibDir, entryPtr->d_name);
+            closedir(dirPtr);
+            return LE_FAULT;
+        }
+
+        uint64_t entryHash = HashData(0xcbf29ce484222325ULL,
+                                      entryPtr->d_name,
+                                      strlen(entryPtr->d_name) + 1);
+
+        if (S_ISLNK(st.st_mode))
+        {
+            // Symlinks are recreated in each system, so only their targets matter.
+            ssize_t targetLen = readlinkat(dirfd(dirPtr), entryPtr->d_name, target, sizeof(target));
+            if (targetLen < 0)
+            {
+                LE_ERROR("Failed (%m) to read link '%s/%s'.", CurrentSystemLibDir, entryPtr->d_name);
+                closedir(dirPtr);
+                return LE_FAULT;
+            }
+            entryHash = HashData(entryHash, target, targetLen);
+        }
+        else
+        {
+            entryHash = HashData(entryHash, &st.st_dev, sizeof(st.st_dev));
+            entryHash = HashData(entryHash, &st.st_ino, sizeof(st.st_ino));
+            entryHash = HashData(entryHash, &st.st_size, sizeof(st.st_size));
+            entryHash = HashData(entryHash, &st.st_mtim, sizeof(st.st_mtim));
+        }
+
+        libHash += entryHash;
+        libCount++;
+    }
+
+    closedir(dirPtr);
+
+    len += snprintf(buffer + len, size - len, "%s %016llx %zu\n",
+                    CurrentSystemLibDir, (unsigned long long)libHash, libCount);
+
+    return (len < size) ? LE_OK : LE_FAULT;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make the current system's dynamic linker cache the one used by the dynamic linker.
+ *
+ * /etc/ld.so.cache is made a symlink into the current system, so that the cache follows the
+ * current system when it changes.  If /etc/ld.so.cache can't be replaced (e.g., it's bind mounted
+ * because the root file system is read-only), the cache is copied over it instead.
+ *
+ * @return LE_OK if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ActivateSystemLdSoCache
+(
+    void
+)
+{
+    char target[PATH_MAX];
+    ssize_t targetLen = readlink(LdSoCacheFile, target, sizeof(target) - 1);
+
+    if (targetLen > 0)
+    {
+        target[targetLen] = '\0';
+        if (strcmp(target, SystemLdSoCacheFile) == 0)
+        {
+            return LE_OK;
+        }
+    }
+
+    // Swap the symlink in atomically so the dynamic linker never sees a missing cache.
+    char tempLink[PATH_MAX];
+    snprintf(tempLink, sizeof(tempLink), "%s-", LdSoCacheFile);
+    (void)unlink(tempLink);
+
+    if (symlink(SystemLdSoCacheFile, tempLink) == 0)
+    {
+        if (rename(tempLink, LdSoCacheFile) == 0)
+        {
+            return LE_OK;
+        }
+        (void)unlink(tempLink);
+    }
+
+    LE_DEBUG("Can't (%m) link '%s', copying the cache instead.", LdSoCacheFile);
+
+    int inFd = open(SystemLdSoCacheFile, O_RDONLY | O_CLOEXEC);
+    if (inFd < 0)
+    {
+        LE_ERROR("Failed (%m) to open '%s'.", SystemLdSoCacheFile);
+        return LE_FAULT;
+    }
+
+    int outFd = open(LdSoCacheFile, O_WRONLY | O_TRUNC | O_CLOEXEC);
+    if (outFd < 0)
+    {
+        LE_ERROR("Failed (%m) to open '%s' for writing.", LdSoCacheFile);
+        fd_Close(inFd);
+        return LE_FAULT;
+    }
+
+    le_result_t result = LE_OK;
+    char buffer[4096];
+    ssize_t readLen;
+
+    while ((readLen = fd_ReadSize(inFd, buffer, sizeof(buffer))) > 0)
+    {
+        if (fd_WriteSize(outFd, buffer, readLen) != readLen)
+        {
+            readLen = -1;
+            break;
+        }
+    }
+
+    if (readLen < 0)
+    {
+        LE_ERROR("Failed (%m) to copy '%s' to '%s'.", SystemLdSoCacheFile, LdSoCacheFile);
+        result = LE_FAULT;
+    }
+
+    fd_Close(outFd);
+    fd_Close(inFd);
+
+    return result;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the dynamic linker's cache for the current system, and activate it.
+ *
+ * The cache is kept in the system's directory along with a stamp identifying the libraries it was
+ * built from.  If the stamp still matches (the system was rolled back to, or a system update
+ * didn't change any library), the cache is reused without running ldconfig.
+ *
+ * @return LE_OK if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t UpdateSystemLdSoCache
+(
+    bool* rebuiltPtr        ///< [OUT] true if ldconfig had to be run.
+)
+{
+    char stamp[512];
+    char oldStamp[512];
+
+    *rebuiltPtr = false;
+
+    if (ComputeLdSoCacheStamp(stamp, sizeof(stamp)) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    if (   (!FileExists(SystemLdSoCacheFile))
+        || (ReadFromFile(SystemLdSoCacheStampFile, oldStamp, sizeof(oldStamp)) < 0)
+        || (strcmp(stamp, oldStamp) != 0) )
+    {
+        // Remove the stamp first, so an interrupted run is never mistaken for a valid cache.
+        (void)unlink(SystemLdSoCacheStampFile);
+
+        *rebuiltPtr = true;
+
+        if (0 != system("ldconfig -C /legato/systems/current/ld.so.cache > /dev/null"))
+        {
+            return LE_FAULT;
+        }
+
+        if (WriteToFile(SystemLdSoCacheStampFile, stamp, strlen(stamp)) < 0)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    return ActivateSystemLdSoCache();
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * create the ld.so.cache for the new install (or reversion).
@@ -675,6 +946,9 @@ static void UpdateLdSoCache
 )
 {
     const char* text;
+    char oldText[PATH_MAX];
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
     // create marker file to say we are doing ldconfig
     text = "start_ldconfig";
     // If this fails, try to limp along anyway.
@@ -683,11 +957,42 @@ static void UpdateLdSoCache
     text = "/legato/systems/current/lib\n";
     // If this fails, the system probably won't work, but not much we can do but try.
     // TODO: Do this without blowing away anything else that might be in the ld.so.conf.
-    (void)WriteToFile("/etc/ld.so.conf", text, strlen(text));
-    if (0 == system("ldconfig > /dev/null"))
+    // The path never changes, so don't wear out the flash rewriting it every time.
+    if (   (ReadFromFile(LdSoConfFile, oldText, sizeof(oldText)) < 0)
+        || (strcmp(text, oldText) != 0) )
     {
+        (void)WriteToFile(LdSoConfFile, text, strlen(text));
+    }
+
+    bool rebuilt = false;
+    const char* method = "reused";
+
+    if (UpdateSystemLdSoCache(&rebuilt) == LE_OK)
+    {
+        if (rebuilt)
+        {
+            method = "built";
+        }
         unlink(LdconfigNotDoneMarkerFile);
     }
+    else
+    {
+        // The system's directory may be read-only, or ldconfig may not support -C.
+        // Fall back to updating the default cache.
+        LE_WARN("Can't keep a cache for the system, running a full ldconfig.");
+        (void)unlink(SystemLdSoCacheStampFile);
+        method = "full ldconfig";
+
+        if (0 == system("ldconfig > /dev/null"))
+        {
+            unlink(LdconfigNotDoneMarkerFile);
+        }
+    }
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    LE_INFO("Dynamic linker cache updated (%s) in %ld ms.",
+            method,
+            (long)(elapsed.sec * 1000 + elapsed.usec / 1000));
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -39,6 +39,7 @@
 #include "smack.h"
 #include "sysPaths.h"
 #include "fileSystem.h"
+#include "blobStore.h"
 
 
 static const char* InstallHookScriptPath = "/legato/systems/current/bin/install-hook";
@@ -378,6 +379,35 @@ static le_result_t SetPermAppWritableDir
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Share an installed app's files with the other apps and systems that have identical ones.  Must
+ * be done after the files' SMACK labels are set.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ShareAppFiles
+(
+    const char* appMd5Ptr,
+    const char* appNamePtr
+)
+{
+    char appPath[PATH_MAX];
+    LE_ASSERT(snprintf(appPath, sizeof(appPath), "/legato/apps/%s", appMd5Ptr) < sizeof(appPath));
+
+    blobStore_Stats_t stats = { 0 };
+
+    if (blobStore_ShareTree(appPath, NULL, &stats) == LE_OK)
+    {
+        LE_INFO("App '%s' <%s>: %zu files added to the blob store, %zu shared (%lld bytes saved).",
+                appNamePtr,
+                appMd5Ptr,
+                stats.addedCount,
+                stats.sharedCount,
+                (long long)stats.bytesSaved);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Perform an application upgrade.
@@ -403,6 +433,9 @@ static le_result_t PerformAppUpgrade
     // Set smackfs file permission for installed files
     SetSmackPermReadOnlyDir(appMd5Ptr, appNamePtr);
 
+    // Store identical files only once.
+    ShareAppFiles(appMd5Ptr, appNamePtr);
+
     // Update non-writeable files dir symlink to point to the new version of the app
     system_SymlinkApp("current", appMd5Ptr, appNamePtr);
 
@@ -435,6 +468,9 @@ static le_result_t PerformAppInstall
     // Set smackfs file permission for installed files
     SetSmackPermReadOnlyDir(appMd5Ptr, appNamePtr);
 
+    // Store identical files only once.
+    ShareAppFiles(appMd5Ptr, appNamePtr);
+
     // Create a non-writeable files dir symlink pointing to the app's installed files.
     system_SymlinkApp("current", appMd5Ptr, appNamePtr);
 
@@ -530,6 +566,8 @@ static le_result_t PerformAppDelete
         {
             LE_ERROR("Was unable to remove old application path, '%s'.", appPath);
         }
+
+        blobStore_CollectGarbage();
     }
 
     return LE_OK;
@@ -537,7 +575,8 @@ static le_result_t PerformAppDelete
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Setup smack permission for contents in app's read-only directory.
+ * Setup smack permission for contents in app's read-only directory, then share the app's files
+ * with the blob store.
  *
  * @return LE_OK if successful, LE_FAULT if fails.
  *
@@ -549,7 +588,14 @@ le_result_t app_SetSmackPermReadOnly
     const char* appNamePtr  ///< [IN] Name of the application to install.
 )
 {
-    return SetSmackPermReadOnlyDir(appMd5Ptr, appNamePtr);
+    le_result_t result = SetSmackPermReadOnlyDir(appMd5Ptr, appNamePtr);
+
+    if (result == LE_OK)
+    {
+        ShareAppFiles(appMd5Ptr, appNamePtr);
+    }
+
+    return result;
 }
 
 
@@ -59,7 +59,8 @@ void app_PrepUnpackDir
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Setup smack permission for contents in app's read-only directory.
+ * Setup smack permission for contents in app's read-only directory, then share the app's files
+ * with the blob store.
  *
  * @return LE_OK if successful, LE_FAULT if fails.
  *
@@ -0,0 +1,380 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file blobStore.c
+ *
+ * Content-addressed store of the files of installed apps and systems.  See blobStore.h.
+ *
+ * A blob's name is the MD5 hash of its metadata (permissions, owner, group and SMACK label, which
+ * hard links share) followed by its contents.  Before a file is replaced by a link to a blob, the
+ * two are compared byte for byte, so a hash collision can never corrupt an app.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include <fts.h>
+#include <sys/xattr.h>
+
+#include "legato.h"
+#include "limit.h"
+#include "fileDescriptor.h"
+#include "blobStore.h"
+#include "md5.h"
+
+
+/// Directory holding the blobs.
+#define BLOB_STORE_PATH     "/legato/blobs"
+
+/// Name, in the store, of the link used to atomically replace a file by a blob.
+#define BLOB_TEMP_PATH      BLOB_STORE_PATH "/.new"
+
+/// Size of the chunks that files are read in.
+#define CHUNK_BYTES         (16 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read buffers, shared by everything in this module (the update daemon is single-threaded).
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t Chunk[CHUNK_BYTES];
+static uint8_t OtherChunk[CHUNK_BYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the name of the blob for a file.
+ *
+ * @return LE_OK or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ComputeBlobName
+(
+    int fd,                                 ///< [IN] Open file.
+    const struct stat* statPtr,             ///< [IN] The file's status.
+    const char* pathPtr,                    ///< [IN] The file's path.
+    char blobName[LIMIT_MD5_STR_BYTES]      ///< [OUT] Name of the blob.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char label[LIMIT_MAX_SMACK_LABEL_BYTES] = "";
+    char meta[LIMIT_MAX_SMACK_LABEL_BYTES + 64];
+    md5_Ctx_t ctx;
+
+    // Files without a label (or without SMACK at all) just get an empty one.
+    ssize_t labelLen = fgetxattr(fd, "security.SMACK64", label, sizeof(label) - 1);
+    if (labelLen > 0)
+    {
+        label[labelLen] = '\0';
+    }
+
+    int metaLen = snprintf(meta, sizeof(meta), "%o %u %u %s\n",
+                           (unsigned int)statPtr->st_mode,
+                           (unsigned int)statPtr->st_uid,
+                           (unsigned int)statPtr->st_gid,
+                           label);
+    LE_ASSERT(metaLen < sizeof(meta));
+
+    md5_Init(&ctx);
+    md5_Update(&ctx, meta, metaLen);
+
+    ssize_t len;
+    while ((len = fd_ReadSize(fd, Chunk, sizeof(Chunk))) > 0)
+    {
+        md5_Update(&ctx, Chunk, len);
+    }
+
+    if (len < 0)
+    {
+        LE_ERROR("Failed to read '%s'.", pathPtr);
+        return LE_IO_ERROR;
+    }
+
+    md5_Final(&ctx, blobName);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether an open file has exactly the same contents as a blob.
+ *
+ * @return true if they are identical.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSameContent
+(
+    int fd,                     ///< [IN] Open file.
+    const char* blobPathPtr     ///< [IN] Blob to compare it with.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int blobFd = open(blobPathPtr, O_RDONLY | O_CLOEXEC);
+
+    if (blobFd < 0)
+    {
+        return false;
+    }
+
+    bool isSame = (lseek(fd, 0, SEEK_SET) == 0);
+
+    while (isSame)
+    {
+        ssize_t len = fd_ReadSize(fd, Chunk, sizeof(Chunk));
+        ssize_t otherLen = fd_ReadSize(blobFd, OtherChunk, sizeof(OtherChunk));
+
+        if ((len < 0) || (len != otherLen) || (memcmp(Chunk, OtherChunk, len) != 0))
+        {
+            isSame = false;
+        }
+        else if (len == 0)
+        {
+            break;
+        }
+    }
+
+    fd_Close(blobFd);
+
+    return isSame;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Share one file with the store: link it into the store if its blob doesn't exist yet, or replace
+ * it by a link to the blob if it does.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ShareFile
+(
+    const char* pathPtr,            ///< [IN] The file.
+    const struct stat* statPtr,     ///< [IN] The file's status.
+    blobStore_Stats_t* statsPtr     ///< [IN/OUT] Statistics.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char blobName[LIMIT_MD5_STR_BYTES];
+    char blobPath[PATH_MAX];
+    struct stat blobStat;
+
+    int fd = open(pathPtr, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        LE_WARN("Can't open '%s' (%m).", pathPtr);
+        return;
+    }
+
+    if (ComputeBlobName(fd, statPtr, pathPtr, blobName) != LE_OK)
+    {
+        fd_Close(fd);
+        return;
+    }
+
+    LE_ASSERT(snprintf(blobPath, sizeof(blobPath), "%s/%s", BLOB_STORE_PATH, blobName)
+              < sizeof(blobPath));
+
+    if (lstat(blobPath, &blobStat) != 0)
+    {
+        fd_Close(fd);
+
+        // First copy of this file: it becomes the blob.
+        if (link(pathPtr, blobPath) == 0)
+        {
+            statsPtr->addedCount++;
+        }
+        else if ((errno != EXDEV) && (errno != EMLINK))
+        {
+            LE_WARN("Failed to add '%s' to the blob store (%m).", pathPtr);
+        }
+
+        return;
+    }
+
+    // Already the same file (e.g., shared with a snapshot of an earlier system).
+    if ((blobStat.st_ino == statPtr->st_ino) && (blobStat.st_dev == statPtr->st_dev))
+    {
+        fd_Close(fd);
+        return;
+    }
+
+    bool isSame = (blobStat.st_size == statPtr->st_size) && IsSameContent(fd, blobPath);
+
+    fd_Close(fd);
+
+    if (!isSame)
+    {
+        LE_WARN("'%s' has the same hash as blob %s, but different contents.", pathPtr, blobName);
+        return;
+    }
+
+    // Replace the file atomically, so that a power cut never leaves it missing.
+    (void)unlink(BLOB_TEMP_PATH);
+
+    if (link(blobPath, BLOB_TEMP_PATH) != 0)
+    {
+        if ((errno != EXDEV) && (errno != EMLINK))
+        {
+            LE_WARN("Failed to link blob %s (%m).", blobName);
+        }
+        return;
+    }
+
+    if (rename(BLOB_TEMP_PATH, pathPtr) != 0)
+    {
+        LE_WARN("Failed to replace '%s' by blob %s (%m).", pathPtr, blobName);
+        (void)unlink(BLOB_TEMP_PATH);
+        return;
+    }
+
+    statsPtr->sharedCount++;
+
+    // If the file had other links (e.g., to a system snapshot), its data is still in use.
+    if (statPtr->st_nlink == 1)
+    {
+        statsPtr->bytesSaved += statPtr->st_size;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Share the files of a newly installed directory tree with the store.
+ *
+ * Files must already have their final permissions and SMACK labels, because those are shared too.
+ * Failure to share a file is not an error; the file is just left as it is.
+ *
+ * @return LE_OK, or LE_IO_ERROR if the tree could not be walked.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t blobStore_ShareTree
+(
+    const char* dirPathPtr,                 ///< [IN] Root of the tree.
+    file_IsWriteableFunc_t isWriteableFunc, ///< [IN] Files for which this returns true are left
+                                            ///       alone.  NULL if no file is writeable.
+    blobStore_Stats_t* statsPtr             ///< [IN/OUT] Statistics are added to this.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (le_dir_MakePath(BLOB_STORE_PATH, S_IRWXU) != LE_OK)
+    {
+        LE_ERROR("Failed to create '%s'.", BLOB_STORE_PATH);
+        return LE_IO_ERROR;
+    }
+
+    char* pathArrayPtr[] = { (char*)dirPathPtr, NULL };
+    FTS* ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL | FTS_NOCHDIR, NULL);
+
+    if (ftsPtr == NULL)
+    {
+        LE_ERROR("Failed to open '%s' (%m).", dirPathPtr);
+        return LE_IO_ERROR;
+    }
+
+    size_t dirPathLen = strlen(dirPathPtr);
+
+    FTSENT* entPtr;
+    while ((entPtr = fts_read(ftsPtr)) != NULL)
+    {
+        // Only non-empty regular files are worth sharing.
+        if ((entPtr->fts_info != FTS_F) || (entPtr->fts_statp->st_size == 0))
+        {
+            continue;
+        }
+
+        const char* relPathPtr = entPtr->fts_path + dirPathLen;
+        while (*relPathPtr == '/')
+        {
+            relPathPtr++;
+        }
+
+        if ((isWriteableFunc != NULL) && isWriteableFunc(relPathPtr))
+        {
+            continue;
+        }
+
+        ShareFile(entPtr->fts_path, entPtr->fts_statp, statsPtr);
+    }
+
+    fts_close(ftsPtr);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the stored files that are no longer used by any app or system.
+ */
+//--------------------------------------------------------------------------------------------------
+void blobStore_CollectGarbage
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DIR* dirPtr = opendir(BLOB_STORE_PATH);
+
+    if (dirPtr == NULL)
+    {
+        if (errno != ENOENT)
+        {
+            LE_ERROR("Failed to open '%s' (%m).", BLOB_STORE_PATH);
+        }
+        return;
+    }
+
+    size_t blobCount = 0;
+    size_t removedCount = 0;
+    off_t storedBytes = 0;
+    off_t removedBytes = 0;
+    off_t savedBytes = 0;
+
+    struct dirent* entryPtr;
+    while ((entryPtr = readdir(dirPtr)) != NULL)
+    {
+        struct stat st;
+
+        if (fstatat(dirfd(dirPtr), entryPtr->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            continue;
+        }
+
+        if (!S_ISREG(st.st_mode))
+        {
+            continue;
+        }
+
+        // The store's own link is the only one left, or it's a leftover temporary link.
+        if ((st.st_nlink == 1) || (strcmp(entryPtr->d_name, ".new") == 0))
+        {
+            if (unlinkat(dirfd(dirPtr), entryPtr->d_name, 0) != 0)
+            {
+                LE_WARN("Failed to remove blob %s (%m).", entryPtr->d_name);
+            }
+            else
+            {
+                removedCount++;
+                removedBytes += st.st_size;
+            }
+            continue;
+        }
+
+        blobCount++;
+        storedBytes += st.st_size;
+
+        // Every link beyond the store's own and the first user's would have been a copy.
+        savedBytes += (off_t)(st.st_nlink - 2) * st.st_size;
+    }
+
+    closedir(dirPtr);
+
+    LE_INFO("Blob store: removed %zu unused blobs (%lld bytes).  %zu blobs (%lld bytes) in use,"
+            " saving %lld bytes of flash.",
+            removedCount,
+            (long long)removedBytes,
+            blobCount,
+            (long long)storedBytes,
+            (long long)savedBytes);
+}
@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file blobStore.h
+ *
+ * Content-addressed store of the files of installed apps and systems.
+ *
+ * Every read-only file installed under /legato/apps and /legato/systems is hard linked into
+ * /legato/blobs under a name derived from its contents and metadata.  When another app or system
+ * is installed with an identical file, that file is replaced by a hard link to the stored copy, so
+ * the data is only kept in flash once.
+ *
+ * The file system's link count is the reference count: a blob with a single link is only
+ * referenced by the store itself and is deleted by blobStore_CollectGarbage().  Since each app and
+ * system tree keeps its own links, removing or rolling back systems never needs to touch the
+ * store.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_UPDATE_BLOB_STORE_H_INCLUDE_GUARD
+#define LEGATO_UPDATE_BLOB_STORE_H_INCLUDE_GUARD
+
+#include "file.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics gathered while sharing a tree's files with the store.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t addedCount;      ///< Number of files added to the store.
+    size_t sharedCount;     ///< Number of files replaced by a link to an identical stored file.
+    off_t bytesSaved;       ///< Number of bytes of file data freed by sharing.
+}
+blobStore_Stats_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Share the files of a newly installed directory tree with the store.
+ *
+ * Files must already have their final permissions and SMACK labels, because those are shared too.
+ * Failure to share a file is not an error; the file is just left as it is.
+ *
+ * @return LE_OK, or LE_IO_ERROR if the tree could not be walked.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t blobStore_ShareTree
+(
+    const char* dirPathPtr,                 ///< [IN] Root of the tree.
+    file_IsWriteableFunc_t isWriteableFunc, ///< [IN] Files for which this returns true are left
+                                            ///       alone.  NULL if no file is writeable.
+    blobStore_Stats_t* statsPtr             ///< [IN/OUT] Statistics are added to this.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete the stored files that are no longer used by any app or system.
+ */
+//--------------------------------------------------------------------------------------------------
+void blobStore_CollectGarbage
+(
+    void
+);
+
+
+#endif // LEGATO_UPDATE_BLOB_STORE_H_INCLUDE_GUARD
@@ -0,0 +1,1076 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file delta.c
+ *
+ * Application of delta app updates.  See delta.h for a description of the delta format.
+ *
+ * Patches are in the classic bsdiff ("BSDIFF40") format, as produced by the host bsdiff tool that
+ * mkPatch already uses for firmware.  They are applied as a stream: the control, diff and extra
+ * blocks are decompressed incrementally and the new file is written out in chunks, so memory use
+ * doesn't depend on the size of the files being patched.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+
+#include <bzlib.h>
+#include <fts.h>
+
+#include "limit.h"
+#include "fileDescriptor.h"
+#include "file.h"
+#include "properties.h"
+#include "md5.h"
+#include "untar.h"
+#include "delta.h"
+
+
+/// Directory, relative to the root of the app, that holds the delta's control files.
+#define DELTA_DIR           ".delta"
+
+/// Path of the manifest, relative to the root of the app.
+#define MANIFEST_PATH       DELTA_DIR "/manifest"
+
+/// Directory holding the patches, relative to the root of the app.
+#define PATCH_DIR           DELTA_DIR "/patch"
+
+/// Path of the file that a patched file is written to before it replaces the old one.
+#define PATCH_OUTPUT_PATH   DELTA_DIR "/output"
+
+/// Magic number at the start of a bsdiff patch.
+#define BSDIFF_MAGIC        "BSDIFF40"
+
+/// Size of a bsdiff patch header (magic number followed by three 8 byte numbers).
+#define BSDIFF_HEADER_BYTES 32
+
+/// Size of the chunks that data is processed in.
+#define CHUNK_BYTES         (64 * 1024)
+
+/// Path, in "find" format, of the app's info.properties file, which isn't part of its hash.
+#define INFO_PROPERTIES_PATH    "./info.properties"
+
+/// md5sum line of xargs running md5sum on its empty standard input, when there are no files.
+#define NO_FILES_MD5SUM_LINE    "d41d8cd98f00b204e9800998ecf8427e  -\n"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An entry found while walking an app's directory tree to compute its hash.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char* pathPtr;      ///< Path relative to the root, in "find" format (".", "./bin", ...).
+    mode_t type;        ///< File type bits (S_IFMT) of the mode.
+}
+TreeEntry_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Chunk buffers, shared by everything in this module (the update daemon is single-threaded).
+ */
+//--------------------------------------------------------------------------------------------------
+static uint8_t Chunk[CHUNK_BYTES];
+static uint8_t OldChunk[CHUNK_BYTES];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Snapshot classifier that lets every file of the base app be hard linked.
+ *
+ * @return false.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsBaseFileWriteable
+(
+    const char* relPathPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that a path from the manifest stays inside the app.
+ *
+ * @return true if the path is relative and has no ".." components.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSafePath
+(
+    const char* pathPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((pathPtr[0] == '\0') || (pathPtr[0] == '/'))
+    {
+        return false;
+    }
+
+    const char* componentPtr = pathPtr;
+
+    while (componentPtr != NULL)
+    {
+        if ((strncmp(componentPtr, "..", 2) == 0)
+            && ((componentPtr[2] == '/') || (componentPtr[2] == '\0')))
+        {
+            return false;
+        }
+
+        componentPtr = strchr(componentPtr, '/');
+
+        if (componentPtr != NULL)
+        {
+            componentPtr++;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Decode a signed 64-bit number from a bsdiff patch (little-endian magnitude with a sign bit).
+ *
+ * @return The number.
+ */
+//--------------------------------------------------------------------------------------------------
+static off_t DecodeOffset
+(
+    const uint8_t* bufPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    off_t value = bufPtr[7] & 0x7f;
+    int i;
+
+    for (i = 6; i >= 0; i--)
+    {
+        value = (value * 256) + bufPtr[i];
+    }
+
+    return (bufPtr[7] & 0x80) ? -value : value;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Open one of the compressed blocks of a bsdiff patch for reading.
+ *
+ * @return The bzip2 stream, or NULL on failure (in which case *filePtrPtr is closed).
+ */
+//--------------------------------------------------------------------------------------------------
+static BZFILE* OpenPatchBlock
+(
+    const char* patchPathPtr,
+    off_t offset,
+    FILE** filePtrPtr       ///< [OUT] Underlying stdio file, to be closed after the stream.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int bzError;
+
+    *filePtrPtr = fopen(patchPathPtr, "re");
+
+    if (*filePtrPtr == NULL)
+    {
+        LE_ERROR("Failed to open patch '%s' (%m).", patchPathPtr);
+        return NULL;
+    }
+
+    if (fseeko(*filePtrPtr, offset, SEEK_SET) != 0)
+    {
+        LE_ERROR("Failed to seek in patch '%s' (%m).", patchPathPtr);
+        fclose(*filePtrPtr);
+        return NULL;
+    }
+
+    BZFILE* bzPtr = BZ2_bzReadOpen(&bzError, *filePtrPtr, 0, 0, NULL, 0);
+
+    if (bzError != BZ_OK)
+    {
+        LE_ERROR("Failed to start decompressing patch '%s' (%d).", patchPathPtr, bzError);
+        fclose(*filePtrPtr);
+        return NULL;
+    }
+
+    return bzPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Read exactly a given number of bytes from a compressed patch block.
+ *
+ * @return true if successful, false if the block is truncated or corrupt.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ReadPatchBlock
+(
+    BZFILE* bzPtr,
+    void* bufPtr,
+    size_t len
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int bzError;
+    int readLen = BZ2_bzRead(&bzError, bzPtr, bufPtr, len);
+
+    return ((bzError == BZ_OK) || (bzError == BZ_STREAM_END)) && (readLen == (int)len);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write all of a buffer to a file.
+ *
+ * @return true if successful.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool WriteAll
+(
+    int fd,
+    const void* bufPtr,
+    size_t len
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const uint8_t* bytePtr = bufPtr;
+
+    while (len > 0)
+    {
+        ssize_t written = write(fd, bytePtr, len);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return false;
+        }
+
+        bytePtr += written;
+        len -= written;
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Produce a new file from an old one and a bsdiff patch.
+ *
+ * The old file is read with pread() as the patch asks for its bytes, and the new file is written
+ * sequentially.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR (bad patch) or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ApplyPatch
+(
+    int oldFd,                  ///< [IN] Old file.
+    off_t oldSize,              ///< [IN] Size of the old file.
+    const char* patchPathPtr,   ///< [IN] Patch file.
+    int newFd                   ///< [IN] New file, empty.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint8_t header[BSDIFF_HEADER_BYTES];
+    struct stat patchStat;
+    le_result_t result = LE_FORMAT_ERROR;
+
+    int patchFd = open(patchPathPtr, O_RDONLY | O_CLOEXEC);
+
+    if (patchFd < 0)
+    {
+        LE_ERROR("Failed to open patch '%s' (%m).", patchPathPtr);
+        return LE_IO_ERROR;
+    }
+
+    if (   (fstat(patchFd, &patchStat) != 0)
+        || (fd_ReadSize(patchFd, header, sizeof(header)) != sizeof(header)))
+    {
+        LE_ERROR("Failed to read patch '%s' header.", patchPathPtr);
+        fd_Close(patchFd);
+        return LE_FORMAT_ERROR;
+    }
+
+    fd_Close(patchFd);
+
+    off_t ctrlLen = DecodeOffset(header + 8);
+    off_t diffLen = DecodeOffset(header + 16);
+    off_t newSize = DecodeOffset(header + 24);
+
+    if (   (memcmp(header, BSDIFF_MAGIC, sizeof(BSDIFF_MAGIC) - 1) != 0)
+        || (ctrlLen < 0)
+        || (diffLen < 0)
+        || (newSize < 0)
+        || (BSDIFF_HEADER_BYTES + ctrlLen + diffLen > patchStat.st_size))
+    {
+        LE_ERROR("Patch '%s' has a bad header.", patchPathPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    FILE* ctrlFilePtr;
+    FILE* diffFilePtr;
+    FILE* extraFilePtr;
+    BZFILE* ctrlPtr = OpenPatchBlock(patchPathPtr, BSDIFF_HEADER_BYTES, &ctrlFilePtr);
+    BZFILE* diffPtr = OpenPatchBlock(patchPathPtr, BSDIFF_HEADER_BYTES + ctrlLen, &diffFilePtr);
+    BZFILE* extraPtr = OpenPatchBlock(patchPathPtr,
+                                      BSDIFF_HEADER_BYTES + ctrlLen + diffLen,
+                                      &extraFilePtr);
+
+    if ((ctrlPtr == NULL) || (diffPtr == NULL) || (extraPtr == NULL))
+    {
+        goto cleanup;
+    }
+
+    off_t oldPos = 0;
+    off_t newPos = 0;
+
+    while (newPos < newSize)
+    {
+        uint8_t ctrlBuf[24];
+
+        if (!ReadPatchBlock(ctrlPtr, ctrlBuf, sizeof(ctrlBuf)))
+        {
+            LE_ERROR("Patch '%s' control block is corrupt.", patchPathPtr);
+            goto cleanup;
+        }
+
+        off_t diffCount = DecodeOffset(ctrlBuf);
+        off_t extraCount = DecodeOffset(ctrlBuf + 8);
+        off_t seek = DecodeOffset(ctrlBuf + 16);
+
+        if (   (diffCount < 0)
+            || (extraCount < 0)
+            || (diffCount > newSize - newPos)
+            || (extraCount > newSize - newPos - diffCount))
+        {
+            LE_ERROR("Patch '%s' control block is corrupt.", patchPathPtr);
+            goto cleanup;
+        }
+
+        // Diff bytes are added to the old file's bytes at the same position (where there are any).
+        while (diffCount > 0)
+        {
+            size_t len = (diffCount > CHUNK_BYTES) ? CHUNK_BYTES : diffCount;
+
+            if (!ReadPatchBlock(diffPtr, Chunk, len))
+            {
+                LE_ERROR("Patch '%s' diff block is corrupt.", patchPathPtr);
+                goto cleanup;
+            }
+
+            // Work out which part of this chunk overlaps the old file.
+            off_t overlapStart = (oldPos < 0) ? -oldPos : 0;
+            off_t overlapEnd = oldSize - oldPos;
+
+            if (overlapEnd > (off_t)len)
+            {
+                overlapEnd = len;
+            }
+
+            if (overlapStart < overlapEnd)
+            {
+                size_t overlapLen = overlapEnd - overlapStart;
+
+                if (pread(oldFd, OldChunk, overlapLen, oldPos + overlapStart) != (ssize_t)overlapLen)
+                {
+                    LE_ERROR("Failed to read old file (%m).");
+                    result = LE_IO_ERROR;
+                    goto cleanup;
+                }
+
+                size_t i;
+                for (i = 0; i < overlapLen; i++)
+                {
+                    Chunk[overlapStart + i] += OldChunk[i];
+                }
+            }
+
+            if (!WriteAll(newFd, Chunk, len))
+            {
+                LE_ERROR("Failed to write patched file (%m).");
+                result = LE_IO_ERROR;
+                goto cleanup;
+            }
+
+            oldPos += len;
+            newPos += len;
+            diffCount -= len;
+        }
+
+        // Extra bytes are copied straight into the new file.
+        while (extraCount > 0)
+        {
+            size_t len = (extraCount > CHUNK_BYTES) ? CHUNK_BYTES : extraCount;
+
+            if (!ReadPatchBlock(extraPtr, Chunk, len))
+            {
+                LE_ERROR("Patch '%s' extra block is corrupt.", patchPathPtr);
+                goto cleanup;
+            }
+
+            if (!WriteAll(newFd, Chunk, len))
+            {
+                LE_ERROR("Failed to write patched file (%m).");
+                result = LE_IO_ERROR;
+                goto cleanup;
+            }
+
+            newPos += len;
+            extraCount -= len;
+        }
+
+        oldPos += seek;
+    }
+
+    result = LE_OK;
+
+cleanup:
+
+    {
+        int bzError;
+
+        if (ctrlPtr != NULL)
+        {
+            BZ2_bzReadClose(&bzError, ctrlPtr);
+            fclose(ctrlFilePtr);
+        }
+        if (diffPtr != NULL)
+        {
+            BZ2_bzReadClose(&bzError, diffPtr);
+            fclose(diffFilePtr);
+        }
+        if (extraPtr != NULL)
+        {
+            BZ2_bzReadClose(&bzError, extraPtr);
+            fclose(extraFilePtr);
+        }
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Patch one file of the app.  The patched file is written next to the old one and then renamed
+ * over it, so the old file (which is probably hard linked to the installed base app) is never
+ * modified.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t PatchFile
+(
+    const char* dirPathPtr,     ///< [IN] Root of the app.
+    const char* relPathPtr      ///< [IN] Path of the file to patch, relative to the root.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char oldPath[PATH_MAX] = "";
+    char patchPath[PATH_MAX] = "";
+    char outputPath[PATH_MAX] = "";
+
+    if (   (le_path_Concat("/", oldPath, sizeof(oldPath), dirPathPtr, relPathPtr, NULL) != LE_OK)
+        || (le_path_Concat("/", patchPath, sizeof(patchPath),
+                           dirPathPtr, PATCH_DIR, relPathPtr, NULL) != LE_OK)
+        || (le_path_Concat("/", outputPath, sizeof(outputPath),
+                           dirPathPtr, PATCH_OUTPUT_PATH, NULL) != LE_OK))
+    {
+        LE_ERROR("Path '%s' too long.", relPathPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    // The base app or the delta may have symlinked directories that lead outside the app.
+    le_result_t result = untar_CheckParentDirs(dirPathPtr, oldPath, false);
+
+    if (result == LE_OK)
+    {
+        result = untar_CheckParentDirs(dirPathPtr, patchPath, false);
+    }
+
+    if (result == LE_OK)
+    {
+        result = untar_CheckParentDirs(dirPathPtr, outputPath, false);
+    }
+
+    if (result != LE_OK)
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    int oldFd = open(oldPath, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+
+    if (oldFd < 0)
+    {
+        LE_ERROR("Can't open '%s' to patch it (%m).", oldPath);
+        return LE_FORMAT_ERROR;
+    }
+
+    struct stat oldStat;
+
+    if ((fstat(oldFd, &oldStat) != 0) || !S_ISREG(oldStat.st_mode))
+    {
+        LE_ERROR("'%s' is not a regular file.", oldPath);
+        fd_Close(oldFd);
+        return LE_FORMAT_ERROR;
+    }
+
+    int newFd = open(outputPath,
+                     O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC,
+                     S_IRUSR | S_IWUSR);
+
+    if (newFd < 0)
+    {
+        LE_ERROR("Failed to create '%s' (%m).", outputPath);
+        fd_Close(oldFd);
+        return LE_IO_ERROR;
+    }
+
+    result = ApplyPatch(oldFd, oldStat.st_size, patchPath, newFd);
+
+    fd_Close(oldFd);
+
+    // The patched file keeps the old file's permissions.
+    if ((result == LE_OK) && (fchmod(newFd, oldStat.st_mode & 07777) != 0))
+    {
+        LE_ERROR("Failed to set permissions of '%s' (%m).", outputPath);
+        result = LE_IO_ERROR;
+    }
+
+    fd_Close(newFd);
+
+    if ((result == LE_OK) && (rename(outputPath, oldPath) != 0))
+    {
+        LE_ERROR("Failed to rename '%s' to '%s' (%m).", outputPath, oldPath);
+        result = LE_IO_ERROR;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Follow the instructions in a delta's manifest.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ProcessManifest
+(
+    const char* dirPathPtr      ///< [IN] Root of the app.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char manifestPath[PATH_MAX] = "";
+
+    if (le_path_Concat("/", manifestPath, sizeof(manifestPath),
+                       dirPathPtr, MANIFEST_PATH, NULL) != LE_OK)
+    {
+        LE_ERROR("Path '%s' too long.", dirPathPtr);
+        return LE_IO_ERROR;
+    }
+
+    FILE* filePtr = fopen(manifestPath, "re");
+
+    if (filePtr == NULL)
+    {
+        LE_ERROR("Delta has no manifest (%m).");
+        return LE_FORMAT_ERROR;
+    }
+
+    le_result_t result = LE_OK;
+    size_t removeCount = 0;
+    size_t patchCount = 0;
+    char line[LIMIT_MAX_PATH_BYTES + 16];
+
+    while ((result == LE_OK) && (fgets(line, sizeof(line), filePtr) != NULL))
+    {
+        size_t len = strlen(line);
+
+        if ((len == 0) || (line[len - 1] != '\n'))
+        {
+            LE_ERROR("Delta manifest line too long or truncated.");
+            result = LE_FORMAT_ERROR;
+            break;
+        }
+
+        line[len - 1] = '\0';
+
+        char* argPtr = strchr(line, ' ');
+
+        if ((argPtr == NULL) || !IsSafePath(argPtr + 1))
+        {
+            LE_ERROR("Bad delta manifest line '%s'.", line);
+            result = LE_FORMAT_ERROR;
+            break;
+        }
+
+        *argPtr++ = '\0';
+
+        if (strcmp(line, "remove") == 0)
+        {
+            char path[PATH_MAX] = "";
+
+            if (le_path_Concat("/", path, sizeof(path), dirPathPtr, argPtr, NULL) != LE_OK)
+            {
+                LE_ERROR("Path '%s' too long.", argPtr);
+                result = LE_FORMAT_ERROR;
+            }
+            // A symlinked directory in the base app would make this remove outside the app.
+            else if (untar_CheckParentDirs(dirPathPtr, path, false) != LE_OK)
+            {
+                result = LE_FORMAT_ERROR;
+            }
+            else if (le_dir_RemoveRecursive(path) != LE_OK)
+            {
+                result = LE_IO_ERROR;
+            }
+
+            removeCount++;
+        }
+        else if (strcmp(line, "patch") == 0)
+        {
+            result = PatchFile(dirPathPtr, argPtr);
+
+            patchCount++;
+        }
+        else
+        {
+            LE_ERROR("Unknown delta manifest instruction '%s'.", line);
+            result = LE_FORMAT_ERROR;
+        }
+    }
+
+    fclose(filePtr);
+
+    if (result == LE_OK)
+    {
+        LE_INFO("Delta applied: %zu files patched, %zu removed.", patchCount, removeCount);
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sort order for tree entries, which is byte-wise like "LC_ALL=C sort".
+ */
+//--------------------------------------------------------------------------------------------------
+static int CompareTreeEntries
+(
+    const void* aPtr,
+    const void* bPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return strcmp(((const TreeEntry_t*)aPtr)->pathPtr, ((const TreeEntry_t*)bPtr)->pathPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the "md5sum" output line for a regular file to a hash.
+ *
+ * @return LE_OK or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t HashMd5sumLine
+(
+    md5_Ctx_t* ctxPtr,          ///< [IN/OUT] Hash to add to.
+    const char* fullPathPtr,    ///< [IN] Path of the file.
+    const char* relPathPtr      ///< [IN] Path of the file as md5sum would print it.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    int fd = open(fullPathPtr, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+    {
+        LE_ERROR("Failed to open '%s' (%m).", fullPathPtr);
+        return LE_IO_ERROR;
+    }
+
+    md5_Ctx_t fileCtx;
+    ssize_t len;
+
+    md5_Init(&fileCtx);
+
+    while ((len = fd_ReadSize(fd, Chunk, sizeof(Chunk))) > 0)
+    {
+        md5_Update(&fileCtx, Chunk, len);
+    }
+
+    fd_Close(fd);
+
+    if (len < 0)
+    {
+        LE_ERROR("Failed to read '%s'.", fullPathPtr);
+        return LE_IO_ERROR;
+    }
+
+    char fileMd5[LIMIT_MD5_STR_BYTES];
+    md5_Final(&fileCtx, fileMd5);
+
+    // md5sum escapes names containing backslashes or newlines, and flags the line with a leading
+    // backslash.
+    bool needsEscape = (strpbrk(relPathPtr, "\\\n") != NULL);
+
+    if (needsEscape)
+    {
+        md5_Update(ctxPtr, "\\", 1);
+    }
+
+    md5_Update(ctxPtr, fileMd5, strlen(fileMd5));
+    md5_Update(ctxPtr, "  ", 2);
+
+    if (needsEscape)
+    {
+        const char* charPtr;
+
+        for (charPtr = relPathPtr; *charPtr != '\0'; charPtr++)
+        {
+            if (*charPtr == '\\')
+            {
+                md5_Update(ctxPtr, "\\\\", 2);
+            }
+            else if (*charPtr == '\n')
+            {
+                md5_Update(ctxPtr, "\\n", 2);
+            }
+            else
+            {
+                md5_Update(ctxPtr, charPtr, 1);
+            }
+        }
+    }
+    else
+    {
+        md5_Update(ctxPtr, relPathPtr, strlen(relPathPtr));
+    }
+
+    md5_Update(ctxPtr, "\n", 1);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill an empty unpack directory with the contents of an installed app, so that a delta can be
+ * extracted on top of it.  Files are hard linked to the installed app's where possible; the delta
+ * only ever replaces files, it never modifies them in place.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if the base app is not installed.
+ *      - LE_FORMAT_ERROR if the base app is not the app being updated.
+ *      - LE_FAULT if the snapshot failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t delta_PrepBase
+(
+    const char* appNamePtr,     ///< [IN] Name of the app being updated.
+    const char* baseMd5Ptr,     ///< [IN] MD5 hash of the installed app the delta applies to.
+    const char* dirPathPtr      ///< [IN] Empty directory to fill.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char appPath[PATH_MAX] = "";
+    char basePath[PATH_MAX] = "";
+
+    LE_ASSERT(snprintf(appPath, sizeof(appPath), "/legato/apps/%s", baseMd5Ptr) < sizeof(appPath));
+
+    // The app may be a symlink to a read-only preloaded copy, so snapshot wherever it really is.
+    if (realpath(appPath, basePath) == NULL)
+    {
+        LE_ERROR("Delta base app <%s> is not installed (%m).", baseMd5Ptr);
+        return LE_NOT_FOUND;
+    }
+
+    // A delta made from another app would turn one app into the other.
+    char propertiesPath[PATH_MAX] = "";
+    char baseName[LIMIT_MAX_APP_NAME_BYTES] = "";
+
+    if (   (le_path_Concat("/", propertiesPath, sizeof(propertiesPath),
+                           basePath, "info.properties", NULL) != LE_OK)
+        || (properties_GetValueForKey(propertiesPath, "app.name",
+                                      baseName, sizeof(baseName)) != LE_OK))
+    {
+        LE_ERROR("Failed to get the name of delta base app <%s>.", baseMd5Ptr);
+        return LE_FAULT;
+    }
+
+    if (strcmp(baseName, appNamePtr) != 0)
+    {
+        LE_ERROR("Delta base app <%s> is '%s', not '%s'.", baseMd5Ptr, baseName, appNamePtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    file_SnapshotStats_t stats = { 0 };
+
+    if (file_SnapshotRecursive(basePath, dirPathPtr, IsBaseFileWriteable, &stats) != LE_OK)
+    {
+        LE_ERROR("Failed to snapshot delta base app <%s>.", baseMd5Ptr);
+        return LE_FAULT;
+    }
+
+    LE_INFO("Delta base <%s>: %zu files linked, %zu copied (%lld bytes written).",
+            baseMd5Ptr,
+            stats.linkCount,
+            stats.cloneCount + stats.copyCount,
+            (long long)stats.bytesWritten);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish applying a delta whose tarball has been extracted into an unpack directory prepared by
+ * delta_PrepBase(), then check the result.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FORMAT_ERROR if the delta is malformed or the result doesn't have the expected hash.
+ *      - LE_IO_ERROR if a file system operation failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t delta_Apply
+(
+    const char* dirPathPtr,     ///< [IN] Unpack directory.
+    const char* md5Ptr          ///< [IN] Expected MD5 hash of the new app.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ProcessManifest(dirPathPtr);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    char deltaPath[PATH_MAX] = "";
+
+    if (   (le_path_Concat("/", deltaPath, sizeof(deltaPath), dirPathPtr, DELTA_DIR, NULL) != LE_OK)
+        || (le_dir_RemoveRecursive(deltaPath) != LE_OK))
+    {
+        LE_ERROR("Failed to remove '%s'.", deltaPath);
+        return LE_IO_ERROR;
+    }
+
+    char md5[LIMIT_MD5_STR_BYTES];
+
+    result = delta_ComputeAppMd5(dirPathPtr, md5);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if (strcmp(md5, md5Ptr) != 0)
+    {
+        LE_ERROR("Delta result has MD5 %s, expected %s.", md5, md5Ptr);
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the MD5 hash of an app's files the same way the build tools do (see the
+ * MakeAppInfoProperties build rule and "mk app-md5"): the hash of the sorted list of all paths,
+ * followed by the md5sum lines of all regular files, followed by the targets of all symlinks.
+ *
+ * The build tools hash the staging area before they write info.properties into it, so that file
+ * is left out.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_IO_ERROR if the directory tree could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t delta_ComputeAppMd5
+(
+    const char* dirPathPtr,             ///< [IN] Root of the app's files.
+    char md5Str[LIMIT_MD5_STR_BYTES]    ///< [OUT] Hash, as a hexadecimal string.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+    TreeEntry_t* entriesPtr = NULL;
+    size_t entryCount = 0;
+    size_t entryCapacity = 0;
+    size_t i;
+
+    // Trailing slashes would end up in the entries' paths.
+    char rootPath[PATH_MAX];
+    size_t dirPathLen = strlen(dirPathPtr);
+
+    if (dirPathLen >= sizeof(rootPath))
+    {
+        LE_ERROR("Path '%s' too long.", dirPathPtr);
+        return LE_IO_ERROR;
+    }
+
+    memcpy(rootPath, dirPathPtr, dirPathLen + 1);
+
+    while ((dirPathLen > 1) && (rootPath[dirPathLen - 1] == '/'))
+    {
+        rootPath[--dirPathLen] = '\0';
+    }
+
+    // Gather every path in the tree.  The order has to be that of the whole path, not fts's
+    // directory by directory order, so they are sorted afterwards.
+    char* pathArrayPtr[] = { rootPath, NULL };
+    FTS* ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL | FTS_NOCHDIR, NULL);
+
+    if (ftsPtr == NULL)
+    {
+        LE_ERROR("Failed to open '%s' (%m).", dirPathPtr);
+        return LE_IO_ERROR;
+    }
+
+    FTSENT* entPtr;
+    while ((entPtr = fts_read(ftsPtr)) != NULL)
+    {
+        if (entPtr->fts_info == FTS_DP)
+        {
+            continue;
+        }
+
+        if (   (entPtr->fts_info == FTS_DNR)
+            || (entPtr->fts_info == FTS_ERR)
+            || (entPtr->fts_info == FTS_NS))
+        {
+            LE_ERROR("Failed to read '%s' (%s).", entPtr->fts_path, strerror(entPtr->fts_errno));
+            result = LE_IO_ERROR;
+            break;
+        }
+
+        // mkapp deletes info.properties ("rm -f") before hashing the staging area.
+        if (   (entPtr->fts_info != FTS_D)
+            && (strcmp(entPtr->fts_path + dirPathLen, INFO_PROPERTIES_PATH + 1) == 0))
+        {
+            continue;
+        }
+
+        if (entryCount == entryCapacity)
+        {
+            entryCapacity = (entryCapacity == 0) ? 64 : entryCapacity * 2;
+            entriesPtr = realloc(entriesPtr, entryCapacity * sizeof(TreeEntry_t));
+            LE_ASSERT(entriesPtr != NULL);
+        }
+
+        // Paths look like find's: "." for the root, "./bin/foo" for everything else.
+        LE_ASSERT(asprintf(&entriesPtr[entryCount].pathPtr,
+                           ".%s",
+                           entPtr->fts_path + dirPathLen) >= 0);
+        entriesPtr[entryCount].type = entPtr->fts_statp->st_mode & S_IFMT;
+        entryCount++;
+    }
+
+    fts_close(ftsPtr);
+
+    if (result == LE_OK)
+    {
+        md5_Ctx_t ctx;
+
+        qsort(entriesPtr, entryCount, sizeof(TreeEntry_t), CompareTreeEntries);
+
+        md5_Init(&ctx);
+
+        // find -P -print0
+        for (i = 0; i < entryCount; i++)
+        {
+            md5_Update(&ctx, entriesPtr[i].pathPtr, strlen(entriesPtr[i].pathPtr) + 1);
+        }
+
+        // find -P -type f -print0 | xargs -0 md5sum
+        bool hasFiles = false;
+
+        for (i = 0; (i < entryCount) && (result == LE_OK); i++)
+        {
+            if (entriesPtr[i].type == S_IFREG)
+            {
+                hasFiles = true;
+
+                char path[PATH_MAX] = "";
+
+                if (le_path_Concat("/", path, sizeof(path),
+                                   rootPath, entriesPtr[i].pathPtr + 1, NULL) != LE_OK)
+                {
+                    LE_ERROR("Path '%s' too long.", entriesPtr[i].pathPtr);
+                    result = LE_IO_ERROR;
+                }
+                else
+                {
+                    result = HashMd5sumLine(&ctx, path, entriesPtr[i].pathPtr);
+                }
+            }
+        }
+
+        // Without any file, xargs runs md5sum without arguments, which hashes its standard input.
+        if (!hasFiles)
+        {
+            md5_Update(&ctx, NO_FILES_MD5SUM_LINE, strlen(NO_FILES_MD5SUM_LINE));
+        }
+
+        // find -P -type l -print0 | xargs -0 -r -n 1 readlink
+        for (i = 0; (i < entryCount) && (result == LE_OK); i++)
+        {
+            if (entriesPtr[i].type == S_IFLNK)
+            {
+                char path[PATH_MAX] = "";
+                char target[PATH_MAX];
+                ssize_t len = -1;
+
+                if (le_path_Concat("/", path, sizeof(path),
+                                   rootPath, entriesPtr[i].pathPtr + 1, NULL) == LE_OK)
+                {
+                    len = readlink(path, target, sizeof(target));
+                }
+
+                if ((len < 0) || (len >= (ssize_t)sizeof(target)))
+                {
+                    LE_ERROR("Failed to read symlink '%s'.", entriesPtr[i].pathPtr);
+                    result = LE_IO_ERROR;
+                }
+                else
+                {
+                    target[len] = '\n';
+                    md5_Update(&ctx, target, len + 1);
+                }
+            }
+        }
+
+        if (result == LE_OK)
+        {
+            md5_Final(&ctx, md5Str);
+        }
+    }
+
+    for (i = 0; i < entryCount; i++)
+    {
+        free(entriesPtr[i].pathPtr);
+    }
+    free(entriesPtr);
+
+    return result;
+}
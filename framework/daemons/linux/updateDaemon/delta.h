@@ -0,0 +1,90 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file delta.h
+ *
+ * Application of delta app updates.
+ *
+ * A delta app update's payload is a bzip2 compressed tarball, like a full app update's, but it
+ * only contains what changed since a given version of the app (the "base", identified by its MD5
+ * hash).  The new version of the app is built by snapshotting the installed base into the unpack
+ * directory, extracting the delta tarball on top of it, and then following the instructions in
+ * the tarball's ".delta/manifest" file:
+ *
+ * @verbatim
+remove <path>   Remove the file, symlink or directory at <path>.
+patch <path>    Apply the bsdiff patch found at ".delta/patch/<path>" to the file at <path>.
+@endverbatim
+ *
+ * Paths are relative to the root of the app.  Once the ".delta" directory has been removed, the
+ * result must have the MD5 hash the update pack says the new app has, computed the same way the
+ * build tools compute it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_UPDATE_DELTA_H_INCLUDE_GUARD
+#define LEGATO_UPDATE_DELTA_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Fill an empty unpack directory with the contents of an installed app, so that a delta can be
+ * extracted on top of it.  Files are hard linked to the installed app's where possible; the delta
+ * only ever replaces files, it never modifies them in place.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_NOT_FOUND if the base app is not installed.
+ *      - LE_FORMAT_ERROR if the base app is not the app being updated.
+ *      - LE_FAULT if the snapshot failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t delta_PrepBase
+(
+    const char* appNamePtr,     ///< [IN] Name of the app being updated.
+    const char* baseMd5Ptr,     ///< [IN] MD5 hash of the installed app the delta applies to.
+    const char* dirPathPtr      ///< [IN] Empty directory to fill.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish applying a delta whose tarball has been extracted into an unpack directory prepared by
+ * delta_PrepBase(), then check the result.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FORMAT_ERROR if the delta is malformed or the result doesn't have the expected hash.
+ *      - LE_IO_ERROR if a file system operation failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t delta_Apply
+(
+    const char* dirPathPtr,     ///< [IN] Unpack directory.
+    const char* md5Ptr          ///< [IN] Expected MD5 hash of the new app.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the MD5 hash of an app's files the same way the build tools do (see the
+ * MakeAppInfoProperties build rule and "mk app-md5"): the hash of the sorted list of all paths,
+ * followed by the md5sum lines of all regular files, followed by the targets of all symlinks.
+ *
+ * The build tools hash the staging area before they write info.properties into it, so that file
+ * is left out.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_IO_ERROR if the directory tree could not be read.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t delta_ComputeAppMd5
+(
+    const char* dirPathPtr,             ///< [IN] Root of the app's files.
+    char md5Str[LIMIT_MD5_STR_BYTES]    ///< [OUT] Hash, as a hexadecimal string.
+);
+
+
+#endif // LEGATO_UPDATE_DELTA_H_INCLUDE_GUARD
@@ -0,0 +1,232 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file md5.c
+ *
+ * Incremental MD5 hashing (RFC 1321).
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "legato.h"
+#include "limit.h"
+#include "md5.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Per-round additive constants (the integer part of abs(sin(i + 1)) * 2^32).
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint32_t K[64] =
+{
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+    0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+    0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+    0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+    0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+    0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+    0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+    0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+    0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Per-round left rotation amounts.
+ */
+//--------------------------------------------------------------------------------------------------
+static const uint8_t S[64] =
+{
+    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+    5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run the compression function over one 64 byte block.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessBlock
+(
+    uint32_t state[4],
+    const uint8_t* blockPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t m[16];
+    int i;
+
+    // The message words are little-endian, whatever the host byte order is.
+    for (i = 0; i < 16; i++)
+    {
+        m[i] =   (uint32_t)blockPtr[i * 4]
+              | ((uint32_t)blockPtr[i * 4 + 1] << 8)
+              | ((uint32_t)blockPtr[i * 4 + 2] << 16)
+              | ((uint32_t)blockPtr[i * 4 + 3] << 24);
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+
+    for (i = 0; i < 64; i++)
+    {
+        uint32_t f;
+        int g;
+
+        if (i < 16)
+        {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32)
+        {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) & 0xf;
+        }
+        else if (i < 48)
+        {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) & 0xf;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+            g = (7 * i) & 0xf;
+        }
+
+        f += a + K[i] + m[g];
+        a = d;
+        d = c;
+        c = b;
+        b += (f << S[i]) | (f >> (32 - S[i]));
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new MD5 computation.
+ */
+//--------------------------------------------------------------------------------------------------
+void md5_Init
+(
+    md5_Ctx_t* ctxPtr       ///< [OUT] Context to initialize.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ctxPtr->state[0] = 0x67452301;
+    ctxPtr->state[1] = 0xefcdab89;
+    ctxPtr->state[2] = 0x98badcfe;
+    ctxPtr->state[3] = 0x10325476;
+    ctxPtr->byteCount = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add data to an MD5 computation.
+ */
+//--------------------------------------------------------------------------------------------------
+void md5_Update
+(
+    md5_Ctx_t* ctxPtr,      ///< [IN/OUT] Context.
+    const void* dataPtr,    ///< [IN] Data to hash.
+    size_t dataLen          ///< [IN] Number of bytes of data.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const uint8_t* bytePtr = dataPtr;
+    size_t used = ctxPtr->byteCount & 0x3f;
+
+    ctxPtr->byteCount += dataLen;
+
+    // Top up a partially filled block first.
+    if (used != 0)
+    {
+        size_t space = sizeof(ctxPtr->buffer) - used;
+
+        if (dataLen < space)
+        {
+            memcpy(ctxPtr->buffer + used, bytePtr, dataLen);
+            return;
+        }
+
+        memcpy(ctxPtr->buffer + used, bytePtr, space);
+        ProcessBlock(ctxPtr->state, ctxPtr->buffer);
+        bytePtr += space;
+        dataLen -= space;
+    }
+
+    // Hash whole blocks straight from the caller's buffer.
+    while (dataLen >= sizeof(ctxPtr->buffer))
+    {
+        ProcessBlock(ctxPtr->state, bytePtr);
+        bytePtr += sizeof(ctxPtr->buffer);
+        dataLen -= sizeof(ctxPtr->buffer);
+    }
+
+    memcpy(ctxPtr->buffer, bytePtr, dataLen);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish an MD5 computation and get the digest as a lower-case hexadecimal string (the same format
+ * that md5sum prints).
+ */
+//--------------------------------------------------------------------------------------------------
+void md5_Final
+(
+    md5_Ctx_t* ctxPtr,                  ///< [IN/OUT] Context.  Must be re-initialized to reuse.
+    char md5Str[LIMIT_MD5_STR_BYTES]    ///< [OUT] Digest string (null-terminated).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t bitCount = ctxPtr->byteCount * 8;
+    size_t used = ctxPtr->byteCount & 0x3f;
+
+    // Pad with a single 1 bit, then zeros up to 8 bytes short of a block boundary.
+    ctxPtr->buffer[used++] = 0x80;
+
+    if (used > 56)
+    {
+        memset(ctxPtr->buffer + used, 0, sizeof(ctxPtr->buffer) - used);
+        ProcessBlock(ctxPtr->state, ctxPtr->buffer);
+        used = 0;
+    }
+
+    memset(ctxPtr->buffer + used, 0, 56 - used);
+
+    // Append the message length in bits, little-endian.
+    int i;
+    for (i = 0; i < 8; i++)
+    {
+        ctxPtr->buffer[56 + i] = (uint8_t)(bitCount >> (8 * i));
+    }
+
+    ProcessBlock(ctxPtr->state, ctxPtr->buffer);
+
+    for (i = 0; i < 16; i++)
+    {
+        snprintf(md5Str + (i * 2), 3, "%02x", (ctxPtr->state[i / 4] >> (8 * (i % 4))) & 0xff);
+    }
+}
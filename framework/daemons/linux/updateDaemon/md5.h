@@ -0,0 +1,66 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file md5.h
+ *
+ * Incremental MD5 hashing, used to check update pack payloads while they are being unpacked.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_UPDATE_MD5_H_INCLUDE_GUARD
+#define LEGATO_UPDATE_MD5_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of an MD5 computation in progress.  Treat as opaque.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t state[4];      ///< Intermediate digest (A, B, C, D).
+    uint64_t byteCount;     ///< Total number of bytes hashed so far.
+    uint8_t buffer[64];     ///< Bytes waiting for a full 64 byte block.
+}
+md5_Ctx_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a new MD5 computation.
+ */
+//--------------------------------------------------------------------------------------------------
+void md5_Init
+(
+    md5_Ctx_t* ctxPtr       ///< [OUT] Context to initialize.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add data to an MD5 computation.
+ */
+//--------------------------------------------------------------------------------------------------
+void md5_Update
+(
+    md5_Ctx_t* ctxPtr,      ///< [IN/OUT] Context.
+    const void* dataPtr,    ///< [IN] Data to hash.
+    size_t dataLen          ///< [IN] Number of bytes of data.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish an MD5 computation and get the digest as a lower-case hexadecimal string (the same format
+ * that md5sum prints).
+ */
+//--------------------------------------------------------------------------------------------------
+void md5_Final
+(
+    md5_Ctx_t* ctxPtr,                  ///< [IN/OUT] Context.  Must be re-initialized to reuse.
+    char md5Str[LIMIT_MD5_STR_BYTES]    ///< [OUT] Digest string (null-terminated).
+);
+
+
+#endif // LEGATO_UPDATE_MD5_H_INCLUDE_GUARD
@@ -23,6 +23,7 @@
 #include "sysPaths.h"
 #include "sysStatus.h"
 #include "smack.h"
+#include "blobStore.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -707,6 +708,74 @@ le_result_t system_CopyAppConfig
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Classify the files of a system for snapshots.  The config tree files and the apps' writeable
+ * files are modified in place while the system runs, so the snapshot needs its own copy of them.
+ * Everything else in a system is either never modified or is replaced atomically (by renaming a
+ * new file over it), so it can be shared with the snapshot.
+ *
+ * @return true if the file must be copied into the snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSystemFileWriteable
+(
+    const char* relPathPtr  ///< [IN] Path of the file relative to the root of the system.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static const char* writeableDirs[] = { "config/", "appsWriteable/" };
+
+    size_t i;
+    for (i = 0; i < NUM_ARRAY_MEMBERS(writeableDirs); i++)
+    {
+        if (strncmp(relPathPtr, writeableDirs[i], strlen(writeableDirs[i])) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Give the unpacked system a link to the current system's dynamic linker cache and its stamp.
+ *
+ * The start program only reuses the cache if the stamp shows that the new system has the same
+ * libraries (which, thanks to the blob store, are then the very same files); otherwise it rebuilds
+ * it.  Both files are only ever replaced, never modified in place, so sharing them is safe.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LinkLdSoCache
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static const char* const fileNames[] = { "ld.so.cache", "ld.so.cache.stamp" };
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(fileNames); i++)
+    {
+        char srcPath[PATH_MAX] = "";
+        char destPath[PATH_MAX] = "";
+
+        LE_ASSERT(le_path_Concat("/", srcPath, sizeof(srcPath),
+                                 CURRENT_SYSTEM_PATH, fileNames[i], NULL) == LE_OK);
+        LE_ASSERT(le_path_Concat("/", destPath, sizeof(destPath),
+                                 system_UnpackPath, fileNames[i], NULL) == LE_OK);
+
+        if ((link(srcPath, destPath) != 0) && (errno != ENOENT) && (errno != EEXIST))
+        {
+            // Not fatal; the start program will just have to run ldconfig.
+            LE_WARN("Failed to link '%s' to '%s' (%m).", srcPath, destPath);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Complete a system update and move the system from unpack into current.
@@ -744,6 +813,22 @@ le_result_t system_FinishUpdate
     // path to some index.
     SetSystemFilesPermissions(system_UnpackPath);
 
+    // Share the new system's read-only files with the installed apps and systems that have
+    // identical ones.  This also needs the final labels, so it's done after setting them.
+    blobStore_Stats_t blobStats = { 0 };
+
+    if (blobStore_ShareTree(system_UnpackPath, IsSystemFileWriteable, &blobStats) == LE_OK)
+    {
+        LE_INFO("System files: %zu added to the blob store, %zu shared (%lld bytes saved).",
+                blobStats.addedCount,
+                blobStats.sharedCount,
+                (long long)blobStats.bytesSaved);
+    }
+
+    // Carry the dynamic linker's cache over, so it doesn't need to be rebuilt on the next start if
+    // no library changed.
+    LinkLdSoCache();
+
     // Now, move the unpacked system into its index.
     char newSystemPath[100] = "";
     snprintf(newSystemPath, sizeof(newSystemPath), "%s/%d", SystemPath, currentIndex);
@@ -783,7 +868,13 @@ le_result_t system_Snapshot
 
     system_PrepUnpackDir();
 
-    if (file_CopyRecursive(CURRENT_SYSTEM_PATH, system_UnpackPath, NULL) != LE_OK)
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    file_SnapshotStats_t stats = { 0 };
+
+    if (file_SnapshotRecursive(CURRENT_SYSTEM_PATH,
+                               system_UnpackPath,
+                               IsSystemFileWriteable,
+                               &stats) != LE_OK)
     {
         return LE_FAULT;
     }
@@ -844,8 +935,8 @@ le_result_t system_Snapshot
                     break;
                 }
 
-                // Copy directories.
-                if (file_CopyRecursive(sourceDir, destDir, NULL) != LE_OK)
+                // Copy directories.  Everything in here is writeable.
+                if (file_SnapshotRecursive(sourceDir, destDir, NULL, &stats) != LE_OK)
                 {
                     result = LE_FAULT;
                     break;
@@ -874,6 +965,15 @@ le_result_t system_Snapshot
 
     file_Rename(system_UnpackPath, newSystemPath);
 
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    LE_INFO("Snapshot: %zu files linked, %zu reflinked, %zu copied (%lld bytes written) in %ld ms.",
+            stats.linkCount,
+            stats.cloneCount,
+            stats.copyCount,
+            (long long)stats.bytesWritten,
+            (long)(elapsed.sec * 1000 + elapsed.usec / 1000));
+
     // Increment the index of the current system.
     SetIndex("current", currentIndex + 1);
 
@@ -1057,6 +1157,9 @@ void system_RemoveUnusedApps
     }
 
     fts_close(ftsPtr);
+
+    // Free the files that only the removed apps were using.
+    blobStore_CollectGarbage();
 }
 
 
@@ -1185,6 +1288,9 @@ void system_RemoveUnneeded
     }
 
     fts_close(ftsPtr);
+
+    // Free the files that only the removed systems were using.
+    blobStore_CollectGarbage();
 }
 
 
@@ -0,0 +1,1285 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file untar.c
+ *
+ * In-process, streaming extractor for the bzip2 compressed tarballs found in update packs.
+ *
+ * Compressed bytes are decompressed into a large output buffer and fed through a tar parser state
+ * machine that writes the entries to the file system as their data arrives.  Nothing is buffered
+ * beyond the current tar header, so memory use doesn't depend on the size of the tarball or of the
+ * files in it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include <bzlib.h>
+
+#include "legato.h"
+#include "limit.h"
+#include "fileDescriptor.h"
+#include "untar.h"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of a tar block.  Headers are one block and entry data is padded to a multiple of this.
+ */
+//--------------------------------------------------------------------------------------------------
+#define BLOCK_BYTES 512
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Size of the buffer that decompressed data is put in before being parsed.
+ */
+//--------------------------------------------------------------------------------------------------
+#define OUT_BUFFER_BYTES (64 * 1024)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of a pax extended header (they normally only hold a long path and link path).
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_PAX_HEADER_BYTES (2 * LIMIT_MAX_PATH_BYTES + BLOCK_BYTES)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Offsets and sizes of the fields in a tar header block that we care about.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HDR_NAME_OFFSET         0
+#define HDR_NAME_BYTES          100
+#define HDR_MODE_OFFSET         100
+#define HDR_MODE_BYTES          8
+#define HDR_SIZE_OFFSET         124
+#define HDR_SIZE_BYTES          12
+#define HDR_CHKSUM_OFFSET       148
+#define HDR_CHKSUM_BYTES        8
+#define HDR_TYPE_OFFSET         156
+#define HDR_LINKNAME_OFFSET     157
+#define HDR_LINKNAME_BYTES      100
+#define HDR_MAGIC_OFFSET        257
+#define HDR_PREFIX_OFFSET       345
+#define HDR_PREFIX_BYTES        155
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * What the tar parser is expecting next.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    PARSE_HEADER,       ///< Accumulating a header block.
+    PARSE_FILE_DATA,    ///< Writing the contents of a regular file.
+    PARSE_LONG_NAME,    ///< Reading a GNU long path name.
+    PARSE_LONG_LINK,    ///< Reading a GNU long link target.
+    PARSE_PAX_HEADER,   ///< Reading pax extended header records.
+    PARSE_SKIP,         ///< Discarding the data of an entry we don't need.
+    PARSE_PADDING,      ///< Discarding the padding after an entry's data.
+    PARSE_END,          ///< Found the end-of-archive marker; the rest is ignored.
+}
+ParseState_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Permissions to apply to a directory once everything has been extracted into it.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t link;                 ///< Link in the extractor's list of directories.
+    mode_t mode;                        ///< Permissions from the tarball.
+    char path[LIMIT_MAX_PATH_BYTES];    ///< Absolute path of the directory.
+}
+DirMode_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Extractor object.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct untar_Extractor
+{
+    bz_stream stream;                   ///< bzip2 decompressor state.
+    bool streamOpen;                    ///< true if the decompressor has been initialized.
+    bool streamEnded;                   ///< true if the last bzip2 stream ended cleanly.
+    char dirPath[LIMIT_MAX_PATH_BYTES]; ///< Directory to extract into.
+    ParseState_t state;                 ///< Tar parser state.
+    uint8_t header[BLOCK_BYTES];        ///< Header block being accumulated.
+    size_t headerBytes;                 ///< Number of bytes in the header block so far.
+    uint64_t dataRemaining;             ///< Bytes of the current entry's data still to come.
+    size_t paddingRemaining;            ///< Bytes of padding after the current entry's data.
+    int fd;                             ///< File being written, or -1.
+    mode_t fileMode;                    ///< Permissions for the file being written.
+    char path[LIMIT_MAX_PATH_BYTES];    ///< Absolute path of the current entry.
+    char longName[LIMIT_MAX_PATH_BYTES];///< Path from a GNU long name or pax header ("" if none).
+    char longLink[LIMIT_MAX_PATH_BYTES];///< Link from a GNU long link or pax header ("" if none).
+    size_t metaBytes;                   ///< Bytes of long name/link/pax data received so far.
+    char pax[MAX_PAX_HEADER_BYTES];     ///< Pax extended header being accumulated.
+    le_sls_List_t dirModeList;          ///< Directory permissions to apply when finished.
+    uint64_t tarBytes;                  ///< Number of decompressed bytes processed.
+    char outBuffer[OUT_BUFFER_BYTES];   ///< Decompressed data.
+}
+Extractor_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for extractor objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ExtractorPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool for directory permission records.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t DirModePool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a numeric header field.  Numbers are normally octal text, terminated by a space or a null,
+ * but GNU tar stores large numbers in base-256 with the top bit of the first byte set.
+ *
+ * @return LE_OK or LE_FORMAT_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParseNumber
+(
+    const uint8_t* fieldPtr,
+    size_t fieldBytes,
+    uint64_t* valuePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t value = 0;
+    size_t i = 0;
+
+    if (fieldPtr[0] & 0x80)
+    {
+        // Base-256.  Only positive values make sense here.
+        if (fieldPtr[0] & 0x40)
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        value = fieldPtr[0] & 0x3f;
+
+        for (i = 1; i < fieldBytes; i++)
+        {
+            if (value >> 56)
+            {
+                return LE_FORMAT_ERROR;
+            }
+            value = (value << 8) | fieldPtr[i];
+        }
+
+        *valuePtr = value;
+        return LE_OK;
+    }
+
+    // Skip leading spaces.
+    while ((i < fieldBytes) && (fieldPtr[i] == ' '))
+    {
+        i++;
+    }
+
+    for (; i < fieldBytes; i++)
+    {
+        if ((fieldPtr[i] == ' ') || (fieldPtr[i] == '\0'))
+        {
+            break;
+        }
+        if ((fieldPtr[i] < '0') || (fieldPtr[i] > '7'))
+        {
+            return LE_FORMAT_ERROR;
+        }
+
+        value = (value << 3) | (fieldPtr[i] - '0');
+    }
+
+    *valuePtr = value;
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a header block's checksum (the sum of all bytes, with the checksum field taken as spaces).
+ *
+ * @return true if the checksum is good.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsChecksumValid
+(
+    const uint8_t* headerPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint64_t expected;
+
+    if (ParseNumber(headerPtr + HDR_CHKSUM_OFFSET, HDR_CHKSUM_BYTES, &expected) != LE_OK)
+    {
+        return false;
+    }
+
+    uint64_t sum = ' ' * HDR_CHKSUM_BYTES;
+    size_t i;
+
+    for (i = 0; i < BLOCK_BYTES; i++)
+    {
+        if ((i < HDR_CHKSUM_OFFSET) || (i >= HDR_CHKSUM_OFFSET + HDR_CHKSUM_BYTES))
+        {
+            sum += headerPtr[i];
+        }
+    }
+
+    return (sum == expected);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a header block is all zeros (the end-of-archive marker).
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsZeroBlock
+(
+    const uint8_t* headerPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i;
+
+    for (i = 0; i < BLOCK_BYTES; i++)
+    {
+        if (headerPtr[i] != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a header field that is null-terminated unless it fills the whole field.
+ *
+ * @return LE_OK or LE_OVERFLOW.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyField
+(
+    char* destPtr,
+    size_t destSize,
+    const uint8_t* fieldPtr,
+    size_t fieldBytes
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t len = strnlen((const char*)fieldPtr, fieldBytes);
+
+    if (len >= destSize)
+    {
+        return LE_OVERFLOW;
+    }
+
+    memcpy(destPtr, fieldPtr, len);
+    destPtr[len] = '\0';
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the absolute path for a path found in the tarball.  Leading "./" is removed and paths
+ * that could escape the extraction directory are rejected.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR or LE_OVERFLOW.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MakeEntryPath
+(
+    Extractor_t* exPtr,
+    const char* tarPathPtr,
+    char* destPtr,
+    size_t destSize
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (tarPathPtr[0] == '/')
+    {
+        LE_ERROR("Absolute path '%s' in tarball.", tarPathPtr);
+        return LE_FORMAT_ERROR;
+    }
+
+    while ((tarPathPtr[0] == '.') && (tarPathPtr[1] == '/'))
+    {
+        tarPathPtr += 2;
+    }
+
+    // Reject any ".." path component.
+    const char* componentPtr = tarPathPtr;
+    while (componentPtr != NULL)
+    {
+        if (   (componentPtr[0] == '.')
+            && (componentPtr[1] == '.')
+            && ((componentPtr[2] == '/') || (componentPtr[2] == '\0')))
+        {
+            LE_ERROR("Path '%s' in tarball goes outside the unpack directory.", tarPathPtr);
+            return LE_FORMAT_ERROR;
+        }
+
+        componentPtr = strchr(componentPtr, '/');
+        if (componentPtr != NULL)
+        {
+            componentPtr++;
+        }
+    }
+
+    if ((tarPathPtr[0] == '\0') || (strcmp(tarPathPtr, ".") == 0))
+    {
+        return le_utf8_Copy(destPtr, exPtr->dirPath, destSize, NULL);
+    }
+
+    destPtr[0] = '\0';
+    le_result_t result = le_path_Concat("/", destPtr, destSize, exPtr->dirPath, tarPathPtr, NULL);
+
+    // Directory entries end with a slash, which would make them look like a parent directory.
+    size_t len = strlen(destPtr);
+    size_t dirPathLen = strlen(exPtr->dirPath);
+
+    while ((len > dirPathLen) && (destPtr[len - 1] == '/'))
+    {
+        destPtr[--len] = '\0';
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the directories leading to a path inside a directory, and optionally create the missing
+ * ones.
+ *
+ * The path must not go through a symlink: an earlier tarball entry (or a file of a delta's base
+ * app) can be a symlink pointing anywhere, and writing through it would escape the directory.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_CheckParentDirs
+(
+    const char* rootPathPtr,    ///< [IN] Trusted directory the path is in.
+    const char* pathPtr,        ///< [IN] Path starting with rootPathPtr, without "." or "..".
+    bool create                 ///< [IN] true to create the missing directories.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char dirPath[LIMIT_MAX_PATH_BYTES];
+
+    LE_ASSERT(le_utf8_Copy(dirPath, pathPtr, sizeof(dirPath), NULL) == LE_OK);
+
+    // The root directory itself is trusted, so start with the path's first component.
+    char* componentPtr = dirPath + strlen(rootPathPtr);
+    char* slashPtr;
+
+    if (*componentPtr == '\0')
+    {
+        return LE_OK;
+    }
+
+    while ((slashPtr = strchr(componentPtr + 1, '/')) != NULL)
+    {
+        struct stat st;
+
+        *slashPtr = '\0';
+
+        if (lstat(dirPath, &st) != 0)
+        {
+            if ((errno != ENOENT) || !create)
+            {
+                LE_ERROR("Failed to look up '%s' (%m).", dirPath);
+                return LE_IO_ERROR;
+            }
+
+            if (mkdir(dirPath, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) != 0)
+            {
+                LE_ERROR("Failed to create directory '%s' (%m).", dirPath);
+                return LE_IO_ERROR;
+            }
+        }
+        else if (S_ISLNK(st.st_mode))
+        {
+            LE_ERROR("Path '%s' goes through symlink '%s'.", pathPtr, dirPath);
+            return LE_FORMAT_ERROR;
+        }
+        else if (!S_ISDIR(st.st_mode))
+        {
+            LE_ERROR("Path '%s' goes through non-directory '%s'.", pathPtr, dirPath);
+            return LE_FORMAT_ERROR;
+        }
+
+        *slashPtr = '/';
+        componentPtr = slashPtr;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove whatever non-directory object exists at a path, so that it can be replaced.
+ *
+ * @return LE_OK or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t RemoveExisting
+(
+    const char* pathPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((unlink(pathPtr) != 0) && (errno != ENOENT))
+    {
+        LE_ERROR("Failed to remove '%s' (%m).", pathPtr);
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Close the regular file being extracted and give it its permissions.
+ *
+ * @return LE_OK or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CloseFile
+(
+    Extractor_t* exPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    if (fchmod(exPtr->fd, exPtr->fileMode) != 0)
+    {
+        LE_ERROR("Failed to set permissions of '%s' (%m).", exPtr->path);
+        result = LE_IO_ERROR;
+    }
+
+    fd_Close(exPtr->fd);
+    exPtr->fd = -1;
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a regular file and get ready to receive its contents.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t StartFile
+(
+    Extractor_t* exPtr,
+    mode_t mode
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_result_t result = untar_CheckParentDirs(exPtr->dirPath, exPtr->path, true);
+
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if (RemoveExisting(exPtr->path) != LE_OK)
+    {
+        return LE_IO_ERROR;
+    }
+
+    // Create the file writeable by us, and only set the real permissions once it's written.
+    // Whatever was there has just been removed, so never open anything that reappeared instead.
+    int fd;
+    do
+    {
+        fd = open(exPtr->path,
+                  O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+                  S_IRUSR | S_IWUSR);
+    }
+    while ((fd == -1) && (errno == EINTR));
+
+    if (fd == -1)
+    {
+        LE_ERROR("Failed to create '%s' (%m).", exPtr->path);
+        return LE_IO_ERROR;
+    }
+
+    exPtr->fd = fd;
+    exPtr->fileMode = mode;
+
+    if (exPtr->dataRemaining == 0)
+    {
+        return CloseFile(exPtr);
+    }
+
+    exPtr->state = PARSE_FILE_DATA;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a directory.  Its permissions are applied when the extraction is finished, so that
+ * read-only directories can still be extracted into.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MakeDir
+(
+    Extractor_t* exPtr,
+    mode_t mode
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // The unpack directory itself already exists.
+    if (strcmp(exPtr->path, exPtr->dirPath) != 0)
+    {
+        le_result_t result = untar_CheckParentDirs(exPtr->dirPath, exPtr->path, true);
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        // The directory may already exist.  Anything else, a symlink in particular, is replaced, as
+        // the directory's permissions will be set through its path.
+        struct stat st;
+
+        if ((lstat(exPtr->path, &st) != 0) || !S_ISDIR(st.st_mode))
+        {
+            if (   (RemoveExisting(exPtr->path) != LE_OK)
+                || (mkdir(exPtr->path, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) != 0))
+            {
+                LE_ERROR("Failed to create directory '%s' (%m).", exPtr->path);
+                return LE_IO_ERROR;
+            }
+        }
+    }
+
+    DirMode_t* dirModePtr = le_mem_ForceAlloc(DirModePool);
+    dirModePtr->link = LE_SLS_LINK_INIT;
+    dirModePtr->mode = mode;
+    LE_ASSERT(le_utf8_Copy(dirModePtr->path, exPtr->path, sizeof(dirModePtr->path), NULL)
+              == LE_OK);
+
+    // Stacking puts sub-directories ahead of their parents.
+    le_sls_Stack(&exPtr->dirModeList, &dirModePtr->link);
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a symbolic or hard link.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t MakeLink
+(
+    Extractor_t* exPtr,
+    const char* linkPtr,
+    bool isSymlink
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char targetPath[LIMIT_MAX_PATH_BYTES];
+
+    // Symlink targets are stored as they are, but hard link targets are paths in the tarball.
+    if (isSymlink)
+    {
+        if (le_utf8_Copy(targetPath, linkPtr, sizeof(targetPath), NULL) != LE_OK)
+        {
+            return LE_FORMAT_ERROR;
+        }
+    }
+    else
+    {
+        le_result_t result = MakeEntryPath(exPtr, linkPtr, targetPath, sizeof(targetPath));
+        if (result != LE_OK)
+        {
+            return (result == LE_OVERFLOW) ? LE_FORMAT_ERROR : result;
+        }
+
+        result = untar_CheckParentDirs(exPtr->dirPath, targetPath, false);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+    }
+
+    le_result_t result = untar_CheckParentDirs(exPtr->dirPath, exPtr->path, true);
+    if (result != LE_OK)
+    {
+        return result;
+    }
+
+    if (RemoveExisting(exPtr->path) != LE_OK)
+    {
+        return LE_IO_ERROR;
+    }
+
+    int linkResult = isSymlink ? symlink(targetPath, exPtr->path) : link(targetPath, exPtr->path);
+
+    if (linkResult != 0)
+    {
+        LE_ERROR("Failed to link '%s' to '%s' (%m).", exPtr->path, targetPath);
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pick the path and link target out of the pax extended header records.  Each record is
+ * "<length> <keyword>=<value>\n".
+ *
+ * @return LE_OK or LE_FORMAT_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ParsePaxHeader
+(
+    Extractor_t* exPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = 0;
+
+    while (offset < exPtr->metaBytes)
+    {
+        char* recordPtr = exPtr->pax + offset;
+        char* endPtr;
+        unsigned long recordLen = strtoul(recordPtr, &endPtr, 10);
+
+        if (   (endPtr == recordPtr)
+            || (*endPtr != ' ')
+            || (recordLen == 0)
+            || (recordLen > exPtr->metaBytes - offset)
+            || (recordPtr[recordLen - 1] != '\n'))
+        {
+            LE_ERROR("Malformed pax header record.");
+            return LE_FORMAT_ERROR;
+        }
+
+        char* keywordPtr = endPtr + 1;
+        char* valuePtr = memchr(keywordPtr, '=', recordPtr + recordLen - keywordPtr);
+
+        if (valuePtr != NULL)
+        {
+            *valuePtr++ = '\0';
+            recordPtr[recordLen - 1] = '\0';
+
+            char* destPtr = NULL;
+
+            if (strcmp(keywordPtr, "path") == 0)
+            {
+                destPtr = exPtr->longName;
+            }
+            else if (strcmp(keywordPtr, "linkpath") == 0)
+            {
+                destPtr = exPtr->longLink;
+            }
+
+            if (   (destPtr != NULL)
+                && (le_utf8_Copy(destPtr, valuePtr, LIMIT_MAX_PATH_BYTES, NULL) != LE_OK))
+            {
+                LE_ERROR("Path too long in pax header.");
+                return LE_FORMAT_ERROR;
+            }
+        }
+
+        offset += recordLen;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Move on to the padding after an entry's data, or to the next header if there isn't any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndEntryData
+(
+    Extractor_t* exPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    exPtr->state = (exPtr->paddingRemaining > 0) ? PARSE_PADDING : PARSE_HEADER;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Act on a complete header block.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ProcessHeader
+(
+    Extractor_t* exPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const uint8_t* hdrPtr = exPtr->header;
+
+    exPtr->headerBytes = 0;
+
+    if (IsZeroBlock(hdrPtr))
+    {
+        exPtr->state = PARSE_END;
+        return LE_OK;
+    }
+
+    if (!IsChecksumValid(hdrPtr))
+    {
+        LE_ERROR("Bad tar header checksum.");
+        return LE_FORMAT_ERROR;
+    }
+
+    uint64_t size;
+    uint64_t mode;
+
+    if (   (ParseNumber(hdrPtr + HDR_SIZE_OFFSET, HDR_SIZE_BYTES, &size) != LE_OK)
+        || (ParseNumber(hdrPtr + HDR_MODE_OFFSET, HDR_MODE_BYTES, &mode) != LE_OK))
+    {
+        LE_ERROR("Bad number in tar header.");
+        return LE_FORMAT_ERROR;
+    }
+
+    char type = hdrPtr[HDR_TYPE_OFFSET];
+
+    exPtr->dataRemaining = size;
+    exPtr->paddingRemaining = (BLOCK_BYTES - (size % BLOCK_BYTES)) % BLOCK_BYTES;
+    exPtr->metaBytes = 0;
+
+    // Meta-data entries that apply to the next header.
+    switch (type)
+    {
+        case 'L':   // GNU long name.
+        case 'K':   // GNU long link.
+            if (size >= LIMIT_MAX_PATH_BYTES)
+            {
+                LE_ERROR("Path too long in tarball (%" PRIu64 " bytes).", size);
+                return LE_FORMAT_ERROR;
+            }
+            exPtr->state = (type == 'L') ? PARSE_LONG_NAME : PARSE_LONG_LINK;
+            return LE_OK;
+
+        case 'x':   // Pax extended header.
+            if (size >= MAX_PAX_HEADER_BYTES)
+            {
+                LE_ERROR("Pax header too long (%" PRIu64 " bytes).", size);
+                return LE_FORMAT_ERROR;
+            }
+            exPtr->state = PARSE_PAX_HEADER;
+            return LE_OK;
+
+        case 'g':   // Pax global header.  Nothing in it matters to us.
+            exPtr->state = PARSE_SKIP;
+            return LE_OK;
+    }
+
+    // Work out the entry's path, preferring a long name given in a previous entry.
+    char tarPath[LIMIT_MAX_PATH_BYTES];
+
+    if (exPtr->longName[0] != '\0')
+    {
+        LE_ASSERT(le_utf8_Copy(tarPath, exPtr->longName, sizeof(tarPath), NULL) == LE_OK);
+    }
+    else if (   (memcmp(hdrPtr + HDR_MAGIC_OFFSET, "ustar", 6) == 0)
+             && (hdrPtr[HDR_PREFIX_OFFSET] != '\0'))
+    {
+        // POSIX ustar splits long paths into a prefix and a name.
+        char name[HDR_NAME_BYTES + 1];
+
+        LE_ASSERT(CopyField(tarPath, sizeof(tarPath),
+                            hdrPtr + HDR_PREFIX_OFFSET, HDR_PREFIX_BYTES) == LE_OK);
+        LE_ASSERT(CopyField(name, sizeof(name), hdrPtr + HDR_NAME_OFFSET, HDR_NAME_BYTES) == LE_OK);
+
+        if (le_path_Concat("/", tarPath, sizeof(tarPath), name, NULL) != LE_OK)
+        {
+            return LE_FORMAT_ERROR;
+        }
+    }
+    else
+    {
+        LE_ASSERT(CopyField(tarPath, sizeof(tarPath),
+                            hdrPtr + HDR_NAME_OFFSET, HDR_NAME_BYTES) == LE_OK);
+    }
+
+    char linkPath[LIMIT_MAX_PATH_BYTES];
+
+    if (exPtr->longLink[0] != '\0')
+    {
+        LE_ASSERT(le_utf8_Copy(linkPath, exPtr->longLink, sizeof(linkPath), NULL) == LE_OK);
+    }
+    else
+    {
+        LE_ASSERT(CopyField(linkPath, sizeof(linkPath),
+                            hdrPtr + HDR_LINKNAME_OFFSET, HDR_LINKNAME_BYTES) == LE_OK);
+    }
+
+    exPtr->longName[0] = '\0';
+    exPtr->longLink[0] = '\0';
+
+    le_result_t result = MakeEntryPath(exPtr, tarPath, exPtr->path, sizeof(exPtr->path));
+    if (result != LE_OK)
+    {
+        LE_ERROR("Bad path '%s' in tarball.", tarPath);
+        return LE_FORMAT_ERROR;
+    }
+
+    mode &= (S_ISUID | S_ISGID | S_ISVTX | S_IRWXU | S_IRWXG | S_IRWXO);
+
+    switch (type)
+    {
+        case '0':
+        case '\0':
+        case '7':   // Contiguous file; same as a regular file.
+            return StartFile(exPtr, mode);
+
+        case '5':
+            exPtr->state = (size > 0) ? PARSE_SKIP : PARSE_HEADER;
+            return MakeDir(exPtr, mode);
+
+        case '2':
+        case '1':
+            exPtr->state = (size > 0) ? PARSE_SKIP : PARSE_HEADER;
+            return MakeLink(exPtr, linkPath, (type == '2'));
+
+        default:
+            LE_ERROR("Unsupported tar entry type '%c' for '%s'.", type, tarPath);
+            return LE_FORMAT_ERROR;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run decompressed bytes through the tar parser.
+ *
+ * @return LE_OK, LE_FORMAT_ERROR or LE_IO_ERROR.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ProcessTarBytes
+(
+    Extractor_t* exPtr,
+    const char* dataPtr,
+    size_t dataLen
+)
+//--------------------------------------------------------------------------------------------------
+{
+    exPtr->tarBytes += dataLen;
+
+    while (dataLen > 0)
+    {
+        size_t count;
+        le_result_t result = LE_OK;
+
+        switch (exPtr->state)
+        {
+            case PARSE_HEADER:
+                count = BLOCK_BYTES - exPtr->headerBytes;
+                if (count > dataLen)
+                {
+                    count = dataLen;
+                }
+                memcpy(exPtr->header + exPtr->headerBytes, dataPtr, count);
+                exPtr->headerBytes += count;
+                if (exPtr->headerBytes == BLOCK_BYTES)
+                {
+                    result = ProcessHeader(exPtr);
+                }
+                break;
+
+            case PARSE_FILE_DATA:
+            {
+                count = (exPtr->dataRemaining < dataLen) ? exPtr->dataRemaining : dataLen;
+
+                size_t written = 0;
+                while (written < count)
+                {
+                    ssize_t writeResult = write(exPtr->fd, dataPtr + written, count - written);
+                    if (writeResult == -1)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+                        LE_ERROR("Failed to write '%s' (%m).", exPtr->path);
+                        return LE_IO_ERROR;
+                    }
+                    written += writeResult;
+                }
+
+                exPtr->dataRemaining -= count;
+                if (exPtr->dataRemaining == 0)
+                {
+                    result = CloseFile(exPtr);
+                    EndEntryData(exPtr);
+                }
+                break;
+            }
+
+            case PARSE_LONG_NAME:
+            case PARSE_LONG_LINK:
+            case PARSE_PAX_HEADER:
+            {
+                count = (exPtr->dataRemaining < dataLen) ? exPtr->dataRemaining : dataLen;
+
+                char* destPtr = (exPtr->state == PARSE_LONG_NAME) ? exPtr->longName :
+                                (exPtr->state == PARSE_LONG_LINK) ? exPtr->longLink :
+                                                                    exPtr->pax;
+                memcpy(destPtr + exPtr->metaBytes, dataPtr, count);
+                exPtr->metaBytes += count;
+                exPtr->dataRemaining -= count;
+
+                if (exPtr->dataRemaining == 0)
+                {
+                    destPtr[exPtr->metaBytes] = '\0';
+                    if (exPtr->state == PARSE_PAX_HEADER)
+                    {
+                        result = ParsePaxHeader(exPtr);
+                    }
+                    EndEntryData(exPtr);
+                }
+                break;
+            }
+
+            case PARSE_SKIP:
+                count = (exPtr->dataRemaining < dataLen) ? exPtr->dataRemaining : dataLen;
+                exPtr->dataRemaining -= count;
+                if (exPtr->dataRemaining == 0)
+                {
+                    EndEntryData(exPtr);
+                }
+                break;
+
+            case PARSE_PADDING:
+                count = (exPtr->paddingRemaining < dataLen) ? exPtr->paddingRemaining : dataLen;
+                exPtr->paddingRemaining -= count;
+                if (exPtr->paddingRemaining == 0)
+                {
+                    exPtr->state = PARSE_HEADER;
+                }
+                break;
+
+            case PARSE_END:
+            default:
+                // Tar pads the archive out to a whole record after the end marker.
+                return LE_OK;
+        }
+
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        dataPtr += count;
+        dataLen -= count;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the module.  Must be called before any other function in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ExtractorPool = le_mem_CreatePool("Untar", sizeof(Extractor_t));
+    DirModePool = le_mem_CreatePool("UntarDirMode", sizeof(DirMode_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an extractor that unpacks into a given directory.
+ *
+ * @return Reference to the extractor, or NULL if the decompressor could not be initialized.
+ */
+//--------------------------------------------------------------------------------------------------
+untar_Ref_t untar_Create
+(
+    const char* dirPath     ///< [IN] Existing directory to unpack into.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Extractor_t* exPtr = le_mem_ForceAlloc(ExtractorPool);
+
+    memset(&exPtr->stream, 0, sizeof(exPtr->stream));
+    exPtr->streamOpen = false;
+    exPtr->streamEnded = false;
+    exPtr->state = PARSE_HEADER;
+    exPtr->headerBytes = 0;
+    exPtr->dataRemaining = 0;
+    exPtr->paddingRemaining = 0;
+    exPtr->fd = -1;
+    exPtr->path[0] = '\0';
+    exPtr->longName[0] = '\0';
+    exPtr->longLink[0] = '\0';
+    exPtr->metaBytes = 0;
+    exPtr->dirModeList = LE_SLS_LIST_INIT;
+    exPtr->tarBytes = 0;
+
+    LE_FATAL_IF(le_utf8_Copy(exPtr->dirPath, dirPath, sizeof(exPtr->dirPath), NULL) != LE_OK,
+                "Unpack path '%s' too long.",
+                dirPath);
+
+    return exPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push compressed bytes into an extractor.  Everything that can be decompressed and extracted from
+ * them is written to the file system before this returns.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FORMAT_ERROR if the data is not a valid bzip2 compressed tarball.
+ *      - LE_IO_ERROR if writing to the file system failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_Write
+(
+    untar_Ref_t extractor,  ///< [IN] Extractor.
+    const void* dataPtr,    ///< [IN] Compressed bytes.
+    size_t dataLen          ///< [IN] Number of bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Extractor_t* exPtr = extractor;
+
+    exPtr->stream.next_in = (char*)dataPtr;
+    exPtr->stream.avail_in = dataLen;
+
+    while (exPtr->stream.avail_in > 0)
+    {
+        // Start a new bzip2 stream.  Some compressors (e.g., pbzip2) concatenate several.
+        if (!exPtr->streamOpen)
+        {
+            int bzResult = BZ2_bzDecompressInit(&exPtr->stream, 0, 0);
+            if (bzResult != BZ_OK)
+            {
+                LE_ERROR("Failed to initialize bzip2 decompressor (%d).", bzResult);
+                return LE_IO_ERROR;
+            }
+            exPtr->streamOpen = true;
+            exPtr->streamEnded = false;
+        }
+
+        exPtr->stream.next_out = exPtr->outBuffer;
+        exPtr->stream.avail_out = sizeof(exPtr->outBuffer);
+
+        int bzResult = BZ2_bzDecompress(&exPtr->stream);
+
+        if ((bzResult != BZ_OK) && (bzResult != BZ_STREAM_END))
+        {
+            LE_ERROR("Corrupt compressed data in update pack (%d).", bzResult);
+            return LE_FORMAT_ERROR;
+        }
+
+        le_result_t result = ProcessTarBytes(exPtr,
+                                             exPtr->outBuffer,
+                                             sizeof(exPtr->outBuffer) - exPtr->stream.avail_out);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        if (bzResult == BZ_STREAM_END)
+        {
+            BZ2_bzDecompressEnd(&exPtr->stream);
+            exPtr->streamOpen = false;
+            exPtr->streamEnded = true;
+        }
+    }
+
+    // Flush out anything the decompressor is still holding on to.
+    while (exPtr->streamOpen)
+    {
+        exPtr->stream.next_out = exPtr->outBuffer;
+        exPtr->stream.avail_out = sizeof(exPtr->outBuffer);
+
+        int bzResult = BZ2_bzDecompress(&exPtr->stream);
+
+        if ((bzResult != BZ_OK) && (bzResult != BZ_STREAM_END))
+        {
+            LE_ERROR("Corrupt compressed data in update pack (%d).", bzResult);
+            return LE_FORMAT_ERROR;
+        }
+
+        size_t produced = sizeof(exPtr->outBuffer) - exPtr->stream.avail_out;
+
+        le_result_t result = ProcessTarBytes(exPtr, exPtr->outBuffer, produced);
+        if (result != LE_OK)
+        {
+            return result;
+        }
+
+        if (bzResult == BZ_STREAM_END)
+        {
+            BZ2_bzDecompressEnd(&exPtr->stream);
+            exPtr->streamOpen = false;
+            exPtr->streamEnded = true;
+        }
+        else if (produced == 0)
+        {
+            // Needs more input.
+            break;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tell an extractor that there's no more input and finish the extraction (e.g., apply the
+ * permissions of read-only directories).
+ *
+ * @return
+ *      - LE_OK if the whole tarball was extracted.
+ *      - LE_FORMAT_ERROR if the compressed stream or the tarball was truncated.
+ *      - LE_IO_ERROR if writing to the file system failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_Finish
+(
+    untar_Ref_t extractor   ///< [IN] Extractor.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Extractor_t* exPtr = extractor;
+
+    if (exPtr->streamOpen || !exPtr->streamEnded)
+    {
+        LE_ERROR("Compressed payload ended early.");
+        return LE_FORMAT_ERROR;
+    }
+
+    // GNU tar without an end marker is tolerated, as long as we're between entries.
+    if ((exPtr->state != PARSE_END) && ((exPtr->state != PARSE_HEADER) || exPtr->headerBytes != 0))
+    {
+        LE_ERROR("Tarball ended early.");
+        return LE_FORMAT_ERROR;
+    }
+
+    le_result_t result = LE_OK;
+    le_sls_Link_t* linkPtr;
+
+    while ((linkPtr = le_sls_Pop(&exPtr->dirModeList)) != NULL)
+    {
+        DirMode_t* dirModePtr = CONTAINER_OF(linkPtr, DirMode_t, link);
+
+        if (chmod(dirModePtr->path, dirModePtr->mode) != 0)
+        {
+            LE_ERROR("Failed to set permissions of '%s' (%m).", dirModePtr->path);
+            result = LE_IO_ERROR;
+        }
+
+        le_mem_Release(dirModePtr);
+    }
+
+    LE_DEBUG("Extracted %" PRIu64 " bytes of tarball into '%s'.", exPtr->tarBytes, exPtr->dirPath);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes of decompressed tarball an extractor has processed.
+ *
+ * @return The byte count.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t untar_GetTarBytes
+(
+    untar_Ref_t extractor   ///< [IN] Extractor.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return extractor->tarBytes;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an extractor.  Files already extracted are left in place.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Delete
+(
+    untar_Ref_t extractor   ///< [IN] Extractor.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Extractor_t* exPtr = extractor;
+
+    if (exPtr->fd != -1)
+    {
+        fd_Close(exPtr->fd);
+    }
+
+    if (exPtr->streamOpen)
+    {
+        BZ2_bzDecompressEnd(&exPtr->stream);
+    }
+
+    le_sls_Link_t* linkPtr;
+    while ((linkPtr = le_sls_Pop(&exPtr->dirModeList)) != NULL)
+    {
+        le_mem_Release(CONTAINER_OF(linkPtr, DirMode_t, link));
+    }
+
+    le_mem_Release(exPtr);
+}
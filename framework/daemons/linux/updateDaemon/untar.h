@@ -0,0 +1,138 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file untar.h
+ *
+ * In-process, streaming extractor for the bzip2 compressed tarballs found in update packs.
+ *
+ * Compressed bytes are pushed into an extractor as they arrive from the update pack input stream
+ * and are decompressed and written to the file system as they go, so there's no need to fork a tar
+ * process and copy the payload to it through a pipe.
+ *
+ * Only what the Legato build tools put into update packs is supported: regular files,
+ * directories, symlinks and hard links, in ustar, GNU or pax format.  Like "tar xjmop", file
+ * permissions are restored but owners and modification times are not.
+ *
+ * Nothing is ever written outside the extraction directory: absolute paths, ".." components and
+ * paths going through a symlink (even one extracted earlier from the same tarball) are rejected.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_UPDATE_UNTAR_H_INCLUDE_GUARD
+#define LEGATO_UPDATE_UNTAR_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to an extractor.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct untar_Extractor* untar_Ref_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the module.  Must be called before any other function in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create an extractor that unpacks into a given directory.
+ *
+ * @return Reference to the extractor, or NULL if the decompressor could not be initialized.
+ */
+//--------------------------------------------------------------------------------------------------
+untar_Ref_t untar_Create
+(
+    const char* dirPath     ///< [IN] Existing directory to unpack into.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Push compressed bytes into an extractor.  Everything that can be decompressed and extracted from
+ * them is written to the file system before this returns.
+ *
+ * @return
+ *      - LE_OK if successful.
+ *      - LE_FORMAT_ERROR if the data is not a valid bzip2 compressed tarball.
+ *      - LE_IO_ERROR if writing to the file system failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_Write
+(
+    untar_Ref_t extractor,  ///< [IN] Extractor.
+    const void* dataPtr,    ///< [IN] Compressed bytes.
+    size_t dataLen          ///< [IN] Number of bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Tell an extractor that there's no more input and finish the extraction (e.g., apply the
+ * permissions of read-only directories).
+ *
+ * @return
+ *      - LE_OK if the whole tarball was extracted.
+ *      - LE_FORMAT_ERROR if the compressed stream or the tarball was truncated.
+ *      - LE_IO_ERROR if writing to the file system failed.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_Finish
+(
+    untar_Ref_t extractor   ///< [IN] Extractor.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes of decompressed tarball an extractor has processed.
+ *
+ * @return The byte count.
+ */
+//--------------------------------------------------------------------------------------------------
+uint64_t untar_GetTarBytes
+(
+    untar_Ref_t extractor   ///< [IN] Extractor.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that none of the directories leading to a path inside a directory is a symlink or a
+ * non-directory, and optionally create the missing ones.  Used on everything an extractor writes,
+ * and by anything else that later writes or removes files in the extraction directory.
+ *
+ * @return
+ *      - LE_OK if the path stays inside the directory.
+ *      - LE_FORMAT_ERROR if it goes through a symlink or a non-directory.
+ *      - LE_IO_ERROR if a directory could not be looked up or created.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t untar_CheckParentDirs
+(
+    const char* rootPathPtr,    ///< [IN] Trusted directory the path is in.
+    const char* pathPtr,        ///< [IN] Path starting with rootPathPtr, without "." or "..".
+    bool create                 ///< [IN] true to create the missing directories.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Delete an extractor.  Files already extracted are left in place.
+ */
+//--------------------------------------------------------------------------------------------------
+void untar_Delete
+(
+    untar_Ref_t extractor   ///< [IN] Extractor.
+);
+
+
+#endif // LEGATO_UPDATE_UNTAR_H_INCLUDE_GUARD
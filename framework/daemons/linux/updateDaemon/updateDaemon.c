@@ -2053,6 +2053,8 @@ COMPONENT_INIT
     le_timer_SetHandler(ProbationTimer, HandleProbationExpiry);
     le_timer_SetMsInterval(ProbationTimer, GetProbationPeriod());
 
+    updateUnpack_Init();
+
     // Make sure we can set file permissions properly.
     umask(0);
 
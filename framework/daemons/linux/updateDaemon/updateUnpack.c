@@ -15,7 +15,9 @@
 #include "interfaces.h"
 #include "limit.h"
 #include "updateUnpack.h"
-#include "pipeline.h"
+#include "untar.h"
+#include "md5.h"
+#include "delta.h"
 #include "fileDescriptor.h"
 #include "system.h"
 #include "app.h"
@@ -24,17 +26,20 @@
 /// An MD5 hash string is 32 characters long, plus a null terminator.
 #define MD5_STRING_BYTES 33
 
+/// Size of the buffer that payload bytes are read into.
+#define READ_BUFFER_BYTES (64 * 1024)
+
 /// File descriptor to read the update pack from.
 static int InputFd = -1;
 
 /// Reference to the FD Monitor for the input stream (NULL if not unpacking).
 static le_fdMonitor_Ref_t InputFdMonitor = NULL;
 
-/// Reference to an unpack pipeline (NULL if not unpacking).
-static pipeline_Ref_t Pipeline = NULL;
+/// Reference to the payload extractor (NULL if not unpacking).
+static untar_Ref_t Extractor = NULL;
 
-/// File descriptor connected to the input of a pipeline (-1 if not unpacking)
-static int PipelineFd = -1;
+/// MD5 hash of the payload bytes read so far.
+static md5_Ctx_t PayloadMd5Ctx;
 
 /// Function to be called to report progress.
 static updateUnpack_ProgressHandler_t ProgressFunc = NULL;
@@ -51,12 +56,24 @@ static char AppName[LIMIT_MAX_APP_NAME_BYTES];
 /// The MD5 hash obtained from a JSON header.
 static char Md5[MD5_STRING_BYTES]; ///< The system's MD5 hash.
 
+/// The payload's MD5 hash obtained from a JSON header (empty if not given).
+static char PayloadMd5[MD5_STRING_BYTES];
+
+/// MD5 hash of the installed app that a delta app update applies to (empty if not a delta).
+static char DeltaFromMd5[MD5_STRING_BYTES];
+
+/// Directory the current payload is being extracted into.
+static char UnpackPath[LIMIT_MAX_PATH_BYTES];
+
 /// # of bytes of payload following the JSON.
 static size_t PayloadSize;
 
-/// # of bytes of payload that have been copied to the unpack pipeline.
+/// # of bytes of payload that have been read from the input stream.
 static size_t PayloadBytesCopied;
 
+/// When the extraction of the current payload started.
+static le_clk_Time_t PayloadStartTime;
+
 /// Percentage complete on current task.
 static unsigned int PercentDone;
 
@@ -161,23 +178,18 @@ static void Reset
 
     DeleteFdMonitor();
 
-    // Close the pipes.
+    // Close the input pipe.
     if (InputFd != -1)
     {
         fd_Close(InputFd);
         InputFd = -1;
     }
-    if (PipelineFd != -1)
-    {
-        fd_Close(PipelineFd);
-        PipelineFd = -1;
-    }
 
-    // Delete the pipeline.
-    if (Pipeline != NULL)
+    // Delete the extractor.
+    if (Extractor != NULL)
     {
-        pipeline_Delete(Pipeline);
-        Pipeline = NULL;
+        untar_Delete(Extractor);
+        Extractor = NULL;
     }
 }
 
@@ -349,6 +361,8 @@ static void StartParsing
     Command[0] = '\0';
     AppName[0] = '\0';
     Md5[0] = '\0';
+    PayloadMd5[0] = '\0';
+    DeltaFromMd5[0] = '\0';
     PayloadSize = 0;
 
     // Set the state
@@ -361,36 +375,78 @@ static void StartParsing
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Completion callback for "tar xj" operation.
+ * Called when all of a payload has been read and extracted.
  */
 //--------------------------------------------------------------------------------------------------
 static void UntarDone
 (
-    pipeline_Ref_t pipeline,
-    int status
+    void
 )
 //--------------------------------------------------------------------------------------------------
 {
-    pipeline_Delete(Pipeline);
-    Pipeline = NULL;
+    le_result_t result = untar_Finish(Extractor);
+
+    le_clk_Time_t elapsed = le_clk_Sub(le_clk_GetRelativeTime(), PayloadStartTime);
+    long elapsedMs = elapsed.sec * 1000 + elapsed.usec / 1000;
 
-    if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+    LE_INFO("Payload of %zu bytes (%" PRIu64 " bytes unpacked) extracted in %ld ms.",
+            PayloadSize,
+            untar_GetTarBytes(Extractor),
+            elapsedMs);
+
+    untar_Delete(Extractor);
+    Extractor = NULL;
+
+    if (result == LE_FORMAT_ERROR)
     {
-        if (WIFEXITED(status))
-        {
-            LE_ERROR("Payload unpack pipeline failed with exit code: %d", WEXITSTATUS(status));
-        }
-        else if (WIFSIGNALED(status))
+        HandleFormatError();
+        return;
+    }
+    else if (result != LE_OK)
+    {
+        HandleInternalError();
+        return;
+    }
+
+    // Check the payload's integrity if the update pack told us what to expect.
+    char md5[MD5_STRING_BYTES];
+    md5_Final(&PayloadMd5Ctx, md5);
+
+    LE_INFO("Payload MD5: %s", md5);
+
+    if ((PayloadMd5[0] != '\0') && (strcmp(PayloadMd5, md5) != 0))
+    {
+        LE_ERROR("Malformed update pack (payload MD5 is %s, expected %s).", md5, PayloadMd5);
+        HandleFormatError();
+        return;
+    }
+
+    // A delta only holds the differences from the base app, so patch the base app's files and
+    // make sure we ended up with exactly the app the update pack describes.
+    if (DeltaFromMd5[0] != '\0')
+    {
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+        result = delta_Apply(UnpackPath, Md5);
+
+        elapsed = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+        if (result == LE_FORMAT_ERROR)
         {
-            LE_ERROR("Payload unpack pipeline killed by signal: %d", WTERMSIG(status));
+            LE_ERROR("Malformed update pack (delta from <%s> to <%s> failed).", DeltaFromMd5, Md5);
+            HandleFormatError();
+            return;
         }
-        else
+        else if (result != LE_OK)
         {
-            LE_ERROR("Payload unpack pipeline died for unknown reason (status: %d)", status);
+            HandleInternalError();
+            return;
         }
 
-        HandleInternalError();
-        return;
+        LE_INFO("Delta from <%s> to <%s> applied and verified in %ld ms.",
+                DeltaFromMd5,
+                Md5,
+                (long)(elapsed.sec * 1000 + elapsed.usec / 1000));
     }
 
     // If this update pack contains changes to individual apps,
@@ -463,19 +519,20 @@ static void SkipForwardDone
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Copy bytes from the input fd to the pipeline's input fd until the input fd's read buffer is
- * empty or we have copied all the payload bytes.
+ * Read bytes from the input fd and extract them until the input fd's read buffer is empty or we
+ * have read all the payload bytes.  Each byte is hashed as it goes by, so the payload is only read
+ * once.
  */
 //--------------------------------------------------------------------------------------------------
-static void CopyBytesToPipeline
+static void ExtractPayloadBytes
 (
     void
 )
 //--------------------------------------------------------------------------------------------------
 {
-    char buffer[1024];
+    static char buffer[READ_BUFFER_BYTES];
 
-    // Keep copying as much as we can until we've copied all the payload.
+    // Keep extracting as much as we can until we've read all the payload.
     while (PayloadBytesCopied < PayloadSize)
     {
         // Compute the number of bytes to read.
@@ -506,7 +563,8 @@ static void CopyBytesToPipeline
             }
 
             LE_ERROR("Failed to read from input stream (%m).");
-            goto error;
+            HandleInternalError();
+            return;
         }
 
         // Handle end of file.
@@ -515,31 +573,26 @@ static void CopyBytesToPipeline
             LE_ERROR("Unexpected early end of input after %zu bytes of %zu.",
                      PayloadBytesCopied,
                      PayloadSize);
-            goto error;
+            HandleInternalError();
+            return;
         }
 
-        // Write the bytes that we read.
-        ssize_t bytesWritten = 0;
-        ssize_t writeResult;
-        do
-        {
-            writeResult = write(PipelineFd, buffer + bytesWritten, readResult - bytesWritten);
+        md5_Update(&PayloadMd5Ctx, buffer, readResult);
 
-            // If some bytes were written, remember how many bytes, so we don't try to write the
-            // same bytes again if we have more to write.
-            if (writeResult > 0)
-            {
-                bytesWritten += writeResult;
-            }
-        }
-        while (   ((writeResult == -1) && (errno == EINTR)) // Retry if interrupted by a signal
-               || ((writeResult != -1) && (bytesWritten < readResult))  ); // Continue if not done
+        le_result_t result = untar_Write(Extractor, buffer, readResult);
 
-        // Check for errors.
-        if (writeResult == -1)
+        if (result == LE_FORMAT_ERROR)
         {
-            LE_ERROR("Failed to write to output stream (%m)");
-            goto error;
+            LE_ERROR("Malformed update pack (bad payload after %zu bytes of %zu).",
+                     PayloadBytesCopied,
+                     PayloadSize);
+            HandleFormatError();
+            return;
+        }
+        else if (result != LE_OK)
+        {
+            HandleInternalError();
+            return;
         }
 
         // Update the static progress variables and report progress to the client.
@@ -548,22 +601,15 @@ static void CopyBytesToPipeline
         ReportProgress();
     }
 
-    // If we have copied all the payload bytes to the pipeline's input, then we can stop
-    // monitoring the input fd now, close the pipeline input write pipe, and wait for the pipeline
-    // completion callback (UntarDone()).
+    // If we have read all the payload bytes, then we can stop monitoring the input fd now and
+    // wrap up the extraction.
     LE_INFO("Payload copied: %zu/%zu", PayloadBytesCopied, PayloadSize);
     LE_ASSERT(PayloadBytesCopied <= PayloadSize);
     if (PayloadBytesCopied == PayloadSize)
     {
         DeleteFdMonitor();
-        fd_Close(PipelineFd);
-        PipelineFd = -1;
+        UntarDone();
     }
-    return;
-
-error:
-
-    HandleInternalError();
 }
 
 
@@ -579,7 +625,7 @@ static void DiscardPayloadBytes
 )
 //--------------------------------------------------------------------------------------------------
 {
-    char buffer[1024];
+    static char buffer[READ_BUFFER_BYTES];
 
     // Keep reading as much as we can until we've read all the payload.
     while (PayloadBytesCopied < PayloadSize)
@@ -635,7 +681,7 @@ static void DiscardPayloadBytes
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Event handler for the input fd when copying bytes to a pipeline.
+ * Event handler for the input fd while reading a payload.
  */
 //--------------------------------------------------------------------------------------------------
 static void InputFdEventHandler
@@ -649,7 +695,7 @@ static void InputFdEventHandler
     {
         if (State == STATE_UNPACKING_PAYLOAD)
         {
-            CopyBytesToPipeline();
+            ExtractPayloadBytes();
         }
         else if (State == STATE_SKIPPING_PAYLOAD)
         {
@@ -668,31 +714,6 @@ static void InputFdEventHandler
 }
 
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Function that runs in the unpack pipeline's "tar" process.
- **/
-//--------------------------------------------------------------------------------------------------
-static int Untar
-(
-    void* param
-)
-//--------------------------------------------------------------------------------------------------
-{
-    const char* unpackDir = param;
-
-    // Close all open file descriptors except for stdin, stdout, and stderr.
-    // This ensures that we don't keep copies of things like the pipeline input write pipe open.
-    fd_CloseAllNonStd();
-
-    // Try bsdtar first.  If that fails, fallback to tar.
-    execl("/usr/bin/bsdtar", "bsdtar", "xjmop", "-f", "-", "-C", unpackDir, (char*)NULL);
-    execl("/bin/tar", "tar", "xjop", "-C", unpackDir, (char*)NULL);
-
-    LE_FATAL("Failed to exec tar (%m)");
-}
-
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Start unpacking a tarball.
@@ -707,12 +728,37 @@ static void StartUntar
     State = STATE_UNPACKING_PAYLOAD;
 
     PayloadBytesCopied = 0;
+    PayloadStartTime = le_clk_GetRelativeTime();
+
+    LE_ASSERT(le_utf8_Copy(UnpackPath, dirPath, sizeof(UnpackPath), NULL) == LE_OK);
 
-    // Create a pipeline: PipelineFd -> tar
-    Pipeline = pipeline_Create();
-    PipelineFd = pipeline_CreateInputPipe(Pipeline);
-    pipeline_Append(Pipeline, Untar, (void*)dirPath);
-    pipeline_Start(Pipeline, UntarDone);
+    // A delta is extracted on top of a copy of the app it was made from.
+    if (DeltaFromMd5[0] != '\0')
+    {
+        le_result_t result = delta_PrepBase(AppName, DeltaFromMd5, dirPath);
+
+        if (result == LE_NOT_FOUND)
+        {
+            LE_ERROR("Malformed update pack (delta base app <%s> not installed).", DeltaFromMd5);
+            HandleFormatError();
+            return;
+        }
+        else if (result == LE_FORMAT_ERROR)
+        {
+            LE_ERROR("Malformed update pack (delta base app <%s> is another app).", DeltaFromMd5);
+            HandleFormatError();
+            return;
+        }
+        else if (result != LE_OK)
+        {
+            HandleInternalError();
+            return;
+        }
+    }
+
+    // The payload is decompressed and extracted right here as it's read from the input fd.
+    Extractor = untar_Create(dirPath);
+    md5_Init(&PayloadMd5Ctx);
 
     fd_SetNonBlocking(InputFd);
 
@@ -809,6 +855,11 @@ static void JsonDone
             LE_ERROR("Malformed update pack (system update payload missing)");
             HandleFormatError();
         }
+        else if (DeltaFromMd5[0] != '\0')
+        {
+            LE_ERROR("Malformed update pack (only apps can be delta updated)");
+            HandleFormatError();
+        }
         // If everything looks good...
         else
         {
@@ -822,7 +873,7 @@ static void JsonDone
             system_PrepUnpackDir();
 
             // Unpack the system tarball.
-            // This is asynchronous and will call UntarDone() when finished.
+            // This is driven by the input fd and will call UntarDone() when finished.
             StartUntar(system_UnpackPath);
         }
     }
@@ -874,7 +925,7 @@ static void JsonDone
                     // Prepare the directory to unpack into.
                     app_PrepUnpackDir();
                     // Unpack the app tarball.
-                    // This is asynchronous and will call UntarDone() when finished.
+                    // This is driven by the input fd and will call UntarDone() when finished.
                     StartUntar(app_UnpackPath);
                 }
                 else
@@ -1045,6 +1096,36 @@ static void Md5EventHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * "payloadMd5" member parsing event function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PayloadMd5EventHandler
+(
+    le_json_Event_t event
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StringMemberEventHandler(event, PayloadMd5, sizeof(PayloadMd5), "payload MD5 hash");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * "deltaFromMd5" member parsing event function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DeltaFromMd5EventHandler
+(
+    le_json_Event_t event
+)
+//--------------------------------------------------------------------------------------------------
+{
+    StringMemberEventHandler(event, DeltaFromMd5, sizeof(DeltaFromMd5), "delta base MD5 hash");
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * "version" member parsing event function.
@@ -1156,6 +1237,14 @@ static void JsonEventHandler
             {
                 le_json_SetEventHandler(Md5EventHandler);
             }
+            else if (strcmp(memberName, "payloadMd5") == 0)
+            {
+                le_json_SetEventHandler(PayloadMd5EventHandler);
+            }
+            else if (strcmp(memberName, "deltaFromMd5") == 0)
+            {
+                le_json_SetEventHandler(DeltaFromMd5EventHandler);
+            }
             else if (strcmp(memberName, "name") == 0)
             {
                 le_json_SetEventHandler(NameEventHandler);
@@ -1192,6 +1281,21 @@ static void JsonEventHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the update unpacker.  Must be called before any other function in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void updateUnpack_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    untar_Init();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Starts processing an update pack.
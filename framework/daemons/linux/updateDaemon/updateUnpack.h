@@ -58,6 +58,17 @@ typedef enum
 updateUnpack_Type_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize the update unpacker.  Must be called before any other function in this module.
+ */
+//--------------------------------------------------------------------------------------------------
+void updateUnpack_Init
+(
+    void
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Start unpacking an update pack.  When sections of the update pack are unpacked, the
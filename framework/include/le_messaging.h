@@ -141,6 +141,10 @@
  *     msgPayloadPtr->... = ...; // <-- Populate message payload...
  * @endcode
  *
+ * By default, the whole payload buffer is sent.  If the message is only partly filled in, and the
+ * server can tell where its contents end, le_msg_SetPayloadSize() can be used to send only the
+ * part that is used.
+ *
  * If no response is required from the server, the client sends the message using le_msg_Send().
  * At this point, the client has handed off the message to the messaging system, and the messaging
  * system will delete the message automatically once it has finished sending it.
@@ -590,6 +594,21 @@
  * To work around this, you could move the service to another thread that that runs the Legato event
  * loop.
  *
+ * A service whose receive handler can block (e.g., waiting for a modem to respond) can be made
+ * multi-threaded by calling le_msg_SetServiceThreadCount().  The receive handler is then called by
+ * a pool of up to 99 worker threads.  The messages of a given session are always handled one at a
+ * time, in the order in which they were received, but the messages of different sessions are
+ * handled at the same time, so a slow request from one client doesn't hold up the others.  The
+ * receive handler must then be thread safe.
+ *
+ * le_msg_Respond() and le_msg_CloseSession() can be called from any thread on the server side.
+ * The messaging system hands the response or close request over to the thread that owns the
+ * service, which is the only one that does any I/O on the session's socket.
+ *
+ * When a client closes a session while a worker thread is still handling one of its messages, the
+ * service's close handlers are only called once the worker thread is done with the session, so
+ * they can safely free per-client data.  They are still called by the thread that owns the service.
+ *
  * @subsection c_messagingServerExample Sample Code
  *
  * @code
@@ -1332,6 +1351,27 @@ size_t le_msg_GetMaxPayloadSize
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the number of bytes at the start of the message payload that are in use, so that only
+ * those are sent.  By default, the whole payload buffer is sent.
+ *
+ * This applies to the next time the message is sent (including as a response).  Receiving a
+ * message resets it, so a server that responds by reusing the request message sends the whole
+ * payload buffer unless it sets the size again.
+ *
+ * @note The receiver gets a shorter message, and the rest of its payload buffer is undefined.
+ *       This is only suitable for protocols whose receivers don't look past the data the sender
+ *       put in the message, like the length-prefixed encoding produced by @ref c_pack.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t payloadSize              ///< [in] Number of bytes used (at most the maximum size).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the file descriptor to be sent with this message.
@@ -1551,6 +1591,23 @@ void le_msg_SetServiceRecvHandler
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes a service multi-threaded: messages received from clients are passed to the service's
+ * receive handler by a pool of worker threads, instead of the thread that owns the service.
+ *
+ * See @ref c_messagingServerMultithreading.
+ *
+ * @note    Server-only function.  Can only be called once for a given service.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetServiceThreadCount
+(
+    le_msg_ServiceRef_t serviceRef, ///< [in] Reference to the service.
+    size_t              threadCount ///< [in] Number of worker threads, from 1 to 99.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Associates an opaque context value (void pointer) with a given service that can be retrieved
@@ -351,8 +351,9 @@ static inline bool le_pack_PackReference
  * Pack a string into a buffer, incrementing the buffer pointer and decrementing the available
  * size.
  *
- * @note Always decrements available size according to the max possible size used, not actual size
- * used.  Will assert if provided string is larger than maximum allowable string.
+ * @note Decrements available size according to the actual size used, so only the bytes that
+ * were packed need to be sent.  Returns false if the string is longer than the maximum allowable
+ * string.
  */
 //--------------------------------------------------------------------------------------------------
 static inline bool le_pack_PackString
@@ -363,43 +364,36 @@ static inline bool le_pack_PackString
     uint32_t maxStringCount
 )
 {
-    size_t bytesCopied;
-
-    if (*sizePtr < (maxStringCount + sizeof(uint32_t)))
-    {
-        return false;
-    }
-
     if (!stringPtr)
     {
         return false;
     }
 
-    // First copy in the string -- up to maxStringCount bytes, allowing enough
-    // space at the begining for a uint32.
-    for (bytesCopied = 0;
-         bytesCopied < maxStringCount && stringPtr[bytesCopied];
-         ++bytesCopied)
+    // Never look further than one character past the maximum, so that an unterminated string
+    // can't be read past its end.
+    size_t stringLen = strnlen(stringPtr, (size_t)maxStringCount + 1);
+
+    // String was too long to fit in the buffer -- return false.
+    if (stringLen > maxStringCount)
     {
-        (*bufferPtr)[bytesCopied + sizeof(uint32_t)] = stringPtr[bytesCopied];
+        return false;
     }
 
-    // String was too long to fit in the buffer -- return false.
-    if (stringPtr[bytesCopied] != '\0')
+    if (*sizePtr < (stringLen + sizeof(uint32_t)))
     {
         return false;
     }
 
-    // Then go back and copy string size.  No loss of precision packing into a uint32
+    // First copy string size.  No loss of precision packing into a uint32
     // because maxStringCount is a uint32 or less.
-    bool packResult = le_pack_PackUint32(bufferPtr, sizePtr, bytesCopied);
+    bool packResult = le_pack_PackUint32(bufferPtr, sizePtr, stringLen);
     LE_ASSERT(packResult); // Should not fail -- have checked there's enough space above.
 
-    // Now increment buffer by size of string actually copied, and decrement available
-    // space by max which could have been copied.  This ensures out of space errors will
-    // be caught as soon as possible.
-    *bufferPtr = *bufferPtr + bytesCopied;
-    *sizePtr -= maxStringCount;
+    // Then copy in the string itself.
+    memcpy(*bufferPtr, stringPtr, stringLen);
+
+    *bufferPtr = *bufferPtr + stringLen;
+    *sizePtr -= stringLen;
 
     return true;
 }
@@ -423,8 +417,8 @@ static inline bool le_pack_PackArrayHeader
     size_t arrayMaxCount
 )
 {
-    if ((*sizePtr < arrayMaxCount*elementSize + sizeof(uint32_t)) ||
-        (arrayCount > arrayMaxCount))
+    if ((arrayCount > arrayMaxCount) ||
+        (*sizePtr < arrayCount*elementSize + sizeof(uint32_t)))
     {
         return false;
     }
@@ -439,8 +433,8 @@ static inline bool le_pack_PackArrayHeader
  * Pack an array into a buffer, incrementing the buffer pointer and decrementing the available
  * size.
  *
- * @note Always decrements available size according to the max possible size used, not actual size
- * used.  Will assert if provided string is larger than maximum allowable string.
+ * @note Decrements available size according to the actual size used.  Elements are never packed
+ * into more bytes than their in-memory size, which is what the available size is checked against.
  */
 //--------------------------------------------------------------------------------------------------
 #define LE_PACK_PACKARRAY(bufferPtr,                                    \
@@ -457,13 +451,10 @@ static inline bool le_pack_PackArrayHeader
         if (*(resultPtr))                                               \
         {                                                               \
             uint32_t i;                                                 \
-            size_t newSizePtr = *(sizePtr) - sizeof((arrayPtr)[0])*(arrayMaxCount); \
             for (i = 0; i < (arrayCount); ++i)                          \
             {                                                           \
                 LE_ASSERT(packFunc((bufferPtr), (sizePtr), (arrayPtr)[i])); \
             }                                                           \
-            LE_ASSERT(*(sizePtr) >= newSizePtr);                        \
-            *(sizePtr) = newSizePtr;                                    \
             *(resultPtr) = true;                                        \
         }                                                               \
     } while (0)
@@ -817,8 +808,8 @@ static inline bool le_pack_UnpackReference
  * Unpack a string from a buffer, incrementing the buffer pointer and decrementing the available
  * size.
  *
- * @note Always decrements available size according to the max possible size used, not actual size
- * used.  Will assert if provided string is larger than maximum allowable string.
+ * @note Decrements available size according to the actual size used.  Returns false if the string
+ * is larger than the maximum allowable string, or than the data left in the buffer.
  */
 //--------------------------------------------------------------------------------------------------
 static inline bool le_pack_UnpackString
@@ -832,11 +823,6 @@ static inline bool le_pack_UnpackString
 {
     uint32_t stringSize;
 
-    if (*sizePtr < (maxStringCount + sizeof(uint32_t)))
-    {
-        return false;
-    }
-
     // First get string size
     if (!le_pack_UnpackUint32(bufferPtr, sizePtr, &stringSize))
     {
@@ -844,7 +830,8 @@ static inline bool le_pack_UnpackString
     }
 
     if ((stringSize > maxStringCount) ||
-        (stringSize > bufferSize))
+        (stringSize > bufferSize) ||
+        (stringSize > *sizePtr))
     {
         return false;
     }
@@ -867,7 +854,7 @@ static inline bool le_pack_UnpackString
     stringPtr[stringSize] = '\0';
 
     *bufferPtr = *bufferPtr + stringSize;
-    *sizePtr -= maxStringCount;
+    *sizePtr -= stringSize;
 
     return true;
 }
@@ -891,13 +878,13 @@ static inline bool le_pack_UnpackArrayHeader
     size_t arrayMaxCount
 )
 {
-    if (*sizePtr < (arrayMaxCount*elementSize + sizeof(uint32_t)))
+    if (!le_pack_UnpackSize(bufferPtr, sizePtr, arrayCountPtr))
     {
         return false;
     }
 
-    LE_ASSERT(le_pack_UnpackSize(bufferPtr, sizePtr, arrayCountPtr));
-    if (*arrayCountPtr > arrayMaxCount)
+    if ((*arrayCountPtr > arrayMaxCount) ||
+        (*sizePtr < *arrayCountPtr*elementSize))
     {
         return false;
     }
@@ -915,8 +902,8 @@ static inline bool le_pack_UnpackArrayHeader
  * Unpack an array into from buffer, incrementing the buffer pointer and decrementing the available
  * size.
  *
- * @note Always decrements available size according to the max possible size used, not actual size
- * used.  Will assert if provided string is larger than maximum allowable string.
+ * @note Decrements available size according to the actual size used.  Elements are never packed
+ * into more bytes than their in-memory size, which is what the available size is checked against.
  */
 //--------------------------------------------------------------------------------------------------
 #define LE_PACK_UNPACKARRAY(bufferPtr,                                  \
@@ -936,13 +923,10 @@ static inline bool le_pack_UnpackArrayHeader
         else                                                            \
         {                                                               \
             uint32_t i;                                                 \
-            size_t newSizePtr = *(sizePtr) - sizeof((arrayPtr)[0])*(arrayMaxCount); \
             for (i = 0; i < *(arrayCountPtr); ++i)                      \
             {                                                           \
                 LE_ASSERT(unpackFunc((bufferPtr), (sizePtr), &(arrayPtr)[i])); \
             }                                                           \
-            LE_ASSERT(*(sizePtr) >= newSizePtr);                        \
-            *(sizePtr) = newSizePtr;                                    \
             *(resultPtr) = true;                                        \
         }                                                               \
     } while (0)
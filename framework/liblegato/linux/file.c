@@ -10,6 +10,7 @@
 //--------------------------------------------------------------------------------------------------
 
 #include <sys/sendfile.h>
+#include <sys/ioctl.h>
 #include "legato.h"
 #include "smack.h"
 #include "fileDescriptor.h"
@@ -17,6 +18,17 @@
 #include "fileSystem.h"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * ioctl used to ask the file system to share (reflink) data blocks between two files.  Not all C
+ * library headers define it yet.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Checks whether or not a file exists at a given file system path.
@@ -533,8 +545,8 @@ static le_result_t CreateDir
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Copy a file.  This function copies the source file's owner, permissions and extended attributes
- * to the destination file as well.
+ * Copy a file, optionally asking the file system to share the source's data blocks with the
+ * destination (a "reflink") rather than duplicating them.
  *
  * @return - LE_OK if the copy was successful.
  *         - LE_NOT_PERMITTED if either the source or destination paths are not files or could not
@@ -543,11 +555,13 @@ static le_result_t CreateDir
  *         - LE_NOT_FOUND if source file or the destination directory does not exist.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t file_Copy
+static le_result_t CopyFile
 (
-    const char* sourcePathPtr,  ///< [IN] Copy from this path...
-    const char* destPathPtr,    ///< [IN] To this path.
-    const char* smackLabelPtr   ///< [IN] If not NULL, the file will have this smack label set.
+    const char* sourcePathPtr,      ///< [IN] Copy from this path...
+    const char* destPathPtr,        ///< [IN] To this path.
+    const char* smackLabelPtr,      ///< [IN] If not NULL, the file will have this smack label set.
+    file_SnapshotStats_t* statsPtr  ///< [IN/OUT] If not NULL, try to reflink the file and
+                                    ///           account for the work done here.
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -618,6 +632,18 @@ le_result_t file_Copy
         return result;
     }
 
+    // If the file system supports it, share the data blocks instead of writing them again.
+    if (   (statsPtr != NULL)
+        && (ioctl(writeFd, FICLONE, readFd) == 0))
+    {
+        statsPtr->cloneCount++;
+
+        fd_Close(readFd);
+        fd_Close(writeFd);
+
+        return LE_OK;
+    }
+
     // Get the kernel to copy the data over.  It may or may not happen in one go, so keep trying
     // until the whole file has been written or we error out.
     ssize_t sizeWritten = 0;
@@ -641,6 +667,12 @@ le_result_t file_Copy
         sizeWritten += nextWritten;
     }
 
+    if (statsPtr != NULL)
+    {
+        statsPtr->copyCount++;
+        statsPtr->bytesWritten += sizeWritten;
+    }
+
     fd_Close(readFd);
     fd_Close(writeFd);
 
@@ -650,11 +682,8 @@ le_result_t file_Copy
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Copy a batch of files recursively from one directory into another.  This function copies the
- * source files' owner, permissions and extended attributes to the destination files as well.
- *
- * @note Does not copy mounted files or any files under mounted directories.  Does not copy anything
- *       if the source path directory is empty.
+ * Copy a file.  This function copies the source file's owner, permissions and extended attributes
+ * to the destination file as well.
  *
  * @return - LE_OK if the copy was successful.
  *         - LE_NOT_PERMITTED if either the source or destination paths are not files or could not
@@ -663,13 +692,90 @@ le_result_t file_Copy
  *         - LE_NOT_FOUND if source file or the destination directory does not exist.
  */
 //--------------------------------------------------------------------------------------------------
-le_result_t file_CopyRecursive
+le_result_t file_Copy
 (
-    const char* sourcePathPtr,  ///< [IN] Copy recursively from this path...
+    const char* sourcePathPtr,  ///< [IN] Copy from this path...
     const char* destPathPtr,    ///< [IN] To this path.
     const char* smackLabelPtr   ///< [IN] If not NULL, the file will have this smack label set.
 )
 //--------------------------------------------------------------------------------------------------
+{
+    return CopyFile(sourcePathPtr, destPathPtr, smackLabelPtr, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Put a regular file into a snapshot.  Files that are not writeable are hard linked, falling back
+ * to a reflink and then to a plain copy if the link can't be made (e.g., because the source and
+ * destination are on different mounts).
+ *
+ * @return - LE_OK if successful.
+ *         - Otherwise, the same error codes as file_Copy().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SnapshotFile
+(
+    const char* sourcePathPtr,      ///< [IN] Source file.
+    const char* destPathPtr,        ///< [IN] Destination file.
+    bool isWriteable,               ///< [IN] true if the file may be modified in place later.
+    bool* linkAllowedPtr,           ///< [IN/OUT] Cleared once the file system refuses a hard link.
+    file_SnapshotStats_t* statsPtr  ///< [IN/OUT] Statistics to update.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!isWriteable && *linkAllowedPtr)
+    {
+        if (link(sourcePathPtr, destPathPtr) == 0)
+        {
+            statsPtr->linkCount++;
+            return LE_OK;
+        }
+
+        // Don't bother asking again for every other file in the tree if links can't be made here.
+        if (   (errno == EXDEV)
+            || (errno == EPERM)
+            || (errno == EOPNOTSUPP))
+        {
+            LE_DEBUG("Can't hard link '%s' to '%s' (%m), copying instead.",
+                     sourcePathPtr,
+                     destPathPtr);
+            *linkAllowedPtr = false;
+        }
+        else if (errno != EMLINK)
+        {
+            LE_CRIT("Error when linking file '%s' to '%s'. (%m)", sourcePathPtr, destPathPtr);
+            return LE_IO_ERROR;
+        }
+    }
+
+    return CopyFile(sourcePathPtr, destPathPtr, NULL, statsPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a tree of files from one directory into another.  Used for both plain recursive copies and
+ * snapshots.
+ *
+ * @return - LE_OK if the copy was successful.
+ *         - LE_NOT_PERMITTED if either the source or destination paths are not files or could not
+ *           be opened.
+ *         - LE_IO_ERROR if an IO error occurs during the copy operation.
+ *         - LE_NOT_FOUND if source file or the destination directory does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CopyTree
+(
+    const char* sourcePathPtr,              ///< [IN] Copy recursively from this path...
+    const char* destPathPtr,                ///< [IN] To this path.
+    const char* smackLabelPtr,              ///< [IN] If not NULL, the files get this smack label.
+    file_IsWriteableFunc_t isWriteableFunc, ///< [IN] Snapshot only: classifies files, or NULL to
+                                            ///       treat every file as writeable.
+    file_SnapshotStats_t* statsPtr          ///< [IN/OUT] NULL for a plain copy, or the statistics
+                                            ///           to update when taking a snapshot.
+)
+//--------------------------------------------------------------------------------------------------
 {
     // Make sure that the source file exists.
     struct stat sourceStatus;
@@ -685,6 +791,15 @@ le_result_t file_CopyRecursive
     // If the source is a file, then just copy it.
     if (S_ISREG(sourceStatus.st_mode))
     {
+        if (statsPtr != NULL)
+        {
+            bool linkAllowed = true;
+            bool isWriteable = (isWriteableFunc == NULL)
+                               || isWriteableFunc(le_path_GetBasenamePtr(sourcePathPtr, "/"));
+
+            return SnapshotFile(sourcePathPtr, destPathPtr, isWriteable, &linkAllowed, statsPtr);
+        }
+
         return file_Copy(sourcePathPtr, destPathPtr, smackLabelPtr);
     }
 
@@ -718,6 +833,7 @@ le_result_t file_CopyRecursive
 
     // Iterate through the directory and copy the files to the destination.
     size_t sourcePathLen = strlen(sourcePathPtr);
+    bool linkAllowed = (smackLabelPtr == NULL);
 
     char* pathArrayPtr[] = { (char*)sourcePathPtr, NULL };
     FTS* ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL, NULL);
@@ -778,7 +894,30 @@ le_result_t file_CopyRecursive
             case FTS_F:
                 if (!fs_IsMountPoint(entPtr->fts_path))
                 {
-                    result = file_Copy(entPtr->fts_path, newPath, smackLabelPtr);
+                    if (statsPtr != NULL)
+                    {
+                        // Path relative to the root of the tree being copied, without the
+                        // leading '/'.
+                        const char* relPathPtr = entPtr->fts_path + sourcePathLen;
+                        while (*relPathPtr == '/')
+                        {
+                            relPathPtr++;
+                        }
+
+                        bool isWriteable = (isWriteableFunc == NULL)
+                                           || isWriteableFunc(relPathPtr);
+
+                        result = SnapshotFile(entPtr->fts_path,
+                                              newPath,
+                                              isWriteable,
+                                              &linkAllowed,
+                                              statsPtr);
+                    }
+                    else
+                    {
+                        result = file_Copy(entPtr->fts_path, newPath, smackLabelPtr);
+                    }
+
                     if (result != LE_OK)
                     {
                         goto cleanup;
@@ -863,6 +1002,67 @@ le_result_t file_CopyRecursive
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copy a batch of files recursively from one directory into another.  This function copies the
+ * source files' owner, permissions and extended attributes to the destination files as well.
+ *
+ * @note Does not copy mounted files or any files under mounted directories.  Does not copy anything
+ *       if the source path directory is empty.
+ *
+ * @return - LE_OK if the copy was successful.
+ *         - LE_NOT_PERMITTED if either the source or destination paths are not files or could not
+ *           be opened.
+ *         - LE_IO_ERROR if an IO error occurs during the copy operation.
+ *         - LE_NOT_FOUND if source file or the destination directory does not exist.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t file_CopyRecursive
+(
+    const char* sourcePathPtr,  ///< [IN] Copy recursively from this path...
+    const char* destPathPtr,    ///< [IN] To this path.
+    const char* smackLabelPtr   ///< [IN] If not NULL, the file will have this smack label set.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return CopyTree(sourcePathPtr, destPathPtr, smackLabelPtr, NULL, NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a snapshot of a directory tree.  The result looks like file_CopyRecursive() had been used,
+ * but files that the classification function reports as not writeable are hard linked to the
+ * source rather than copied, and writeable files are reflinked where the file system supports it.
+ * Anything that can't be linked or reflinked is copied.
+ *
+ * @warning Hard linked files share their contents, owner, permissions and extended attributes with
+ *          the source, so only files that are never modified in place may be reported as
+ *          not writeable.
+ *
+ * @note Like file_CopyRecursive(), does not copy mounted files or any files under mounted
+ *       directories.
+ *
+ * @return - LE_OK if the snapshot was successful.
+ *         - Otherwise, the same error codes as file_CopyRecursive().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t file_SnapshotRecursive
+(
+    const char* sourcePathPtr,              ///< [IN] Snapshot recursively from this path...
+    const char* destPathPtr,                ///< [IN] To this path.
+    file_IsWriteableFunc_t isWriteableFunc, ///< [IN] Classifies files.  NULL means every file is
+                                            ///       treated as writeable.
+    file_SnapshotStats_t* statsPtr          ///< [IN/OUT] Statistics are added to this.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(statsPtr != NULL);
+
+    return CopyTree(sourcePathPtr, destPathPtr, NULL, isWriteableFunc, statsPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Rename a file or directory.
@@ -135,6 +135,63 @@ le_result_t file_CopyRecursive
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Statistics about the work done while taking a snapshot of a directory tree.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t linkCount;       ///< Number of files hard linked to the source.
+    size_t cloneCount;      ///< Number of files reflinked (sharing data blocks with the source).
+    size_t copyCount;       ///< Number of files whose data had to be copied.
+    off_t bytesWritten;     ///< Number of bytes of file data copied.
+}
+file_SnapshotStats_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function used to classify the files in a snapshot.
+ *
+ * @return true if the file may be modified in place after the snapshot is taken (and so must get
+ *         its own copy), false if it is never modified in place and can be shared.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef bool (*file_IsWriteableFunc_t)
+(
+    const char* relPathPtr  ///< [IN] Path of the file relative to the root of the snapshot.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a snapshot of a directory tree.  The result looks like file_CopyRecursive() had been used,
+ * but files that the classification function reports as not writeable are hard linked to the
+ * source rather than copied, and writeable files are reflinked where the file system supports it.
+ * Anything that can't be linked or reflinked is copied.
+ *
+ * @warning Hard linked files share their contents, owner, permissions and extended attributes with
+ *          the source, so only files that are never modified in place may be reported as
+ *          not writeable.
+ *
+ * @note Like file_CopyRecursive(), does not copy mounted files or any files under mounted
+ *       directories.
+ *
+ * @return - LE_OK if the snapshot was successful.
+ *         - Otherwise, the same error codes as file_CopyRecursive().
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t file_SnapshotRecursive
+(
+    const char* sourcePathPtr,              ///< [IN] Snapshot recursively from this path...
+    const char* destPathPtr,                ///< [IN] To this path.
+    file_IsWriteableFunc_t isWriteableFunc, ///< [IN] Classifies files.  NULL means every file is
+                                            ///       treated as writeable.
+    file_SnapshotStats_t* statsPtr          ///< [IN/OUT] Statistics are added to this.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Rename a file or directory.
@@ -15,6 +15,7 @@
 #include "messagingInterface.h"
 #include "messagingSession.h"
 #include "fileDescriptor.h"
+#include "thread.h"
 
 
 // =======================================
@@ -89,6 +90,35 @@ static le_mem_PoolRef_t ClientInterfacePoolRef;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t  HandlerEventPoolRef;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of worker threads of a multi-threaded service, and the number of characters of
+ * the worker index appended to the service name to name the threads ("-99").
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_WORKER_THREAD_COUNT     99
+#define WORKER_THREAD_SUFFIX_LEN    3
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Worker thread of a multi-threaded service.  See le_msg_SetServiceThreadCount().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t   link;           ///< Used to link into the Service's worker list.
+    le_thread_Ref_t threadRef;      ///< The thread.
+    size_t          msgCount;       ///< Messages queued to or being handled by the thread.
+}
+ServiceWorker_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Service Worker objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t ServiceWorkerPoolRef;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Mutex used to protect data structures in this module from multi-threaded race conditions.
@@ -239,6 +269,8 @@ static msgInterface_Service_t* CreateService
     // Initialize the open handlers dls
     servicePtr->openListPtr = LE_DLS_LIST_INIT;
 
+    servicePtr->workerList = LE_DLS_LIST_INIT;
+
     ServiceObjMapChangeCount++;
     le_hashmap_Put(ServiceMapRef, &servicePtr->interface.id, servicePtr);
 
@@ -362,6 +394,24 @@ static msgInterface_ClientInterface_t* GetClient
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes a multi-threaded service's worker thread exit.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ */
+//--------------------------------------------------------------------------------------------------
+static void StopServiceWorker
+(
+    void* param1Ptr,    ///< [IN] Not used.
+    void* param2Ptr     ///< [IN] Not used.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_thread_Exit(NULL);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Destructor function that runs when a Service object is about to be returned back to the
@@ -402,6 +452,19 @@ static void ServiceDestructor
 
         le_mem_Release(openEventPtr);
     }
+
+    // Stop the worker threads once they are done with what they are running.  This may run in
+    // one of them, when it drops the last reference to a session of this service at the end of
+    // HandleMessageInWorker(), so they are asked to exit from their event loop instead of being
+    // cancelled.
+    while ((linkPtr = le_dls_Pop(&servicePtr->workerList)) != NULL)
+    {
+        ServiceWorker_t* workerPtr = CONTAINER_OF(linkPtr, ServiceWorker_t, link);
+
+        le_event_QueueFunctionToThread(workerPtr->threadRef, StopServiceWorker, NULL, NULL);
+
+        le_mem_Release(workerPtr);
+    }
 }
 
 
@@ -729,6 +792,138 @@ static void CloseAllSessions
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of a multi-threaded service's worker threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ServiceWorkerMain
+(
+    void* contextPtr    ///< Semaphore to post when ready to run queued functions.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sem_Post(contextPtr);
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Passes a message received from a client to a service's receive handler, in one of the service's
+ * worker threads.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ *          The Service object has a reference held on it by DispatchToWorker().
+ */
+//--------------------------------------------------------------------------------------------------
+static void HandleMessageInWorker
+(
+    void* param1Ptr,    ///< [IN] Reference to the Service object.
+    void* param2Ptr     ///< [IN] Reference to the received message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_ServiceRef_t serviceRef = param1Ptr;
+    le_msg_MessageRef_t msgRef = param2Ptr;
+    le_msg_SessionRef_t sessionRef = le_msg_GetSession(msgRef);
+
+    // The handler is likely to release the message, and with it, possibly the last reference to
+    // the session.
+    le_mem_AddRef(sessionRef);
+    bool isCloseDeferred;
+
+    pthread_setspecific(ThreadLocalRxMsgKey, msgRef);
+
+    serviceRef->recvHandler(msgRef, serviceRef->recvContextPtr);
+
+    pthread_setspecific(ThreadLocalRxMsgKey, NULL);
+
+    LOCK
+
+    ((ServiceWorker_t*)sessionRef->workerPtr)->msgCount--;
+    sessionRef->workerMsgCount--;
+
+    // If the session closed while its messages were being handled, its close handlers have been
+    // waiting for this thread to be done with them.
+    isCloseDeferred = (sessionRef->isCloseDeferred && (sessionRef->workerMsgCount == 0));
+    if (isCloseDeferred)
+    {
+        sessionRef->isCloseDeferred = false;
+    }
+
+    le_mem_Release(serviceRef);
+
+    UNLOCK
+
+    if (isCloseDeferred)
+    {
+        msgSession_FinishDeferredClose(sessionRef);
+    }
+
+    le_mem_Release(sessionRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queues a message received from a client to one of a service's worker threads.
+ *
+ * All the messages of a session go to the same worker thread for as long as any of them is queued
+ * to or being handled by it, so that they are handled in the order in which they were received.
+ * Once a session has nothing left in a worker thread, its next message goes to whichever worker
+ * thread has the least messages queued.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DispatchToWorker
+(
+    le_msg_ServiceRef_t serviceRef, ///< [IN] Reference to the Service object.
+    le_msg_MessageRef_t msgRef      ///< [IN] Message reference for the received message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_SessionRef_t sessionRef = le_msg_GetSession(msgRef);
+    ServiceWorker_t* workerPtr;
+
+    LOCK
+
+    if (sessionRef->workerMsgCount == 0)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&serviceRef->workerList);
+
+        workerPtr = CONTAINER_OF(linkPtr, ServiceWorker_t, link);
+
+        while ((workerPtr->msgCount > 0)
+               && ((linkPtr = le_dls_PeekNext(&serviceRef->workerList, linkPtr)) != NULL))
+        {
+            ServiceWorker_t* otherWorkerPtr = CONTAINER_OF(linkPtr, ServiceWorker_t, link);
+
+            if (otherWorkerPtr->msgCount < workerPtr->msgCount)
+            {
+                workerPtr = otherWorkerPtr;
+            }
+        }
+
+        sessionRef->workerPtr = workerPtr;
+    }
+    else
+    {
+        workerPtr = sessionRef->workerPtr;
+    }
+
+    workerPtr->msgCount++;
+    sessionRef->workerMsgCount++;
+
+    // Keep the service (and its worker threads) until the message has been handled.
+    le_mem_AddRef(serviceRef);
+
+    UNLOCK
+
+    le_event_QueueFunctionToThread(workerPtr->threadRef, HandleMessageInWorker, serviceRef, msgRef);
+}
+
+
 // =======================================
 //  PROTECTED (INTER-MODULE) FUNCTIONS
 // =======================================
@@ -816,6 +1011,9 @@ void msgInterface_Init
     HandlerEventPoolRef = le_mem_CreatePool("HandlerEventPool", sizeof(SessionEventHandler_t));
     le_mem_ExpandPool(HandlerEventPoolRef, MAX_EXPECTED_SERVICES*6);
 
+    // Create the pool of Service Worker objects.
+    ServiceWorkerPoolRef = le_mem_CreatePool("MessagingServiceWorkers", sizeof(ServiceWorker_t));
+
     // Create safe reference map for add references.
     HandlersRefMap = le_ref_CreateMap("HandlersRef", MAX_EXPECTED_SERVICES*6);
 
@@ -989,6 +1187,43 @@ void msgInterface_CallCloseHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a closing session's close handlers must wait for a worker thread of a
+ * multi-threaded service to be done with the session's messages.  Otherwise, a close handler could
+ * free per-client data that a worker thread is still using.
+ *
+ * @return true if they must.  msgSession_FinishDeferredClose() is then called once the worker
+ *         thread is done, and the session and service are kept until then.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_DeferCloseHandler
+(
+    le_msg_ServiceRef_t serviceRef,
+    le_msg_SessionRef_t sessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    bool isDeferred;
+
+    LOCK
+
+    isDeferred = (sessionRef->workerMsgCount > 0);
+    if (isDeferred)
+    {
+        sessionRef->isCloseDeferred = true;
+
+        // Released by msgSession_FinishDeferredClose().
+        le_mem_AddRef(sessionRef);
+        le_mem_AddRef(serviceRef);
+    }
+
+    UNLOCK
+
+    return isDeferred;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Dispatches a message received from a client to a service's server.
@@ -1001,8 +1236,13 @@ void msgInterface_ProcessMessageFromClient
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Pass the message to the server's registered receive handler, if there is one.
-    if (serviceRef->recvHandler != NULL)
+    // Pass the message to the server's registered receive handler, if there is one.  Handlers of
+    // multi-threaded services are run by worker threads.
+    if ((serviceRef->recvHandler != NULL) && !le_dls_IsEmpty(&serviceRef->workerList))
+    {
+        DispatchToWorker(serviceRef, msgRef);
+    }
+    else if (serviceRef->recvHandler != NULL)
     {
         // Set the thread-local received message reference so it can be retrieved by the handler.
         pthread_setspecific(ThreadLocalRxMsgKey, msgRef);
@@ -1253,6 +1493,83 @@ void le_msg_SetServiceRecvHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes a service multi-threaded: messages received from clients are passed to the service's
+ * receive handler by a pool of worker threads, instead of the thread that owns the service.
+ *
+ * The messages of a given session are still handled one at a time, in the order in which they were
+ * received, but the messages of different sessions can be handled at the same time.
+ *
+ * @note    This is a server-only function.  It can only be called once for a given service.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetServiceThreadCount
+(
+    le_msg_ServiceRef_t serviceRef, ///< [in] Reference to the service.
+    size_t              threadCount ///< [in] Number of worker threads.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LE_FATAL_IF(serviceRef->serverThread != le_thread_GetCurrent(),
+                "Service (%s:%s) not owned by calling thread.",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+
+    LE_FATAL_IF(!le_dls_IsEmpty(&serviceRef->workerList),
+                "Service (%s:%s) already has worker threads.",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef));
+
+    LE_FATAL_IF((threadCount == 0) || (threadCount > MAX_WORKER_THREAD_COUNT),
+                "Service (%s:%s) cannot have %zu worker threads (1 to %d).",
+                serviceRef->interface.id.name,
+                le_msg_GetProtocolIdStr(serviceRef->interface.id.protocolRef),
+                threadCount,
+                MAX_WORKER_THREAD_COUNT);
+
+    // Messages can only be queued to a thread once it has initialized its event loop.
+    le_sem_Ref_t readySemRef = le_sem_Create("MsgWorkerReady", 0);
+
+    unsigned int i;
+    for (i = 0; i < threadCount; i++)
+    {
+        // Truncate the service name so that the worker index always fits.  (The modulo does not
+        // change the index, it tells the compiler how many digits it has.)
+        char threadName[MAX_THREAD_NAME_SIZE];
+        char suffix[WORKER_THREAD_SUFFIX_LEN + 1];
+        int suffixLen = snprintf(suffix, sizeof(suffix), "-%u", i % (MAX_WORKER_THREAD_COUNT + 1));
+
+        LE_FATAL_IF((suffixLen < 0) || (suffixLen >= (int)sizeof(suffix)),
+                    "Invalid worker thread index %u.",
+                    i);
+
+        le_utf8_Copy(threadName,
+                     serviceRef->interface.id.name,
+                     sizeof(threadName) - WORKER_THREAD_SUFFIX_LEN,
+                     NULL);
+        le_result_t result = le_utf8_Append(threadName, suffix, sizeof(threadName), NULL);
+
+        LE_FATAL_IF(result != LE_OK, "Worker thread name too long for '%s'.", threadName);
+
+        ServiceWorker_t* workerPtr = le_mem_ForceAlloc(ServiceWorkerPoolRef);
+
+        workerPtr->link = LE_DLS_LINK_INIT;
+        workerPtr->msgCount = 0;
+        workerPtr->threadRef = le_thread_Create(threadName, ServiceWorkerMain, readySemRef);
+
+        le_thread_Start(workerPtr->threadRef);
+        le_sem_Wait(readySemRef);
+
+        LOCK
+        le_dls_Queue(&serviceRef->workerList, &workerPtr->link);
+        UNLOCK
+    }
+
+    le_sem_Delete(readySemRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Associates an opaque context value (void pointer) with a given service that can be retrieved
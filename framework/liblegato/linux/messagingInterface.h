@@ -94,6 +94,9 @@ typedef struct le_msg_Service
 
     le_dls_List_t                   closeListPtr; ///< open List: list of close session handlers
                                                   ///  called when a session is opened
+
+    le_dls_List_t                   workerList;  ///< Worker threads that messages are handled by,
+                                                 ///  or empty if handled by the server thread.
 }
 msgInterface_Service_t;
 
@@ -258,6 +261,22 @@ void msgInterface_CallCloseHandler
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a closing session's close handlers must wait for a worker thread of a
+ * multi-threaded service to be done with the session's messages.
+ *
+ * @return true if they must.  msgSession_FinishDeferredClose() is then called once the worker
+ *         thread is done, and the session and service are kept until then.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgInterface_DeferCloseHandler
+(
+    le_msg_ServiceRef_t serviceRef,
+    le_msg_SessionRef_t sessionRef
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Dispatches a message received from a client to a service's server.
@@ -158,11 +158,17 @@ le_result_t msgMessage_Send
         msgPtr->clientServer.server.responseFd = -1;
     }
 
+    size_t payloadSize = msgPtr->payloadSize;
+    if (payloadSize == 0)
+    {
+        payloadSize = le_msg_GetMaxPayloadSize(msgPtr);
+    }
+
     // The first bytes come from our transaction ID and the rest (if any)
     // from our Message object's payload section, which comes right after the transaction ID.
     return unixSocket_SendMsg(  socketFd,
                                 &msgPtr->txnId,
-                                sizeof(msgPtr->txnId) + le_msg_GetMaxPayloadSize(msgPtr),
+                                sizeof(msgPtr->txnId) + payloadSize,
                                 msgPtr->fd,
                                 false   ); // Don't send process credentials.
 }
@@ -199,6 +205,9 @@ le_result_t msgMessage_Receive
         msgRef->clientServer.server.responseFd = -1;
     }
 
+    // Whatever is sent back in this message has to set its own size.
+    msgRef->payloadSize = 0;
+
     return result;
 }
 
@@ -273,6 +282,7 @@ le_msg_MessageRef_t le_msg_CreateMsg
 
     msgPtr->fd = -1;
     msgPtr->txnId = 0;
+    msgPtr->payloadSize = 0;
     memset(msgPtr->payload, 0, le_msg_GetProtocolMaxMsgSize(protocolRef));
 
     return msgPtr;
@@ -372,6 +382,35 @@ size_t le_msg_GetMaxPayloadSize
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the number of bytes at the start of the message payload that are in use, so that only
+ * those are sent.  By default, the whole payload buffer is sent.
+ *
+ * This applies to the next time the message is sent (including as a response).  Receiving a
+ * message resets it.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t payloadSize              ///< [in] Number of bytes used (at most the maximum size).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t maxPayloadSize = le_msg_GetMaxPayloadSize(msgRef);
+
+    if (payloadSize > maxPayloadSize)
+    {
+        LE_FATAL("Payload size %zu is larger than the maximum of %zu.", payloadSize, maxPayloadSize);
+    }
+
+    // Zero means "the whole buffer", so an empty payload is sent in full.  That's no worse than
+    // before, and keeps freshly created and received messages simple to initialize.
+    msgRef->payloadSize = payloadSize;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the file descriptor to be sent with this message.
@@ -41,6 +41,7 @@ typedef struct le_msg_Message
     clientServer;
 
     int                         fd;         ///< File descriptor to send or received (-1 = no fd)
+    size_t                      payloadSize;///< Payload bytes to send (0 = whole payload buffer).
     void*                       txnId;      ///< Safe reference value used as a transaction ID.
     void*                       payload[0]; ///< Variable-length payload buffer appears at the end.
 }
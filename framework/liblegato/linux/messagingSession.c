@@ -448,6 +448,10 @@ static msgSession_Session_t* CreateSession
     sessionPtr->closeHandler = NULL;
     sessionPtr->closeContextPtr = NULL;
 
+    sessionPtr->workerPtr = NULL;
+    sessionPtr->workerMsgCount = 0;
+    sessionPtr->isCloseDeferred = false;
+
     sessionPtr->interfaceRef = interfaceRef;
 
     SessionObjListChangeCount++;
@@ -470,24 +474,39 @@ static void CloseSession
 )
 //--------------------------------------------------------------------------------------------------
 {
+    bool isCloseDeferred = false;
+
     sessionPtr->state = LE_MSG_SESSION_STATE_CLOSED;
 
-    // Always notify the server on close.
+    // Always notify the server on close.  If a worker thread of a multi-threaded service is still
+    // handling the session's messages, the close handlers are only called once it is done.
     if (sessionPtr->interfaceRef->interfaceType == LE_MSG_INTERFACE_SERVER)
     {
+        isCloseDeferred = msgInterface_DeferCloseHandler(
+                                            (le_msg_ServiceRef_t)sessionPtr->interfaceRef,
+                                            sessionPtr);
+
         // Note: This needs to be done before the FD is closed, in case someone wants to check the
         //       credentials in their callback.
-        msgInterface_CallCloseHandler((le_msg_ServiceRef_t)sessionPtr->interfaceRef, sessionPtr);
+        if (!isCloseDeferred)
+        {
+            msgInterface_CallCloseHandler((le_msg_ServiceRef_t)sessionPtr->interfaceRef,
+                                          sessionPtr);
+        }
     }
 
-    // Delete the socket and the FD Monitor.
+    // Delete the socket and the FD Monitor.  A deferred close keeps the socket for the close
+    // handlers, and closes it after them.
     if (sessionPtr->fdMonitorRef != NULL)
     {
         le_fdMonitor_Delete(sessionPtr->fdMonitorRef);
         sessionPtr->fdMonitorRef = NULL;
     }
-    fd_Close(sessionPtr->socketFd);
-    sessionPtr->socketFd = -1;
+    if (!isCloseDeferred)
+    {
+        fd_Close(sessionPtr->socketFd);
+        sessionPtr->socketFd = -1;
+    }
 
     // If there are any messages stranded on the transmit queue, the pending transaction list,
     // or the receive queue, clean them all up.
@@ -1501,6 +1520,84 @@ static void TriggerDeferredProcessing
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a message that another thread asked to send through a session, from the thread that owns
+ * the session.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ *          The Message object holds a reference to the Session object, so the Session can't have
+ *          been deleted, although it may have been closed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SendQueuedMessage
+(
+    void* param1Ptr,    ///< [IN] Pointer to a Session object.
+    void* param2Ptr     ///< [IN] Reference to the Message object.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_SendMessage(param1Ptr, param2Ptr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Closes a server-side session that another thread asked to close, from the thread that owns the
+ * session.
+ *
+ * @note    This function is called by the Event Loop as a "queued function".
+ */
+//--------------------------------------------------------------------------------------------------
+static void CloseQueuedSession
+(
+    void* param1Ptr,    ///< [IN] Pointer to a Session object.
+    void* param2Ptr     ///< not used
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_Session_t* sessionPtr = param1Ptr;
+
+    // The session may have been closed (and therefore deleted) since this function was queued.
+    if (sessionPtr->state != LE_MSG_SESSION_STATE_CLOSED)
+    {
+        DeleteSession(sessionPtr);
+    }
+
+    // Drop the reference that was taken when this function was queued.
+    le_mem_Release(sessionPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Calls the close handlers of a server-side session whose close was deferred while a worker thread
+ * was handling its messages, then closes its socket.
+ *
+ * @note    This function is called by the Event Loop as a "queued function", in the thread that
+ *          owns the session.  The Session and Service objects have references held on them by
+ *          msgInterface_DeferCloseHandler().
+ */
+//--------------------------------------------------------------------------------------------------
+static void CallDeferredCloseHandlers
+(
+    void* param1Ptr,    ///< [IN] Pointer to a Session object.
+    void* param2Ptr     ///< not used
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgSession_Session_t* sessionPtr = param1Ptr;
+
+    msgInterface_CallCloseHandler((le_msg_ServiceRef_t)sessionPtr->interfaceRef, sessionPtr);
+
+    fd_Close(sessionPtr->socketFd);
+    sessionPtr->socketFd = -1;
+
+    msgInterface_Release(sessionPtr->interfaceRef);
+    le_mem_Release(sessionPtr);
+}
+
+
 // =======================================
 //  PROTECTED (INTER-MODULE) FUNCTIONS
 // =======================================
@@ -1588,11 +1685,20 @@ void msgSession_SendMessage
 //--------------------------------------------------------------------------------------------------
 {
     // Only the thread that is handling events on this socket is allowed to send messages through
-    // this socket.  This prevents multi-threaded races.
-    /// @todo Allow other threads to send?
-    LE_FATAL_IF(le_thread_GetCurrent() != sessionRef->threadRef,
-                "Attempt to send by thread that doesn't own session '%s'.",
-                le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+    // this socket.  This prevents multi-threaded races.  On the server side, other threads (such
+    // as the worker threads of a multi-threaded service) hand the message over to that thread.
+    if (le_thread_GetCurrent() != sessionRef->threadRef)
+    {
+        LE_FATAL_IF(sessionRef->interfaceRef->interfaceType != LE_MSG_INTERFACE_SERVER,
+                    "Attempt to send by thread that doesn't own session '%s'.",
+                    le_msg_GetInterfaceName(le_msg_GetSessionInterface(sessionRef)));
+
+        le_event_QueueFunctionToThread(sessionRef->threadRef,
+                                       SendQueuedMessage,
+                                       sessionRef,
+                                       messageRef);
+        return;
+    }
 
     if (sessionRef->state != LE_MSG_SESSION_STATE_OPEN)
     {
@@ -1821,6 +1927,28 @@ le_msg_SessionRef_t msgSession_CreateServerSideSession
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finishes closing a server-side session whose close handlers were deferred by
+ * msgInterface_DeferCloseHandler(), now that no worker thread is handling its messages anymore.
+ *
+ * The close handlers are called by the thread that owns the session, as they would have been if
+ * the close had not been deferred.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgSession_FinishDeferredClose
+(
+    le_msg_SessionRef_t sessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_event_QueueFunctionToThread(sessionRef->threadRef,
+                                   CallDeferredCloseHandlers,
+                                   sessionRef,
+                                   NULL);
+}
+
+
 // =======================================
 //  PUBLIC API FUNCTIONS
 // =======================================
@@ -2090,10 +2218,23 @@ void le_msg_CloseSession
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // On the server side, sessions are automatically deleted when they close.
+    // On the server side, sessions are automatically deleted when they close.  Only the thread
+    // that owns the session can do that, so other threads (such as the worker threads of a
+    // multi-threaded service) ask it to.
     if (sessionRef->interfaceRef->interfaceType == LE_MSG_INTERFACE_SERVER)
     {
-        DeleteSession(sessionRef);
+        if (le_thread_GetCurrent() != sessionRef->threadRef)
+        {
+            le_mem_AddRef(sessionRef);
+            le_event_QueueFunctionToThread(sessionRef->threadRef,
+                                           CloseQueuedSession,
+                                           sessionRef,
+                                           NULL);
+        }
+        else
+        {
+            DeleteSession(sessionRef);
+        }
     }
     else if (sessionRef->state != LE_MSG_SESSION_STATE_CLOSED)
     {
@@ -61,6 +61,13 @@ typedef struct le_msg_Session
     void*                           openContextPtr; ///< Open handler's context pointer.
     le_msg_SessionEventHandler_t    closeHandler;   ///< Close handler function.
     void*                           closeContextPtr;///< Close handler's context pointer.
+
+    void*                           workerPtr;      ///< Worker thread of a multi-threaded service
+                                                    ///  that handles this session's messages.
+    size_t                          workerMsgCount; ///< Number of this session's messages queued
+                                                    ///  to or being handled by the worker thread.
+    bool                            isCloseDeferred;///< true if the close handlers are waiting for
+                                                    ///  the worker thread to be done.
 }
 msgSession_Session_t;
 
@@ -206,4 +213,16 @@ le_msg_SessionRef_t msgSession_CreateServerSideSession
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finishes closing a server-side session whose close handlers were deferred by
+ * msgInterface_DeferCloseHandler(), now that no worker thread is handling its messages anymore.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgSession_FinishDeferredClose
+(
+    le_msg_SessionRef_t sessionRef
+);
+
+
 #endif // LE_MESSAGING_SESSION_H_INCLUDE_GUARD
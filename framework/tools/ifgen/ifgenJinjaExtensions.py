@@ -67,6 +67,15 @@ def IsRemoveHandlerFunction(functionObj):
     return (isinstance(functionObj, interfaceIR.EventFunction)
             and functionObj.name.startswith("Remove"))
 
+def IsIdempotentFunction(functionObj):
+    """Idempotent functions are marked @idempotent in their documentation, and have no callback or
+    file parameters.  Identical calls to them can be answered with the same response."""
+    return ('@idempotent' in [ line.strip() for line in functionObj.comment.split(u'\n') ]
+            and not IsEventFunction(functionObj)
+            and not HasCallbackFunction(functionObj)
+            and not any(parameter.apiType == interfaceIR.FILE_TYPE
+                        for parameter in functionObj.parameters))
+
 ### Other helper tests
 @contextfunction
 def AnyFilter(context, iterable, filterName):
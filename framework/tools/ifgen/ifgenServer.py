@@ -0,0 +1,297 @@
+#
+# Persistent ifgen server, and the client side that hands requests to it.
+#
+# Starting ifgen takes much longer than generating the code for a typical .api file, because most
+# of the time goes into loading the interpreter, jinja2 and the ANTLR generated parser.  A build
+# runs ifgen for every client and server of every API, so when the IFGEN_SERVER environment
+# variable holds the path of a Unix socket, ifgen hands its command line to a server listening on
+# that socket instead of doing the work itself, starting the server first if there isn't one.
+#
+# The server has everything loaded already.  It forks a child to handle each request, so that
+# requests run in parallel (ninja runs many ifgens at once) and can't leave any state behind.  It
+# exits after being idle for IDLE_TIMEOUT seconds, or as soon as it sees that the ifgen sources
+# changed.
+#
+# Whenever a request can't be served (no server can be started, the socket path is too long, the
+# server went away, ...) the client just returns and ifgen runs as usual.
+#
+# Copyright (C) Sierra Wireless Inc.
+#
+
+import os
+import sys
+import errno
+import json
+import socket
+import time
+
+
+# Path of the ifgen main program.  Clients and servers of different ifgen installations must
+# never talk to each other.
+IfgenPath = os.path.realpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), 'ifgen'))
+
+# Number of seconds the server waits for a request before exiting.
+IDLE_TIMEOUT = 30
+
+# Number of seconds a client waits for a server it just started to accept connections.
+START_TIMEOUT = 10
+
+# Longest path that fits in a sockaddr_un, not counting the terminating null character.
+MAX_SOCKET_PATH_LEN = 107
+
+
+def ReadAll(conn):
+    """Read from a connection until the other end shuts it down."""
+    chunks = []
+    while True:
+        chunk = conn.recv(65536)
+        if not chunk:
+            return b''.join(chunks)
+        chunks.append(chunk)
+
+
+def ToStr(value):
+    """JSON decoding gives unicode strings, where ifgen expects byte strings (in Python 2)."""
+    if isinstance(value, list):
+        return [ ToStr(item) for item in value ]
+    if sys.version_info[0] < 3 and isinstance(value, unicode):
+        return value.encode('utf-8')
+    return value
+
+
+#---------------------------------------------------------------------------------------------------
+# Client
+#---------------------------------------------------------------------------------------------------
+
+def Connect(socketPath):
+    """Connect to the server, or return None if there isn't one listening."""
+    conn = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        conn.connect(socketPath)
+    except socket.error:
+        conn.close()
+        return None
+    return conn
+
+
+def StartServer(socketPath):
+    """Start a server in the background, fully detached from the build (ninja waits for the
+    command's output pipe to be closed, so the server mustn't inherit it)."""
+    import subprocess
+
+    devNull = open(os.devnull, 'r+')
+    subprocess.Popen([ sys.executable, '-E', IfgenPath, '--server', socketPath ],
+                     stdin=devNull,
+                     stdout=devNull,
+                     stderr=devNull,
+                     close_fds=True,
+                     preexec_fn=os.setsid)
+    devNull.close()
+
+
+def ConnectToNewServer(socketPath):
+    """Start a server and connect to it.  When a build starts, many clients find there is no
+    server at the same time, so only one of them starts it while the others wait."""
+    import fcntl
+
+    startLockFile = open(socketPath + '.start', 'w')
+    fcntl.flock(startLockFile, fcntl.LOCK_EX)
+
+    try:
+        # Another client may have started it while this one was waiting.
+        conn = Connect(socketPath)
+        if conn is not None:
+            return conn
+
+        StartServer(socketPath)
+
+        deadline = time.time() + START_TIMEOUT
+        while conn is None and time.time() < deadline:
+            time.sleep(0.01)
+            conn = Connect(socketPath)
+
+        return conn
+    finally:
+        startLockFile.close()
+
+
+def RunClient(socketPath, argList):
+    """Have the server run ifgen with the given arguments, then exit with its exit code.
+    Returns if the request could not be served, in which case the caller must do the work."""
+    if len(socketPath) > MAX_SOCKET_PATH_LEN:
+        return
+
+    conn = Connect(socketPath)
+
+    if conn is None:
+        conn = ConnectToNewServer(socketPath)
+
+        if conn is None:
+            return
+
+    request = json.dumps({ 'ifgen':   IfgenPath,
+                           'cwd':     os.getcwd(),
+                           'argv':    argList,
+                           'options': os.environ.get('IFGEN_OPTIONS', '') })
+
+    try:
+        conn.sendall(request.encode('utf-8'))
+        conn.shutdown(socket.SHUT_WR)
+        reply = ReadAll(conn)
+    except socket.error:
+        return
+    finally:
+        conn.close()
+
+    # An empty reply means the server refused the request, or died handling it.
+    if not reply:
+        return
+
+    reply = json.loads(reply.decode('utf-8'))
+
+    sys.stdout.write(ToStr(reply['stdout']))
+    sys.stderr.write(ToStr(reply['stderr']))
+    sys.stdout.flush()
+    sys.stderr.flush()
+
+    sys.exit(reply['status'])
+
+
+#---------------------------------------------------------------------------------------------------
+# Server
+#---------------------------------------------------------------------------------------------------
+
+def GetSourceTime():
+    """Get the latest modification time of the ifgen modules that have been loaded."""
+    ifgenDir = os.path.dirname(IfgenPath) + os.sep
+    latest = os.path.getmtime(IfgenPath)
+
+    for module in list(sys.modules.values()):
+        path = getattr(module, '__file__', None)
+        if not path or not os.path.abspath(path).startswith(ifgenDir):
+            continue
+        if path.endswith('.pyc') or path.endswith('.pyo'):
+            path = path[:-1]
+        try:
+            latest = max(latest, os.path.getmtime(path))
+        except OSError:
+            # Deleted, which is a change too.
+            return None
+
+    return latest
+
+
+def GetExitStatus(code):
+    """Convert the code of a SystemExit exception to the process exit status it stands for."""
+    if code is None:
+        return 0
+    if isinstance(code, int):
+        return code
+    sys.stderr.write('%s\n' % code)
+    return 1
+
+
+def HandleRequest(conn, mainFunc):
+    """Run ifgen's main function for one request, in a child process of the server, and send the
+    results back to the client.  Never returns."""
+    import logging
+    import signal
+    import traceback
+    from StringIO import StringIO
+
+    signal.signal(signal.SIGCHLD, signal.SIG_DFL)
+
+    try:
+        conn.settimeout(None)
+        request = json.loads(ReadAll(conn).decode('utf-8'))
+
+        # Clients of another ifgen installation that uses the same socket are refused.
+        if request['ifgen'] != IfgenPath:
+            os._exit(0)
+
+        os.chdir(request['cwd'])
+        sys.argv = [ IfgenPath ] + ToStr(request['argv'])
+        os.environ['IFGEN_OPTIONS'] = ToStr(request['options'])
+
+        # Capture everything ifgen prints, including the log, whose handler has kept a reference
+        # to the server's stderr.
+        sys.stdout = StringIO()
+        sys.stderr = StringIO()
+        for handler in logging.getLogger().handlers:
+            handler.stream = sys.stderr
+
+        try:
+            mainFunc()
+            status = 0
+        except SystemExit as e:
+            status = GetExitStatus(e.code)
+        except Exception:
+            traceback.print_exc()
+            status = 1
+
+        reply = json.dumps({ 'status': status,
+                             'stdout': sys.stdout.getvalue(),
+                             'stderr': sys.stderr.getvalue() })
+
+        conn.sendall(reply.encode('utf-8'))
+    except Exception:
+        # The client sees an empty reply and does the work itself.
+        pass
+
+    os._exit(0)
+
+
+def RunServer(socketPath, mainFunc):
+    """Serve requests on the given socket until idle for IDLE_TIMEOUT seconds."""
+    import fcntl
+    import signal
+
+    # Only one server per socket.  The lock is held until this process exits, so a new server can't
+    # remove the socket of one that is still serving.
+    lockFile = open(socketPath + '.lock', 'w')
+    try:
+        fcntl.flock(lockFile, fcntl.LOCK_EX | fcntl.LOCK_NB)
+    except IOError:
+        return
+
+    try:
+        os.unlink(socketPath)
+    except OSError as e:
+        if e.errno != errno.ENOENT:
+            raise
+
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(socketPath)
+    server.listen(128)
+    server.settimeout(IDLE_TIMEOUT)
+
+    # Children are never waited for.
+    signal.signal(signal.SIGCHLD, signal.SIG_IGN)
+
+    sourceTime = GetSourceTime()
+
+    try:
+        while True:
+            try:
+                conn, address = server.accept()
+            except socket.timeout:
+                break
+            except socket.error as e:
+                if e.errno == errno.EINTR:
+                    continue
+                raise
+
+            # Requests made after the sources changed are refused, and the client does the work
+            # itself.  The next client starts an up to date server.
+            if GetSourceTime() != sourceTime:
+                conn.close()
+                break
+
+            if os.fork() == 0:
+                server.close()
+                HandleRequest(conn, mainFunc)
+
+            conn.close()
+    finally:
+        server.close()
+        os.unlink(socketPath)
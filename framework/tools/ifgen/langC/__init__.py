@@ -12,6 +12,12 @@ def AddLangArgumentGroup(parser):
                         action='store_true',
                         default=False,
                         help='generate asynchronous-style server functions')
+    parser.add_argument('--async-client',
+                        dest="asyncClient",
+                        action='store_true',
+                        default=False,
+                        help='also generate asynchronous client functions, which take a '
+                             'completion callback instead of blocking')
 
 # Custom filters needed for C templates
 Filters = { 'FormatHeaderComment': codeGenHelpers.FormatHeaderComment,
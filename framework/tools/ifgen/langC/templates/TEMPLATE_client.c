@@ -8,6 +8,27 @@
  #  Copyright (C) Sierra Wireless Inc.
  #}
 {%- import 'pack.templ' as pack -%}
+{%- macro CheckInputs(parameterList) %}
+    {%- for parameter in parameterList if parameter is InParameter %}
+    {%- if parameter is StringParameter %}
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- elif parameter is ArrayParameter %}
+    if ( (NULL == {{parameter|FormatParameterName}}) &&
+         (0 != {{parameter|GetParameterCount}}) )
+    {
+        LE_FATAL("If {{parameter|FormatParameterName}} is NULL "
+                 "{{parameter|GetParameterCount}} must be zero");
+    }
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- endif %}
+    {%- endfor %}
+{%- endmacro -%}
 /*
  * ====================== WARNING ======================
  *
@@ -639,25 +660,7 @@ error_unpack:
     {%- endif %}
 
     // Range check values, if appropriate
-    {%- for parameter in function.parameters if parameter is InParameter %}
-    {%- if parameter is StringParameter %}
-    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
-    {
-        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
-    }
-    {%- elif parameter is ArrayParameter %}
-    if ( (NULL == {{parameter|FormatParameterName}}) &&
-         (0 != {{parameter|GetParameterCount}}) )
-    {
-        LE_FATAL("If {{parameter|FormatParameterName}} is NULL "
-                 "{{parameter|GetParameterCount}} must be zero");
-    }
-    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
-    {
-        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
-    }
-    {%- endif %}
-    {%- endfor %}
+    {{- CheckInputs(function.parameters) }}
 
 
     // Create a new message object and get the message buffer
@@ -699,6 +702,7 @@ error_unpack:
     // Send a request to the server and get the response.
     LE_DEBUG("Sending message to server and waiting for response : %ti bytes sent",
              _msgBufPtr-_msgPtr->buffer);
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     _responseMsgRef = le_msg_RequestSyncResponse(_msgRef);
     // It is a serious error if we don't get a valid response from the server.  Call disconnect
     // handler (if one is defined) to allow cleanup
@@ -759,6 +763,156 @@ error_unpack:
     {%- endif %}
     {%- endwith %}
 }
+{%- if args.asyncClient and function is not EventFunction and function is not HasCallbackFunction %}
+
+
+// This function parses the response to {{apiName}}_{{function.name}}Async() and then calls the
+// completion callback, which is stored in a client data object.
+static void _Handle_{{apiName}}_{{function.name}}Response
+(
+    le_msg_MessageRef_t _msgRef,
+    void* _dataPtr
+)
+{
+    {%- with error_unpack_label=Labeler("error_unpack") %}
+    _ClientData_t* _clientDataPtr = _dataPtr;
+    {{apiName}}_{{function.name}}CompletionFunc_t _completionFunc =
+        ({{apiName}}_{{function.name}}CompletionFunc_t)_clientDataPtr->handlerPtr;
+    void* contextPtr = _clientDataPtr->contextPtr;
+
+    le_mem_Release(_clientDataPtr);
+
+    // The transaction ended without a response.  The session close handler deals with the
+    // session going away.
+    if (_msgRef == NULL)
+    {
+        LE_DEBUG("No response from server to {{apiName}}_{{function.name}}Async()");
+        return;
+    }
+
+    _Message_t* _msgPtr = le_msg_GetPayloadPtr(_msgRef);
+    __attribute__((unused)) uint8_t* _msgBufPtr = _msgPtr->buffer;
+    __attribute__((unused)) size_t _msgBufSize = _MAX_MSG_SIZE;
+    {%- if function.returnType %}
+
+    // Unpack the result first
+    {{function.returnType|FormatType}} _result;
+    if (!{{function.returnType|UnpackFunction}}( &_msgBufPtr, &_msgBufSize, &_result ))
+    {
+        goto {{error_unpack_label}};
+    }
+    {%- endif %}
+
+    // Storage for the "out" parameters, all of which were requested.
+    {%- for parameter in function.parameters if parameter is OutParameter %}
+    {%- if parameter is StringParameter %}
+    char {{parameter.name}}Buffer[{{parameter.maxCount + 1}}];
+    char* {{parameter|FormatParameterName}} = {{parameter.name}}Buffer;
+    size_t {{parameter.name}}Size = sizeof({{parameter.name}}Buffer);
+    {%- elif parameter is ArrayParameter %}
+    {{parameter.apiType|FormatType}} {{parameter.name}}Buffer[{{parameter.maxCount}}];
+    {{parameter.apiType|FormatType}}* {{parameter|FormatParameterName}} = {{parameter.name}}Buffer;
+    size_t {{parameter.name}}Size = {{parameter.maxCount}};
+    size_t* {{parameter.name}}SizePtr = &{{parameter.name}}Size;
+    {%- else %}
+    {{parameter.apiType|FormatType}} {{parameter.name}};
+    {{parameter.apiType|FormatType}}* {{parameter|FormatParameterName}} = &{{parameter.name}};
+    {%- endif %}
+    {%- endfor %}
+
+    // Unpack any "out" parameters
+    {%- call pack.UnpackOutputs(function.parameters) %}
+        goto {{error_unpack_label}};
+    {%- endcall %}
+
+    // Release the message object, now that all results/output has been copied.
+    le_msg_ReleaseMsg(_msgRef);
+
+    if (_completionFunc != NULL)
+    {
+        _completionFunc(
+            {%- if function.returnType %}_result, {% endif %}
+            {%- for parameter in function|CAPIParameters if parameter is OutParameter %}
+            {{- parameter|FormatParameterName(forceInput=True)}}, {% endfor -%}
+            contextPtr);
+    }
+
+    return;
+    {%- if error_unpack_label.IsUsed() %}
+
+error_unpack:
+    LE_FATAL("Unexpected response from server.");
+    {%- endif %}
+    {%- endwith %}
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous version of {{apiName}}_{{function.name}}().  Sends the request and returns without
+ * waiting for the response, so several requests can be outstanding at once.  The completion
+ * callback is called by the calling thread's event loop when the response arrives.  String and
+ * array "out" parameters are always requested at their maximum size.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_{{function.name}}Async
+(
+    {%- for parameter in function|CAPIParameters
+        if parameter is InParameter
+           and not (parameter is SizeParameter and parameter.relatedParameter is OutParameter) %}
+    {{parameter|FormatParameter}},
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    {{apiName}}_{{function.name}}CompletionFunc_t completionFunc,
+        ///< [IN] Called with the results; NULL if they aren't needed.
+    void* contextPtr
+        ///< [IN] Passed to the completion callback.
+)
+{
+    le_msg_MessageRef_t _msgRef;
+    _Message_t* _msgPtr;
+
+    // Will not be used if no data is sent to server.
+    __attribute__((unused)) uint8_t* _msgBufPtr;
+    __attribute__((unused)) size_t _msgBufSize;
+
+    // Range check values, if appropriate
+    {{- CheckInputs(function.parameters) }}
+
+
+    // Create a new message object and get the message buffer
+    _msgRef = le_msg_CreateMsg(GetCurrentSessionRef());
+    _msgPtr = le_msg_GetPayloadPtr(_msgRef);
+    _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
+    _msgBufPtr = _msgPtr->buffer;
+    _msgBufSize = _MAX_MSG_SIZE;
+
+    // Request all of the outputs, since they go to the completion callback.
+    {%- if any(function.parameters, "OutParameter") %}
+    uint32_t _requiredOutputs = 0;
+    {%- for output in function.parameters if output is OutParameter %}
+    _requiredOutputs |= (1 << {{loop.index0}});
+    {%- endfor %}
+    LE_ASSERT(le_pack_PackUint32(&_msgBufPtr, &_msgBufSize, _requiredOutputs));
+    {%- endif %}
+
+    // Pack the input parameters
+    {{- pack.PackInputs(function.parameters, requestMaxOutputs=True) }}
+
+    // Keep the completion callback in a client data object until the response comes back.
+    _ClientData_t* _clientDataPtr = le_mem_ForceAlloc(_ClientDataPool);
+    _clientDataPtr->handlerPtr = (le_event_HandlerFunc_t)completionFunc;
+    _clientDataPtr->contextPtr = contextPtr;
+    _clientDataPtr->handlerRef = NULL;
+    _clientDataPtr->callersThreadRef = le_thread_GetCurrent();
+
+    // Send the request to the server.  The response is handled by this thread's event loop.
+    LE_DEBUG("Sending message to server : %ti bytes sent", _msgBufPtr-_msgPtr->buffer);
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
+    le_msg_RequestResponse(_msgRef, _Handle_{{apiName}}_{{function.name}}Response, _clientDataPtr);
+}
+{%- endif %}
 {%- endfor %}
 
 
@@ -99,3 +99,50 @@ void {{apiName}}_DisconnectService
     void
 );
 {%- endblock %}
+{% block FunctionDeclaration %}
+{{- super() }}
+{%- if args.asyncClient and function is not EventFunction and function is not HasCallbackFunction %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion callback for {{apiName}}_{{function.name}}Async().  Gets the result and "out"
+ * parameters of {{apiName}}_{{function.name}}().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*{{apiName}}_{{function.name}}CompletionFunc_t)
+(
+    {%- if function.returnType %}
+    {{function.returnType|FormatType}} _result,
+    {%- endif %}
+    {%- for parameter in function|CAPIParameters if parameter is OutParameter %}
+    {{parameter|FormatParameter(forceInput=True)}},
+        ///<{{parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    void* contextPtr
+        ///< Context pointer passed to {{apiName}}_{{function.name}}Async().
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous version of {{apiName}}_{{function.name}}().  Sends the request and returns without
+ * waiting for the response, so several requests can be outstanding at once.  The completion
+ * callback is called by the calling thread's event loop when the response arrives.  String and
+ * array "out" parameters are always requested at their maximum size.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_{{function.name}}Async
+(
+    {%- for parameter in function|CAPIParameters
+        if parameter is InParameter
+           and not (parameter is SizeParameter and parameter.relatedParameter is OutParameter) %}
+    {{parameter|FormatParameter}},
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%- endfor %}
+    {{apiName}}_{{function.name}}CompletionFunc_t completionFunc,
+        ///< [IN] Called with the results; NULL if they aren't needed.
+    void* contextPtr
+        ///< [IN] Passed to the completion callback.
+);
+{%- endif %}
+{%- endblock %}
@@ -63,6 +63,9 @@ typedef struct {{apiName}}_ServerCmd
     le_msg_MessageRef_t msgRef;           ///< Reference to the message
     le_dls_Link_t cmdLink;                ///< Link to server cmd objects
     uint32_t requiredOutputs;           ///< Outputs which must be sent (if any)
+    {%- if any(functions, "IdempotentFunction") %}
+    void* coalesceEntryPtr;             ///< Request coalescing entry (if any)
+    {%- endif %}
 } {{apiName}}_ServerCmd_t;
 {%- endif %}
 
@@ -107,6 +110,278 @@ __attribute__((unused)) static pthread_mutex_t _Mutex = PTHREAD_MUTEX_INITIALIZE
 
 /// Unlocks the mutex.
 #define _UNLOCK  LE_ASSERT(pthread_mutex_unlock(&_Mutex) == 0);
+{%- if any(functions, "IdempotentFunction") %}
+
+
+//--------------------------------------------------------------------------------------------------
+// Request coalescing
+//
+// Calls to functions marked @idempotent in the .api file are not handled again while an identical
+// call is being handled: they wait for its response, which is then sent to them too.  Optionally,
+// responses are also kept for a while, and sent in response to identical calls made in the
+// meantime (see {{apiName}}_SetResponseCacheTime()).
+//
+// Calls are identical if their request messages are the same up to the end of the inputs, which
+// includes the function ID and which outputs are needed.
+//--------------------------------------------------------------------------------------------------
+
+/// Maximum number of different calls being handled or cached at the same time.  Calls beyond that
+/// are handled normally.
+#define _COALESCE_MAX_ENTRIES 16
+
+/// Maximum number of identical calls waiting for the response to a call, which an asynchronous
+/// server may never send.  Calls beyond that are handled normally.
+#define _COALESCE_MAX_WAITERS 8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A call being handled, or whose response is cached.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;                 ///< Link in _CoalesceList.
+    le_dls_List_t waiterList;           ///< Identical calls waiting for the response.
+    size_t        waiterCount;          ///< Number of calls in waiterList.
+    bool          isDone;               ///< true once the response is known (i.e., cached).
+    le_clk_Time_t expiryTime;           ///< Time after which the cached response is stale.
+    size_t        requestSize;          ///< Number of bytes used in the request.
+    size_t        responseSize;         ///< Number of bytes used in the response.
+    uint8_t       request[sizeof(_Message_t)];  ///< Request message payload.
+    uint8_t       response[sizeof(_Message_t)]; ///< Response message payload.
+}
+_CoalesceEntry_t;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A call waiting for the response to an identical one.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;           ///< Link in the entry's waiterList.
+    le_msg_MessageRef_t msgRef;         ///< Request message, to be responded to.
+}
+_CoalesceWaiter_t;
+
+static le_mem_PoolRef_t _CoalesceEntryPool;     ///< Pool of _CoalesceEntry_t.
+static le_mem_PoolRef_t _CoalesceWaiterPool;    ///< Pool of _CoalesceWaiter_t.
+
+/// Calls being handled, and cached responses.  Protected by _Mutex.
+static le_dls_List_t _CoalesceList = LE_DLS_LIST_INIT;
+
+/// Number of entries in _CoalesceList.
+static size_t _CoalesceEntryCount = 0;
+
+/// How long responses are cached.  Zero means they aren't.
+static le_clk_Time_t _CoalesceCacheTime = { 0, 0 };
+
+/// Statistics.  Protected by _Mutex.
+static uint64_t _CoalesceCallCount = 0;     ///< Calls to idempotent functions.
+static uint64_t _CoalesceMergedCount = 0;   ///< Calls that waited for an identical call.
+static uint64_t _CoalesceCacheHitCount = 0; ///< Calls answered with a cached response.
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look for a call identical to the one just received.
+ *
+ * @return
+ *  - LE_OK if the call has to be handled.  *entryPtrPtr is set to the entry to pass its response
+ *    to with CoalesceResponse(), or to NULL if there's no room for a new entry or for another
+ *    waiter on an identical call.
+ *  - LE_DUPLICATE if the call has been, or will be, responded to with the response to an identical
+ *    one.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CoalesceRequest
+(
+    le_msg_MessageRef_t msgRef,         ///< Request message.
+    size_t requestSize,                 ///< Number of bytes used in the request.
+    _CoalesceEntry_t** entryPtrPtr      ///< [OUT] Entry to pass the response to.
+)
+{
+    const uint8_t* requestPtr = le_msg_GetPayloadPtr(msgRef);
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    _CoalesceEntry_t* entryPtr = NULL;
+
+    _LOCK
+
+    _CoalesceCallCount++;
+
+    // Drop stale responses, and look for an identical call.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&_CoalesceList);
+    while (linkPtr != NULL)
+    {
+        _CoalesceEntry_t* currentPtr = CONTAINER_OF(linkPtr, _CoalesceEntry_t, link);
+        linkPtr = le_dls_PeekNext(&_CoalesceList, linkPtr);
+
+        if (currentPtr->isDone && !le_clk_GreaterThan(currentPtr->expiryTime, now))
+        {
+            le_dls_Remove(&_CoalesceList, &currentPtr->link);
+            _CoalesceEntryCount--;
+            le_mem_Release(currentPtr);
+        }
+        else if ((currentPtr->requestSize == requestSize)
+                 && (memcmp(currentPtr->request, requestPtr, requestSize) == 0))
+        {
+            entryPtr = currentPtr;
+        }
+    }
+
+    if ((entryPtr != NULL) && !entryPtr->isDone && (entryPtr->waiterCount >= _COALESCE_MAX_WAITERS))
+    {
+        _UNLOCK
+
+        *entryPtrPtr = NULL;
+        return LE_OK;
+    }
+
+    if (entryPtr == NULL)
+    {
+        if (_CoalesceEntryCount < _COALESCE_MAX_ENTRIES)
+        {
+            entryPtr = le_mem_ForceAlloc(_CoalesceEntryPool);
+            entryPtr->link = LE_DLS_LINK_INIT;
+            entryPtr->waiterList = LE_DLS_LIST_INIT;
+            entryPtr->waiterCount = 0;
+            entryPtr->isDone = false;
+            entryPtr->requestSize = requestSize;
+            entryPtr->responseSize = 0;
+            memcpy(entryPtr->request, requestPtr, requestSize);
+
+            le_dls_Queue(&_CoalesceList, &entryPtr->link);
+            _CoalesceEntryCount++;
+        }
+
+        _UNLOCK
+
+        *entryPtrPtr = entryPtr;
+        return LE_OK;
+    }
+
+    if (entryPtr->isDone)
+    {
+        _CoalesceCacheHitCount++;
+
+        // Copy the response out of the entry while it can't be dropped, but respond outside of
+        // the lock: a failure to send closes the session, which calls CleanupClientData().
+        size_t responseSize = entryPtr->responseSize;
+        memcpy(le_msg_GetPayloadPtr(msgRef), entryPtr->response, responseSize);
+
+        _UNLOCK
+
+        le_msg_SetPayloadSize(msgRef, responseSize);
+        le_msg_Respond(msgRef);
+    }
+    else
+    {
+        _CoalesceMergedCount++;
+
+        _CoalesceWaiter_t* waiterPtr = le_mem_ForceAlloc(_CoalesceWaiterPool);
+        waiterPtr->link = LE_DLS_LINK_INIT;
+        waiterPtr->msgRef = msgRef;
+        le_dls_Queue(&entryPtr->waiterList, &waiterPtr->link);
+        entryPtr->waiterCount++;
+
+        _UNLOCK
+    }
+
+    return LE_DUPLICATE;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send the response to a call to the identical calls that are waiting for it, and cache it if
+ * responses are cached.  Must be called before the response is sent to the call itself.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CoalesceResponse
+(
+    _CoalesceEntry_t* entryPtr,         ///< Entry returned by CoalesceRequest(), or NULL.
+    le_msg_MessageRef_t msgRef,         ///< Response message.
+    size_t responseSize                 ///< Number of bytes used in the response.
+)
+{
+    if (entryPtr == NULL)
+    {
+        return;
+    }
+
+    _LOCK
+
+    // The waiters are responded to outside of the lock, from the response message itself.
+    le_dls_List_t waiterList = entryPtr->waiterList;
+    entryPtr->waiterList = LE_DLS_LIST_INIT;
+    entryPtr->waiterCount = 0;
+
+    if ((_CoalesceCacheTime.sec != 0) || (_CoalesceCacheTime.usec != 0))
+    {
+        entryPtr->isDone = true;
+        entryPtr->expiryTime = le_clk_Add(le_clk_GetRelativeTime(), _CoalesceCacheTime);
+        entryPtr->responseSize = responseSize;
+        memcpy(entryPtr->response, le_msg_GetPayloadPtr(msgRef), responseSize);
+    }
+    else
+    {
+        le_dls_Remove(&_CoalesceList, &entryPtr->link);
+        _CoalesceEntryCount--;
+        le_mem_Release(entryPtr);
+    }
+
+    _UNLOCK
+
+    le_dls_Link_t* linkPtr;
+    while ((linkPtr = le_dls_Pop(&waiterList)) != NULL)
+    {
+        _CoalesceWaiter_t* waiterPtr = CONTAINER_OF(linkPtr, _CoalesceWaiter_t, link);
+
+        memcpy(le_msg_GetPayloadPtr(waiterPtr->msgRef), le_msg_GetPayloadPtr(msgRef), responseSize);
+        le_msg_SetPayloadSize(waiterPtr->msgRef, responseSize);
+        le_msg_Respond(waiterPtr->msgRef);
+
+        le_mem_Release(waiterPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how long responses to calls to idempotent functions are cached, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_SetResponseCacheTime
+(
+    uint32_t milliseconds
+)
+{
+    _LOCK
+    _CoalesceCacheTime.sec = milliseconds / 1000;
+    _CoalesceCacheTime.usec = (milliseconds % 1000) * 1000;
+    _UNLOCK
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the request coalescing statistics.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_GetCoalescingStats
+(
+    uint64_t* callCountPtr,
+    uint64_t* mergedCountPtr,
+    uint64_t* cacheHitCountPtr
+)
+{
+    _LOCK
+    *callCountPtr = _CoalesceCallCount;
+    *mergedCountPtr = _CoalesceMergedCount;
+    *cacheHitCountPtr = _CoalesceCacheHitCount;
+    _UNLOCK
+}
+{%- endif %}
 
 
 //--------------------------------------------------------------------------------------------------
@@ -141,10 +416,11 @@ static le_thread_Ref_t _ServerThreadRef;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Client Session Reference for the current message received from a client
+ * Client Session Reference for the current message received from a client.  Thread-local, because
+ * the messages of a multi-threaded service are handled by several threads at once.
  */
 //--------------------------------------------------------------------------------------------------
-static le_msg_SessionRef_t _ClientSessionRef;
+static __thread le_msg_SessionRef_t _ClientSessionRef;
 
 
 //--------------------------------------------------------------------------------------------------
@@ -306,6 +582,13 @@ void {{apiName}}_AdvertiseService
     // Create the server command pool
     _ServerCmdPool = le_mem_CreatePool("{{apiName}}_ServerCmd", sizeof({{apiName}}_ServerCmd_t));
     {%- endif %}
+    {%- if any(functions, "IdempotentFunction") %}
+
+    // Create the request coalescing pools
+    _CoalesceEntryPool = le_mem_CreatePool("{{apiName}}_CoalesceEntry", sizeof(_CoalesceEntry_t));
+    _CoalesceWaiterPool = le_mem_CreatePool("{{apiName}}_CoalesceWaiter",
+                                            sizeof(_CoalesceWaiter_t));
+    {%- endif %}
 
     // Create safe reference map for handler references.
     // The size of the map should be based on the number of handlers defined for the server.
@@ -376,6 +659,7 @@ static void AsyncResponse_{{apiName}}_{{function.name}}
     LE_DEBUG("Sending message to client session %p : %ti bytes sent",
              serverDataPtr->clientSessionRef,
              _msgBufPtr-_msgPtr->buffer);
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     SendMsgToClient(_msgRef);
 
     {%- if function is not AddHandlerFunction %}
@@ -445,8 +729,15 @@ void {{apiName}}_{{function.name}}Respond
     // Pack any "out" parameters
     {{- pack.PackOutputs(function.parameters) }}
 
+    {%- if function is IdempotentFunction %}
+
+    // Also respond to identical calls
+    CoalesceResponse(_cmdRef->coalesceEntryPtr, _msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
+    {%- endif %}
+
     // Return the response
     LE_DEBUG("Sending response to client session %p", le_msg_GetSession(_msgRef));
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)_msgPtr);
     le_msg_Respond(_msgRef);
 
     // Release the command
@@ -482,6 +773,19 @@ static void Handle_{{apiName}}_{{function.name}}
     {%- call pack.UnpackInputs(function.parameters) %}
         goto {{error_unpack_label}};
     {%- endcall %}
+    {%- if function is IdempotentFunction %}
+
+    // Don't call the function if an identical call is responded to instead
+    _CoalesceEntry_t* _coalesceEntryPtr;
+    if (CoalesceRequest(_msgRef,
+                        _msgBufPtr - (uint8_t*)le_msg_GetPayloadPtr(_msgRef),
+                        &_coalesceEntryPtr) == LE_DUPLICATE)
+    {
+        le_mem_Release(_serverCmdPtr);
+        return;
+    }
+    _serverCmdPtr->coalesceEntryPtr = _coalesceEntryPtr;
+    {%- endif %}
 
     // Call the function
     {{apiName}}_{{function.name}} ( _serverCmdPtr
@@ -561,6 +865,17 @@ static void Handle_{{apiName}}_{{function.name}}
         goto {{error_unpack_label}};
     {%- endcall %}
     {%- endif %}
+    {%- if function is IdempotentFunction %}
+
+    // Don't call the function if an identical call is responded to instead
+    _CoalesceEntry_t* _coalesceEntryPtr;
+    if (CoalesceRequest(_msgRef,
+                        _msgBufPtr - (uint8_t*)le_msg_GetPayloadPtr(_msgRef),
+                        &_coalesceEntryPtr) == LE_DUPLICATE)
+    {
+        return;
+    }
+    {%- endif %}
     {#- Now create handler parameters, if there are any.  Should be zero or one #}
     {%- for handler in function.parameters if handler.apiType is HandlerType %}
 
@@ -649,10 +964,19 @@ static void Handle_{{apiName}}_{{function.name}}
     // Pack any "out" parameters
     {{- pack.PackOutputs(function.parameters) }}
 
+    {%- if function is IdempotentFunction %}
+
+    // Also respond to identical calls
+    CoalesceResponse(_coalesceEntryPtr,
+                     _msgRef,
+                     _msgBufPtr - (uint8_t*)le_msg_GetPayloadPtr(_msgRef));
+    {%- endif %}
+
     // Return the response
     LE_DEBUG("Sending response to client session %p : %ti bytes sent",
              le_msg_GetSession(_msgRef),
              _msgBufPtr-_msgBufStartPtr);
+    le_msg_SetPayloadSize(_msgRef, _msgBufPtr - (uint8_t*)le_msg_GetPayloadPtr(_msgRef));
     le_msg_Respond(_msgRef);
 
     return;
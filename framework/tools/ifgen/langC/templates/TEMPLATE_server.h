@@ -53,6 +53,35 @@ void {{apiName}}_AdvertiseService
 (
     void
 );
+{%- if any(functions, "IdempotentFunction") %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how long the responses to calls to functions marked @c @@idempotent are cached, and sent in
+ * response to identical calls instead of calling the function again.
+ *
+ * By default, responses aren't cached, and are only sent in response to identical calls made
+ * while the function is being called.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_SetResponseCacheTime
+(
+    uint32_t milliseconds       ///< [IN] How long to cache responses for (0 = don't cache).
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of calls made to functions marked @c @@idempotent, and how many of those were
+ * responded to without calling the function.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_GetCoalescingStats
+(
+    uint64_t* callCountPtr,     ///< [OUT] Number of calls.
+    uint64_t* mergedCountPtr,   ///< [OUT] Calls sent the response to an identical, ongoing call.
+    uint64_t* cacheHitCountPtr  ///< [OUT] Calls sent a cached response.
+);
+{%- endif %}
 {%- endif %}
 {%- endblock %}
 {% block FunctionDeclaration %}
@@ -26,6 +26,7 @@ BuildParams_t::BuildParams_t
     target("localhost"),
     codeGenOnly(false),
     isStandAloneComp(false),
+    jobCount(1),
     argc(0),
     argv(NULL)
 //--------------------------------------------------------------------------------------------------
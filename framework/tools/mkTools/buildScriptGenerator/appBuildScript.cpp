@@ -66,15 +66,10 @@ void AppBuildScriptGenerator_t::GenerateAppBuildRules
         // Delete the old info.properties file, if there is one.
         "  command = rm -f $out && $\n"
         // Compute the MD5 checksum of the staging area.
-        // Don't follow symlinks (-P), and include the directory structure and the contents of
-        // symlinks as part of the MD5 hash.
-        "            md5=$$( ( cd $workingDir/staging && $\n"
-        "                      find -P -print0 |LC_ALL=C sort -z && $\n"
-        "                      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum && $\n"
-        "                      find -P -type l -print0 |LC_ALL=C sort -z"
-                             " |xargs -0 -r -n 1 readlink $\n"
-        "                    ) |tee /proc/self/fd/2 | md5sum) && $\n"
-        "            md5=$${md5%% *} && $\n"
+        // Symlinks aren't followed, and the directory structure and the contents of symlinks are
+        // part of the MD5 hash.  The hashes of files are cached, so only changed files are read.
+        "            md5=`mk app-md5 --cache=$workingDir/staging.md5cache $\n"
+        "                            $workingDir/staging` && $\n"
         // Generate the app's info.properties file.
         "            ( echo \"app.name=$name\" && $\n"
         "              echo \"app.md5=$$md5\" && $\n"
@@ -20,12 +20,14 @@ namespace ninja
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a build script file and open it.
+ * Start generating a build script file.
+ *
+ * The script is generated in memory and only written to the file by CloseFile(), if it changed.
  **/
 //--------------------------------------------------------------------------------------------------
 void OpenFile
 (
-    std::ofstream& script,
+    std::ostringstream& script,
     const std::string& filePath,
     bool beVerbose
 )
@@ -37,34 +39,32 @@ void OpenFile
                   << std::endl;
     }
 
-    file::MakeDir(path::GetContainingDir(filePath));
-
-    script.open(filePath, std::ofstream::trunc);
-    if (!script.is_open())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
-        );
-    }
+    script.str("");
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Close a build script file and check for errors.
+ * Finish generating a build script file, and write it if its contents changed.
+ *
+ * Leaving an unchanged file alone keeps its timestamp, so nothing depending on it gets rebuilt.
  **/
 //--------------------------------------------------------------------------------------------------
 void CloseFile
 (
-    std::ofstream& script
+    std::ostringstream& script,
+    const std::string& filePath
 )
 //--------------------------------------------------------------------------------------------------
 {
-    script.close();
     if (script.fail())
     {
-        throw mk::Exception_t(LE_I18N("Failed to close file."));
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to generate file '%s'."), filePath)
+        );
     }
+
+    file::WriteIfChanged(filePath, script.str());
 }
 
 
@@ -121,7 +121,7 @@ BuildScriptGenerator_t::~BuildScriptGenerator_t
 (
 )
 {
-    CloseFile(script);
+    CloseFile(script, scriptPath);
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -323,10 +323,13 @@ void BuildScriptGenerator_t::GenerateBuildRules
     }
     script << "            sh -c \'$externalCommand\'\n";
 
-    // Generate a rule for running ifgen.
+    // Generate a rule for running ifgen.  Unless IFGEN_SERVER is already set (to empty, to
+    // disable it), ifgen hands its work to a server kept running in the build directory, to save
+    // the cost of starting the Python interpreter and loading the parser once per interface.
     script << "rule GenInterfaceCode\n"
               "  description = Generating IPC interface code\n"
-              "  command = ifgen --output-dir $outputDir $ifgenFlags $in\n"
+              "  command = IFGEN_SERVER=$${IFGEN_SERVER-$builddir/ifgen.sock} $\n"
+              "            ifgen --output-dir $outputDir $ifgenFlags $in\n"
               "\n";
 
     // Generate a rule for copying a file.
@@ -336,9 +339,11 @@ void BuildScriptGenerator_t::GenerateBuildRules
               "\n";
 
     // Generate a rule for re-building the build.ninja script when it is out of date.
+    // The script is only rewritten if it changes, so ninja must check its timestamp afterwards.
     script << "rule RegenNinjaScript\n"
               "  description = Regenerating build script\n"
               "  generator = 1\n"
+              "  restat = 1\n"
               "  command = " << buildParams.argv[0] << " --dont-run-ninja";
     for (int i = 1; i < buildParams.argc; i++)
     {
@@ -20,12 +20,14 @@ namespace ninja
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a build script file and open it.
+ * Start generating a build script file.
+ *
+ * The script is generated in memory and only written to the file by CloseFile(), if it changed.
  **/
 //--------------------------------------------------------------------------------------------------
 void OpenFile
 (
-    std::ofstream& script,
+    std::ostringstream& script,
     const std::string& filePath,
     bool beVerbose
 );
@@ -33,12 +35,13 @@ void OpenFile
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Close a build script file and check for errors.
+ * Finish generating a build script file, and write it if its contents changed.
  **/
 //--------------------------------------------------------------------------------------------------
 void CloseFile
 (
-    std::ofstream& script
+    std::ostringstream& script,
+    const std::string& filePath
 );
 
 //--------------------------------------------------------------------------------------------------
@@ -61,7 +64,7 @@ class BuildScriptGenerator_t
     friend struct RequireBaseGenerator_t;
 
     protected:
-        std::ofstream script;
+        std::ostringstream script;
         const mk::BuildParams_t& buildParams;
         const std::string scriptPath;
 
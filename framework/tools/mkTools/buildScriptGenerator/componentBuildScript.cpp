@@ -970,6 +970,10 @@ void ComponentBuildScriptGenerator_t::GenerateCBuildStatement
     }
     if (!generatedFiles.empty())
     {
+        if (ifPtr->async)
+        {
+            ifgenFlags += " --async-client";
+        }
         ifgenFlags += " --name-prefix " + ifPtr->internalName;
         script << "build" << generatedFiles <<
                   ": GenInterfaceCode " << ifPtr->apiFilePtr->path << " |";
@@ -106,8 +106,9 @@ void ModuleBuildScriptGenerator_t::GenerateMakefile
                                 + "/modules/" + modulePtr->name);
     const std::string& compilerPath = buildParams.cCompilerPath;
 
-    std::ofstream makefile;
-    OpenFile(makefile, buildPath + "/Makefile", buildParams.beVerbose);
+    std::string makefilePath = buildPath + "/Makefile";
+    std::ostringstream makefile;
+    OpenFile(makefile, makefilePath, buildParams.beVerbose);
 
     // Specify kernel module name and list all object files to link
     makefile << "obj-m += " << modulePtr->name << ".o\n";
@@ -160,7 +161,7 @@ void ModuleBuildScriptGenerator_t::GenerateMakefile
     makefile << "clean:\n";
     makefile << "\t make -C $(KBUILD) M=" + buildPath + " clean\n";
 
-    CloseFile(makefile);
+    CloseFile(makefile, makefilePath);
 }
 
 
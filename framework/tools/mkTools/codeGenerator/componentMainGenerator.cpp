@@ -8,6 +8,14 @@
 
 #include "mkTools.h"
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of worker threads that handle the requests of a [multi-threaded] server-side interface.
+ */
+//--------------------------------------------------------------------------------------------------
+static const size_t ServerThreadCount = 4;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Define the service name variables for an IPC interface.
@@ -15,7 +23,7 @@
 //--------------------------------------------------------------------------------------------------
 static void DefineServiceNameVars
 (
-    std::ofstream& fileStream,      ///< File stream to write to.
+    std::ostream& fileStream,       ///< Stream to write to.
     const model::ApiRef_t* interfacePtr,  ///< Ptr to client or server interface.
     bool isStandAlone   ///< true = fully resolve all interface name variables.
 )
@@ -87,15 +95,8 @@ void GenerateCLangComponentMainFile
                   << std::endl;
     }
 
-    // Open the .c file for writing.
-    file::MakeDir(outputDir);
-    std::ofstream fileStream(filePath, std::ofstream::trunc);
-    if (!fileStream.is_open())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
-        );
-    }
+    // Generate the .c file in memory; it's only written if it changed.
+    std::ostringstream fileStream;
 
     // Generate file header and #include directives.
     fileStream << "/*\n"
@@ -130,6 +131,12 @@ void GenerateCLangComponentMainFile
 
         // Declare the server-side interface initialization function.
         fileStream << "void " << interfacePtr->internalName << "_AdvertiseService(void);\n";
+
+        if (interfacePtr->multiThreaded)
+        {
+            fileStream << "le_msg_ServiceRef_t " << interfacePtr->internalName
+                       << "_GetServiceRef(void);\n";
+        }
     }
 
     // Declare the component's log session variables.
@@ -164,6 +171,15 @@ void GenerateCLangComponentMainFile
             {
                 // Call the interface initialization function.
                 fileStream << "    " << ifPtr->internalName << "_AdvertiseService();\n";
+
+                // No message can be received before the event loop starts, so handing the
+                // service over to worker threads now is as good as doing it before advertising.
+                if (ifPtr->multiThreaded)
+                {
+                    fileStream << "    le_msg_SetServiceThreadCount("
+                               << ifPtr->internalName << "_GetServiceRef(), "
+                               << ServerThreadCount << ");\n";
+                }
             }
             else
             {
@@ -214,6 +230,8 @@ void GenerateCLangComponentMainFile
                   "#ifdef __cplusplus\n"
                   "}\n"
                   "#endif\n";
+
+    file::WriteIfChanged(filePath, fileStream.str());
 }
 
 
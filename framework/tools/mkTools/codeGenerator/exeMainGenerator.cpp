@@ -43,15 +43,8 @@ void GenerateCLangExeMain
                   << std::endl;
     }
 
-    // Open the file as an output stream.
-    file::MakeDir(path::GetContainingDir(sourceFile));
-    std::ofstream outputFile(sourceFile);
-    if (outputFile.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), sourceFile)
-        );
-    }
+    // Generate the file in memory; it's only written if it changed.
+    std::ostringstream outputFile;
 
     // Generate the file header comment and #include directives.
     outputFile << "\n"
@@ -205,7 +198,7 @@ void GenerateCLangExeMain
                   "    LE_FATAL(\"== SHOULDN'T GET HERE! ==\");\n"
                   "}\n";
 
-    outputFile.close();
+    file::WriteIfChanged(sourceFile, outputFile.str());
 }
 
 
@@ -37,17 +37,9 @@ void GenerateCLangInterfacesHeader
                   << std::endl;
     }
 
-    // Make sure the working file output directory exists.
-    file::MakeDir(outputDir);
-
-    // Open the interfaces.h file for writing.
-    std::ofstream fileStream(filePath, std::ofstream::trunc);
-    if (!fileStream.is_open())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for writing."), filePath)
-        );
-    }
+    // Generate interfaces.h in memory; it's only written if it changed, so that the component
+    // isn't recompiled needlessly.
+    std::ostringstream fileStream;
 
     std::string includeGuardName = "__" + componentPtr->name
                                         + "_COMPONENT_INTERFACE_H_INCLUDE_GUARD";
@@ -102,6 +94,8 @@ void GenerateCLangInterfacesHeader
                   "#endif\n"
                   "\n"
                   "#endif // " << includeGuardName << "\n";
+
+    file::WriteIfChanged(filePath, fileStream.str());
 }
 
 
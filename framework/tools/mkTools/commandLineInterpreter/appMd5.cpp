@@ -0,0 +1,546 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Implements the "app-md5" command of the "mk" tool, which app build scripts use to compute the
+ *  MD5 hash of an app's staging area.
+ *
+ *  The hash is the same as the one computed by this shell pipeline, run in the staging area:
+ *
+ *  @verbatim
+    ( find -P -print0 |LC_ALL=C sort -z &&
+      find -P -type f -print0 |LC_ALL=C sort -z |xargs -0 md5sum &&
+      find -P -type l -print0 |LC_ALL=C sort -z |xargs -0 -r -n 1 readlink
+    ) | md5sum
+    @endverbatim
+ *
+ *  But the tree is only walked once, regular files are hashed by several threads, and the hashes of
+ *  files are kept in a cache file between runs, so that only files that changed are read again.
+ *  A cached hash is used if the file still has the same inode, modification time, status change
+ *  time and size.
+ *
+ *  Usage: mk app-md5 [--cache=CACHE_FILE] [--jobs=N] STAGING_DIR
+ *
+ *  Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include <iostream>
+#include <string.h>
+#include <unistd.h>
+#include <fts.h>
+#include <limits.h>
+#include <sys/stat.h>
+
+#include "mkTools.h"
+#include "commandLineInterpreter.h"
+
+
+namespace cli
+{
+
+
+/// Path to the app's staging directory.
+static std::string StagingDir;
+
+/// Path to the file holding the cached file hashes.  "" = don't use a cache.
+static std::string CachePath;
+
+/// Number of threads hashing files.
+static int JobCount;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * An entry in the staging directory.
+ */
+//--------------------------------------------------------------------------------------------------
+struct StagedEntry_t
+{
+    std::string path;   ///< Path relative to the staging directory, as find prints it ("./x/y").
+    struct stat status; ///< The entry's status (not following symlinks).
+    std::string md5;    ///< Hash of a regular file's contents, or target of a symlink.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A cached hash, with the file status it is valid for.
+ */
+//--------------------------------------------------------------------------------------------------
+struct CacheEntry_t
+{
+    ino_t inode;
+    struct timespec modTime;
+    struct timespec changeTime;
+    off_t size;
+    std::string md5;
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the command-line arguments and update the static operating parameters variables.
+ *
+ * Throws a std::runtime_error exception on failure.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void GetCommandLineArgs
+(
+    int argc,
+    const char** argv
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto stagingDirSet = [](const char* param)
+    {
+        if (!StagingDir.empty())
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("Only one staging directory allowed. First is '%s'."
+                                   "  Second is '%s'."),
+                           StagingDir, param)
+            );
+        }
+
+        StagingDir = param;
+    };
+
+    args::AddOptionalString(&CachePath,
+                            "",
+                            'c',
+                            "cache",
+                            LE_I18N("File to keep the hashes of files in between runs."));
+
+    args::AddOptionalInt(&JobCount,
+                         static_cast<int>(mk::ThreadPool_t::DefaultThreadCount()),
+                         'j',
+                         "jobs",
+                         LE_I18N("Number of threads to use to hash files.  Defaults to the number"
+                                 " of processors."));
+
+    args::SetLooseArgHandler(stagingDirSet);
+
+    args::Scan(argc, argv);
+
+    if (JobCount < 1)
+    {
+        throw mk::Exception_t(LE_I18N("The number of jobs must be at least 1."));
+    }
+
+    if (StagingDir.empty())
+    {
+        throw mk::Exception_t(LE_I18N("A staging directory must be supplied."));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the list of all the entries in the staging directory, including the directory itself,
+ * sorted by path the way "LC_ALL=C sort" does.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::vector<StagedEntry_t> ListStagingDir
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::vector<StagedEntry_t> entries;
+
+    char* pathArrayPtr[] = { const_cast<char*>(StagingDir.c_str()), NULL };
+    FTS* ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL | FTS_NOCHDIR, NULL);
+
+    if (ftsPtr == NULL)
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open directory '%s' (%s)."),
+                       StagingDir,
+                       strerror(errno))
+        );
+    }
+
+    FTSENT* entPtr;
+    while ((entPtr = fts_read(ftsPtr)) != NULL)
+    {
+        switch (entPtr->fts_info)
+        {
+            case FTS_DP:
+                // Directories are listed on the way in.
+                continue;
+
+            case FTS_DNR:
+            case FTS_ERR:
+            case FTS_NS:
+            {
+                std::string path = entPtr->fts_path;
+                int errCode = entPtr->fts_errno;
+                fts_close(ftsPtr);
+                throw mk::Exception_t(
+                    mk::format(LE_I18N("Failed to read '%s' (%s)."), path, strerror(errCode))
+                );
+            }
+        }
+
+        StagedEntry_t entry;
+
+        entry.path = "." + std::string(entPtr->fts_path + StagingDir.length());
+        entry.status = *entPtr->fts_statp;
+
+        entries.push_back(std::move(entry));
+    }
+
+    fts_close(ftsPtr);
+
+    std::sort(entries.begin(),
+              entries.end(),
+              [](const StagedEntry_t& a, const StagedEntry_t& b)
+              {
+                  return a.path < b.path;
+              });
+
+    return entries;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the cached file hashes.  A missing or unreadable cache is just empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::map<std::string, CacheEntry_t> LoadCache
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::map<std::string, CacheEntry_t> cache;
+
+    if (CachePath.empty())
+    {
+        return cache;
+    }
+
+    std::ifstream input(CachePath);
+    std::string line;
+
+    // Each line is: md5 inode mtime-sec mtime-nsec ctime-sec ctime-nsec size path
+    while (std::getline(input, line))
+    {
+        std::istringstream fields(line);
+        CacheEntry_t entry;
+        long long inode, modSec, modNsec, changeSec, changeNsec, size;
+        std::string path;
+
+        if (   (fields >> entry.md5 >> inode >> modSec >> modNsec >> changeSec >> changeNsec
+                       >> size)
+            && (fields.get() == ' ')
+            && std::getline(fields, path))
+        {
+            entry.inode = static_cast<ino_t>(inode);
+            entry.modTime.tv_sec = static_cast<time_t>(modSec);
+            entry.modTime.tv_nsec = static_cast<long>(modNsec);
+            entry.changeTime.tv_sec = static_cast<time_t>(changeSec);
+            entry.changeTime.tv_nsec = static_cast<long>(changeNsec);
+            entry.size = static_cast<off_t>(size);
+
+            cache[path] = entry;
+        }
+    }
+
+    return cache;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the hashes of the staging directory's regular files to the cache.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SaveCache
+(
+    const std::vector<StagedEntry_t>& entries
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (CachePath.empty())
+    {
+        return;
+    }
+
+    std::ostringstream contents;
+
+    for (const auto& entry : entries)
+    {
+        // Paths with newlines in them aren't worth the trouble of escaping.
+        if (!S_ISREG(entry.status.st_mode) || (entry.path.find('\n') != std::string::npos))
+        {
+            continue;
+        }
+
+        contents << entry.md5 << ' '
+                 << static_cast<long long>(entry.status.st_ino) << ' '
+                 << static_cast<long long>(entry.status.st_mtim.tv_sec) << ' '
+                 << static_cast<long long>(entry.status.st_mtim.tv_nsec) << ' '
+                 << static_cast<long long>(entry.status.st_ctim.tv_sec) << ' '
+                 << static_cast<long long>(entry.status.st_ctim.tv_nsec) << ' '
+                 << static_cast<long long>(entry.status.st_size) << ' '
+                 << entry.path << '\n';
+    }
+
+    file::WriteIfChanged(CachePath, contents.str());
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a cached hash is valid for a file.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsCacheValid
+(
+    const CacheEntry_t& cacheEntry,
+    const struct stat& status
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (   (cacheEntry.inode == status.st_ino)
+            && (cacheEntry.modTime.tv_sec == status.st_mtim.tv_sec)
+            && (cacheEntry.modTime.tv_nsec == status.st_mtim.tv_nsec)
+            && (cacheEntry.changeTime.tv_sec == status.st_ctim.tv_sec)
+            && (cacheEntry.changeTime.tv_nsec == status.st_ctim.tv_nsec)
+            && (cacheEntry.size == status.st_size));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the MD5 hash of a file's contents.
+ *
+ * @return The hash, as a string of hex digits.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string HashFile
+(
+    const std::string& filePath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::ifstream input(filePath, std::ios::binary);
+
+    if (!input.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for reading."), filePath)
+        );
+    }
+
+    MD5 md5;
+    std::vector<char> buffer(64 * 1024);
+
+    while (input.read(buffer.data(), buffer.size()) || (input.gcount() > 0))
+    {
+        md5.update(buffer.data(), static_cast<MD5::size_type>(input.gcount()));
+    }
+
+    if (input.bad())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to read from file '%s'."), filePath)
+        );
+    }
+
+    return md5.finalize().hexdigest();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the target of a symlink.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string ReadLink
+(
+    const std::string& linkPath,
+    off_t size                      ///< Size of the link, from lstat().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Some file systems report a size of 0 for symlinks.
+    std::vector<char> buffer((size > 0 ? size : PATH_MAX) + 1);
+
+    ssize_t length = readlink(linkPath.c_str(), buffer.data(), buffer.size());
+
+    if ((length < 0) || (static_cast<size_t>(length) >= buffer.size()))
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to read symlink '%s'."), linkPath)
+        );
+    }
+
+    return std::string(buffer.data(), length);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the line md5sum prints for a file, given its hash.
+ *
+ * md5sum escapes file names containing backslashes or newlines, and flags such lines with a
+ * leading backslash.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string Md5sumLine
+(
+    const std::string& md5,
+    const std::string& path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (path.find_first_of("\\\n") == std::string::npos)
+    {
+        return md5 + "  " + path + "\n";
+    }
+
+    std::string escapedPath;
+
+    for (char c : path)
+    {
+        if (c == '\\')
+        {
+            escapedPath += "\\\\";
+        }
+        else if (c == '\n')
+        {
+            escapedPath += "\\n";
+        }
+        else
+        {
+            escapedPath += c;
+        }
+    }
+
+    return "\\" + md5 + "  " + escapedPath + "\n";
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Compute the hash of the staging directory.
+ *
+ * @return The hash, as a string of hex digits.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string ComputeStagingMd5
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto entries = ListStagingDir();
+    auto cache = LoadCache();
+
+    // Hash the files that aren't in the cache, and read the symlinks.
+    {
+        mk::ThreadPool_t pool(JobCount);
+
+        for (auto& entry : entries)
+        {
+            if (S_ISREG(entry.status.st_mode))
+            {
+                auto cacheIter = cache.find(entry.path);
+
+                if ((cacheIter != cache.end()) && IsCacheValid(cacheIter->second, entry.status))
+                {
+                    entry.md5 = cacheIter->second.md5;
+                }
+                else
+                {
+                    auto entryPtr = &entry;
+
+                    pool.Post([entryPtr]()
+                        {
+                            entryPtr->md5 = HashFile(path::Combine(StagingDir, entryPtr->path));
+                        });
+                }
+            }
+            else if (S_ISLNK(entry.status.st_mode))
+            {
+                entry.md5 = ReadLink(path::Combine(StagingDir, entry.path), entry.status.st_size);
+            }
+        }
+
+        pool.Wait();
+    }
+
+    MD5 md5;
+
+    auto update = [&md5](const std::string& text)
+        {
+            md5.update(text.data(), static_cast<MD5::size_type>(text.size()));
+        };
+
+    // The list of everything.
+    for (const auto& entry : entries)
+    {
+        update(entry.path);
+        update(std::string(1, '\0'));
+    }
+
+    // The hashes of the regular files.  Without any, xargs runs md5sum without arguments, so it
+    // hashes its empty standard input.
+    bool hasFiles = false;
+
+    for (const auto& entry : entries)
+    {
+        if (S_ISREG(entry.status.st_mode))
+        {
+            update(Md5sumLine(entry.md5, entry.path));
+            hasFiles = true;
+        }
+    }
+
+    if (!hasFiles)
+    {
+        update(MD5("").hexdigest() + "  -\n");
+    }
+
+    // The targets of the symlinks.
+    for (const auto& entry : entries)
+    {
+        if (S_ISLNK(entry.status.st_mode))
+        {
+            update(entry.md5 + "\n");
+        }
+    }
+
+    SaveCache(entries);
+
+    return md5.finalize().hexdigest();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Implements the app-md5 command: prints the MD5 hash of an app's staging directory.
+ */
+//--------------------------------------------------------------------------------------------------
+void ComputeAppMd5
+(
+    int argc,           ///< Count of the number of command line parameters.
+    const char** argv   ///< Pointer to an array of pointers to command line argument strings.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    GetCommandLineArgs(argc, argv);
+
+    // Trailing slashes would end up in the entries' paths.
+    while ((StagingDir.length() > 1) && (StagingDir.back() == '/'))
+    {
+        StagingDir.pop_back();
+    }
+
+    std::cout << ComputeStagingMd5() << std::endl;
+}
+
+
+} // namespace cli
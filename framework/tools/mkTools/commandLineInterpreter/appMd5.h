@@ -0,0 +1,22 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#ifndef APP_MD5_H_INCLUDE_GUARD
+#define APP_MD5_H_INCLUDE_GUARD
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Implements the app-md5 command: prints the MD5 hash of an app's staging directory.
+ */
+//--------------------------------------------------------------------------------------------------
+void ComputeAppMd5
+(
+    int argc,           ///< Count of the number of command line parameters.
+    const char** argv   ///< Pointer to an array of pointers to command line argument strings.
+);
+
+
+#endif // APP_MD5_H_INCLUDE_GUARD
@@ -42,6 +42,11 @@ int main(int argc, const char** argv)
         {
             cli::MakeSystem(argc, argv);
         }
+        else if ((fileName == "mk") && (argc > 1) && (strcmp(argv[1], "app-md5") == 0))
+        {
+            // Build step run by app build scripts.
+            cli::ComputeAppMd5(argc - 1, argv + 1);
+        }
         else
         {
             std::cerr << mk::format(LE_I18N("** ERROR: unknown command name '%s'."), fileName)
@@ -313,6 +313,52 @@ void RunNinja
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the file system path to the file in which .api file dependencies are cached.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::string GetApiDependencyCachePath
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return path::Combine(buildParams.workingDir, "mktool_api_deps");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the .api file dependencies cached in the working directory by a previous run, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+void LoadApiDependencyCache
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    parser::api::LoadDependencyCache(GetApiDependencyCachePath(buildParams));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the .api file dependencies found while modelling in the working directory, for the next
+ * run to use.
+ */
+//--------------------------------------------------------------------------------------------------
+void SaveApiDependencyCache
+(
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    parser::api::SaveDependencyCache(GetApiDependencyCachePath(buildParams));
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate code for a given component.
@@ -343,7 +389,7 @@ void GenerateCode
 //--------------------------------------------------------------------------------------------------
 void GenerateCode
 (
-    const std::set<model::Component_t*>& components,  ///< Set of components to generate code for.
+    const model::ComponentPtrSet_t& components,  ///< Set of components to generate code for.
     const mk::BuildParams_t& buildParams
 )
 //--------------------------------------------------------------------------------------------------
@@ -45,6 +45,29 @@ void RunNinja
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the .api file dependencies cached in the working directory by a previous run, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+void LoadApiDependencyCache
+(
+    const mk::BuildParams_t& buildParams
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the .api file dependencies found while modelling in the working directory, for the next
+ * run to use.
+ */
+//--------------------------------------------------------------------------------------------------
+void SaveApiDependencyCache
+(
+    const mk::BuildParams_t& buildParams
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Generate code for a given component.
@@ -64,7 +87,7 @@ void GenerateCode
 //--------------------------------------------------------------------------------------------------
 void GenerateCode
 (
-    const std::set<model::Component_t*>& components,  ///< Set of components to generate code for.
+    const model::ComponentPtrSet_t& components,  ///< Set of components to generate code for.
     const mk::BuildParams_t& buildParams
 );
 
@@ -329,9 +329,13 @@ void MakeApp
         envVars::Save(BuildParams);
     }
 
+    LoadApiDependencyCache(BuildParams);
+
     // Construct a model of the application.
     model::App_t* appPtr = modeller::GetApp(AdefFilePath, BuildParams);
 
+    SaveApiDependencyCache(BuildParams);
+
     // Append a "." and the VersionSuffix if the user provides a
     // "--append or -a" argument in the command line.
     if (appPtr->version.empty())
@@ -296,9 +296,13 @@ void MakeComponent
     }
     ComponentPath = path::MakeAbsolute(foundPath);
 
+    LoadApiDependencyCache(BuildParams);
+
     // Generate the conceptual object model.
     model::Component_t* componentPtr = modeller::GetComponent(ComponentPath, BuildParams);
 
+    SaveApiDependencyCache(BuildParams);
+
     // Add Linux info -- for now always compiling for Linux.
     componentPtr->setTargetInfo(new target::LinuxComponentInfo_t(componentPtr, BuildParams));
 
@@ -471,8 +471,12 @@ void MakeExecutable
         }
     }
 
+    LoadApiDependencyCache(BuildParams);
+
     ConstructObjectModel();
 
+    SaveApiDependencyCache(BuildParams);
+
     // Run appropriate generator
     generator::RunAllGenerators(LinuxSteps, ExePtr, BuildParams);
 
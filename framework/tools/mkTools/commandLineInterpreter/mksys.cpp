@@ -44,9 +44,37 @@ static const generator::SystemGenerator_t LinuxSteps[] =
 {
     [](model::System_t* systemPtr, const mk::BuildParams_t& buildParams)
     {
-        GenerateCode(model::Component_t::GetComponentMap(), buildParams);
+        // Each component and app has its own generated files, so they can be generated in
+        // parallel.  In verbose mode, stick to one thread so the progress messages stay in order.
+        mk::ThreadPool_t pool(buildParams.beVerbose ? 1 : buildParams.jobCount);
+
+        // Generating a component's code sets its Linux target info, which the executables' main
+        // files read.  So all the components must be done before any app is started.
+
+        for (auto& mapEntry : model::Component_t::GetComponentMap())
+        {
+            auto componentPtr = mapEntry.second;
+
+            pool.Post([componentPtr, &buildParams]()
+                {
+                    GenerateCode(componentPtr, buildParams);
+                });
+        }
+
+        pool.Wait();
+
+        for (auto& appMapEntry : systemPtr->apps)
+        {
+            auto appPtr = appMapEntry.second;
+
+            pool.Post([appPtr, &buildParams]()
+                {
+                    GenerateCode(appPtr, buildParams);
+                });
+        }
+
+        pool.Wait();
     },
-    generator::ForAllApps<GenerateCode>,
     config::Generate,
     ninja::Generate,
     NULL
@@ -186,6 +214,13 @@ static void GetCommandLineArgs
                                   " regenerate itself and any other files that need to be"
                                   " regenerated when the build.ninja finds itself out of date."));
 
+    args::AddOptionalInt(&BuildParams.jobCount,
+                         static_cast<int>(mk::ThreadPool_t::DefaultThreadCount()),
+                         'j',
+                         "jobs",
+                         LE_I18N("Number of threads to use to parse definition files and"
+                                 " generate code.  Defaults to the number of processors."));
+
     args::AddOptionalFlag(&BuildParams.codeGenOnly,
                           'g',
                           "generate-code",
@@ -202,6 +237,11 @@ static void GetCommandLineArgs
 
     args::Scan(argc, argv);
 
+    if (BuildParams.jobCount < 1)
+    {
+        throw mk::Exception_t(LE_I18N("The number of jobs must be at least 1."));
+    }
+
     // Were we given an system definition?
     if (SdefFilePath == "")
     {
@@ -291,9 +331,13 @@ void MakeSystem
         envVars::Save(BuildParams);
     }
 
+    LoadApiDependencyCache(BuildParams);
+
     // Construct a model of the system.
     model::System_t* systemPtr = modeller::GetSystem(SdefFilePath, BuildParams);
 
+    SaveApiDependencyCache(BuildParams);
+
     // If verbose mode is on, print a summary of the system model.
     if (BuildParams.beVerbose)
     {
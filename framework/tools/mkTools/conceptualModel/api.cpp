@@ -320,7 +320,8 @@ ApiClientInterface_t::ApiClientInterface_t
 //--------------------------------------------------------------------------------------------------
 :   ApiRef_t(aPtr, cPtr, iName),
     manualStart(false),
-    optional(false)
+    optional(false),
+    async(false)
 //--------------------------------------------------------------------------------------------------
 {
 }
@@ -338,7 +339,16 @@ void ApiClientInterface_t::GetInterfaceFiles
 const
 //--------------------------------------------------------------------------------------------------
 {
-    std::string codeGenDir = path::Combine(apiFilePtr->codeGenDir, "client/");
+    std::string codeGenDir;
+
+    if (async)
+    {
+        codeGenDir = path::Combine(apiFilePtr->codeGenDir, "async_client/");
+    }
+    else
+    {
+        codeGenDir = path::Combine(apiFilePtr->codeGenDir, "client/");
+    }
 
     cFiles.interfaceFile = codeGenDir + internalName + "_interface.h";
     cFiles.internalHFile = codeGenDir + internalName + "_messages.h";
@@ -381,7 +391,8 @@ ApiServerInterface_t::ApiServerInterface_t
 //--------------------------------------------------------------------------------------------------
 :   ApiRef_t(aPtr, cPtr, iName),
     async(isAsync),
-    manualStart(false)
+    manualStart(false),
+    multiThreaded(false)
 //--------------------------------------------------------------------------------------------------
 {
 }
@@ -68,6 +68,24 @@ protected:
 };
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Orders API file object pointers by file path, so sets of them are iterated in the same order
+ * no matter where the objects happen to be allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+struct ApiFilePtrLess_t
+{
+    inline bool operator()(const ApiFile_t* a, const ApiFile_t* b) const
+    {
+        return a->path < b->path;
+    }
+};
+
+/// Convenience typedef for constructing sets of API file object pointers.
+typedef std::set<const ApiFile_t*, ApiFilePtrLess_t> ApiFilePtrSet_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Structure to hold paths to the C code for a generated interface.
@@ -141,6 +159,7 @@ struct ApiClientInterface_t : public ApiRef_t
 {
     bool manualStart;   ///< true = generated main() should not call the ConnectService() function.
     bool optional;      ///< true = okay to not be bound.
+    bool async;         ///< true = also generate asynchronous (pipelined) client functions.
 
     ApiClientInterface_t(ApiFile_t* aPtr, Component_t* cPtr, const std::string& iName);
 
@@ -158,6 +177,7 @@ struct ApiServerInterface_t : public ApiRef_t
 {
     const bool async;         ///< true = component wants to use asynchronous mode of operation.
     bool manualStart;   ///< true = generated main() should not call AdvertiseService() function.
+    bool multiThreaded; ///< true = requests are handled by a pool of worker threads.
 
     ApiServerInterface_t(ApiFile_t* aPtr, Component_t* cPtr, const std::string& iName, bool async);
 
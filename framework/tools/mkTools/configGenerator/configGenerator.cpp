@@ -19,7 +19,7 @@ namespace config
 //--------------------------------------------------------------------------------------------------
 static void GenerateAppVersionConfig
 (
-    std::ofstream& cfgStream,
+    std::ostream& cfgStream,
     const model::App_t* appPtr
 )
 //--------------------------------------------------------------------------------------------------
@@ -38,7 +38,7 @@ static void GenerateAppVersionConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateAppLimitsConfig
 (
-    std::ofstream& cfgStream,
+    std::ostream& cfgStream,
     const model::App_t* appPtr
 )
 //--------------------------------------------------------------------------------------------------
@@ -94,7 +94,7 @@ static void GenerateAppLimitsConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateGroupsConfig
 (
-    std::ofstream& cfgStream,
+    std::ostream& cfgStream,
     const model::App_t* appPtr
 )
 //--------------------------------------------------------------------------------------------------
@@ -129,7 +129,7 @@ static void GenerateGroupsConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateSingleFileMappingConfig
 (
-    std::ofstream& cfgStream,   ///< Stream to send the configuration to.
+    std::ostream& cfgStream,    ///< Stream to send the configuration to.
     size_t          index,      ///< The index of the file in the files list in the configuration.
     const model::FileSystemObject_t* mappingPtr  ///< The file mapping.
 )
@@ -164,7 +164,7 @@ static void GenerateSingleFileMappingConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateBundledObjectMappingConfig
 (
-    std::ofstream& cfgStream,   ///< Stream to send the configuration to.
+    std::ostream& cfgStream,    ///< Stream to send the configuration to.
     size_t          index,      ///< Index of the mapping in the files list in the configuration.
     const model::FileSystemObject_t* mappingPtr  ///< The mapping.
 )
@@ -221,7 +221,7 @@ static void GenerateBundledObjectMappingConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateFileMappingConfig
 (
-    std::ofstream& cfgStream,
+    std::ostream& cfgStream,
     const model::App_t* appPtr
 )
 //--------------------------------------------------------------------------------------------------
@@ -366,7 +366,7 @@ static void GenerateFileMappingConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateProcessEnvVarsConfig
 (
-    std::ofstream& cfgStream,
+    std::ostream& cfgStream,
     const model::App_t* appPtr,
     const model::ProcessEnv_t* procEnvPtr
 )
@@ -450,7 +450,7 @@ static std::string GenerateClassPath
 //--------------------------------------------------------------------------------------------------
 static void GenerateProcessConfig
 (
-    std::ofstream& cfgStream,
+    std::ostream& cfgStream,
     const model::App_t* appPtr
 )
 //--------------------------------------------------------------------------------------------------
@@ -567,7 +567,7 @@ static void GenerateProcessConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateSingleApiBindingToUser
 (
-    std::ofstream& cfgStream,           ///< Stream to send the configuration to.
+    std::ostream& cfgStream,            ///< Stream to send the configuration to.
     const std::string& clientInterface, ///< Client interface name.
     const std::string& serverUserName,  ///< User name of the server.
     const std::string& serviceName      ///< Service instance name the server will advertise.
@@ -589,7 +589,7 @@ static void GenerateSingleApiBindingToUser
 //--------------------------------------------------------------------------------------------------
 static void GenerateSingleApiBindingToApp
 (
-    std::ofstream& cfgStream,           ///< Stream to send the configuration to.
+    std::ostream& cfgStream,            ///< Stream to send the configuration to.
     const std::string& clientInterface, ///< Client interface name.
     const std::string& serverAppName,   ///< Name of the application running the server.
     const std::string& serviceName      ///< Service instance name the server will advertise.
@@ -611,7 +611,7 @@ static void GenerateSingleApiBindingToApp
 //--------------------------------------------------------------------------------------------------
 static void GenerateBindingConfig
 (
-    std::ofstream& cfgStream,       ///< Stream to send the configuration to.
+    std::ostream& cfgStream,        ///< Stream to send the configuration to.
     const model::Binding_t* bindingPtr  ///< Binding to internal exe.component.interface.
 )
 //--------------------------------------------------------------------------------------------------
@@ -646,7 +646,7 @@ static void GenerateBindingConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateBindingsConfig
 (
-    std::ofstream& cfgStream,
+    std::ostream& cfgStream,
     model::App_t* appPtr,
     const mk::BuildParams_t& buildParams
 )
@@ -707,7 +707,7 @@ static void GenerateBindingsConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateConfigTreeAclConfig
 (
-    std::ofstream& cfgStream,
+    std::ostream& cfgStream,
     model::App_t* appPtr
 )
 //--------------------------------------------------------------------------------------------------
@@ -748,7 +748,7 @@ static void GenerateConfigTreeAclConfig
 //--------------------------------------------------------------------------------------------------
 static void GenerateAppWatchdogConfig
 (
-    std::ofstream& cfgStream,
+    std::ostream& cfgStream,
     model::App_t* appPtr
 )
 //--------------------------------------------------------------------------------------------------
@@ -797,14 +797,8 @@ void Generate
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
-
-    if (cfgStream.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
-        );
-    }
+    // Generate the file in memory; it's only written if it changed.
+    std::ostringstream cfgStream;
 
     cfgStream << "{" << std::endl;
 
@@ -825,6 +819,8 @@ void Generate
     GenerateAppWatchdogConfig(cfgStream, appPtr);
 
     cfgStream << "}" << std::endl;
+
+    file::WriteIfChanged(filePath, cfgStream.str());
 }
 
 
@@ -850,14 +846,7 @@ static void GenerateModulesConfig
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
-
-    if (cfgStream.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
-        );
-    }
+    std::ostringstream cfgStream;
 
     cfgStream << "{\n";
 
@@ -883,6 +872,8 @@ static void GenerateModulesConfig
     }
 
     cfgStream << "}\n";
+
+    file::WriteIfChanged(filePath, cfgStream.str());
 }
 
 
@@ -910,14 +901,7 @@ static void GenerateUsersConfig
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
-
-    if (cfgStream.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
-        );
-    }
+    std::ostringstream cfgStream;
 
     cfgStream << "{\n";
 
@@ -942,6 +926,8 @@ static void GenerateUsersConfig
     }
 
     cfgStream << "}\n";
+
+    file::WriteIfChanged(filePath, cfgStream.str());
 }
 
 
@@ -954,7 +940,7 @@ static void GenerateUsersConfig
 //--------------------------------------------------------------------------------------------------
 static void AddAppConfig
 (
-    std::ofstream& cfgStream,    ///< The configuration file being written to.
+    std::ostream& cfgStream,     ///< The configuration file being written to.
     model::App_t* appPtr,
     const mk::BuildParams_t& buildParams
 )
@@ -1003,14 +989,7 @@ static void GenerateAppsConfig
                   << std::endl;
     }
 
-    std::ofstream cfgStream(filePath, std::ofstream::trunc);
-
-    if (cfgStream.is_open() == false)
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Could not open '%s' for writing."), filePath)
-        );
-    }
+    std::ostringstream cfgStream;
 
     cfgStream << "{\n";
 
@@ -1024,6 +1003,8 @@ static void GenerateAppsConfig
     }
 
     cfgStream << "}\n";
+
+    file::WriteIfChanged(filePath, cfgStream.str());
 }
 
 
@@ -19,6 +19,15 @@ namespace envVars
 {
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Variables set by a thread that called MakeThreadLocal().  These hide the process's environment
+ * for that thread only, so worker threads can each have their own CURDIR, etc.
+ */
+//--------------------------------------------------------------------------------------------------
+static thread_local std::map<std::string, std::string>* ThreadVarsPtr = nullptr;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetch the value of a given optional environment variable.
@@ -32,6 +41,16 @@ std::string Get
 )
 //--------------------------------------------------------------------------------------------------
 {
+    if (ThreadVarsPtr != nullptr)
+    {
+        auto i = ThreadVarsPtr->find(name);
+
+        if (i != ThreadVarsPtr->end())
+        {
+            return i->second;
+        }
+    }
+
     const char* value = getenv(name.c_str());
 
     if (value == nullptr)
@@ -58,6 +77,16 @@ std::string GetRequired
 )
 //--------------------------------------------------------------------------------------------------
 {
+    if (ThreadVarsPtr != nullptr)
+    {
+        auto i = ThreadVarsPtr->find(name);
+
+        if (i != ThreadVarsPtr->end())
+        {
+            return i->second;
+        }
+    }
+
     const char* value = getenv(name.c_str());
 
     if (value == nullptr)
@@ -84,6 +113,12 @@ void Set
 )
 //--------------------------------------------------------------------------------------------------
 {
+    if (ThreadVarsPtr != nullptr)
+    {
+        (*ThreadVarsPtr)[name] = value;
+        return;
+    }
+
     if (setenv(name.c_str(), value.c_str(), true /* overwrite existing */) != 0)
     {
         throw mk::Exception_t(
@@ -93,6 +128,28 @@ void Set
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make the calling thread's changes to environment variables local to that thread.  After this,
+ * Set() no longer changes the process's environment when called by this thread, and Get() sees the
+ * values set by this thread first.
+ *
+ * Must be called by every worker thread that sets variables (e.g., CURDIR) while other threads
+ * may be reading them.
+ */
+//--------------------------------------------------------------------------------------------------
+void MakeThreadLocal
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    static thread_local std::map<std::string, std::string> threadVars;
+
+    ThreadVarsPtr = &threadVars;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set compiler, linker, etc. environment variables according to the target device type, if they're
@@ -361,13 +418,7 @@ std::string DoSubstitution
         case UNBRACKETED_VAR_NAME:
             // The end of the string terminates the environment variable name.
             // Look up the environment variable, and if found, add its value to the result.
-            {
-                const char* envVarPtr = getenv(envVarName.c_str());
-                if (envVarPtr != NULL)
-                {
-                    result += envVarPtr;
-                }
-            }
+            result += Get(envVarName);
             break;
 
         case BRACKETED_VAR_NAME:
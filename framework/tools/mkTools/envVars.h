@@ -56,6 +56,17 @@ void Set
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make the calling thread's changes to environment variables local to that thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void MakeThreadLocal
+(
+    void
+);
+
+
 //----------------------------------------------------------------------------------------------
 /**
  * Adds target-specific environment variables (e.g., LEGATO_TARGET) to the process's environment.
@@ -308,7 +308,8 @@ void MakeDir
 
         int status = mkdir(path.c_str(), mode);
 
-        if (status != 0)
+        // Another thread may have created it in the meantime.
+        if ((status != 0) && !((errno == EEXIST) && DirectoryExists(path)))
         {
             int err = errno;
 
@@ -434,4 +435,81 @@ void DeleteFile
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the contents of a file, unless it already has exactly those contents.
+ *
+ * An unchanged file is left untouched, so that its modification time doesn't change and nothing
+ * that depends on it gets rebuilt.  Otherwise, the new contents are written to a temporary file
+ * which then replaces the file atomically.
+ *
+ * @return true if the file was written, false if it was already up to date.
+ *
+ * @throw mk::Exception_t if the file can't be written.
+ **/
+//--------------------------------------------------------------------------------------------------
+bool WriteIfChanged
+(
+    const std::string& path,
+    const std::string& contents
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct stat statBuffer;
+
+    // Only read the old file if it could possibly be the same.
+    if (   (stat(path.c_str(), &statBuffer) == 0)
+        && S_ISREG(statBuffer.st_mode)
+        && (statBuffer.st_size == static_cast<off_t>(contents.size())) )
+    {
+        std::ifstream oldFile(path, std::ifstream::binary);
+        std::string oldContents(contents.size(), '\0');
+
+        if (   oldFile.read(&oldContents[0], oldContents.size())
+            && (oldContents == contents) )
+        {
+            return false;
+        }
+    }
+
+    MakeDir(path::GetContainingDir(path));
+
+    // The temporary file is in the same directory, so the rename can't cross file systems, and its
+    // name is unique to this process and thread.
+    std::string tempPath = path + ".tmp." + std::to_string(getpid()) + "."
+                         + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    std::ofstream newFile(tempPath, std::ofstream::trunc | std::ofstream::binary);
+    if (!newFile.is_open())
+    {
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to open file '%s' for writing."), tempPath)
+        );
+    }
+
+    newFile.write(contents.data(), contents.size());
+    newFile.close();
+
+    if (newFile.fail())
+    {
+        unlink(tempPath.c_str());
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to write file '%s'."), tempPath)
+        );
+    }
+
+    if (rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        int errCode = errno;
+        unlink(tempPath.c_str());
+        throw mk::Exception_t(
+            mk::format(LE_I18N("Failed to rename '%s' to '%s' (%s)."),
+                       tempPath, path, strerror(errCode))
+        );
+    }
+
+    return true;
+}
+
+
 } // namespace file
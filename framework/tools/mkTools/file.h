@@ -173,6 +173,26 @@ void DeleteFile
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the contents of a file, unless it already has exactly those contents.
+ *
+ * An unchanged file is left untouched, so that its modification time doesn't change and nothing
+ * that depends on it gets rebuilt.  Otherwise, the new contents are written to a temporary file
+ * which then replaces the file atomically.
+ *
+ * @return true if the file was written, false if it was already up to date.
+ *
+ * @throw mk::Exception_t if the file can't be written.
+ **/
+//--------------------------------------------------------------------------------------------------
+bool WriteIfChanged
+(
+    const std::string& path,        ///< File system path
+    const std::string& contents     ///< Contents the file must have.
+);
+
+
 } // namespace file
 
 #endif // LEGATO_MKTOOLS_FILE_H_INCLUDE_GUARD
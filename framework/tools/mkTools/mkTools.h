@@ -16,6 +16,9 @@
 
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -24,11 +27,13 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <stack>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <typeindex>
 #include <unordered_set>
 #include <unordered_map>
@@ -44,6 +49,7 @@
 #include "file.h"
 #include "format.h"
 #include "md5.h"
+#include "threadPool.h"
 #include "parseTree/parseTree.h"
 #include "parser/parser.h"
 #include "conceptualModel/conceptualModel.h"
@@ -338,7 +338,7 @@ static void AddBundledItems
 //--------------------------------------------------------------------------------------------------
 static void GetUsetypesApis
 (
-    std::set<const model::ApiFile_t*>& set,    ///< Set to add the USETYPES-included .api files to.
+    model::ApiFilePtrSet_t& set,    ///< Set to add the USETYPES-included .api files to.
     model::ApiFile_t* apiFilePtr
 )
 //--------------------------------------------------------------------------------------------------
@@ -399,6 +399,7 @@ static void GetProvidedApi
     // Check for options.
     bool async = false;
     bool manualStart = false;
+    bool multiThreaded = false;
     for (auto contentPtr : contentList)
     {
         if (contentPtr->type == parseTree::Token_t::SERVER_IPC_OPTION)
@@ -411,8 +412,17 @@ static void GetProvidedApi
             {
                 manualStart = true;
             }
+            else if (contentPtr->text == "[multi-threaded]")
+            {
+                multiThreaded = true;
+            }
         }
     }
+    if (manualStart && multiThreaded)
+    {
+        itemPtr->ThrowException(LE_I18N("Can't use [manual-start] with [multi-threaded]"
+                                  " for the same interface."));
+    }
 
     // Get a pointer to the .api file object.
     auto apiFilePtr = GetApiFilePtr(apiFilePath, buildParams.interfaceDirs, contentList[0]);
@@ -429,6 +439,7 @@ static void GetProvidedApi
                                                  internalName,
                                                  async);
     ifPtr->manualStart = manualStart;
+    ifPtr->multiThreaded = multiThreaded;
 
     componentPtr->serverApis.push_back(ifPtr);
 
@@ -525,6 +536,7 @@ static void GetRequiredApi
     bool typesOnly = false;
     bool manualStart = false;
     bool optional = false;
+    bool async = false;
     for (auto contentPtr : contentList)
     {
         if (contentPtr->type == parseTree::Token_t::CLIENT_IPC_OPTION)
@@ -542,6 +554,10 @@ static void GetRequiredApi
                 manualStart = true; // [optional] implies [manual-start].
                 optional = true;
             }
+            else if (contentPtr->text == "[async]")
+            {
+                async = true;
+            }
         }
     }
     if (typesOnly && manualStart)
@@ -549,6 +565,11 @@ static void GetRequiredApi
         itemPtr->ThrowException(LE_I18N("Can't use [types-only] with [manual-start] or [optional]"
                                   " for the same interface."));
     }
+    if (typesOnly && async)
+    {
+        itemPtr->ThrowException(LE_I18N("Can't use [types-only] with [async]"
+                                  " for the same interface."));
+    }
 
     // Get a pointer to the .api file object.
     auto apiFilePtr = GetApiFilePtr(apiFilePath, buildParams.interfaceDirs, contentList[0]);
@@ -572,6 +593,7 @@ static void GetRequiredApi
 
         ifPtr->manualStart = manualStart;
         ifPtr->optional = optional;
+        ifPtr->async = async;
 
         componentPtr->clientApis.push_back(ifPtr);
     }
@@ -213,6 +213,19 @@ model::ApiFile_t* GetApiFilePtr
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pre-parse the .adef files of the apps listed in a system's "apps:" sections, the .cdef files of
+ * all their components and the .api files those use, using buildParams.jobCount threads.
+ */
+//--------------------------------------------------------------------------------------------------
+void PreParseApps
+(
+    const std::list<const parseTree::CompoundItem_t*>& appsSections,
+    const mk::BuildParams_t& buildParams
+);
+
+
 
 } // namespace modeller
 
@@ -0,0 +1,381 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file preParser.cpp
+ *
+ * Parses the definition files of a system's apps and components, and scans their .api files,
+ * ahead of time using a pool of worker threads.
+ *
+ * The modeller itself stays single-threaded, because the conceptual model's objects are shared
+ * between apps (components, .api files) and modelling depends on the CURDIR environment variable.
+ * But most of its time is spent reading and parsing files, and that work is independent for each
+ * file.  So the files that the modeller is going to need are found the same way the modeller
+ * finds them, parsed by worker threads and left in the parser's store of pre-parsed files, where
+ * the modeller takes them from, in its usual order, instead of parsing them itself.
+ *
+ * Any error found here is ignored: the file in error isn't stored, so the modeller parses it
+ * again and reports the error exactly as it would have without pre-parsing.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+//--------------------------------------------------------------------------------------------------
+
+#include "mkTools.h"
+#include "modellerCommon.h"
+
+
+namespace modeller
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * State shared by all pre-parsing tasks.
+ */
+//--------------------------------------------------------------------------------------------------
+struct PreParser_t
+{
+    const mk::BuildParams_t& buildParams;
+    mk::ThreadPool_t pool;              ///< Worker threads.
+    std::mutex mutex;                   ///< Protects the set of seen paths.
+    std::set<std::string> seenPaths;    ///< Component dirs and .api files already posted.
+
+    PreParser_t(const mk::BuildParams_t& params)
+    :   buildParams(params),
+        pool(params.jobCount)
+    {
+    }
+};
+
+
+static void PreParseComponent(PreParser_t& preParser, const std::string& componentDir);
+static void PreScanApi(PreParser_t& preParser, const std::string& apiFilePath);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check whether a component directory or .api file has already been handed to a task, and
+ * remember it if not.
+ *
+ * @return true if this is the first time it is seen.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MarkSeen
+(
+    PreParser_t& preParser,
+    const std::string& path
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(preParser.mutex);
+
+    return preParser.seenPaths.insert(path).second;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find a component the same way GetComponent() does, and post a task to pre-parse it.
+ * Tokens that can't be resolved are skipped; the modeller will report them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PostComponent
+(
+    PreParser_t& preParser,
+    const parseTree::Token_t* tokenPtr,
+    const std::string& preSearchDir ///< Dir to search before the build's source dirs.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::string componentPath = path::Unquote(envVars::DoSubstitution(tokenPtr->text));
+
+    if (componentPath.empty())
+    {
+        return;
+    }
+
+    auto resolvedPath = file::FindComponent(componentPath, { preSearchDir });
+    if (resolvedPath.empty())
+    {
+        resolvedPath = file::FindComponent(componentPath, preParser.buildParams.sourceDirs);
+    }
+    if (resolvedPath.empty())
+    {
+        return;
+    }
+
+    auto componentDir = path::MakeAbsolute(resolvedPath);
+
+    if (MarkSeen(preParser, path::MakeCanonical(componentDir)))
+    {
+        preParser.pool.Post([&preParser, componentDir]()
+            {
+                PreParseComponent(preParser, componentDir);
+            });
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Post a task to scan an .api file for dependencies, unless it has already been done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PostApi
+(
+    PreParser_t& preParser,
+    const std::string& apiFilePath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!apiFilePath.empty() && MarkSeen(preParser, apiFilePath))
+    {
+        preParser.pool.Post([&preParser, apiFilePath]()
+            {
+                PreScanApi(preParser, apiFilePath);
+            });
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan an .api file for the other .api files it uses (the results are remembered by the parser),
+ * and post tasks to scan those too.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PreScanApi
+(
+    PreParser_t& preParser,
+    const std::string& apiFilePath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Same search order as GetApiFilePtr().
+    auto handler = [&preParser, &apiFilePath](std::string&& dependency)
+        {
+            if (!path::HasSuffix(dependency, ".api"))
+            {
+                dependency += ".api";
+            }
+
+            auto includedFilePath = file::FindFile(dependency,
+                                                   { path::GetContainingDir(apiFilePath) });
+            if (includedFilePath.empty())
+            {
+                includedFilePath = file::FindFile(dependency, preParser.buildParams.interfaceDirs);
+            }
+
+            PostApi(preParser, includedFilePath);
+        };
+
+    try
+    {
+        parser::api::GetDependencies(apiFilePath, handler);
+    }
+    catch (const mk::Exception_t&)
+    {
+        // The modeller will report it.
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Post tasks to scan the .api files listed in a "provides:" or "requires:" section's "api:"
+ * subsection.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PostApis
+(
+    PreParser_t& preParser,
+    const parseTree::CompoundItem_t* subsectionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    for (auto itemPtr : parseTree::ToCompoundItemListPtr(subsectionPtr)->Contents())
+    {
+        // Same as GetProvidedApi() and GetRequiredApi(): skip the internal alias, if any.
+        const auto& contentList = parseTree::ToTokenListPtr(itemPtr)->Contents();
+        const auto& fileTokenPtr = (contentList[0]->type == parseTree::Token_t::NAME ?
+                                    contentList[1] : contentList[0]);
+
+        PostApi(preParser, file::FindFile(envVars::DoSubstitution(fileTokenPtr->text),
+                                          preParser.buildParams.interfaceDirs));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a component's .cdef file, then post tasks for its sub-components and .api files.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PreParseComponent
+(
+    PreParser_t& preParser,
+    const std::string& componentDir     ///< Absolute path to the component's directory.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    envVars::MakeThreadLocal();
+    envVars::Set("CURDIR", componentDir);
+
+    parseTree::CdefFile_t* cdefFilePtr;
+
+    try
+    {
+        cdefFilePtr = parser::cdef::Parse(path::Combine(componentDir, "Component.cdef"), false);
+
+        for (auto sectionPtr : cdefFilePtr->sections)
+        {
+            auto& sectionName = sectionPtr->firstTokenPtr->text;
+
+            if ((sectionName != "provides") && (sectionName != "requires"))
+            {
+                continue;
+            }
+
+            for (auto memberPtr : parseTree::ToComplexSectionPtr(sectionPtr)->Contents())
+            {
+                auto& subsectionName = memberPtr->firstTokenPtr->text;
+
+                if (subsectionName == "api")
+                {
+                    PostApis(preParser, memberPtr);
+                }
+                else if (subsectionName == "component")
+                {
+                    for (auto tokenPtr : parseTree::ToTokenListPtr(memberPtr)->Contents())
+                    {
+                        PostComponent(preParser, tokenPtr, componentDir);
+                    }
+                }
+            }
+        }
+    }
+    catch (const mk::Exception_t&)
+    {
+        // The modeller will parse the file again and report the error.
+        return;
+    }
+
+    parser::AddPreParsedFile(cdefFilePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse an app's .adef file, then post tasks for its components.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PreParseApp
+(
+    PreParser_t& preParser,
+    const std::string& adefPath     ///< Path to the .adef file, as the modeller will parse it.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto appDir = path::MakeAbsolute(path::GetContainingDir(adefPath));
+
+    envVars::MakeThreadLocal();
+    envVars::Set("CURDIR", appDir);
+
+    parseTree::AdefFile_t* adefFilePtr;
+
+    try
+    {
+        adefFilePtr = parser::adef::Parse(adefPath, false);
+
+        for (auto sectionPtr : adefFilePtr->sections)
+        {
+            auto& sectionName = sectionPtr->firstTokenPtr->text;
+
+            if (sectionName == "components")
+            {
+                for (auto tokenPtr : parseTree::ToTokenListSectionPtr(sectionPtr)->Contents())
+                {
+                    PostComponent(preParser, tokenPtr, appDir);
+                }
+            }
+            else if (sectionName == "executables")
+            {
+                for (auto itemPtr : parseTree::ToCompoundItemListPtr(sectionPtr)->Contents())
+                {
+                    for (auto tokenPtr : parseTree::ToTokenListPtr(itemPtr)->Contents())
+                    {
+                        PostComponent(preParser, tokenPtr, appDir);
+                    }
+                }
+            }
+        }
+    }
+    catch (const mk::Exception_t&)
+    {
+        // The modeller will parse the file again and report the error.
+        return;
+    }
+
+    parser::AddPreParsedFile(adefFilePtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pre-parse the .adef files of the apps listed in a system's "apps:" sections, the .cdef files of
+ * all their components and the .api files those use, using buildParams.jobCount threads.
+ *
+ * The app specifications are resolved the same way ModelApp() resolves them.  Binary apps and
+ * anything that can't be resolved are skipped.
+ */
+//--------------------------------------------------------------------------------------------------
+void PreParseApps
+(
+    const std::list<const parseTree::CompoundItem_t*>& appsSections,
+    const mk::BuildParams_t& buildParams
+)
+//--------------------------------------------------------------------------------------------------
+{
+    PreParser_t preParser(buildParams);
+
+    const std::string appSuffix = "." + buildParams.target + ".app";
+
+    for (auto sectionPtr : appsSections)
+    {
+        for (auto itemPtr : parseTree::ToCompoundItemListPtr(sectionPtr)->Contents())
+        {
+            std::string filePath;
+
+            try
+            {
+                auto appSpec = path::Unquote(envVars::DoSubstitution(itemPtr->firstTokenPtr->text));
+
+                if (path::HasSuffix(appSpec, ".adef"))
+                {
+                    filePath = file::FindFile(appSpec, buildParams.sourceDirs);
+                }
+                else if (!path::HasSuffix(appSpec, appSuffix))
+                {
+                    filePath = file::FindFile(appSpec + ".adef", buildParams.sourceDirs);
+                }
+            }
+            catch (const mk::Exception_t&)
+            {
+                // The modeller will report it.
+            }
+
+            if (!filePath.empty())
+            {
+                preParser.pool.Post([&preParser, filePath]()
+                    {
+                        PreParseApp(preParser, filePath);
+                    });
+            }
+        }
+    }
+
+    preParser.pool.Wait();
+}
+
+
+
+} // namespace modeller
@@ -968,6 +968,13 @@ model::System_t* GetSystem
         }
     }
 
+    // Parse the apps' and components' definition files in parallel, if allowed to.  They will be
+    // picked up by the modeller below.
+    if (buildParams.jobCount > 1)
+    {
+        PreParseApps(appsSections, buildParams);
+    }
+
     // Process all the "apps:" sections.  This must be done after all interface search directories
     // have been parsed.
     ModelApps(systemPtr, appsSections, buildParams);
@@ -694,6 +694,12 @@ parseTree::AdefFile_t* Parse
 )
 //--------------------------------------------------------------------------------------------------
 {
+    auto preParsedPtr = TakePreParsedFile(filePath, parseTree::DefFile_t::ADEF, beVerbose);
+    if (preParsedPtr != NULL)
+    {
+        return static_cast<parseTree::AdefFile_t*>(preParsedPtr);
+    }
+
     parseTree::AdefFile_t* filePtr = new parseTree::AdefFile_t(filePath);
 
     ParseFile(filePtr, beVerbose, internal::ParseSection);
@@ -24,7 +24,7 @@ namespace api
 //--------------------------------------------------------------------------------------------------
 std::string ParseUseTypesStatement
 (
-    std::ifstream& inputStream
+    std::istream& inputStream
 )
 //--------------------------------------------------------------------------------------------------
 {
@@ -69,35 +69,46 @@ std::string ParseUseTypesStatement
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets a list of other .api files that a given .api file depends on.
+ * What is known about the dependencies of an .api file.
+ */
+//--------------------------------------------------------------------------------------------------
+struct DependencyEntry_t
+{
+    std::string modTime;        ///< File's modification time, when it was scanned.
+    off_t size;                 ///< File's size, when it was scanned.
+    std::string contentMd5;     ///< MD5 hash of the file's contents, when it was scanned.
+    std::list<std::string> dependencies;    ///< .api files it uses types from.
+    bool isChecked;             ///< true if checked against the file itself during this run.
+};
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Dependencies of .api files, keyed by file path.  The same .api file is typically used by many
+ * components, and may be scanned by several threads at once.
  *
- * @throw mk::Exception_t if an error is encountered.
+ * Entries loaded by LoadDependencyCache() are only trusted once the file's modification time and
+ * size, or else the hash of its contents, have been found to be unchanged.
  */
 //--------------------------------------------------------------------------------------------------
-void GetDependencies
+static std::map<std::string, DependencyEntry_t> DependencyCache;
+static std::mutex DependencyCacheMutex;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan the contents of a .api file for USETYPES statements.
+ *
+ * @return The list of .api files that it depends on, in the order they appear in the file.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::list<std::string> ScanDependencies
 (
-    const std::string& filePath,    ///< Path to .api file to be parsed.
-    std::function<void (std::string&&)> handlerFunc ///< Function to call with dependencies.
+    std::istream& inputStream       ///< Contents of the .api file.
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Make sure the file exists.
-    if (!file::FileExists(filePath))
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("File not found: '%s'."), filePath)
-        );
-    }
-
-    std::ifstream inputStream(filePath);
-
-    // Make sure we were able to open the file.
-    if (!inputStream.is_open())
-    {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to open file '%s' for reading."), filePath)
-        );
-    }
+    std::list<std::string> dependencies;
 
     // Keep looking for USETYPES statements, skipping comments.
     for (int c = inputStream.get(); c != EOF; c = inputStream.get())
@@ -108,7 +119,7 @@ void GetDependencies
             std::string dependency = ParseUseTypesStatement(inputStream);
             if (!dependency.empty())
             {
-                handlerFunc(std::move(dependency));
+                dependencies.push_back(std::move(dependency));
             }
         }
         // Skip comments.
@@ -145,17 +156,203 @@ void GetDependencies
         }
     }
 
-    if (inputStream.bad())
+    return dependencies;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a list of other .api files that a given .api file depends on.
+ *
+ * Each file is only scanned once; the results are remembered for later calls, and for later runs
+ * of the tools if saved using SaveDependencyCache().  This function is thread-safe.
+ *
+ * @throw mk::Exception_t if an error is encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+void GetDependencies
+(
+    const std::string& filePath,    ///< Path to .api file to be parsed.
+    std::function<void (std::string&&)> handlerFunc ///< Function to call with dependencies.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DependencyEntry_t entry;
+    bool isCached = false;
+
     {
-        throw mk::Exception_t(
-            mk::format(LE_I18N("Failed to read from file '%s'."), filePath)
-        );
+        std::lock_guard<std::mutex> lock(DependencyCacheMutex);
+
+        auto i = DependencyCache.find(filePath);
+
+        if (i != DependencyCache.end())
+        {
+            entry = i->second;
+            isCached = true;
+        }
+    }
+
+    // Check entries from previous runs against the file, outside the lock, so other files can be
+    // checked at the same time.
+    if (!(isCached && entry.isChecked))
+    {
+        struct stat fileStat;
+
+        // Make sure the file exists.
+        if ((stat(filePath.c_str(), &fileStat) != 0) || !S_ISREG(fileStat.st_mode))
+        {
+            throw mk::Exception_t(
+                mk::format(LE_I18N("File not found: '%s'."), filePath)
+            );
+        }
+
+        auto modTime = std::to_string(fileStat.st_mtim.tv_sec) + "."
+                     + std::to_string(fileStat.st_mtim.tv_nsec);
+
+        if (!(isCached && (entry.modTime == modTime) && (entry.size == fileStat.st_size)))
+        {
+            std::ifstream inputStream(filePath, std::ifstream::binary);
+
+            // Make sure we were able to open the file.
+            if (!inputStream.is_open())
+            {
+                throw mk::Exception_t(
+                    mk::format(LE_I18N("Failed to open file '%s' for reading."), filePath)
+                );
+            }
+
+            std::stringstream contents;
+            contents << inputStream.rdbuf();
+
+            if (inputStream.bad())
+            {
+                throw mk::Exception_t(
+                    mk::format(LE_I18N("Failed to read from file '%s'."), filePath)
+                );
+            }
+
+            // The file may just have been touched (e.g., by a checkout).
+            auto contentMd5 = md5(contents.str());
+
+            if (!(isCached && (entry.contentMd5 == contentMd5)))
+            {
+                entry.dependencies = ScanDependencies(contents);
+                entry.contentMd5 = contentMd5;
+            }
+
+            entry.modTime = modTime;
+            entry.size = fileStat.st_size;
+        }
+
+        entry.isChecked = true;
+
+        std::lock_guard<std::mutex> lock(DependencyCacheMutex);
+
+        DependencyCache[filePath] = entry;
+    }
+
+    for (auto& dependency : entry.dependencies)
+    {
+        handlerFunc(std::string(dependency));
     }
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the dependencies of .api files saved by an earlier run of the tools.  Missing or corrupt
+ * cache files are ignored.
+ *
+ * The file holds one line per .api file, made of tab-separated fields: the file's path,
+ * modification time, size, MD5 hash of its contents, and the dependencies found in it.
+ */
+//--------------------------------------------------------------------------------------------------
+void LoadDependencyCache
+(
+    const std::string& cacheFilePath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::ifstream cacheFile(cacheFilePath);
+    std::string line;
+
+    std::lock_guard<std::mutex> lock(DependencyCacheMutex);
+
+    while (std::getline(cacheFile, line))
+    {
+        std::list<std::string> fields;
+        std::istringstream lineStream(line);
+        std::string field;
+
+        while (std::getline(lineStream, field, '\t'))
+        {
+            fields.push_back(field);
+        }
+
+        if (fields.size() < 4)
+        {
+            continue;
+        }
+
+        auto fieldIter = fields.begin();
+        auto& apiFilePath = *(fieldIter++);
+
+        DependencyEntry_t entry;
+        entry.modTime = *(fieldIter++);
+        entry.size = strtoll((fieldIter++)->c_str(), NULL, 10);
+        entry.contentMd5 = *(fieldIter++);
+        entry.dependencies.assign(fieldIter, fields.end());
+        entry.isChecked = false;
+
+        DependencyCache.insert(std::make_pair(apiFilePath, entry));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the dependencies of the .api files used during this run, for LoadDependencyCache() to load
+ * in a later run.  The file is only rewritten if something changed.
+ *
+ * @throw mk::Exception_t if the file can't be written.
+ */
+//--------------------------------------------------------------------------------------------------
+void SaveDependencyCache
+(
+    const std::string& cacheFilePath
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::ostringstream cacheStream;
+
+    std::lock_guard<std::mutex> lock(DependencyCacheMutex);
+
+    for (auto& mapEntry : DependencyCache)
+    {
+        auto& entry = mapEntry.second;
+
+        // Forget files that are no longer used.
+        if (!entry.isChecked)
+        {
+            continue;
+        }
+
+        cacheStream << mapEntry.first << '\t' << entry.modTime << '\t' << entry.size
+                    << '\t' << entry.contentMd5;
+
+        for (auto& dependency : entry.dependencies)
+        {
+            cacheStream << '\t' << dependency;
+        }
+
+        cacheStream << '\n';
+    }
+
+    file::WriteIfChanged(cacheFilePath, cacheStream.str());
+}
+
+
 
 } // namespace api
 
 } // namespace parser
-
@@ -16,7 +16,9 @@ namespace api
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Gets a list of other .api files that a given .api file depends on.
+ * Gets a list of other .api files that a given .api file depends on.  Thread-safe.
+ *
+ * Results are cached, and checked against the file's modification time, size and contents hash.
  *
  * @throw mk::Exception_t if an error is encountered.
  */
@@ -28,6 +30,32 @@ void GetDependencies
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the dependencies of .api files saved by an earlier run of the tools.  Missing or corrupt
+ * cache files are ignored.
+ */
+//--------------------------------------------------------------------------------------------------
+void LoadDependencyCache
+(
+    const std::string& cacheFilePath
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Save the dependencies of the .api files used during this run, for LoadDependencyCache() to load
+ * in a later run.
+ *
+ * @throw mk::Exception_t if the file can't be written.
+ */
+//--------------------------------------------------------------------------------------------------
+void SaveDependencyCache
+(
+    const std::string& cacheFilePath
+);
+
+
 
 } // namespace api
 
@@ -274,6 +274,12 @@ parseTree::CdefFile_t* Parse
 )
 //--------------------------------------------------------------------------------------------------
 {
+    auto preParsedPtr = TakePreParsedFile(filePath, parseTree::DefFile_t::CDEF, beVerbose);
+    if (preParsedPtr != NULL)
+    {
+        return static_cast<parseTree::CdefFile_t*>(preParsedPtr);
+    }
+
     parseTree::CdefFile_t* filePtr = new parseTree::CdefFile_t(filePath);
 
     ParseFile(filePtr, beVerbose, internal::ParseSection);
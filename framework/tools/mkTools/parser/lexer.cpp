@@ -18,7 +18,8 @@ namespace parser
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Constructor
+ * Constructor.  Reads the whole file into memory, so the lexer can look ahead and consume runs of
+ * characters without going through the stream one character at a time.
  */
 //--------------------------------------------------------------------------------------------------
 Lexer_t::LexerContext_t::LexerContext_t
@@ -27,7 +28,7 @@ Lexer_t::LexerContext_t::LexerContext_t
 )
 //--------------------------------------------------------------------------------------------------
 :   filePtr(filePtr),
-    inputStream(filePtr->path),
+    pos(0),
     line(1),
     column(0),
     ifNestDepth(0)
@@ -40,6 +41,9 @@ Lexer_t::LexerContext_t::LexerContext_t
             mk::format(LE_I18N("File not found: '%s'."), filePtr->path)
         );
     }
+
+    std::ifstream inputStream(filePtr->path, std::ifstream::binary);
+
     if (!inputStream.is_open())
     {
         throw mk::Exception_t(
@@ -47,8 +51,8 @@ Lexer_t::LexerContext_t::LexerContext_t
         );
     }
 
-    // Read in the first characters.
-    Buffer(2);
+    std::ostringstream contents;
+    contents << inputStream.rdbuf();
 
     if (inputStream.bad())
     {
@@ -56,22 +60,8 @@ Lexer_t::LexerContext_t::LexerContext_t
             mk::format(LE_I18N("Failed to read from file '%s'."), filePtr->path)
         );
     }
-}
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Ensure at least n elements are present in the lookahead character buffer
- */
-//--------------------------------------------------------------------------------------------------
-void Lexer_t::LexerContext_t::Buffer
-(
-    size_t n
-)
-{
-    while (inputStream.good() && (nextChars.size() < n))
-    {
-        nextChars.push_back(inputStream.get());
-    }
+    buffer = contents.str();
 }
 
 
@@ -199,42 +189,42 @@ bool Lexer_t::IsMatch
     switch (type)
     {
         case parseTree::Token_t::END_OF_FILE:
-            return (context.top().nextChars[0] == EOF);
+            return (context.top().Peek(0) == EOF);
 
         case parseTree::Token_t::OPEN_CURLY:
-            return (context.top().nextChars[0] == '{');
+            return (context.top().Peek(0) == '{');
 
         case parseTree::Token_t::CLOSE_CURLY:
-            return (context.top().nextChars[0] == '}');
+            return (context.top().Peek(0) == '}');
 
         case parseTree::Token_t::OPEN_PARENTHESIS:
-            return (context.top().nextChars[0] == '(');
+            return (context.top().Peek(0) == '(');
 
         case parseTree::Token_t::CLOSE_PARENTHESIS:
-            return (context.top().nextChars[0] == ')');
+            return (context.top().Peek(0) == ')');
 
         case parseTree::Token_t::COLON:
-            return (context.top().nextChars[0] == ':');
+            return (context.top().Peek(0) == ':');
 
         case parseTree::Token_t::EQUALS:
-            return (context.top().nextChars[0] == '=');
+            return (context.top().Peek(0) == '=');
 
         case parseTree::Token_t::DOT:
-            return (context.top().nextChars[0] == '.');
+            return (context.top().Peek(0) == '.');
 
         case parseTree::Token_t::STAR:
-            return (context.top().nextChars[0] == '*');
+            return (context.top().Peek(0) == '*');
 
         case parseTree::Token_t::ARROW:
-            return ((context.top().nextChars[0] == '-') && (context.top().nextChars[1] == '>'));
+            return ((context.top().Peek(0) == '-') && (context.top().Peek(1) == '>'));
 
         case parseTree::Token_t::WHITESPACE:
-            return IsWhitespace(context.top().nextChars[0]);
+            return IsWhitespace(context.top().Peek(0));
 
         case parseTree::Token_t::COMMENT:
-            if (context.top().nextChars[0] == '/')
+            if (context.top().Peek(0) == '/')
             {
-                int secondChar = context.top().nextChars[1];
+                int secondChar = context.top().Peek(1);
                 return ((secondChar == '/') || (secondChar == '*'));
             }
             else
@@ -245,11 +235,11 @@ bool Lexer_t::IsMatch
         case parseTree::Token_t::FILE_PERMISSIONS:
         case parseTree::Token_t::SERVER_IPC_OPTION:
         case parseTree::Token_t::CLIENT_IPC_OPTION:
-            return (context.top().nextChars[0] == '[');
+            return (context.top().Peek(0) == '[');
 
         case parseTree::Token_t::ARG:
             // Can be anything in a FILE_PATH, plus the equals sign (=).
-            if (context.top().nextChars[0] == '=')
+            if (context.top().Peek(0) == '=')
             {
                 return true;
             }
@@ -258,22 +248,22 @@ bool Lexer_t::IsMatch
         case parseTree::Token_t::FILE_PATH:
             // Can be anything in a FILE_NAME, plus the forward slash (/).
             // If it starts with a slash, it could be a comment or a file path.
-            if (context.top().nextChars[0] == '/')
+            if (context.top().Peek(0) == '/')
             {
                 // If it's not a comment, then it's a file path.
-                int secondChar = context.top().nextChars[1];
+                int secondChar = context.top().Peek(1);
                 return ((secondChar != '/') && (secondChar != '*'));
             }
             // *** FALL THROUGH ***
 
         case parseTree::Token_t::FILE_NAME:
-            return (   IsFileNameChar(context.top().nextChars[0])
-                       || (context.top().nextChars[0] == '\'')   // Could be in single-quotes.
-                       || (context.top().nextChars[0] == '"') ); // Could be in quotes.
+            return (   IsFileNameChar(context.top().Peek(0))
+                       || (context.top().Peek(0) == '\'')   // Could be in single-quotes.
+                       || (context.top().Peek(0) == '"') ); // Could be in quotes.
 
         case parseTree::Token_t::IPC_AGENT:
             // Can start with the same characters as a NAME or GROUP_NAME, plus '<'.
-            if (context.top().nextChars[0] == '<')
+            if (context.top().Peek(0) == '<')
             {
                 return true;
             }
@@ -282,17 +272,17 @@ bool Lexer_t::IsMatch
         case parseTree::Token_t::NAME:
         case parseTree::Token_t::GROUP_NAME:
         case parseTree::Token_t::DOTTED_NAME:
-            return (   islower(context.top().nextChars[0])
-                       || isupper(context.top().nextChars[0])
-                       || (context.top().nextChars[0] == '_') );
+            return (   islower(context.top().Peek(0))
+                       || isupper(context.top().Peek(0))
+                       || (context.top().Peek(0) == '_') );
 
         case parseTree::Token_t::INTEGER:
-            return (isdigit(context.top().nextChars[0]));
+            return (isdigit(context.top().Peek(0)));
 
         case parseTree::Token_t::SIGNED_INTEGER:
-            return (   (context.top().nextChars[0] == '+')
-                       || (context.top().nextChars[0] == '-')
-                       || isdigit(context.top().nextChars[0]));
+            return (   (context.top().Peek(0) == '+')
+                       || (context.top().Peek(0) == '-')
+                       || isdigit(context.top().Peek(0)));
 
         case parseTree::Token_t::BOOLEAN:
             return IsMatchBoolean();
@@ -304,10 +294,10 @@ bool Lexer_t::IsMatch
             throw mk::Exception_t(LE_I18N("Internal error: STRING lookahead not implemented."));
 
         case parseTree::Token_t::MD5_HASH:
-            return isxdigit(context.top().nextChars[0]);
+            return isxdigit(context.top().Peek(0));
 
         case parseTree::Token_t::DIRECTIVE:
-            return context.top().nextChars[0] == '#';
+            return context.top().Peek(0) == '#';
     }
 
     throw mk::Exception_t(LE_I18N("Internal error: IsMatch(): Invalid token type requested."));
@@ -339,7 +329,7 @@ void Lexer_t::SkipToNextDirective
 
     while (true)
     {
-        switch (context.top().nextChars[0])
+        switch (context.top().Peek(0))
         {
             case '#':
                 // Found a directive
@@ -347,7 +337,7 @@ void Lexer_t::SkipToNextDirective
 
             case '/':
             {
-                int secondChar = context.top().nextChars[1];
+                int secondChar = context.top().Peek(1);
                 if (secondChar == '/' ||
                     secondChar == '*')
                 {
@@ -367,7 +357,7 @@ void Lexer_t::SkipToNextDirective
             case '\'':
                 // Found a quoted string.  Pull the whole thing as it may contain embedded
                 // directives that should be ignored.
-                PullQuoted(phonyTokenPtr, context.top().nextChars[0]);
+                PullQuoted(phonyTokenPtr, context.top().Peek(0));
                 break;
 
             default:
@@ -395,11 +385,11 @@ parseTree::Token_t* Lexer_t::PullRaw
     {
         case parseTree::Token_t::END_OF_FILE:
 
-            if (context.top().nextChars[0] != EOF)
+            if (context.top().Peek(0) != EOF)
             {
                 ThrowException(
                     mk::format(LE_I18N("Expected end-of-file, but found '%c'."),
-                               (char)context.top().nextChars[0])
+                               (char)context.top().Peek(0))
                 );
             }
             break;
@@ -697,10 +687,22 @@ void Lexer_t::ResetTo(parseTree::Token_t* resetTokenPtr)
                                                   "across file boundary"));
         }
 
-        // Re-add the text to the buffer
-        context.top().nextChars.insert(context.top().nextChars.begin(),
-                                       lastTokenPtr->text.begin(),
-                                       lastTokenPtr->text.end());
+        // Step back over the token's text.  (Should a token's text ever differ from what was
+        // consumed, put its text in front of the remaining characters instead.)
+        auto& text = lastTokenPtr->text;
+        auto& currentContext = context.top();
+
+        if (   (text.size() <= currentContext.pos)
+            && (currentContext.buffer.compare(currentContext.pos - text.size(),
+                                              text.size(),
+                                              text) == 0) )
+        {
+            currentContext.pos -= text.size();
+        }
+        else
+        {
+            currentContext.buffer.insert(currentContext.pos, text);
+        }
 
         // Reset column & line numbers
         context.top().line = lastTokenPtr->line;
@@ -1198,16 +1200,13 @@ bool Lexer_t::IsMatchBoolean
         on_string[] = "on",
         off_string[] = "off";
 
-    // Need at most 5 characters (for false)
-    context.top().Buffer(5);
-    return std::equal(true_string, true_string + sizeof(true_string) - 1,
-                      context.top().nextChars.begin()) ||
-        std::equal(false_string, false_string + sizeof(false_string) - 1,
-                   context.top().nextChars.begin()) ||
-        std::equal(on_string, on_string + sizeof(on_string) - 1,
-                   context.top().nextChars.begin()) ||
-        std::equal(off_string, off_string + sizeof(off_string) - 1,
-                   context.top().nextChars.begin());
+    const auto& buffer = context.top().buffer;
+    const auto pos = context.top().pos;
+
+    return (buffer.compare(pos, sizeof(true_string) - 1, true_string) == 0) ||
+        (buffer.compare(pos, sizeof(false_string) - 1, false_string) == 0) ||
+        (buffer.compare(pos, sizeof(on_string) - 1, on_string) == 0) ||
+        (buffer.compare(pos, sizeof(off_string) - 1, off_string) == 0);
 }
 
 
@@ -1229,7 +1228,7 @@ void Lexer_t::PullConstString
 
     while (*charPtr != '\0')
     {
-        if (context.top().nextChars[0] != *charPtr)
+        if (context.top().Peek(0) != *charPtr)
         {
             UnexpectedChar(mk::format(LE_I18N("Unexpected character %%s. Expected '%s'"),
                                       tokenString));
@@ -1256,11 +1255,14 @@ void Lexer_t::PullWhitespace
     size_t start_line = context.top().line,
         start_column = context.top().column;
 
-    while (IsWhitespace(context.top().nextChars[0]))
+    size_t count = 0;
+    while (IsWhitespace(context.top().Peek(count)))
     {
-        AdvanceOneCharacter(tokenPtr);
+        count++;
     }
 
+    AdvanceCharacters(tokenPtr->text, count);
+
     if ((start_line == context.top().line) &&
         (start_column == context.top().column))
     {
@@ -1281,7 +1283,7 @@ void Lexer_t::PullComment
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] != '/')
+    if (context.top().Peek(0) != '/')
     {
         ThrowException(LE_I18N("Expected '/' at start of comment."));
     }
@@ -1290,44 +1292,36 @@ void Lexer_t::PullComment
     AdvanceOneCharacter(tokenPtr);
 
     // Figure out which kind of comment it is.
-    if (context.top().nextChars[0] == '/')
+    if (context.top().Peek(0) == '/')
     {
         // C++ style comment, terminated by either new-line or end-of-file.
-        AdvanceOneCharacter(tokenPtr);
-        while ((context.top().nextChars[0] != '\n') && (context.top().nextChars[0] != EOF))
+        auto& currentContext = context.top();
+        auto endPos = currentContext.buffer.find('\n', currentContext.pos);
+        if (endPos == std::string::npos)
         {
-            AdvanceOneCharacter(tokenPtr);
+            endPos = currentContext.buffer.size();
         }
+
+        AdvanceCharacters(tokenPtr->text, endPos - currentContext.pos);
     }
-    else if (context.top().nextChars[0] == '*')
+    else if (context.top().Peek(0) == '*')
     {
         // C style comment, terminated by "*/" digraph.
         AdvanceOneCharacter(tokenPtr);
-        for (;;)
-        {
-            if (context.top().nextChars[0] == '*')
-            {
-                AdvanceOneCharacter(tokenPtr);
-
-                if (context.top().nextChars[0] == '/')
-                {
-                    AdvanceOneCharacter(tokenPtr);
 
-                    break;
-                }
-            }
-            else if (context.top().nextChars[0] == EOF)
-            {
-                ThrowException(
-                    mk::format(LE_I18N("Unexpected end-of-file before end of comment.\n"
-                                       "%s: note: Comment starts here."), tokenPtr->GetLocation())
-                );
-            }
-            else
-            {
-                AdvanceOneCharacter(tokenPtr);
-            }
+        auto& currentContext = context.top();
+        auto endPos = currentContext.buffer.find("*/", currentContext.pos);
+        if (endPos == std::string::npos)
+        {
+            AdvanceCharacters(tokenPtr->text,
+                              currentContext.buffer.size() - currentContext.pos);
+            ThrowException(
+                mk::format(LE_I18N("Unexpected end-of-file before end of comment.\n"
+                                   "%s: note: Comment starts here."), tokenPtr->GetLocation())
+            );
         }
+
+        AdvanceCharacters(tokenPtr->text, endPos + 2 - currentContext.pos);
     }
     else
     {
@@ -1347,17 +1341,17 @@ void Lexer_t::PullInteger
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (!isdigit(context.top().nextChars[0]))
+    if (!isdigit(context.top().Peek(0)))
     {
         UnexpectedChar(LE_I18N("Unexpected character %s at beginning of integer."));
     }
 
-    while (isdigit(context.top().nextChars[0]))
+    while (isdigit(context.top().Peek(0)))
     {
         AdvanceOneCharacter(tokenPtr);
     }
 
-    if (context.top().nextChars[0] == 'K')
+    if (context.top().Peek(0) == 'K')
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1375,8 +1369,8 @@ void Lexer_t::PullSignedInteger
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   (context.top().nextChars[0] == '-')
-           || (context.top().nextChars[0] == '+'))
+    if (   (context.top().Peek(0) == '-')
+           || (context.top().Peek(0) == '+'))
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1396,27 +1390,27 @@ void Lexer_t::PullBoolean
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] == 't')
+    if (context.top().Peek(0) == 't')
     {
         PullConstString(tokenPtr, "true");
     }
-    else if (context.top().nextChars[0] == 'f')
+    else if (context.top().Peek(0) == 'f')
     {
         PullConstString(tokenPtr, "false");
     }
-    else if (context.top().nextChars[0] == 'o')
+    else if (context.top().Peek(0) == 'o')
     {
         AdvanceOneCharacter(tokenPtr);
 
-        if (context.top().nextChars[0] == 'n')
+        if (context.top().Peek(0) == 'n')
         {
             AdvanceOneCharacter(tokenPtr);
         }
-        else if (context.top().nextChars[0] == 'f')
+        else if (context.top().Peek(0) == 'f')
         {
             AdvanceOneCharacter(tokenPtr);
 
-            if (context.top().nextChars[0] != 'f')
+            if (context.top().Peek(0) != 'f')
             {
                 ThrowException(LE_I18N("Unexpected boolean value.  Only 'true', 'false', "
                                        "'on', or 'off' allowed."));
@@ -1444,38 +1438,38 @@ void Lexer_t::PullFloat
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   (isdigit(context.top().nextChars[0]) == false)
-           && (context.top().nextChars[0] != '+')
-           && (context.top().nextChars[0] != '-'))
+    if (   (isdigit(context.top().Peek(0)) == false)
+           && (context.top().Peek(0) != '+')
+           && (context.top().Peek(0) != '-'))
     {
         UnexpectedChar(LE_I18N("Unexpected character %s at beginning of floating point value."));
     }
 
     AdvanceOneCharacter(tokenPtr);
 
-    while (isdigit(context.top().nextChars[0]))
+    while (isdigit(context.top().Peek(0)))
     {
         AdvanceOneCharacter(tokenPtr);
     }
 
-    if (context.top().nextChars[0] == '.')
+    if (context.top().Peek(0) == '.')
     {
         AdvanceOneCharacter(tokenPtr);
 
-        while (isdigit(context.top().nextChars[0]))
+        while (isdigit(context.top().Peek(0)))
         {
             AdvanceOneCharacter(tokenPtr);
         }
     }
 
-    if (   (context.top().nextChars[0] == 'e')
-           || (context.top().nextChars[0] == 'E'))
+    if (   (context.top().Peek(0) == 'e')
+           || (context.top().Peek(0) == 'E'))
     {
         AdvanceOneCharacter(tokenPtr);
 
-        if (   (isdigit(context.top().nextChars[0]) == false)
-               && (context.top().nextChars[0] != '+')
-               && (context.top().nextChars[0] != '-'))
+        if (   (isdigit(context.top().Peek(0)) == false)
+               && (context.top().Peek(0) != '+')
+               && (context.top().Peek(0) != '-'))
         {
             UnexpectedChar(LE_I18N("Unexpected character %s in exponent part of"
                                    " floating point value."));
@@ -1483,7 +1477,7 @@ void Lexer_t::PullFloat
 
         AdvanceOneCharacter(tokenPtr);
 
-        while (isdigit(context.top().nextChars[0]))
+        while (isdigit(context.top().Peek(0)))
         {
             AdvanceOneCharacter(tokenPtr);
         }
@@ -1502,10 +1496,10 @@ void Lexer_t::PullString
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   (context.top().nextChars[0] == '"')
-           || (context.top().nextChars[0] == '\''))
+    if (   (context.top().Peek(0) == '"')
+           || (context.top().Peek(0) == '\''))
     {
-        PullQuoted(tokenPtr, context.top().nextChars[0]);
+        PullQuoted(tokenPtr, context.top().Peek(0));
     }
     else
     {
@@ -1525,7 +1519,7 @@ void Lexer_t::PullFilePermissions
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] != '[')
+    if (context.top().Peek(0) != '[')
     {
         ThrowException(LE_I18N("Expected '[' at start of file permissions."));
     }
@@ -1534,7 +1528,7 @@ void Lexer_t::PullFilePermissions
     AdvanceOneCharacter(tokenPtr);
 
     // Must be something between the square brackets.
-    if (context.top().nextChars[0] == ']')
+    if (context.top().Peek(0) == ']')
     {
         ThrowException(LE_I18N("Empty file permissions."));
     }
@@ -1543,18 +1537,18 @@ void Lexer_t::PullFilePermissions
     do
     {
         // Check for end-of-file or illegal character in file permissions.
-        if (context.top().nextChars[0] == EOF)
+        if (context.top().Peek(0) == EOF)
         {
             ThrowException(LE_I18N("Unexpected end-of-file before end of file permissions."));
         }
-        else if ((context.top().nextChars[0] != 'r') && (context.top().nextChars[0] != 'w') && (context.top().nextChars[0] != 'x'))
+        else if ((context.top().Peek(0) != 'r') && (context.top().Peek(0) != 'w') && (context.top().Peek(0) != 'x'))
         {
             UnexpectedChar(LE_I18N("Unexpected character %s inside file permissions."));
         }
 
         AdvanceOneCharacter(tokenPtr);
 
-    } while (context.top().nextChars[0] != ']');
+    } while (context.top().Peek(0) != ']');
 
     // Eat the trailing ']'.
     AdvanceOneCharacter(tokenPtr);
@@ -1576,7 +1570,8 @@ void Lexer_t::PullServerIpcOption
 
     // Check that it's one of the valid server-side options.
     if (   (tokenPtr->text != "[manual-start]")
-           && (tokenPtr->text != "[async]") )
+           && (tokenPtr->text != "[async]")
+           && (tokenPtr->text != "[multi-threaded]") )
     {
         ThrowException(
             mk::format(LE_I18N("Invalid server-side IPC option: '%s'"), tokenPtr->text)
@@ -1601,7 +1596,8 @@ void Lexer_t::PullClientIpcOption
     // Check that it's one of the valid client-side options.
     if (   (tokenPtr->text != "[manual-start]")
            && (tokenPtr->text != "[types-only]")
-           && (tokenPtr->text != "[optional]") )
+           && (tokenPtr->text != "[optional]")
+           && (tokenPtr->text != "[async]") )
     {
         ThrowException(
             mk::format(LE_I18N("Invalid client-side IPC option: '%s'"), tokenPtr->text)
@@ -1621,7 +1617,7 @@ void Lexer_t::PullIpcOption
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] != '[')
+    if (context.top().Peek(0) != '[')
     {
         ThrowException(LE_I18N("Expected '[' at start of IPC option."));
     }
@@ -1630,7 +1626,7 @@ void Lexer_t::PullIpcOption
     AdvanceOneCharacter(tokenPtr);
 
     // Must be something between the square brackets.
-    if (context.top().nextChars[0] == ']')
+    if (context.top().Peek(0) == ']')
     {
         ThrowException(LE_I18N("Empty IPC option."));
     }
@@ -1639,18 +1635,18 @@ void Lexer_t::PullIpcOption
     do
     {
         // Check for end-of-file or illegal character in option.
-        if (context.top().nextChars[0] == EOF)
+        if (context.top().Peek(0) == EOF)
         {
             ThrowException(LE_I18N("Unexpected end-of-file before end of IPC option."));
         }
-        else if ((context.top().nextChars[0] != '-') && !islower(context.top().nextChars[0]))
+        else if ((context.top().Peek(0) != '-') && !islower(context.top().Peek(0)))
         {
             UnexpectedChar(LE_I18N("Unexpected character %s inside option."));
         }
 
         AdvanceOneCharacter(tokenPtr);
 
-    } while (context.top().nextChars[0] != ']');
+    } while (context.top().Peek(0) != ']');
 
     // Eat the trailing ']'.
     AdvanceOneCharacter(tokenPtr);
@@ -1670,11 +1666,11 @@ void Lexer_t::PullArg
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] == '"')
+    if (context.top().Peek(0) == '"')
     {
         PullQuoted(tokenPtr, '"');
     }
-    else if (context.top().nextChars[0] == '\'')
+    else if (context.top().Peek(0) == '\'')
     {
         PullQuoted(tokenPtr, '\'');
     }
@@ -1683,18 +1679,18 @@ void Lexer_t::PullArg
         size_t start_line = context.top().line;
         size_t start_column = context.top().column;
 
-        while (IsArgChar(context.top().nextChars[0]))
+        while (IsArgChar(context.top().Peek(0)))
         {
-            if (context.top().nextChars[0] == '$')
+            if (context.top().Peek(0) == '$')
             {
                 PullEnvVar(tokenPtr);
             }
             else
             {
-                if (context.top().nextChars[0] == '/')
+                if (context.top().Peek(0) == '/')
                 {
                     // Check for comment start.
-                    int secondChar = context.top().nextChars[1];
+                    int secondChar = context.top().Peek(1);
                     if ((secondChar == '/') || (secondChar == '*'))
                     {
                         break;
@@ -1710,11 +1706,11 @@ void Lexer_t::PullArg
         if ((start_line == context.top().line) &&
             (start_column == context.top().column))
         {
-            if (isprint(context.top().nextChars[0]))
+            if (isprint(context.top().Peek(0)))
             {
                 ThrowException(
                     mk::format(LE_I18N("Invalid character '%c' in argument."),
-                               (char)context.top().nextChars[0])
+                               (char)context.top().Peek(0))
                 );
             }
             else
@@ -1739,11 +1735,11 @@ void Lexer_t::PullFilePath
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] == '"')
+    if (context.top().Peek(0) == '"')
     {
         PullQuoted(tokenPtr, '"');
     }
-    else if (context.top().nextChars[0] == '\'')
+    else if (context.top().Peek(0) == '\'')
     {
         PullQuoted(tokenPtr, '\'');
     }
@@ -1752,18 +1748,18 @@ void Lexer_t::PullFilePath
         size_t start_line = context.top().line,
             start_column = context.top().column;
 
-        while (IsFilePathChar(context.top().nextChars[0]))
+        while (IsFilePathChar(context.top().Peek(0)))
         {
-            if (context.top().nextChars[0] == '$')
+            if (context.top().Peek(0) == '$')
             {
                 PullEnvVar(tokenPtr);
             }
             else
             {
-                if (context.top().nextChars[0] == '/')
+                if (context.top().Peek(0) == '/')
                 {
                     // Check for comment start.
-                    int secondChar = context.top().nextChars[1];
+                    int secondChar = context.top().Peek(1);
                     if ((secondChar == '/') || (secondChar == '*'))
                     {
                         break;
@@ -1779,11 +1775,11 @@ void Lexer_t::PullFilePath
         if (start_line == context.top().line &&
             start_column == context.top().column)
         {
-            if (isprint(context.top().nextChars[0]))
+            if (isprint(context.top().Peek(0)))
             {
                 ThrowException(
                     mk::format(LE_I18N("Invalid character '%c' in file path."),
-                               (char)context.top().nextChars[0])
+                               (char)context.top().Peek(0))
                 );
             }
             else
@@ -1808,11 +1804,11 @@ void Lexer_t::PullFileName
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (context.top().nextChars[0] == '"')
+    if (context.top().Peek(0) == '"')
     {
         PullQuoted(tokenPtr, '"');
     }
-    else if (context.top().nextChars[0] == '\'')
+    else if (context.top().Peek(0) == '\'')
     {
         PullQuoted(tokenPtr, '\'');
     }
@@ -1821,9 +1817,9 @@ void Lexer_t::PullFileName
         size_t start_line = context.top().line,
             start_column = context.top().column;
 
-        while (IsFileNameChar(context.top().nextChars[0]))
+        while (IsFileNameChar(context.top().Peek(0)))
         {
-            if (context.top().nextChars[0] == '$')
+            if (context.top().Peek(0) == '$')
             {
                 PullEnvVar(tokenPtr);
             }
@@ -1838,11 +1834,11 @@ void Lexer_t::PullFileName
         if ((start_line == context.top().line) &&
             (start_column == context.top().column))
         {
-            if (isprint(context.top().nextChars[0]))
+            if (isprint(context.top().Peek(0)))
             {
                 ThrowException(
                     mk::format(LE_I18N("Invalid character '%c' in name."),
-                               (char)context.top().nextChars[0])
+                               (char)context.top().Peek(0))
                 );
             }
             else
@@ -1865,9 +1861,9 @@ void Lexer_t::PullName
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   islower(context.top().nextChars[0])
-           || isupper(context.top().nextChars[0])
-           || (context.top().nextChars[0] == '_') )
+    if (   islower(context.top().Peek(0))
+           || isupper(context.top().Peek(0))
+           || (context.top().Peek(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1878,10 +1874,10 @@ void Lexer_t::PullName
                                " or an underscore ('_')."));
     }
 
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0])
-              || isdigit(context.top().nextChars[0])
-              || (context.top().nextChars[0] == '_') )
+    while (   islower(context.top().Peek(0))
+              || isupper(context.top().Peek(0))
+              || isdigit(context.top().Peek(0))
+              || (context.top().Peek(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1903,14 +1899,14 @@ void Lexer_t::PullDottedName
     {
         PullName(tokenPtr);
 
-        if (context.top().nextChars[0] == '.')
+        if (context.top().Peek(0) == '.')
         {
             AdvanceOneCharacter(tokenPtr);
         }
     }
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0])
-              || (context.top().nextChars[0] == '_'));
+    while (   islower(context.top().Peek(0))
+              || isupper(context.top().Peek(0))
+              || (context.top().Peek(0) == '_'));
 }
 
 
@@ -1925,9 +1921,9 @@ void Lexer_t::PullGroupName
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (   islower(context.top().nextChars[0])
-           || isupper(context.top().nextChars[0])
-           || (context.top().nextChars[0] == '_') )
+    if (   islower(context.top().Peek(0))
+           || isupper(context.top().Peek(0))
+           || (context.top().Peek(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1938,11 +1934,11 @@ void Lexer_t::PullGroupName
                                "('a'-'z' or 'A'-'Z') or an underscore ('_')."));
     }
 
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0])
-              || isdigit(context.top().nextChars[0])
-              || (context.top().nextChars[0] == '_')
-              || (context.top().nextChars[0] == '-') )
+    while (   islower(context.top().Peek(0))
+              || isupper(context.top().Peek(0))
+              || isdigit(context.top().Peek(0))
+              || (context.top().Peek(0) == '_')
+              || (context.top().Peek(0) == '-') )
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -1960,23 +1956,23 @@ void Lexer_t::PullIpcAgentName
 )
 //--------------------------------------------------------------------------------------------------
 {
-    auto firstChar = context.top().nextChars[0];
+    auto firstChar = context.top().Peek(0);
 
     // User names are enclosed in angle brackets (e.g., "<username>").
     if (firstChar == '<')
     {
         AdvanceOneCharacter(tokenPtr);
 
-        while (   islower(context.top().nextChars[0])
-                  || isupper(context.top().nextChars[0])
-                  || isdigit(context.top().nextChars[0])
-                  || (context.top().nextChars[0] == '_')
-                  || (context.top().nextChars[0] == '-') )
+        while (   islower(context.top().Peek(0))
+                  || isupper(context.top().Peek(0))
+                  || isdigit(context.top().Peek(0))
+                  || (context.top().Peek(0) == '_')
+                  || (context.top().Peek(0) == '-') )
         {
             AdvanceOneCharacter(tokenPtr);
         }
 
-        if (context.top().nextChars[0] != '>')
+        if (context.top().Peek(0) != '>')
         {
             UnexpectedChar(LE_I18N("Unexpected character %s in user name.  "
                                    "Must be terminated with '>'."));
@@ -1987,16 +1983,16 @@ void Lexer_t::PullIpcAgentName
         }
     }
     // App names have the same rules as C programming language identifiers.
-    else if (   islower(context.top().nextChars[0])
-                || isupper(context.top().nextChars[0])
-                || (context.top().nextChars[0] == '_') )
+    else if (   islower(context.top().Peek(0))
+                || isupper(context.top().Peek(0))
+                || (context.top().Peek(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr);
 
-        while (   islower(context.top().nextChars[0])
-                  || isupper(context.top().nextChars[0])
-                  || isdigit(context.top().nextChars[0])
-                  || (context.top().nextChars[0] == '_') )
+        while (   islower(context.top().Peek(0))
+                  || isupper(context.top().Peek(0))
+                  || isdigit(context.top().Peek(0))
+                  || (context.top().Peek(0) == '_') )
         {
             AdvanceOneCharacter(tokenPtr);
         }
@@ -2028,14 +2024,14 @@ void Lexer_t::PullQuoted
     // Eat the leading quote.
     AdvanceOneCharacter(tokenPtr);
 
-    while (context.top().nextChars[0] != quoteChar)
+    while (context.top().Peek(0) != quoteChar)
     {
         // Don't allow end of file or end of line characters inside the quoted string.
-        if (context.top().nextChars[0] == EOF)
+        if (context.top().Peek(0) == EOF)
         {
             ThrowException(LE_I18N("Unexpected end-of-file before end of quoted string."));
         }
-        if ((context.top().nextChars[0] == '\n') || (context.top().nextChars[0] == '\r'))
+        if ((context.top().Peek(0) == '\n') || (context.top().Peek(0) == '\r'))
         {
             ThrowException(LE_I18N("Unexpected end-of-line before end of quoted string."));
         }
@@ -2067,16 +2063,16 @@ void Lexer_t::PullEnvVar
 
     // If the next character is a curly brace, remember that we need to look for the closing curly.
     bool hasCurlies = false;    // true if ${ENV_VAR} style.  false if $ENV_VAR style.
-    if (context.top().nextChars[0] == '{')
+    if (context.top().Peek(0) == '{')
     {
         AdvanceOneCharacter(tokenPtr->text);
         hasCurlies = true;
     }
 
     // Pull the first character of the environment variable name.
-    if (   islower(context.top().nextChars[0])
-           || isupper(context.top().nextChars[0])
-           || (context.top().nextChars[0] == '_') )
+    if (   islower(context.top().Peek(0))
+           || isupper(context.top().Peek(0))
+           || (context.top().Peek(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr->text);
     }
@@ -2089,10 +2085,10 @@ void Lexer_t::PullEnvVar
     }
 
     // Pull the rest of the environment variable name.
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0])
-              || isdigit(context.top().nextChars[0])
-              || (context.top().nextChars[0] == '_') )
+    while (   islower(context.top().Peek(0))
+              || isupper(context.top().Peek(0))
+              || isdigit(context.top().Peek(0))
+              || (context.top().Peek(0) == '_') )
     {
         AdvanceOneCharacter(tokenPtr->text);
     }
@@ -2100,18 +2096,18 @@ void Lexer_t::PullEnvVar
     // If there was an opening curly brace, match the closing one now.
     if (hasCurlies)
     {
-        if (context.top().nextChars[0] == '}')
+        if (context.top().Peek(0) == '}')
         {
             AdvanceOneCharacter(tokenPtr->text);
         }
-        else if (context.top().nextChars[0] == EOF)
+        else if (context.top().Peek(0) == EOF)
         {
             ThrowException(LE_I18N("Unexpected end-of-file inside environment variable name."));
         }
         else
         {
             ThrowException(
-                mk::format(LE_I18N("'}' expected.  '%c' found."), (char)context.top().nextChars[0])
+                mk::format(LE_I18N("'}' expected.  '%c' found."), (char)context.top().Peek(0))
             );
         }
     }
@@ -2132,15 +2128,15 @@ void Lexer_t::PullMd5
     // There are always exactly 32 hexadecimal digits in an md5 sum.
     for (int i = 0; i < 32; i++)
     {
-        if (   (!isdigit(context.top().nextChars[0]))
-               && (context.top().nextChars[0] != 'a')
-               && (context.top().nextChars[0] != 'b')
-               && (context.top().nextChars[0] != 'c')
-               && (context.top().nextChars[0] != 'd')
-               && (context.top().nextChars[0] != 'e')
-               && (context.top().nextChars[0] != 'f')  )
+        if (   (!isdigit(context.top().Peek(0)))
+               && (context.top().Peek(0) != 'a')
+               && (context.top().Peek(0) != 'b')
+               && (context.top().Peek(0) != 'c')
+               && (context.top().Peek(0) != 'd')
+               && (context.top().Peek(0) != 'e')
+               && (context.top().Peek(0) != 'f')  )
         {
-            if (IsWhitespace(context.top().nextChars[0]))
+            if (IsWhitespace(context.top().Peek(0)))
             {
                 ThrowException(LE_I18N("MD5 hash too short."));
             }
@@ -2152,13 +2148,13 @@ void Lexer_t::PullMd5
     }
 
     // Make sure it isn't too long.
-    if (   isdigit(context.top().nextChars[0])
-           || (context.top().nextChars[0] == 'a')
-           || (context.top().nextChars[0] == 'b')
-           || (context.top().nextChars[0] == 'c')
-           || (context.top().nextChars[0] == 'd')
-           || (context.top().nextChars[0] == 'e')
-           || (context.top().nextChars[0] == 'f')  )
+    if (   isdigit(context.top().Peek(0))
+           || (context.top().Peek(0) == 'a')
+           || (context.top().Peek(0) == 'b')
+           || (context.top().Peek(0) == 'c')
+           || (context.top().Peek(0) == 'd')
+           || (context.top().Peek(0) == 'e')
+           || (context.top().Peek(0) == 'f')  )
     {
         ThrowException(LE_I18N("MD5 hash too long."));
     }
@@ -2177,7 +2173,7 @@ void Lexer_t::PullDirective
 //--------------------------------------------------------------------------------------------------
 {
     // advance past the '#'
-    if (context.top().nextChars[0] == '#')
+    if (context.top().Peek(0) == '#')
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -2187,8 +2183,8 @@ void Lexer_t::PullDirective
                                "Must start with '#' character."));
     }
 
-    if (   islower(context.top().nextChars[0])
-           || isupper(context.top().nextChars[0]))
+    if (   islower(context.top().Peek(0))
+           || isupper(context.top().Peek(0)))
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -2198,8 +2194,8 @@ void Lexer_t::PullDirective
                                "Must start with a letter ('a'-'z' or 'A'-'Z')."));
     }
 
-    while (   islower(context.top().nextChars[0])
-              || isupper(context.top().nextChars[0]))
+    while (   islower(context.top().Peek(0))
+              || isupper(context.top().Peek(0)))
     {
         AdvanceOneCharacter(tokenPtr);
     }
@@ -2427,25 +2423,64 @@ void Lexer_t::AdvanceOneCharacter
 )
 //--------------------------------------------------------------------------------------------------
 {
-    string += context.top().nextChars[0];
+    auto& currentContext = context.top();
+
+    if (currentContext.pos >= currentContext.buffer.size())
+    {
+        ThrowException(LE_I18N("Unexpected end-of-file."));
+    }
 
-    if (context.top().nextChars[0] == '\n')
+    char c = currentContext.buffer[currentContext.pos++];
+
+    string += c;
+
+    if (c == '\n')
     {
-        context.top().line++;
-        context.top().column = 0;
+        currentContext.line++;
+        currentContext.column = 0;
     }
     else
     {
-        context.top().column++;
+        currentContext.column++;
     }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Advance the current file position by a number of characters, appending them into a given string
+ * and updating the line and column numbers.
+ *
+ * The characters must all be in the file (e.g., found using Peek()).
+ */
+//--------------------------------------------------------------------------------------------------
+void Lexer_t::AdvanceCharacters
+(
+    std::string& string,    ///< String to add the characters to.
+    size_t count            ///< Number of characters.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    auto& currentContext = context.top();
+    auto startPtr = currentContext.buffer.data() + currentContext.pos;
+    auto endPtr = startPtr + count;
 
-    context.top().nextChars.pop_front();
-    context.top().Buffer(2);
+    string.append(startPtr, count);
 
-    if (context.top().inputStream.bad())
+    // The column restarts after the last new-line.
+    auto lineStartPtr = startPtr;
+    for (auto newLinePtr = static_cast<const char*>(memchr(startPtr, '\n', count));
+         newLinePtr != NULL;
+         newLinePtr = static_cast<const char*>(memchr(newLinePtr + 1, '\n',
+                                                      endPtr - (newLinePtr + 1))))
     {
-        ThrowException(LE_I18N("Failed to fetch next character from file."));
+        currentContext.line++;
+        currentContext.column = 0;
+        lineStartPtr = newLinePtr + 1;
     }
+
+    currentContext.column += endPtr - lineStartPtr;
+    currentContext.pos += count;
 }
 
 
@@ -2486,7 +2521,7 @@ void Lexer_t::UnexpectedChar
 )
 //--------------------------------------------------------------------------------------------------
 {
-    throw mk::Exception_t(UnexpectedCharErrorMsg(context.top().nextChars[0],
+    throw mk::Exception_t(UnexpectedCharErrorMsg(context.top().Peek(0),
                                                  context.top().line,
                                                  context.top().column,
                                                  message));
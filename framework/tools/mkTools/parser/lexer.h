@@ -58,16 +58,21 @@ class Lexer_t
         {
             parseTree::DefFileFragment_t* filePtr;  ///< Pointer to the File object for the file being parsed.
 
-            std::ifstream inputStream;      ///< File input stream from which tokens will be matched.
-            std::deque<int> nextChars;      ///< File buffer for characters read from the input
-                                            ///< stream but not yet consumed.
+            std::string buffer;             ///< Whole contents of the file.
+            size_t pos;                     ///< Index in buffer of the next character to consume.
             size_t line;                    ///< File line number.
             size_t column;                  ///< Char index on line (treat tab & return same as space).
             size_t ifNestDepth;             ///< Current number of nested #if directives.
 
             LexerContext_t(parseTree::DefFileFragment_t *filePtr);
 
-            void Buffer(size_t n);
+            /// Look ahead at a character not yet consumed.
+            /// @return The character, or EOF if past the end of the file.
+            int Peek(size_t offset) const
+            {
+                return (pos + offset < buffer.size() ?
+                        static_cast<unsigned char>(buffer[pos + offset]) : EOF);
+            }
         };
 
         std::stack<LexerContext_t> context;
@@ -121,6 +126,7 @@ class Lexer_t
         void PullDirective(parseTree::Token_t* tokenPtr);
         void AdvanceOneCharacter(parseTree::Token_t* tokenPtr);
         void AdvanceOneCharacter(std::string& string);
+        void AdvanceCharacters(std::string& string, size_t count);
         std::string UnexpectedCharErrorMsg(char unexpectedChar,
                                            size_t lineNum,
                                            size_t columnNum,
@@ -341,6 +341,81 @@ void ParseFile
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Files parsed ahead of time, keyed by path, waiting to be taken by the modeller.
+ */
+//--------------------------------------------------------------------------------------------------
+static std::map<std::string, parseTree::DefFile_t*> PreParsedFiles;
+static std::mutex PreParsedFilesMutex;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store a file that has been parsed ahead of time (e.g., by a worker thread), to be returned by
+ * the next call to TakePreParsedFile() for the same path.  Thread-safe.
+ */
+//--------------------------------------------------------------------------------------------------
+void AddPreParsedFile
+(
+    parseTree::DefFile_t* defFilePtr    ///< The parsed file.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(PreParsedFilesMutex);
+
+    // Only the first one counts if the same file was parsed twice.
+    if (!PreParsedFiles.insert(std::make_pair(defFilePtr->path, defFilePtr)).second)
+    {
+        delete defFilePtr;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a file that has been parsed ahead of time out of the store.  Thread-safe.
+ *
+ * The same progress message is printed as if the file was being parsed now, so verbose output
+ * doesn't depend on whether the file was parsed ahead of time or not.
+ *
+ * @return Pointer to the parsed file, or NULL if this file hasn't been parsed ahead of time.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::DefFile_t* TakePreParsedFile
+(
+    const std::string& filePath,        ///< Path of the file, exactly as it would be parsed.
+    parseTree::DefFile_t::Type_t type,  ///< Type of file expected.
+    bool beVerbose                      ///< true if progress messages should be printed.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    parseTree::DefFile_t* defFilePtr = NULL;
+
+    {
+        std::lock_guard<std::mutex> lock(PreParsedFilesMutex);
+
+        auto i = PreParsedFiles.find(path::MakeAbsolute(filePath));
+
+        if ((i == PreParsedFiles.end()) || (i->second->type != type))
+        {
+            return NULL;
+        }
+
+        defFilePtr = i->second;
+        PreParsedFiles.erase(i);
+    }
+
+    if (beVerbose)
+    {
+        std::cout << mk::format(LE_I18N("Parsing file: '%s'."), defFilePtr->path)
+                  << std::endl;
+    }
+
+    return defFilePtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Parse a bundled file or directory item from inside a "bundles:" section's "file" or "dir"
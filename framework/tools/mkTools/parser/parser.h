@@ -193,6 +193,33 @@ void ParseFile
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Store a file that has been parsed ahead of time (e.g., by a worker thread), to be returned by
+ * the next call to TakePreParsedFile() for the same path.  Thread-safe.
+ */
+//--------------------------------------------------------------------------------------------------
+void AddPreParsedFile
+(
+    parseTree::DefFile_t* defFilePtr    ///< The parsed file.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Take a file that has been parsed ahead of time out of the store.  Thread-safe.
+ *
+ * @return Pointer to the parsed file, or NULL if this file hasn't been parsed ahead of time.
+ */
+//--------------------------------------------------------------------------------------------------
+parseTree::DefFile_t* TakePreParsedFile
+(
+    const std::string& filePath,        ///< Path of the file, exactly as it would be parsed.
+    parseTree::DefFile_t::Type_t type,  ///< Type of file expected.
+    bool beVerbose                      ///< true if progress messages should be printed.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Parse a subsection inside a "bundles:" section.
@@ -0,0 +1,202 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file threadPool.cpp  Implementation of the pool of worker threads.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#include "mkTools.h"
+
+
+namespace mk
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Constructor.  Starts the worker threads.
+ **/
+//--------------------------------------------------------------------------------------------------
+ThreadPool_t::ThreadPool_t
+(
+    size_t threadCount      ///< Number of threads to run tasks in.
+)
+//--------------------------------------------------------------------------------------------------
+:   nextTaskId(0),
+    pendingCount(0),
+    isStopping(false),
+    errorTaskId(0)
+//--------------------------------------------------------------------------------------------------
+{
+    if (threadCount > 1)
+    {
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back(&ThreadPool_t::RunWorker, this);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor.  Waits for the tasks to finish (ignoring their errors) and stops the threads.
+ **/
+//--------------------------------------------------------------------------------------------------
+ThreadPool_t::~ThreadPool_t
+(
+)
+//--------------------------------------------------------------------------------------------------
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        tasksDone.wait(lock, [this]() { return (pendingCount == 0); });
+
+        isStopping = true;
+    }
+
+    taskPosted.notify_all();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Post a task to be run by one of the worker threads.
+ **/
+//--------------------------------------------------------------------------------------------------
+void ThreadPool_t::Post
+(
+    std::function<void(void)> task
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (threads.empty())
+    {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        taskQueue.push_back(std::make_pair(nextTaskId++, std::move(task)));
+        pendingCount++;
+    }
+
+    taskPosted.notify_one();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Wait for all the tasks posted so far (and the tasks they post) to finish.
+ *
+ * @throw The exception thrown by the first posted task that failed, if any did.
+ **/
+//--------------------------------------------------------------------------------------------------
+void ThreadPool_t::Wait
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::exception_ptr exceptionPtr;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        tasksDone.wait(lock, [this]() { return (pendingCount == 0); });
+
+        exceptionPtr = errorPtr;
+        errorPtr = nullptr;
+    }
+
+    if (exceptionPtr)
+    {
+        std::rethrow_exception(exceptionPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of threads to use by default: one per processor.
+ **/
+//--------------------------------------------------------------------------------------------------
+size_t ThreadPool_t::DefaultThreadCount
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t count = std::thread::hardware_concurrency();
+
+    return (count > 0 ? count : 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the worker threads.
+ **/
+//--------------------------------------------------------------------------------------------------
+void ThreadPool_t::RunWorker
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    for (;;)
+    {
+        taskPosted.wait(lock, [this]() { return (isStopping || !taskQueue.empty()); });
+
+        if (taskQueue.empty())
+        {
+            // Stopping, and nothing left to do.
+            return;
+        }
+
+        auto entry = std::move(taskQueue.front());
+        taskQueue.pop_front();
+
+        lock.unlock();
+
+        std::exception_ptr exceptionPtr;
+
+        try
+        {
+            entry.second();
+        }
+        catch (...)
+        {
+            exceptionPtr = std::current_exception();
+        }
+
+        lock.lock();
+
+        if (exceptionPtr && ((!errorPtr) || (entry.first < errorTaskId)))
+        {
+            errorPtr = exceptionPtr;
+            errorTaskId = entry.first;
+        }
+
+        pendingCount--;
+
+        if (pendingCount == 0)
+        {
+            tasksDone.notify_all();
+        }
+    }
+}
+
+
+} // namespace mk
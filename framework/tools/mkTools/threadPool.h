@@ -0,0 +1,60 @@
+//--------------------------------------------------------------------------------------------------
+/**
+ * @file threadPool.h  Pool of worker threads used to parse and generate files in parallel.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ **/
+//--------------------------------------------------------------------------------------------------
+
+#ifndef LEGATO_MKTOOLS_THREAD_POOL_H_INCLUDE_GUARD
+#define LEGATO_MKTOOLS_THREAD_POOL_H_INCLUDE_GUARD
+
+
+namespace mk
+{
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool of worker threads that run posted tasks.
+ *
+ * Tasks may post more tasks.  Wait() returns once every task posted so far has finished.  If
+ * tasks throw exceptions, Wait() re-throws the one thrown by the task that was posted first, so
+ * the error reported doesn't depend on thread scheduling.
+ *
+ * A pool with a single thread doesn't start any: tasks are run immediately by Post(), in the
+ * caller's thread, exactly as if the pool wasn't there.
+ **/
+//--------------------------------------------------------------------------------------------------
+class ThreadPool_t
+{
+    public:
+
+        ThreadPool_t(size_t threadCount);
+        ~ThreadPool_t();
+
+        void Post(std::function<void(void)> task);
+        void Wait(void);
+
+        static size_t DefaultThreadCount(void);
+
+    private:
+
+        void RunWorker(void);
+
+        std::mutex mutex;                       ///< Protects everything below.
+        std::condition_variable taskPosted;     ///< Signalled when a task is posted or stopping.
+        std::condition_variable tasksDone;      ///< Signalled when the last pending task is done.
+        std::deque<std::pair<size_t, std::function<void(void)>>> taskQueue; ///< (id, task) pairs.
+        size_t nextTaskId;                      ///< Id to give the next task posted.
+        size_t pendingCount;                    ///< Tasks posted but not finished yet.
+        bool isStopping;                        ///< true when worker threads must exit.
+        size_t errorTaskId;                     ///< Id of the first task that threw an exception.
+        std::exception_ptr errorPtr;            ///< Exception thrown by that task.
+        std::vector<std::thread> threads;       ///< Worker threads.
+};
+
+
+} // namespace mk
+
+#endif // LEGATO_MKTOOLS_THREAD_POOL_H_INCLUDE_GUARD